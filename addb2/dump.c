@@ -726,6 +726,73 @@ static void hbar(char *buf, uint32_t val, uint32_t m)
 	}
 }
 
+/**
+ * Prints log-linear histogram data: percentiles and non-empty buckets.
+ *
+ * Percentiles are computed over the buckets recorded in this record only. Use
+ * m0_addb2_loghist_merge() to combine records of different localities, nodes
+ * or time intervals.
+ */
+static void loghist(const uint64_t *data, char *buf)
+{
+	static uint64_t bucket[M0_ADDB2_LOGHIST_NR(
+					M0_ADDB2_LOGHIST_PRECISION_MAX)];
+	static const unsigned pm[] = { 500, 900, 990, 999 };
+	int      precision = m0_addb2_loghist_precision(data);
+	bool     more      = data[0] & M0_ADDB2_LOGHIST_MORE;
+	uint64_t m         = 1; /* avoid division by 0. */
+	uint64_t p[ARRAY_SIZE(pm)];
+	char     cr        = flatten ? ' ' : '\n';
+	char     sep       = ' ';
+	int      nr;
+	int      i;
+
+	if (precision < 1 || precision > M0_ADDB2_LOGHIST_PRECISION_MAX)
+		return;
+	nr = M0_ADDB2_LOGHIST_NR(precision);
+	memset(bucket, 0, nr * sizeof bucket[0]);
+	if (m0_addb2_loghist_merge(data, precision, bucket) != 0)
+		return;
+	for (i = 0; i < ARRAY_SIZE(pm); ++i)
+		p[i] = m0_addb2_loghist_percentile(precision, bucket, pm[i]);
+	if (json_output) {
+		sprintf(buf + strlen(buf), ",\"loghist\":{"
+			"\"precision\":%i"
+			",\"p50\":%"PRIu64
+			",\"p90\":%"PRIu64
+			",\"p99\":%"PRIu64
+			",\"p999\":%"PRIu64
+			",\"more\":%s"
+			",\"buckets\":[", precision, p[0], p[1], p[2], p[3],
+			more ? "true" : "false");
+		for (i = 0; i < nr; ++i) {
+			if (bucket[i] == 0)
+				continue;
+			sprintf(buf + strlen(buf), "%c[%"PRIu64",%"PRIu64
+				",%"PRIu64"]", sep,
+				m0_addb2_loghist_low(precision, i),
+				m0_addb2_loghist_high(precision, i), bucket[i]);
+			sep = ',';
+		}
+		strcat(buf, "]}");
+		return;
+	}
+	sprintf(buf + strlen(buf), " p50: %"PRIu64" p90: %"PRIu64
+		" p99: %"PRIu64" p99.9: %"PRIu64"%s", p[0], p[1], p[2], p[3],
+		more ? " (more)" : "");
+	for (i = 0; i < nr; ++i)
+		m = max64u(m, bucket[i]);
+	for (i = 0; i < nr; ++i) {
+		if (bucket[i] == 0)
+			continue;
+		sprintf(buf + strlen(buf), "%c| %9"PRIu64" - %9"PRIu64
+			" : %9"PRIu64" | ", cr,
+			m0_addb2_loghist_low(precision, i),
+			m0_addb2_loghist_high(precision, i), bucket[i]);
+		hbar(buf, bucket[i], m);
+	}
+}
+
 static void hist(struct m0_addb2__context *ctx, const uint64_t *v, char *buf)
 {
 	struct m0_addb2_hist_data *hd = (void *)&v[M0_ADDB2_COUNTER_VALS];
@@ -736,6 +803,10 @@ static void hist(struct m0_addb2__context *ctx, const uint64_t *v, char *buf)
 	char                       cr = flatten ? ' ' : '\n';
 
 	counter(ctx, v, buf);
+	if (m0_addb2_loghist_is(&v[M0_ADDB2_COUNTER_VALS])) {
+		loghist(&v[M0_ADDB2_COUNTER_VALS], buf);
+		return;
+	}
 	if (json_output)
 		/* TODO: enable histogram support in JSON format */
 		return;
@@ -788,6 +859,20 @@ static void fom_state_counter(struct m0_addb2__context *ctx, char *buf)
 	sm_trans(&fom_states_conf, "", ctx, buf);
 }
 
+static void runq_prio_counter(struct m0_addb2__context *ctx, char *buf)
+{
+	int nob = sprintf(buf, "runq-prio-%i",
+			  (int)(ctx->c_val->va_id - M0_AVI_RUNQ_PRIO));
+	hist(ctx, &ctx->c_val->va_data[0], buf + nob);
+}
+
+static void runq_wait_counter(struct m0_addb2__context *ctx, char *buf)
+{
+	int nob = sprintf(buf, "runq-wait-%i",
+			  (int)(ctx->c_val->va_id - M0_AVI_RUNQ_WAIT));
+	hist(ctx, &ctx->c_val->va_data[0], buf + nob);
+}
+
 static void fop_counter(struct m0_addb2__context *ctx, char *buf)
 {
 	uint64_t mask = ctx->c_val->va_id - M0_AVI_FOP_TYPES_RANGE_START;
@@ -1109,6 +1194,18 @@ struct m0_addb2__id_intrp ids[] = {
 	{ M0_AVI_FOM_ACTIVE,      "fom-active",      { HIST } },
 	{ M0_AVI_RUNQ,            "runq",            { HIST } },
 	{ M0_AVI_WAIL,            "wail",            { HIST } },
+	{ M0_AVI_RUNQ_PRIO,       "",
+	  .ii_repeat = M0_AVI_RUNQ_PRIO_END - M0_AVI_RUNQ_PRIO,
+	  .ii_spec   = &runq_prio_counter },
+	{ M0_AVI_RUNQ_WAIT,       "",
+	  .ii_repeat = M0_AVI_RUNQ_WAIT_END - M0_AVI_RUNQ_WAIT,
+	  .ii_spec   = &runq_wait_counter },
+	{ M0_AVI_LOCALITY_STEAL,  "loc-steal",       { &dec, &dec },
+	  { "thief", "nr" } },
+	{ M0_AVI_LOCALITY_UTIL,   "loc-util",        { &dec, &dec, &dec },
+	  { "busy%", "adopted", "given" } },
+	{ M0_AVI_FOM_MOVE,        "fom-move",        { &ptr, &dec, &dec },
+	  { "fom", "home", "locality" } },
 	{ M0_AVI_AST,             "ast" },
 	{ M0_AVI_LOCALITY_FORQ_DURATION, "loc-forq-duration", { TIMED },
 	  { "duration" } },
@@ -1145,6 +1242,7 @@ struct m0_addb2__id_intrp ids[] = {
 	{ M0_AVI_STOB_IOQ_INFLIGHT, "stob-ioq-inflight", { HIST } },
 	{ M0_AVI_STOB_IOQ_QUEUED, "stob-ioq-queued", { HIST } },
 	{ M0_AVI_STOB_IOQ_GOT,    "stob-ioq-got",    { HIST } },
+	{ M0_AVI_STOB_IOQ_LATENCY, "stob-ioq-latency", { HIST } },
 
 	{ M0_AVI_RPC_LOCK,        "rpc-machine-lock", { &ptr } },
 	{ M0_AVI_RPC_REPLIED,     "rpc-replied",      { &ptr, &rpcop } },
@@ -1174,6 +1272,8 @@ struct m0_addb2__id_intrp ids[] = {
 	  .ii_spec   = &beop_state_counter },
 	{ M0_AVI_BE_TX_TO_GROUP,  "tx-to-gr", { &dec, &dec, &dec },
 	  { "tx_id", "gr_id", "inout" } },
+	{ M0_AVI_BE_ALLOC_LOCK,   "be-alloc-lock",   { &ptr, &duration },
+	  { "allocator", "wait" } },
 	{ M0_AVI_NET_BUF,         "net-buf",         { &ptr, &dec, &_clock,
 						       &duration, &dec, &dec },
 	  { "buf", "qtype", "time", "duration", "status", "len" } },
@@ -1187,6 +1287,12 @@ struct m0_addb2__id_intrp ids[] = {
 	  { "fom", "wait", "hold"} },
 	{ M0_AVI_CAS_KV_SIZES,    "cas-kv-sizes",  { FID, &dec, &dec },
 	  { "ifid", NULL, "ksize", "vsize"} },
+	{ M0_AVI_CAS_CTG_FILTER,  "cas-ctg-filter",
+	  { &ptr, &dec, &dec, &dec, &dec },
+	  { "ctg", "lookups", "negatives", "false_pos", "keys" } },
+	{ M0_AVI_CAS_CTG_FILTER_BUILD, "cas-ctg-filter-build",
+	  { &ptr, &dec, &dec, &duration },
+	  { "ctg", "keys", "counters", "duration" } },
 
 	/* client -> md|io-path */
 	{ M0_AVI_CLIENT_SM_OP,         "op-state", { &op_state, SKIP2 } },
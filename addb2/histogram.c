@@ -30,6 +30,9 @@
 #include "lib/trace.h"
 #include "addb2/histogram.h"
 #include "addb2/internal.h"               /* m0_addb2__counter_snapshot */
+#include "lib/arith.h"                    /* m0_log2, min64u */
+#include "lib/errno.h"                    /* EPROTO */
+#include "lib/memory.h"                   /* M0_ALLOC_ARR */
 
 static const struct m0_addb2_sensor_ops hist_ops;
 
@@ -60,9 +63,28 @@ void m0_addb2_hist_add_auto(struct m0_addb2_hist *hist, int skip,
 	m0_addb2_sensor_add(&c->co_sensor, label, VALUE_MAX_NR, idx, &hist_ops);
 }
 
+void m0_addb2_hist_add_log(struct m0_addb2_hist *hist, int precision,
+			   uint64_t label, int idx)
+{
+	struct m0_addb2_counter *c = &hist->hi_counter;
+
+	M0_PRE(M0_IS0(hist));
+	M0_PRE(0 < precision && precision <= M0_ADDB2_LOGHIST_PRECISION_MAX);
+
+	m0_addb2__counter_data_init(&c->co_val);
+	hist->hi_precision = precision;
+	m0_addb2_sensor_add(&c->co_sensor, label, VALUE_MAX_NR, idx, &hist_ops);
+}
+
+static void loghist_free(struct m0_addb2_hist *hist)
+{
+	m0_free0(&hist->hi_log);
+}
+
 void m0_addb2_hist_del(struct m0_addb2_hist *hist)
 {
 	m0_addb2_sensor_del(&hist->hi_counter.co_sensor);
+	loghist_free(hist);
 }
 
 void m0_addb2_hist_mod(struct m0_addb2_hist *hist, int64_t val)
@@ -74,8 +96,19 @@ void m0_addb2_hist_mod_with(struct m0_addb2_hist *hist,
 			    int64_t val, uint64_t datum)
 {
 	struct m0_addb2_hist_data *hd = &hist->hi_data;
+	uint32_t                  *b;
 
-	if (hist->hi_skip > 0) {
+	if (hist->hi_precision > 0) {
+		if (hist->hi_log == NULL)
+			M0_ALLOC_ARR(hist->hi_log,
+				     M0_ADDB2_LOGHIST_NR(hist->hi_precision));
+		/* If allocation failed, only counter data are updated. */
+		if (hist->hi_log != NULL) {
+			b = &hist->hi_log[m0_addb2_hist_bucket(hist, val)];
+			if (*b < UINT32_MAX)
+				++*b;
+		}
+	} else if (hist->hi_skip > 0) {
 		hd->hd_min = min64(hd->hd_min, val);
 		hd->hd_max = max64(hd->hd_max, val);
 		hist->hi_skip--;
@@ -89,6 +122,8 @@ int m0_addb2_hist_bucket(const struct m0_addb2_hist *hist, int64_t val)
 	const struct m0_addb2_hist_data *hd = &hist->hi_data;
 	int                              idx;
 
+	if (hist->hi_precision > 0)
+		return m0_addb2_loghist_idx(hist->hi_precision, val);
 	if (val < hd->hd_min)
 		idx = 0;
 	else if (val >= hd->hd_max)
@@ -100,7 +135,151 @@ int m0_addb2_hist_bucket(const struct m0_addb2_hist *hist, int64_t val)
 	return idx;
 }
 
-static void hist_snapshot(struct m0_addb2_sensor *s, uint64_t *area)
+int m0_addb2_loghist_idx(int precision, int64_t val)
+{
+	uint64_t v;
+	unsigned shift;
+
+	M0_PRE(0 < precision && precision <= M0_ADDB2_LOGHIST_PRECISION_MAX);
+
+	if (val <= 0)
+		return 0;
+	v = min64u(val, (1ULL << M0_ADDB2_LOGHIST_VALUE_BITS) - 1);
+	if (v < (1ULL << precision))
+		return v;
+	shift = m0_log2(v) - precision + 1;
+	return (shift << (precision - 1)) + (v >> shift);
+}
+
+uint64_t m0_addb2_loghist_low(int precision, int idx)
+{
+	int half = 1 << (precision - 1);
+	int shift;
+
+	M0_PRE(0 <= idx && idx < M0_ADDB2_LOGHIST_NR(precision));
+
+	if (idx < 2 * half)
+		return idx;
+	shift = idx / half - 1;
+	return ((uint64_t)idx - shift * half) << shift;
+}
+
+uint64_t m0_addb2_loghist_high(int precision, int idx)
+{
+	int half = 1 << (precision - 1);
+
+	return m0_addb2_loghist_low(precision, idx) +
+		(idx < 2 * half ? 0 : (1ULL << (idx / half - 1)) - 1);
+}
+
+bool m0_addb2_loghist_is(const uint64_t *data)
+{
+	return (data[0] >> 32) == M0_ADDB2_LOGHIST_MAGIC;
+}
+
+int m0_addb2_loghist_precision(const uint64_t *data)
+{
+	return (data[0] >> 8) & 0xff;
+}
+
+static uint32_t loghist_entry(const uint64_t *data, int i)
+{
+	return data[1 + i / 2] >> (32 * (i % 2));
+}
+
+static int loghist_entry_idx(uint32_t entry)
+{
+	return entry & ((1 << M0_ADDB2_LOGHIST_IDX_BITS) - 1);
+}
+
+int m0_addb2_loghist_merge(const uint64_t *data, int precision,
+			   uint64_t *bucket)
+{
+	int nr = data[0] & 0xff;
+	int i;
+
+	M0_PRE(0 < precision && precision <= M0_ADDB2_LOGHIST_PRECISION_MAX);
+
+	if (!m0_addb2_loghist_is(data) ||
+	    m0_addb2_loghist_precision(data) != precision ||
+	    nr > M0_ADDB2_LOGHIST_ENTRIES ||
+	    !m0_forall(j, nr, loghist_entry_idx(loghist_entry(data, j)) <
+		       M0_ADDB2_LOGHIST_NR(precision)))
+		return M0_ERR(-EPROTO);
+	for (i = 0; i < nr; ++i) {
+		uint32_t e = loghist_entry(data, i);
+
+		bucket[loghist_entry_idx(e)] += e >> M0_ADDB2_LOGHIST_IDX_BITS;
+	}
+	return 0;
+}
+
+uint64_t m0_addb2_loghist_percentile(int precision, const uint64_t *bucket,
+				     unsigned permille)
+{
+	int      nr    = M0_ADDB2_LOGHIST_NR(precision);
+	uint64_t total = 0;
+	uint64_t seen  = 0;
+	uint64_t target;
+	int      i;
+
+	M0_PRE(0 < precision && precision <= M0_ADDB2_LOGHIST_PRECISION_MAX);
+	M0_PRE(permille <= 1000);
+
+	for (i = 0; i < nr; ++i)
+		total += bucket[i];
+	if (total == 0)
+		return 0;
+	target = max64u((total * permille + 999) / 1000, 1);
+	for (i = 0; i < nr - 1; ++i) {
+		seen += bucket[i];
+		if (seen >= target)
+			break;
+	}
+	return m0_addb2_loghist_high(precision, i);
+}
+
+/**
+ * Packs non-empty log-linear buckets in the record, starting from
+ * m0_addb2_hist::hi_log_next, and subtracts recorded counts from the buckets.
+ */
+static void loghist_snapshot(struct m0_addb2_hist *hist, uint64_t *area)
+{
+	int      nr    = M0_ADDB2_LOGHIST_NR(hist->hi_precision);
+	int      start = hist->hi_log_next;
+	uint32_t limit = (1 << M0_ADDB2_LOGHIST_COUNT_BITS) - 1;
+	uint32_t count;
+	bool     more  = false;
+	int      n     = 0;
+	int      idx;
+	int      i;
+
+	for (i = 0; i < M0_ADDB2_LOGHIST_ENTRIES / 2; ++i)
+		area[1 + i] = 0;
+	for (i = 0; hist->hi_log != NULL && i < nr; ++i) {
+		idx = (start + i) % nr;
+		if (hist->hi_log[idx] == 0)
+			continue;
+		if (n == M0_ADDB2_LOGHIST_ENTRIES) {
+			more = true;
+			break;
+		}
+		count = min32u(hist->hi_log[idx], limit);
+		hist->hi_log[idx] -= count;
+		more |= hist->hi_log[idx] > 0;
+		area[1 + n / 2] |= ((uint64_t)idx |
+				    count << M0_ADDB2_LOGHIST_IDX_BITS) <<
+			(32 * (n % 2));
+		hist->hi_log_next = (idx + 1) % nr;
+		++n;
+	}
+	area[0] = ((uint64_t)M0_ADDB2_LOGHIST_MAGIC << 32) |
+		(more ? M0_ADDB2_LOGHIST_MORE : 0) |
+		hist->hi_precision << 8 | n;
+}
+
+M0_INTERNAL void m0_addb2__hist_snapshot(struct m0_addb2_sensor *s,
+					 uint64_t *area)
 {
 	struct m0_addb2_hist      *hist = M0_AMB(hist, s, hi_counter.co_sensor);
 	struct m0_addb2_hist_data *hd   = &hist->hi_data;
@@ -108,16 +287,24 @@ static void hist_snapshot(struct m0_addb2_sensor *s, uint64_t *area)
 
 	m0_addb2__counter_snapshot(s, area);
 	area += M0_ADDB2_COUNTER_VALS;
+	if (hist->hi_precision > 0) {
+		loghist_snapshot(hist, area);
+		return;
+	}
 	*(struct m0_addb2_hist_data *)area = *hd;
 	for (i = 0; i < ARRAY_SIZE(hd->hd_bucket); ++i)
 		hd->hd_bucket[i] = 0;
 }
 
 static void hist_fini(struct m0_addb2_sensor *s)
-{;}
+{
+	struct m0_addb2_hist *hist = M0_AMB(hist, s, hi_counter.co_sensor);
+
+	loghist_free(hist);
+}
 
 static const struct m0_addb2_sensor_ops hist_ops = {
-	.so_snapshot = &hist_snapshot,
+	.so_snapshot = &m0_addb2__hist_snapshot,
 	.so_fini     = &hist_fini
 };
 
@@ -81,6 +81,33 @@
  * point on, buckets are updated. This is suitable for situations where
  * distribution of values is now known in advance, e.g., network latencies.
  *
+ * Log-linear histograms
+ * ---------------------
+ *
+ * A histogram initialised with m0_addb2_hist_add_log() does not use minimum,
+ * maximum and linear buckets. Instead, similarly to HdrHistogram, values are
+ * placed in log-linear buckets determined by a "precision" parameter P: each
+ * value below 2^P has a bucket of its own and each larger power-of-two range
+ * [2^k, 2^(k+1)) is split into 2^(P-1) buckets of equal width. The relative
+ * width of any bucket is thus below 2^-(P-1), independently of the value
+ * range. Negative values are placed in bucket 0, values not less than
+ * 2^M0_ADDB2_LOGHIST_VALUE_BITS in the last bucket.
+ *
+ * Bucket boundaries depend on nothing but the precision, so buckets of
+ * log-linear histograms with the same precision, produced by different
+ * localities, processes or nodes, can be merged by simple addition
+ * (m0_addb2_loghist_merge()). Percentiles of the merged distribution are
+ * computed by m0_addb2_loghist_percentile().
+ *
+ * Log-linear buckets are too numerous to fit in an addb2 record and most of
+ * them are typically empty. Buckets are allocated on the first update and
+ * only non-empty buckets are recorded: after counter data, the record
+ * contains a header word (with M0_ADDB2_LOGHIST_MAGIC in the upper half),
+ * followed by up to M0_ADDB2_LOGHIST_ENTRIES (index, count) pairs packed in
+ * 32-bit entries. Buckets that do not fit in a record (or counts that
+ * overflow an entry) are carried over to the next record, so that no update
+ * is lost, but the buckets of a record can lag behind its counter data.
+ *
  * @{
  */
 
@@ -101,6 +128,37 @@ enum {
 
 M0_BASSERT(M0_ADDB2_HIST_BUCKETS >= 2);
 
+enum {
+	/** Maximal precision of a log-linear histogram. */
+	M0_ADDB2_LOGHIST_PRECISION_MAX = 8,
+	/**
+	 * Precision used for latencies: buckets are at most 1/8 of their
+	 * values wide.
+	 */
+	M0_ADDB2_LOGHIST_PRECISION     = 4,
+	/** Values up to 2^M0_ADDB2_LOGHIST_VALUE_BITS - 1 are distinguished. */
+	M0_ADDB2_LOGHIST_VALUE_BITS    = 48,
+	/** Marks a log-linear histogram record (upper half of the header). */
+	M0_ADDB2_LOGHIST_MAGIC         = 0x4c6f6748, /* "LogH" */
+	/** Bits of a record entry used for the bucket index. */
+	M0_ADDB2_LOGHIST_IDX_BITS      = 13,
+	/** Bits of a record entry used for the bucket count. */
+	M0_ADDB2_LOGHIST_COUNT_BITS    = 32 - M0_ADDB2_LOGHIST_IDX_BITS,
+	/** Header flag: some buckets are carried to the next record. */
+	M0_ADDB2_LOGHIST_MORE          = 1 << 16,
+	/** Maximal number of (index, count) entries in a record. */
+	M0_ADDB2_LOGHIST_ENTRIES       =
+		2 * (VALUE_MAX_NR - M0_ADDB2_COUNTER_VALS - 1)
+};
+
+/** Number of buckets in a log-linear histogram with the given precision. */
+#define M0_ADDB2_LOGHIST_NR(precision)					\
+	((M0_ADDB2_LOGHIST_VALUE_BITS - (precision) + 2) << ((precision) - 1))
+
+M0_BASSERT(M0_ADDB2_LOGHIST_NR(M0_ADDB2_LOGHIST_PRECISION_MAX) <=
+	   M0_BITS(M0_ADDB2_LOGHIST_IDX_BITS));
+M0_BASSERT(M0_ADDB2_LOGHIST_ENTRIES < 256);
+
 /**
  * Data (in addition to counter data, m0_addb2_counter_data), produced by the
  * histogram.
@@ -132,6 +190,17 @@ struct m0_addb2_hist {
 	/** Remaining updates in the auto-tuning period. */
 	int                       hi_skip;
 	struct m0_addb2_hist_data hi_data;
+	/**
+	 * Precision of a log-linear histogram, 0 for a linear histogram.
+	 */
+	int                       hi_precision;
+	/**
+	 * Log-linear buckets, M0_ADDB2_LOGHIST_NR(hi_precision) of them.
+	 * Allocated on the first update.
+	 */
+	uint32_t                 *hi_log;
+	/** Log-linear bucket from which the next record starts. */
+	uint32_t                  hi_log_next;
 };
 
 void m0_addb2_hist_add(struct m0_addb2_hist *hist, int64_t min, int64_t max,
@@ -144,6 +213,46 @@ void m0_addb2_hist_mod_with(struct m0_addb2_hist *hist,
 			    int64_t val, uint64_t datum);
 int m0_addb2_hist_bucket(const struct m0_addb2_hist *hist, int64_t val);
 
+/**
+ * Initialises a log-linear histogram with the given precision
+ * (1 <= precision <= M0_ADDB2_LOGHIST_PRECISION_MAX).
+ *
+ * m0_addb2_hist_mod(), m0_addb2_hist_mod_with(), m0_addb2_hist_del() and
+ * M0_ADDB2_HIST() work with log-linear histograms as with the linear ones.
+ */
+void m0_addb2_hist_add_log(struct m0_addb2_hist *hist, int precision,
+			   uint64_t label, int idx);
+
+/** Returns the log-linear bucket for the value. */
+int      m0_addb2_loghist_idx(int precision, int64_t val);
+/** Returns the smallest value falling in the log-linear bucket. */
+uint64_t m0_addb2_loghist_low(int precision, int idx);
+/** Returns the largest value falling in the log-linear bucket. */
+uint64_t m0_addb2_loghist_high(int precision, int idx);
+
+/**
+ * True iff the histogram record data (following the counter data) were
+ * produced by a log-linear histogram.
+ */
+bool m0_addb2_loghist_is(const uint64_t *data);
+/** Returns the precision of the log-linear histogram record data. */
+int  m0_addb2_loghist_precision(const uint64_t *data);
+/**
+ * Adds bucket counts from the log-linear histogram record data to the array
+ * of M0_ADDB2_LOGHIST_NR(precision) buckets.
+ *
+ * Returns -EPROTO if the data are malformed or have a different precision.
+ */
+int  m0_addb2_loghist_merge(const uint64_t *data, int precision,
+			    uint64_t *bucket);
+/**
+ * Returns the upper bound of the log-linear bucket containing the permille-th
+ * (1/1000) fraction of the values counted in the array of buckets, or 0 if
+ * the buckets are empty.
+ */
+uint64_t m0_addb2_loghist_percentile(int precision, const uint64_t *bucket,
+				     unsigned permille);
+
 #define M0_ADDB2_HIST(id, hist, datum, ...)				\
 do {									\
 	struct m0_addb2_hist *__hist = (hist);				\
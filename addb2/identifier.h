@@ -99,6 +99,18 @@ enum m0_addb2_value_id {
 	M0_AVI_LONG_LOCK,
 	/** Measurement: generic attribute. */
 	M0_AVI_ATTR,
+	/** Measurement: run queue length of a fom priority class. */
+	M0_AVI_RUNQ_PRIO,
+	M0_AVI_RUNQ_PRIO_END = M0_AVI_RUNQ_PRIO + 0x8,
+	/** Measurement: run queue wait time of a fom priority class. */
+	M0_AVI_RUNQ_WAIT,
+	M0_AVI_RUNQ_WAIT_END = M0_AVI_RUNQ_WAIT + 0x8,
+	/** Measurement: foms handed over to an idle locality. */
+	M0_AVI_LOCALITY_STEAL,
+	/** Measurement: locality utilisation and steals in a period. */
+	M0_AVI_LOCALITY_UTIL,
+	/** Measurement: fom moved to another locality. */
+	M0_AVI_FOM_MOVE,
 
 	M0_AVI_LIB_RANGE_START     = 0x3000,
 	/** Measurement: memory allocation. */
@@ -84,6 +84,8 @@ struct m0_addb2_sensor;
 M0_INTERNAL void m0_addb2__counter_snapshot(struct m0_addb2_sensor *s,
 					    uint64_t *area);
 M0_INTERNAL void m0_addb2__counter_data_init(struct m0_addb2_counter_data *d);
+M0_INTERNAL void m0_addb2__hist_snapshot(struct m0_addb2_sensor *s,
+					 uint64_t *area);
 
 enum {
 	/**
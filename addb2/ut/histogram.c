@@ -22,8 +22,10 @@
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_UT
 
 #include "lib/trace.h"
+#include "lib/errno.h"                    /* EPROTO */
 #include "ut/ut.h"
 #include "addb2/histogram.h"
+#include "addb2/internal.h"               /* m0_addb2__hist_snapshot */
 
 #include "addb2/ut/common.h"
 
@@ -102,6 +104,94 @@ static void test_bucket(void)
 	}
 }
 
+static void test_log_bucket(void)
+{
+	int precision;
+	int nr;
+	int i;
+
+	for (precision = 1; precision <= M0_ADDB2_LOGHIST_PRECISION_MAX;
+	     ++precision) {
+		nr = M0_ADDB2_LOGHIST_NR(precision);
+		M0_UT_ASSERT(m0_addb2_loghist_idx(precision, -1) == 0);
+		M0_UT_ASSERT(m0_addb2_loghist_idx(precision, INT64_MAX) ==
+			     nr - 1);
+		for (i = 0; i < nr; ++i) {
+			uint64_t low  = m0_addb2_loghist_low(precision, i);
+			uint64_t high = m0_addb2_loghist_high(precision, i);
+
+			M0_UT_ASSERT(low <= high);
+			M0_UT_ASSERT(m0_addb2_loghist_idx(precision, low) == i);
+			M0_UT_ASSERT(m0_addb2_loghist_idx(precision, high) == i);
+			M0_UT_ASSERT(ergo(i + 1 < nr, high + 1 ==
+				     m0_addb2_loghist_low(precision, i + 1)));
+			/* Relative bucket width is bounded by the precision. */
+			M0_UT_ASSERT(((high - low) << (precision - 1)) <= low);
+		}
+	}
+}
+
+enum { LOG_P = M0_ADDB2_LOGHIST_PRECISION };
+
+static uint64_t log_ref[M0_ADDB2_LOGHIST_NR(LOG_P)];
+static uint64_t log_got[M0_ADDB2_LOGHIST_NR(LOG_P)];
+
+/** Reads out the histogram until all buckets are recorded. */
+static void log_drain(struct m0_addb2_hist *h)
+{
+	uint64_t area[VALUE_MAX_NR];
+	uint64_t *data = &area[M0_ADDB2_COUNTER_VALS];
+	int       rc;
+
+	do {
+		m0_addb2__hist_snapshot(&h->hi_counter.co_sensor, area);
+		M0_UT_ASSERT(m0_addb2_loghist_is(data));
+		M0_UT_ASSERT(m0_addb2_loghist_precision(data) == LOG_P);
+		rc = m0_addb2_loghist_merge(data, LOG_P, log_got);
+		M0_UT_ASSERT(rc == 0);
+	} while ((data[0] & M0_ADDB2_LOGHIST_MORE) || (data[0] & 0xff) != 0);
+	rc = m0_addb2_loghist_merge(data, LOG_P + 1, log_got);
+	M0_UT_ASSERT(rc == -EPROTO);
+}
+
+static void test_log(void)
+{
+	struct m0_addb2_hist h = {};
+	int64_t              val;
+	uint64_t             p;
+	int                  i;
+
+	M0_SET0(&log_ref);
+	M0_SET0(&log_got);
+	m0_addb2_hist_add_log(&h, LOG_P, 6, -1);
+	/* 1000 distinct values, more than fit in a record. */
+	for (i = 1; i <= 1000; ++i) {
+		val = i * 997;
+		m0_addb2_hist_mod(&h, val);
+		log_ref[m0_addb2_loghist_idx(LOG_P, val)]++;
+	}
+	/* A count which does not fit in a record entry. */
+	for (i = 0; i < 600000; ++i)
+		m0_addb2_hist_mod(&h, 3);
+	log_ref[3] += 600000;
+	log_drain(&h);
+	M0_UT_ASSERT(memcmp(log_ref, log_got, sizeof log_ref) == 0);
+	M0_UT_ASSERT(m0_forall(j, M0_ADDB2_LOGHIST_NR(LOG_P),
+			       h.hi_log[j] == 0));
+
+	M0_SET0(&log_got);
+	for (i = 1; i <= 1000; ++i)
+		m0_addb2_hist_mod(&h, i * 1000);
+	log_drain(&h);
+	for (i = 1; i <= 1000; ++i) {
+		p = m0_addb2_loghist_percentile(LOG_P, log_got, i);
+		M0_UT_ASSERT(i * 1000 <= p);
+		M0_UT_ASSERT(p < i * 1000 + (i * 1000 >> (LOG_P - 1)));
+	}
+	m0_addb2_hist_del(&h);
+	M0_UT_ASSERT(h.hi_log == NULL);
+}
+
 struct m0_ut_suite addb2_hist_ut = {
 	.ts_name = "addb2-histogram",
 	.ts_init = NULL,
@@ -109,6 +199,8 @@ struct m0_ut_suite addb2_hist_ut = {
 	.ts_tests = {
 		{ "init-fini",      &init_fini },
 		{ "history-bucket", &test_bucket },
+		{ "log-bucket",     &test_log_bucket },
+		{ "log",            &test_log },
 		{ NULL, NULL }
 	}
 };
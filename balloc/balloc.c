@@ -374,8 +374,171 @@ static struct m0_mutex *bgi_mutex(struct m0_balloc_group_info *grp)
 	return &grp->bgi_mutex.bm_u.mutex;
 }
 
-static void lext_del(struct m0_lext *le)
+/**
+ * @name Size index of zone extents.
+ *
+ * Free extents of a loaded zone are linked, in addition to the offset-ordered
+ * bzp_extents list, into segregated lists by the binary order of their length
+ * (as in TLSF or buddy allocators), with a bitmap of non-empty lists. This
+ * finds a good fit, or the longest extent, of a zone without walking all its
+ * fragments.
+ */
+/** @{ */
+
+enum {
+	/** How many extents of the smallest fitting size class to examine. */
+	BALLOC_SIZE_CLASS_SCAN = 8,
+};
+
+static int zone_index_init(struct m0_balloc_zone_param *zp)
+{
+	int i;
+
+	M0_PRE(zp->bzp_size == NULL);
+
+	M0_ALLOC_ARR(zp->bzp_size, BALLOC_SIZE_CLASS_NR);
+	if (zp->bzp_size == NULL)
+		return M0_ERR(-ENOMEM);
+	for (i = 0; i < BALLOC_SIZE_CLASS_NR; ++i)
+		m0_list_init(&zp->bzp_size[i]);
+	zp->bzp_size_mask = 0;
+	return 0;
+}
+
+static void zone_index_fini(struct m0_balloc_zone_param *zp)
+{
+	int i;
+
+	if (zp->bzp_size == NULL)
+		return;
+	M0_PRE(zp->bzp_size_mask == 0);
+	for (i = 0; i < BALLOC_SIZE_CLASS_NR; ++i)
+		m0_list_fini(&zp->bzp_size[i]);
+	m0_free0(&zp->bzp_size);
+}
+
+static void zone_ext_add(struct m0_balloc_zone_param *zp, struct m0_lext *le)
+{
+	unsigned c = m0_log2(m0_ext_length(&le->le_ext));
+
+	M0_PRE(zp->bzp_size != NULL);
+	M0_PRE(m0_ext_length(&le->le_ext) > 0);
+
+	m0_list_add(&zp->bzp_size[c], &le->le_size_link);
+	le->le_size_class = c;
+	zp->bzp_size_mask |= 1ULL << c;
+}
+
+static void zone_ext_del(struct m0_balloc_zone_param *zp, struct m0_lext *le)
+{
+	unsigned c = le->le_size_class;
+
+	m0_list_del(&le->le_size_link);
+	if (m0_list_is_empty(&zp->bzp_size[c]))
+		zp->bzp_size_mask &= ~(1ULL << c);
+}
+
+/** Moves the extent to the size class of its new length. */
+static void zone_ext_resize(struct m0_balloc_zone_param *zp,
+			    struct m0_ext *ex)
+{
+	struct m0_lext *le = container_of(ex, struct m0_lext, le_ext);
+
+	if (m0_log2(m0_ext_length(ex)) != le->le_size_class) {
+		zone_ext_del(zp, le);
+		zone_ext_add(zp, le);
+	}
+}
+
+/**
+ * Returns the extent to satisfy a request for "len" blocks from: the shortest
+ * extent not shorter than "len" among the first BALLOC_SIZE_CLASS_SCAN
+ * extents of the size class of "len" or, failing that, of the next non-empty
+ * class. If no extent is long enough, returns the longest one. Returns NULL
+ * for a zone without free extents.
+ */
+static struct m0_ext *zone_ext_fit(struct m0_balloc_zone_param *zp,
+				   m0_bcount_t len)
+{
+	struct m0_lext *le;
+	struct m0_ext  *fit = NULL;
+	uint64_t        mask;
+	unsigned        c = m0_log2(len);
+	int             n = 0;
+
+	M0_PRE(zp->bzp_size != NULL);
+
+	if (zp->bzp_size_mask & (1ULL << c)) {
+		m0_list_for_each_entry(&zp->bzp_size[c], le, struct m0_lext,
+				       le_size_link) {
+			if (m0_ext_length(&le->le_ext) >= len &&
+			    (fit == NULL ||
+			     m0_ext_length(&le->le_ext) < m0_ext_length(fit)))
+				fit = &le->le_ext;
+			if (++n == BALLOC_SIZE_CLASS_SCAN)
+				break;
+		}
+		if (fit != NULL)
+			return fit;
+	}
+	/* Any extent of a higher class is long enough. */
+	mask = c + 1 < BALLOC_SIZE_CLASS_NR ?
+		zp->bzp_size_mask >> (c + 1) << (c + 1) : 0;
+	if (mask != 0) {
+		c = m0_log2(mask & -mask);
+		n = 0;
+		m0_list_for_each_entry(&zp->bzp_size[c], le, struct m0_lext,
+				       le_size_link) {
+			if (fit == NULL ||
+			    m0_ext_length(&le->le_ext) < m0_ext_length(fit))
+				fit = &le->le_ext;
+			if (++n == BALLOC_SIZE_CLASS_SCAN)
+				break;
+		}
+		return fit;
+	}
+	/* Nothing is long enough: the longest extent is in the top class. */
+	if (zp->bzp_size_mask == 0)
+		return NULL;
+	c = m0_log2(zp->bzp_size_mask);
+	m0_list_for_each_entry(&zp->bzp_size[c], le, struct m0_lext,
+			       le_size_link) {
+		if (fit == NULL ||
+		    m0_ext_length(&le->le_ext) > m0_ext_length(fit))
+			fit = &le->le_ext;
+	}
+	return fit;
+}
+
+/** Returns the length of the longest extent of the zone other than "skip". */
+static m0_bcount_t zone_maxchunk(struct m0_balloc_zone_param *zp,
+				 const struct m0_ext *skip)
+{
+	struct m0_lext *le;
+	m0_bcount_t     max  = 0;
+	uint64_t        mask = zp->bzp_size_mask;
+	unsigned        c;
+
+	M0_PRE(zp->bzp_size != NULL);
+
+	while (mask != 0 && max == 0) {
+		c = m0_log2(mask);
+		m0_list_for_each_entry(&zp->bzp_size[c], le, struct m0_lext,
+				       le_size_link) {
+			if (&le->le_ext != skip)
+				max = max_check(max,
+						m0_ext_length(&le->le_ext));
+		}
+		mask &= ~(1ULL << c);
+	}
+	return max;
+}
+
+/** @} */
+
+static void lext_del(struct m0_balloc_zone_param *zp, struct m0_lext *le)
 {
+	zone_ext_del(zp, le);
 	m0_list_del(&le->le_link);
 	if (le->le_is_alloc)
 		m0_free(le);
@@ -406,9 +569,10 @@ static void extents_release(struct m0_balloc_group_info *grp,
 	zp = is_spare(zone_type) ? &grp->bgi_spare : &grp->bgi_normal;
 	while ((l = m0_list_first(&zp->bzp_extents)) != NULL) {
 		le = m0_list_entry(l, struct m0_lext, le_link);
-		lext_del(le);
+		lext_del(zp, le);
 		++frags;
 	}
+	zone_index_fini(zp);
 	M0_LOG(M0_DEBUG, "zone_type = %d, grp=%p grpno=%" PRIu64 " list_frags=%d"
 	       "bzp_frags=%d", (int)zone_type, grp, grp->bgi_groupno,
 	       (int)frags, (int)zp->bzp_fragments);
@@ -517,6 +681,100 @@ static void balloc_group_info_fini(struct m0_balloc_group_info *gi)
 	m0_list_fini(&gi->bgi_spare.bzp_extents);
 }
 
+/** Value of the group leaf of m0_balloc_summary. */
+static m0_bcount_t summary_value(struct m0_balloc_group_info *grp)
+{
+	return group_freeblocks_get(grp) == 0 ||
+		group_fragments_get(grp) == 0 ? 0 :
+		max64u(group_maxchunk_get(grp), 1);
+}
+
+static int balloc_summary_init(struct m0_balloc *bal)
+{
+	struct m0_balloc_summary *s;
+	m0_bcount_t               nr = bal->cb_sb.bsb_groupcount;
+	m0_bcount_t               i;
+
+	M0_ALLOC_PTR(s);
+	if (s == NULL)
+		return M0_ERR(-ENOMEM);
+	for (s->bs_leaves = 1; s->bs_leaves < nr; s->bs_leaves <<= 1)
+		;
+	M0_ALLOC_ARR(s->bs_max, 2 * s->bs_leaves);
+	if (s->bs_max == NULL) {
+		m0_free(s);
+		return M0_ERR(-ENOMEM);
+	}
+	for (i = 0; i < nr; ++i)
+		s->bs_max[s->bs_leaves + i] =
+			summary_value(&bal->cb_group_info[i]);
+	for (i = s->bs_leaves - 1; i > 0; --i)
+		s->bs_max[i] = max64u(s->bs_max[2 * i], s->bs_max[2 * i + 1]);
+	m0_mutex_init(&s->bs_lock);
+	bal->cb_summary = s;
+	return 0;
+}
+
+static void balloc_summary_fini(struct m0_balloc *bal)
+{
+	struct m0_balloc_summary *s = bal->cb_summary;
+
+	if (s != NULL) {
+		m0_mutex_fini(&s->bs_lock);
+		m0_free(s->bs_max);
+		m0_free0(&bal->cb_summary);
+	}
+}
+
+/** Called when free space of the group changes, under the group lock. */
+static void balloc_summary_update(struct m0_balloc *bal,
+				  struct m0_balloc_group_info *grp)
+{
+	struct m0_balloc_summary *s = bal->cb_summary;
+	m0_bcount_t               val = summary_value(grp);
+	m0_bcount_t               n;
+
+	if (s == NULL)
+		return;
+	n = s->bs_leaves + grp->bgi_groupno;
+	m0_mutex_lock(&s->bs_lock);
+	if (s->bs_max[n] != val) {
+		s->bs_max[n] = val;
+		for (n >>= 1; n > 0; n >>= 1)
+			s->bs_max[n] = max64u(s->bs_max[2 * n],
+					      s->bs_max[2 * n + 1]);
+	}
+	m0_mutex_unlock(&s->bs_lock);
+}
+
+/**
+ * Returns the first group starting from "group" which has a free extent of at
+ * least "min" blocks in the normal zone, or the group count if there is none.
+ *
+ * Runs without locks, the result is a hint.
+ */
+static m0_bcount_t balloc_summary_find(const struct m0_balloc *bal,
+				       m0_bcount_t group, m0_bcount_t min)
+{
+	const struct m0_balloc_summary *s = bal->cb_summary;
+	m0_bcount_t                     n = s->bs_leaves + group;
+
+	M0_PRE(min > 0);
+
+	/* Go up until a right sibling has a suitable group below it... */
+	while (s->bs_max[n] < min) {
+		while ((n & 1) != 0)
+			n >>= 1;
+		if (n == 0)
+			return bal->cb_sb.bsb_groupcount;
+		++n;
+	}
+	/* ... and down to the leftmost suitable group. */
+	while (n < s->bs_leaves)
+		n = s->bs_max[2 * n] >= min ? 2 * n : 2 * n + 1;
+	return min64u(n - s->bs_leaves, bal->cb_sb.bsb_groupcount);
+}
+
 static int balloc_group_info_load(struct m0_balloc *bal)
 {
 	struct m0_balloc_group_info *gi;
@@ -533,6 +791,7 @@ static int balloc_group_info_load(struct m0_balloc *bal)
 
 		/* TODO verify the super_block info based on the group info */
 	}
+	rc = rc ?: balloc_summary_init(bal);
 	while (rc != 0 && i > 0) {
 		balloc_group_info_fini(&bal->cb_group_info[--i]);
 	}
@@ -550,6 +809,7 @@ static void balloc_fini_internal(struct m0_balloc *bal)
 
 	M0_ENTRY();
 
+	balloc_summary_fini(bal);
 	if (bal->cb_group_info != NULL) {
 		for (i = 0 ; i < bal->cb_sb.bsb_groupcount; i++) {
 			gi = &bal->cb_group_info[i];
@@ -873,6 +1133,8 @@ static void balloc_zone_init(struct m0_balloc_zone_param *zone, uint64_t type,
 	zone->bzp_fragments = fragments;
 	zone->bzp_maxchunk = maxchunk;
 	m0_list_init(&zone->bzp_extents);
+	zone->bzp_size = NULL;
+	zone->bzp_size_mask = 0;
 }
 
 static int balloc_groups_write(struct m0_balloc *bal)
@@ -1056,6 +1318,7 @@ static int balloc_init_internal(struct m0_balloc *bal,
 
 	bal->cb_be_seg = seg;
 	bal->cb_group_info = NULL;
+	bal->cb_summary = NULL;
 	m0_mutex_init(&bal->cb_sb_mutex.bm_u.mutex);
 
 	M0_ALLOC_PTR(bal->cb_db_group_desc);
@@ -1313,10 +1576,19 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 		return M0_RC(0);
 	}
 
+	rc = zone_index_init(&grp->bgi_normal) ?:
+		zone_index_init(&grp->bgi_spare);
+	if (rc != 0) {
+		m0_balloc_release_extents(grp);
+		return M0_RC(rc);
+	}
+
 	M0_ALLOC_ARR(grp->bgi_extents, group_fragments_get(grp) +
 		     group_spare_fragments_get(grp) + 1);
-	if (grp->bgi_extents == NULL)
+	if (grp->bgi_extents == NULL) {
+		m0_balloc_release_extents(grp);
 		return M0_RC(-ENOMEM);
+	}
 
 	if (group_fragments_get(grp) == 0 &&
 	    group_spare_fragments_get(grp) == 0) {
@@ -1348,11 +1620,13 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 		ex->le_ext.e_end   = m0_byteorder_be64_to_cpu(ex->le_ext.e_end);
 		ex->le_ext.e_start = *(m0_bindex_t*)val.b_addr;
 		m0_ext_init(&ex->le_ext);
-		if (m0_ext_is_partof(&normal_range, &ex->le_ext))
+		if (m0_ext_is_partof(&normal_range, &ex->le_ext)) {
 			m0_list_add_tail(group_normal_ext(grp), &ex->le_link);
-		else if (m0_ext_is_partof(&spare_range, &ex->le_ext))
+			zone_ext_add(&grp->bgi_normal, ex);
+		} else if (m0_ext_is_partof(&spare_range, &ex->le_ext)) {
 			m0_list_add_tail(group_spare_ext(grp), &ex->le_link);
-		else {
+			zone_ext_add(&grp->bgi_spare, ex);
+		} else {
 			M0_LOG(M0_ERROR, "Invalid extent");
 			M0_ASSERT(false);
 		}
@@ -1411,6 +1685,13 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 		return M0_RC(0);
 	}
 
+	rc = zone_index_init(&grp->bgi_normal) ?:
+		zone_index_init(&grp->bgi_spare);
+	if (rc != 0) {
+		m0_balloc_release_extents(grp);
+		return M0_RC(rc);
+	}
+
 	if (group_fragments_get(grp) +
 	    group_spare_fragments_get(grp) == 0) {
 		M0_LOG(M0_NOTICE, "zero fragments");
@@ -1420,8 +1701,10 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 
 	M0_ALLOC_ARR(grp->bgi_extents, group_fragments_get(grp) +
 		     group_spare_fragments_get(grp) + 1);
-	if (grp->bgi_extents == NULL)
+	if (grp->bgi_extents == NULL) {
+		m0_balloc_release_extents(grp);
 		return M0_RC(-ENOMEM);
+	}
 
 	spare_range.e_start = grp->bgi_spare.bzp_range.e_start;
 	spare_range.e_end = (grp->bgi_groupno + 1) << cb->cb_sb.bsb_gsbits;
@@ -1449,11 +1732,13 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 		m0_ext_init(&ex->le_ext);
 		if (m0_ext_is_partof(&normal_range, &ex->le_ext)) {
 			m0_list_add_tail(group_normal_ext(grp), &ex->le_link);
+			zone_ext_add(&grp->bgi_normal, ex);
 			++normal_frags;
 			zone_params_update(grp, &ex->le_ext,
 					   M0_BALLOC_NORMAL_ZONE);
 		} else if (m0_ext_is_partof(&spare_range, &ex->le_ext)) {
 			m0_list_add_tail(group_spare_ext(grp), &ex->le_link);
+			zone_ext_add(&grp->bgi_spare, ex);
 			++spare_frags;
 			zone_params_update(grp, &ex->le_ext,
 					   M0_BALLOC_SPARE_ZONE);
@@ -1476,6 +1761,7 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 		grp->bgi_normal.bzp_fragments = normal_frags;
 		grp->bgi_spare.bzp_fragments = spare_frags;
 		grp->bgi_extents_loaded = true;
+		balloc_summary_update(cb, grp);
 	}
 
 	return M0_RC(rc);
@@ -1529,8 +1815,10 @@ static int balloc_find_extent_buddy(struct balloc_allocation_context *bac,
 					.e_end = 0xffffffff,
 				     };
 	struct m0_balloc_zone_param *zp;
+	unsigned                     c;
 
 	M0_PRE(m0_mutex_is_locked(bgi_mutex(grp)));
+	M0_PRE(m0_is_po2(len));
 
 	m0_ext_init(&min);
 
@@ -1540,37 +1828,28 @@ static int balloc_find_extent_buddy(struct balloc_allocation_context *bac,
 	       zp->bzp_range.e_start, len);
 
 	start = zp->bzp_range.e_start;
-	m0_list_for_each_entry(&zp->bzp_extents, le, struct m0_lext, le_link) {
-		frag = &le->le_ext;
-		flen = m0_ext_length(frag);
-		M0_LOG(M0_DEBUG, "frag="EXT_F, EXT_P(frag));
-repeat:
-		/*
-		{
-			char msg[128];
-			sprintf(msg, "buddy[s=%llu:0x%08llx, l=%u:0x%08x]",
-			(unsigned long long)start,
-			(unsigned long long)start,
-			(int)len, (int)len);
-			(void)msg;
-			balloc_debug_dump_extent(msg, frag);
+	/*
+	 * Look for a len-aligned fragment in the size classes from the one of
+	 * len up. Any fragment of a higher class is longer than all fragments
+	 * of a lower one, so stop at the first class having one.
+	 */
+	for (c = m0_log2(len); c < BALLOC_SIZE_CLASS_NR && found == 0; ++c) {
+		if ((zp->bzp_size_mask & (1ULL << c)) == 0)
+			continue;
+		m0_list_for_each_entry(&zp->bzp_size[c], le, struct m0_lext,
+				       le_size_link) {
+			frag = &le->le_ext;
+			flen = m0_ext_length(frag);
+			M0_LOG(M0_DEBUG, "frag="EXT_F, EXT_P(frag));
+			if (((frag->e_start - start) & (len - 1)) == 0 &&
+			    flen >= len) {
+				++found;
+				if (flen < m0_ext_length(&min))
+					min = *frag;
+				if (flen == len ||
+				    found > M0_BALLOC_BUDDY_LOOKUP_MAX)
+					break;
 			}
-		*/
-		if (frag->e_start == start && flen >= len) {
-			++found;
-			if (flen < m0_ext_length(&min))
-				min = *frag;
-			if (flen == len || found > M0_BALLOC_BUDDY_LOOKUP_MAX)
-				break;
-		}
-		if (frag->e_start > start) {
-			do {
-				start += len;
-			} while (frag->e_start > start);
-			if (start >= zp->bzp_range.e_end)
-				break;
-			/* we changed the 'start'. let's restart searching. */
-			goto repeat;
 		}
 	}
 
@@ -1699,17 +1978,9 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 
 	balloc_debug_dump_extent("current=", cur);
 
-	if (m0_ext_length(cur) == zp->bzp_maxchunk) {
+	if (m0_ext_length(cur) == zp->bzp_maxchunk)
 		/* find next to max sized chunk */
-		maxchunk = 0;
-		m0_list_for_each_entry(&zp->bzp_extents, le,
-				       struct m0_lext, le_link) {
-			if (&le->le_ext == cur)
-				continue;
-			maxchunk = max_check(maxchunk,
-					     m0_ext_length(&le->le_ext));
-		}
-	}
+		maxchunk = zone_maxchunk(zp, cur);
 
 	M0_LOG(M0_DEBUG, "bzp_maxchunk=0x%" PRIx64 " next_maxchunk=0x%"PRIx64,
 	       zp->bzp_maxchunk, maxchunk);
@@ -1728,6 +1999,7 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 			/* |      |  tgt  |                    | */
 			/* +------+-------+--------------------+ */
 			cur->e_end = tgt->e_start;
+			zone_ext_resize(zp, cur);
 			rc = balloc_ext_insert(db, tx, *cur);
 			M0_ASSERT_INFO(rc == 0, "rc = %d", rc);
 			if (rc != 0)
@@ -1739,7 +2011,7 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 			/* |     tgt     |                     | */
 			/* +-------------+---------------------+ */
 			le = container_of(cur, struct m0_lext, le_ext);
-			lext_del(le);
+			lext_del(zp, le);
 			zp->bzp_fragments--;
 		}
 	} else {
@@ -1750,6 +2022,7 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 		/* |     tgt    |                      | */
 		/* +------------+----------------------+ */
 		cur->e_start = tgt->e_end;
+		zone_ext_resize(zp, cur);
 		rc = balloc_ext_update(db, tx, *cur);
 		M0_ASSERT_INFO(rc == 0, "rc = %d", rc);
 		if (rc != 0)
@@ -1775,12 +2048,14 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 			}
 			lcur = container_of(cur, struct m0_lext, le_ext);
 			m0_list_add_before(&lcur->le_link, &le->le_link);
+			zone_ext_add(zp, le);
 			zp->bzp_fragments++;
 			maxchunk = max_check(maxchunk, m0_ext_length(&new));
 		}
 	}
 	zp->bzp_maxchunk = maxchunk;
 	zp->bzp_freeblocks -= m0_ext_length(tgt);
+	balloc_summary_update(motr, grp);
 
 	grp->bgi_state |= M0_BALLOC_GROUP_INFO_DIRTY;
 
@@ -1876,6 +2151,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				return M0_RC(rc);
 			}
 			m0_list_add(&zp->bzp_extents, &le->le_link);
+			zone_ext_add(zp, le);
 			++zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 		} else {
@@ -1897,6 +2173,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 					return M0_RC(rc);
 				}
 				m0_list_add_after(&lcur->le_link, &le->le_link);
+				zone_ext_add(zp, le);
 				++zp->bzp_fragments;
 				maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 			} else {
@@ -1911,6 +2188,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				if (rc != 0)
 					return M0_RC(rc);
 				cur->e_end = tgt->e_end;
+				zone_ext_resize(zp, cur);
 				rc = balloc_ext_insert(db, tx, *cur);
 				M0_ASSERT_INFO(rc == 0, "rc = %d", rc);
 				if (rc != 0)
@@ -1937,6 +2215,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				return M0_RC(rc);
 			}
 			m0_list_add_before(&lcur->le_link, &le->le_link);
+			zone_ext_add(zp, le);
 			++zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 		} else {
@@ -1947,6 +2226,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			/* +-----+---------+-------------------+ */
 			M0_ASSERT(tgt->e_end == cur->e_start);
 			cur->e_start = tgt->e_start;
+			zone_ext_resize(zp, cur);
 			rc = balloc_ext_update(db, tx, *cur);
 			M0_ASSERT_INFO(rc == 0, "rc = %d", rc);
 			if (rc != 0)
@@ -1968,12 +2248,13 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			if (rc != 0)
 				return M0_RC(rc);
 			cur->e_start = pre->e_start;
+			zone_ext_resize(zp, cur);
 			rc = balloc_ext_update(db, tx, *cur);
 			M0_ASSERT_INFO(rc == 0, "rc = %d", rc);
 			if (rc != 0)
 				return M0_RC(rc);
 			le = container_of(pre, struct m0_lext, le_ext);
-			lext_del(le);
+			lext_del(zp, le);
 			--zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(cur));
 		} else if (pre->e_end == tgt->e_start) {
@@ -1988,6 +2269,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			if (rc != 0)
 				return M0_RC(rc);
 			pre->e_end = tgt->e_end;
+			zone_ext_resize(zp, pre);
 			rc = balloc_ext_insert(db, tx, *pre);
 			M0_ASSERT_INFO(rc == 0, "rc = %d", rc);
 			if (rc != 0)
@@ -2000,6 +2282,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			/* |          |  tgt  |                | */
 			/* +----------+-------+----------------+ */
 			cur->e_start = tgt->e_start;
+			zone_ext_resize(zp, cur);
 			rc = balloc_ext_update(db, tx, *cur);
 			M0_ASSERT_INFO(rc == 0, "rc = %d", rc);
 			if (rc != 0)
@@ -2022,12 +2305,14 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				return M0_RC(rc);
 			}
 			m0_list_add_before(&lcur->le_link, &le->le_link);
+			zone_ext_add(zp, le);
 			++zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 		}
 	}
 	zp->bzp_maxchunk = maxchunk;
 	zp->bzp_freeblocks += m0_ext_length(tgt);
+	balloc_summary_update(motr, grp);
 
 	grp->bgi_state |= M0_BALLOC_GROUP_INFO_DIRTY;
 
@@ -2349,23 +2634,24 @@ static int balloc_wild_scan_group(struct balloc_allocation_context *bac,
 				  struct m0_balloc_group_info *grp,
 				  enum m0_balloc_allocation_flag alloc_flag)
 {
-	struct m0_list  *list;
-	m0_bcount_t	 free;
-	struct m0_ext	*ex;
-	struct m0_lext	*le;
-	int		 rc;
-	int              end_of_group = 0;
+	struct m0_balloc_zone_param *zp;
+	struct m0_list              *list;
+	m0_bcount_t	             free;
+	struct m0_ext	            *ex;
+	struct m0_lext	            *le;
+	int		             rc;
+	int                          end_of_group = 0;
 	M0_ENTRY();
 
 #ifdef __SPARE_SPACE__
 	free = is_spare(bac->bac_flags) ? group_spare_freeblocks_get(grp) :
 		group_freeblocks_get(grp);
-	list = is_spare(alloc_flag) ? &grp->bgi_spare.bzp_extents :
-		 &grp->bgi_normal.bzp_extents;
+	zp = is_spare(alloc_flag) ? &grp->bgi_spare : &grp->bgi_normal;
 #else
 	free = group_freeblocks_get(grp);
-	list = &grp->bgi_normal.bzp_extents;
+	zp = &grp->bgi_normal;
 #endif
+	list = &zp->bzp_extents;
 
 	/**
 	 * Check to detect the block allocation request which came earlier
@@ -2395,6 +2681,18 @@ static int balloc_wild_scan_group(struct balloc_allocation_context *bac,
 		(unsigned long long)grp->bgi_groupno,
 		(unsigned long long)free);
 
+	if (!(bac->bac_flags & M0_BALLOC_HINT_FIRST)) {
+		/*
+		 * Measure the best candidate of the group, taken from the size
+		 * index, as if the whole group was scanned.
+		 */
+		ex = zone_ext_fit(zp, m0_ext_length(&bac->bac_goal));
+		if (ex != NULL)
+			balloc_measure_extent(bac, grp, alloc_flag, ex, 1);
+		rc = balloc_check_limits(bac, grp, 1, alloc_flag);
+		return M0_RC(rc);
+	}
+
 	m0_list_for_each_entry(list, le, struct m0_lext, le_link) {
 		ex = &le->le_ext;
 		if (m0_ext_length(ex) > free) {
@@ -2514,13 +2812,22 @@ balloc_regular_allocator(struct balloc_allocation_context *bac)
 {
 	m0_bcount_t ngroups;
 	m0_bcount_t group;
+	m0_bcount_t next;
 	m0_bcount_t i;
 	m0_bcount_t len;
+	m0_bcount_t min;
+	bool        summary;
 	int         cr;
 	int         rc = 0;
 
 	ngroups = bac->bac_ctxt->cb_sb.bsb_groupcount;
 	len = m0_ext_length(&bac->bac_goal);
+	/* The summary covers the normal zone only. */
+#ifdef __SPARE_SPACE__
+	summary = !is_spare(bac->bac_flags);
+#else
+	summary = true;
+#endif
 
 	M0_ENTRY("goal=0x%lx len=%d",
 		(unsigned long)bac->bac_goal.e_start, (int)len);
@@ -2553,6 +2860,11 @@ repeat:
 	for (;cr < 3 && bac->bac_status == M0_BALLOC_AC_CONTINUE; cr++) {
 		M0_LOG(M0_DEBUG, "cr=%d", cr);
 		bac->bac_criteria = cr;
+		/*
+		 * Groups good enough for criteria 0 and 1 have an extent of
+		 * at least len blocks, see is_group_good_enough().
+		 */
+		min = cr < 2 ? len : 1;
 		/*
 		 * searching for the right group start
 		 * from the goal value specified
@@ -2565,6 +2877,21 @@ repeat:
 			if (group >= ngroups)
 				group = 0;
 
+			if (summary) {
+				/* Skip unsuitable groups without locking. */
+				next = balloc_summary_find(bac->bac_ctxt,
+							   group, min);
+				if (next >= ngroups) {
+					i += ngroups - 1 - group;
+					group = ngroups - 1;
+					continue;
+				}
+				i += next - group;
+				group = next;
+				if (i >= ngroups)
+					break;
+			}
+
 			grp = m0_balloc_gn2info(bac->bac_ctxt, group);
 			// m0_balloc_debug_dump_group("searching group ...",
 			//			 grp);
@@ -134,6 +134,18 @@ struct m0_balloc_zone_param {
 	m0_bcount_t                     bzp_fragments;
 	m0_bcount_t                     bzp_maxchunk;
 	struct m0_list                  bzp_extents;
+	/**
+	 * Size index of bzp_extents: list i links extents with length in
+	 * [2^i, 2^(i+1)). Allocated while group extents are loaded.
+	 */
+	struct m0_list                 *bzp_size;
+	/** Bit i is set iff bzp_size[i] is not empty. */
+	uint64_t                        bzp_size_mask;
+};
+
+enum {
+	/** Number of size classes in m0_balloc_zone_param::bzp_size. */
+	BALLOC_SIZE_CLASS_NR = 64,
 };
 
 /** Linked extents */
@@ -142,6 +154,9 @@ struct m0_lext {
 	bool                le_is_alloc;
 	struct m0_list_link le_link;
 	struct m0_ext       le_ext;
+	/** Link into m0_balloc_zone_param::bzp_size[le_size_class]. */
+	struct m0_list_link le_size_link;
+	unsigned            le_size_class;
 };
 
 /**
@@ -162,6 +177,26 @@ struct m0_balloc_group_info {
 	struct m0_be_mutex           bgi_mutex;
 };
 
+/**
+   Cross-group summary of free space.
+
+   A complete binary tree over groups ("segment tree"): a leaf holds the length
+   of the longest free extent in the normal zone of its group, an inner node
+   holds the maximum of its children. The allocator uses it to skip groups
+   which cannot satisfy a request without locking them, and finds the next
+   suitable group in O(log(groupcount)).
+
+   Updates are serialised by bs_lock. Lookups read the tree without locking,
+   so their result is a hint, verified under the group lock.
+ */
+struct m0_balloc_summary {
+	/** Number of leaves, a power of 2 not less than the group count. */
+	m0_bcount_t      bs_leaves;
+	/** bs_max[1] is the root, leaf of group g is bs_max[bs_leaves + g]. */
+	m0_bcount_t     *bs_max;
+	struct m0_mutex  bs_lock;
+};
+
 enum m0_balloc_group_info_state {
 	/** inited from disk */
 	M0_BALLOC_GROUP_INFO_INIT = 1 << 0,
@@ -270,6 +305,8 @@ struct m0_balloc {
 
 	/** array of group info */
 	struct m0_balloc_group_info *cb_group_info;
+	/** summary of free space in cb_group_info */
+	struct m0_balloc_summary    *cb_summary;
 	/** super block lock */
 	struct m0_be_mutex           cb_sb_mutex;
 	struct m0_be_seg            *cb_be_seg;
@@ -33,6 +33,7 @@
 #include "lib/memory.h"
 #include "lib/thread.h"
 #include "lib/getopts.h"
+#include "lib/ub.h"
 #include "dtm/dtm.h"      /* m0_dtx */
 #include "motr/magic.h"
 #include "ut/ut.h"
@@ -300,6 +301,168 @@ void test_reserve_extent()
 	m0_be_ut_backend_fini(&ut_be);
 }
 
+static struct m0_balloc *balloc_ut_create(struct m0_be_ut_backend *ut_be,
+					  struct m0_be_seg *seg)
+{
+	struct m0_balloc *bal;
+	int               rc;
+
+	rc = m0_balloc_create(0, seg, m0_be_ut_backend_sm_group_lookup(ut_be),
+			      &bal, &M0_FID_INIT(0, 1));
+	M0_ASSERT(rc == 0);
+	bal->cb_ballroom.ab_ops->bo_fini(&bal->cb_ballroom);
+	rc = bal->cb_ballroom.ab_ops->bo_init
+		(&bal->cb_ballroom, seg, BALLOC_DEF_BLOCK_SHIFT,
+		 BALLOC_DEF_CONTAINER_SIZE, BALLOC_DEF_BLOCKS_PER_GROUP,
+		 m0_stob_ad_spares_calc(BALLOC_DEF_BLOCKS_PER_GROUP));
+	M0_ASSERT(rc == 0);
+	return bal;
+}
+
+static int balloc_ut_alloc(struct m0_be_ut_backend *ut_be,
+			   struct m0_balloc *bal, m0_bindex_t goal,
+			   m0_bcount_t len, struct m0_ext *ext)
+{
+	struct m0_ad_balloc    *ballroom = &bal->cb_ballroom;
+	struct m0_dtx           dtx = {};
+	struct m0_be_tx_credit  cred = {};
+	int                     rc;
+
+	ballroom->ab_ops->bo_alloc_credit(ballroom, 1, &cred);
+	m0_ut_be_tx_begin(&dtx.tx_betx, ut_be, &cred);
+	M0_SET0(ext);
+	ext->e_start = goal;
+	rc = ballroom->ab_ops->bo_alloc(ballroom, &dtx, len, ext,
+					M0_BALLOC_NORMAL_ZONE);
+	m0_ut_be_tx_end(&dtx.tx_betx);
+	return rc;
+}
+
+static void balloc_ut_free(struct m0_be_ut_backend *ut_be,
+			   struct m0_balloc *bal, struct m0_ext *ext)
+{
+	struct m0_ad_balloc    *ballroom = &bal->cb_ballroom;
+	struct m0_dtx           dtx = {};
+	struct m0_be_tx_credit  cred = {};
+	int                     rc;
+
+	ballroom->ab_ops->bo_free_credit(ballroom, 1, &cred);
+	m0_ut_be_tx_begin(&dtx.tx_betx, ut_be, &cred);
+	rc = ballroom->ab_ops->bo_free(ballroom, &dtx, ext);
+	M0_ASSERT(rc == 0);
+	m0_ut_be_tx_end(&dtx.tx_betx);
+}
+
+/** Checks the size index of a loaded zone against its extent list. */
+static void balloc_ut_zone_check(struct m0_balloc_zone_param *zp)
+{
+	struct m0_lext *le;
+	m0_bcount_t     frags = 0;
+	m0_bcount_t     maxchunk = 0;
+	size_t          indexed = 0;
+	int             i;
+
+	m0_list_for_each_entry(&zp->bzp_extents, le, struct m0_lext,
+			       le_link) {
+		M0_UT_ASSERT(le->le_size_class ==
+			     m0_log2(m0_ext_length(&le->le_ext)));
+		M0_UT_ASSERT(m0_list_contains(&zp->bzp_size[le->le_size_class],
+					      &le->le_size_link));
+		maxchunk = max64u(maxchunk, m0_ext_length(&le->le_ext));
+		++frags;
+	}
+	for (i = 0; i < BALLOC_SIZE_CLASS_NR; ++i) {
+		M0_UT_ASSERT(m0_list_is_empty(&zp->bzp_size[i]) ==
+			     !(zp->bzp_size_mask & (1ULL << i)));
+		indexed += m0_list_length(&zp->bzp_size[i]);
+	}
+	M0_UT_ASSERT(frags == zp->bzp_fragments);
+	M0_UT_ASSERT(indexed == frags);
+	M0_UT_ASSERT(maxchunk == zp->bzp_maxchunk);
+}
+
+static void balloc_ut_index_check(struct m0_balloc *bal)
+{
+	struct m0_balloc_summary    *s = bal->cb_summary;
+	struct m0_balloc_group_info *grp;
+	m0_bcount_t                  leaf;
+	m0_bcount_t                  i;
+
+	for (i = 0; i < bal->cb_sb.bsb_groupcount; ++i) {
+		grp = m0_balloc_gn2info(bal, i);
+		m0_balloc_lock_group(grp);
+		if (grp->bgi_extents_loaded)
+			balloc_ut_zone_check(&grp->bgi_normal);
+		leaf = grp->bgi_normal.bzp_freeblocks == 0 ||
+			grp->bgi_normal.bzp_fragments == 0 ? 0 :
+			max64u(grp->bgi_normal.bzp_maxchunk, 1);
+		M0_UT_ASSERT(s->bs_max[s->bs_leaves + i] == leaf);
+		m0_balloc_unlock_group(grp);
+	}
+	for (i = s->bs_leaves - 1; i > 0; --i)
+		M0_UT_ASSERT(s->bs_max[i] == max64u(s->bs_max[2 * i],
+						    s->bs_max[2 * i + 1]));
+}
+
+enum { BALLOC_UT_FRAG_NR = 64 };
+
+/**
+ * Fragments free space and verifies the free space index, and that a request
+ * which fragmented groups cannot satisfy is served from an intact one.
+ */
+void test_free_space_index()
+{
+	struct m0_be_ut_backend  ut_be = {};
+	struct m0_be_ut_seg      ut_seg;
+	struct m0_balloc        *bal;
+	struct m0_ext            ext[BALLOC_UT_FRAG_NR];
+	struct m0_ext            big;
+	m0_bcount_t              free;
+	m0_bcount_t              gsize;
+	m0_bcount_t              zone;
+	int                      i;
+	int                      rc;
+
+	m0_be_ut_backend_init(&ut_be);
+	m0_be_ut_seg_init(&ut_seg, &ut_be, 1ULL << 24);
+	bal = balloc_ut_create(&ut_be, ut_seg.bus_seg);
+	free = bal->cb_sb.bsb_freeblocks;
+	gsize = bal->cb_sb.bsb_groupsize;
+	zone = gsize - m0_stob_ad_spares_calc(gsize);
+	balloc_ut_index_check(bal);
+
+	/* Age the allocator: allocate extents and free every other one. */
+	for (i = 0; i < ARRAY_SIZE(ext); ++i) {
+		rc = balloc_ut_alloc(&ut_be, bal, 0, i % 7 + 1, &ext[i]);
+		M0_UT_ASSERT(rc == 0);
+		M0_UT_ASSERT(m0_ext_length(&ext[i]) > 0);
+		M0_UT_ASSERT(m0_ext_length(&ext[i]) <= i % 7 + 1);
+	}
+	for (i = 0; i < ARRAY_SIZE(ext); i += 2)
+		balloc_ut_free(&ut_be, bal, &ext[i]);
+	balloc_ut_index_check(bal);
+
+	/* Only an intact group has a free extent of the whole normal zone. */
+	rc = balloc_ut_alloc(&ut_be, bal, 0, zone, &big);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_ext_length(&big) == zone);
+	M0_UT_ASSERT((big.e_start & (gsize - 1)) == 0);
+	for (i = 1; i < ARRAY_SIZE(ext); i += 2)
+		M0_UT_ASSERT(!m0_ext_are_overlapping(&big, &ext[i]));
+	balloc_ut_index_check(bal);
+	balloc_ut_free(&ut_be, bal, &big);
+
+	for (i = 1; i < ARRAY_SIZE(ext); i += 2)
+		balloc_ut_free(&ut_be, bal, &ext[i]);
+	balloc_ut_index_check(bal);
+	M0_UT_ASSERT(bal->cb_sb.bsb_freeblocks == free);
+	M0_UT_ASSERT(bal->cb_summary->bs_max[1] == zone);
+
+	bal->cb_ballroom.ab_ops->bo_fini(&bal->cb_ballroom);
+	m0_be_ut_seg_fini(&ut_seg);
+	m0_be_ut_backend_fini(&ut_be);
+}
+
 static int test_balloc_ut_suite_init(void)
 {
 	m0_btree_glob_init();
@@ -319,10 +482,114 @@ struct m0_ut_suite balloc_ut = {
         .ts_tests = {
 		{ "balloc", test_balloc},
 		{ "reserve blocks for extmap", test_reserve_extent},
+		{ "free space index", test_free_space_index},
 		{ NULL, NULL }
         }
 };
 
+enum {
+	/** Number of extents allocated to age the allocator. */
+	BALLOC_UB_NR     = 2048,
+	/** Number of groups the aged extents are spread over. */
+	BALLOC_UB_GROUPS = 16,
+	BALLOC_UB_ITER   = 500,
+};
+
+static struct m0_be_ut_backend  ub_be;
+static struct m0_be_ut_seg      ub_seg;
+static struct m0_balloc        *ub_bal;
+static struct m0_ext            ub_ext[BALLOC_UB_NR];
+static uint64_t                 ub_seed;
+
+static m0_bindex_t ub_goal(void)
+{
+	return m0_rnd64(&ub_seed) %
+		(BALLOC_UB_GROUPS * ub_bal->cb_sb.bsb_groupsize);
+}
+
+static int ub_init(const char *opts M0_UNUSED)
+{
+	m0_btree_glob_init();
+	M0_SET0(&ub_be);
+	m0_be_ut_backend_init(&ub_be);
+	m0_be_ut_seg_init(&ub_seg, &ub_be, 1ULL << 26);
+	ub_bal = balloc_ut_create(&ub_be, ub_seg.bus_seg);
+	ub_seed = 42;
+	return 0;
+}
+
+static void ub_fini(void)
+{
+	ub_bal->cb_ballroom.ab_ops->bo_fini(&ub_bal->cb_ballroom);
+	m0_be_ut_seg_fini(&ub_seg);
+	m0_be_ut_backend_fini(&ub_be);
+	m0_btree_glob_fini();
+}
+
+/**
+ * Ages the allocator: allocates extents of random lengths in the first
+ * BALLOC_UB_GROUPS groups and frees a random half of them, leaving holes of
+ * various sizes.
+ */
+static void ub_age(int i)
+{
+	int j;
+	int rc;
+
+	for (j = 0; j < BALLOC_UB_NR; ++j) {
+		rc = balloc_ut_alloc(&ub_be, ub_bal, ub_goal(),
+				     m0_rnd64(&ub_seed) % 64 + 1, &ub_ext[j]);
+		M0_ASSERT(rc == 0);
+	}
+	for (j = 0; j < BALLOC_UB_NR; ++j) {
+		if (m0_rnd64(&ub_seed) % 2 == 0)
+			balloc_ut_free(&ub_be, ub_bal, &ub_ext[j]);
+	}
+}
+
+static void ub_alloc_free(m0_bcount_t len)
+{
+	struct m0_ext ext;
+	int           rc;
+
+	rc = balloc_ut_alloc(&ub_be, ub_bal, ub_goal(), len, &ext);
+	M0_ASSERT(rc == 0);
+	balloc_ut_free(&ub_be, ub_bal, &ext);
+}
+
+/** Fits into the holes left by ub_age(). */
+static void ub_small(int i)
+{
+	ub_alloc_free(m0_rnd64(&ub_seed) % 8 + 1);
+}
+
+/** Does not fit into aged groups, which have to be skipped. */
+static void ub_large(int i)
+{
+	ub_alloc_free(ub_bal->cb_sb.bsb_groupsize / 2);
+}
+
+struct m0_ub_set m0_balloc_ub = {
+	.us_name = "balloc-ub",
+	.us_init = ub_init,
+	.us_fini = ub_fini,
+	.us_run  = {
+		{ .ub_name  = "age",
+		  .ub_iter  = 1,
+		  .ub_round = ub_age },
+
+		{ .ub_name  = "small",
+		  .ub_iter  = BALLOC_UB_ITER,
+		  .ub_round = ub_small },
+
+		{ .ub_name  = "large",
+		  .ub_iter  = BALLOC_UB_ITER,
+		  .ub_round = ub_large },
+
+		{ .ub_name = NULL }
+	}
+};
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
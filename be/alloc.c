@@ -31,8 +31,12 @@
 #include "lib/memory.h"         /* m0_addr_is_aligned */
 #include "lib/errno.h"          /* ENOSPC */
 #include "lib/misc.h"           /* memset, M0_BITS, m0_forall */
+#include "lib/processor.h"      /* m0_processor_id_get */
+#include "lib/atomic.h"         /* m0_mb */
 #include "motr/magic.h"
 #include "be/domain.h"          /* m0_be_domain */
+#include "be/addb2.h"           /* M0_AVI_BE_ALLOC_LOCK */
+#include "addb2/addb2.h"        /* M0_ADDB2_ADD */
 
 /*
  * @addtogroup be
@@ -167,10 +171,25 @@
  * - allocator credit includes 2 * size requested for alignment shift greater
  *   than M0_BE_ALLOC_SHIFT_MIN;
  * - it is not truly O(1) allocator; see m0_be_fl documentation for explanation;
- * - there is one big allocator lock that protects all allocations/deallocation.
+ * - allocations which are not served by slabs take one big allocator lock;
+ * - free space inside slabs is accounted as used in m0_be_allocator_stats.
+ *
+ * Slabs
+ *
+ * Small M0_BE_ALLOC_SHIFT_MIN allocations and page-sized chunk-aligned
+ * allocations (btree nodes) from M0_BAP_NORMAL zone are served by slabs, see
+ * be_alloc_slab_classes[]. A slab is a used chunk carved into objects of one
+ * size. The slab header and a header of each allocated object are persistent
+ * and captured, the object header has the size of be_alloc_chunk. Slabs are
+ * owned by arenas (m0_be_alloc_arena); an arena is picked by the current
+ * processor. Arena lists of slabs are volatile: a slab left by a previous run
+ * is taken over by an arena on the first free of one of its objects. An
+ * empty slab is returned to the free lists right away.
  *
  * Locks
- * Allocator lock (m0_mutex) is used to protect all allocator data.
+ * Allocator lock (m0_mutex) is used to protect all allocator data, except
+ * slabs. Arena lock (m0_be_alloc_arena::baa_lock) protects the slabs of the
+ * arena. Arena lock is taken before allocator lock.
  *
  * Space reservation for DIX recovery
  * ----------------------------------
@@ -219,6 +238,101 @@ M0_BE_LIST_DESCR_DEFINE(chunks_all, "list of all chunks in m0_be_allocator",
 			M0_BE_ALLOC_ALL_LINK_MAGIC, M0_BE_ALLOC_ALL_MAGIC);
 M0_BE_LIST_DEFINE(chunks_all, static, struct be_alloc_chunk);
 
+enum {
+	/** Alignment of objects of page slab classes. */
+	BE_ALLOC_SLAB_PAGE_SHIFT  = 12,
+	/** Alignment of objects of small slab classes. */
+	BE_ALLOC_SLAB_SMALL_SHIFT = 6,
+	/** Maximum number of objects in a slab, see be_alloc_slab::bsl_used. */
+	BE_ALLOC_SLAB_OBJ_MAX     = 64,
+};
+
+/** Slab size class. */
+struct be_alloc_slab_class {
+	/** Object size, including be_alloc_slab_obj. */
+	m0_bcount_t bsc_size;
+	/** Number of objects in a slab. */
+	uint32_t    bsc_nr;
+	/**
+	 * Objects are page-aligned and serve chunk-aligned requests.
+	 * Otherwise they serve M0_BE_ALLOC_SHIFT_MIN requests.
+	 */
+	bool        bsc_page;
+};
+
+/**
+ * Slab size classes. be_alloc_slab::bsl_class is an index in this array, so
+ * existing entries must not be changed or reordered.
+ */
+static const struct be_alloc_slab_class be_alloc_slab_classes[] = {
+	{ .bsc_size = 0x80,   .bsc_nr = 64, .bsc_page = false },
+	{ .bsc_size = 0x100,  .bsc_nr = 64, .bsc_page = false },
+	{ .bsc_size = 0x200,  .bsc_nr = 64, .bsc_page = false },
+	{ .bsc_size = 0x400,  .bsc_nr = 32, .bsc_page = false },
+	{ .bsc_size = 0x1000, .bsc_nr = 16, .bsc_page = true  },
+	{ .bsc_size = 0x2000, .bsc_nr = 16, .bsc_page = true  },
+	{ .bsc_size = 0x4000, .bsc_nr = 8,  .bsc_page = true  },
+};
+M0_BASSERT(ARRAY_SIZE(be_alloc_slab_classes) == M0_BE_ALLOC_SLAB_CLASS_NR);
+
+/**
+ * Slab header.
+ *
+ * It is placed in the memory of a used M0_BAP_NORMAL chunk. Objects follow
+ * the header aligned to BE_ALLOC_SLAB_SMALL_SHIFT or, for page classes,
+ * starting from the next page.
+ *
+ * Fields before bsl_gen are persistent. The rest is volatile state of the
+ * owning arena. It is written to the segment without capturing and is valid
+ * only while bsl_gen == m0_be_allocator::ba_slab_gen.
+ */
+struct be_alloc_slab {
+	/** M0_BE_ALLOC_SLAB_MAGIC */
+	uint64_t                  bsl_magic;
+	/** Index in be_alloc_slab_classes[]. */
+	uint32_t                  bsl_class;
+	/** Number of objects. */
+	uint32_t                  bsl_nr;
+	/** Bitmap of used objects. */
+	uint64_t                  bsl_used;
+	/** m0_be_allocator::ba_slab_gen of the owner. */
+	uint64_t                  bsl_gen;
+	/** Owning arena. */
+	struct m0_be_alloc_arena *bsl_arena;
+	/** Linkage to m0_be_alloc_arena::baa_slabs[]. */
+	struct m0_tlink           bsl_linkage;
+	/** M0_BE_ALLOC_SLAB_LINK_MAGIC */
+	uint64_t                  bsl_link_magic;
+};
+
+/**
+ * Header of a slab object.
+ *
+ * It has the size of be_alloc_chunk, so m0_be_chunk_header_size() holds for
+ * slab objects. bso_magic is at the offset of be_alloc_chunk::bac_magic0,
+ * m0_be_free_aligned() uses it to tell slab objects apart.
+ */
+struct be_alloc_slab_obj {
+	/** M0_BE_ALLOC_SLAB_OBJ_MAGIC */
+	uint64_t              bso_magic;
+	struct be_alloc_slab *bso_slab;
+	/** Index of the object in the slab. */
+	uint64_t              bso_index;
+	/** Never written. */
+	char                  bso_pad[sizeof(struct be_alloc_chunk) -
+				      2 * sizeof(uint64_t) -
+				      sizeof(struct be_alloc_slab *)];
+	char                  bso_mem[0];
+};
+M0_BASSERT(sizeof(struct be_alloc_slab_obj) == sizeof(struct be_alloc_chunk));
+M0_BASSERT(offsetof(struct be_alloc_slab_obj, bso_magic) ==
+	   offsetof(struct be_alloc_chunk, bac_magic0));
+
+M0_TL_DESCR_DEFINE(slabs, "slabs of m0_be_alloc_arena", static,
+		   struct be_alloc_slab, bsl_linkage, bsl_link_magic,
+		   M0_BE_ALLOC_SLAB_LINK_MAGIC, M0_BE_ALLOC_SLAB_HEAD_MAGIC);
+M0_TL_DEFINE(slabs, static, struct be_alloc_slab);
+
 static const char *be_alloc_zone_name(enum m0_be_alloc_zone_type type)
 {
 	static const char *zone_names[] = {
@@ -739,11 +853,368 @@ static bool be_alloc_chunk_trymerge(struct m0_be_allocator *a,
 	return chunks_were_merged;
 }
 
+/**
+ * Takes ba_lock and accounts the acquisition in volatile lock statistics.
+ *
+ * The trylock attempt lets us tell contended acquisitions apart without
+ * timing every call. Only contended acquisitions are timed. The wait time is
+ * posted by the waiting thread to its own ADDB2 machine.
+ */
+static void be_allocator_lock(struct m0_be_allocator *a)
+{
+	m0_time_t wait;
+
+	if (m0_mutex_trylock(&a->ba_lock) == 0) {
+		++a->ba_lock_nr;
+		return;
+	}
+	wait = m0_time_now();
+	m0_mutex_lock(&a->ba_lock);
+	wait = m0_time_now() - wait;
+	++a->ba_lock_nr;
+	++a->ba_lock_contended_nr;
+	M0_ADDB2_ADD(M0_AVI_BE_ALLOC_LOCK, (uint64_t)a, wait);
+}
+
+static void be_allocator_unlock(struct m0_be_allocator *a)
+{
+	m0_mutex_unlock(&a->ba_lock);
+}
+
+/**
+ * Picks a free chunk from the zones in zonemask and splits it, under ba_lock.
+ * Chunk memory is neither zeroed nor captured.
+ */
+static struct be_alloc_chunk *be_alloc_chunk_get(struct m0_be_allocator *a,
+						 struct m0_be_tx *tx,
+						 m0_bcount_t size,
+						 unsigned shift,
+						 uint64_t zonemask,
+						 bool chunk_align)
+{
+	enum  m0_be_alloc_zone_type  ztype;
+	struct be_alloc_chunk       *c = NULL;
+	m0_bcount_t                  size_to_pick;
+	int                          z;
+	void                        *mem_ptr;
+
+	be_allocator_lock(a);
+	M0_PRE_EX(m0_be_allocator__invariant(a));
+
+	/* algorithm starts here */
+	size_to_pick = (1UL << shift) - (1UL << M0_BE_ALLOC_SHIFT_MIN) +
+		       m0_align(size, 1UL << M0_BE_ALLOC_SHIFT_MIN);
+	for (z = 0; z < M0_BAP_NR; ++z) {
+		if ((zonemask & M0_BITS(z)) != 0)
+			c = m0_be_fl_pick(&a->ba_h[z]->bah_fl, size_to_pick);
+		if (c != NULL)
+			break;
+	}
+	/* XXX If allocation fails then stats are updated for normal zone. */
+	ztype = c != NULL ? z : M0_BAP_NORMAL;
+	if (c != NULL) {
+		c = be_alloc_chunk_trysplit(a, ztype, tx, c, size, shift,
+					    chunk_align);
+		M0_ASSERT(c != NULL);
+		M0_ASSERT(c->bac_zone == ztype);
+	}
+	be_allocator_stats_update(&a->ba_h[ztype]->bah_stats,
+				  c == NULL ? size : c->bac_size, true, c == 0);
+	be_allocator_stats_capture(a, ztype, tx);
+	/* and ends here */
+
+	M0_LOG(M0_DEBUG, "allocator=%p size=%" PRIu64 " shift=%u "
+	       "c=%p c->bac_size=%" PRIu64 " chunk_align=%s", a, size,
+	       shift, c, c == NULL ? 0 : c->bac_size,
+	       chunk_align ? "true" : "false");
+	if (c == NULL) {
+		be_allocator_stats_print(&a->ba_h[ztype]->bah_stats);
+		M0_ASSERT(m0_be_allocator__invariant(a));
+	}
+
+	if (c != NULL) {
+		mem_ptr = chunk_align ? (void *)c : (void *)&c->bac_mem;
+		M0_POST(!c->bac_free);
+		M0_POST(c->bac_size >= size);
+		M0_POST(m0_addr_is_aligned(mem_ptr, shift));
+		M0_POST(be_alloc_chunk_is_in(a, ztype, c));
+	}
+	/*
+	 * unlock mutex after post-conditions which are using allocator
+	 * internals
+	 */
+	M0_POST_EX(m0_be_allocator__invariant(a));
+	be_allocator_unlock(a);
+	return c;
+}
+
+/** Marks a used chunk free and merges it with its neighbours, under ba_lock. */
+static void be_alloc_chunk_put(struct m0_be_allocator *a,
+			       struct m0_be_tx        *tx,
+			       struct be_alloc_chunk  *c)
+{
+	enum m0_be_alloc_zone_type  ztype;
+	struct be_alloc_chunk      *prev;
+	struct be_alloc_chunk      *next;
+	bool		            chunks_were_merged;
+
+	be_allocator_lock(a);
+	M0_PRE_EX(m0_be_allocator__invariant(a));
+
+	M0_PRE(be_alloc_chunk_invariant(a, c));
+	M0_PRE(!c->bac_free);
+	ztype = c->bac_zone;
+	M0_LOG(M0_DEBUG, "allocator=%p c=%p c->bac_size=%" PRIu64 " zone=%d "
+			"data=%p", a, c, c->bac_size, c->bac_zone, &c->bac_mem);
+	/* algorithm starts here */
+	be_alloc_chunk_mark_free(a, ztype, tx, c);
+	/* update stats before c->bac_size gets modified due to merge */
+	be_allocator_stats_update(&a->ba_h[ztype]->bah_stats,
+			c->bac_size, false, false);
+	prev = be_alloc_chunk_prev(a, ztype, c);
+	next = be_alloc_chunk_next(a, ztype, c);
+	chunks_were_merged = be_alloc_chunk_trymerge(a, ztype, tx,
+			prev, c);
+	if (chunks_were_merged)
+		c = prev;
+	be_alloc_chunk_trymerge(a, ztype, tx, c, next);
+	be_allocator_stats_capture(a, ztype, tx);
+	/* and ends here */
+	M0_POST(c->bac_free);
+	M0_POST(c->bac_size > 0);
+	M0_POST(be_alloc_chunk_invariant(a, c));
+
+	M0_POST_EX(m0_be_allocator__invariant(a));
+	be_allocator_unlock(a);
+}
+
+static void be_alloc_capture(struct m0_be_allocator *a,
+			     struct m0_be_tx        *tx,
+			     void                   *addr,
+			     m0_bcount_t             size)
+{
+	if (tx != NULL)
+		m0_be_tx_capture(tx, &M0_BE_REG(a->ba_seg, size, addr));
+}
+
+static struct m0_be_alloc_arena *be_alloc_arena_here(struct m0_be_allocator *a)
+{
+	return &a->ba_arena[m0_processor_id_get() % ARRAY_SIZE(a->ba_arena)];
+}
+
+/**
+ * Returns the slab class serving a request, or -1 if the request goes to the
+ * free lists. Page classes take only requests which use more than half of an
+ * object: smaller chunk-aligned requests waste less on the free lists.
+ */
+static int be_alloc_slab_class(m0_bcount_t size,
+			       unsigned    shift,
+			       uint64_t    zonemask,
+			       bool        chunk_align)
+{
+	const struct be_alloc_slab_class *sc;
+	m0_bcount_t                       total;
+	int                               i;
+
+	if (zonemask != M0_BITS(M0_BAP_NORMAL) ||
+	    (chunk_align ? shift > BE_ALLOC_SLAB_PAGE_SHIFT :
+			   shift != M0_BE_ALLOC_SHIFT_MIN))
+		return -1;
+	total = sizeof(struct be_alloc_slab_obj) + size;
+	for (i = 0; i < ARRAY_SIZE(be_alloc_slab_classes); ++i) {
+		sc = &be_alloc_slab_classes[i];
+		if (sc->bsc_page == chunk_align && total <= sc->bsc_size)
+			return !chunk_align || total > sc->bsc_size / 2 ?
+				i : -1;
+	}
+	return -1;
+}
+
+/** Size of the chunk holding a slab of class sc. */
+static m0_bcount_t be_alloc_slab_size(const struct be_alloc_slab_class *sc)
+{
+	return sc->bsc_nr * sc->bsc_size + (sc->bsc_page ?
+		(1UL << BE_ALLOC_SLAB_PAGE_SHIFT) -
+		sizeof(struct be_alloc_chunk) :
+		sizeof(struct be_alloc_slab) +
+		(1UL << BE_ALLOC_SLAB_SMALL_SHIFT));
+}
+
+static struct be_alloc_slab_obj *be_alloc_slab_obj(struct be_alloc_slab *s,
+						   uint64_t              index)
+{
+	const struct be_alloc_slab_class *sc;
+	uintptr_t                         base;
+
+	sc   = &be_alloc_slab_classes[s->bsl_class];
+	base = m0_align((uintptr_t)(s + 1),
+			1UL << (sc->bsc_page ? BE_ALLOC_SLAB_PAGE_SHIFT :
+					       BE_ALLOC_SLAB_SMALL_SHIFT));
+	return (struct be_alloc_slab_obj *)(base + index * sc->bsc_size);
+}
+
+static bool be_alloc_slab_invariant(const struct be_alloc_slab *s)
+{
+	return _0C(s->bsl_magic == M0_BE_ALLOC_SLAB_MAGIC) &&
+	       _0C(s->bsl_class < ARRAY_SIZE(be_alloc_slab_classes)) &&
+	       _0C(s->bsl_nr == be_alloc_slab_classes[s->bsl_class].bsc_nr) &&
+	       _0C(s->bsl_nr <= BE_ALLOC_SLAB_OBJ_MAX) &&
+	       _0C(ergo(s->bsl_nr < BE_ALLOC_SLAB_OBJ_MAX,
+			(s->bsl_used >> s->bsl_nr) == 0));
+}
+
+static bool be_alloc_slab_is_full(const struct be_alloc_slab *s)
+{
+	return __builtin_popcountll(s->bsl_used) == s->bsl_nr;
+}
+
+/**
+ * Allocates a slab of class cls from the free lists and puts it on the list
+ * of arena ar. Only the slab header is captured: objects are captured when
+ * they are allocated.
+ */
+static struct be_alloc_slab *be_alloc_slab_create(struct m0_be_allocator   *a,
+						  struct m0_be_alloc_arena *ar,
+						  struct m0_be_tx          *tx,
+						  int                       cls)
+{
+	const struct be_alloc_slab_class *sc = &be_alloc_slab_classes[cls];
+	struct be_alloc_chunk            *c;
+	struct be_alloc_slab             *s;
+
+	M0_PRE(m0_mutex_is_locked(&ar->baa_lock));
+
+	c = be_alloc_chunk_get(a, tx, be_alloc_slab_size(sc),
+			       sc->bsc_page ? BE_ALLOC_SLAB_PAGE_SHIFT :
+					      M0_BE_ALLOC_SHIFT_MIN,
+			       M0_BITS(M0_BAP_NORMAL), sc->bsc_page);
+	if (c == NULL)
+		return NULL;
+	s = (struct be_alloc_slab *)&c->bac_mem;
+	*s = (struct be_alloc_slab) {
+		.bsl_magic = M0_BE_ALLOC_SLAB_MAGIC,
+		.bsl_class = cls,
+		.bsl_nr    = sc->bsc_nr,
+		.bsl_used  = 0,
+		.bsl_gen   = a->ba_slab_gen,
+		.bsl_arena = ar,
+	};
+	be_alloc_capture(a, tx, s, offsetof(struct be_alloc_slab, bsl_gen));
+	slabs_tlink_init_at(s, &ar->baa_slabs[cls]);
+	++ar->baa_stats.bss_slab_alloc_nr;
+	M0_POST(be_alloc_slab_invariant(s));
+	return s;
+}
+
+/**
+ * Allocates an object of class cls in the arena of the current processor.
+ * Returns NULL if the arena has no free object of this class and a new slab
+ * cannot be allocated.
+ */
+static void *be_alloc_slab_get(struct m0_be_allocator *a,
+			       struct m0_be_tx        *tx,
+			       int                     cls)
+{
+	struct m0_be_alloc_arena *ar = be_alloc_arena_here(a);
+	struct be_alloc_slab_obj *obj;
+	struct be_alloc_slab     *s;
+	uint64_t                  index;
+
+	m0_mutex_lock(&ar->baa_lock);
+	s = slabs_tlist_head(&ar->baa_slabs[cls]) ?:
+	    be_alloc_slab_create(a, ar, tx, cls);
+	if (s == NULL) {
+		m0_mutex_unlock(&ar->baa_lock);
+		return NULL;
+	}
+	M0_ASSERT(be_alloc_slab_invariant(s));
+	M0_ASSERT(s->bsl_arena == ar && !be_alloc_slab_is_full(s));
+	index = __builtin_ctzll(~s->bsl_used);
+	s->bsl_used |= M0_BITS(index);
+	be_alloc_capture(a, tx, &s->bsl_used, sizeof s->bsl_used);
+	if (be_alloc_slab_is_full(s))
+		slabs_tlist_del(s);
+	++ar->baa_stats.bss_alloc_nr;
+	m0_mutex_unlock(&ar->baa_lock);
+
+	obj = be_alloc_slab_obj(s, index);
+	obj->bso_magic = M0_BE_ALLOC_SLAB_OBJ_MAGIC;
+	obj->bso_slab  = s;
+	obj->bso_index = index;
+	be_alloc_capture(a, tx, obj, offsetof(struct be_alloc_slab_obj,
+					      bso_pad));
+	return &obj->bso_mem;
+}
+
+/**
+ * Returns the arena owning slab s.
+ *
+ * A slab left by a previous run has stale volatile fields. It is taken over
+ * by the arena of the current processor and *adopted is set; the caller puts
+ * it on the arena list.
+ */
+static struct m0_be_alloc_arena *
+be_alloc_slab_arena(struct m0_be_allocator *a,
+		    struct be_alloc_slab   *s,
+		    bool                   *adopted)
+{
+	*adopted = false;
+	if (s->bsl_gen != a->ba_slab_gen) {
+		m0_mutex_lock(&a->ba_slab_adopt_lock);
+		if (s->bsl_gen != a->ba_slab_gen) {
+			s->bsl_arena = be_alloc_arena_here(a);
+			slabs_tlink_init(s);
+			m0_mb();
+			s->bsl_gen = a->ba_slab_gen;
+			*adopted = true;
+		}
+		m0_mutex_unlock(&a->ba_slab_adopt_lock);
+	}
+	/* Pairs with the barrier above. */
+	m0_mb();
+	return s->bsl_arena;
+}
+
+/**
+ * Returns an object to its slab. An empty slab goes back to the free lists.
+ */
+static void be_alloc_slab_put(struct m0_be_allocator   *a,
+			      struct m0_be_tx          *tx,
+			      struct be_alloc_slab_obj *obj)
+{
+	struct be_alloc_slab     *s     = obj->bso_slab;
+	uint64_t                  index = obj->bso_index;
+	struct m0_be_alloc_arena *ar;
+	bool                      adopted;
+
+	M0_PRE(be_alloc_slab_invariant(s));
+	M0_PRE(index < s->bsl_nr && be_alloc_slab_obj(s, index) == obj);
+
+	ar = be_alloc_slab_arena(a, s, &adopted);
+	m0_mutex_lock(&ar->baa_lock);
+	M0_PRE((s->bsl_used & M0_BITS(index)) != 0);
+	s->bsl_used &= ~M0_BITS(index);
+	be_alloc_capture(a, tx, &s->bsl_used, sizeof s->bsl_used);
+	++ar->baa_stats.bss_free_nr;
+	ar->baa_stats.bss_slab_adopt_nr += adopted;
+	if (s->bsl_used == 0) {
+		if (slabs_tlink_is_in(s))
+			slabs_tlist_del(s);
+		slabs_tlink_fini(s);
+		be_alloc_chunk_put(a, tx, be_alloc_chunk_addr(s));
+		++ar->baa_stats.bss_slab_free_nr;
+	} else if (!slabs_tlink_is_in(s))
+		slabs_tlist_add(&ar->baa_slabs[s->bsl_class], s);
+	m0_mutex_unlock(&ar->baa_lock);
+}
+
 M0_INTERNAL int m0_be_allocator_init(struct m0_be_allocator *a,
 				     struct m0_be_seg *seg)
 {
-	struct m0_be_seg_hdr *seg_hdr;
-	int                   i;
+	struct m0_be_alloc_arena *ar;
+	struct m0_be_seg_hdr     *seg_hdr;
+	int                       i;
+	int                       j;
 
 	M0_ENTRY("a=%p seg=%p seg->bs_addr=%p seg->bs_size=%"PRId64,
 		 a, seg, seg->bs_addr, seg->bs_size);
@@ -753,6 +1224,19 @@ M0_INTERNAL int m0_be_allocator_init(struct m0_be_allocator *a,
 	/* See comment in m0_be_btree_init(). */
 	M0_SET0(&a->ba_lock);
 	m0_mutex_init(&a->ba_lock);
+	a->ba_lock_nr           = 0;
+	a->ba_lock_contended_nr = 0;
+	for (i = 0; i < ARRAY_SIZE(a->ba_arena); ++i) {
+		ar = &a->ba_arena[i];
+		M0_SET0(ar);
+		m0_mutex_init(&ar->baa_lock);
+		for (j = 0; j < ARRAY_SIZE(ar->baa_slabs); ++j)
+			slabs_tlist_init(&ar->baa_slabs[j]);
+	}
+	/* Makes volatile slab state of a previous run stale. */
+	a->ba_slab_gen = m0_time_now();
+	M0_SET0(&a->ba_slab_adopt_lock);
+	m0_mutex_init(&a->ba_slab_adopt_lock);
 
 	a->ba_seg = seg;
 	seg_hdr = (struct m0_be_seg_hdr *)seg->bs_addr;
@@ -767,12 +1251,32 @@ M0_INTERNAL int m0_be_allocator_init(struct m0_be_allocator *a,
 
 M0_INTERNAL void m0_be_allocator_fini(struct m0_be_allocator *a)
 {
-	int i;
+	struct m0_be_alloc_arena *ar;
+	struct be_alloc_slab     *s;
+	int                       i;
+	int                       j;
 
 	M0_ENTRY("a=%p", a);
 
 	for (i = 0; i < M0_BAP_NR; ++i)
 		be_allocator_stats_print(&a->ba_h[i]->bah_stats);
+	M0_LOG(M0_DEBUG, "lock_nr=%"PRIu64" lock_contended_nr=%"PRIu64,
+	       a->ba_lock_nr, a->ba_lock_contended_nr);
+	/*
+	 * Slabs with allocated objects stay in the segment. They are adopted
+	 * by the next m0_be_allocator_init() when their objects are freed.
+	 */
+	for (i = 0; i < ARRAY_SIZE(a->ba_arena); ++i) {
+		ar = &a->ba_arena[i];
+		for (j = 0; j < ARRAY_SIZE(ar->baa_slabs); ++j) {
+			m0_tl_teardown(slabs, &ar->baa_slabs[j], s) {
+				slabs_tlink_fini(s);
+			}
+			slabs_tlist_fini(&ar->baa_slabs[j]);
+		}
+		m0_mutex_fini(&ar->baa_lock);
+	}
+	m0_mutex_fini(&a->ba_slab_adopt_lock);
 	m0_mutex_fini(&a->ba_lock);
 
 	M0_LEAVE();
@@ -951,8 +1455,11 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 	struct m0_be_tx_credit         cred_free_flag;
 	struct m0_be_tx_credit         cred_chunk_size;
 	struct m0_be_tx_credit         stats_credit;
+	struct m0_be_tx_credit         cred_slab_used;
+	struct m0_be_tx_credit         cred_slab_alloc;
 	struct m0_be_tx_credit         tmp;
 	struct be_alloc_chunk          chunk;
+	struct be_alloc_slab           slab;
 
 	chunk_credit    = M0_BE_TX_CREDIT_TYPE(struct be_alloc_chunk);
 	cred_free_flag  = M0_BE_TX_CREDIT_PTR(&chunk.bac_free);
@@ -1001,6 +1508,18 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 	m0_be_tx_credit_add(&cred_mark_free, &cred_free_flag);
 	m0_be_fl_credit(&h->bah_fl, M0_BFL_ADD, &cred_mark_free);
 
+	/*
+	 * Slab object allocation captures the slab bitmap and the object
+	 * header. Allocation of a new slab additionally captures the slab
+	 * header; the slab chunk itself is covered by cred_split.
+	 */
+	cred_slab_used  = M0_BE_TX_CREDIT_PTR(&slab.bsl_used);
+	cred_slab_alloc = M0_BE_TX_CREDIT(1, offsetof(struct be_alloc_slab,
+						      bsl_gen));
+	m0_be_tx_credit_add(&cred_slab_alloc, &cred_slab_used);
+	tmp = M0_BE_TX_CREDIT(1, offsetof(struct be_alloc_slab_obj, bso_pad));
+	m0_be_tx_credit_add(&cred_slab_alloc, &tmp);
+
 	switch (optype) {
 		case M0_BAO_CREATE:
 			tmp = M0_BE_TX_CREDIT(0, 0);
@@ -1022,6 +1541,7 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 			m0_be_tx_credit_add(accum, &cred_split);
 			m0_be_tx_credit_add(accum, &mem_zero_credit);
 			m0_be_tx_credit_add(accum, &stats_credit);
+			m0_be_tx_credit_add(accum, &cred_slab_alloc);
 			break;
 		case M0_BAO_ALLOC:
 			m0_be_allocator_credit(a, M0_BAO_ALLOC_ALIGNED, size,
@@ -1031,6 +1551,7 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 			m0_be_tx_credit_add(accum, &cred_mark_free);
 			m0_be_tx_credit_mac(accum, &chunk_trymerge_credit, 2);
 			m0_be_tx_credit_add(accum, &stats_credit);
+			m0_be_tx_credit_add(accum, &cred_slab_used);
 			break;
 		case M0_BAO_FREE:
 			m0_be_allocator_credit(a, M0_BAO_FREE_ALIGNED, size,
@@ -1053,11 +1574,9 @@ M0_INTERNAL void m0_be_alloc_aligned(struct m0_be_allocator *a,
 				     uint64_t zonemask,
 				     bool chunk_align)
 {
-	enum  m0_be_alloc_zone_type  ztype;
-	struct be_alloc_chunk       *c = NULL;
-	m0_bcount_t                  size_to_pick;
-	int                          z;
-	void                        *mem_ptr;
+	struct be_alloc_chunk *c;
+	void                  *mem = NULL;
+	int                    cls;
 
 	shift = max_check(shift, (unsigned) M0_BE_ALLOC_SHIFT_MIN);
 	M0_ASSERT_INFO(size <= (M0_BCOUNT_MAX - (1UL << shift)) / 2,
@@ -1065,56 +1584,29 @@ M0_INTERNAL void m0_be_alloc_aligned(struct m0_be_allocator *a,
 
 	m0_be_op_active(op);
 
-	m0_mutex_lock(&a->ba_lock);
-	M0_PRE_EX(m0_be_allocator__invariant(a));
-
-	/* algorithm starts here */
-	size_to_pick = (1UL << shift) - (1UL << M0_BE_ALLOC_SHIFT_MIN) +
-		       m0_align(size, 1UL << M0_BE_ALLOC_SHIFT_MIN);
-	for (z = 0; z < M0_BAP_NR; ++z) {
-		if ((zonemask & M0_BITS(z)) != 0)
-			c = m0_be_fl_pick(&a->ba_h[z]->bah_fl, size_to_pick);
-		if (c != NULL)
-			break;
-	}
-	/* XXX If allocation fails then stats are updated for normal zone. */
-	ztype = c != NULL ? z : M0_BAP_NORMAL;
-	if (c != NULL) {
-		c = be_alloc_chunk_trysplit(a, ztype, tx, c, size, shift,
-					    chunk_align);
-		M0_ASSERT(c != NULL);
-		M0_ASSERT(c->bac_zone == ztype);
-		memset(&c->bac_mem, 0, size);
-		m0_be_tx_capture(tx, &M0_BE_REG(a->ba_seg, size, &c->bac_mem));
-	}
-	*ptr = c == NULL ? NULL : &c->bac_mem;
-	be_allocator_stats_update(&a->ba_h[ztype]->bah_stats,
-				  c == NULL ? size : c->bac_size, true, c == 0);
-	be_allocator_stats_capture(a, ztype, tx);
-	/* and ends here */
-
-	M0_LOG(M0_DEBUG, "allocator=%p size=%" PRIu64 " shift=%u "
-	       "c=%p c->bac_size=%" PRIu64 " ptr=%p chunk_align=%s", a, size,
-	       shift, c, c == NULL ? 0 : c->bac_size, *ptr,
-	       chunk_align ? "true" : "false");
-	if (*ptr == NULL) {
-		be_allocator_stats_print(&a->ba_h[ztype]->bah_stats);
-		M0_ASSERT(m0_be_allocator__invariant(a));
+	cls = be_alloc_slab_class(size, shift, zonemask, chunk_align);
+	if (cls >= 0)
+		mem = be_alloc_slab_get(a, tx, cls);
+	if (mem == NULL) {
+		c = be_alloc_chunk_get(a, tx, size, shift, zonemask,
+				       chunk_align);
+		mem = c == NULL ? NULL : &c->bac_mem;
 	}
+	*ptr = mem;
 
-	if (c != NULL) {
-		mem_ptr = chunk_align ? (void *)c : (void *)&c->bac_mem;
-		M0_POST(!c->bac_free);
-		M0_POST(c->bac_size >= size);
-		M0_POST(m0_addr_is_aligned(mem_ptr, shift));
-		M0_POST(be_alloc_chunk_is_in(a, ztype, c));
-	}
 	/*
-	 * unlock mutex after post-conditions which are using allocator
-	 * internals
+	 * The chunk or the slab object is already marked as used, so nobody
+	 * else touches its memory. Zero and capture it without holding any
+	 * allocator lock: for large allocations (e.g. btree nodes) this is the
+	 * most expensive part of the call.
 	 */
-	M0_POST_EX(m0_be_allocator__invariant(a));
-	m0_mutex_unlock(&a->ba_lock);
+	if (mem != NULL) {
+		M0_POST(m0_addr_is_aligned(chunk_align ?
+					   mem - m0_be_chunk_header_size() :
+					   mem, shift));
+		memset(mem, 0, size);
+		m0_be_tx_capture(tx, &M0_BE_REG(a->ba_seg, size, mem));
+	}
 
 	/* set op state after post-conditions because they are using op */
 	m0_be_op_done(op);
@@ -1140,11 +1632,7 @@ M0_INTERNAL void m0_be_free_aligned(struct m0_be_allocator *a,
 				    struct m0_be_op *op,
 				    void *ptr)
 {
-	enum m0_be_alloc_zone_type  ztype;
-	struct be_alloc_chunk      *c;
-	struct be_alloc_chunk      *prev;
-	struct be_alloc_chunk      *next;
-	bool		            chunks_were_merged;
+	struct be_alloc_chunk *c;
 
 	M0_PRE(ptr != NULL);
 	M0_PRE(m0_reduce(z, M0_BAP_NR, 0,
@@ -1152,35 +1640,13 @@ M0_INTERNAL void m0_be_free_aligned(struct m0_be_allocator *a,
 
 	m0_be_op_active(op);
 
-	m0_mutex_lock(&a->ba_lock);
-	M0_PRE_EX(m0_be_allocator__invariant(a));
-
 	c = be_alloc_chunk_addr(ptr);
-	M0_PRE(be_alloc_chunk_invariant(a, c));
-	M0_PRE(!c->bac_free);
-	ztype = c->bac_zone;
-	M0_LOG(M0_DEBUG, "allocator=%p c=%p c->bac_size=%" PRIu64 " zone=%d "
-			"data=%p", a, c, c->bac_size, c->bac_zone, &c->bac_mem);
-	/* algorithm starts here */
-	be_alloc_chunk_mark_free(a, ztype, tx, c);
-	/* update stats before c->bac_size gets modified due to merge */
-	be_allocator_stats_update(&a->ba_h[ztype]->bah_stats,
-			c->bac_size, false, false);
-	prev = be_alloc_chunk_prev(a, ztype, c);
-	next = be_alloc_chunk_next(a, ztype, c);
-	chunks_were_merged = be_alloc_chunk_trymerge(a, ztype, tx,
-			prev, c);
-	if (chunks_were_merged)
-		c = prev;
-	be_alloc_chunk_trymerge(a, ztype, tx, c, next);
-	be_allocator_stats_capture(a, ztype, tx);
-	/* and ends here */
-	M0_POST(c->bac_free);
-	M0_POST(c->bac_size > 0);
-	M0_POST(be_alloc_chunk_invariant(a, c));
-
-	M0_POST_EX(m0_be_allocator__invariant(a));
-	m0_mutex_unlock(&a->ba_lock);
+	if (c->bac_magic0 == M0_BE_ALLOC_SLAB_OBJ_MAGIC)
+		be_alloc_slab_put(a, tx, container_of(ptr,
+						      struct be_alloc_slab_obj,
+						      bso_mem));
+	else
+		be_alloc_chunk_put(a, tx, c);
 
 	m0_be_op_done(op);
 }
@@ -1202,6 +1668,35 @@ M0_INTERNAL void m0_be_alloc_stats(struct m0_be_allocator *a,
 	m0_mutex_unlock(&a->ba_lock);
 }
 
+M0_INTERNAL void m0_be_alloc_lock_stats(struct m0_be_allocator *a,
+					uint64_t               *nr,
+					uint64_t               *contended_nr)
+{
+	m0_mutex_lock(&a->ba_lock);
+	*nr           = a->ba_lock_nr;
+	*contended_nr = a->ba_lock_contended_nr;
+	m0_mutex_unlock(&a->ba_lock);
+}
+
+M0_INTERNAL void m0_be_alloc_slab_stats(struct m0_be_allocator        *a,
+					struct m0_be_alloc_slab_stats *out)
+{
+	struct m0_be_alloc_slab_stats *st;
+	int                            i;
+
+	M0_SET0(out);
+	for (i = 0; i < ARRAY_SIZE(a->ba_arena); ++i) {
+		st = &a->ba_arena[i].baa_stats;
+		m0_mutex_lock(&a->ba_arena[i].baa_lock);
+		out->bss_alloc_nr      += st->bss_alloc_nr;
+		out->bss_free_nr       += st->bss_free_nr;
+		out->bss_slab_alloc_nr += st->bss_slab_alloc_nr;
+		out->bss_slab_free_nr  += st->bss_slab_free_nr;
+		out->bss_slab_adopt_nr += st->bss_slab_adopt_nr;
+		m0_mutex_unlock(&a->ba_arena[i].baa_lock);
+	}
+}
+
 M0_INTERNAL void m0_be_alloc_stats_credit(struct m0_be_allocator *a,
                                           struct m0_be_tx_credit *accum)
 {
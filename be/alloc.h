@@ -26,6 +26,7 @@
 
 #include "lib/types.h"  /* m0_bcount_t */
 #include "lib/mutex.h"
+#include "lib/tlist.h"  /* m0_tl */
 
 struct m0_be_op;
 struct m0_be_seg;
@@ -45,6 +46,10 @@ enum {
 	 * @see m0_be_alloc(), m0_be_allocator_credit().
 	 */
 	M0_BE_ALLOC_SHIFT_MIN  = 3,
+	/** Number of slab size classes, see m0_be_alloc_arena. */
+	M0_BE_ALLOC_SLAB_CLASS_NR = 7,
+	/** Number of slab arenas in an allocator. */
+	M0_BE_ALLOC_ARENA_NR      = 16,
 };
 
 struct m0_be_allocator_call_stat {
@@ -128,6 +133,44 @@ struct m0_be_allocator_stats {
 
 struct m0_be_allocator_header;
 
+/**
+ * Volatile statistics of the slab front-end.
+ *
+ * @see m0_be_alloc_slab_stats().
+ */
+struct m0_be_alloc_slab_stats {
+	/** Objects allocated from slabs. */
+	uint64_t bss_alloc_nr;
+	/** Objects returned to slabs. */
+	uint64_t bss_free_nr;
+	/** Slabs allocated from the global free lists. */
+	uint64_t bss_slab_alloc_nr;
+	/** Empty slabs returned to the global free lists. */
+	uint64_t bss_slab_free_nr;
+	/** Slabs left by a previous run and taken over on the first free. */
+	uint64_t bss_slab_adopt_nr;
+};
+
+/**
+ * @brief Slab arena.
+ *
+ * Small and btree-node-sized allocations from the M0_BAP_NORMAL zone are
+ * served from slabs. A slab is one used chunk of the allocator, carved into
+ * objects of a single size class. Every slab is owned by an arena. An arena
+ * is selected by the processor the caller runs on, so FOMs of a locality
+ * keep using the same arena and do not contend on ba_lock. ba_lock is taken
+ * only to allocate a new slab or to release an empty one.
+ *
+ * Volatile.
+ */
+struct m0_be_alloc_arena {
+	/** Protects the slab lists, bitmaps of the slabs and statistics. */
+	struct m0_mutex               baa_lock;
+	/** Slabs with free objects, one list per size class. */
+	struct m0_tl                  baa_slabs[M0_BE_ALLOC_SLAB_CLASS_NR];
+	struct m0_be_alloc_slab_stats baa_stats;
+};
+
 /** @brief Allocator */
 struct m0_be_allocator {
 	/**
@@ -143,6 +186,22 @@ struct m0_be_allocator {
 	struct m0_mutex                ba_lock;
 	/** Internal allocator data. It is stored inside the segment. */
 	struct m0_be_allocator_header *ba_h[M0_BAP_NR];
+	/** Number of ba_lock acquisitions. Volatile, protected by ba_lock. */
+	uint64_t                       ba_lock_nr;
+	/**
+	 * Number of ba_lock acquisitions which had to wait for another thread.
+	 * Volatile, protected by ba_lock.
+	 */
+	uint64_t                       ba_lock_contended_nr;
+	/** Slab arenas, indexed by processor. */
+	struct m0_be_alloc_arena       ba_arena[M0_BE_ALLOC_ARENA_NR];
+	/**
+	 * Identifies volatile slab state written by this instance of the
+	 * allocator. It is different for every m0_be_allocator_init().
+	 */
+	uint64_t                       ba_slab_gen;
+	/** Serialises adoption of slabs left by a previous run. */
+	struct m0_mutex                ba_slab_adopt_lock;
 };
 
 /**
@@ -311,6 +370,26 @@ M0_INTERNAL void m0_be_free(struct m0_be_allocator *a,
 M0_INTERNAL void m0_be_alloc_stats(struct m0_be_allocator *a,
 				   struct m0_be_allocator_stats *out);
 
+/**
+ * Returns volatile ba_lock statistics: total and contended acquisitions since
+ * m0_be_allocator_init().
+ *
+ * Every contended acquisition is also posted to ADDB2 as an
+ * M0_AVI_BE_ALLOC_LOCK record with the wait time, by the waiting thread.
+ */
+M0_INTERNAL void m0_be_alloc_lock_stats(struct m0_be_allocator *a,
+					uint64_t               *nr,
+					uint64_t               *contended_nr);
+
+/**
+ * Returns volatile statistics of the slab front-end, summed over all arenas.
+ *
+ * Space taken by slabs is accounted in m0_be_allocator_stats as used, whether
+ * slab objects are allocated or not.
+ */
+M0_INTERNAL void m0_be_alloc_slab_stats(struct m0_be_allocator        *a,
+					struct m0_be_alloc_slab_stats *out);
+
 M0_INTERNAL void m0_be_alloc_stats_credit(struct m0_be_allocator *a,
                                           struct m0_be_tx_credit *accum);
 M0_INTERNAL void m0_be_alloc_stats_capture(struct m0_be_allocator *a,
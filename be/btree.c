@@ -573,6 +573,7 @@
 #include <unistd.h>
 #include <sys/mman.h>
 #include "ut/ut.h"          /** struct m0_ut_suite */
+#include "lib/ub.h"         /** struct m0_ub_set */
 #endif
 
 #include "balloc/balloc.h"
@@ -1107,8 +1108,12 @@ struct nd {
 	 * If the n_ref count is non-zero the node should be in active node
 	 * descriptor list. Once n_ref count reaches 0, it means the node is not
 	 * in use by any operation and is safe to move to global lru list.
+	 *
+	 * The count is changed without any lock as long as it stays positive,
+	 * see bnode_get_active() and bnode_put(). Transitions between 0 and 1
+	 * (and freeing of the descriptor) are done under list_lock only.
 	 */
-	int                     n_ref;
+	struct m0_atomic64      n_ref;
 
 	/**
 	 * Transaction reference count. A non-zero txref value indicates
@@ -1248,6 +1253,8 @@ static void bnode_capture(struct slot *slot, struct m0_be_tx *tx);
 
 static void bnode_lock(struct nd *node);
 static void bnode_unlock(struct nd *node);
+static void bnode_read_lock(struct nd *node);
+static void bnode_read_unlock(struct nd *node);
 static void bnode_fini(const struct nd *node);
 
 /**
@@ -1417,6 +1424,15 @@ static struct m0_tl     btree_lru_nds;
  */
 struct m0_tl btree_active_nds;
 
+/**
+ * Freed node descriptors. bnode_get_active() may still dereference a
+ * descriptor after it is freed, so descriptors are never returned to the
+ * memory allocator before m0_btree_glob_fini(): they are reused for other
+ * nodes instead. A freed descriptor has zero n_ref, hence no reference can be
+ * taken on it without list_lock.
+ */
+static struct m0_tl     btree_free_nds;
+
 /**
  * node descriptor list lock.
  * It protects node descriptor movement between lru node descriptor list and
@@ -1667,6 +1683,44 @@ static void bnode_val_resize(struct slot *slot, int vsize_diff)
 	slot->s_node->n_type->nt_val_resize(slot, vsize_diff);
 }
 
+/**
+ * Returns the normalized head of a key: its first 8 bytes loaded as a
+ * big-endian integer. Integer comparison of two heads gives the same ordering
+ * as memcmp() over those 8 bytes, which lets bnode_find() resolve most probes
+ * with a single 64-bit compare. The key must be at least 8 bytes long.
+ */
+static inline uint64_t bnode_key_head(const void *key)
+{
+	uint64_t head;
+
+	memcpy(&head, key, sizeof head);
+	return m0_byteorder_be64_to_cpu(head);
+}
+
+/**
+ * Compares node key with the search key in the same way as
+ * m0_bufvec_cursor_cmp() does for single-segment buffers, i.e. only the common
+ * prefix of the two keys is compared.
+ *
+ * @param fhead normalized head of find_data, valid iff fsize >= 8.
+ */
+static inline int bnode_key_raw_cmp(const void *key_data, m0_bcount_t ksize,
+				    const void *find_data, m0_bcount_t fsize,
+				    uint64_t fhead)
+{
+	m0_bcount_t len = min64u(ksize, fsize);
+	uint64_t    head;
+
+	if (len < sizeof head)
+		return memcmp(key_data, find_data, len);
+
+	head = bnode_key_head(key_data);
+	if (head != fhead)
+		return head < fhead ? -1 : 1;
+	return memcmp(key_data + sizeof head, find_data + sizeof head,
+		      len - sizeof head);
+}
+
 static bool bnode_find(struct slot *slot, struct m0_btree_key *find_key)
 {
 	int                         i     = -1;
@@ -1675,8 +1729,9 @@ static bool bnode_find(struct slot *slot, struct m0_btree_key *find_key)
 	void                       *p_key;
 	struct slot                 key_slot;
 	m0_bcount_t                 ksize;
-	struct m0_bufvec_cursor     cur_1;
-	struct m0_bufvec_cursor     cur_2;
+	void                       *find_data;
+	m0_bcount_t                 fsize;
+	uint64_t                    fhead = 0;
 	int                         diff;
 	int                         m;
 	struct m0_btree_rec_key_op *keycmp = &slot->s_node->n_tree->t_keycmp;
@@ -1688,24 +1743,30 @@ static bool bnode_find(struct slot *slot, struct m0_btree_key *find_key)
 	M0_PRE(bnode_invariant(slot->s_node));
 	M0_PRE(find_key->k_data.ov_vec.v_nr == 1);
 
+	/**
+	 * Both the node key returned by bnode_key() and the search key are
+	 * single-segment buffers, so the default comparison can be done with
+	 * memcmp() directly. The head of the search key is normalized once
+	 * here, so that every probe is resolved by comparing 64-bit integers
+	 * and memcmp() is only needed to break ties.
+	 */
+	find_data = M0_BUFVEC_DATA(&find_key->k_data);
+	fsize     = find_key->k_data.ov_vec.v_count[0];
+	if (keycmp->rko_keycmp == NULL && fsize >= sizeof fhead)
+		fhead = bnode_key_head(find_data);
+
 	while (i + 1 < j) {
 		m = (i + j) / 2;
 
 		key_slot.s_idx = m;
 		bnode_key(&key_slot);
 
-		if (keycmp->rko_keycmp != NULL) {
-			void     *key_data;
-			void     *find_data;
-
-			key_data = M0_BUFVEC_DATA(&key.k_data);
-			find_data = M0_BUFVEC_DATA(&find_key->k_data);
-			diff = keycmp->rko_keycmp(key_data, find_data);
-		} else {
-			m0_bufvec_cursor_init(&cur_1, &key.k_data);
-			m0_bufvec_cursor_init(&cur_2, &find_key->k_data);
-			diff = m0_bufvec_cursor_cmp(&cur_1, &cur_2);
-		}
+		if (keycmp->rko_keycmp != NULL)
+			diff = keycmp->rko_keycmp(M0_BUFVEC_DATA(&key.k_data),
+						  find_data);
+		else
+			diff = bnode_key_raw_cmp(p_key, ksize, find_data, fsize,
+						 fhead);
 
 		M0_ASSERT(i < m && m < j);
 		if (diff < 0)
@@ -1781,6 +1842,21 @@ static void bnode_unlock(struct nd *node)
 	m0_rwlock_write_unlock(&node->n_lock);
 }
 
+/**
+ * Shared node lock. It is used by the operations which only read the node
+ * (traversal and sequence number validation), so that concurrent readers of
+ * the same node do not serialise on each other.
+ */
+static void bnode_read_lock(struct nd *node)
+{
+	m0_rwlock_read_lock(&node->n_lock);
+}
+
+static void bnode_read_unlock(struct nd *node)
+{
+	m0_rwlock_read_unlock(&node->n_lock);
+}
+
 static void bnode_fini(const struct nd *node)
 {
 	node->n_type->nt_fini(node);
@@ -1839,6 +1915,7 @@ M0_INTERNAL void m0_btree_glob_init(void)
 	/* Initialtise lru list, active list and lock. */
 	ndlist_tlist_init(&btree_lru_nds);
 	ndlist_tlist_init(&btree_active_nds);
+	ndlist_tlist_init(&btree_free_nds);
 	m0_rwlock_init(&list_lock);
 }
 
@@ -1862,6 +1939,12 @@ M0_INTERNAL void m0_btree_glob_fini(void)
 		}
 	ndlist_tlist_fini(&btree_active_nds);
 
+	m0_tl_teardown(ndlist, &btree_free_nds, node) {
+		ndlist_tlink_fini(node);
+		m0_free(node);
+	}
+	ndlist_tlist_fini(&btree_free_nds);
+
 	m0_rwlock_fini(&list_lock);
 }
 
@@ -2059,6 +2142,94 @@ static void tree_put(struct td *tree)
 
 }
 
+/**
+ * Allocates a node descriptor, reusing a freed one if possible.
+ * Called under list_lock.
+ */
+static struct nd *bnode_nd_alloc(void)
+{
+	struct nd *node = ndlist_tlist_pop(&btree_free_nds);
+
+	if (node == NULL)
+		return m0_alloc(sizeof *node);
+	ndlist_tlink_fini(node);
+	/* n_ref is 0 already, nobody else writes it. */
+	M0_SET0(node);
+	return node;
+}
+
+/**
+ * Frees a node descriptor, which is already removed from active and LRU lists.
+ * Called under list_lock.
+ */
+static void bnode_nd_free(struct nd *node)
+{
+	M0_PRE(m0_atomic64_get(&node->n_ref) == 0);
+
+	m0_rwlock_fini(&node->n_lock);
+	ndlist_tlink_init_at(node, &btree_free_nds);
+}
+
+/** Takes a reference on the node unless nobody else holds one. */
+static bool bnode_ref_get_not_zero(struct nd *node)
+{
+	int64_t ref = m0_atomic64_get(&node->n_ref);
+
+	while (ref > 0) {
+		if (m0_atomic64_cas((int64_t *)&node->n_ref.a_value,
+				    ref, ref + 1))
+			return true;
+		ref = m0_atomic64_get(&node->n_ref);
+	}
+	return false;
+}
+
+/** Drops a reference on the node unless it is the last one. */
+static bool bnode_ref_put_not_last(struct nd *node)
+{
+	int64_t ref = m0_atomic64_get(&node->n_ref);
+
+	while (ref > 1) {
+		if (m0_atomic64_cas((int64_t *)&node->n_ref.a_value,
+				    ref, ref - 1))
+			return true;
+		ref = m0_atomic64_get(&node->n_ref);
+	}
+	return false;
+}
+
+/**
+ * Takes a reference on the node descriptor for the node at segaddr if the
+ * descriptor is already in the active list, i.e. it is referenced by some other
+ * operation. Such a descriptor does not move between the lists, so no lock is
+ * taken here, which lets concurrent operations descend through the (hot) upper
+ * levels of a tree in parallel.
+ *
+ * The descriptor pointer is read from the node without list_lock, so the
+ * descriptor may be freed and reused for another node meanwhile. Descriptors
+ * are never returned to the allocator (see btree_free_nds) and a freed one has
+ * zero n_ref, so it is checked that the reference taken is on the descriptor of
+ * this very node.
+ *
+ * @return true if the reference was taken and op->no_node is set.
+ */
+static bool bnode_get_active(struct node_op *op, struct segaddr *addr)
+{
+	struct nd *node;
+
+	if (!segaddr_header_isvalid(addr))
+		return false;
+	node = btree_node_format[segaddr_ntype_get(addr)]->nt_opaque_get(addr);
+	if (node == NULL || !bnode_ref_get_not_zero(node))
+		return false;
+	if (node->n_addr.as_core != addr->as_core || !node->n_be_node_valid) {
+		bnode_put(op, node);
+		return false;
+	}
+	op->no_node = node;
+	return true;
+}
+
 /**
  * This function loads the node descriptor for the node at segaddr in memory.
  * If a node descriptor pointing to this node is already loaded in memory then
@@ -2098,6 +2269,9 @@ static int64_t bnode_get(struct node_op *op, struct td *tree,
 	 * functionality is implemented.
 	 */
 
+	if (bnode_get_active(op, addr))
+		return nxt;
+
 	m0_rwlock_write_lock(&list_lock);
 
 	/**
@@ -2125,8 +2299,9 @@ static int64_t bnode_get(struct node_op *op, struct td *tree,
 			return nxt;
 		}
 
-		in_lrulist = op->no_node->n_ref == 0;
-		op->no_node->n_ref++;
+		/* Only list_lock holders change n_ref from 0. */
+		in_lrulist = m0_atomic64_get(&op->no_node->n_ref) == 0;
+		m0_atomic64_inc(&op->no_node->n_ref);
 		if (in_lrulist) {
 			/**
 			 * The node descriptor is in LRU list. Remove from lru
@@ -2167,9 +2342,7 @@ static int64_t bnode_get(struct node_op *op, struct td *tree,
 		op->no_node = nt->nt_opaque_get(addr);
 		if (op->no_node != NULL &&
 		    op->no_node->n_addr.as_core == addr->as_core) {
-			bnode_lock(op->no_node);
-			op->no_node->n_ref++;
-			bnode_unlock(op->no_node);
+			m0_atomic64_inc(&op->no_node->n_ref);
 			m0_rwlock_write_unlock(&list_lock);
 			return nxt;
 		}
@@ -2177,7 +2350,7 @@ static int64_t bnode_get(struct node_op *op, struct td *tree,
 		 * If node descriptor is not present allocate a new one
 		 * and assign to node.
 		 */
-		node = m0_alloc(sizeof *node);
+		node = bnode_nd_alloc();
 		/**
 		 * TODO: If Node-alloc fails, free up any node descriptor from
 		 * lru list and add assign to node. Unmap and map back the node
@@ -2188,12 +2361,17 @@ static int64_t bnode_get(struct node_op *op, struct td *tree,
 		node->n_tree          = tree;
 		node->n_type          = nt;
 		node->n_seq           = m0_time_now();
-		node->n_ref           = 1;
 		node->n_txref         = 0;
 		node->n_size          = nt->nt_nsize(node);
 		node->n_be_node_valid = true;
 		node->n_seg           = tree == NULL ? NULL : tree->t_seg;
 		m0_rwlock_init(&node->n_lock);
+		/*
+		 * A stale bnode_get_active() can take a reference as soon as
+		 * n_ref is set, n_addr has to be valid before that.
+		 */
+		m0_mb();
+		m0_atomic64_set(&node->n_ref, 1);
 		op->no_node           = node;
 		nt->nt_opaque_set(addr, node);
 		ndlist_tlink_init_at(op->no_node, &btree_active_nds);
@@ -2273,10 +2451,16 @@ static void bnode_put(struct node_op *op, struct nd *node)
 
 	M0_PRE(node != NULL);
 
+	/**
+	 * Dropping a reference which is not the last one does not move the
+	 * descriptor between the lists and is done without list_lock.
+	 */
+	if (bnode_ref_put_not_last(node))
+		return;
+
 	m0_rwlock_write_lock(&list_lock);
 	bnode_lock(node);
-	node->n_ref--;
-	if (node->n_ref == 0) {
+	if (m0_atomic64_dec_and_test(&node->n_ref)) {
 		/**
 		 * The node descriptor is in tree's active list. Remove from
 		 * active list and add to lru list
@@ -2301,8 +2485,7 @@ static void bnode_put(struct node_op *op, struct nd *node)
 				node->n_type->nt_opaque_set(&node->n_addr,
 							    NULL);
 			bnode_unlock(node);
-			m0_rwlock_fini(&node->n_lock);
-			m0_free(node);
+			bnode_nd_free(node);
 			m0_rwlock_write_unlock(&list_lock);
 			return;
 		}
@@ -2320,10 +2503,11 @@ static int64_t bnode_free(struct node_op *op, struct nd *node,
 {
 	int           size  = node->n_type->nt_nsize(node);
 	struct m0_buf buf;
+	bool          last;
 
 	m0_rwlock_write_lock(&list_lock);
 	bnode_lock(node);
-	node->n_ref--;
+	last = m0_atomic64_dec_and_test(&node->n_ref);
 	node->n_be_node_valid = false;
 	op->no_addr = node->n_addr;
 	buf = M0_BUF_INIT(size, segaddr_addr(&op->no_addr));
@@ -2331,11 +2515,10 @@ static int64_t bnode_free(struct node_op *op, struct nd *node,
 	M0_BE_FREE_ALIGN_BUF_SYNC(&buf, 0, node->n_tree->t_seg, tx);
 	/** Capture in transaction */
 
-	if (node->n_ref == 0 && node->n_txref == 0) {
+	if (last && node->n_txref == 0) {
 		ndlist_tlink_del_fini(node);
 		bnode_unlock(node);
-		m0_rwlock_fini(&node->n_lock);
-		m0_free(node);
+		bnode_nd_free(node);
 		m0_rwlock_write_unlock(&list_lock);
 		/** Capture in transaction */
 		return nxt;
@@ -5848,6 +6031,40 @@ M0_INTERNAL void m0_btree_update_credit2(const struct m0_btree_type *type,
 	m0_btree_update_credit(&dummy_btree, nr, ksize, vsize, accum);
 }
 
+M0_INTERNAL void m0_btree_batch_credit(const struct m0_btree       *tree,
+				       const struct m0_btree_batch *batch,
+				       struct m0_be_tx_credit      *accum)
+{
+	m0_bcount_t ksize = 0;
+	m0_bcount_t vsize = 0;
+	uint32_t    i;
+
+	if (batch->bb_opc == M0_BO_GET)
+		return;
+
+	for (i = 0; i < batch->bb_nr; i++) {
+		const struct m0_btree_rec *rec = &batch->bb_recs[i];
+
+		ksize = max64u(ksize, m0_vec_count(&rec->r_key.k_data.ov_vec));
+		if (batch->bb_opc != M0_BO_DEL)
+			vsize = max64u(vsize, m0_vec_count(&rec->r_val.ov_vec));
+	}
+
+	switch (batch->bb_opc) {
+	case M0_BO_PUT:
+		m0_btree_put_credit(tree, batch->bb_nr, ksize, vsize, accum);
+		break;
+	case M0_BO_UPDATE:
+		m0_btree_update_credit(tree, batch->bb_nr, ksize, vsize, accum);
+		break;
+	case M0_BO_DEL:
+		m0_btree_del_credit(tree, batch->bb_nr, ksize, vsize, accum);
+		break;
+	default:
+		M0_IMPOSSIBLE("Wrong batch opcode: %i", batch->bb_opc);
+	}
+}
+
 M0_INTERNAL void m0_btree_create_credit(const struct m0_btree_type *bt,
 					struct m0_be_tx_credit *accum,
 					m0_bcount_t nr)
@@ -5961,17 +6178,17 @@ static bool path_check(struct m0_btree_oimpl *oi, struct td *tree,
 
 	while (total_level >= 0) {
 		l_node = oi->i_level[total_level].l_node;
-		bnode_lock(l_node);
+		bnode_read_lock(l_node);
 		if (!bnode_isvalid(l_node)) {
-			bnode_unlock(l_node);
+			bnode_read_unlock(l_node);
 			bnode_op_fini(&oi->i_nop);
 			return false;
 		}
 		if (oi->i_level[total_level].l_seq != l_node->n_seq) {
-			bnode_unlock(l_node);
+			bnode_read_unlock(l_node);
 			return false;
 		}
-		bnode_unlock(l_node);
+		bnode_read_unlock(l_node);
 		total_level--;
 	}
 	return true;
@@ -5990,17 +6207,17 @@ static bool sibling_node_check(struct m0_btree_oimpl *oi)
 	if (l_sibling == NULL || oi->i_pivot == -1)
 		return true;
 
-	bnode_lock(l_sibling);
+	bnode_read_lock(l_sibling);
 	if (!bnode_isvalid(l_sibling)) {
-		bnode_unlock(l_sibling);
+		bnode_read_unlock(l_sibling);
 		bnode_op_fini(&oi->i_nop);
 		return false;
 	}
 	if (oi->i_level[oi->i_used].l_sib_seq != l_sibling->n_seq) {
-		bnode_unlock(l_sibling);
+		bnode_read_unlock(l_sibling);
 		return false;
 	}
-	bnode_unlock(l_sibling);
+	bnode_read_unlock(l_sibling);
 	return true;
 }
 
@@ -6019,6 +6236,25 @@ static void lock_op_unlock(struct td *tree)
 	m0_rwlock_write_unlock(&tree->t_lock);
 }
 
+/**
+ * Read-only operations (GET, MINKEY, MAXKEY, ITER) take the tree lock in
+ * shared mode. The lock only has to exclude modifications of the tree while
+ * the path traversed without it is validated (path_check()) and the record is
+ * handed to the user callback; several readers can do this in parallel.
+ */
+static int64_t lock_op_read_init(struct m0_sm_op *bo_op,
+				 struct node_op  *i_nop, struct td *tree,
+				 int nxt)
+{
+	m0_rwlock_read_lock(&tree->t_lock);
+	return nxt;
+}
+
+static void lock_op_read_unlock(struct td *tree)
+{
+	m0_rwlock_read_unlock(&tree->t_lock);
+}
+
 static void level_put(struct m0_btree_oimpl *oi)
 {
 	int i;
@@ -6129,11 +6365,11 @@ static void btree_tx_commit_cb(void *payload)
 	bnode_lock(node);
 	M0_ASSERT(node->n_txref != 0);
 	node->n_txref--;
-	if (!node->n_be_node_valid && node->n_ref == 0 && node->n_txref == 0) {
+	if (!node->n_be_node_valid && m0_atomic64_get(&node->n_ref) == 0 &&
+	    node->n_txref == 0) {
 		ndlist_tlink_del_fini(node);
 		bnode_unlock(node);
-		m0_rwlock_fini(&node->n_lock);
-		m0_free(node);
+		bnode_nd_free(node);
 		m0_rwlock_write_unlock(&list_lock);
 		return;
 	}
@@ -6272,6 +6508,31 @@ static int64_t btree_put_root_split_handle(struct m0_btree_op *bop,
 	return P_CAPTURE;
 }
 
+/**
+ * Returns true if the record for the given level is appended after the last key
+ * of lev->l_node by a BOF_APPEND PUT. In internal nodes the new separator goes
+ * just before the last child, i.e. at the index equal to the key count.
+ *
+ * Only the right edge of the tree qualifies: every level above lev has to be
+ * at its last child as well. A node in the middle of the tree keeps receiving
+ * keys below its right neighbour, so packing it full would make every later
+ * insert into it split again.
+ */
+static bool btree_put_is_append(const struct m0_btree_op *bop,
+				const struct level *lev)
+{
+	const struct m0_btree_oimpl *oi = bop->bo_i;
+	const struct level          *anc;
+
+	if (!(bop->bo_flags & BOF_APPEND) || oi->i_key_found)
+		return false;
+	for (anc = &oi->i_level[0]; anc <= lev; anc++) {
+		if (anc->l_idx < bnode_key_count(anc->l_node))
+			return false;
+	}
+	return true;
+}
+
 /**
  * This function is called when there is overflow and splitting needs to be
  * done. It will move some records from right node(l_node) to left node(l_alloc)
@@ -6283,10 +6544,14 @@ static int64_t btree_put_root_split_handle(struct m0_btree_op *bop,
  * @param current_node It is the current node, from where we want to move record
  * @param rec It is the given record for which we want to find slot
  * @param tgt result of record find will get stored in tgt slot
+ * @param append true if the given record goes after the last key of the
+ * current node as part of BOF_APPEND load. Then only the minimal number of
+ * records is left in the current node and the left node is packed full.
  */
 static void btree_put_split_and_find(struct nd *allocated_node,
 				     struct nd *current_node,
-				     struct m0_btree_rec *rec, struct slot *tgt)
+				     struct m0_btree_rec *rec, struct slot *tgt,
+				     bool append)
 {
 	struct slot              right_slot;
 	struct slot              left_slot;
@@ -6298,6 +6563,7 @@ static void btree_put_split_and_find(struct nd *allocated_node,
 	m0_bcount_t              vsize;
 	void                    *p_val;
 	int                      min_rec_count;
+	int                      nr;
 
 	/* intialised slot for left and right node*/
 	left_slot.s_node  = allocated_node;
@@ -6307,14 +6573,15 @@ static void btree_put_split_and_find(struct nd *allocated_node,
 
 	bnode_set_level(allocated_node, bnode_level(current_node));
 
-	bnode_move(current_node, allocated_node, D_LEFT, NR_EVEN);
+	min_rec_count = bnode_level(current_node) ? 2 : 1;
+	nr = append ? bnode_rec_count(current_node) - min_rec_count : NR_EVEN;
+	bnode_move(current_node, allocated_node, D_LEFT, nr);
 
 	/**
 	 * Assert that nodes still contain minimum number of records in the node
 	 * required by btree. If Assert fails, increase the node size or
 	 * decrease the object size.
 	 */
-	min_rec_count = bnode_level(current_node) ? 2 : 1;
 	M0_ASSERT(bnode_rec_count(current_node) >= min_rec_count);
 	M0_ASSERT(bnode_rec_count(allocated_node) >= min_rec_count);
 	/*2) Find appropriate slot for given record */
@@ -6408,7 +6675,8 @@ static int64_t btree_put_makespace_phase(struct m0_btree_op *bop)
 
 	lev->l_alloc_in_use = true;
 
-	btree_put_split_and_find(lev->l_alloc, lev->l_node, &bop->bo_rec, &tgt);
+	btree_put_split_and_find(lev->l_alloc, lev->l_node, &bop->bo_rec, &tgt,
+				 btree_put_is_append(bop, lev));
 
 	if (!oi->i_key_found) {
 		/* PUT operation */
@@ -6521,7 +6789,7 @@ static int64_t btree_put_makespace_phase(struct m0_btree_op *bop)
 		lev->l_alloc_in_use = true;
 
 		btree_put_split_and_find(lev->l_alloc, lev->l_node, &new_rec,
-					 &tgt);
+					 &tgt, btree_put_is_append(bop, lev));
 
 		tgt.s_rec = new_rec;
 		bnode_make(&tgt);
@@ -7356,7 +7624,8 @@ static int64_t btree_close_tree_tick(struct m0_sm_op *smop)
 	case P_WAITCHECK:
 		m0_rwlock_write_lock(&list_lock);
 		m0_tl_for(ndlist, &btree_active_nds, node) {
-			if (node->n_tree == tree && node->n_ref > 0) {
+			if (node->n_tree == tree &&
+			    m0_atomic64_get(&node->n_ref) > 0) {
 				m0_rwlock_write_unlock(&list_lock);
 				return P_WAITCHECK;
 			}
@@ -7474,7 +7743,7 @@ static int64_t btree_get_kv_tick(struct m0_sm_op *smop)
 			return P_SETUP;
 	case P_LOCKALL:
 		M0_ASSERT(bop->bo_flags & BOF_LOCKALL);
-		return lock_op_init(&bop->bo_op, &bop->bo_i->i_nop,
+		return lock_op_read_init(&bop->bo_op, &bop->bo_i->i_nop,
 				    bop->bo_arbor->t_desc, P_SETUP);
 	case P_SETUP:
 		oi->i_height = tree->t_height;
@@ -7494,7 +7763,7 @@ static int64_t btree_get_kv_tick(struct m0_sm_op *smop)
 			lev->l_node = oi->i_nop.no_node;
 			s.s_node = oi->i_nop.no_node;
 
-			bnode_lock(lev->l_node);
+			bnode_read_lock(lev->l_node);
 			lev->l_seq = lev->l_node->n_seq;
 
 			/**
@@ -7509,7 +7778,7 @@ static int64_t btree_get_kv_tick(struct m0_sm_op *smop)
 			 */
 			if (!bnode_isvalid(lev->l_node) || (oi->i_used > 0 &&
 			    bnode_rec_count(lev->l_node) == 0)) {
-				bnode_unlock(lev->l_node);
+				bnode_read_unlock(lev->l_node);
 				return m0_sm_op_sub(&bop->bo_op, P_CLEANUP,
 						    P_SETUP);
 			}
@@ -7532,7 +7801,7 @@ static int64_t btree_get_kv_tick(struct m0_sm_op *smop)
 
 				bnode_child(&s, &child);
 				if (!address_in_segment(child)) {
-					bnode_unlock(lev->l_node);
+					bnode_read_unlock(lev->l_node);
 					bnode_op_fini(&oi->i_nop);
 					return fail(bop, M0_ERR(-EFAULT));
 				}
@@ -7540,21 +7809,21 @@ static int64_t btree_get_kv_tick(struct m0_sm_op *smop)
 				if (oi->i_used >= oi->i_height) {
 					/* If height of tree increased. */
 					oi->i_used = oi->i_height - 1;
-					bnode_unlock(lev->l_node);
+					bnode_read_unlock(lev->l_node);
 					return m0_sm_op_sub(&bop->bo_op,
 							    P_CLEANUP, P_SETUP);
 				}
-				bnode_unlock(lev->l_node);
+				bnode_read_unlock(lev->l_node);
 				return bnode_get(&oi->i_nop, tree, &child,
 						 P_NEXTDOWN);
 			} else {
 				if ((lev->l_idx == bnode_key_count(lev->l_node)) &&
 				    (!oi->i_key_found) &&
 				    (bop->bo_flags & BOF_SLANT)) {
-					bnode_unlock(lev->l_node);
+					bnode_read_unlock(lev->l_node);
 					return P_SIBLING;
 				}
-				bnode_unlock(lev->l_node);
+				bnode_read_unlock(lev->l_node);
 				return P_LOCK;
 			}
 		} else {
@@ -7574,15 +7843,15 @@ static int64_t btree_get_kv_tick(struct m0_sm_op *smop)
 			return P_LOCK;
 		}
 
-		bnode_lock(lev->l_sibling);
+		bnode_read_lock(lev->l_sibling);
 		lev->l_sib_seq = lev->l_sibling->n_seq;
-		bnode_unlock(lev->l_sibling);
+		bnode_read_unlock(lev->l_sibling);
 
 		return P_LOCK;
 	}
 	case P_LOCK:
 		if (!lock_acquired)
-			return lock_op_init(&bop->bo_op, &bop->bo_i->i_nop,
+			return lock_op_read_init(&bop->bo_op, &bop->bo_i->i_nop,
 					    bop->bo_arbor->t_desc, P_CHECK);
 		/** Fall through if LOCK is already acquired. */
 	case P_CHECK:
@@ -7594,18 +7863,18 @@ static int64_t btree_get_kv_tick(struct m0_sm_op *smop)
 					       0, "Get record failure in tree"
 					       "lock mode");
 				bop->bo_flags |= BOF_LOCKALL;
-				lock_op_unlock(tree);
+				lock_op_read_unlock(tree);
 				return m0_sm_op_sub(&bop->bo_op, P_CLEANUP,
 						    P_LOCKALL);
 			}
 			if (oi->i_height != tree->t_height) {
 				/* If height has changed. */
-				lock_op_unlock(tree);
+				lock_op_read_unlock(tree);
 				return m0_sm_op_sub(&bop->bo_op, P_CLEANUP,
 				                    P_SETUP);
 			} else {
 				/* If height is same, put back all the nodes. */
-				lock_op_unlock(tree);
+				lock_op_read_unlock(tree);
 				level_put(oi);
 				return P_DOWN;
 			}
@@ -7642,7 +7911,7 @@ static int64_t btree_get_kv_tick(struct m0_sm_op *smop)
 			if (oi->i_key_found)
 				bnode_rec(&s);
 			else if (bop->bo_flags & BOF_EQUAL) {
-				lock_op_unlock(tree);
+				lock_op_read_unlock(tree);
 				return fail(bop, -ENOENT);
 			} else { /** bop->bo_flags & BOF_SLANT */
 				if (lev->l_idx < count)
@@ -7654,7 +7923,7 @@ static int64_t btree_get_kv_tick(struct m0_sm_op *smop)
 						bnode_rec(&s);
 					} else {
 						bnode_op_fini(&oi->i_nop);
-						lock_op_unlock(tree);
+						lock_op_read_unlock(tree);
 						return fail(bop, -ENOENT);
 					}
 				}
@@ -7667,7 +7936,7 @@ static int64_t btree_get_kv_tick(struct m0_sm_op *smop)
 				bnode_rec(&s);
 			} else {
 				/** Only root node is present and is empty. */
-				lock_op_unlock(tree);
+				lock_op_read_unlock(tree);
 				return fail(bop, -ENOENT);
 			}
 		}
@@ -7675,7 +7944,7 @@ static int64_t btree_get_kv_tick(struct m0_sm_op *smop)
 		if (bop->bo_cb.c_act != NULL)
 			rc = bop->bo_cb.c_act(&bop->bo_cb, &s.s_rec);
 
-		lock_op_unlock(tree);
+		lock_op_read_unlock(tree);
 		if (rc != 0)
 			return fail(bop, rc);
 		return m0_sm_op_sub(&bop->bo_op, P_CLEANUP, P_FINI);
@@ -7721,7 +7990,7 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 			return P_SETUP;
 	case P_LOCKALL:
 		M0_ASSERT(bop->bo_flags & BOF_LOCKALL);
-		return lock_op_init(&bop->bo_op, &bop->bo_i->i_nop,
+		return lock_op_read_init(&bop->bo_op, &bop->bo_i->i_nop,
 				    bop->bo_arbor->t_desc, P_SETUP);
 	case P_SETUP:
 		oi->i_height = tree->t_height;
@@ -7742,7 +8011,7 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 			lev->l_node = oi->i_nop.no_node;
 			s.s_node = oi->i_nop.no_node;
 
-			bnode_lock(lev->l_node);
+			bnode_read_lock(lev->l_node);
 			lev->l_seq = lev->l_node->n_seq;
 
 			/**
@@ -7757,7 +8026,7 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 			 */
 			if (!bnode_isvalid(lev->l_node) || (oi->i_used > 0 &&
 			    bnode_rec_count(lev->l_node) == 0)) {
-				bnode_unlock(lev->l_node);
+				bnode_read_unlock(lev->l_node);
 				return m0_sm_op_sub(&bop->bo_op, P_CLEANUP,
 						    P_SETUP);
 			}
@@ -7786,7 +8055,7 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 
 				bnode_child(&s, &child);
 				if (!address_in_segment(child)) {
-					bnode_unlock(lev->l_node);
+					bnode_read_unlock(lev->l_node);
 					bnode_op_fini(&oi->i_nop);
 					return fail(bop, M0_ERR(-EFAULT));
 				}
@@ -7794,11 +8063,11 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 				if (oi->i_used >= oi->i_height) {
 					/* If height of tree increased. */
 					oi->i_used = oi->i_height - 1;
-					bnode_unlock(lev->l_node);
+					bnode_read_unlock(lev->l_node);
 					return m0_sm_op_sub(&bop->bo_op,
 							    P_CLEANUP, P_SETUP);
 				}
-				bnode_unlock(lev->l_node);
+				bnode_read_unlock(lev->l_node);
 				return bnode_get(&oi->i_nop, tree, &child,
 						 P_NEXTDOWN);
 			} else	{
@@ -7819,10 +8088,10 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 				 *   leftmost for PREV flag).
 				 */
 				if (index_is_valid(lev) || oi->i_pivot == -1) {
-					bnode_unlock(lev->l_node);
+					bnode_read_unlock(lev->l_node);
 					return P_LOCK;
 				}
-				bnode_unlock(lev->l_node);
+				bnode_read_unlock(lev->l_node);
 				/**
 				 * We are here, it means we want to load
 				 * sibling node of the leaf node.
@@ -7833,17 +8102,17 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 				 * state machine.
 				 */
 				lev = &oi->i_level[oi->i_pivot];
-				bnode_lock(lev->l_node);
+				bnode_read_lock(lev->l_node);
 				if (!bnode_isvalid(lev->l_node) ||
 				    (oi->i_pivot > 0 &&
 				     bnode_rec_count(lev->l_node) == 0)) {
-					bnode_unlock(lev->l_node);
+					bnode_read_unlock(lev->l_node);
 					bnode_op_fini(&oi->i_nop);
 					return m0_sm_op_sub(&bop->bo_op,
 							    P_CLEANUP, P_SETUP);
 				}
 				if (lev->l_seq != lev->l_node->n_seq) {
-					bnode_unlock(lev->l_node);
+					bnode_read_unlock(lev->l_node);
 					return m0_sm_op_sub(&bop->bo_op,
 							    P_CLEANUP, P_SETUP);
 				}
@@ -7860,12 +8129,12 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 
 				bnode_child(&s, &child);
 				if (!address_in_segment(child)) {
-					bnode_unlock(lev->l_node);
+					bnode_read_unlock(lev->l_node);
 					bnode_op_fini(&oi->i_nop);
 					return fail(bop, M0_ERR(-EFAULT));
 				}
 				oi->i_pivot++;
-				bnode_unlock(lev->l_node);
+				bnode_read_unlock(lev->l_node);
 				return bnode_get(&oi->i_nop, tree, &child,
 						 P_SIBLING);
 			}
@@ -7881,7 +8150,7 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 			lev = &oi->i_level[oi->i_pivot];
 			lev->l_sibling = oi->i_nop.no_node;
 			s.s_node = oi->i_nop.no_node;
-			bnode_lock(lev->l_sibling);
+			bnode_read_lock(lev->l_sibling);
 			lev->l_sib_seq = lev->l_sibling->n_seq;
 
 			/**
@@ -7897,7 +8166,7 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 			if (!bnode_isvalid(lev->l_sibling) ||
 			    (oi->i_pivot > 0 &&
 			     bnode_rec_count(lev->l_sibling) == 0)) {
-				bnode_unlock(lev->l_sibling);
+				bnode_read_unlock(lev->l_sibling);
 				return m0_sm_op_sub(&bop->bo_op, P_CLEANUP,
 						    P_SETUP);
 			}
@@ -7907,22 +8176,22 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 					  bnode_key_count(s.s_node);
 				bnode_child(&s, &child);
 				if (!address_in_segment(child)) {
-					bnode_unlock(lev->l_sibling);
+					bnode_read_unlock(lev->l_sibling);
 					bnode_op_fini(&oi->i_nop);
 					return fail(bop, M0_ERR(-EFAULT));
 				}
 				oi->i_pivot++;
 				if (oi->i_pivot >= oi->i_height) {
 					/* If height of tree increased. */
-					bnode_unlock(lev->l_sibling);
+					bnode_read_unlock(lev->l_sibling);
 					return m0_sm_op_sub(&bop->bo_op,
 							    P_CLEANUP, P_SETUP);
 				}
-				bnode_unlock(lev->l_sibling);
+				bnode_read_unlock(lev->l_sibling);
 				return bnode_get(&oi->i_nop, tree, &child,
 						 P_SIBLING);
 			} else {
-				bnode_unlock(lev->l_sibling);
+				bnode_read_unlock(lev->l_sibling);
 				return P_LOCK;
 			}
 		} else {
@@ -7931,7 +8200,7 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 		}
 	case P_LOCK:
 		if (!lock_acquired)
-			return lock_op_init(&bop->bo_op, &bop->bo_i->i_nop,
+			return lock_op_read_init(&bop->bo_op, &bop->bo_i->i_nop,
 					    bop->bo_arbor->t_desc, P_CHECK);
 		/** Fall through if LOCK is already acquired. */
 	case P_CHECK:
@@ -7943,17 +8212,17 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 					       0, "Iterator failure in tree"
 					       "lock mode");
 				bop->bo_flags |= BOF_LOCKALL;
-				lock_op_unlock(tree);
+				lock_op_read_unlock(tree);
 				return m0_sm_op_sub(&bop->bo_op, P_CLEANUP,
 						    P_LOCKALL);
 			}
 			if (oi->i_height != tree->t_height) {
-				lock_op_unlock(tree);
+				lock_op_read_unlock(tree);
 				return m0_sm_op_sub(&bop->bo_op, P_CLEANUP,
 				                    P_SETUP);
 			} else {
 				/* If height is same, put back all the nodes. */
-				lock_op_unlock(tree);
+				lock_op_read_unlock(tree);
 				level_put(oi);
 				return P_DOWN;
 			}
@@ -7982,7 +8251,7 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 			bnode_rec(&s);
 		} else if (oi->i_pivot == -1) {
 			/* Handle rightmost/leftmost key case. */
-			lock_op_unlock(tree);
+			lock_op_read_unlock(tree);
 			return fail(bop, -ENOENT);
 		} else {
 			/* Return sibling record based on flag. */
@@ -7992,7 +8261,7 @@ static int64_t btree_iter_kv_tick(struct m0_sm_op *smop)
 			bnode_rec(&s);
 		}
 		rc = bop->bo_cb.c_act(&bop->bo_cb, &s.s_rec);
-		lock_op_unlock(tree);
+		lock_op_read_unlock(tree);
 		if (rc != 0)
 			return fail(bop, rc);
 		return m0_sm_op_sub(&bop->bo_op, P_CLEANUP, P_FINI);
@@ -8733,7 +9002,8 @@ M0_INTERNAL int64_t m0_btree_lrulist_purge(int64_t size, int64_t num_nodes)
 	while (node != NULL && (size > 0 || num_nodes > 0)) {
 		curr_size = 0;
 		prev      = ndlist_tlist_prev(&btree_lru_nds, node);
-		if (node->n_txref == 0 && node->n_ref == 0) {
+		if (node->n_txref == 0 &&
+		    m0_atomic64_get(&node->n_ref) == 0) {
 			curr_size = node->n_size + m0_be_chunk_header_size();
 			seg       = node->n_seg;
 			a         = m0_be_seg_allocator(seg);
@@ -8752,8 +9022,7 @@ M0_INTERNAL int64_t m0_btree_lrulist_purge(int64_t size, int64_t num_nodes)
 					total_size += curr_size;
 					ndlist_tlink_del_fini(node);
 					lru_space_used -= curr_size;
-					m0_rwlock_fini(&node->n_lock);
-					m0_free(node);
+					bnode_nd_free(node);
 				} else
 					M0_LOG(M0_ERROR,
 					       "Remapping of memory failed");
@@ -8945,17 +9214,17 @@ M0_INTERNAL void m0_btree_iter(struct m0_btree *arbor,
 		      &btree_conf, &bop->bo_sm_group);
 }
 
-M0_INTERNAL void m0_btree_put(struct m0_btree *arbor,
-			      const struct m0_btree_rec *rec,
-			      const struct m0_btree_cb *cb,
-			      struct m0_btree_op *bop, struct m0_be_tx *tx)
+static void btree_put_init(struct m0_btree *arbor,
+			   const struct m0_btree_rec *rec,
+			   const struct m0_btree_cb *cb, uint64_t flags,
+			   struct m0_btree_op *bop, struct m0_be_tx *tx)
 {
 	bop->bo_opc    = M0_BO_PUT;
 	bop->bo_arbor  = arbor;
 	bop->bo_rec    = *rec;
 	bop->bo_cb     = *cb;
 	bop->bo_tx     = tx;
-	bop->bo_flags  = 0;
+	bop->bo_flags  = flags;
 	bop->bo_seg    = arbor->t_desc->t_seg;
 	bop->bo_i      = NULL;
 
@@ -8963,6 +9232,14 @@ M0_INTERNAL void m0_btree_put(struct m0_btree *arbor,
 		      &btree_conf, &bop->bo_sm_group);
 }
 
+M0_INTERNAL void m0_btree_put(struct m0_btree *arbor,
+			      const struct m0_btree_rec *rec,
+			      const struct m0_btree_cb *cb,
+			      struct m0_btree_op *bop, struct m0_be_tx *tx)
+{
+	btree_put_init(arbor, rec, cb, 0, bop, tx);
+}
+
 M0_INTERNAL void m0_btree_del(struct m0_btree *arbor,
 			      const struct m0_btree_key *key,
 			      const struct m0_btree_cb *cb,
@@ -9184,91 +9461,525 @@ M0_INTERNAL bool m0_btree_is_empty(struct m0_btree *btree)
 	return (bnode_rec_count(btree->t_desc->t_root) == 0);
 }
 
-#ifndef __KERNEL__
 /**
- *  --------------------------
- *  Section START - Unit Tests
- *  --------------------------
+ * Compares the key at index idx of the node with the given key. The ordering is
+ * the same as used by bnode_find().
  */
+static int bnode_key_cmp(const struct nd *node, int idx,
+			 const struct m0_btree_key *key)
+{
+	struct m0_btree_rec_key_op *keycmp    = &node->n_tree->t_keycmp;
+	void                       *find_data = key->k_data.ov_buf[0];
+	m0_bcount_t                 fsize     = key->k_data.ov_vec.v_count[0];
+	void                       *p_key;
+	m0_bcount_t                 ksize;
+	struct slot                 s         = {
+		.s_node = node,
+		.s_idx  = idx,
+	};
 
-/**
- * The code contained below is 'ut'. This is a little experiment to contain the
- * ut code in the same file containing the functionality code. We are open to
- * changes iff enough reasons are found that this model either does not work or
- * is not intuitive or maintainable.
- */
+	M0_PRE(key->k_data.ov_vec.v_nr == 1);
 
-static struct m0_be_ut_backend *ut_be;
-static struct m0_be_ut_seg     *ut_seg;
-static struct m0_be_seg        *seg;
-static bool                     btree_ut_initialised = false;
+	s.s_rec.r_key.k_data = M0_BUFVEC_INIT_BUF(&p_key, &ksize);
+	bnode_key(&s);
+	if (keycmp->rko_keycmp != NULL)
+		return keycmp->rko_keycmp(p_key, find_data);
+	return bnode_key_raw_cmp(p_key, ksize, find_data, fsize,
+				 fsize >= sizeof(uint64_t) ?
+				 bnode_key_head(find_data) : 0);
+}
 
-static void btree_ut_init(void)
+/**
+ * Returns the level of the path (0 is the root) from which the descent for key
+ * has to start, i.e., the lowest level whose node covers key. The key must not
+ * be less than the key the path was built for.
+ *
+ * The sub-tree rooted at path[l] covers all the keys less than the delimiting
+ * key which follows it in its parent, path[l - 1]. If path[l] is the rightmost
+ * child of its parent, the bound is inherited from the parent.
+ */
+static int btree_batch_path_restart(struct nd **path, const int *cidx,
+				    int height, const struct m0_btree_key *key)
 {
-	if (!btree_ut_initialised) {
-		btree_ut_initialised = true;
+	int lev;
+	int parent;
+
+	for (lev = height - 1; lev > 0; lev = parent) {
+		parent = lev - 1;
+		if (cidx[parent] < bnode_key_count(path[parent]) &&
+		    bnode_key_cmp(path[parent], cidx[parent], key) > 0)
+			break;
 	}
+	return lev;
 }
 
-static void btree_ut_fini(void)
+static void btree_batch_path_put(struct node_op *nop, struct nd **path,
+				 int from, int height)
 {
-	btree_ut_initialised = false;
+	int lev;
+
+	for (lev = from; lev < height; lev++) {
+		if (path[lev] != NULL) {
+			bnode_put(nop, path[lev]);
+			path[lev] = NULL;
+		}
+	}
 }
 
 /**
- * In this unit test we exercise a few tree operations in invalid conditions
- * only.
+ * Descends from path[lev] to the leaf covering key, filling path[] and cidx[]
+ * below lev. Returns a negative error code, or else whether the key is present
+ * in the leaf; s then points to the slot of the key in the leaf.
  */
-static void ut_basic_tree_oper_icp(void)
+static int btree_batch_descend(struct td *tree, struct node_op *nop,
+			       struct nd **path, int *cidx, int lev,
+			       struct m0_btree_key *key, struct slot *s)
 {
-	void                   *invalid_addr = (void *)0xbadbadbadbad;
-	struct m0_btree         btree;
-	struct m0_btree_type    btree_type = {  .tt_id = M0_BT_UT_KV_OPS,
-						.ksize = 8,
-						.vsize = 8, };
-	struct m0_be_tx         tx_data    = {};
-	struct m0_be_tx        *tx         = &tx_data;
-	struct m0_btree_op      b_op       = {};
-	struct m0_be_tx_credit  cred       = {};
-	void                   *temp_node;
-	int                     rc;
-	struct m0_fid           fid        = M0_FID_TINIT('b', 0, 1);
-	uint32_t                rnode_sz   = m0_pagesize_get();
-	uint32_t                rnode_sz_shift;
-	struct m0_buf           buf;
+	struct segaddr child;
+	bool           found;
+	int            rc;
 
-	btree_ut_init();
+	for (;; lev++) {
+		s->s_node = path[lev];
+		found = bnode_find(s, key);
+		if (bnode_level(s->s_node) == 0)
+			return found;
+		if (found)
+			s->s_idx++;
+		cidx[lev] = s->s_idx;
+		bnode_child(s, &child);
+		if (!address_in_segment(child))
+			return M0_ERR(-EFAULT);
+		bnode_get(nop, tree, &child, 0);
+		rc = nop->no_op.o_sm.sm_rc;
+		if (rc != 0)
+			return rc;
+		path[lev + 1] = nop->no_node;
+	}
+}
 
-	M0_ASSERT(rnode_sz != 0 && m0_is_po2(rnode_sz));
-	rnode_sz_shift = __builtin_ffsl(rnode_sz) - 1;
-	cred = M0_BE_TX_CB_CREDIT(0, 0, 0);
-	m0_be_allocator_credit(NULL, M0_BAO_ALLOC_ALIGNED, rnode_sz,
-			       rnode_sz_shift, &cred);
-	m0_btree_create_credit(&btree_type, &cred, 1);
+static int btree_batch_get(struct td *tree, struct m0_btree_batch *batch)
+{
+	struct node_op  nop                     = {};
+	struct nd      *path[MAX_TREE_HEIGHT]   = {};
+	int             cidx[MAX_TREE_HEIGHT]   = {};
+	int             height;
+	int             lev;
+	uint32_t        i;
+	int             rc                      = 0;
 
-	/** Prepare transaction to capture tree operations. */
-	m0_be_ut_tx_init(tx, ut_be);
-	m0_be_tx_prep(tx, &cred);
-	rc = m0_be_tx_open_sync(tx);
-	M0_ASSERT(rc == 0);
+	m0_rwlock_read_lock(&tree->t_lock);
+	height = tree->t_height;
+	bnode_get(&nop, tree, &tree->t_root->n_addr, 0);
+	rc = nop.no_op.o_sm.sm_rc;
+	path[0] = nop.no_node;
 
-	/**
-	 *  Run a invalid scenario which:
-	 *  1) Attempts to create a btree with invalid address
-	 *
-	 * This scenario is invalid because the root node address is incorrect.
-	 * In this case m0_btree_create() will return -EFAULT.
-	 */
-	rc = M0_BTREE_OP_SYNC_WITH_RC(&b_op, m0_btree_create(invalid_addr,
-				      rnode_sz, &btree_type, M0_BCT_NO_CRC,
-				      &b_op, &btree, seg, &fid, tx, NULL));
-	M0_ASSERT(rc == -EFAULT);
-	m0_be_tx_close_sync(tx);
-	m0_be_tx_fini(tx);
+	for (i = 0; i < batch->bb_nr && rc == 0; i++) {
+		struct m0_btree_rec *rec   = &batch->bb_recs[i];
+		struct m0_btree_key *key   = &rec->r_key;
+		struct slot          s     = {};
+		bool                 found;
 
-	/**
-	 *  Run a invalid scenario which:
-	 *  1) Attempts to open a btree with invalid address
+		lev = i == 0 ? 0 :
+		      btree_batch_path_restart(path, cidx, height, key);
+		btree_batch_path_put(&nop, path, lev + 1, height);
+
+		rc = btree_batch_descend(tree, &nop, path, cidx, lev, key, &s);
+		if (rc < 0)
+			break;
+		found = rc;
+		rc = 0;
+
+		batch->bb_idx = i;
+		if (batch->bb_rc != NULL)
+			batch->bb_rc[i] = found ? 0 : -ENOENT;
+		if (found && batch->bb_cb.c_act != NULL) {
+			m0_bcount_t  ksize;
+			m0_bcount_t  vsize;
+			void        *pkey;
+			void        *pval;
+
+			REC_INIT(&s.s_rec, &pkey, &ksize, &pval, &vsize);
+			s.s_rec.r_flags = M0_BSC_SUCCESS;
+			bnode_rec(&s);
+			rc = batch->bb_cb.c_act(&batch->bb_cb, &s.s_rec);
+		}
+	}
+
+	btree_batch_path_put(&nop, path, 0, height);
+	m0_rwlock_read_unlock(&tree->t_lock);
+	return rc;
+}
+
+/**
+ * Returns true if the current record of the modifying batch can be applied to
+ * the leaf found by the shared descent without splitting the leaf or freeing
+ * it, i.e., without touching any other node of the path.
+ */
+static bool btree_batch_leaf_fits(const struct m0_btree_batch *batch,
+				  struct slot *s, bool found, int height)
+{
+	const struct m0_btree_rec *rec = &batch->bb_recs[batch->bb_idx];
+	m0_bcount_t                ksize;
+	m0_bcount_t                vsize;
+	void                      *p_key;
+	void                      *p_val;
+	int                        vsize_diff;
+
+	switch (batch->bb_opc) {
+	case M0_BO_DEL:
+		/* Only a non-root leaf left empty is freed. */
+		return !found || height == 1 ||
+		       !bnode_isunderflow(s->s_node, true);
+	case M0_BO_UPDATE:
+		if (found) {
+			REC_INIT(&s->s_rec, &p_key, &ksize, &p_val, &vsize);
+			bnode_rec(s);
+			vsize_diff = m0_vec_count(&rec->r_val.ov_vec) -
+				     m0_vec_count(&s->s_rec.r_val.ov_vec);
+			return vsize_diff <= 0 ||
+			       bnode_space(s->s_node) >= vsize_diff;
+		}
+		if (!(batch->bb_flags & BOF_INSERT_IF_NOT_FOUND))
+			return true;
+		/* Fall through. */
+	case M0_BO_PUT:
+		if (found)
+			return true;
+		s->s_rec = *rec;
+		return bnode_isfit(s);
+	default:
+		M0_IMPOSSIBLE("Wrong batch opcode: %i", batch->bb_opc);
+	}
+}
+
+/**
+ * Inserts or updates the current record of the batch in the leaf, the same way
+ * as P_MAKESPACE and P_ACT phases of btree_put_kv_tick() do when the leaf does
+ * not overflow. The caller has checked btree_batch_leaf_fits().
+ */
+static int btree_batch_leaf_put(struct m0_btree_batch *batch, struct nd *leaf,
+				struct slot *s, bool found)
+{
+	const struct m0_btree_rec *rec        = &batch->bb_recs[batch->bb_idx];
+	int                        vsize_diff = 0;
+	m0_bcount_t                ksize;
+	m0_bcount_t                vsize;
+	void                      *p_key;
+	void                      *p_val;
+	int                        rc;
+
+	if (found && batch->bb_opc == M0_BO_PUT)
+		return -EEXIST;
+	if (!found && batch->bb_opc == M0_BO_UPDATE &&
+	    !(batch->bb_flags & BOF_INSERT_IF_NOT_FOUND))
+		return -ENOENT;
+
+	if (!found) {
+		s->s_rec = *rec;
+		bnode_lock(leaf);
+		bnode_make(s);
+	} else {
+		REC_INIT(&s->s_rec, &p_key, &ksize, &p_val, &vsize);
+		bnode_rec(s);
+		vsize_diff = m0_vec_count(&rec->r_val.ov_vec) -
+			     m0_vec_count(&s->s_rec.r_val.ov_vec);
+		bnode_lock(leaf);
+		bnode_val_resize(s, vsize_diff);
+	}
+
+	REC_INIT(&s->s_rec, &p_key, &ksize, &p_val, &vsize);
+	bnode_rec(s);
+	s->s_rec.r_flags = M0_BSC_SUCCESS;
+	rc = batch->bb_cb.c_act(&batch->bb_cb, &s->s_rec);
+	if (rc != 0) {
+		if (!found)
+			bnode_del(leaf, s->s_idx);
+		else
+			bnode_val_resize(s, -vsize_diff);
+	}
+	bnode_done(s, true);
+	bnode_seq_cnt_update(leaf);
+	bnode_fix(leaf);
+	M0_ASSERT_EX(bnode_expensive_invariant(leaf));
+	bnode_unlock(leaf);
+	return rc;
+}
+
+/**
+ * Deletes the current record of the batch from the leaf, the same way as P_ACT
+ * phase of btree_del_kv_tick() does when the leaf does not underflow.
+ */
+static int btree_batch_leaf_del(struct m0_btree_batch *batch, struct nd *leaf,
+				struct slot *s, bool found)
+{
+	m0_bcount_t  ksize;
+	m0_bcount_t  vsize;
+	void        *p_key;
+	void        *p_val;
+	int          rc;
+
+	if (!found)
+		return -ENOENT;
+
+	if (batch->bb_cb.c_act != NULL) {
+		REC_INIT(&s->s_rec, &p_key, &ksize, &p_val, &vsize);
+		bnode_rec(s);
+		s->s_rec.r_flags = M0_BSC_SUCCESS;
+		rc = batch->bb_cb.c_act(&batch->bb_cb, &s->s_rec);
+		if (rc != 0)
+			return rc;
+	}
+
+	bnode_lock(leaf);
+	bnode_del(leaf, s->s_idx);
+	bnode_done(s, false);
+	bnode_seq_cnt_update(leaf);
+	bnode_fix(leaf);
+	M0_ASSERT_EX(bnode_expensive_invariant(leaf));
+	bnode_unlock(leaf);
+	return 0;
+}
+
+/**
+ * Captures the part of the leaf modified by the batch, starting from the lowest
+ * modified index, once the batch moves past the leaf.
+ */
+static void btree_batch_capture(struct node_capture_info *cap,
+				struct m0_be_tx *tx)
+{
+	struct slot s = { .s_node = cap->nc_node, .s_idx = cap->nc_idx };
+
+	if (cap->nc_node == NULL)
+		return;
+	bnode_capture(&s, tx);
+	bnode_lock(cap->nc_node);
+	cap->nc_node->n_txref++;
+	bnode_unlock(cap->nc_node);
+	M0_BTREE_TX_CB_CAPTURE(tx, cap->nc_node, &btree_tx_commit_cb);
+	cap->nc_node = NULL;
+}
+
+/**
+ * Executes the current record of the batch by the regular state machine. This
+ * is used when the record does not fit into its leaf (or empties it), so that
+ * splits and merges are handled as usual.
+ */
+static int btree_batch_one(struct m0_btree *arbor,
+			   struct m0_btree_batch *batch, struct m0_be_tx *tx)
+{
+	struct m0_btree_op   kv_op = {};
+	struct m0_btree_rec *rec   = &batch->bb_recs[batch->bb_idx];
+
+	switch (batch->bb_opc) {
+	case M0_BO_PUT:
+		return M0_BTREE_OP_SYNC_WITH_RC(&kv_op,
+			btree_put_init(arbor, rec, &batch->bb_cb,
+				       batch->bb_flags & BOF_APPEND,
+				       &kv_op, tx));
+	case M0_BO_UPDATE:
+		return M0_BTREE_OP_SYNC_WITH_RC(&kv_op,
+			m0_btree_update(arbor, rec, &batch->bb_cb,
+					batch->bb_flags, &kv_op, tx));
+	case M0_BO_DEL:
+		return M0_BTREE_OP_SYNC_WITH_RC(&kv_op,
+			m0_btree_del(arbor, &rec->r_key, &batch->bb_cb,
+				     &kv_op, tx));
+	default:
+		M0_IMPOSSIBLE("Wrong batch opcode: %i", batch->bb_opc);
+	}
+}
+
+/**
+ * Executes a modifying batch. The tree lock is taken for writing and the path
+ * to the leaf is kept between adjacent records, as in btree_batch_get(). A
+ * record that can be applied to its leaf alone is applied in place; the leaf
+ * is captured once, when the batch moves to another leaf. Otherwise the path
+ * and the lock are released, the record goes through the regular state
+ * machine and the next record descends from the root again.
+ */
+static int btree_batch_mod(struct m0_btree *arbor,
+			   struct m0_btree_batch *batch, struct m0_be_tx *tx)
+{
+	struct td                *tree                  = arbor->t_desc;
+	struct node_op            nop                   = {};
+	struct nd                *path[MAX_TREE_HEIGHT] = {};
+	int                       cidx[MAX_TREE_HEIGHT] = {};
+	struct node_capture_info  cap                   = {};
+	bool                      locked                = false;
+	int                       height                = 0;
+	int                       lev;
+	uint32_t                  i;
+	int                       rc                    = 0;
+
+	for (i = 0; i < batch->bb_nr; i++) {
+		struct m0_btree_key *key   = &batch->bb_recs[i].r_key;
+		struct slot          s     = {};
+		struct nd           *leaf;
+		bool                 found;
+
+		batch->bb_idx = i;
+		if (!locked) {
+			m0_rwlock_write_lock(&tree->t_lock);
+			locked = true;
+			height = tree->t_height;
+			bnode_get(&nop, tree, &tree->t_root->n_addr, 0);
+			rc = nop.no_op.o_sm.sm_rc;
+			if (rc != 0)
+				break;
+			path[0] = nop.no_node;
+			lev = 0;
+		} else
+			lev = btree_batch_path_restart(path, cidx, height,
+						       key);
+		if (lev < height - 1)
+			btree_batch_capture(&cap, tx);
+		btree_batch_path_put(&nop, path, lev + 1, height);
+
+		rc = btree_batch_descend(tree, &nop, path, cidx, lev, key, &s);
+		if (rc < 0)
+			break;
+		found = rc;
+
+		leaf = path[height - 1];
+		if (btree_batch_leaf_fits(batch, &s, found, height)) {
+			rc = batch->bb_opc == M0_BO_DEL ?
+				btree_batch_leaf_del(batch, leaf, &s, found) :
+				btree_batch_leaf_put(batch, leaf, &s, found);
+			if (rc == 0 &&
+			    (cap.nc_node == NULL || s.s_idx < cap.nc_idx)) {
+				cap.nc_node = leaf;
+				cap.nc_idx  = s.s_idx;
+			}
+		} else {
+			btree_batch_capture(&cap, tx);
+			btree_batch_path_put(&nop, path, 0, height);
+			m0_rwlock_write_unlock(&tree->t_lock);
+			locked = false;
+			rc = btree_batch_one(arbor, batch, tx);
+		}
+
+		if (batch->bb_rc != NULL)
+			batch->bb_rc[i] = rc;
+		/* Missing and existing keys do not stop a reported batch. */
+		if (rc != 0 && !(batch->bb_rc != NULL &&
+				 M0_IN(rc, (-ENOENT, -EEXIST))))
+			break;
+		rc = 0;
+	}
+
+	if (locked) {
+		btree_batch_capture(&cap, tx);
+		btree_batch_path_put(&nop, path, 0, height);
+		m0_rwlock_write_unlock(&tree->t_lock);
+	}
+	return rc;
+}
+
+M0_INTERNAL int m0_btree_batch(struct m0_btree       *arbor,
+			       struct m0_btree_batch *batch,
+			       struct m0_be_tx       *tx)
+{
+	M0_ENTRY("opc=%d nr=%u", batch->bb_opc, batch->bb_nr);
+	M0_PRE(M0_IN(batch->bb_opc,
+		     (M0_BO_GET, M0_BO_PUT, M0_BO_UPDATE, M0_BO_DEL)));
+	M0_PRE(ergo(batch->bb_opc != M0_BO_GET, tx != NULL));
+	M0_PRE(ergo(batch->bb_opc == M0_BO_PUT,
+		    (batch->bb_flags & ~BOF_APPEND) == 0));
+
+	if (batch->bb_nr == 0)
+		return M0_RC(0);
+
+	return M0_RC(batch->bb_opc == M0_BO_GET ?
+		     btree_batch_get(arbor->t_desc, batch) :
+		     btree_batch_mod(arbor, batch, tx));
+}
+
+#ifndef __KERNEL__
+/**
+ *  --------------------------
+ *  Section START - Unit Tests
+ *  --------------------------
+ */
+
+/**
+ * The code contained below is 'ut'. This is a little experiment to contain the
+ * ut code in the same file containing the functionality code. We are open to
+ * changes iff enough reasons are found that this model either does not work or
+ * is not intuitive or maintainable.
+ */
+
+static struct m0_be_ut_backend *ut_be;
+static struct m0_be_ut_seg     *ut_seg;
+static struct m0_be_seg        *seg;
+static bool                     btree_ut_initialised = false;
+
+static void btree_ut_init(void)
+{
+	if (!btree_ut_initialised) {
+		btree_ut_initialised = true;
+	}
+}
+
+static void btree_ut_fini(void)
+{
+	btree_ut_initialised = false;
+}
+
+/**
+ * In this unit test we exercise a few tree operations in invalid conditions
+ * only.
+ */
+static void ut_basic_tree_oper_icp(void)
+{
+	void                   *invalid_addr = (void *)0xbadbadbadbad;
+	struct m0_btree         btree;
+	struct m0_btree_type    btree_type = {  .tt_id = M0_BT_UT_KV_OPS,
+						.ksize = 8,
+						.vsize = 8, };
+	struct m0_be_tx         tx_data    = {};
+	struct m0_be_tx        *tx         = &tx_data;
+	struct m0_btree_op      b_op       = {};
+	struct m0_be_tx_credit  cred       = {};
+	void                   *temp_node;
+	int                     rc;
+	struct m0_fid           fid        = M0_FID_TINIT('b', 0, 1);
+	uint32_t                rnode_sz   = m0_pagesize_get();
+	uint32_t                rnode_sz_shift;
+	struct m0_buf           buf;
+
+	btree_ut_init();
+
+	M0_ASSERT(rnode_sz != 0 && m0_is_po2(rnode_sz));
+	rnode_sz_shift = __builtin_ffsl(rnode_sz) - 1;
+	cred = M0_BE_TX_CB_CREDIT(0, 0, 0);
+	m0_be_allocator_credit(NULL, M0_BAO_ALLOC_ALIGNED, rnode_sz,
+			       rnode_sz_shift, &cred);
+	m0_btree_create_credit(&btree_type, &cred, 1);
+
+	/** Prepare transaction to capture tree operations. */
+	m0_be_ut_tx_init(tx, ut_be);
+	m0_be_tx_prep(tx, &cred);
+	rc = m0_be_tx_open_sync(tx);
+	M0_ASSERT(rc == 0);
+
+	/**
+	 *  Run a invalid scenario which:
+	 *  1) Attempts to create a btree with invalid address
+	 *
+	 * This scenario is invalid because the root node address is incorrect.
+	 * In this case m0_btree_create() will return -EFAULT.
+	 */
+	rc = M0_BTREE_OP_SYNC_WITH_RC(&b_op, m0_btree_create(invalid_addr,
+				      rnode_sz, &btree_type, M0_BCT_NO_CRC,
+				      &b_op, &btree, seg, &fid, tx, NULL));
+	M0_ASSERT(rc == -EFAULT);
+	m0_be_tx_close_sync(tx);
+	m0_be_tx_fini(tx);
+
+	/**
+	 *  Run a invalid scenario which:
+	 *  1) Attempts to open a btree with invalid address
 	 *
 	 * This scenario is invalid because the root node address is incorrect.
 	 * In this case m0_btree_open() will return -EFAULT.
@@ -12422,6 +13133,497 @@ static void ut_btree_truncate(void)
 	btree_ut_fini();
 }
 
+enum {
+	UT_BATCH_NR        = 128,
+	UT_BATCH_KEYS      = 64 * UT_BATCH_NR,
+	UT_BATCH_NODE_SIZE = 1024,
+};
+
+static int ut_btree_batch_put_cb(struct m0_btree_cb  *cb,
+				 struct m0_btree_rec *rec)
+{
+	struct m0_btree_batch *batch = cb->c_datum;
+
+	M0_ASSERT(rec->r_flags == M0_BSC_SUCCESS);
+	COPY_RECORD(rec, &batch->bb_recs[batch->bb_idx]);
+	return 0;
+}
+
+static int ut_btree_batch_get_cb(struct m0_btree_cb  *cb,
+				 struct m0_btree_rec *rec)
+{
+	struct m0_btree_batch *batch = cb->c_datum;
+	struct m0_btree_rec   *src   = &batch->bb_recs[batch->bb_idx];
+	uint64_t               key;
+	uint64_t               value;
+
+	M0_ASSERT(rec->r_flags == M0_BSC_SUCCESS);
+	key   = *(uint64_t *)rec->r_key.k_data.ov_buf[0];
+	value = *(uint64_t *)rec->r_val.ov_buf[0];
+	M0_ASSERT(key == *(uint64_t *)src->r_key.k_data.ov_buf[0]);
+	M0_ASSERT(value == ~key);
+	return 0;
+}
+
+/**
+ * This unit test checks that bnode_key_raw_cmp(), used by bnode_find() for the
+ * default key ordering, orders keys exactly as m0_bufvec_cursor_cmp() does. Key
+ * pairs of lengths from 0 to 2 * 8 + 3 bytes are built from a small alphabet
+ * (including 0x00, 0x7f, 0x80 and 0xff to catch sign and byte order errors),
+ * so that common prefixes and keys that are prefixes of each other are
+ * frequent. Some pairs differ in a single byte at a random position, on either
+ * side of the 8-byte key head.
+ */
+static void ut_key_raw_cmp(void)
+{
+	enum {
+		KEY_MAX  = 2 * sizeof(uint64_t) + 3,
+		PAIRS_NR = 200000,
+	};
+	static const uint8_t    alphabet[] = { 0x00, 0x01, 0x7f, 0x80, 0xff };
+	uint8_t                 a[KEY_MAX];
+	uint8_t                 b[KEY_MAX];
+	void                   *a_ptr = a;
+	void                   *b_ptr = b;
+	m0_bcount_t             alen;
+	m0_bcount_t             blen;
+	struct m0_bufvec        a_vec = M0_BUFVEC_INIT_BUF(&a_ptr, &alen);
+	struct m0_bufvec        b_vec = M0_BUFVEC_INIT_BUF(&b_ptr, &blen);
+	struct m0_bufvec_cursor a_cur;
+	struct m0_bufvec_cursor b_cur;
+	uint64_t                seed = 42;
+	uint64_t                bhead;
+	int                     expected;
+	int                     diff;
+	int                     i;
+	int                     j;
+
+	for (i = 0; i < PAIRS_NR; i++) {
+		alen = m0_rnd64(&seed) % (KEY_MAX + 1);
+		for (j = 0; j < KEY_MAX; j++)
+			a[j] = alphabet[m0_rnd64(&seed) % ARRAY_SIZE(alphabet)];
+		memcpy(b, a, sizeof b);
+		switch (m0_rnd64(&seed) % 3) {
+		case 0:
+			/* Common prefix, possibly a prefix of the other key. */
+			blen = m0_rnd64(&seed) % (KEY_MAX + 1);
+			break;
+		case 1:
+			/* Same length, differ in one byte. */
+			blen = alen;
+			if (blen > 0)
+				b[m0_rnd64(&seed) % blen] =
+				   alphabet[m0_rnd64(&seed) %
+					    ARRAY_SIZE(alphabet)];
+			break;
+		default:
+			/* Unrelated keys. */
+			blen = m0_rnd64(&seed) % (KEY_MAX + 1);
+			for (j = 0; j < KEY_MAX; j++)
+				b[j] = alphabet[m0_rnd64(&seed) %
+						ARRAY_SIZE(alphabet)];
+			break;
+		}
+		bhead = blen >= sizeof bhead ? bnode_key_head(b) : 0;
+		m0_bufvec_cursor_init(&a_cur, &a_vec);
+		m0_bufvec_cursor_init(&b_cur, &b_vec);
+		expected = m0_bufvec_cursor_cmp(&a_cur, &b_cur);
+		diff = bnode_key_raw_cmp(a, alen, b, blen, bhead);
+		M0_ASSERT(M0_3WAY(diff, 0) == M0_3WAY(expected, 0));
+	}
+}
+
+/**
+ * Runs a batch of UT_BATCH_NR records with keys first, first + stride, ... in a
+ * transaction of its own (no transaction for M0_BO_GET).
+ */
+static int ut_btree_batch_run(struct m0_btree *tree,
+			      struct m0_btree_batch *batch,
+			      enum m0_btree_opcode opc, uint64_t flags,
+			      uint64_t first, uint64_t stride)
+{
+	struct m0_be_tx         tx_data = {};
+	struct m0_be_tx        *tx      = &tx_data;
+	struct m0_be_tx_credit  cred    = M0_BE_TX_CB_CREDIT(0, 0, 0);
+	uint64_t               *key;
+	uint64_t               *val;
+	int                     i;
+	int                     rc;
+
+	for (i = 0; i < batch->bb_nr; i++) {
+		key  = batch->bb_recs[i].r_key.k_data.ov_buf[0];
+		val  = batch->bb_recs[i].r_val.ov_buf[0];
+		*key = m0_byteorder_cpu_to_be64(first + stride * i);
+		*val = ~*key;
+	}
+	batch->bb_opc      = opc;
+	batch->bb_flags    = flags;
+	batch->bb_cb.c_act = opc == M0_BO_GET ? ut_btree_batch_get_cb :
+			     opc == M0_BO_DEL ? NULL : ut_btree_batch_put_cb;
+	if (opc == M0_BO_GET)
+		return m0_btree_batch(tree, batch, NULL);
+
+	m0_btree_batch_credit(tree, batch, &cred);
+	m0_be_ut_tx_init(tx, ut_be);
+	m0_be_tx_prep(tx, &cred);
+	rc = m0_be_tx_open_sync(tx);
+	M0_ASSERT(rc == 0);
+	rc = m0_btree_batch(tree, batch, tx);
+	m0_be_tx_close_sync(tx);
+	m0_be_tx_fini(tx);
+	return rc;
+}
+
+/**
+ * This unit test exercises m0_btree_batch() on a tree of small nodes, which
+ * grows to several levels. Even keys are put by batches of adjacent keys, so
+ * that most records go into the leaf of the previous one and some split it.
+ * Then strided batches, every one spanning the whole key range and hence many
+ * leaves and internal nodes, look up all the keys, put the odd keys, update
+ * some keys and finally delete everything, emptying and freeing the leaves.
+ */
+static void ut_btree_batch(void)
+{
+	struct m0_be_tx             tx_data    = {};
+	struct m0_be_tx            *tx         = &tx_data;
+	struct m0_be_tx_credit      cred;
+	struct m0_btree_op          b_op       = {};
+	struct m0_btree            *tree;
+	struct m0_btree             btree;
+	const struct m0_btree_type  bt         = {
+						.tt_id = M0_BT_UT_KV_OPS,
+						.ksize = sizeof(uint64_t),
+						.vsize = sizeof(uint64_t),
+					};
+	uint64_t                    keys[UT_BATCH_NR];
+	uint64_t                    values[UT_BATCH_NR];
+	void                       *k_ptr[UT_BATCH_NR];
+	void                       *v_ptr[UT_BATCH_NR];
+	m0_bcount_t                 ksize      = sizeof(uint64_t);
+	m0_bcount_t                 vsize      = sizeof(uint64_t);
+	struct m0_btree_rec         recs[UT_BATCH_NR];
+	int                         rcs[UT_BATCH_NR];
+	struct m0_btree_batch       batch      = {};
+	void                       *rnode;
+	struct m0_buf               buf;
+	uint32_t                    rnode_sz   = UT_BATCH_NODE_SIZE;
+	uint32_t                    rnode_sz_shift;
+	struct m0_fid               fid        = M0_FID_TINIT('b', 0, 1);
+	/** Number of strided batches covering UT_BATCH_KEYS keys. */
+	uint64_t                    stride     = UT_BATCH_KEYS / UT_BATCH_NR;
+	uint64_t                    b;
+	int                         i;
+	int                         rc;
+
+	M0_ENTRY();
+
+	btree_ut_init();
+
+	M0_ASSERT(rnode_sz != 0 && m0_is_po2(rnode_sz));
+	rnode_sz_shift = __builtin_ffsl(rnode_sz) - 1;
+	cred = M0_BE_TX_CB_CREDIT(0, 0, 0);
+	m0_be_allocator_credit(NULL, M0_BAO_ALLOC_ALIGNED, rnode_sz,
+			       rnode_sz_shift, &cred);
+	m0_btree_create_credit(&bt, &cred, 1);
+
+	m0_be_ut_tx_init(tx, ut_be);
+	m0_be_tx_prep(tx, &cred);
+	rc = m0_be_tx_open_sync(tx);
+	M0_ASSERT(rc == 0);
+	buf = M0_BUF_INIT(rnode_sz, NULL);
+	M0_BE_ALLOC_ALIGN_BUF_SYNC(&buf, rnode_sz_shift, seg, tx);
+	rnode = buf.b_addr;
+	rc = M0_BTREE_OP_SYNC_WITH_RC(&b_op, m0_btree_create(rnode, rnode_sz,
+							     &bt,
+							     M0_BCT_NO_CRC,
+							     &b_op, &btree, seg,
+							     &fid, tx, NULL));
+	M0_ASSERT(rc == M0_BSC_SUCCESS);
+	m0_be_tx_close_sync(tx);
+	m0_be_tx_fini(tx);
+	tree = b_op.bo_arbor;
+
+	for (i = 0; i < ARRAY_SIZE(recs); i++) {
+		k_ptr[i]  = &keys[i];
+		v_ptr[i]  = &values[i];
+		REC_INIT_WITH_CRC(&recs[i], &k_ptr[i], &ksize, &v_ptr[i],
+				  &vsize, M0_BCT_NO_CRC);
+	}
+	batch.bb_recs        = recs;
+	batch.bb_nr          = ARRAY_SIZE(recs);
+	batch.bb_cb.c_datum  = &batch;
+	batch.bb_rc          = rcs;
+
+	/** Put the even keys, every batch covers adjacent keys. */
+	for (b = 0; b < UT_BATCH_KEYS; b += 2 * UT_BATCH_NR) {
+		rc = ut_btree_batch_run(tree, &batch, M0_BO_PUT, 0, b, 2);
+		M0_ASSERT(rc == 0);
+		for (i = 0; i < ARRAY_SIZE(recs); i++)
+			M0_ASSERT(rcs[i] == 0);
+	}
+	M0_ASSERT(tree->t_height >= 3);
+
+	/** Look up all the keys, the odd ones are missing. */
+	for (b = 0; b < stride; b++) {
+		rc = ut_btree_batch_run(tree, &batch, M0_BO_GET, 0, b, stride);
+		M0_ASSERT(rc == 0);
+		for (i = 0; i < ARRAY_SIZE(recs); i++)
+			M0_ASSERT(rcs[i] == ((b + stride * i) % 2 == 0 ?
+					     0 : -ENOENT));
+	}
+
+	/** Put the odd keys and put the even keys again. */
+	for (b = 1; b < stride; b += 2) {
+		rc = ut_btree_batch_run(tree, &batch, M0_BO_PUT, 0, b, stride);
+		M0_ASSERT(rc == 0);
+		for (i = 0; i < ARRAY_SIZE(recs); i++)
+			M0_ASSERT(rcs[i] == 0);
+	}
+	rc = ut_btree_batch_run(tree, &batch, M0_BO_PUT, 0, 0, stride);
+	M0_ASSERT(rc == 0);
+	for (i = 0; i < ARRAY_SIZE(recs); i++)
+		M0_ASSERT(rcs[i] == -EEXIST);
+
+	/**
+	 * Update present keys and keys beyond the range, inserting the latter
+	 * ones with BOF_INSERT_IF_NOT_FOUND only.
+	 */
+	rc = ut_btree_batch_run(tree, &batch, M0_BO_UPDATE, 0, 0, stride);
+	M0_ASSERT(rc == 0);
+	for (i = 0; i < ARRAY_SIZE(recs); i++)
+		M0_ASSERT(rcs[i] == 0);
+	rc = ut_btree_batch_run(tree, &batch, M0_BO_UPDATE, 0,
+				UT_BATCH_KEYS, 1);
+	M0_ASSERT(rc == 0);
+	for (i = 0; i < ARRAY_SIZE(recs); i++)
+		M0_ASSERT(rcs[i] == -ENOENT);
+	rc = ut_btree_batch_run(tree, &batch, M0_BO_UPDATE,
+				BOF_INSERT_IF_NOT_FOUND, UT_BATCH_KEYS, 1);
+	M0_ASSERT(rc == 0);
+	for (i = 0; i < ARRAY_SIZE(recs); i++)
+		M0_ASSERT(rcs[i] == 0);
+
+	/** All the keys are present now. */
+	for (b = 0; b < stride; b++) {
+		rc = ut_btree_batch_run(tree, &batch, M0_BO_GET, 0, b, stride);
+		M0_ASSERT(rc == 0);
+		for (i = 0; i < ARRAY_SIZE(recs); i++)
+			M0_ASSERT(rcs[i] == 0);
+	}
+	rc = ut_btree_batch_run(tree, &batch, M0_BO_GET, 0, UT_BATCH_KEYS, 1);
+	M0_ASSERT(rc == 0);
+	for (i = 0; i < ARRAY_SIZE(recs); i++)
+		M0_ASSERT(rcs[i] == 0);
+
+	/** Delete everything by strided batches, leaves get emptied. */
+	for (b = 0; b < stride; b++) {
+		rc = ut_btree_batch_run(tree, &batch, M0_BO_DEL, 0, b, stride);
+		M0_ASSERT(rc == 0);
+		for (i = 0; i < ARRAY_SIZE(recs); i++)
+			M0_ASSERT(rcs[i] == 0);
+	}
+	rc = ut_btree_batch_run(tree, &batch, M0_BO_DEL, 0, UT_BATCH_KEYS, 1);
+	M0_ASSERT(rc == 0);
+	for (i = 0; i < ARRAY_SIZE(recs); i++)
+		M0_ASSERT(rcs[i] == 0);
+	M0_ASSERT(m0_btree_is_empty(tree));
+	rc = ut_btree_batch_run(tree, &batch, M0_BO_DEL, 0, 0, stride);
+	M0_ASSERT(rc == 0);
+	for (i = 0; i < ARRAY_SIZE(recs); i++)
+		M0_ASSERT(rcs[i] == -ENOENT);
+
+	cred = M0_BE_TX_CREDIT(0, 0);
+	m0_be_allocator_credit(NULL, M0_BAO_FREE_ALIGNED, rnode_sz,
+			       rnode_sz_shift, &cred);
+	m0_btree_destroy_credit(tree, NULL, &cred, 1);
+	m0_be_ut_tx_init(tx, ut_be);
+	m0_be_tx_prep(tx, &cred);
+	rc = m0_be_tx_open_sync(tx);
+	M0_ASSERT(rc == 0);
+	rc = M0_BTREE_OP_SYNC_WITH_RC(&b_op, m0_btree_destroy(tree, &b_op, tx));
+	M0_ASSERT(rc == 0);
+	M0_SET0(&btree);
+	buf = M0_BUF_INIT(rnode_sz, rnode);
+	M0_BE_FREE_ALIGN_BUF_SYNC(&buf, rnode_sz_shift, seg, tx);
+	m0_be_tx_close_sync(tx);
+	m0_be_tx_fini(tx);
+
+	btree_ut_fini();
+	M0_LEAVE();
+}
+
+enum {
+	UT_APPEND_NR    = 4096,
+	UT_APPEND_CHUNK = 128,
+};
+
+/**
+ * Loads UT_APPEND_NR records with ascending keys into a new tree, one
+ * transaction per UT_APPEND_CHUNK records, checks that all of them can be found
+ * and returns the number of leaves the tree ended up with.
+ */
+static int ut_btree_append_load(uint64_t flags)
+{
+	struct m0_be_tx             tx_data    = {};
+	struct m0_be_tx            *tx         = &tx_data;
+	struct m0_be_tx_credit      cred;
+	struct m0_btree_op          b_op       = {};
+	struct m0_btree_op          kv_op      = {};
+	struct m0_btree            *tree;
+	struct m0_btree             btree;
+	const struct m0_btree_type  bt         = {
+						.tt_id = M0_BT_UT_KV_OPS,
+						.ksize = sizeof(uint64_t),
+						.vsize = sizeof(uint64_t),
+					};
+	uint64_t                    keys[UT_APPEND_CHUNK];
+	uint64_t                    values[UT_APPEND_CHUNK];
+	void                       *k_ptr[UT_APPEND_CHUNK];
+	void                       *v_ptr[UT_APPEND_CHUNK];
+	m0_bcount_t                 ksize      = sizeof(uint64_t);
+	m0_bcount_t                 vsize      = sizeof(uint64_t);
+	struct m0_btree_rec         recs[UT_APPEND_CHUNK];
+	int                         rcs[UT_APPEND_CHUNK];
+	struct m0_btree_batch       batch      = {};
+	void                       *rnode;
+	struct m0_buf               buf;
+	uint32_t                    rnode_sz   = m0_pagesize_get();
+	uint32_t                    rnode_sz_shift;
+	struct m0_fid               fid        = M0_FID_TINIT('b', 0, 1);
+	m0_bcount_t                 limit;
+	int                         leaves;
+	int                         i;
+	int                         j;
+	int                         rc;
+
+	M0_ASSERT(rnode_sz != 0 && m0_is_po2(rnode_sz));
+	rnode_sz_shift = __builtin_ffsl(rnode_sz) - 1;
+	cred = M0_BE_TX_CB_CREDIT(0, 0, 0);
+	m0_be_allocator_credit(NULL, M0_BAO_ALLOC_ALIGNED, rnode_sz,
+			       rnode_sz_shift, &cred);
+	m0_btree_create_credit(&bt, &cred, 1);
+
+	m0_be_ut_tx_init(tx, ut_be);
+	m0_be_tx_prep(tx, &cred);
+	rc = m0_be_tx_open_sync(tx);
+	M0_ASSERT(rc == 0);
+	buf = M0_BUF_INIT(rnode_sz, NULL);
+	M0_BE_ALLOC_ALIGN_BUF_SYNC(&buf, rnode_sz_shift, seg, tx);
+	rnode = buf.b_addr;
+	rc = M0_BTREE_OP_SYNC_WITH_RC(&b_op, m0_btree_create(rnode, rnode_sz,
+							     &bt,
+							     M0_BCT_NO_CRC,
+							     &b_op, &btree, seg,
+							     &fid, tx, NULL));
+	M0_ASSERT(rc == M0_BSC_SUCCESS);
+	m0_be_tx_close_sync(tx);
+	m0_be_tx_fini(tx);
+	tree = b_op.bo_arbor;
+
+	for (i = 0; i < ARRAY_SIZE(recs); i++) {
+		k_ptr[i]  = &keys[i];
+		v_ptr[i]  = &values[i];
+		REC_INIT_WITH_CRC(&recs[i], &k_ptr[i], &ksize, &v_ptr[i],
+				  &vsize, M0_BCT_NO_CRC);
+	}
+	batch.bb_recs        = recs;
+	batch.bb_nr          = ARRAY_SIZE(recs);
+	batch.bb_cb.c_datum  = &batch;
+	batch.bb_rc          = rcs;
+
+	for (i = 0; i < UT_APPEND_NR; i += UT_APPEND_CHUNK) {
+		for (j = 0; j < ARRAY_SIZE(recs); j++) {
+			keys[j]   = m0_byteorder_cpu_to_be64(i + j);
+			values[j] = ~keys[j];
+		}
+		batch.bb_opc         = M0_BO_PUT;
+		batch.bb_flags       = flags;
+		batch.bb_cb.c_act    = ut_btree_batch_put_cb;
+
+		cred = M0_BE_TX_CB_CREDIT(0, 0, 0);
+		m0_btree_batch_credit(tree, &batch, &cred);
+		m0_be_ut_tx_init(tx, ut_be);
+		m0_be_tx_prep(tx, &cred);
+		rc = m0_be_tx_open_sync(tx);
+		M0_ASSERT(rc == 0);
+		rc = m0_btree_batch(tree, &batch, tx);
+		M0_ASSERT(rc == 0);
+		m0_be_tx_close_sync(tx);
+		m0_be_tx_fini(tx);
+	}
+
+	for (i = 0; i < UT_APPEND_NR; i += UT_APPEND_CHUNK) {
+		for (j = 0; j < ARRAY_SIZE(recs); j++)
+			keys[j] = m0_byteorder_cpu_to_be64(i + j);
+		batch.bb_opc         = M0_BO_GET;
+		batch.bb_flags       = 0;
+		batch.bb_cb.c_act    = ut_btree_batch_get_cb;
+		rc = m0_btree_batch(tree, &batch, NULL);
+		M0_ASSERT(rc == 0);
+		for (j = 0; j < ARRAY_SIZE(recs); j++)
+			M0_ASSERT(rcs[j] == 0);
+	}
+
+	/** All the leaves hang off the root, which is the only internal node. */
+	M0_ASSERT(tree->t_height == 2);
+	leaves = bnode_rec_count(tree->t_desc->t_root);
+
+	while (!m0_btree_is_empty(tree)) {
+		cred = M0_BE_TX_CREDIT(0, 0);
+		m0_btree_truncate_credit(tx, tree, &cred, &limit);
+		m0_be_ut_tx_init(tx, ut_be);
+		m0_be_tx_prep(tx, &cred);
+		rc = m0_be_tx_open_sync(tx);
+		M0_ASSERT(rc == 0);
+		rc = M0_BTREE_OP_SYNC_WITH_RC(&kv_op,
+					      m0_btree_truncate(tree, limit, tx,
+								&kv_op));
+		M0_ASSERT(rc == 0);
+		m0_be_tx_close_sync(tx);
+		m0_be_tx_fini(tx);
+	}
+
+	cred = M0_BE_TX_CREDIT(0, 0);
+	m0_be_allocator_credit(NULL, M0_BAO_FREE_ALIGNED, rnode_sz,
+			       rnode_sz_shift, &cred);
+	m0_btree_destroy_credit(tree, NULL, &cred, 1);
+	m0_be_ut_tx_init(tx, ut_be);
+	m0_be_tx_prep(tx, &cred);
+	rc = m0_be_tx_open_sync(tx);
+	M0_ASSERT(rc == 0);
+	rc = M0_BTREE_OP_SYNC_WITH_RC(&b_op, m0_btree_destroy(tree, &b_op, tx));
+	M0_ASSERT(rc == 0);
+	M0_SET0(&btree);
+	buf = M0_BUF_INIT(rnode_sz, rnode);
+	M0_BE_FREE_ALIGN_BUF_SYNC(&buf, rnode_sz_shift, seg, tx);
+	m0_be_tx_close_sync(tx);
+	m0_be_tx_fini(tx);
+
+	return leaves;
+}
+
+/**
+ * This unit test loads the same sorted stream of records with and without
+ * BOF_APPEND. Regular splits leave half-full leaves behind, while the append
+ * load has to pack them, needing substantially fewer leaves.
+ */
+static void ut_btree_append(void)
+{
+	int plain;
+	int packed;
+
+	M0_ENTRY();
+
+	btree_ut_init();
+	plain  = ut_btree_append_load(0);
+	packed = ut_btree_append_load(BOF_APPEND);
+	M0_LOG(M0_INFO, "leaves: plain=%d packed=%d", plain, packed);
+	M0_ASSERT(packed * 3 < plain * 2);
+	btree_ut_fini();
+
+	M0_LEAVE();
+}
+
 static void ut_lru_test(void)
 {
 	void                       *rnode;
@@ -13582,6 +14784,220 @@ static int ut_btree_suite_fini(void)
 	return 0;
 }
 
+/**
+ *  ------------------------------
+ *  Section START - Unit Benchmark
+ *  ------------------------------
+ */
+
+/**
+ * Point lookup benchmark. A tree of every supported node format is filled with
+ * BTREE_UB_RECS records and then probed with m0_btree_get() in a pseudo-random
+ * order. Per node type results are reported by m0ub as lookups/sec.
+ *
+ * Keys are 2 words long so that bnode_find() exercises both the key head and
+ * the tie-breaking part of the key comparison.
+ */
+enum {
+	BTREE_UB_RECS        = 50000,
+	BTREE_UB_RECS_PER_TX = 16,
+	BTREE_UB_KSIZE       = 2 * sizeof(uint64_t),
+	BTREE_UB_VSIZE       = 2 * sizeof(uint64_t),
+	BTREE_UB_ITER        = 200000,
+	/** Prime, co-prime with BTREE_UB_RECS, used to scatter lookups. */
+	BTREE_UB_STRIDE      = 7919,
+};
+
+static struct m0_btree *btree_ub_trees[BNT_VARIABLE_KEYSIZE_VARIABLE_VALUESIZE
+				       + 1];
+static struct m0_btree  btree_ub_btrees[BNT_VARIABLE_KEYSIZE_VARIABLE_VALUESIZE
+					+ 1];
+
+static int btree_ub_get_cb(struct m0_btree_cb *cb, struct m0_btree_rec *rec)
+{
+	M0_ASSERT(rec->r_flags == M0_BSC_SUCCESS);
+	return 0;
+}
+
+static void btree_ub_tree_fill(enum btree_node_type bnt)
+{
+	struct m0_btree_type    btree_type = {
+		.tt_id = M0_BT_UT_KV_OPS,
+		.ksize = bnt == BNT_VARIABLE_KEYSIZE_VARIABLE_VALUESIZE ?
+			 -1 : BTREE_UB_KSIZE,
+		.vsize = bnt == BNT_FIXED_FORMAT ? BTREE_UB_VSIZE : -1,
+	};
+	struct m0_be_tx         tx_data    = {};
+	struct m0_be_tx        *tx         = &tx_data;
+	struct m0_be_tx_credit  cred;
+	struct m0_btree_op      b_op       = {};
+	struct m0_btree_op      kv_op      = {};
+	struct m0_btree_cb      ut_cb;
+	struct ut_cb_data       put_data;
+	struct m0_btree_rec     rec;
+	struct m0_fid           fid        = M0_FID_TINIT('b', 0, bnt);
+	struct m0_buf           buf;
+	uint64_t                key[BTREE_UB_KSIZE / sizeof(uint64_t)];
+	uint64_t                value[BTREE_UB_VSIZE / sizeof(uint64_t)];
+	void                   *k_ptr      = &key;
+	void                   *v_ptr      = &value;
+	m0_bcount_t             ksize      = sizeof key;
+	m0_bcount_t             vsize      = sizeof value;
+	uint32_t                rnode_sz   = m0_pagesize_get();
+	uint32_t                rnode_sz_shift;
+	uint64_t                i;
+	int                     rc;
+
+	M0_ASSERT(rnode_sz != 0 && m0_is_po2(rnode_sz));
+	rnode_sz_shift = __builtin_ffsl(rnode_sz) - 1;
+	cred = M0_BE_TX_CB_CREDIT(0, 0, 0);
+	m0_be_allocator_credit(NULL, M0_BAO_ALLOC_ALIGNED, rnode_sz,
+			       rnode_sz_shift, &cred);
+	m0_btree_create_credit(&btree_type, &cred, 1);
+
+	m0_be_ut_tx_init(tx, ut_be);
+	m0_be_tx_prep(tx, &cred);
+	rc = m0_be_tx_open_sync(tx);
+	M0_ASSERT(rc == 0);
+	buf = M0_BUF_INIT(rnode_sz, NULL);
+	M0_BE_ALLOC_ALIGN_BUF_SYNC(&buf, rnode_sz_shift, seg, tx);
+	rc = M0_BTREE_OP_SYNC_WITH_RC(&b_op,
+				      m0_btree_create(buf.b_addr, rnode_sz,
+						      &btree_type,
+						      M0_BCT_NO_CRC, &b_op,
+						      &btree_ub_btrees[bnt],
+						      seg, &fid, tx, NULL));
+	M0_ASSERT(rc == M0_BSC_SUCCESS);
+	m0_be_tx_close_sync(tx);
+	m0_be_tx_fini(tx);
+	btree_ub_trees[bnt] = b_op.bo_arbor;
+
+	cred = M0_BE_TX_CB_CREDIT(0, 0, 0);
+	m0_btree_put_credit(btree_ub_trees[bnt], BTREE_UB_RECS_PER_TX,
+			    ksize, vsize, &cred);
+
+	REC_INIT_WITH_CRC(&rec, &k_ptr, &ksize, &v_ptr, &vsize, M0_BCT_NO_CRC);
+	put_data.key   = &rec.r_key;
+	put_data.value = &rec.r_val;
+	ut_cb.c_act    = ut_btree_kv_put_cb;
+	ut_cb.c_datum  = &put_data;
+
+	for (i = 0; i < BTREE_UB_RECS; i++) {
+		if (i % BTREE_UB_RECS_PER_TX == 0) {
+			m0_be_ut_tx_init(tx, ut_be);
+			m0_be_tx_prep(tx, &cred);
+			rc = m0_be_tx_open_sync(tx);
+			M0_ASSERT(rc == 0);
+		}
+		key[0] = key[1] = m0_byteorder_cpu_to_be64(i);
+		value[0] = value[1] = key[0];
+		rc = M0_BTREE_OP_SYNC_WITH_RC(&kv_op,
+					      m0_btree_put(btree_ub_trees[bnt],
+							   &rec, &ut_cb,
+							   &kv_op, tx));
+		M0_ASSERT(rc == 0 && put_data.flags == M0_BSC_SUCCESS);
+		if ((i + 1) % BTREE_UB_RECS_PER_TX == 0 ||
+		    i + 1 == BTREE_UB_RECS) {
+			m0_be_tx_close_sync(tx);
+			m0_be_tx_fini(tx);
+		}
+	}
+}
+
+static void btree_ub_get(enum btree_node_type bnt, int iter)
+{
+	uint64_t            key[BTREE_UB_KSIZE / sizeof(uint64_t)];
+	void               *k_ptr = &key;
+	m0_bcount_t         ksize = sizeof key;
+	struct m0_btree_key find_key;
+	struct m0_btree_cb  ub_cb = { .c_act = btree_ub_get_cb };
+	struct m0_btree_op  kv_op = {};
+	uint64_t            n;
+	int                 rc;
+
+	n = ((uint64_t)iter * BTREE_UB_STRIDE) % BTREE_UB_RECS;
+	key[0] = key[1] = m0_byteorder_cpu_to_be64(n);
+	find_key.k_data = M0_BUFVEC_INIT_BUF(&k_ptr, &ksize);
+	rc = M0_BTREE_OP_SYNC_WITH_RC(&kv_op,
+				      m0_btree_get(btree_ub_trees[bnt],
+						   &find_key, &ub_cb,
+						   BOF_EQUAL, &kv_op));
+	M0_ASSERT(rc == 0);
+}
+
+static void btree_ub_get_ff(int iter)
+{
+	btree_ub_get(BNT_FIXED_FORMAT, iter);
+}
+
+static void btree_ub_get_fkvv(int iter)
+{
+	btree_ub_get(BNT_FIXED_KEYSIZE_VARIABLE_VALUESIZE, iter);
+}
+
+static void btree_ub_get_vkvv(int iter)
+{
+	btree_ub_get(BNT_VARIABLE_KEYSIZE_VARIABLE_VALUESIZE, iter);
+}
+
+static int btree_ub_init(const char *opts M0_UNUSED)
+{
+	int rc = ut_btree_suite_init();
+
+	M0_ASSERT(rc == 0);
+	btree_ub_tree_fill(BNT_FIXED_FORMAT);
+	btree_ub_tree_fill(BNT_FIXED_KEYSIZE_VARIABLE_VALUESIZE);
+	btree_ub_tree_fill(BNT_VARIABLE_KEYSIZE_VARIABLE_VALUESIZE);
+	return 0;
+}
+
+static void btree_ub_fini(void)
+{
+	struct m0_btree_op b_op = {};
+	int                i;
+
+	/**
+	 * Trees are only closed; the segment is thrown away together with the
+	 * backend by ut_btree_suite_fini().
+	 */
+	for (i = 0; i < ARRAY_SIZE(btree_ub_trees); i++) {
+		if (btree_ub_trees[i] != NULL)
+			M0_BTREE_OP_SYNC_WITH_RC(&b_op,
+						 m0_btree_close(
+							 btree_ub_trees[i],
+							 &b_op));
+		btree_ub_trees[i] = NULL;
+	}
+	ut_btree_suite_fini();
+}
+
+struct m0_ub_set m0_btree_ub = {
+	.us_name = "btree-ub",
+	.us_init = btree_ub_init,
+	.us_fini = btree_ub_fini,
+	.us_run  = {
+		{ .ub_name  = "get-ff",
+		  .ub_iter  = BTREE_UB_ITER,
+		  .ub_round = btree_ub_get_ff },
+
+		{ .ub_name  = "get-fkvv",
+		  .ub_iter  = BTREE_UB_ITER,
+		  .ub_round = btree_ub_get_fkvv },
+
+		{ .ub_name  = "get-vkvv",
+		  .ub_iter  = BTREE_UB_ITER,
+		  .ub_round = btree_ub_get_vkvv },
+
+		{ .ub_name = NULL }
+	}
+};
+
+/**
+ *  ----------------------------
+ *  Section END - Unit Benchmark
+ *  ----------------------------
+ */
+
 struct m0_ut_suite btree_ut = {
 	.ts_name = "btree-ut",
 	.ts_yaml_config_string = "{ valgrind: { timeout: 3600 },"
@@ -13603,6 +15019,9 @@ struct m0_ut_suite btree_ut = {
 		{"multi_thread_tree_op",            ut_mt_tree_oper},
 		{"btree_persistence",               ut_btree_persistence},
 		{"btree_truncate",                  ut_btree_truncate},
+		{"key_raw_cmp",                     ut_key_raw_cmp},
+		{"btree_batch",                     ut_btree_batch},
+		{"btree_append",                    ut_btree_append},
 		{"btree_crc_test",                  ut_btree_crc_test},
 		{"btree_crc_persist_test",          ut_btree_crc_persist_test},
 		{"btree_mtree_mthreads_test",       ut_mtree_mthread_test},
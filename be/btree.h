@@ -182,6 +182,13 @@ enum m0_btree_op_flags {
 	BOF_EQUAL                   = M0_BITS(4),
 	BOF_SLANT                   = M0_BITS(5),
 	BOF_INSERT_IF_NOT_FOUND     = M0_BITS(6),
+	/**
+	 * PUT hint: records are inserted in ascending key order, each after
+	 * all the keys already in the tree. A node overflowing on its right
+	 * edge keeps only the minimal number of records, so the nodes left
+	 * behind stay fully packed instead of half full.
+	 */
+	BOF_APPEND                  = M0_BITS(7),
 };
 
 /**
@@ -207,6 +214,39 @@ enum m0_btree_purge_user{
 	M0_PU_EXTERNAL,
 };
 
+/**
+ * Vector of records processed by m0_btree_batch().
+ *
+ * Records in bb_recs[] must be sorted in ascending key order (according to the
+ * key comparison used by the tree) and must not contain duplicate keys.
+ */
+struct m0_btree_batch {
+	/** M0_BO_GET, M0_BO_PUT, M0_BO_UPDATE or M0_BO_DEL. */
+	enum m0_btree_opcode  bb_opc;
+	/** Records (keys only for GET and DEL) to process. */
+	struct m0_btree_rec  *bb_recs;
+	/** Number of records in bb_recs[]. */
+	uint32_t              bb_nr;
+	/**
+	 * Callback called for every record, exactly as it is called by the
+	 * single record operation. bb_idx tells which record is processed.
+	 */
+	struct m0_btree_cb    bb_cb;
+	/**
+	 * Flags for M0_BO_UPDATE, see m0_btree_update(). For M0_BO_PUT only
+	 * BOF_APPEND is accepted: it bulk-loads records whose keys are all
+	 * greater than the keys already present in the tree.
+	 */
+	uint64_t              bb_flags;
+	/** Index of the record in bb_recs[] being processed. */
+	uint32_t              bb_idx;
+	/**
+	 * Optional array of bb_nr elements, filled with per record result: 0 or
+	 * negative error code (e.g. -ENOENT for a missing key).
+	 */
+	int                  *bb_rc;
+};
+
 /** Btree fid type */
 M0_EXTERN const struct m0_fid_type m0_btree_fid_type;
 
@@ -726,6 +766,52 @@ M0_INTERNAL void m0_btree_del_credit2(const struct m0_btree_type *type,
 				      m0_bcount_t                 vsize,
 				      struct m0_be_tx_credit     *accum);
 
+/**
+ * Calculates credits required to execute the batch by m0_btree_batch() in a
+ * single transaction and adds them to accum. Credit is calculated once for the
+ * whole batch, using the largest key and value present in it.
+ *
+ * Nothing is added for M0_BO_GET batches.
+ */
+M0_INTERNAL void m0_btree_batch_credit(const struct m0_btree       *tree,
+				       const struct m0_btree_batch *batch,
+				       struct m0_be_tx_credit      *accum);
+
+/**
+ * Executes the same operation on a sorted vector of records.
+ *
+ * For M0_BO_GET the tree is swept once: the path from the root to the leaf
+ * holding the previous key is kept, and the descent for the next key starts
+ * from the lowest node of this path whose sub-tree still covers the key. The
+ * batch is executed under a single acquisition of the tree lock. The callback
+ * is called for every key found; missing keys are reported through bb_rc[].
+ *
+ * Modifying batches sweep the tree in the same way, under the tree lock taken
+ * for writing. A record which fits into its leaf (or, for M0_BO_DEL, does not
+ * leave a non-root leaf empty) is applied to the leaf in place, and the leaf is
+ * captured once for all the records applied to it. A record which needs a
+ * split or a merge is executed by the single record operation, after which the
+ * sweep restarts from the root. Modifying batches are executed within the given
+ * transaction, which has to be prepared with m0_btree_batch_credit().
+ *
+ * A tree can be bulk-loaded from a sorted stream of records by splitting the
+ * stream into M0_BO_PUT batches with BOF_APPEND set and running them in
+ * consecutive transactions, e.g. from m0_be_tx_bulk work function. Leaves and
+ * internal nodes are then filled to capacity while the tree grows on its
+ * right edge.
+ *
+ * This is a synchronous call.
+ *
+ * @return 0 if all the records were processed, otherwise the error returned by
+ *         the first failed callback or, for the modifying operations, by the
+ *         first failed record operation. If bb_rc[] is given, -EEXIST and
+ *         -ENOENT of a modifying record are only reported there and the batch
+ *         goes on.
+ */
+M0_INTERNAL int m0_btree_batch(struct m0_btree       *arbor,
+			       struct m0_btree_batch *batch,
+			       struct m0_be_tx       *tx);
+
 #include "be/btree_internal.h"
 
 M0_INTERNAL int     m0_btree_mod_init(void);
@@ -662,6 +662,24 @@ M0_INTERNAL void m0_be_domain__0type_unregister(struct m0_be_domain *dom,
 
 static const struct m0_modlev levels_be_domain[];
 
+/**
+ * Fills recovery parameters which are not set by the user.
+ *
+ * Groups are idle until recovery is done, so all of them are used for it by
+ * default, and each of them may have a log record read in flight.
+ */
+static void be_domain_recovery_cfg_default(struct m0_be_domain_cfg *cfg)
+{
+	struct m0_be_engine_cfg   *en_cfg = &cfg->bc_engine;
+	struct m0_be_io_sched_cfg *io_cfg =
+				&cfg->bc_log.lc_sched_cfg.lsch_io_sched_cfg;
+
+	if (en_cfg->bec_recovery_group_nr == 0)
+		en_cfg->bec_recovery_group_nr = en_cfg->bec_group_nr;
+	if (io_cfg->bisc_read_nr_max == 0)
+		io_cfg->bisc_read_nr_max = en_cfg->bec_recovery_group_nr;
+}
+
 static int be_domain_level_enter(struct m0_module *module)
 {
 	struct m0_be_domain     *dom = M0_AMB(dom, module, bd_module);
@@ -751,6 +769,7 @@ static int be_domain_level_enter(struct m0_module *module)
 	case M0_BE_DOMAIN_LEVEL_NORMAL_LOG_OPEN:
 		if (cfg->bc_mkfs_mode)
 			return M0_RC(0);
+		be_domain_recovery_cfg_default(cfg);
 		return M0_RC(m0_be_log_open(m0_be_domain_log(dom),
 		                            &cfg->bc_log));
 	case M0_BE_DOMAIN_LEVEL_PD_INIT:
@@ -28,6 +28,7 @@
 #include "lib/memory.h"         /* m0_free */
 #include "lib/errno.h"          /* ENOMEM */
 #include "lib/misc.h"           /* m0_forall */
+#include "lib/arith.h"          /* min_check */
 #include "lib/time.h"           /* m0_time_now */
 
 #include "be/tx_service.h"      /* m0_be_tx_service_init */
@@ -751,6 +752,97 @@ M0_INTERNAL void m0_be_engine__tx_group_ready(struct m0_be_engine   *en,
 	M0_LEAVE();
 }
 
+/*
+ * Groups are recovered concurrently, but m0_be_tx_group_reapply() of a group
+ * must not run before m0_be_tx_group_reapply() of any group that is recovered
+ * from an earlier log record and has intersecting regions (see EOS-7888 for
+ * what happens otherwise). Regions of a group are not known until the group
+ * is reconstructed, so such group is treated as intersecting with everything.
+ *
+ * Segment I/O (placing) is ordered by m0_be_pd I/O scheduler according to the
+ * log position of the group, so it doesn't need to be handled here.
+ */
+static bool be_engine_group_may_reapply(struct m0_be_engine   *en,
+					struct m0_be_tx_group *gr)
+{
+	struct m0_be_tx_group *other;
+	size_t                 i;
+
+	M0_PRE(be_engine_is_locked(en));
+	M0_PRE(m0_be_tx_group_is_recovering(gr) && gr->tg_reconstructed);
+
+	for (i = 0; i < en->eng_group_nr; ++i) {
+		other = &en->eng_group[i];
+		if (other == gr || !m0_be_tx_group_is_recovering(other) ||
+		    other->tg_reapplied ||
+		    other->tg_recovery_pos > gr->tg_recovery_pos)
+			continue;
+		if (!other->tg_reconstructed ||
+		    m0_be_reg_area_intersects(&other->tg_reg_area,
+					      &gr->tg_reg_area))
+			return false;
+	}
+	return true;
+}
+
+static void be_engine_group_reapply_wakeup(struct m0_be_engine *en)
+{
+	struct m0_be_tx_group *gr;
+	struct m0_be_op       *op;
+	size_t                 i;
+
+	M0_PRE(be_engine_is_locked(en));
+
+	for (i = 0; i < en->eng_group_nr; ++i) {
+		gr = &en->eng_group[i];
+		if (gr->tg_reapply_op != NULL &&
+		    be_engine_group_may_reapply(en, gr)) {
+			op = gr->tg_reapply_op;
+			gr->tg_reapply_op = NULL;
+			m0_be_op_done(op);
+		}
+	}
+}
+
+M0_INTERNAL void
+m0_be_engine__tx_group_reconstructed(struct m0_be_engine   *en,
+				     struct m0_be_tx_group *gr)
+{
+	be_engine_lock(en);
+	gr->tg_reconstructed = true;
+	be_engine_group_reapply_wakeup(en);
+	be_engine_unlock(en);
+}
+
+M0_INTERNAL void
+m0_be_engine__tx_group_reapply_wait(struct m0_be_engine   *en,
+				    struct m0_be_tx_group *gr,
+				    struct m0_be_op       *op)
+{
+	m0_be_op_active(op);
+	be_engine_lock(en);
+	M0_PRE(gr->tg_reapply_op == NULL);
+	if (be_engine_group_may_reapply(en, gr)) {
+		m0_be_op_done(op);
+	} else {
+		M0_LOG(M0_DEBUG, "gr=%p pos=%"PRIu64" waits for reapply",
+		       gr, gr->tg_recovery_pos);
+		gr->tg_reapply_op = op;
+	}
+	be_engine_unlock(en);
+}
+
+M0_INTERNAL void m0_be_engine__tx_group_reapplied(struct m0_be_engine   *en,
+						  struct m0_be_tx_group *gr)
+{
+	be_engine_lock(en);
+	gr->tg_reapplied = true;
+	if (en->eng_cfg->bec_group_reapplied_cb != NULL)
+		en->eng_cfg->bec_group_reapplied_cb(gr);
+	be_engine_group_reapply_wakeup(en);
+	be_engine_unlock(en);
+}
+
 static void be_engine_group_stop_nr(struct m0_be_engine *en, size_t nr)
 {
 	size_t i;
@@ -792,6 +884,7 @@ static int be_engine_group_start(struct m0_be_engine *en, size_t index)
 M0_INTERNAL int m0_be_engine_start(struct m0_be_engine *en)
 {
 	m0_time_t recovery_time = 0;
+	size_t    recovery_group_nr;
 	int       rc = 0;
 	size_t    i;
 
@@ -800,19 +893,22 @@ M0_INTERNAL int m0_be_engine_start(struct m0_be_engine *en)
 	M0_PRE(be_engine_invariant(en));
 
 	/*
-	 * Run BE recovery having only one group.
-	 * This prevents having m0_be_tx_group_reapply() called in wrong order,
-	 * i.e. not in the same order as corresponding log records in the log.
-	 * See EOS-7888 and linked tickets for an example of what happens if
-	 * the order of m0_be_tx_group_reapply() is wrong.
-	 *
-	 * An alternative solution would be to enforce the right order for
-	 * m0_be_tx_group_reapply(), but with group rewrite this solution
-	 * wouldn't be needed anymore. One group for recovery is just easier.
+	 * Run BE recovery with bec_recovery_group_nr groups. Log records are
+	 * given to the groups in the log order, log reads and decoding are
+	 * done by the groups concurrently. The order of
+	 * m0_be_tx_group_reapply() is enforced by be_engine_group_may_reapply().
 	 */
-	rc = be_engine_group_start(en, 0);
-	if (rc != 0)
-		return M0_ERR(rc);
+	recovery_group_nr = min_check(max_check(
+				en->eng_cfg->bec_recovery_group_nr,
+				(size_t)1), en->eng_group_nr);
+	for (i = 0; i < recovery_group_nr; ++i) {
+		rc = be_engine_group_start(en, i);
+		if (rc != 0) {
+			be_engine_group_stop_nr(en, i);
+			be_engine_unlock(en);
+			return M0_ERR(rc);
+		}
+	}
 
 	recovery_time = m0_time_now();
 	be_engine_try_recovery(en);
@@ -833,7 +929,7 @@ M0_INTERNAL int m0_be_engine_start(struct m0_be_engine *en)
 		/* XXX workaround END */
 	}
 	be_engine_lock(en);
-	for (i = 1; i < en->eng_group_nr; ++i) {
+	for (i = recovery_group_nr; i < en->eng_group_nr; ++i) {
 		rc = be_engine_group_start(en, i);
 		if (rc != 0)
 			break;
@@ -59,6 +59,13 @@ struct m0_be_engine_cfg {
 	uint64_t                   bec_tx_active_max;
 	/** Number of groups. */
 	size_t			   bec_group_nr;
+	/**
+	 * Number of groups used for recovery. Log records are read, decoded
+	 * and reapplied by these groups concurrently.
+	 * 0 means 1, values greater than bec_group_nr mean bec_group_nr.
+	 * m0_be_domain replaces 0 with bec_group_nr.
+	 */
+	size_t			   bec_recovery_group_nr;
 	/**
 	 * Group configuration.
 	 *
@@ -84,6 +91,12 @@ struct m0_be_engine_cfg {
 	struct m0_reqh		  *bec_reqh;
 	/** Wait in m0_be_engine_start() until recovery is finished. */
 	bool			   bec_wait_for_recovery;
+	/**
+	 * Optional. It is called under the engine lock after a group
+	 * recovered from the log is re-applied. Used by UT.
+	 */
+	void			 (*bec_group_reapplied_cb)(struct m0_be_tx_group
+							   *gr);
 	/** BE domain the engine belongs to. */
 	struct m0_be_domain	  *bec_domain;
 	struct m0_be_log_discard  *bec_log_discard;
@@ -153,6 +166,17 @@ M0_INTERNAL void m0_be_engine__tx_group_ready(struct m0_be_engine   *en,
 M0_INTERNAL void m0_be_engine__tx_group_discard(struct m0_be_engine   *en,
 						struct m0_be_tx_group *gr);
 
+/* Recovery: ordering of m0_be_tx_group_reapply(). */
+M0_INTERNAL void
+m0_be_engine__tx_group_reconstructed(struct m0_be_engine   *en,
+				     struct m0_be_tx_group *gr);
+M0_INTERNAL void
+m0_be_engine__tx_group_reapply_wait(struct m0_be_engine   *en,
+				    struct m0_be_tx_group *gr,
+				    struct m0_be_op       *op);
+M0_INTERNAL void m0_be_engine__tx_group_reapplied(struct m0_be_engine   *en,
+						  struct m0_be_tx_group *gr);
+
 M0_INTERNAL void m0_be_engine_got_log_space_cb(struct m0_be_log *log);
 M0_INTERNAL void m0_be_engine_full_log_cb(struct m0_be_log *log);
 
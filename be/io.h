@@ -120,6 +120,8 @@ struct m0_be_io {
 	struct m0_be_op         bio_sched_op;
 	/** The op passed to m0_be_io_sched_add() */
 	struct m0_be_op        *bio_sched_op_user;
+	/** The I/O is launched by the scheduler and is not finished yet. */
+	bool                    bio_sched_launched;
 	struct m0_ext           bio_ext;
 };
 
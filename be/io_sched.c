@@ -33,6 +33,7 @@
 #include "be/io_sched.h"
 
 #include "lib/ext.h"            /* m0_ext */
+#include "lib/arith.h"          /* max_check */
 
 #include "be/op.h"              /* m0_be_op */
 #include "be/io.h"              /* m0_be_io_launch */
@@ -56,6 +57,7 @@ M0_INTERNAL int m0_be_io_sched_init(struct m0_be_io_sched     *sched,
 	m0_mutex_init(&sched->bis_lock);
 	sched_io_tlist_init(&sched->bis_ios);
 	sched->bis_io_in_progress = false;
+	sched->bis_read_nr = 0;
 	sched->bis_pos = sched->bis_cfg.bisc_pos_start;
 
 	return 0;
@@ -90,28 +92,56 @@ static bool be_io_sched_invariant(struct m0_be_io_sched *sched)
 		    sched_io_tlist_next(&sched->bis_ios, io)->bio_ext.e_start);
 }
 
+static bool be_io_sched_io_is_read(struct m0_be_io *io)
+{
+	return !m0_be_io_is_empty(io) && m0_be_io_opcode(io) == SIO_READ;
+}
+
+static void be_io_sched_launch(struct m0_be_io_sched *sched,
+			       struct m0_be_io       *io)
+{
+	M0_LOG(M0_DEBUG, "sched=%p io=%p pos=%"PRId64,
+	       sched, io, sched->bis_pos);
+	io->bio_sched_launched = true;
+	m0_be_op_active(io->bio_sched_op_user);
+	m0_be_io_launch(io, &io->bio_sched_op);
+}
+
 static void be_io_sched_launch_next(struct m0_be_io_sched *sched)
 {
 	struct m0_be_io *io;
+	uint32_t         read_nr_max;
 
 	M0_PRE(m0_be_io_sched_is_locked(sched));
 
-	if (!sched->bis_io_in_progress) {
-		io = sched_io_tlist_head(&sched->bis_ios);
-		M0_ASSERT(ergo(io != NULL,
-			       sched->bis_pos <= io->bio_ext.e_start));
-		if (io != NULL) {
-			M0_LOG(M0_DEBUG, "bis_pos=%" PRIu64 " "
-			       "io->bio_ext.e_start=%"PRIu64,
-			       sched->bis_pos, io->bio_ext.e_start);
-		}
-		if (io != NULL && io->bio_ext.e_start == sched->bis_pos) {
-			sched->bis_io_in_progress = true;
-			M0_LOG(M0_DEBUG, "sched=%p io=%p pos=%"PRId64,
-			       sched, io, sched->bis_pos);
-			m0_be_op_active(io->bio_sched_op_user);
-			m0_be_io_launch(io, &io->bio_sched_op);
+	if (sched->bis_io_in_progress)
+		return;
+	read_nr_max = max_check(sched->bis_cfg.bisc_read_nr_max, 1U);
+	io = sched_io_tlist_head(&sched->bis_ios);
+	M0_ASSERT(ergo(io != NULL, sched->bis_pos <= io->bio_ext.e_start));
+	if (io != NULL) {
+		M0_LOG(M0_DEBUG, "bis_pos=%" PRIu64 " "
+		       "io->bio_ext.e_start=%"PRIu64,
+		       sched->bis_pos, io->bio_ext.e_start);
+	}
+	/* Launched read I/Os are always at the head of the queue. */
+	while (io != NULL && io->bio_sched_launched) {
+		M0_ASSERT(be_io_sched_io_is_read(io));
+		io = sched_io_tlist_next(&sched->bis_ios, io);
+	}
+	while (io != NULL && io->bio_ext.e_start == sched->bis_pos) {
+		if (!be_io_sched_io_is_read(io)) {
+			if (sched->bis_read_nr == 0) {
+				sched->bis_io_in_progress = true;
+				be_io_sched_launch(sched, io);
+			}
+			break;
 		}
+		if (sched->bis_read_nr == read_nr_max)
+			break;
+		++sched->bis_read_nr;
+		be_io_sched_launch(sched, io);
+		io = sched_io_tlist_next(&sched->bis_ios, io);
 	}
 }
 
@@ -134,7 +164,11 @@ static void be_io_sched_cb(struct m0_be_op *op, void *param)
 	m0_be_io_sched_lock(sched);
 	sched_io_tlink_del_fini(io);
 	m0_be_op_fini(&io->bio_sched_op);
-	sched->bis_io_in_progress = false;
+	io->bio_sched_launched = false;
+	if (be_io_sched_io_is_read(io))
+		M0_CNT_DEC(sched->bis_read_nr);
+	else
+		sched->bis_io_in_progress = false;
 	sched->bis_pos = io->bio_ext.e_end;
 	m0_be_io_sched_unlock(sched);
 
@@ -204,6 +238,7 @@ M0_INTERNAL void m0_be_io_sched_add(struct m0_be_io_sched *sched,
 	m0_be_op_callback_set(&io->bio_sched_op, &be_io_sched_cb,
 			      io, M0_BOS_GC);
 	io->bio_sched_op_user = op;
+	io->bio_sched_launched = false;
 	be_io_sched_launch_next(sched);
 }
 
@@ -42,6 +42,13 @@ struct m0_ext;
 struct m0_be_io_sched_cfg {
 	/** start position for m0_be_io_sched::bis_pos */
 	m0_bcount_t bisc_pos_start;
+	/**
+	 * Maximum number of read I/Os launched at the same time.
+	 * 0 and 1 mean that read I/Os are launched one by one, like write I/Os.
+	 * m0_be_domain replaces 0 in the log scheduler configuration with
+	 * m0_be_engine_cfg::bec_recovery_group_nr.
+	 */
+	uint32_t    bisc_read_nr_max;
 };
 
 /*
@@ -59,14 +66,20 @@ struct m0_be_io_sched_cfg {
  * - read I/O:
  *   - doesn't have m0_ext assigned (subject to change);
  *   - is launched after the last write I/O (at the time the read I/O is added
- *     to the scheduler's queue) from the queue is finished.
+ *     to the scheduler's queue) from the queue is finished;
+ *   - up to m0_be_io_sched_cfg::bisc_read_nr_max consecutive read I/Os are
+ *     launched without waiting for each other. They may finish in any order.
+ *     A write I/O is not launched until all of them are finished.
  */
 struct m0_be_io_sched {
 	struct m0_be_io_sched_cfg bis_cfg;
 	/** list of m0_be_io-s under scheduler's control */
 	struct m0_tl              bis_ios;
 	struct m0_mutex           bis_lock;
+	/** A write I/O (or the only read I/O) is in progress. */
 	bool                      bis_io_in_progress;
+	/** Number of read I/Os in progress. */
+	uint32_t                  bis_read_nr;
 	/** position for the next I/O */
 	m0_bcount_t               bis_pos;
 };
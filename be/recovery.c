@@ -140,6 +140,14 @@
  *
  * <b>Iterative interface for looking over groups that need to be re-applied</b>
  * Recovery provides interface for pick next group for re-applying.
+ *
+ * <b>Parallel re-applying</b>
+ * Engine starts m0_be_engine_cfg::bec_recovery_group_nr groups for recovery.
+ * Each of them takes the next log record, reads and reconstructs it
+ * independently, so log reads of several records are in flight at the same
+ * time (see m0_be_io_sched_cfg::bisc_read_nr_max). Group is re-applied to
+ * segments only after all groups with preceding log records either are
+ * re-applied or don't intersect with it (m0_be_tx_group_reapply_wait()).
  */
 
 M0_TL_DESCR_DEFINE(log_record_iter, "m0_be_log_record_iter list in recovery",
@@ -2221,6 +2221,7 @@ static void be_cfg_update(struct m0_be_domain_cfg *cfg,
 					M0_BE_TX_CREDIT(value1_64, value2_64);
 		}
 	} else if (m0_streq(str_key, "bpdc_seg_io_nr") ||
+		   m0_streq(str_key, "bisc_read_nr_max") ||
 		   m0_streq(str_key, "ldsc_items_max") ||
 		   m0_streq(str_key, "ldsc_items_threshold")) {
 
@@ -2234,6 +2235,9 @@ static void be_cfg_update(struct m0_be_domain_cfg *cfg,
 
 		if (m0_streq(str_key, "bpdc_seg_io_nr")) {
 			cfg->bc_pd_cfg.bpdc_seg_io_nr = value1_32;
+		} else if (m0_streq(str_key, "bisc_read_nr_max")) {
+			cfg->bc_log.lc_sched_cfg.lsch_io_sched_cfg.
+				bisc_read_nr_max = value1_32;
 		} else if (m0_streq(str_key, "ldsc_items_max")) {
 			cfg->bc_log_discard_cfg.ldsc_items_max = value1_32;
 		} else if (m0_streq(str_key, "ldsc_items_threshold")) {
@@ -2253,6 +2257,8 @@ static void be_cfg_update(struct m0_be_domain_cfg *cfg,
 			cfg->bc_engine.bec_tx_active_max = value1_64;
 		else if (m0_streq(str_key, "bec_group_nr"))
 			cfg->bc_engine.bec_group_nr = value1_64;
+		else if (m0_streq(str_key, "bec_recovery_group_nr"))
+			cfg->bc_engine.bec_recovery_group_nr = value1_64;
 		else if (m0_streq(str_key, "tgc_tx_nr_max"))
 			cfg->bc_engine.bec_group_cfg.tgc_tx_nr_max = value1_64;
 		else if (m0_streq(str_key, "tgc_payload_max"))
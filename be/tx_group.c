@@ -464,7 +464,11 @@ M0_INTERNAL void m0_be_tx_group_recovery_prepare(struct m0_be_tx_group *gr,
 {
 	m0_be_group_format_recovery_prepare(&gr->tg_od, log);
 	m0_be_tx_group_fom_recovery_prepare(&gr->tg_fom);
-	gr->tg_recovering = true;
+	gr->tg_recovering    = true;
+	gr->tg_recovery_pos  = m0_be_group_format_log_position(&gr->tg_od);
+	gr->tg_reconstructed = false;
+	gr->tg_reapplied     = false;
+	gr->tg_reapply_op    = NULL;
 }
 
 M0_INTERNAL void m0_be_tx_group_log_read(struct m0_be_tx_group *gr,
@@ -579,6 +583,7 @@ M0_INTERNAL int m0_be_tx_group_reconstruct(struct m0_be_tx_group *gr,
 {
 	be_tx_group_reconstruct_reg_area(gr);
 	be_tx_group_reconstruct_transactions(gr, sm_grp);
+	m0_be_engine__tx_group_reconstructed(gr->tg_engine, gr);
 	return 0; /* XXX no error handling yet. It will be fixed. */
 }
 
@@ -613,6 +618,12 @@ m0_be_tx_group_reconstruct_tx_close(struct m0_be_tx_group *gr,
 	} m0_tl_endfor;
 }
 
+M0_INTERNAL void m0_be_tx_group_reapply_wait(struct m0_be_tx_group *gr,
+					     struct m0_be_op       *op)
+{
+	m0_be_engine__tx_group_reapply_wait(gr->tg_engine, gr, op);
+}
+
 /*
  * It will perform actual I/O when paged implemented so op is added
  * to the function parameters list.
@@ -627,6 +638,7 @@ M0_INTERNAL int m0_be_tx_group_reapply(struct m0_be_tx_group *gr,
 	M0_BE_REG_AREA_FORALL(&gr->tg_reg_area, rd) {
 		memcpy(rd->rd_reg.br_addr, rd->rd_buf, rd->rd_reg.br_size);
 	};
+	m0_be_engine__tx_group_reapplied(gr->tg_engine, gr);
 
 	m0_be_op_done(op);
 	return 0;
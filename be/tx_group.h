@@ -144,6 +144,17 @@ struct m0_be_tx_group {
 	m0_time_t                  tg_close_deadline;
 	/** Group state. Is used and set by the engine. */
 	enum m0_be_tx_group_state  tg_state;
+	/*
+	 * Recovery fields. They are protected by the engine lock.
+	 */
+	/** Log position of the log record the group is recovered from. */
+	m0_bindex_t                tg_recovery_pos;
+	/** Regions of the group are known (group is reconstructed). */
+	bool                       tg_reconstructed;
+	/** Regions of the group are copied to the segments. */
+	bool                       tg_reapplied;
+	/** The op from m0_be_tx_group_reapply_wait() that is not done yet. */
+	struct m0_be_op           *tg_reapply_op;
 };
 
 M0_INTERNAL bool m0_be_tx_group__invariant(struct m0_be_tx_group *gr);
@@ -231,6 +242,16 @@ M0_INTERNAL void m0_be_tx_group_reconstruct_tx_open(struct m0_be_tx_group *gr,
 M0_INTERNAL void
 m0_be_tx_group_reconstruct_tx_close(struct m0_be_tx_group *gr,
                                     struct m0_be_op       *op_gc);
+/**
+ * Signals op when m0_be_tx_group_reapply() may be called for the group.
+ *
+ * Groups are recovered concurrently. Groups that are recovered from earlier
+ * log records and capture a region that intersects with one of the group
+ * regions have to be reapplied first, otherwise segment could get stale data.
+ * Groups with disjoint regions are reapplied in any order.
+ */
+M0_INTERNAL void m0_be_tx_group_reapply_wait(struct m0_be_tx_group *gr,
+					     struct m0_be_op       *op);
 M0_INTERNAL int m0_be_tx_group_reapply(struct m0_be_tx_group *gr,
 				       struct m0_be_op       *op);
 
@@ -62,6 +62,9 @@ static void tx_group_fom_fini(struct m0_fom *fom);
  * |      |                v
  * |      |             TX_CLOSE
  * |      |                |
+ * |      |                v
+ * |      |           REAPPLY_WAIT
+ * |      |                |
  * |      v                v
  * |    PLACING <------ REAPPLY
  * |      |
@@ -94,6 +97,8 @@ enum tx_group_fom_state {
 	TGS_RECONSTRUCT,        /* XXX rename it? */
 	TGS_TX_OPEN,            /* XXX rename it? */
 	TGS_TX_CLOSE,           /* XXX rename it? */
+	/** Waiting for groups with intersecting regions to be reapplied. */
+	TGS_REAPPLY_WAIT,
 	TGS_REAPPLY,            /* XXX rename it? */
 	/** In-place (segment) stobio is in progress. */
 	TGS_PLACING,
@@ -129,7 +134,8 @@ static struct m0_sm_state_descr tx_group_fom_states[TGS_NR] = {
 	_S(TGS_LOGGING,     0, M0_BITS(TGS_PLACING, TGS_RECONSTRUCT)),
 	_S(TGS_RECONSTRUCT, 0, M0_BITS(TGS_TX_OPEN)),
 	_S(TGS_TX_OPEN,     0, M0_BITS(TGS_TX_CLOSE)),
-	_S(TGS_TX_CLOSE,    0, M0_BITS(TGS_REAPPLY)),
+	_S(TGS_TX_CLOSE,    0, M0_BITS(TGS_REAPPLY_WAIT)),
+	_S(TGS_REAPPLY_WAIT, 0, M0_BITS(TGS_REAPPLY)),
 	_S(TGS_REAPPLY,     0, M0_BITS(TGS_PLACING)),
 	_S(TGS_PLACING,     0, M0_BITS(TGS_PLACED)),
 	_S(TGS_PLACED,      0, M0_BITS(TGS_STABILIZING)),
@@ -199,8 +205,12 @@ static int tx_group_fom_tick(struct m0_fom *fom)
 		m0_be_op_reset(&m->tgf_op_gc);
 		/* m0_be_op_tick_ret() for the op is in TGS_TX_GC_WAIT phase */
 		m0_be_tx_group_reconstruct_tx_close(gr, &m->tgf_op_gc);
-		m0_fom_phase_set(fom, TGS_REAPPLY);
+		m0_fom_phase_set(fom, TGS_REAPPLY_WAIT);
 		return M0_FSO_AGAIN;
+	case TGS_REAPPLY_WAIT:
+		m0_be_op_reset(op);
+		m0_be_tx_group_reapply_wait(gr, op);
+		return m0_be_op_tick_ret(op, fom, TGS_REAPPLY);
 	case TGS_REAPPLY:
 		m0_be_op_reset(op);
 		rc = m0_be_tx_group_reapply(gr, op);
@@ -34,6 +34,7 @@
 #include "lib/memory.h"      /* m0_alloc */
 #include "lib/misc.h"        /* M0_SET0 */
 #include "lib/errno.h"       /* ENOMEM */
+#include "lib/finject.h"     /* M0_FI_ENABLED */
 
 #include "module/instance.h" /* m0_get */
 
@@ -576,6 +577,16 @@ M0_INTERNAL void m0_be_group_format_seg_place(struct m0_be_group_format *gft,
 	m0_be_op_callback_set(gft_op, &be_tx_group_format_seg_io_op_gc,
 	                      gft, M0_BOS_GC);
 	M0_LOG(M0_DEBUG, "seg_place ldi=%p", gft->gft_log_discard_item);
+	if (M0_FI_ENABLED("skip_place")) {
+		/*
+		 * Crash simulation: segments are not updated and the log
+		 * record stays in the log to be re-applied by recovery.
+		 */
+		m0_mutex_lock(gft->gft_log->lg_cfg.lc_lock);
+		m0_be_log_record_skip_discard(&gft->gft_log_record);
+		m0_mutex_unlock(gft->gft_log->lg_cfg.lc_lock);
+		m0_be_io_reset(m0_be_pd_io_be_io(gft->gft_pd_io));
+	}
 	m0_be_pd_io_add(gft->gft_cfg.gfc_pd, gft->gft_pd_io, &gft->gft_ext,
 			gft_op);
 }
@@ -822,6 +822,24 @@ m0_be_reg_area_next(struct m0_be_reg_area *ra, struct m0_be_reg_d *prev)
 	return m0_be_regmap_next(&ra->bra_map, prev);
 }
 
+M0_INTERNAL bool m0_be_reg_area_intersects(struct m0_be_reg_area *ra1,
+					   struct m0_be_reg_area *ra2)
+{
+	struct m0_be_reg_d *rd1 = m0_be_reg_area_first(ra1);
+	struct m0_be_reg_d *rd2 = m0_be_reg_area_first(ra2);
+
+	/* Both lists are sorted by address, walk them like in merge sort. */
+	while (rd1 != NULL && rd2 != NULL) {
+		if (be_reg_d_are_overlapping(rd1, rd2))
+			return true;
+		if (be_reg_d_lb(rd1) < be_reg_d_lb(rd2))
+			rd1 = m0_be_reg_area_next(ra1, rd1);
+		else
+			rd2 = m0_be_reg_area_next(ra2, rd2);
+	}
+	return false;
+}
+
 M0_INTERNAL int
 m0_be_reg_area_merger_init(struct m0_be_reg_area_merger *brm,
                            int                           reg_area_nr_max)
@@ -296,6 +296,10 @@ M0_INTERNAL struct m0_be_reg_d *m0_be_reg_area_first(struct m0_be_reg_area *ra);
 M0_INTERNAL struct m0_be_reg_d *
 m0_be_reg_area_next(struct m0_be_reg_area *ra, struct m0_be_reg_d *prev);
 
+/** Returns true iff some region of ra1 overlaps with some region of ra2. */
+M0_INTERNAL bool m0_be_reg_area_intersects(struct m0_be_reg_area *ra1,
+					   struct m0_be_reg_area *ra2);
+
 #define M0_BE_REG_AREA_FORALL(ra, rd)                   \
 	for ((rd) = m0_be_reg_area_first(ra);           \
 	     (rd) != NULL;                              \
@@ -30,6 +30,7 @@
 #include "lib/thread.h"         /* m0_thread */
 #include "lib/arith.h"          /* m0_rnd64 */
 #include "lib/finject.h"        /* m0_fi_enable_once */
+#include "lib/ub.h"             /* m0_ub_set */
 
 #include "ut/ut.h"              /* M0_UT_ASSERT */
 
@@ -152,10 +153,13 @@ static void be_ut_alloc_thread(int index)
 
 static void be_ut_alloc_mt(int nr)
 {
-	struct m0_be_ut_backend *ut_be  = &be_ut_alloc_backend;
-	struct m0_be_ut_seg     *ut_seg = &be_ut_alloc_seg;
-	int                      rc;
-	int                      i;
+	struct m0_be_ut_backend       *ut_be  = &be_ut_alloc_backend;
+	struct m0_be_ut_seg           *ut_seg = &be_ut_alloc_seg;
+	struct m0_be_alloc_slab_stats  slab;
+	uint64_t                       lock_nr;
+	uint64_t                       lock_contended_nr;
+	int                            rc;
+	int                            i;
 
 	M0_SET_ARR0(be_ut_ts);
 	for (i = 0; i < nr; ++i) {
@@ -176,6 +180,15 @@ static void be_ut_alloc_mt(int nr)
 		m0_thread_join(&be_ut_ts[i].ats_thread);
 		m0_thread_fini(&be_ut_ts[i].ats_thread);
 	}
+	m0_be_alloc_lock_stats(m0_be_seg_allocator(ut_seg->bus_seg),
+			       &lock_nr, &lock_contended_nr);
+	m0_be_alloc_slab_stats(m0_be_seg_allocator(ut_seg->bus_seg), &slab);
+	/* Slab objects are allocated and freed without taking ba_lock. */
+	M0_UT_ASSERT(lock_nr + slab.bss_alloc_nr + slab.bss_free_nr >=
+		     m0_reduce(j, nr, 0ULL, + be_ut_ts[j].ats_nr));
+	M0_UT_ASSERT(lock_contended_nr <= lock_nr);
+	M0_UT_ASSERT(slab.bss_alloc_nr == slab.bss_free_nr);
+	M0_UT_ASSERT(slab.bss_slab_alloc_nr == slab.bss_slab_free_nr);
 	m0_be_ut_seg_allocator_fini(ut_seg, ut_be);
 	m0_be_ut_seg_fini(ut_seg);
 	m0_be_ut_backend_fini(ut_be);
@@ -635,6 +648,274 @@ M0_INTERNAL void m0_be_ut_alloc_align(void)
 	M0_SET0(ut_be);
 }
 
+enum {
+	BE_UT_SLAB_SEG_SIZE   = 0x100000,
+	BE_UT_SLAB_NODE_SIZE  = 0x1000,
+	BE_UT_SLAB_NODE_SHIFT = 12,
+	BE_UT_SLAB_SMALL_SIZE = 0x20,
+	/* More than fits into one slab of BE_UT_SLAB_NODE_SIZE nodes. */
+	BE_UT_SLAB_PTR_NR     = 0x14,
+};
+
+static bool be_ut_alloc_disjoint(void *p0, void *p1, m0_bcount_t size)
+{
+	return (char *)p0 + size <= (char *)p1 ||
+	       (char *)p1 + size <= (char *)p0;
+}
+
+static void be_ut_alloc_slab_credit(struct m0_be_allocator  *a,
+				    enum m0_be_allocator_op  node_op,
+				    enum m0_be_allocator_op  small_op,
+				    struct m0_be_tx_credit  *cred)
+{
+	m0_be_allocator_credit(a, node_op,
+			       BE_UT_SLAB_NODE_SIZE - m0_be_chunk_header_size(),
+			       BE_UT_SLAB_NODE_SHIFT, cred);
+	m0_be_allocator_credit(a, small_op, BE_UT_SLAB_SMALL_SIZE, 0, cred);
+}
+
+/**
+ * Allocates btree nodes and small objects, which are served by slabs.
+ * Re-initialises the allocator, as it happens on restart, frees the objects
+ * and checks that the slabs are taken over and returned to the free lists.
+ */
+M0_INTERNAL void m0_be_ut_alloc_slab(void)
+{
+	struct m0_be_ut_backend       *ut_be  = &be_ut_alloc_backend;
+	struct m0_be_ut_seg           *ut_seg = &be_ut_alloc_seg;
+	struct m0_be_alloc_slab_stats  slab;
+	struct m0_be_allocator        *a;
+	void                          *node[BE_UT_SLAB_PTR_NR] = {};
+	void                          *small[BE_UT_SLAB_PTR_NR] = {};
+	m0_bcount_t                    node_size;
+	int                            rc;
+	int                            i;
+
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(ut_seg, ut_be, BE_UT_SLAB_SEG_SIZE);
+	m0_be_ut_seg_allocator_init(ut_seg, ut_be);
+	a = m0_be_seg_allocator(ut_seg->bus_seg);
+	node_size = BE_UT_SLAB_NODE_SIZE - m0_be_chunk_header_size();
+
+	for (i = 0; i < ARRAY_SIZE(node); ++i) {
+		M0_BE_UT_TRANSACT(ut_be, tx, cred,
+			be_ut_alloc_slab_credit(a, M0_BAO_ALLOC_ALIGNED,
+						M0_BAO_ALLOC, &cred),
+			(M0_BE_OP_SYNC(op, m0_be_alloc_aligned(a, tx, &op,
+						&node[i], node_size,
+						BE_UT_SLAB_NODE_SHIFT,
+						M0_BITS(M0_BAP_NORMAL), true)),
+			 M0_BE_OP_SYNC(op, m0_be_alloc(a, tx, &op, &small[i],
+						BE_UT_SLAB_SMALL_SIZE))));
+		M0_UT_ASSERT(node[i] != NULL && small[i] != NULL);
+		M0_UT_ASSERT(m0_addr_is_aligned((char *)node[i] -
+						m0_be_chunk_header_size(),
+						BE_UT_SLAB_NODE_SHIFT));
+		M0_UT_ASSERT(m0_addr_is_aligned(small[i],
+						M0_BE_ALLOC_SHIFT_MIN));
+		M0_UT_ASSERT(m0_forall(j, node_size,
+				       ((char *)node[i])[j] == 0));
+		M0_UT_ASSERT(m0_forall(j, i,
+			be_ut_alloc_disjoint(node[i], node[j],
+					     BE_UT_SLAB_NODE_SIZE) &&
+			be_ut_alloc_disjoint(small[i], small[j],
+					     BE_UT_SLAB_SMALL_SIZE)));
+	}
+	m0_be_alloc_slab_stats(a, &slab);
+	M0_UT_ASSERT(slab.bss_alloc_nr == 2 * ARRAY_SIZE(node));
+	M0_UT_ASSERT(slab.bss_free_nr == 0);
+	/* At least two slabs of nodes and one of small objects. */
+	M0_UT_ASSERT(slab.bss_slab_alloc_nr >= 3);
+
+	/* Volatile slab state of the previous instance is stale after this. */
+	m0_be_allocator_fini(a);
+	rc = m0_be_allocator_init(a, ut_seg->bus_seg);
+	M0_UT_ASSERT(rc == 0);
+
+	for (i = 0; i < ARRAY_SIZE(node); ++i) {
+		M0_BE_UT_TRANSACT(ut_be, tx, cred,
+			be_ut_alloc_slab_credit(a, M0_BAO_FREE_ALIGNED,
+						M0_BAO_FREE, &cred),
+			(M0_BE_OP_SYNC(op, m0_be_free_aligned(a, tx, &op,
+							      node[i])),
+			 M0_BE_OP_SYNC(op, m0_be_free(a, tx, &op,
+						      small[i]))));
+	}
+	m0_be_alloc_slab_stats(a, &slab);
+	M0_UT_ASSERT(slab.bss_alloc_nr == 0);
+	M0_UT_ASSERT(slab.bss_free_nr == 2 * ARRAY_SIZE(node));
+	M0_UT_ASSERT(slab.bss_slab_adopt_nr >= 3);
+	M0_UT_ASSERT(slab.bss_slab_free_nr == slab.bss_slab_adopt_nr);
+
+	/* Allocator destruction checks that all slabs are released. */
+	m0_be_ut_seg_allocator_fini(ut_seg, ut_be);
+	m0_be_ut_seg_fini(ut_seg);
+	m0_be_ut_backend_fini(ut_be);
+	M0_SET0(ut_be);
+}
+
+enum {
+	BE_UB_ALLOC_SEG_SIZE = 0x800000,
+	/** Size of a btree node, the most frequent large allocation. */
+	BE_UB_ALLOC_SIZE     = 0x1000,
+	BE_UB_ALLOC_SHIFT    = 12,
+	BE_UB_ALLOC_THR_NR   = 0x8,
+	BE_UB_ALLOC_TX_NR    = 0x10,
+	BE_UB_ALLOC_ITER     = 0x10,
+};
+
+static struct be_ut_alloc_thread_state be_ub_ts[BE_UB_ALLOC_THR_NR];
+
+static void be_ub_alloc_credit(struct m0_be_allocator  *a,
+			       enum m0_be_allocator_op  optype,
+			       struct m0_be_tx_credit  *cred)
+{
+	int i;
+
+	for (i = 0; i < BE_UT_ALLOC_PTR_NR; ++i)
+		m0_be_allocator_credit(a, optype, BE_UB_ALLOC_SIZE,
+				       BE_UB_ALLOC_SHIFT, cred);
+}
+
+static void be_ub_alloc_all(struct m0_be_allocator *a,
+			    struct m0_be_tx        *tx,
+			    void                  **ptr)
+{
+	int i;
+
+	/* Allocate the way bnode_alloc() does. */
+	for (i = 0; i < BE_UT_ALLOC_PTR_NR; ++i) {
+		M0_BE_OP_SYNC(op, m0_be_alloc_aligned(a, tx, &op, &ptr[i],
+					BE_UB_ALLOC_SIZE -
+					m0_be_chunk_header_size(),
+					BE_UB_ALLOC_SHIFT,
+					M0_BITS(M0_BAP_NORMAL), true));
+		M0_UB_ASSERT(ptr[i] != NULL);
+	}
+}
+
+static void be_ub_free_all(struct m0_be_allocator *a,
+			   struct m0_be_tx        *tx,
+			   void                  **ptr)
+{
+	int i;
+
+	for (i = 0; i < BE_UT_ALLOC_PTR_NR; ++i) {
+		M0_BE_OP_SYNC(op, m0_be_free_aligned(a, tx, &op, ptr[i]));
+		ptr[i] = NULL;
+	}
+}
+
+/**
+ * Allocates all ats_ptr[] in one transaction and frees them in the next one,
+ * BE_UB_ALLOC_TX_NR times.
+ */
+static void be_ub_alloc_thread(int index)
+{
+	struct be_ut_alloc_thread_state *ts    = &be_ub_ts[index];
+	struct m0_be_ut_backend         *ut_be = &be_ut_alloc_backend;
+	struct m0_be_allocator          *a;
+	int                              i;
+
+	a = m0_be_seg_allocator(be_ut_alloc_seg.bus_seg);
+	for (i = 0; i < BE_UB_ALLOC_TX_NR; ++i) {
+		M0_BE_UT_TRANSACT(ut_be, tx, cred,
+				  be_ub_alloc_credit(a, M0_BAO_ALLOC_ALIGNED,
+						     &cred),
+				  be_ub_alloc_all(a, tx, ts->ats_ptr));
+		M0_BE_UT_TRANSACT(ut_be, tx, cred,
+				  be_ub_alloc_credit(a, M0_BAO_FREE_ALIGNED,
+						     &cred),
+				  be_ub_free_all(a, tx, ts->ats_ptr));
+	}
+	m0_be_ut_backend_thread_exit(ut_be);
+}
+
+static void be_ub_alloc_mt(int nr)
+{
+	int rc;
+	int i;
+
+	M0_SET_ARR0(be_ub_ts);
+	for (i = 0; i < nr; ++i) {
+		rc = M0_THREAD_INIT(&be_ub_ts[i].ats_thread, int, NULL,
+				    &be_ub_alloc_thread, i,
+				    "#%dbe_ub_alloc", i);
+		M0_UB_ASSERT(rc == 0);
+	}
+	for (i = 0; i < nr; ++i) {
+		m0_thread_join(&be_ub_ts[i].ats_thread);
+		m0_thread_fini(&be_ub_ts[i].ats_thread);
+	}
+}
+
+static void be_ub_alloc_1(int iter)
+{
+	be_ub_alloc_mt(1);
+}
+
+static void be_ub_alloc_2(int iter)
+{
+	be_ub_alloc_mt(2);
+}
+
+static void be_ub_alloc_4(int iter)
+{
+	be_ub_alloc_mt(4);
+}
+
+static void be_ub_alloc_8(int iter)
+{
+	be_ub_alloc_mt(8);
+}
+
+static int be_ub_alloc_init(const char *opts M0_UNUSED)
+{
+	m0_be_ut_backend_init(&be_ut_alloc_backend);
+	m0_be_ut_seg_init(&be_ut_alloc_seg, &be_ut_alloc_backend,
+			  BE_UB_ALLOC_SEG_SIZE);
+	m0_be_ut_seg_allocator_init(&be_ut_alloc_seg, &be_ut_alloc_backend);
+	return 0;
+}
+
+static void be_ub_alloc_fini(void)
+{
+	m0_be_ut_seg_allocator_fini(&be_ut_alloc_seg, &be_ut_alloc_backend);
+	m0_be_ut_seg_fini(&be_ut_alloc_seg);
+	m0_be_ut_backend_fini(&be_ut_alloc_backend);
+	M0_SET0(&be_ut_alloc_backend);
+}
+
+/**
+ * Multi-threaded allocator benchmark: every thread allocates and frees
+ * btree nodes, so the rounds show how m0_be_alloc_aligned() and
+ * m0_be_free_aligned() scale with the number of threads.
+ */
+struct m0_ub_set m0_be_alloc_ub = {
+	.us_name = "be-alloc-ub",
+	.us_init = be_ub_alloc_init,
+	.us_fini = be_ub_alloc_fini,
+	.us_run  = {
+		{ .ub_name  = "mt-1",
+		  .ub_iter  = BE_UB_ALLOC_ITER,
+		  .ub_round = be_ub_alloc_1 },
+
+		{ .ub_name  = "mt-2",
+		  .ub_iter  = BE_UB_ALLOC_ITER,
+		  .ub_round = be_ub_alloc_2 },
+
+		{ .ub_name  = "mt-4",
+		  .ub_iter  = BE_UB_ALLOC_ITER,
+		  .ub_round = be_ub_alloc_4 },
+
+		{ .ub_name  = "mt-8",
+		  .ub_iter  = BE_UB_ALLOC_ITER,
+		  .ub_round = be_ub_alloc_8 },
+
+		{ .ub_name = NULL }
+	}
+};
+
 #undef M0_TRACE_SUBSYSTEM
 
 /*
@@ -312,10 +312,6 @@ void m0_be_ut_backend_cfg_default(struct m0_be_domain_cfg *cfg)
 				.lsc_rbuf_nr = 3,
 				/* other fields are filled by domain and log */
 			},
-			.lc_sched_cfg = {
-				.lsch_io_sched_cfg = {
-				},
-			},
 			.lc_full_threshold = 20 * (1 << 20),
 			.lc_skip_recovery  = false,
 			/* other fields are filled by the domain */
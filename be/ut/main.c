@@ -86,6 +86,7 @@ extern void m0_be_ut_log_unplaced(void);
 extern void m0_be_ut_log_multi(void);
 
 extern void m0_be_ut_recovery(void);
+extern void m0_be_ut_recovery_engine(void);
 
 extern void m0_be_ut_pd_usecase(void);
 
@@ -142,6 +143,7 @@ extern void m0_be_ut_alloc_oom(void);
 extern void m0_be_ut_alloc_info(void);
 extern void m0_be_ut_alloc_spare(void);
 extern void m0_be_ut_alloc_align(void);
+extern void m0_be_ut_alloc_slab(void);
 
 extern void m0_be_ut_list(void);
 extern void m0_be_ut_emap(void);
@@ -213,6 +215,7 @@ struct m0_ut_suite be_ut = {
 		{ "log-multi",               m0_be_ut_log_multi               },
 */
 		{ "recovery",                m0_be_ut_recovery                },
+		{ "recovery-engine",         m0_be_ut_recovery_engine         },
 		{ "pd-usecase",              m0_be_ut_pd_usecase              },
 		{ "seg-open",                m0_be_ut_seg_open_close          },
 		{ "seg-io",                  m0_be_ut_seg_io                  },
@@ -261,6 +264,7 @@ struct m0_ut_suite be_ut = {
 		{ "alloc-info",              m0_be_ut_alloc_info              },
 		{ "alloc-spare",             m0_be_ut_alloc_spare             },
                 { "alloc-align",             m0_be_ut_alloc_align             },
+		{ "alloc-slab",              m0_be_ut_alloc_slab              },
 		{ "obj",                     m0_be_ut_obj_test                },
 		{ "actrec",                  m0_be_ut_actrec_test             },
 #endif /* __KERNEL__ */
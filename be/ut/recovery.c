@@ -20,10 +20,19 @@
  */
 
 
+#define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_UT
+#include "lib/trace.h"
+
 #include "be/io.h"
 #include "be/log.h"
+#include "be/op.h"
 #include "be/recovery.h"
+#include "be/tx_group.h"        /* m0_be_tx_group */
+#include "be/tx_regmap.h"       /* M0_BE_REG_AREA_FORALL */
+#include "be/ut/helper.h"       /* m0_be_ut_backend */
+#include "lib/finject.h"        /* m0_fi_enable */
 #include "lib/memory.h"
+#include "lib/ub.h"             /* m0_ub_set */
 #include "stob/domain.h"
 #include "stob/stob.h"
 #include "ut/stob.h"
@@ -36,6 +45,8 @@ enum {
 	BE_UT_RECOVERY_LOG_STOB_DOMAIN_KEY = 100,
 	BE_UT_RECOVERY_LOG_STOB_KEY        = 42,
 	BE_UT_RECOVERY_LOG_RBUF_NR         = 8,
+	/* number of log records read at the same time */
+	BE_UT_RECOVERY_READ_WINDOW         = 4,
 };
 
 const char *be_ut_recovery_log_sdom_location   = "linuxstob:./log";
@@ -47,15 +58,18 @@ struct be_ut_recovery_ctx {
 	struct m0_mutex          burc_lock;
 	struct m0_stob_domain   *burc_sdom;
 	struct m0_be_log_record *burc_records;
+	m0_bcount_t              burc_log_size;
+	m0_bcount_t              burc_lio_size;
+	/** @see m0_be_io_sched_cfg::bisc_read_nr_max */
+	uint32_t                 burc_read_nr_max;
 };
 
 static void be_ut_log_got_space_cb(struct m0_be_log *log)
 {
 }
 
-static void be_ut_recovery_log_cfg_set(struct m0_be_log_cfg  *log_cfg,
-				       struct m0_stob_domain *sdom,
-				       struct m0_mutex       *lock)
+static void be_ut_recovery_log_cfg_set(struct m0_be_log_cfg     *log_cfg,
+				       struct be_ut_recovery_ctx *ctx)
 {
 	*log_cfg = (struct m0_be_log_cfg){
 		.lc_store_cfg = {
@@ -65,15 +79,20 @@ static void be_ut_recovery_log_cfg_set(struct m0_be_log_cfg  *log_cfg,
 			.lsc_stob_domain_key        = 0x1000,
 			.lsc_stob_domain_create_cfg = NULL,
 			/* temporary solution END */
-			.lsc_size            = BE_UT_RECOVERY_LOG_SIZE,
+			.lsc_size            = ctx->burc_log_size,
 			.lsc_stob_create_cfg = NULL,
 			.lsc_rbuf_nr         = BE_UT_RECOVERY_LOG_RBUF_NR,
 		},
+		.lc_sched_cfg = {
+			.lsch_io_sched_cfg = {
+				.bisc_read_nr_max = ctx->burc_read_nr_max,
+			},
+		},
 		.lc_got_space_cb = &be_ut_log_got_space_cb,
-		.lc_lock         = lock,
+		.lc_lock         = &ctx->burc_lock,
 	};
 	m0_stob_id_make(0, BE_UT_RECOVERY_LOG_STOB_KEY,
-	                m0_stob_domain_id_get(sdom),
+	                m0_stob_domain_id_get(ctx->burc_sdom),
 	                &log_cfg->lc_store_cfg.lsc_stob_id);
 }
 
@@ -89,7 +108,7 @@ static void be_ut_recovery_log_init(struct be_ut_recovery_ctx *ctx)
 				   be_ut_recovery_log_sdom_create_cfg,
 				   &ctx->burc_sdom);
 	M0_UT_ASSERT(rc == 0);
-	be_ut_recovery_log_cfg_set(&log_cfg, ctx->burc_sdom, &ctx->burc_lock);
+	be_ut_recovery_log_cfg_set(&log_cfg, ctx);
 	rc = m0_be_log_create(&ctx->burc_log, &log_cfg);
 	M0_UT_ASSERT(rc == 0);
 }
@@ -109,7 +128,7 @@ static void be_ut_recovery_log_open(struct be_ut_recovery_ctx *ctx)
 	struct m0_be_log_cfg log_cfg;
 	int                  rc;
 
-	be_ut_recovery_log_cfg_set(&log_cfg, ctx->burc_sdom, &ctx->burc_lock);
+	be_ut_recovery_log_cfg_set(&log_cfg, ctx);
 	rc = m0_be_log_open(&ctx->burc_log, &log_cfg);
 	M0_UT_ASSERT(rc == 0);
 }
@@ -127,12 +146,13 @@ static void be_ut_recovery_log_reopen(struct be_ut_recovery_ctx *ctx)
 }
 
 static void be_ut_recovery_log_record_init_one(struct m0_be_log_record *record,
-					       struct m0_be_log        *log)
+					       struct m0_be_log        *log,
+					       m0_bcount_t              lio_size)
 {
 	int rc;
 
 	m0_be_log_record_init(record, log);
-	rc = m0_be_log_record_io_create(record, BE_UT_RECOVERY_LOG_LIO_SIZE);
+	rc = m0_be_log_record_io_create(record, lio_size);
 	M0_UT_ASSERT(rc == 0);
 	rc = m0_be_log_record_allocate(record);
 	M0_UT_ASSERT(rc == 0);
@@ -160,7 +180,8 @@ static void be_ut_recovery_log_fill(struct be_ut_recovery_ctx *ctx,
 
 	for (i = 0; i < record_nr; ++i) {
 		record = &ctx->burc_records[i];
-		be_ut_recovery_log_record_init_one(record, log);
+		be_ut_recovery_log_record_init_one(record, log,
+						   BE_UT_RECOVERY_LOG_LIO_SIZE);
 		m0_mutex_lock(lock);
 		rc = m0_be_log_reserve(log, BE_UT_RECOVERY_LOG_RESERVE_SIZE);
 		M0_UT_ASSERT(rc == 0);
@@ -191,77 +212,495 @@ static void be_ut_recovery_log_fill(struct be_ut_recovery_ctx *ctx,
 	m0_free(ctx->burc_records);
 }
 
-static int be_ut_recovery_iter_count(struct be_ut_recovery_ctx *ctx)
+/**
+ * Reads all log records that need to be re-applied, keeping up to "window"
+ * records being read at the same time. Records are completed in the log
+ * order.
+ *
+ * If "discard" is true then the records are discarded to move log's pointers.
+ */
+static int be_ut_recovery_iter_count(struct be_ut_recovery_ctx *ctx,
+				     int                        window,
+				     bool                       discard)
 {
 	struct m0_be_log             *log    = &ctx->burc_log;
 	struct m0_mutex              *lock   = &ctx->burc_lock;
-	struct m0_be_log_record       record = {};
+	struct m0_be_log_record      *records;
+	struct m0_be_log_record      *record;
 	struct m0_be_log_record_iter  iter   = {};
+	struct m0_be_op              *ops;
+	m0_bcount_t                   lio_size;
 	int                           count  = 0;
+	int                           head   = 0;
+	int                           nr     = 0;
 	int                           rc;
-
-	be_ut_recovery_log_record_init_one(&record, log);
+	int                           i;
+
+	lio_size = ctx->burc_lio_size ?: BE_UT_RECOVERY_LOG_LIO_SIZE;
+	M0_ALLOC_ARR(records, window);
+	M0_ALLOC_ARR(ops, window);
+	M0_UT_ASSERT(records != NULL && ops != NULL);
+	for (i = 0; i < window; ++i)
+		be_ut_recovery_log_record_init_one(&records[i], log, lio_size);
 	rc = m0_be_log_record_iter_init(&iter);
 	M0_UT_ASSERT(rc == 0);
-	while (m0_be_log_recovery_record_available(log)) {
-		m0_be_log_recovery_record_get(log, &iter);
+	while (true) {
+		while (nr < window && m0_be_log_recovery_record_available(log)) {
+			i = (head + nr) % window;
+			record = &records[i];
+			m0_be_log_recovery_record_get(log, &iter);
+			m0_be_log_record_assign(record, &iter, discard);
+			m0_mutex_lock(lock);
+			m0_be_log_record_io_prepare(record, SIO_READ, 0);
+			m0_mutex_unlock(lock);
+			m0_be_op_init(&ops[i]);
+			m0_be_log_record_io_launch(record, &ops[i]);
+			++nr;
+		}
+		if (nr == 0)
+			break;
+		record = &records[head];
+		m0_be_op_wait(&ops[head]);
+		M0_UT_ASSERT(ops[head].bo_sm.sm_rc == 0);
+		m0_be_op_fini(&ops[head]);
+		if (discard) {
+			m0_mutex_lock(lock);
+			m0_be_log_record_discard(record->lgr_log,
+						 record->lgr_size);
+			m0_mutex_unlock(lock);
+		}
+		m0_be_log_record_reset(record);
+		head = (head + 1) % window;
+		--nr;
 		++count;
-
-		/* discard this record to move log's pointers */
-		m0_be_log_record_assign(&record, &iter, true);
-		m0_mutex_lock(lock);
-		m0_be_log_record_io_prepare(&record, SIO_READ, 0);
-		m0_mutex_unlock(lock);
-		rc = M0_BE_OP_SYNC_RET(op,
-				       m0_be_log_record_io_launch(&record, &op),
-				       bo_sm.sm_rc);
-		M0_UT_ASSERT(rc == 0);
-		m0_mutex_lock(lock);
-		m0_be_log_record_discard(record.lgr_log, record.lgr_size);
-		m0_mutex_unlock(lock);
-		m0_be_log_record_reset(&record);
 	}
 	m0_be_log_record_iter_fini(&iter);
-	be_ut_recovery_log_record_fini_one(&record);
+	for (i = 0; i < window; ++i)
+		be_ut_recovery_log_record_fini_one(&records[i]);
+	m0_free(ops);
+	m0_free(records);
 
 	return count;
 }
 
 void m0_be_ut_recovery(void)
 {
-	struct be_ut_recovery_ctx ctx = {};
+	struct be_ut_recovery_ctx ctx = {
+		.burc_log_size    = BE_UT_RECOVERY_LOG_SIZE,
+		.burc_read_nr_max = BE_UT_RECOVERY_READ_WINDOW,
+	};
 	int                       count;
 	int                       nr;
 
 	be_ut_recovery_log_init(&ctx);
 
 	/* empty log */
-	count = be_ut_recovery_iter_count(&ctx);
+	count = be_ut_recovery_iter_count(&ctx, 1, true);
 	M0_UT_ASSERT(count == 0);
 
 	be_ut_recovery_log_fill(&ctx, 10, 10, false);
 	be_ut_recovery_log_reopen(&ctx);
-	count = be_ut_recovery_iter_count(&ctx);
+	count = be_ut_recovery_iter_count(&ctx, 1, true);
 	M0_UT_ASSERT(count == 0);
 
 	be_ut_recovery_log_fill(&ctx, 10, 5, false);
 	be_ut_recovery_log_reopen(&ctx);
-	count = be_ut_recovery_iter_count(&ctx);
+	count = be_ut_recovery_iter_count(&ctx, 1, true);
 	M0_UT_ASSERT(count == 5);
 
 	nr = BE_UT_RECOVERY_LOG_SIZE / BE_UT_RECOVERY_LOG_RESERVE_SIZE * 2;
 	be_ut_recovery_log_fill(&ctx, nr, nr - 5, false);
 	be_ut_recovery_log_reopen(&ctx);
-	count = be_ut_recovery_iter_count(&ctx);
+	count = be_ut_recovery_iter_count(&ctx, 1, true);
 	M0_UT_ASSERT(count == 5);
 
 	be_ut_recovery_log_reopen(&ctx);
-	count = be_ut_recovery_iter_count(&ctx);
+	count = be_ut_recovery_iter_count(&ctx, 1, true);
+	M0_UT_ASSERT(count == 0);
+
+	/* read-ahead: several log records are read at the same time */
+	be_ut_recovery_log_fill(&ctx, 20, 3, false);
+	be_ut_recovery_log_reopen(&ctx);
+	count = be_ut_recovery_iter_count(&ctx, BE_UT_RECOVERY_READ_WINDOW,
+					  false);
+	M0_UT_ASSERT(count == 17);
+	be_ut_recovery_log_reopen(&ctx);
+	count = be_ut_recovery_iter_count(&ctx, BE_UT_RECOVERY_READ_WINDOW,
+					  true);
+	M0_UT_ASSERT(count == 17);
+	be_ut_recovery_log_reopen(&ctx);
+	count = be_ut_recovery_iter_count(&ctx, 1, true);
 	M0_UT_ASSERT(count == 0);
 
 	be_ut_recovery_log_fini(&ctx);
 }
 
+enum {
+	BE_UT_RECOVERY_ENGINE_TX_NR      = 32,
+	BE_UT_RECOVERY_ENGINE_REG_SIZE   = 0x2000,
+	BE_UT_RECOVERY_ENGINE_SEG_SIZE   = 1 << 20,
+	BE_UT_RECOVERY_ENGINE_GROUP_NR   = 4,
+	BE_UT_RECOVERY_ENGINE_REAPPLY_NR = 0x100,
+};
+
+/** Group re-applied by recovery, in the order of re-applying. */
+struct be_ut_recovery_reapplied {
+	m0_bindex_t  burr_pos;
+	char        *burr_start;
+	char        *burr_end;
+};
+
+static struct be_ut_recovery_reapplied
+	be_ut_recovery_reapplied[BE_UT_RECOVERY_ENGINE_REAPPLY_NR];
+static int be_ut_recovery_reapplied_nr;
+
+static void be_ut_recovery_group_reapplied(struct m0_be_tx_group *gr)
+{
+	struct be_ut_recovery_reapplied *r;
+	struct m0_be_reg_d              *rd;
+	char                            *addr;
+
+	if (be_ut_recovery_reapplied_nr < ARRAY_SIZE(be_ut_recovery_reapplied)) {
+		r = &be_ut_recovery_reapplied[be_ut_recovery_reapplied_nr];
+		*r = (struct be_ut_recovery_reapplied){
+			.burr_pos   = gr->tg_recovery_pos,
+			.burr_start = (char *)UINTPTR_MAX,
+			.burr_end   = NULL,
+		};
+		M0_BE_REG_AREA_FORALL(&gr->tg_reg_area, rd) {
+			addr = rd->rd_reg.br_addr;
+			r->burr_start = min_check(r->burr_start, addr);
+			r->burr_end   = max_check(r->burr_end,
+						  addr + rd->rd_reg.br_size);
+		};
+	}
+	++be_ut_recovery_reapplied_nr;
+}
+
+static void be_ut_recovery_engine_cfg(struct m0_be_domain_cfg *cfg,
+				      size_t                   group_nr,
+				      m0_bcount_t              log_size)
+{
+	struct m0_be_engine_cfg   *en_cfg = &cfg->bc_engine;
+	struct m0_be_tx_group_cfg *gr_cfg = &en_cfg->bec_group_cfg;
+
+	m0_be_ut_backend_cfg_default(cfg);
+	/* smaller groups: there are more of them than in the default config */
+	en_cfg->bec_group_nr           = group_nr;
+	en_cfg->bec_recovery_group_nr  = group_nr;
+	en_cfg->bec_tx_size_max        = M0_BE_TX_CREDIT(1 << 14, 8UL << 20);
+	en_cfg->bec_tx_payload_max     = 1 << 20;
+	en_cfg->bec_group_reapplied_cb = &be_ut_recovery_group_reapplied;
+	gr_cfg->tgc_size_max           = en_cfg->bec_tx_size_max;
+	gr_cfg->tgc_payload_max        = 1 << 21;
+	cfg->bc_log.lc_store_cfg.lsc_size = log_size;
+}
+
+/* Size of the segment area written by be_ut_recovery_engine_crash(). */
+static m0_bcount_t be_ut_recovery_engine_area(int tx_nr, m0_bcount_t reg_size)
+{
+	return 2 * (tx_nr / 2 + 1) * (reg_size / 2);
+}
+
+/**
+ * Creates a segment, then runs tx_nr transactions with segment placing
+ * disabled and stops the backend. Segment stob doesn't have the changes, but
+ * log records of all the transactions are left for recovery.
+ *
+ * Even and odd transactions write to 2 disjoint parts of the segment. Each
+ * transaction overwrites half of the region written by the previous
+ * transaction in the same part, so re-applying of such groups must keep the
+ * log order while groups from different parts may be re-applied in any order.
+ *
+ * Expected segment contents after recovery are returned in "expected".
+ */
+static void *be_ut_recovery_engine_crash(struct m0_be_domain_cfg *cfg,
+					 m0_bcount_t              seg_size,
+					 int                      tx_nr,
+					 m0_bcount_t              reg_size,
+					 char                    *expected)
+{
+	struct m0_be_ut_backend  ut_be = {};
+	struct m0_be_tx_credit   cred  = M0_BE_TX_CREDIT(1, reg_size);
+	struct m0_be_seg        *seg;
+	struct m0_be_tx          tx;
+	m0_bcount_t              half  = reg_size / 2;
+	m0_bcount_t              area;
+	m0_bcount_t              offset;
+	void                    *addr;
+	char                    *data;
+	int                      rc;
+	int                      i;
+
+	area = be_ut_recovery_engine_area(tx_nr, reg_size);
+	rc = m0_be_ut_backend_init_cfg(&ut_be, cfg, true);
+	M0_UT_ASSERT(rc == 0);
+	m0_be_ut_backend_seg_add2(&ut_be, seg_size, true, NULL, &seg);
+	addr = seg->bs_addr;
+	M0_UT_ASSERT(seg->bs_reserved + area <= seg->bs_size);
+	m0_be_ut_backend_fini(&ut_be);
+
+	M0_SET0(&ut_be);
+	rc = m0_be_ut_backend_init_cfg(&ut_be, cfg, false);
+	M0_UT_ASSERT(rc == 0);
+	seg = m0_be_domain_seg(&ut_be.but_dom, addr);
+	M0_UT_ASSERT(seg != NULL);
+	data = seg->bs_addr + seg->bs_reserved;
+	memcpy(expected, data, area);
+
+	m0_fi_enable("m0_be_group_format_seg_place", "skip_place");
+	for (i = 0; i < tx_nr; ++i) {
+		offset = (i % 2) * (area / 2) + (i / 2) * half;
+		M0_SET0(&tx);
+		m0_be_ut_tx_init(&tx, &ut_be);
+		m0_be_tx_prep(&tx, &cred);
+		rc = m0_be_tx_open_sync(&tx);
+		M0_UT_ASSERT(rc == 0);
+		memset(data + offset, i + 1, reg_size);
+		memset(expected + offset, i + 1, reg_size);
+		m0_be_tx_capture(&tx, &M0_BE_REG(seg, reg_size, data + offset));
+		/* every transaction goes to a separate group */
+		m0_be_tx_close_sync(&tx);
+		m0_be_tx_fini(&tx);
+	}
+	m0_be_ut_backend_fini(&ut_be);
+	m0_fi_disable("m0_be_group_format_seg_place", "skip_place");
+	return addr;
+}
+
+/**
+ * Recovery of groups with overlapping regions by several recovery groups.
+ * @see be_engine_group_may_reapply()
+ */
+void m0_be_ut_recovery_engine(void)
+{
+	struct be_ut_recovery_reapplied *ri;
+	struct be_ut_recovery_reapplied *rj;
+	struct m0_be_ut_backend          ut_be = {};
+	struct m0_be_domain_cfg          cfg   = {};
+	struct m0_be_seg                *seg;
+	m0_bcount_t                      area;
+	void                            *addr;
+	char                            *expected;
+	int                              rc;
+	int                              i;
+	int                              j;
+
+	area = be_ut_recovery_engine_area(BE_UT_RECOVERY_ENGINE_TX_NR,
+					  BE_UT_RECOVERY_ENGINE_REG_SIZE);
+	expected = m0_alloc(area);
+	M0_UT_ASSERT(expected != NULL);
+	be_ut_recovery_engine_cfg(&cfg, BE_UT_RECOVERY_ENGINE_GROUP_NR,
+				  1 << 27);
+	addr = be_ut_recovery_engine_crash(&cfg, BE_UT_RECOVERY_ENGINE_SEG_SIZE,
+					   BE_UT_RECOVERY_ENGINE_TX_NR,
+					   BE_UT_RECOVERY_ENGINE_REG_SIZE,
+					   expected);
+
+	be_ut_recovery_reapplied_nr = 0;
+	rc = m0_be_ut_backend_init_cfg(&ut_be, &cfg, false);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(be_ut_recovery_reapplied_nr >=
+		     BE_UT_RECOVERY_ENGINE_TX_NR);
+	M0_UT_ASSERT(be_ut_recovery_reapplied_nr <=
+		     ARRAY_SIZE(be_ut_recovery_reapplied));
+	seg = m0_be_domain_seg(&ut_be.but_dom, addr);
+	M0_UT_ASSERT(seg != NULL);
+	M0_UT_ASSERT(memcmp(seg->bs_addr + seg->bs_reserved,
+			    expected, area) == 0);
+	/*
+	 * TGS_REAPPLY_WAIT: a group re-applied before a group from an earlier
+	 * log record must not intersect with it.
+	 */
+	for (i = 0; i < be_ut_recovery_reapplied_nr; ++i) {
+		ri = &be_ut_recovery_reapplied[i];
+		for (j = i + 1; j < be_ut_recovery_reapplied_nr; ++j) {
+			rj = &be_ut_recovery_reapplied[j];
+			M0_UT_ASSERT(ri->burr_pos != rj->burr_pos);
+			M0_UT_ASSERT(ri->burr_pos < rj->burr_pos ||
+				     ri->burr_end <= rj->burr_start ||
+				     rj->burr_end <= ri->burr_start);
+		}
+	}
+	m0_be_ut_backend_seg_del(&ut_be, seg);
+	m0_be_ut_backend_fini(&ut_be);
+	m0_free(expected);
+}
+
+enum {
+	BE_UB_RECOVERY_LIO_SIZE  = 4 * 1024 * 1024,
+	/* ~2GB of log records */
+	BE_UB_RECOVERY_RECORD_NR = 512,
+	/* header, footer and paddings of a log record fit into this */
+	BE_UB_RECOVERY_OVERHEAD  = 64 * 1024,
+	/* ~64MB of groups to re-apply */
+	BE_UB_RECOVERY_TX_NR     = 256,
+	BE_UB_RECOVERY_REG_SIZE  = 256 * 1024,
+	BE_UB_RECOVERY_SEG_SIZE  = 1 << 26,
+	BE_UB_RECOVERY_LOG_SIZE  = 1 << 28,
+};
+
+static struct be_ut_recovery_ctx be_ub_recovery_ctx;
+static struct m0_be_domain_cfg   be_ub_recovery_be_cfg;
+
+/**
+ * Writes BE_UB_RECOVERY_RECORD_NR records of BE_UB_RECOVERY_LIO_SIZE bytes.
+ * None of them is discarded, so all of them are found on the next log open.
+ */
+static void be_ub_recovery_log_fill(struct be_ut_recovery_ctx *ctx)
+{
+	struct m0_be_log        *log  = &ctx->burc_log;
+	struct m0_mutex         *lock = &ctx->burc_lock;
+	struct m0_be_log_record  record = {};
+	m0_bcount_t              lio_size = ctx->burc_lio_size;
+	m0_bcount_t              reserved;
+	int                      rc;
+	int                      i;
+
+	be_ut_recovery_log_record_init_one(&record, log, lio_size);
+	reserved = m0_be_log_reserved_size(log, &lio_size, 1);
+	for (i = 0; i < BE_UB_RECOVERY_RECORD_NR; ++i) {
+		m0_mutex_lock(lock);
+		rc = m0_be_log_reserve(log, reserved);
+		M0_UB_ASSERT(rc == 0);
+		m0_be_log_record_io_size_set(&record, 0, lio_size);
+		m0_be_log_record_io_prepare(&record, SIO_WRITE, reserved);
+		m0_mutex_unlock(lock);
+		rc = M0_BE_OP_SYNC_RET(op,
+				       m0_be_log_record_io_launch(&record, &op),
+				       bo_sm.sm_rc);
+		M0_UB_ASSERT(rc == 0);
+		m0_mutex_lock(lock);
+		m0_be_log_record_skip_discard(&record);
+		m0_mutex_unlock(lock);
+		m0_be_log_record_reset(&record);
+	}
+	be_ut_recovery_log_record_fini_one(&record);
+}
+
+static int be_ub_recovery_init(const char *opts M0_UNUSED)
+{
+	struct be_ut_recovery_ctx *ctx = &be_ub_recovery_ctx;
+	char                      *expected;
+
+	*ctx = (struct be_ut_recovery_ctx){
+		.burc_log_size = (m0_bcount_t)BE_UB_RECOVERY_RECORD_NR *
+				 (BE_UB_RECOVERY_LIO_SIZE +
+				  BE_UB_RECOVERY_OVERHEAD) +
+				 BE_UT_RECOVERY_LOG_SIZE,
+		.burc_lio_size = BE_UB_RECOVERY_LIO_SIZE,
+	};
+	be_ut_recovery_log_init(ctx);
+	be_ub_recovery_log_fill(ctx);
+
+	expected = m0_alloc(be_ut_recovery_engine_area(BE_UB_RECOVERY_TX_NR,
+						       BE_UB_RECOVERY_REG_SIZE));
+	M0_UB_ASSERT(expected != NULL);
+	be_ut_recovery_engine_cfg(&be_ub_recovery_be_cfg, 1,
+				  BE_UB_RECOVERY_LOG_SIZE);
+	(void)be_ut_recovery_engine_crash(&be_ub_recovery_be_cfg,
+					  BE_UB_RECOVERY_SEG_SIZE,
+					  BE_UB_RECOVERY_TX_NR,
+					  BE_UB_RECOVERY_REG_SIZE, expected);
+	m0_free(expected);
+	return 0;
+}
+
+static void be_ub_recovery_fini(void)
+{
+	be_ut_recovery_log_fini(&be_ub_recovery_ctx);
+}
+
+/** Finds all records in the log without reading them. */
+static void be_ub_recovery_scan(int iter M0_UNUSED)
+{
+	struct be_ut_recovery_ctx    *ctx   = &be_ub_recovery_ctx;
+	struct m0_be_log_record_iter  riter = {};
+	int                           count = 0;
+	int                           rc;
+
+	ctx->burc_read_nr_max = 1;
+	be_ut_recovery_log_reopen(ctx);
+	rc = m0_be_log_record_iter_init(&riter);
+	M0_UB_ASSERT(rc == 0);
+	while (m0_be_log_recovery_record_available(&ctx->burc_log)) {
+		m0_be_log_recovery_record_get(&ctx->burc_log, &riter);
+		++count;
+	}
+	m0_be_log_record_iter_fini(&riter);
+	M0_UB_ASSERT(count == BE_UB_RECOVERY_RECORD_NR);
+}
+
+/**
+ * Starts the backend left by be_ut_recovery_engine_crash(). Recovery reads,
+ * reconstructs and re-applies all the groups using "group_nr" groups.
+ */
+static void be_ub_recovery_replay(int group_nr)
+{
+	struct m0_be_domain_cfg *cfg   = &be_ub_recovery_be_cfg;
+	struct m0_be_ut_backend  ut_be = {};
+	int                      rc;
+
+	cfg->bc_engine.bec_group_nr          = group_nr;
+	cfg->bc_engine.bec_recovery_group_nr = group_nr;
+	be_ut_recovery_reapplied_nr = 0;
+	/* re-applied groups are not placed, so the next round replays them */
+	m0_fi_enable("m0_be_group_format_seg_place", "skip_place");
+	rc = m0_be_ut_backend_init_cfg(&ut_be, cfg, false);
+	M0_UB_ASSERT(rc == 0);
+	M0_UB_ASSERT(be_ut_recovery_reapplied_nr >= BE_UB_RECOVERY_TX_NR);
+	m0_be_ut_backend_fini(&ut_be);
+	m0_fi_disable("m0_be_group_format_seg_place", "skip_place");
+}
+
+static void be_ub_recovery_replay_1(int iter M0_UNUSED)
+{
+	be_ub_recovery_replay(1);
+}
+
+static void be_ub_recovery_replay_4(int iter M0_UNUSED)
+{
+	be_ub_recovery_replay(4);
+}
+
+static void be_ub_recovery_replay_16(int iter M0_UNUSED)
+{
+	be_ub_recovery_replay(16);
+}
+
+/**
+ * Recovery benchmark. "scan" finds all records of a synthetic log without
+ * reading them. "replay-N" runs BE recovery of a backend stopped with
+ * unplaced groups: log records are read, reconstructed and re-applied by N
+ * groups (m0_be_engine_cfg::bec_recovery_group_nr).
+ */
+struct m0_ub_set m0_be_recovery_ub = {
+	.us_name = "be-recovery-ub",
+	.us_init = be_ub_recovery_init,
+	.us_fini = be_ub_recovery_fini,
+	.us_run  = {
+		{ .ub_name  = "scan",
+		  .ub_iter  = 1,
+		  .ub_round = be_ub_recovery_scan },
+
+		{ .ub_name  = "replay-1",
+		  .ub_iter  = 1,
+		  .ub_round = be_ub_recovery_replay_1 },
+
+		{ .ub_name  = "replay-4",
+		  .ub_iter  = 1,
+		  .ub_round = be_ub_recovery_replay_4 },
+
+		{ .ub_name  = "replay-16",
+		  .ub_iter  = 1,
+		  .ub_round = be_ub_recovery_replay_16 },
+
+		{ .ub_name = NULL }
+	}
+};
+
+#undef M0_TRACE_SUBSYSTEM
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
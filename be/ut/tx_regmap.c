@@ -975,6 +975,22 @@ static void be_ut_reg_area_merge_post(struct m0_be_reg_area *ra)
 	M0_UT_ASSERT(cmp == 0);
 }
 
+static void be_ut_reg_area_intersects_check(struct m0_be_reg_area *ra1,
+					    struct m0_be_reg_area *ra2)
+{
+	static unsigned char arr1[BE_UT_RA_MERGE_SIZE_TOTAL];
+	static unsigned char arr2[BE_UT_RA_MERGE_SIZE_TOTAL];
+	bool                 expected = false;
+	int                  i;
+
+	be_ut_reg_area_arr_copy(arr1, ARRAY_SIZE(arr1), ra1, true);
+	be_ut_reg_area_arr_copy(arr2, ARRAY_SIZE(arr2), ra2, true);
+	for (i = 0; i < ARRAY_SIZE(arr1); ++i)
+		expected |= arr1[i] != 0 && arr2[i] != 0;
+	M0_UT_ASSERT(m0_be_reg_area_intersects(ra1, ra2) == expected);
+	M0_UT_ASSERT(m0_be_reg_area_intersects(ra2, ra1) == expected);
+}
+
 void m0_be_ut_reg_area_merge(void)
 {
 	static struct m0_be_reg_area ra;
@@ -1014,6 +1030,8 @@ void m0_be_ut_reg_area_merge(void)
 		/* create random reg_areas */
 		for (i = 0; i < ARRAY_SIZE(mra); ++i)
 			be_ut_reg_area_merge_rand_ra(&mra[i]);
+		for (i = 0; i + 1 < ARRAY_SIZE(mra); ++i)
+			be_ut_reg_area_intersects_check(&mra[i], &mra[i + 1]);
 		/* merge it with ra */
 		for (i = 0; i < ARRAY_SIZE(mra); ++i) {
 #if BE_UT_RA_MERGE_DEBUG
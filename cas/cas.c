@@ -116,6 +116,14 @@ static int cas_fops_init(const struct m0_sm_conf           *sm_conf,
 			 .fom_ops   = &m0_fsync_fom_ops,
 #endif
 			 .rpc_flags = M0_RPC_ITEM_TYPE_REQUEST);
+#ifndef __KERNEL__
+	/*
+	 * Read-only requests can be executed in any locality. Whether they are
+	 * actually moved is controlled by m0_fom_domain_steal_enable().
+	 */
+	cas_get_fopt.ft_fom_type.ft_stealable = true;
+	cas_cur_fopt.ft_fom_type.ft_stealable = true;
+#endif
 	return  m0_fop_type_addb2_instrument(&cas_get_fopt) ?:
 		m0_fop_type_addb2_instrument(&cas_put_fopt) ?:
 		m0_fop_type_addb2_instrument(&cas_del_fopt) ?:
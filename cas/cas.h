@@ -343,6 +343,13 @@ enum m0_cas_op_flags {
 	 * NO DTM is needed for this operation.
 	 */
 	COF_NO_DTM = 1 << 11,
+	/**
+	 * For NEXT operation, allows CAS service to return a partial reply
+	 * instead of failing with -E2BIG when the requested records do not fit
+	 * into one RPC item. The reply is cut after the last record that fits,
+	 * see m0_cas_rep::cgr_cur_partial.
+	 */
+	COF_PARTIAL = 1 << 12,
 };
 
 enum m0_cas_opcode {
@@ -449,6 +456,25 @@ struct m0_cas_rep {
 
 	/** Returned values for an UPDATE operation, such as CAS-PUT. */
 	struct m0_fop_mod_rep   cgr_mod_rep;
+
+	/**
+	 * Non-zero if CAS-CUR reply with ::COF_PARTIAL was cut because of RPC
+	 * item size limit.
+	 *
+	 * In this case input records before cgr_cur_ipos are processed
+	 * completely, cgr_cur_nr records are returned for the input record
+	 * cgr_cur_ipos and following input records are not processed. There
+	 * are no zeroed records at the end of the reply.
+	 *
+	 * @note These fields change the on-wire layout of m0_cas_rep. A CAS
+	 * client and service built with and without them cannot decode each
+	 * other's replies, so they must be upgraded together. A service
+	 * without COF_PARTIAL support ignores the flag and fails an oversized
+	 * CAS-CUR with -E2BIG as before.
+	 */
+	uint32_t                cgr_cur_partial;
+	uint32_t                cgr_cur_ipos;
+	uint32_t                cgr_cur_nr;
 } M0_XCA_RECORD M0_XCA_DOMAIN(rpc);
 
 M0_EXTERN struct m0_reqh_service_type m0_cas_service_type;
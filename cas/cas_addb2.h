@@ -60,6 +60,11 @@ enum m0_avi_cas_labels {
 	M0_AVI_CAS_FOM_ATTR_OUT_INLINE_VALS_NR,
 	M0_AVI_CAS_FOM_ATTR_OUT_BULK_VALS_NR,
 	M0_AVI_CAS_FOM_ATTR_OUT_VALS_SIZE,
+
+	/** Negative-lookup filter statistics, see m0_ctg_filter_stats(). */
+	M0_AVI_CAS_CTG_FILTER,
+	/** Negative-lookup filter (re)built by a catalogue scan. */
+	M0_AVI_CAS_CTG_FILTER_BUILD,
 } M0_XCA_ENUM;
 
 
@@ -276,6 +276,10 @@ static void cas_req_fini(struct m0_cas_req *req)
 			m0_fop_put_lock(req->ccr_fop);
 		}
 	}
+	if (m0_rpc_at_is_set(&req->ccr_cur_rec.cr_key))
+		creq_recv_fini(&(struct m0_cas_recv) {
+					.cr_nr  = 1,
+					.cr_rec = &req->ccr_cur_rec }, false);
 	if (req->ccr_req_op != NULL) {
 		/* Restore records vector for proper freeing. */
 		req->ccr_req_op->cg_rec = req->ccr_rec_orig;
@@ -496,6 +500,13 @@ static int cas_rep__validate(const struct m0_fop_type *ftype,
 			sum += op->cg_rec.cr_rec[i].cr_rc;
 		if (rep->cgr_rep.cr_nr > sum)
 			return M0_ERR(-EPROTO);
+		if (rep->cgr_cur_partial &&
+		    (rep->cgr_rep.cr_nr == 0 ||
+		     rep->cgr_cur_ipos >= op->cg_rec.cr_nr ||
+		     rep->cgr_cur_nr > rep->cgr_rep.cr_nr ||
+		     rep->cgr_cur_nr >=
+		     op->cg_rec.cr_rec[rep->cgr_cur_ipos].cr_rc))
+			return M0_ERR(-EPROTO);
 		for (i = 0; i < rep->cgr_rep.cr_nr; i++) {
 			rec = &rep->cgr_rep.cr_rec[i];
 			if ((int32_t)rec->cr_rc > 0 &&
@@ -801,6 +812,27 @@ static void creq_niter_fini(struct creq_niter *it)
 	M0_SET0(it);
 }
 
+/**
+ * Returns true if 'op' requests the rest of records for a NEXT start key,
+ * which reply was cut by CAS service.
+ */
+static bool nreq_is_cont(const struct m0_cas_req *req,
+			 const struct m0_cas_op  *op)
+{
+	return op->cg_rec.cr_rec == &req->ccr_cur_rec;
+}
+
+/**
+ * Returns index in the original records vector of the record 'idx' of the
+ * last sent operation 'op'.
+ */
+static uint64_t creq_orig_idx(const struct m0_cas_req *req,
+			      const struct m0_cas_op  *op,
+			      uint64_t                 idx)
+{
+	return req->ccr_sent_recs_nr - op->cg_rec.cr_nr + idx;
+}
+
 /**
  * Sets starting keys and allocates space for key/values AT buffers expected in
  * reply.
@@ -814,12 +846,19 @@ static int nreq_asmbl_prep(struct m0_cas_req *req, struct m0_cas_op *op)
 
 	M0_PRE(op->cg_rec.cr_nr == orig->cg_rec.cr_nr);
 	op->cg_id = orig->cg_id;
+	/* Starting keys should be interpreted the same way. */
+	op->cg_flags = orig->cg_flags;
 	for (i = 0; i < orig->cg_rec.cr_nr; i++) {
 		rec = &op->cg_rec.cr_rec[i];
 		M0_ASSERT(M0_IS0(rec));
 		rec->cr_rc = orig->cg_rec.cr_rec[i].cr_rc;
 		m0_rpc_at_init(&rec->cr_key);
-		rc = creq_kv_buf_add(req, req->ccr_keys, i, &rec->cr_key);
+		rc = nreq_is_cont(req, orig) ?
+			m0_rpc_at_add(&rec->cr_key, &req->ccr_cur_key,
+				      creq_rpc_conn(req)) :
+			creq_kv_buf_add(req, req->ccr_keys,
+					creq_orig_idx(req, orig, i),
+					&rec->cr_key);
 		if (rc != 0)
 			goto err;
 		M0_ALLOC_ARR(rec->cr_kv_bufs.cv_rec, rec->cr_rc);
@@ -977,7 +1016,8 @@ static void nreq_asmbl_accept(struct m0_cas_req *req)
 
 	i = 0;
 	creq_niter_init(&iter, op, rep);
-	while (creq_niter_next(&iter) != -ENOENT) {
+	/* Assembly reply may be cut at another place than the original one. */
+	while (creq_niter_next(&iter) != -ENOENT && i < crep->cgr_rep.cr_nr) {
 		rcvd = iter.cni_rep;
 		sent = iter.cni_req;
 		if ((int32_t)rcvd->cr_rc > 0) {
@@ -1039,6 +1079,94 @@ static void cas_req_fsync_remid_copy(struct m0_cas_req *req)
 	req->ccr_remid = rep->cgr_mod_rep.fmr_remid;
 }
 
+/**
+ * Handles NEXT reply that may be cut by CAS service (see COF_PARTIAL).
+ *
+ * Records of the start keys before the cut one are complete and are not
+ * requested again. If some records are received for the cut start key, then
+ * the rest of them is requested starting from the last received key: 'op' is
+ * prepared for that and '*cont' is set.
+ *
+ * A key sent via bulk is available only if the assembly request succeeded
+ * (see nreq_asmbl_accept()). Records received after the last available key
+ * are dropped and requested again. If no key of the cut start key is
+ * available, then the start key is resent as is.
+ */
+static int nreq_partial_handle(struct m0_cas_req       *req,
+			       struct m0_cas_op        *op,
+			       const struct m0_cas_rep *rcvd,
+			       uint64_t                 seed,
+			       bool                    *cont)
+{
+	struct m0_cas_recv *repv = &req->ccr_reply.cgr_rep;
+	struct m0_cas_rec  *last = NULL;
+	uint64_t            got = 0;
+	uint64_t            left;
+	uint64_t            drop;
+	uint64_t            i;
+	int                 rc;
+
+	*cont = false;
+	if (nreq_is_cont(req, op)) {
+		/* CAS service numbers records of the continuation from 1. */
+		got = req->ccr_cur_got;
+		for (i = seed; i < repv->cr_nr &&
+			     repv->cr_rec[i].cr_rc == i - seed + 1; i++)
+			repv->cr_rec[i].cr_rc += got;
+		creq_recv_fini(&op->cg_rec, false);
+		op->cg_flags = req->ccr_cur_flags;
+	}
+	if (!rcvd->cgr_cur_partial)
+		return 0;
+	left = op->cg_rec.cr_rec[rcvd->cgr_cur_ipos].cr_rc - rcvd->cgr_cur_nr;
+	req->ccr_sent_recs_nr = creq_orig_idx(req, op, rcvd->cgr_cur_ipos);
+	if (rcvd->cgr_cur_nr == 0)
+		/* Nothing is received for the start key, resend it as is. */
+		return 0;
+	for (drop = 0; drop < rcvd->cgr_cur_nr; drop++) {
+		last = &repv->cr_rec[repv->cr_nr - 1 - drop];
+		if ((int32_t)last->cr_rc > 0 &&
+		    last->cr_key.ab_type == M0_RPC_AT_INLINE)
+			break;
+	}
+	if (drop == rcvd->cgr_rep.cr_nr) {
+		/*
+		 * Nothing would be left from this reply, so the same reply
+		 * would come again. Return the records as is (they carry
+		 * their errors) and finish the start key.
+		 */
+		req->ccr_sent_recs_nr++;
+		return M0_RC(0);
+	}
+	for (i = repv->cr_nr - drop; i < repv->cr_nr; i++) {
+		m0_rpc_at_fini(&repv->cr_rec[i].cr_key);
+		m0_rpc_at_fini(&repv->cr_rec[i].cr_val);
+		M0_SET0(&repv->cr_rec[i]);
+	}
+	repv->cr_nr -= drop;
+	if (drop == rcvd->cgr_cur_nr)
+		/*
+		 * Other start keys made progress, resend this one as is. A
+		 * continuation has the only start key, so it is not the case.
+		 */
+		return M0_RC(0);
+	left += drop;
+	M0_SET0(&req->ccr_cur_rec);
+	m0_rpc_at_init(&req->ccr_cur_rec.cr_key);
+	rc = m0_rpc_at_add(&req->ccr_cur_rec.cr_key, &last->cr_key.u.ab_buf,
+			   creq_rpc_conn(req));
+	if (rc != 0)
+		return M0_ERR(rc);
+	req->ccr_cur_key       = last->cr_key.u.ab_buf;
+	req->ccr_cur_rec.cr_rc = left;
+	req->ccr_cur_got       = got + rcvd->cgr_cur_nr - drop;
+	op->cg_rec.cr_nr  = 1;
+	op->cg_rec.cr_rec = &req->ccr_cur_rec;
+	op->cg_flags = req->ccr_cur_flags | COF_SLANT | COF_EXCLUDE_START_KEY;
+	*cont = true;
+	return M0_RC(0);
+}
+
 static int cas_req_reply_handle(struct m0_cas_req *req,
 				bool              *fragm_continue)
 {
@@ -1048,6 +1176,7 @@ static int cas_req_reply_handle(struct m0_cas_req *req,
 	struct m0_cas_op   *op = m0_fop_data(req_fop);
 	uint64_t            i;
 	uint64_t            reply_seed;
+	bool                cont = false;
 	int                 rc = 0;
 
 	M0_ASSERT(req_fop->f_type == req->ccr_ftype);
@@ -1070,6 +1199,9 @@ static int cas_req_reply_handle(struct m0_cas_req *req,
 		creq_kv_hold_down(&rcvd_reply->cgr_rep.cr_rec[i]);
 	}
 	reply->cgr_rep.cr_nr += rcvd_reply->cgr_rep.cr_nr;
+	if (req_fop->f_type == &cas_cur_fopt && !req->ccr_is_meta)
+		rc = nreq_partial_handle(req, op, rcvd_reply, reply_seed,
+					 &cont);
 	/* Roger, reply item is not needed anymore. */
 	m0_rpc_item_put_lock(req->ccr_reply_item);
 	req->ccr_reply_item = NULL;
@@ -1080,7 +1212,16 @@ static int cas_req_reply_handle(struct m0_cas_req *req,
 	req_fop->f_data.fd_data = NULL;
 	m0_fop_put_lock(req_fop);
 	req->ccr_fop = NULL;
-	if (req->ccr_sent_recs_nr < req->ccr_rec_orig.cr_nr) {
+	if (rc != 0)
+		return M0_ERR(rc);
+	if (cont) {
+		/* Request the rest of records for the cut start key. */
+		rc = creq_fop_create(req, req->ccr_ftype, op);
+		if (rc == 0) {
+			cas_fop_send(req);
+			*fragm_continue = true;
+		}
+	} else if (req->ccr_sent_recs_nr < req->ccr_rec_orig.cr_nr) {
 		/* Continue fragmentation. */
 		rc = cas_req_fragment_continue(req, op);
 		if (rc == 0)
@@ -1859,6 +2000,12 @@ M0_INTERNAL int m0_cas_next(struct m0_cas_req *req,
 		return M0_ERR(rc);
 	for (i = 0; i < start_keys->ov_vec.v_nr; i++)
 		op->cg_rec.cr_rec[i].cr_rc = recs_nr[i];
+	/*
+	 * Let CAS service return as many records as fit into one reply
+	 * instead of failing, the rest is requested by nreq_partial_handle().
+	 */
+	op->cg_flags |= COF_PARTIAL;
+	req->ccr_cur_flags = op->cg_flags;
 	req->ccr_keys = start_keys;
 	rc = creq_fop_create_and_prepare(req, &cas_cur_fopt, op,
 					 &next_state);
@@ -162,6 +162,17 @@ struct m0_cas_req {
 	 * request. It's used only to assemble "GET" request.
 	 */
 	uint64_t               *ccr_asmbl_ikeys;
+	/**
+	 * Request for the rest of records of a NEXT start key, which reply was
+	 * cut by CAS service (see COF_PARTIAL). Its start key is the last
+	 * received one, ->ccr_cur_key.
+	 */
+	struct m0_cas_rec       ccr_cur_rec;
+	struct m0_buf           ccr_cur_key;
+	/** Number of records received for the start key before the cut. */
+	uint64_t                ccr_cur_got;
+	/** Flags of the original NEXT request. */
+	uint32_t                ccr_cur_flags;
 	/* Returned tx REMID inforation from service to update FSYNC records. */
 	struct m0_be_tx_remid  ccr_remid;
 };
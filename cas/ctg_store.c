@@ -22,18 +22,26 @@
 
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_CAS
 
+#include <stdlib.h>                  /* qsort */
+
 #include "lib/trace.h"
 #include "lib/memory.h"
 #include "lib/finject.h"
 #include "lib/assert.h"
 #include "lib/errno.h"               /* ENOMEM, EPROTO */
 #include "lib/ext.h"                 /* m0_ext */
+#include "lib/cksum.h"               /* m0_xxh64 */
+#include "lib/atomic.h"
+#include "lib/arith.h"               /* m0_log2 */
+#include "addb2/addb2.h"
 #include "be/domain.h"               /* m0_be_domain_seg_first */
 #include "be/op.h"
 #include "module/instance.h"
+#include "fop/fom.h"                 /* m0_fom_block_enter */
 #include "fop/fom_long_lock.h"       /* m0_long_lock */
 #include "cas/ctg_store.h"
 #include "cas/index_gc.h"
+#include "cas/cas_addb2.h"           /* M0_AVI_CAS_CTG_FILTER */
 #include "dix/fid_convert.h"        /* m0_dix_fid_convert_cctg2dix */
 #include "motr/setup.h"
 
@@ -76,6 +84,9 @@ struct m0_ctg_store {
 	 * Flag indicating whether catalogue store is initialised or not.
 	 */
 	bool                 cs_initialised;
+
+	/** Whether user catalogues get negative-lookup filters. */
+	bool                 cs_filter;
 };
 
 /* Data schema for CAS catalogues { */
@@ -131,6 +142,60 @@ enum cursor_phase {
 	CPH_NEXT
 };
 
+enum {
+	/** Counters per key of filter capacity. */
+	CTG_FILTER_CNT_PER_KEY = 10,
+	/** Hashes per key, ~0.8% false positives at full capacity. */
+	CTG_FILTER_HASH_NR     = 7,
+	/** Minimal filter capacity, in keys. */
+	CTG_FILTER_KEYS_MIN    = 1024,
+	/** Statistics are posted to ADDB2 once per this many lookups. */
+	CTG_FILTER_REPORT      = 1 << 16,
+	CTG_FILTER_SEED        = 0x6374676c,
+};
+
+/**
+ * Negative-lookup filter of a user catalogue: a counting Bloom filter over the
+ * keys (in on-disk format) stored in the catalogue btree.
+ *
+ * A key sets CTG_FILTER_HASH_NR counters, derived from a single 64-bit hash by
+ * double hashing. Counters (rather than bits) make deletion possible. A counter
+ * that reached UINT8_MAX sticks there, which can only cause false positives.
+ * Only keys new to the btree are added: an overwriting put updates the record
+ * if the filter may contain the key and inserts it otherwise, falling back to
+ * the other operation if the first one fails; a versioned put or delete over
+ * an existing record (or tombstone) leaves the filter as is.
+ * The filter is rebuilt with twice the number of keys as capacity when cfl_nr
+ * exceeds cfl_cap.
+ *
+ * Modifications of the filter are done under the exclusive catalogue lock,
+ * taken by the store users for insert and delete. Lookups are done under the
+ * shared lock, concurrently with each other, and may need to (re)build the
+ * filter; the lookup that sets cfl_building does it. The build scans the
+ * whole btree, so the lookup FOM does it in blocking mode
+ * (m0_fom_block_enter()), letting the locality run other FOMs meanwhile;
+ * concurrent lookups bypass the filter until it is ready.
+ */
+struct m0_ctg_filter {
+	/** Non-zero while a lookup (re)builds the filter. */
+	struct m0_atomic64 cfl_building;
+	/**
+	 * Non-zero if the counters are valid, i.e., reflect every key in the
+	 * btree. See ctg_filter_is_ready() and ctg_filter_ready_set().
+	 */
+	struct m0_atomic64 cfl_ready;
+	/** log2 of the number of counters. */
+	unsigned           cfl_shift;
+	uint8_t           *cfl_cnt;
+	/** Keys added to the filter minus keys deleted from it. */
+	uint64_t           cfl_nr;
+	uint64_t           cfl_cap;
+	uint64_t           cfl_builds;
+	struct m0_atomic64 cfl_lookups;
+	struct m0_atomic64 cfl_negatives;
+	struct m0_atomic64 cfl_false_pos;
+};
+
 static struct m0_be_seg *cas_seg(struct m0_be_domain *dom);
 
 static bool ctg_op_is_versioned(const struct m0_ctg_op *op);
@@ -405,6 +470,282 @@ static int ctg_cmp(const void *opaque_key_left, const void *opaque_key_right)
 		M0_3WAY(left->gk_length, right->gk_length);
 }
 
+static uint64_t ctg_filter_hash(const struct m0_buf *key)
+{
+	return m0_xxh64(key->b_addr, key->b_nob, CTG_FILTER_SEED);
+}
+
+/** Returns the i-th counter of a key with the given hash. */
+static uint8_t *ctg_filter_cnt(const struct m0_ctg_filter *flt, uint64_t hash,
+			       unsigned i)
+{
+	uint64_t h1 = hash & 0xffffffff;
+	uint64_t h2 = (hash >> 32) | 1;
+
+	return &flt->cfl_cnt[(h1 + i * h2) & ((1ULL << flt->cfl_shift) - 1)];
+}
+
+static bool ctg_filter_test(const struct m0_ctg_filter *flt, uint64_t hash)
+{
+	unsigned i;
+
+	for (i = 0; i < CTG_FILTER_HASH_NR; ++i) {
+		if (*ctg_filter_cnt(flt, hash, i) == 0)
+			return false;
+	}
+	return true;
+}
+
+static void ctg_filter_inc(struct m0_ctg_filter *flt, uint64_t hash)
+{
+	uint8_t *cnt;
+	unsigned i;
+
+	for (i = 0; i < CTG_FILTER_HASH_NR; ++i) {
+		cnt = ctg_filter_cnt(flt, hash, i);
+		if (*cnt != UINT8_MAX)
+			++*cnt;
+	}
+}
+
+static void ctg_filter_dec(struct m0_ctg_filter *flt, uint64_t hash)
+{
+	uint8_t *cnt;
+	unsigned i;
+
+	for (i = 0; i < CTG_FILTER_HASH_NR; ++i) {
+		cnt = ctg_filter_cnt(flt, hash, i);
+		M0_ASSERT(*cnt != 0);
+		if (*cnt != UINT8_MAX)
+			--*cnt;
+	}
+}
+
+/**
+ * Returns true if the filter is ready. Counters written before the filter was
+ * made ready by ctg_filter_ready_set() are visible to the caller.
+ */
+static bool ctg_filter_is_ready(const struct m0_ctg_filter *flt)
+{
+	bool ready = m0_atomic64_get(&flt->cfl_ready) != 0;
+
+	m0_mb();
+	return ready;
+}
+
+static void ctg_filter_ready_set(struct m0_ctg_filter *flt, bool ready)
+{
+	/* Publish the counters to the lookups which test them concurrently. */
+	m0_mb();
+	m0_atomic64_set(&flt->cfl_ready, ready);
+}
+
+/** Allocates zeroed counters for "nr" keys, the filter becomes ready. */
+static int ctg_filter_reset(struct m0_ctg_filter *flt, uint64_t nr)
+{
+	uint64_t cap = max64u(2 * nr, CTG_FILTER_KEYS_MIN);
+	unsigned shift = m0_log2(cap * CTG_FILTER_CNT_PER_KEY - 1) + 1;
+	uint8_t *cnt;
+
+	M0_PRE(!ctg_filter_is_ready(flt));
+
+	if (flt->cfl_cnt != NULL && flt->cfl_shift == shift) {
+		memset(flt->cfl_cnt, 0, 1ULL << shift);
+	} else {
+		M0_ALLOC_ARR(cnt, 1ULL << shift);
+		if (cnt == NULL)
+			return M0_ERR(-ENOMEM);
+		m0_free(flt->cfl_cnt);
+		flt->cfl_cnt   = cnt;
+		flt->cfl_shift = shift;
+	}
+	flt->cfl_cap = cap;
+	flt->cfl_nr  = 0;
+	return 0;
+}
+
+static void ctg_filter_report(const struct m0_cas_ctg *ctg)
+{
+	struct m0_ctg_filter_stats st;
+
+	if (m0_ctg_filter_stats(ctg, &st))
+		M0_ADDB2_ADD(M0_AVI_CAS_CTG_FILTER, (uint64_t)ctg,
+			     st.cfs_lookups, st.cfs_negatives,
+			     st.cfs_false_pos, st.cfs_keys);
+}
+
+static int ctg_filter_hashes_grow(uint64_t **hash, uint64_t *nr)
+{
+	uint64_t  size = max64u(2 * *nr, CTG_FILTER_KEYS_MIN);
+	uint64_t *area;
+
+	M0_ALLOC_ARR(area, size);
+	if (area == NULL)
+		return M0_ERR(-ENOMEM);
+	if (*hash != NULL)
+		memcpy(area, *hash, *nr * sizeof area[0]);
+	m0_free(*hash);
+	*hash = area;
+	*nr   = size;
+	return 0;
+}
+
+/**
+ * Populates the filter from the catalogue btree. Hashes are collected first,
+ * so that the btree is scanned once and the filter is sized for the actual
+ * number of keys.
+ */
+static int ctg_filter_build(struct m0_cas_ctg *ctg)
+{
+	struct m0_ctg_filter   *flt   = ctg->cc_filter;
+	struct m0_btree_cursor  cur;
+	struct m0_buf           key;
+	uint64_t               *hash  = NULL;
+	uint64_t                size  = 0;
+	uint64_t                nr    = 0;
+	uint64_t                i;
+	m0_time_t               start = m0_time_now();
+	int                     rc;
+
+	M0_PRE(m0_atomic64_get(&flt->cfl_building) != 0);
+	M0_PRE(!ctg_filter_is_ready(flt));
+
+	m0_btree_cursor_init(&cur, ctg->cc_tree);
+	for (rc = m0_btree_cursor_first(&cur); rc == 0;
+	     rc = m0_btree_cursor_next(&cur)) {
+		if (nr == size) {
+			rc = ctg_filter_hashes_grow(&hash, &size);
+			if (rc != 0)
+				break;
+		}
+		m0_btree_cursor_kv_get(&cur, &key, NULL);
+		hash[nr++] = ctg_filter_hash(&key);
+	}
+	m0_btree_cursor_fini(&cur);
+	if (rc == -ENOENT)
+		rc = ctg_filter_reset(flt, nr);
+	if (rc == 0) {
+		for (i = 0; i < nr; ++i)
+			ctg_filter_inc(flt, hash[i]);
+		flt->cfl_nr = nr;
+		flt->cfl_builds++;
+		ctg_filter_ready_set(flt, true);
+		M0_ADDB2_ADD(M0_AVI_CAS_CTG_FILTER_BUILD, (uint64_t)ctg, nr,
+			     1ULL << flt->cfl_shift,
+			     m0_time_sub(m0_time_now(), start));
+	}
+	m0_free(hash);
+	return M0_RC(rc);
+}
+
+static void ctg_filter_init(struct m0_cas_ctg *ctg)
+{
+	struct m0_ctg_filter *flt;
+
+	M0_PRE(ctg->cc_filter == NULL);
+
+	if (!ctg_store.cs_filter)
+		return;
+	M0_ALLOC_PTR(flt);
+	if (flt == NULL)
+		return;
+	m0_atomic64_set(&flt->cfl_building, 0);
+	m0_atomic64_set(&flt->cfl_ready, 0);
+	m0_atomic64_set(&flt->cfl_lookups, 0);
+	m0_atomic64_set(&flt->cfl_negatives, 0);
+	m0_atomic64_set(&flt->cfl_false_pos, 0);
+	ctg->cc_filter = flt;
+}
+
+static void ctg_filter_fini(struct m0_cas_ctg *ctg)
+{
+	struct m0_ctg_filter *flt = ctg->cc_filter;
+
+	if (flt == NULL)
+		return;
+	if (m0_atomic64_get(&flt->cfl_lookups) != 0)
+		ctg_filter_report(ctg);
+	m0_free(flt->cfl_cnt);
+	m0_free0(&ctg->cc_filter);
+}
+
+/**
+ * Returns false iff the key is definitely not in the catalogue. Builds the
+ * filter if it is not ready, unless another lookup is building it already.
+ * The build is done with the FOM blocked, off the locality handler thread, so
+ * a lookup without a FOM or with the FOM blocked already does not build it.
+ */
+static bool ctg_filter_may_contain(struct m0_cas_ctg   *ctg,
+				   struct m0_fom       *fom,
+				   const struct m0_buf *key)
+{
+	struct m0_ctg_filter *flt = ctg->cc_filter;
+	bool                  found;
+	int64_t               nr;
+
+	if (!ctg_filter_is_ready(flt)) {
+		if (fom == NULL || m0_fom_is_blocked(fom) ||
+		    !m0_atomic64_cas((int64_t *)&flt->cfl_building.a_value,
+				     0, 1))
+			return true;
+		m0_fom_block_enter(fom);
+		if (!ctg_filter_is_ready(flt))
+			(void)ctg_filter_build(ctg);
+		m0_fom_block_leave(fom);
+		m0_atomic64_set(&flt->cfl_building, 0);
+		if (!ctg_filter_is_ready(flt))
+			return true;
+	}
+	found = ctg_filter_test(flt, ctg_filter_hash(key));
+	if (!found)
+		m0_atomic64_inc(&flt->cfl_negatives);
+	nr = m0_atomic64_add_return(&flt->cfl_lookups, 1);
+	if ((nr & (CTG_FILTER_REPORT - 1)) == 0)
+		ctg_filter_report(ctg);
+	return found;
+}
+
+static void ctg_filter_add(struct m0_ctg_filter *flt, const struct m0_buf *key)
+{
+	if (!ctg_filter_is_ready(flt))
+		return;
+	ctg_filter_inc(flt, ctg_filter_hash(key));
+	/* Rebuild a larger filter on the next lookup. */
+	if (++flt->cfl_nr > flt->cfl_cap || M0_FI_ENABLED("filter_full"))
+		ctg_filter_ready_set(flt, false);
+}
+
+static void ctg_filter_del(struct m0_ctg_filter *flt, const struct m0_buf *key)
+{
+	if (!ctg_filter_is_ready(flt))
+		return;
+	ctg_filter_dec(flt, ctg_filter_hash(key));
+	if (flt->cfl_nr > 0)
+		flt->cfl_nr--;
+}
+
+M0_INTERNAL void m0_ctg_filter_enable(bool enable)
+{
+	ctg_store.cs_filter = enable;
+}
+
+M0_INTERNAL bool m0_ctg_filter_stats(const struct m0_cas_ctg    *ctg,
+				     struct m0_ctg_filter_stats *stats)
+{
+	struct m0_ctg_filter *flt = ctg->cc_filter;
+
+	if (flt == NULL)
+		return false;
+	*stats = (struct m0_ctg_filter_stats) {
+		.cfs_lookups   = m0_atomic64_get(&flt->cfl_lookups),
+		.cfs_negatives = m0_atomic64_get(&flt->cfl_negatives),
+		.cfs_false_pos = m0_atomic64_get(&flt->cfl_false_pos),
+		.cfs_keys      = flt->cfl_nr,
+		.cfs_builds    = flt->cfl_builds
+	};
+	return true;
+}
+
 static void ctg_init(struct m0_cas_ctg *ctg, struct m0_be_seg *seg)
 {
 	m0_format_header_pack(&ctg->cc_head, &(struct m0_format_tag){
@@ -417,6 +758,7 @@ static void ctg_init(struct m0_cas_ctg *ctg, struct m0_be_seg *seg)
 	m0_mutex_init(&ctg->cc_chan_guard.bm_u.mutex);
 	m0_chan_init(&ctg->cc_chan.bch_chan, &ctg->cc_chan_guard.bm_u.mutex);
 	ctg->cc_inited = true;
+	ctg->cc_filter = NULL;
 	m0_format_footer_update(ctg);
 }
 
@@ -451,6 +793,7 @@ static void ctg_fini(struct m0_cas_ctg *ctg)
 		M0_ASSERT(rc == 0);
 		m0_free0(&ctg->cc_tree);
 	}
+	ctg_filter_fini(ctg);
 	m0_long_lock_fini(m0_ctg_lock(ctg));
 	m0_chan_fini_lock(&ctg->cc_chan.bch_chan);
 	m0_mutex_fini(&ctg->cc_chan_guard.bm_u.mutex);
@@ -514,9 +857,16 @@ int m0_ctg_create(struct m0_be_seg *seg, struct m0_be_tx *tx,
 		m0_free0(&ctg->cc_tree);
 		ctg_fini(ctg);
 		M0_BE_FREE_PTR_SYNC(ctg, seg, tx);
-	}
-	else
+	} else {
+		if (ctype == CTT_CTG) {
+			/* The catalogue is empty, the filter is ready now. */
+			ctg_filter_init(ctg);
+			if (ctg->cc_filter != NULL &&
+			    ctg_filter_reset(ctg->cc_filter, 0) == 0)
+				ctg_filter_ready_set(ctg->cc_filter, true);
+		}
 		*out = ctg;
+	}
 	return M0_RC(rc);
 }
 
@@ -1074,6 +1424,8 @@ M0_INTERNAL void m0_ctg_try_init(struct m0_cas_ctg *ctg)
 	if (ctg != NULL && !ctg->cc_inited) {
 		M0_LOG(M0_DEBUG, "ctg_init %p", ctg);
 		ctg_open(ctg, cas_seg(ctg_store.cs_be_domain));
+		/* The filter is built on the first lookup. */
+		ctg_filter_init(ctg);
 	} else
 		M0_LOG(M0_DEBUG, "ctg %p zero or inited", ctg);
 	m0_mutex_unlock(&ctg_store.cs_state->cs_ctg_init_mutex.bm_u.mutex);
@@ -1318,6 +1670,8 @@ static int ctg_op_exec_normal(struct m0_ctg_op *ctg_op, int next_phase)
 	struct ctg_op_cb_data      cb_data = {};
 	struct m0_btree_cb         cb      = {};
 	int                        rc      = 0;
+	struct m0_ctg_filter      *flt;
+	bool                       overwrite;
 	void                      *k_ptr;
 	void                      *v_ptr;
 	m0_bcount_t                ksize;
@@ -1339,18 +1693,47 @@ static int ctg_op_exec_normal(struct m0_ctg_op *ctg_op, int next_phase)
 		rec.r_val        = M0_BUFVEC_INIT_BUF(&v_ptr, &vsize);
 		rec.r_crc_type   = M0_BCT_NO_CRC;
 
-		if (!!(ctg_op->co_flags & COF_OVERWRITE)) {
+		/*
+		 * The filter counts new keys only, so with a ready filter an
+		 * overwrite has to know whether the key is new. The filter
+		 * tells which of insert and update is likely to succeed, the
+		 * other one is done only if it fails.
+		 */
+		overwrite = !!(ctg_op->co_flags & COF_OVERWRITE);
+		flt       = ctg_op->co_ctg->cc_filter;
+		if (overwrite && (flt == NULL || !ctg_filter_is_ready(flt))) {
 			rc = M0_BTREE_OP_SYNC_WITH_RC(&kv_op,
 					m0_btree_update(btree, &rec, &cb,
 							BOF_INSERT_IF_NOT_FOUND,
 							&kv_op, tx));
 			M0_ASSERT(rc == 0);
-		}
-		else
+		} else if (overwrite &&
+			   (ctg_filter_test(flt, ctg_filter_hash(key)) ||
+			    M0_FI_ENABLED("filter_maybe"))) {
+			rc = M0_BTREE_OP_SYNC_WITH_RC(&kv_op,
+					m0_btree_update(btree, &rec, &cb, 0,
+							&kv_op, tx));
+			if (rc == -ENOENT) {
+				rc = M0_BTREE_OP_SYNC_WITH_RC(&kv_op,
+					m0_btree_put(btree, &rec, &cb,
+						     &kv_op, tx));
+				ctg_op->co_inserted = rc == 0;
+			}
+			M0_ASSERT(rc == 0);
+		} else {
 			rc = M0_BTREE_OP_SYNC_WITH_RC(&kv_op,
 						      m0_btree_put(btree, &rec,
 								   &cb, &kv_op,
 								   tx));
+			ctg_op->co_inserted = rc == 0;
+			if (rc == -EEXIST && overwrite) {
+				rc = M0_BTREE_OP_SYNC_WITH_RC(&kv_op,
+					m0_btree_update(btree, &rec, &cb,
+							BOF_INSERT_IF_NOT_FOUND,
+							&kv_op, tx));
+				M0_ASSERT(rc == 0);
+			}
+		}
 		m0_be_op_done(beop);
 		break;
 	case CTG_OP_COMBINE(CO_PUT, CT_META): {
@@ -1531,14 +1914,68 @@ static int ctg_op_exec_versioned(struct m0_ctg_op *ctg_op, int next_phase)
 	return M0_RC(M0_FSO_AGAIN);
 }
 
+/** Completes a lookup of a key rejected by the negative-lookup filter. */
+static int ctg_op_filter_miss(struct m0_ctg_op *ctg_op, int next_phase)
+{
+	struct m0_be_op *beop = ctg_beop(ctg_op);
+
+	ctg_op->co_rc = -ENOENT;
+	m0_be_op_active(beop);
+	m0_be_op_done(beop);
+	if (!ctg_op->co_is_versioned)
+		return ctg_op_tick_ret(ctg_op, next_phase);
+	if (next_phase >= 0)
+		m0_fom_phase_set(ctg_op->co_fom, next_phase);
+	return M0_FSO_AGAIN;
+}
+
+/** Reflects the result of an executed operation in the filter. */
+static void ctg_op_filter_update(struct m0_ctg_op *ctg_op)
+{
+	struct m0_ctg_filter *flt = ctg_op->co_ctg->cc_filter;
+	int                   rc  = ctg_op->co_rc;
+
+	switch (ctg_op->co_opcode) {
+	case CO_GET:
+		if (rc == -ENOENT && ctg_filter_is_ready(flt))
+			m0_atomic64_inc(&flt->cfl_false_pos);
+		break;
+	case CO_PUT:
+		if (rc == 0 && ctg_op->co_inserted)
+			ctg_filter_add(flt, &ctg_op->co_key);
+		break;
+	case CO_DEL:
+		/* Versioned delete leaves a tombstone record in the btree. */
+		if (rc == 0 && !ctg_op->co_is_versioned)
+			ctg_filter_del(flt, &ctg_op->co_key);
+		break;
+	}
+}
+
 static int ctg_op_exec(struct m0_ctg_op *ctg_op, int next_phase)
 {
+	int  opc = ctg_op->co_opcode;
+	bool filtered;
+	int  ret;
+
 	M0_ENTRY();
 	ctg_op->co_is_versioned = ctg_op_is_versioned(ctg_op);
+	ctg_op->co_inserted = false;
+	filtered = ctg_op->co_ct == CT_BTREE &&
+		   M0_IN(opc, (CO_GET, CO_PUT, CO_DEL)) &&
+		   ctg_op->co_ctg->cc_filter != NULL;
+
+	if (filtered && opc == CO_GET &&
+	    !ctg_filter_may_contain(ctg_op->co_ctg, ctg_op->co_fom,
+				    &ctg_op->co_key))
+		return ctg_op_filter_miss(ctg_op, next_phase);
 
-	return ctg_op->co_is_versioned ?
+	ret = ctg_op->co_is_versioned ?
 		ctg_op_exec_versioned(ctg_op, next_phase) :
 		ctg_op_exec_normal(ctg_op, next_phase);
+	if (filtered)
+		ctg_op_filter_update(ctg_op);
+	return ret;
 }
 
 static int ctg_mem_op_exec(struct m0_ctg_op *ctg_op, int next_phase)
@@ -1842,6 +2279,291 @@ M0_INTERNAL int m0_ctg_delete(struct m0_ctg_op    *ctg_op,
 	return ctg_exec(ctg_op, ctg, key, next_phase);
 }
 
+/** Record of m0_ctg_batch as it is passed to m0_btree_batch(). */
+struct ctg_batch_rec {
+	/** Position of the record in the request. */
+	uint64_t       cbr_pos;
+	/** Key in on-disk format (struct generic_key). */
+	struct m0_buf  cbr_key;
+	void          *cbr_kptr;
+	m0_bcount_t    cbr_ksize;
+	void          *cbr_vptr;
+	m0_bcount_t    cbr_vsize;
+	/** Result of the record. */
+	int            cbr_rc;
+};
+
+struct ctg_batch_cb_data {
+	struct m0_ctg_batch    *d_batch;
+	struct ctg_batch_rec   *d_recs;
+	struct m0_btree_batch  *d_bb;
+	struct m0_cas_ctg      *d_ctg;
+	struct m0_be_tx        *d_tx;
+};
+
+M0_INTERNAL int m0_ctg_batch_init(struct m0_ctg_batch *batch, int opcode,
+				  uint32_t flags, uint64_t nr)
+{
+	M0_PRE(M0_IN(opcode, (CO_PUT, CO_DEL)));
+
+	*batch = (struct m0_ctg_batch) {
+		.cb_opcode = opcode,
+		.cb_flags  = flags,
+		.cb_nr     = nr
+	};
+	M0_ALLOC_ARR(batch->cb_keys, nr);
+	M0_ALLOC_ARR(batch->cb_vals, nr);
+	M0_ALLOC_ARR(batch->cb_rc, nr);
+	if (batch->cb_keys == NULL || batch->cb_vals == NULL ||
+	    batch->cb_rc == NULL) {
+		m0_ctg_batch_fini(batch);
+		return M0_ERR(-ENOMEM);
+	}
+	return 0;
+}
+
+M0_INTERNAL void m0_ctg_batch_fini(struct m0_ctg_batch *batch)
+{
+	uint64_t i;
+
+	if (batch->cb_opcode == CO_DEL && batch->cb_vals != NULL) {
+		for (i = 0; i < batch->cb_nr; i++)
+			m0_buf_free(&batch->cb_vals[i]);
+	}
+	m0_free(batch->cb_keys);
+	m0_free(batch->cb_vals);
+	m0_free(batch->cb_rc);
+	M0_SET0(batch);
+}
+
+static int ctg_batch_rec_cmp(const void *a, const void *b)
+{
+	const struct ctg_batch_rec *left  = a;
+	const struct ctg_batch_rec *right = b;
+
+	return ctg_cmp(left->cbr_key.b_addr, right->cbr_key.b_addr) ?:
+		M0_3WAY(left->cbr_pos, right->cbr_pos);
+}
+
+static int ctg_batch_cb(struct m0_btree_cb *cb, struct m0_btree_rec *rec)
+{
+	struct ctg_batch_cb_data *datum = cb->c_datum;
+	struct m0_ctg_batch      *batch = datum->d_batch;
+	struct ctg_batch_rec     *brec  = &datum->d_recs[datum->d_bb->bb_idx];
+	struct m0_buf            *val   = &batch->cb_vals[brec->cbr_pos];
+	struct m0_buf             btree_val;
+	int                       rc;
+
+	m0_buf_init(&btree_val, rec->r_val.ov_buf[0],
+		    m0_vec_count(&rec->r_val.ov_vec));
+	if (batch->cb_opcode == CO_DEL) {
+		/* Keep the deleted value, as m0_ctg_lookup_delete() does. */
+		rc = ctg_vbuf_unpack(&btree_val, NULL) ?:
+		     m0_buf_copy(val, &btree_val);
+		return M0_RC(rc);
+	}
+
+	M0_ASSERT(m0_vec_count(&rec->r_key.k_data.ov_vec) ==
+		  brec->cbr_key.b_nob);
+	m0_memmove(rec->r_key.k_data.ov_buf[0], brec->cbr_key.b_addr,
+		   brec->cbr_key.b_nob);
+	ctg_vbuf_pack(&btree_val, val, &M0_CRV_INIT_NONE);
+	if (ctg_is_ordinary(datum->d_ctg))
+		m0_ctg_state_inc_update(datum->d_tx,
+					brec->cbr_key.b_nob -
+					sizeof(struct generic_key) +
+					val->b_nob);
+	else
+		m0_chan_broadcast_lock(&datum->d_ctg->cc_chan.bch_chan);
+	return 0;
+}
+
+/**
+ * Applies recs[0 .. nr) to the catalogue btree with a single m0_btree_batch()
+ * sweep, the result of every record is set in its cbr_rc.
+ */
+static int ctg_batch_sweep(struct m0_cas_ctg     *ctg,
+			   struct m0_ctg_batch   *batch,
+			   struct ctg_batch_rec  *recs,
+			   struct m0_btree_rec   *brecs,
+			   int                   *brc,
+			   uint64_t               nr,
+			   enum m0_btree_opcode   opc,
+			   uint64_t               flags,
+			   struct m0_be_tx       *tx)
+{
+	bool                      put   = batch->cb_opcode == CO_PUT;
+	struct m0_btree_batch     bb    = {};
+	struct ctg_batch_cb_data  datum = {};
+	uint64_t                  i;
+	int                       rc;
+
+	for (i = 0; i < nr; i++) {
+		struct ctg_batch_rec *r = &recs[i];
+
+		r->cbr_kptr  = r->cbr_key.b_addr;
+		r->cbr_ksize = r->cbr_key.b_nob;
+		r->cbr_vsize = put ? sizeof(struct generic_value) +
+			       batch->cb_vals[r->cbr_pos].b_nob : 0;
+		brecs[i] = (struct m0_btree_rec) {
+			.r_key.k_data = M0_BUFVEC_INIT_BUF(&r->cbr_kptr,
+							   &r->cbr_ksize),
+			.r_val        = M0_BUFVEC_INIT_BUF(&r->cbr_vptr,
+							   &r->cbr_vsize),
+			.r_crc_type   = M0_BCT_NO_CRC
+		};
+	}
+
+	datum = (struct ctg_batch_cb_data) {
+		.d_batch = batch,
+		.d_recs  = recs,
+		.d_bb    = &bb,
+		.d_ctg   = ctg,
+		.d_tx    = tx
+	};
+	bb = (struct m0_btree_batch) {
+		.bb_opc   = opc,
+		.bb_flags = flags,
+		.bb_recs  = brecs,
+		.bb_nr    = nr,
+		.bb_cb    = { .c_act = ctg_batch_cb, .c_datum = &datum },
+		.bb_rc    = brc
+	};
+	rc = nr == 0 ? 0 : m0_btree_batch(ctg->cc_tree, &bb, tx);
+	for (i = 0; i < nr; i++)
+		recs[i].cbr_rc = rc == 0 || i < bb.bb_idx ? brc[i] : rc;
+	return rc;
+}
+
+M0_INTERNAL int m0_ctg_batch_exec(struct m0_cas_ctg   *ctg,
+				  struct m0_ctg_batch *batch,
+				  struct m0_be_tx     *tx)
+{
+	struct m0_ctg_filter     *flt     = ctg->cc_filter;
+	bool                      put     = batch->cb_opcode == CO_PUT;
+	bool                      last    = put &&
+					    (batch->cb_flags & COF_OVERWRITE);
+	/* See ctg_op_exec_normal(): the filter counts new keys only. */
+	bool                      split   = last && flt != NULL &&
+					    ctg_filter_is_ready(flt);
+	struct ctg_batch_rec     *recs;
+	struct m0_btree_rec      *brecs;
+	int                      *brc;
+	uint64_t                  nr      = 0;
+	uint64_t                  i;
+	uint64_t                  j;
+	int                       rc;
+
+	M0_ENTRY("ctg=%p opc=%d nr=%"PRIu64, ctg, batch->cb_opcode,
+		 batch->cb_nr);
+	M0_PRE(batch->cb_nr > 0);
+
+	M0_ALLOC_ARR(recs, batch->cb_nr);
+	M0_ALLOC_ARR(brecs, batch->cb_nr);
+	M0_ALLOC_ARR(brc, batch->cb_nr);
+	if (recs == NULL || brecs == NULL || brc == NULL) {
+		rc = M0_ERR(-ENOMEM);
+		for (i = 0; i < batch->cb_nr; i++)
+			batch->cb_rc[i] = rc;
+		goto out;
+	}
+
+	for (i = 0; i < batch->cb_nr; i++) {
+		batch->cb_rc[i] = ctg_kbuf_get(&recs[nr].cbr_key,
+					       &batch->cb_keys[i], true);
+		if (batch->cb_rc[i] == 0)
+			recs[nr++].cbr_pos = i;
+	}
+	qsort(recs, nr, sizeof recs[0], &ctg_batch_rec_cmp);
+
+	/*
+	 * Only one record of a run with the same key goes to the btree: the
+	 * first one, or the last one for overwriting PUT. The rest get the
+	 * result they would get if executed one by one around it.
+	 */
+	for (i = 0, j = 0; i < nr; i++) {
+		bool dup_next = i + 1 < nr &&
+			ctg_cmp(recs[i].cbr_key.b_addr,
+				recs[i + 1].cbr_key.b_addr) == 0;
+		bool dup_prev = j > 0 &&
+			ctg_cmp(recs[j - 1].cbr_key.b_addr,
+				recs[i].cbr_key.b_addr) == 0;
+
+		if (last ? dup_next : dup_prev) {
+			batch->cb_rc[recs[i].cbr_pos] = last ? 0 :
+							put  ? -EEXIST :
+							       -ENOENT;
+			m0_buf_free(&recs[i].cbr_key);
+			continue;
+		}
+		recs[j++] = recs[i];
+	}
+	nr = j;
+
+	rc = ctg_batch_sweep(ctg, batch, recs, brecs, brc, nr,
+			     !put ? M0_BO_DEL :
+			     last && !split ? M0_BO_UPDATE : M0_BO_PUT,
+			     last && !split ? BOF_INSERT_IF_NOT_FOUND : 0, tx);
+	if (flt != NULL) {
+		for (i = 0; i < nr; i++) {
+			if (recs[i].cbr_rc != 0)
+				continue;
+			if (put)
+				ctg_filter_add(flt, &recs[i].cbr_key);
+			else
+				ctg_filter_del(flt, &recs[i].cbr_key);
+		}
+	}
+	if (split) {
+		/* Overwrite the existing keys by the second sweep. */
+		for (i = 0, j = 0; i < nr; i++) {
+			struct ctg_batch_rec *r = &recs[i];
+
+			if (r->cbr_rc == -EEXIST && rc == 0) {
+				recs[j++] = *r;
+				continue;
+			}
+			if (r->cbr_rc == -EEXIST)
+				r->cbr_rc = rc;
+			batch->cb_rc[r->cbr_pos] = r->cbr_rc;
+			m0_buf_free(&r->cbr_key);
+		}
+		nr = j;
+		rc = ctg_batch_sweep(ctg, batch, recs, brecs, brc, nr,
+				     M0_BO_UPDATE, 0, tx);
+	}
+
+	for (i = 0; i < nr; i++) {
+		batch->cb_rc[recs[i].cbr_pos] = recs[i].cbr_rc;
+		m0_buf_free(&recs[i].cbr_key);
+	}
+out:
+	m0_free(brc);
+	m0_free(brecs);
+	m0_free(recs);
+	return M0_RC(rc);
+}
+
+M0_INTERNAL int m0_ctg_batch_result(struct m0_ctg_op          *ctg_op,
+				    struct m0_cas_ctg         *ctg,
+				    const struct m0_ctg_batch *batch,
+				    uint64_t                   pos,
+				    int                        next_phase)
+{
+	struct m0_be_op *beop = ctg_beop(ctg_op);
+
+	M0_PRE(ctg_op->co_beop.bo_sm.sm_state == M0_BOS_INIT);
+	M0_PRE(pos < batch->cb_nr);
+
+	ctg_op->co_ctg    = ctg;
+	ctg_op->co_ct     = CT_BTREE;
+	ctg_op->co_opcode = batch->cb_opcode;
+	ctg_op->co_rc     = batch->cb_rc[pos];
+	m0_be_op_active(beop);
+	m0_be_op_done(beop);
+	return ctg_op_tick_ret(ctg_op, next_phase);
+}
+
 M0_INTERNAL int m0_ctg_lookup(struct m0_ctg_op    *ctg_op,
 			      struct m0_cas_ctg   *ctg,
 			      const struct m0_buf *key,
@@ -2763,6 +3485,7 @@ static int versioned_put_sync(struct m0_ctg_op *ctg_op)
 						   &kv_op));
 	if (!M0_IN(rc, (0, -ENOENT)))
 		return M0_ERR(rc);
+	ctg_op->co_inserted = rc == -ENOENT;
 
 	/*
 	 * Since we're actually doing a put of a tombstone, the
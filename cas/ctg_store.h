@@ -127,6 +127,8 @@ enum cas_tree_type {
 	 */
 	CTT_CTIDX,
 };
+struct m0_ctg_filter;
+
 /** CAS catalogue. */
 struct m0_cas_ctg {
 	struct m0_format_header cc_head;
@@ -149,6 +151,11 @@ struct m0_cas_ctg {
 	 * meta.
 	 */
 	bool                    cc_inited;
+	/**
+	 * Negative-lookup filter of a user catalogue, NULL if filters are
+	 * disabled. See m0_ctg_filter_enable().
+	 */
+	struct m0_ctg_filter   *cc_filter;
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 
 enum m0_cas_ctg_format_version {
@@ -273,6 +280,35 @@ struct m0_ctg_op {
 	 * See ::COF_VERSIONED for details.
 	 */
 	bool                      co_is_versioned;
+	/**
+	 * Set by CO_PUT when the key was not in the catalogue before. Tracked
+	 * for catalogues with a negative-lookup filter and for versioned puts.
+	 */
+	bool                      co_inserted;
+};
+
+/**
+ * Records of a multi-record request, inserted into (CO_PUT) or deleted from
+ * (CO_DEL) a catalogue by a sweep of its btree, see m0_ctg_batch_exec().
+ */
+struct m0_ctg_batch {
+	/** CO_PUT or CO_DEL. */
+	int                       cb_opcode;
+	/** Request flags, only COF_OVERWRITE is taken into account. */
+	uint32_t                  cb_flags;
+	/** Number of records. */
+	uint64_t                  cb_nr;
+	/** Keys of the records, in the request order. Set by the user. */
+	struct m0_buf            *cb_keys;
+	/**
+	 * Values of the records. For CO_PUT they are set by the user and are
+	 * not copied. For CO_DEL m0_ctg_batch_exec() fills them with copies of
+	 * the deleted values, which the user may take over (zeroing the
+	 * element), the rest are freed by m0_ctg_batch_fini().
+	 */
+	struct m0_buf            *cb_vals;
+	/** Results of the records. Set by m0_ctg_batch_exec(). */
+	int                      *cb_rc;
 };
 
 #define CTG_OP_COMBINE(opc, ct) (((uint64_t)(opc)) | ((ct) << 16))
@@ -491,6 +527,52 @@ M0_INTERNAL int m0_ctg_delete(struct m0_ctg_op    *ctg_op,
 			      const struct m0_buf *key,
 			      int                  next_phase);
 
+/**
+ * Allocates arrays of the batch for nr records.
+ */
+M0_INTERNAL int m0_ctg_batch_init(struct m0_ctg_batch *batch, int opcode,
+				  uint32_t flags, uint64_t nr);
+
+/**
+ * Frees arrays of the batch and the deleted values not taken by the user.
+ */
+M0_INTERNAL void m0_ctg_batch_fini(struct m0_ctg_batch *batch);
+
+/**
+ * Executes all the records of the batch in the given transaction with one
+ * m0_btree_batch() call, i.e., under a single acquisition of the btree lock
+ * and with one descent for the records falling into the same leaf. Records
+ * are sorted by key before execution; for duplicate keys the result is the
+ * same as if records were executed one by one in the request order.
+ * Overwriting PUT into a catalogue with a ready negative-lookup filter takes
+ * a second call for the keys found in the btree, see ctg_op_exec_normal().
+ *
+ * The batch is synchronous and not versioned: it is only suitable for the
+ * requests which are executed by ctg_op_exec_normal() record by record.
+ * Transaction credits are the same as for separate m0_ctg_insert() or
+ * m0_ctg_lookup_delete() calls.
+ *
+ * @ret 0 when all the records have been executed (with their own results in
+ *      batch->cb_rc[]), otherwise the error which stopped the batch; records
+ *      not executed have this error as their result.
+ */
+M0_INTERNAL int m0_ctg_batch_exec(struct m0_cas_ctg   *ctg,
+				  struct m0_ctg_batch *batch,
+				  struct m0_be_tx     *tx);
+
+/**
+ * Completes catalogue operation for the record of the batch at position pos,
+ * without touching the catalogue: m0_ctg_op_rc() returns the result the
+ * record got from m0_ctg_batch_exec().
+ *
+ * @ret M0_FSO_AGAIN.
+ */
+M0_INTERNAL int m0_ctg_batch_result(struct m0_ctg_op          *ctg_op,
+				    struct m0_cas_ctg         *ctg,
+				    const struct m0_ctg_batch *batch,
+				    uint64_t                   pos,
+				    int                        next_phase);
+
 /**
  * Looks up a key/value record in catalogue.
  * @note Key is copied before execution of operation, user does not need to keep
@@ -799,6 +881,45 @@ M0_INTERNAL uint64_t m0_ctg_rec_nr(void);
  */
 M0_INTERNAL uint64_t m0_ctg_rec_size(void);
 
+/**
+ * Enables or disables negative-lookup filters for user catalogues created or
+ * opened after the call. Filters are disabled by default. CAS service enables
+ * them if its configuration object has "ctg_filter:on" parameter.
+ *
+ * A filter is an in-memory counting Bloom filter over the keys of a catalogue.
+ * m0_ctg_lookup() of a key that the filter definitely does not contain
+ * completes with -ENOENT without descending the btree. The filter is updated
+ * by m0_ctg_insert() and m0_ctg_delete() and is (re)built by a catalogue scan
+ * on the first lookup after the catalogue is opened or the filter outgrows
+ * its capacity. It costs 10-20 bytes of memory per key.
+ *
+ * Filters rely on the catalogue locking done by the users of the store:
+ * lookups may run concurrently, but not concurrently with modifications.
+ */
+M0_INTERNAL void m0_ctg_filter_enable(bool enable);
+
+/** Negative-lookup filter statistics. */
+struct m0_ctg_filter_stats {
+	/** Lookups answered with the help of the filter. */
+	uint64_t cfs_lookups;
+	/** Lookups completed without btree access. */
+	uint64_t cfs_negatives;
+	/** Lookups passed by the filter for keys not found in the btree. */
+	uint64_t cfs_false_pos;
+	/** Number of keys the filter was populated with. */
+	uint64_t cfs_keys;
+	/** Number of catalogue scans done to (re)build the filter. */
+	uint64_t cfs_builds;
+};
+
+/**
+ * Returns statistics of the catalogue negative-lookup filter. Returns false if
+ * the catalogue has no filter. The same statistics are periodically posted to
+ * ADDB2 (M0_AVI_CAS_CTG_FILTER).
+ */
+M0_INTERNAL bool m0_ctg_filter_stats(const struct m0_cas_ctg    *ctg,
+				     struct m0_ctg_filter_stats *stats);
+
 /**
  * Returns a reference to the catalogue store "delete" long lock.
  *
@@ -35,6 +35,7 @@
 #include "lib/misc.h"                /* M0_IN */
 #include "lib/errno.h"               /* ENOMEM, EPROTO */
 #include "lib/ext.h"
+#include "lib/string.h"              /* m0_streq */
 #include "fop/fom_long_lock.h"
 #include "fop/fom_generic.h"
 #include "fop/fom_interpose.h"
@@ -119,6 +120,10 @@
  *   CAS service processes requests synchronously. If catalogue can't be locked
  *   immediately, then FOM is blocked.
  *
+ * - @b r.cas.partial-next
+ *   A range scan (NEXT) that has more records than fit into one RPC item
+ *   should not fail, the records should be delivered in several replies.
+ *
  * - @b r.cas.indices-list
  *   User should be able to request list of all indices in meta-index without
  *   prior knowledge of any index FID.
@@ -270,6 +275,13 @@
  * - @b i.cas.sync
  *   FOM is blocked on waiting of per-index FOM long lock.
  *
+ * - @b i.cas.partial-next
+ *   If COF_PARTIAL is set in CUR request, the size of the reply is accounted
+ *   as records are generated. The reply is cut before the first record that
+ *   does not fit into RPC item and the position of the cut is returned to the
+ *   client (m0_cas_rep::cgr_cur_*), which requests the rest of records
+ *   starting from the last returned key.
+ *
  * - @b i.cas.indices-list
  *   Meta-index includes itself and has the smallest FID (0,0), so it is always
  *   the first by key order. User can specify m0_cas_meta_fid as s starting FID
@@ -350,6 +362,16 @@ struct cas_fom {
 	bool                      cf_op_checked;
 	uint64_t                  cf_curpos;
 	bool                      cf_startkey_excluded;
+	/**
+	 * Maximum payload size of CUR reply, if the reply may be cut (see
+	 * COF_PARTIAL). Zero otherwise.
+	 */
+	m0_bcount_t               cf_rep_max;
+	/**
+	 * Payload size of CUR reply, including zeroed records, which are not
+	 * generated yet.
+	 */
+	m0_bcount_t               cf_rep_size;
 	/**
 	 * Key/value pairs from incoming FOP.
 	 * They are loaded once from incoming RPC AT buffers
@@ -386,6 +408,11 @@ struct cas_fom {
 				       	     [STATS_KV_IO_NR]
 				       	     [STATS_NR];
 	struct m0_dtm0_redo      *cf_redo;
+	/**
+	 * Records of a multi-record PUT or DEL, executed together before the
+	 * first record is processed in CAS_LOOP, see cas_batch_exec().
+	 */
+	struct m0_ctg_batch       cf_batch;
 };
 
 enum cas_fom_phase {
@@ -467,6 +494,8 @@ static int                  cas_exec   (struct cas_fom *fom,
 					enum m0_cas_type ct,
 					struct m0_cas_ctg *ctg,
 					uint64_t rec_pos, int next);
+static int  cas_batch_exec(struct cas_fom *fom, enum m0_cas_opcode opc,
+			   enum m0_cas_type ct, struct m0_cas_ctg *ctg);
 
 static int  cas_done(struct cas_fom *fom, struct m0_cas_op *op,
 		     struct m0_cas_rep *rep, enum m0_cas_opcode opc);
@@ -645,6 +674,37 @@ m0_cas__ut_svc_dtm0_domain_get(struct m0_reqh_service *svc)
 	return service->c_dtm0_domain;
 }
 
+/**
+ * Applies parameters of the CAS service configuration object.
+ *
+ * "ctg_filter:on" and "ctg_filter:off" enable and disable negative-lookup
+ * filters of user catalogues, see m0_ctg_filter_enable().
+ */
+static void cas_service_params_apply(struct cas_service *cas_svc)
+{
+	struct m0_reqh_service *svc = &cas_svc->c_service;
+	struct m0_conf_cache   *cache;
+	struct m0_conf_obj     *obj;
+	struct m0_conf_service *service;
+	const char            **param;
+
+	if (cas_in_ut())
+		return;
+	cache = &m0_reqh2confc(svc->rs_reqh)->cc_cache;
+	obj = m0_conf_cache_lookup(cache, &svc->rs_service_fid);
+	if (obj == NULL)
+		return;
+	service = M0_CONF_CAST(obj, m0_conf_service);
+	if (service->cs_params == NULL)
+		return;
+	for (param = service->cs_params; *param != NULL; ++param) {
+		if (m0_streq(*param, "ctg_filter:on"))
+			m0_ctg_filter_enable(true);
+		else if (m0_streq(*param, "ctg_filter:off"))
+			m0_ctg_filter_enable(false);
+	}
+}
+
 static int cas_service_start(struct m0_reqh_service *svc)
 {
 	int                    rc;
@@ -661,6 +721,7 @@ static int cas_service_start(struct m0_reqh_service *svc)
 	service->c_dtm0_domain = dod != NULL ? dod :
 				&svc->rs_reqh_ctx->rc_dtm0_domain;
 	service->c_sdev_id = INVALID_CAS_SDEV_ID;
+	cas_service_params_apply(service);
 	rc = m0_ctg_store_init(service->c_be_domain);
 	if (rc == 0) {
 		/*
@@ -1030,6 +1091,78 @@ static bool cas_max_reply_payload_exceeded(struct cas_fom *fom)
 	return payload_exceeded;
 }
 
+/**
+ * Starts accounting of CUR reply size if the reply may be cut when records
+ * do not fit into one RPC item.
+ */
+static void cas_cur_size_init(struct cas_fom *fom)
+{
+	struct m0_fom         *fom0    = &fom->cf_fom;
+	struct m0_rpc_session *session = fom0->fo_fop->f_item.ri_session;
+
+	fom->cf_rep_max  = 0;
+	fom->cf_rep_size = 0;
+	if (!(cas_op(fom0)->cg_flags & COF_PARTIAL) || session == NULL)
+		return;
+	fom->cf_rep_size = m0_rpc_item_payload_size(&fom0->fo_rep_fop->f_item);
+	fom->cf_rep_max  = m0_rpc_session_get_max_item_payload_size(session);
+}
+
+/**
+ * Checks whether just generated CUR reply record fits into the reply and
+ * accounts its size if so.
+ */
+static bool cas_cur_rec_fits(struct cas_fom *fom, struct m0_cas_rec *rec)
+{
+	struct m0_cas_rec   zero = {};
+	struct m0_xcode_ctx ctx;
+	m0_bcount_t         size;
+
+	if (fom->cf_rep_max == 0)
+		return true;
+	/* The record replaces zeroed one, which is already accounted. */
+	size = m0_xcode_data_size(&ctx, &M0_XCODE_OBJ(m0_cas_rec_xc, rec)) -
+	       m0_xcode_data_size(&ctx, &M0_XCODE_OBJ(m0_cas_rec_xc, &zero));
+	if (M0_FI_ENABLED("reply_full") ||
+	    fom->cf_rep_size + size > fom->cf_rep_max)
+		return false;
+	fom->cf_rep_size += size;
+	return true;
+}
+
+/**
+ * Cuts CUR reply before the last generated record and stops processing of
+ * input records. The client is told where the cut happened: "ipos" is the
+ * input record the dropped record belongs to, "nr" is the number of records
+ * already returned for it.
+ *
+ * The cursor is not kept open after the reply: the client continues with a
+ * new request (see nreq_partial_handle() in cas/client.c), so a long scan
+ * still costs one round trip per RPC item worth of records.
+ */
+static void cas_cur_cut(struct cas_fom *fom, struct m0_cas_op *op,
+			struct m0_cas_rep *rep, uint64_t ipos, uint64_t nr)
+{
+	struct m0_cas_rec *rec = cas_out_at(rep, fom->cf_opos - 1);
+
+	m0_rpc_at_fini(&rec->cr_key);
+	m0_rpc_at_fini(&rec->cr_val);
+	M0_SET0(rec);
+	if (fom->cf_curpos != 0) {
+		/* The iteration for "ipos" is not finished yet. */
+		m0_ctg_cursor_put(&fom->cf_ctg_op);
+		fom->cf_curpos = 0;
+		fom->cf_startkey_excluded = false;
+	}
+	rep->cgr_rep.cr_nr   = --fom->cf_opos;
+	rep->cgr_cur_partial = 1;
+	rep->cgr_cur_ipos    = ipos;
+	rep->cgr_cur_nr      = nr;
+	fom->cf_ipos         = op->cg_rec.cr_nr;
+	M0_LOG(M0_DEBUG, "CUR reply cut at ipos=%"PRIu64" nr=%"PRIu64,
+	       ipos, nr);
+}
+
 static bool cas_key_need_to_send(struct cas_fom *fom, enum m0_cas_opcode opc,
 				 enum m0_cas_type ct, struct m0_cas_op *op,
 				 uint64_t rec_pos)
@@ -1360,6 +1493,8 @@ static int cas_fom_tick(struct m0_fom *fom0)
 	bool                is_index_drop;
 	bool                do_ctidx;
 	int                 next_phase;
+	uint64_t            cur_ipos = 0;
+	uint64_t            cur_nr   = 0;
 
 	M0_ENTRY("fom %p phase %d (%s) op_flag=0x%x", fom, phase,
 		 m0_fom_phase_name(fom0, phase), op->cg_flags);
@@ -1604,6 +1739,7 @@ static int cas_fom_tick(struct m0_fom *fom0)
 			 */
 			m0_ctg_op_init(&fom->cf_ctg_op, fom0,
 				       cas_op(fom0)->cg_flags);
+			cas_cur_size_init(fom);
 		}
 
 		rc = cas_dtm0_prep(fom);
@@ -1650,6 +1786,11 @@ static int cas_fom_tick(struct m0_fom *fom0)
 			}
 			addb2_add_kv_attrs(fom, STATS_KV_OUT);
 		} else {
+			rc = cas_batch_exec(fom, opc, ct, ctg);
+			if (rc != 0) {
+				cas_fom_failure(fom, M0_ERR(rc), false);
+				break;
+			}
 			do_ctidx = cas_ctidx_op_needed(fom, opc, ct, ipos);
 			result = cas_exec(fom, opc, ct, ctg, ipos,
 					  is_index_drop ?
@@ -1869,10 +2010,22 @@ static int cas_fom_tick(struct m0_fom *fom0)
 		m0_fom_phase_set(fom0, CAS_DONE);
 		break;
 	case CAS_DONE:
+		if (opc == CO_CUR) {
+			cur_ipos = fom->cf_ipos;
+			cur_nr   = fom->cf_curpos -
+				   (fom->cf_startkey_excluded ? 1 : 0);
+		}
 		if (cas_done(fom, op, rep, opc) == 0 && is_index_drop)
 			m0_fom_phase_set(fom0, CAS_IDROP_LOCK_LOOP);
 		else
 			m0_fom_phase_set(fom0, CAS_LOOP);
+		/*
+		 * Cut the reply before the record that does not fit, unless
+		 * it is the first one: an empty reply makes no progress.
+		 */
+		if (opc == CO_CUR && fom->cf_opos > 1 &&
+		    !cas_cur_rec_fits(fom, cas_out_at(rep, fom->cf_opos - 1)))
+			cas_cur_cut(fom, op, rep, cur_ipos, cur_nr);
 		break;
 	case CAS_DTM0:
 		rc = cas_dtm0_logrec_add(&fom->cf_fom,
@@ -1918,6 +2071,7 @@ static void cas_fom_fini(struct m0_fom *fom0)
 	m0_free(fom->cf_in_cids);
 	m0_free(fom->cf_moved_ctgs);
 	m0_free(fom->cf_ikv);
+	m0_ctg_batch_fini(&fom->cf_batch);
 	m0_long_lock_link_fini(&fom->cf_meta);
 	m0_long_lock_link_fini(&fom->cf_lock);
 	m0_long_lock_link_fini(&fom->cf_ctidx);
@@ -2420,10 +2574,23 @@ static int cas_exec(struct cas_fom *fom, enum m0_cas_opcode opc,
 		ret = m0_ctg_lookup(ctg_op, ctg, &kbuf, next);
 		break;
 	case CTG_OP_COMBINE(CO_PUT, CT_BTREE):
-		ret = m0_ctg_insert(ctg_op, ctg, &kbuf, &vbuf, next);
+		if (fom->cf_batch.cb_rc != NULL)
+			ret = m0_ctg_batch_result(ctg_op, ctg, &fom->cf_batch,
+						  rec_pos, next);
+		else
+			ret = m0_ctg_insert(ctg_op, ctg, &kbuf, &vbuf, next);
 		break;
 	case CTG_OP_COMBINE(CO_DEL, CT_BTREE):
-		ret = m0_ctg_lookup_delete(ctg_op, ctg, &kbuf, &lbuf, flags, next);
+		if (fom->cf_batch.cb_rc != NULL) {
+			ret = m0_ctg_batch_result(ctg_op, ctg, &fom->cf_batch,
+						  rec_pos, next);
+			if (ctg_op->co_rc == 0) {
+				lbuf = fom->cf_batch.cb_vals[rec_pos];
+				fom->cf_batch.cb_vals[rec_pos] = M0_BUF_INIT0;
+			}
+		} else
+			ret = m0_ctg_lookup_delete(ctg_op, ctg, &kbuf, &lbuf,
+						   flags, next);
 		if (ctg_op->co_rc == 0) {
 			rec = cas_at(cas_op(fom0), rec_pos);
 
@@ -2476,6 +2643,44 @@ static int cas_exec(struct cas_fom *fom, enum m0_cas_opcode opc,
 	return ret;
 }
 
+/**
+ * Executes all the records of a multi-record PUT or DEL of a catalogue with a
+ * single sweep of the catalogue btree, before the first record is processed.
+ * cas_exec() then only picks up the result of every record. Versioned requests
+ * and requests for which the batch cannot be allocated are executed record by
+ * record.
+ */
+/**
+ * Executes all the records of a multi-record PUT or DEL by a single sweep of
+ * the catalogue btree, when the request is suitable for that. The records are
+ * then completed one by one in CAS_LOOP, with the results of the batch.
+ *
+ * Returns an error if the batch was stopped by a btree failure: the request
+ * fails as a whole then, like when the failure happens outside of CAS_LOOP.
+ */
+static int cas_batch_exec(struct cas_fom *fom, enum m0_cas_opcode opc,
+			  enum m0_cas_type ct, struct m0_cas_ctg *ctg)
+{
+	struct m0_fom       *fom0  = &fom->cf_fom;
+	struct m0_cas_op    *op    = cas_op(fom0);
+	struct m0_ctg_batch *batch = &fom->cf_batch;
+	struct m0_buf        val;
+	uint64_t             i;
+
+	if (ct != CT_BTREE || !M0_IN(opc, (CO_PUT, CO_DEL)) ||
+	    op->cg_rec.cr_nr < 2 || (op->cg_flags & COF_VERSIONED) ||
+	    fom->cf_ipos != 0 || batch->cb_rc != NULL)
+		return 0;
+	/* Fall back to record by record execution. */
+	if (m0_ctg_batch_init(batch, opc, op->cg_flags, op->cg_rec.cr_nr) != 0)
+		return 0;
+	for (i = 0; i < batch->cb_nr; i++)
+		cas_incoming_kv(fom, i, &batch->cb_keys[i],
+				opc == CO_PUT ? &batch->cb_vals[i] : &val);
+	/* Results of the records are returned in batch->cb_rc[]. */
+	return M0_RC(m0_ctg_batch_exec(ctg, batch, &fom0->fo_tx.tx_betx));
+}
+
 static bool cas_ctidx_op_needed(struct cas_fom *fom, enum m0_cas_opcode opc,
 				enum m0_cas_type ct, uint64_t rec_pos)
 {
@@ -3211,7 +3416,8 @@ M0_INTERNAL struct m0_reqh_service_type m0_cas_service_type = {
 	.rst_name     = "M0_CST_CAS",
 	.rst_ops      = &cas_service_type_ops,
 	.rst_level    = M0_RS_LEVEL_NORMAL,
-	.rst_typecode = M0_CST_CAS
+	.rst_typecode = M0_CST_CAS,
+	.rst_fom_prio = M0_FOM_PRIO_MD
 };
 
 #undef M0_TRACE_SUBSYSTEM
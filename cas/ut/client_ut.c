@@ -2679,6 +2679,117 @@ static void recs_fragm_fail(void)
 	casc_ut_fini(&casc_ut_sctx, &casc_ut_cctx);
 }
 
+/*
+ * Test NEXT requests, which replies are cut by CAS service.
+ */
+static void next_partial(void)
+{
+	struct m0_cas_rec_reply  rep[COUNT];
+	struct m0_cas_next_reply next_rep[COUNT];
+	const struct m0_fid      ifid = IFID(2, 3);
+	struct m0_cas_id         index = {};
+	struct m0_bufvec         keys;
+	struct m0_bufvec         values;
+	struct m0_bufvec         start_keys;
+	uint32_t                 recs_nr[2];
+	uint64_t                 rep_count;
+	int                      rc;
+
+	casc_ut_init(&casc_ut_sctx, &casc_ut_cctx);
+	rc = m0_bufvec_alloc(&keys, COUNT, sizeof(uint64_t));
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_bufvec_alloc(&values, COUNT, sizeof(uint64_t));
+	M0_UT_ASSERT(rc == 0);
+	m0_forall(i, keys.ov_vec.v_nr, (*(uint64_t*)keys.ov_buf[i]   = i,
+					*(uint64_t*)values.ov_buf[i] = i * i,
+					true));
+	M0_SET_ARR0(rep);
+	rc = ut_idx_create(&casc_ut_cctx, &ifid, 1, rep);
+	M0_UT_ASSERT(rc == 0);
+	index.ci_fid = ifid;
+	rc = ut_rec_put(&casc_ut_cctx, &index, &keys, &values, rep, 0);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_forall(i, COUNT, rep[i].crr_rc == 0));
+
+	/* One start key, every sixth record doesn't fit into the reply. */
+	M0_SET_ARR0(next_rep);
+	rc = m0_bufvec_alloc(&start_keys, 1, keys.ov_vec.v_count[0]);
+	M0_UT_ASSERT(rc == 0);
+	value_create(start_keys.ov_vec.v_count[0], 0, start_keys.ov_buf[0]);
+	recs_nr[0] = COUNT;
+	m0_fi_enable_off_n_on_m("cas_cur_rec_fits", "reply_full", 4, 1);
+	rc = ut_next_rec(&casc_ut_cctx, &index, &start_keys, recs_nr, next_rep,
+			 &rep_count, 0);
+	m0_fi_disable("cas_cur_rec_fits", "reply_full");
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(rep_count == COUNT);
+	M0_UT_ASSERT(m0_forall(i, rep_count,
+			       next_rep[i].cnp_rc == 0 &&
+			       next_rep_equals(&next_rep[i], keys.ov_buf[i],
+					       values.ov_buf[i])));
+	ut_next_rep_clear(next_rep, rep_count);
+	m0_bufvec_free(&start_keys);
+
+	/* Two start keys, replies are cut inside and between them. */
+	M0_SET_ARR0(next_rep);
+	rc = m0_bufvec_alloc(&start_keys, 2, keys.ov_vec.v_count[0]);
+	M0_UT_ASSERT(rc == 0);
+	value_create(start_keys.ov_vec.v_count[0], 0, start_keys.ov_buf[0]);
+	value_create(start_keys.ov_vec.v_count[1], COUNT / 2,
+		     start_keys.ov_buf[1]);
+	recs_nr[0] = recs_nr[1] = COUNT / 2;
+	m0_fi_enable_off_n_on_m("cas_cur_rec_fits", "reply_full", 2, 1);
+	rc = ut_next_rec(&casc_ut_cctx, &index, &start_keys, recs_nr, next_rep,
+			 &rep_count, 0);
+	m0_fi_disable("cas_cur_rec_fits", "reply_full");
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(rep_count == COUNT);
+	M0_UT_ASSERT(m0_forall(i, rep_count,
+			       next_rep[i].cnp_rc == 0 &&
+			       next_rep_equals(&next_rep[i], keys.ov_buf[i],
+					       values.ov_buf[i])));
+	ut_next_rep_clear(next_rep, rep_count);
+	m0_bufvec_free(&start_keys);
+
+	/* Remove index. */
+	rc = ut_idx_delete(&casc_ut_cctx, &ifid, 1, rep);
+	M0_UT_ASSERT(rc == 0);
+	m0_bufvec_free(&keys);
+
+	/*
+	 * Bulk keys: the rest of records is requested starting from the key
+	 * received by assembly request, which may be cut too.
+	 */
+	vals_create(COUNT, COUNT_VAL_BYTES, &keys);
+	rc = ut_idx_create(&casc_ut_cctx, &ifid, 1, rep);
+	M0_UT_ASSERT(rc == 0);
+	rc = ut_rec_put(&casc_ut_cctx, &index, &keys, &values, rep, 0);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_forall(i, COUNT, rep[i].crr_rc == 0));
+	M0_SET_ARR0(next_rep);
+	rc = m0_bufvec_alloc(&start_keys, 1, keys.ov_vec.v_count[0]);
+	M0_UT_ASSERT(rc == 0);
+	value_create(start_keys.ov_vec.v_count[0], 0, start_keys.ov_buf[0]);
+	recs_nr[0] = COUNT;
+	m0_fi_enable_off_n_on_m("cas_cur_rec_fits", "reply_full", 4, 1);
+	rc = ut_next_rec(&casc_ut_cctx, &index, &start_keys, recs_nr, next_rep,
+			 &rep_count, 0);
+	m0_fi_disable("cas_cur_rec_fits", "reply_full");
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(rep_count == COUNT);
+	M0_UT_ASSERT(m0_forall(i, rep_count,
+			       next_rep[i].cnp_rc == 0 &&
+			       next_rep_equals(&next_rep[i], keys.ov_buf[i],
+					       values.ov_buf[i])));
+	ut_next_rep_clear(next_rep, rep_count);
+	m0_bufvec_free(&start_keys);
+	rc = ut_idx_delete(&casc_ut_cctx, &ifid, 1, rep);
+	M0_UT_ASSERT(rc == 0);
+	m0_bufvec_free(&keys);
+	m0_bufvec_free(&values);
+	casc_ut_fini(&casc_ut_sctx, &casc_ut_cctx);
+}
+
 /*
  * Put Large Keys and Values.
  */
@@ -3951,6 +4062,7 @@ struct m0_ut_suite cas_client_ut = {
 		{ "reply-too-large",        reply_too_large,        "Sergey" },
 		{ "recs-fragm",             recs_fragm,             "Sergey" },
 		{ "recs_fragm_fail",        recs_fragm_fail,        "Sergey" },
+		{ "next-partial",           next_partial },
 		{ "put-ver",                put_ver,                "Ivan"   },
 		{ "put-overwrite-ver",      put_overwrite_ver,      "Ivan"   },
 		{ "del-ver",                del_ver,                "Ivan"   },
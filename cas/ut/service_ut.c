@@ -34,6 +34,7 @@
 #include "lib/finject.h"
 #include "lib/semaphore.h"
 #include "lib/byteorder.h"
+#include "lib/ub.h"
 #include "fop/fop.h"
 #include "reqh/reqh.h"
 #include "reqh/reqh_service.h"
@@ -41,6 +42,7 @@
 
 #include "cas/cas.h"
 #include "cas/cas_xc.h"
+#include "cas/ctg_store.h"                /* m0_ctg_filter_stats */
 #include "rpc/at.h"
 #include "fdmi/fdmi.h"
 #include "rpc/rpc_machine.h"
@@ -70,6 +72,8 @@ static struct m0_cas_rep       rep;
 static struct m0_cas_rec       repv[N];
 static struct m0_fid           ifid = IFID(2, 3);
 static bool                    mt;
+/** Flags of the operations sent by fop_submit(). */
+static uint32_t                op_flags;
 
 extern void (*cas__ut_cb_done)(struct m0_fom *fom);
 extern void (*cas__ut_cb_fini)(struct m0_fom *fom);
@@ -430,8 +434,9 @@ static void fop_submit(struct m0_fop_type *ft, const struct m0_fid *index,
 	int              result;
 	struct fopsem    fs;
 	struct m0_cas_op op = {
-		.cg_id  = { .ci_fid = *index },
-		.cg_rec = { .cr_rec = rec }
+		.cg_id    = { .ci_fid = *index },
+		.cg_rec   = { .cr_rec = rec },
+		.cg_flags = op_flags
 	};
 
 	M0_UT_ASSERT(cas__ut_cb_done == &cb_done);
@@ -1282,6 +1287,79 @@ static void lookup_restart(void)
 	fini();
 }
 
+/**
+ * Test lookups in a catalogue with negative-lookup filter: misses are answered
+ * by the filter, deleted keys are filtered out, the filter is rebuilt after it
+ * overflows.
+ */
+static void lookup_filter(void)
+{
+	struct m0_ctg_filter_stats st;
+	struct m0_cas_ctg         *ctg;
+	int                        rc;
+
+	m0_ctg_filter_enable(true);
+	init();
+	meta_fid_submit(&cas_put_fopt, &ifid);
+	rc = m0_ctg_meta_find_ctg(m0_ctg_meta(), &ifid, &ctg);
+	M0_UT_ASSERT(rc == 0);
+	insert_odd(&ifid);
+	lookup_all(&ifid);
+	M0_UT_ASSERT(m0_ctg_filter_stats(ctg, &st));
+	M0_UT_ASSERT(st.cfs_builds == 0);
+	M0_UT_ASSERT(st.cfs_keys == INSERTS / 2);
+	M0_UT_ASSERT(st.cfs_lookups == INSERTS - 1);
+	M0_UT_ASSERT(st.cfs_negatives + st.cfs_false_pos == (INSERTS - 1) / 2);
+	M0_UT_ASSERT(st.cfs_negatives > st.cfs_false_pos);
+
+	/* Only an overwriting put of a new key is counted. */
+	op_flags = COF_OVERWRITE;
+	index_op(&cas_put_fopt, &ifid, CB(1), 2);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	M0_UT_ASSERT(m0_ctg_filter_stats(ctg, &st));
+	M0_UT_ASSERT(st.cfs_keys == INSERTS / 2);
+	index_op(&cas_put_fopt, &ifid, CB(2), 2);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	op_flags = 0;
+	M0_UT_ASSERT(m0_ctg_filter_stats(ctg, &st));
+	M0_UT_ASSERT(st.cfs_keys == INSERTS / 2 + 1);
+	index_op(&cas_del_fopt, &ifid, CB(2), NOVAL);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	/* A new key passed by the filter is inserted once the update fails. */
+	op_flags = COF_OVERWRITE;
+	m0_fi_enable_once("ctg_op_exec_normal", "filter_maybe");
+	index_op(&cas_put_fopt, &ifid, CB(2), 2);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	op_flags = 0;
+	M0_UT_ASSERT(m0_ctg_filter_stats(ctg, &st));
+	M0_UT_ASSERT(st.cfs_keys == INSERTS / 2 + 1);
+	index_op(&cas_get_fopt, &ifid, CB(2), NOVAL);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BSET));
+	index_op(&cas_del_fopt, &ifid, CB(2), NOVAL);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+
+	index_op(&cas_del_fopt, &ifid, CB(1), NOVAL);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	index_op(&cas_get_fopt, &ifid, CB(1), NOVAL);
+	M0_UT_ASSERT(rep_check(0, -ENOENT, BUNSET, BUNSET));
+	M0_UT_ASSERT(m0_ctg_filter_stats(ctg, &st));
+	M0_UT_ASSERT(st.cfs_keys == INSERTS / 2 - 1);
+
+	/* Insert the key back and make the filter overflow. */
+	m0_fi_enable_once("ctg_filter_add", "filter_full");
+	index_op(&cas_put_fopt, &ifid, CB(1), 1);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	lookup_all(&ifid);
+	M0_UT_ASSERT(m0_ctg_filter_stats(ctg, &st));
+	M0_UT_ASSERT(st.cfs_builds == 1);
+	M0_UT_ASSERT(st.cfs_keys == INSERTS / 2);
+	/* Cleaning up allocated memory to avoid leaks. */
+	meta_fid_submit(&cas_del_fopt, &ifid);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	fini();
+	m0_ctg_filter_enable(false);
+}
+
 /**
  * Test iteration over multiple values (with restart).
  */
@@ -2202,6 +2280,7 @@ struct m0_ut_suite cas_service_ut = {
 		{ "delete-2",                &delete_2,              "Nikita" },
 		{ "lookup-N",                &lookup_N,              "Nikita" },
 		{ "lookup-restart",          &lookup_restart,        "Nikita" },
+		{ "lookup-filter",           &lookup_filter },
 		{ "cur-N",                   &cur_N,                 "Nikita" },
 		{ "meta-mt",                 &meta_mt,               "Nikita" },
 		{ "meta-insert-fail",        &meta_insert_fail,      "Leonid" },
@@ -2230,6 +2309,120 @@ struct m0_ut_suite cas_service_ut = {
 	}
 };
 
+enum {
+	/** Records in a benchmark catalogue. */
+	CAS_UB_RECS   = 20000,
+	/** Records inserted by a PUT fop. */
+	CAS_UB_BATCH  = 16,
+	/** Keys looked up by a GET fop, 90% of them are missing. */
+	CAS_UB_GET_NR = 100,
+	CAS_UB_ITER   = 1000,
+	/** Prime, co-prime with CAS_UB_RECS, used to scatter lookups. */
+	CAS_UB_STRIDE = 7919,
+};
+
+/**
+ * The same records are inserted in both catalogues, the second one has
+ * negative-lookup filter.
+ */
+static struct m0_fid cas_ub_fid[] = { IFID(2, 4), IFID(2, 5) };
+
+/** Inserts even keys 2, 4, ..., 2 * CAS_UB_RECS. */
+static void cas_ub_fill(const struct m0_fid *index)
+{
+	static struct m0_cas_rec recs[CAS_UB_BATCH + 1];
+	static uint64_t          keys[CAS_UB_BATCH];
+	int                      i;
+	int                      j;
+
+	for (i = 0; i < CAS_UB_RECS; i += CAS_UB_BATCH) {
+		for (j = 0; j < CAS_UB_BATCH; ++j) {
+			keys[j] = CB(2 * (i + j) + 2);
+			recs[j] = (struct m0_cas_rec) {
+				.cr_key.u.ab_buf = M0_BUF_INIT_PTR(&keys[j]),
+				.cr_key.ab_type  = M0_RPC_AT_INLINE,
+				.cr_val.u.ab_buf = M0_BUF_INIT_PTR(&keys[j]),
+				.cr_val.ab_type  = M0_RPC_AT_INLINE
+			};
+		}
+		recs[j].cr_rc = ~0ULL;
+		fop_submit(&cas_put_fopt, index, recs);
+		M0_UT_ASSERT(rep.cgr_rc == 0);
+	}
+}
+
+static int cas_ub_init(const char *opts M0_UNUSED)
+{
+	init();
+	meta_fid_submit(&cas_put_fopt, &cas_ub_fid[0]);
+	m0_ctg_filter_enable(true);
+	meta_fid_submit(&cas_put_fopt, &cas_ub_fid[1]);
+	m0_ctg_filter_enable(false);
+	cas_ub_fill(&cas_ub_fid[0]);
+	cas_ub_fill(&cas_ub_fid[1]);
+	return 0;
+}
+
+static void cas_ub_fini(void)
+{
+	meta_fid_submit(&cas_del_fopt, &cas_ub_fid[0]);
+	meta_fid_submit(&cas_del_fopt, &cas_ub_fid[1]);
+	fini();
+}
+
+/**
+ * Every 10th looked up key exists, the others are odd and fall between
+ * existing keys, so that the btree is descended to a leaf for each of them.
+ */
+static void cas_ub_get(const struct m0_fid *index, int iter)
+{
+	static struct m0_cas_rec recs[CAS_UB_GET_NR + 1];
+	static uint64_t          keys[CAS_UB_GET_NR];
+	uint64_t                 n;
+	int                      j;
+
+	for (j = 0; j < CAS_UB_GET_NR; ++j) {
+		n = ((uint64_t)iter * CAS_UB_GET_NR + j) * CAS_UB_STRIDE %
+			CAS_UB_RECS;
+		keys[j] = CB(2 * n + (j % 10 == 0 ? 2 : 1));
+		recs[j] = (struct m0_cas_rec) {
+			.cr_key.u.ab_buf = M0_BUF_INIT_PTR(&keys[j]),
+			.cr_key.ab_type  = M0_RPC_AT_INLINE,
+			.cr_val.ab_type  = M0_RPC_AT_EMPTY
+		};
+	}
+	recs[j].cr_rc = ~0ULL;
+	fop_submit(&cas_get_fopt, index, recs);
+	M0_UT_ASSERT(rep.cgr_rc == 0 && rep.cgr_rep.cr_nr == CAS_UB_GET_NR);
+}
+
+static void cas_ub_get_miss(int iter)
+{
+	cas_ub_get(&cas_ub_fid[0], iter);
+}
+
+static void cas_ub_get_miss_filter(int iter)
+{
+	cas_ub_get(&cas_ub_fid[1], iter);
+}
+
+struct m0_ub_set m0_cas_ub = {
+	.us_name = "cas-ub",
+	.us_init = cas_ub_init,
+	.us_fini = cas_ub_fini,
+	.us_run  = {
+		{ .ub_name  = "get-90-miss",
+		  .ub_iter  = CAS_UB_ITER,
+		  .ub_round = cas_ub_get_miss },
+
+		{ .ub_name  = "get-90-miss-filter",
+		  .ub_iter  = CAS_UB_ITER,
+		  .ub_round = cas_ub_get_miss_filter },
+
+		{ .ub_name = NULL }
+	}
+};
+
 #undef M0_TRACE_SUBSYSTEM
 
 /** @} end of cas group */
@@ -471,7 +471,8 @@ M0_INTERNAL struct m0_cm_type cmtype ## _cmt = {				\
 		.rst_name    = (name),				\
 		.rst_ops     = (ops),				\
 		.rst_level   = M0_RS_LEVEL_NORMAL,		\
-		.rst_typecode = (typecode)			\
+		.rst_typecode = (typecode),			\
+		.rst_fom_prio = M0_FOM_PRIO_BG			\
 	}							\
 }
 
@@ -171,6 +171,24 @@ M0_INTERNAL void m0_dix_target(struct m0_dix_linst *inst,
 			key, src.sa_group, unit, *out_id);
 }
 
+/**
+ * Maps all units of the parity group of the record with the key "key".
+ * "tgt" is an array of N + K + S elements.
+ */
+static void dix_group_map(struct m0_dix_linst        *inst,
+			  struct m0_buf              *key,
+			  struct m0_pdclust_tgt_addr *tgt)
+{
+	uint64_t group = 0;
+
+	if (key->b_addr != NULL)
+		dix_hash(inst->li_ldescr, key, &group);
+	if (M0_FI_ENABLED("pdcluster-map"))
+		m0_pdclust_instance_map_groups(inst->li_pi, group, 1, tgt);
+	else
+		m0_fd_fwd_map_groups(inst->li_pi, group, 1, tgt);
+}
+
 M0_INTERNAL int m0_dix_ldesc_init(struct m0_dix_ldesc       *ld,
 				  struct m0_ext             *range,
 				  m0_bcount_t                range_nr,
@@ -246,6 +264,13 @@ int m0_dix_layout_iter_init(struct m0_dix_layout_iter *iter,
 		       pver->pv_attr.pa_N);
 	iter->dit_W = pd_attr->pa_N + pd_attr->pa_K + pd_attr->pa_S;
 	iter->dit_unit = 0;
+	M0_ALLOC_ARR(iter->dit_tgt, iter->dit_W);
+	if (iter->dit_tgt == NULL) {
+		m0_buf_free(&iter->dit_key);
+		m0_dix_layout_fini(&iter->dit_linst);
+		return M0_ERR(-ENOMEM);
+	}
+	dix_group_map(&iter->dit_linst, &iter->dit_key, iter->dit_tgt);
 	return M0_RC(rc);
 }
 
@@ -262,7 +287,8 @@ M0_INTERNAL void m0_dix_layout_iter_get_at(struct m0_dix_layout_iter *iter,
 					   uint64_t                   unit,
 					   uint64_t                  *tgt)
 {
-	m0_dix_target(&iter->dit_linst, unit, &iter->dit_key, tgt);
+	M0_PRE(unit < iter->dit_W);
+	*tgt = iter->dit_tgt[unit].ta_obj;
 }
 
 M0_INTERNAL uint32_t m0_dix_liter_W(struct m0_dix_layout_iter *iter)
@@ -318,6 +344,7 @@ M0_INTERNAL void m0_dix_layout_iter_reset(struct m0_dix_layout_iter *iter)
 M0_INTERNAL void m0_dix_layout_iter_fini(struct m0_dix_layout_iter *iter)
 {
 	M0_ENTRY("iter %p", iter);
+	m0_free0(&iter->dit_tgt);
 	m0_buf_free(&iter->dit_key);
 	m0_dix_layout_fini(&iter->dit_linst);
 }
@@ -32,6 +32,7 @@
 #include "dix/imask_xc.h"
 #include "lib/buf.h"
 #include "lib/types_xc.h"
+#include "xcode/xcode.h"          /* m0_void_t */
 
 /**
  * @addtogroup dix
@@ -99,6 +100,9 @@ struct m0_dix_composite_ldesc {
 struct m0_dix_layout {
 	uint32_t dl_type;
 	union {
+		/** No layout, only the type is sent. */
+		m0_void_t                     dl_unknown
+					M0_XCA_TAG("DIX_LTYPE_UNKNOWN");
 		uint64_t                      dl_id
 					M0_XCA_TAG("DIX_LTYPE_ID");
 		struct m0_dix_ldesc           dl_desc
@@ -145,6 +149,12 @@ struct m0_dix_layout_iter {
 	 * identity mask.
 	 */
 	struct m0_buf       dit_key;
+
+	/**
+	 * Targets of all dit_W units of the record parity group, mapped once
+	 * in m0_dix_layout_iter_init().
+	 */
+	struct m0_pdclust_tgt_addr *dit_tgt;
 };
 
 /**
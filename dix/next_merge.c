@@ -61,12 +61,6 @@ static int sc_rep_cmp(const struct m0_cas_next_reply *a,
 		M0_3WAY(a->cnp_key.b_nob, b->cnp_key.b_nob);
 }
 
-static bool sc_rep_le(const struct m0_cas_next_reply *a,
-		      const struct m0_cas_next_reply *b)
-{
-	return sc_rep_cmp(a, b) < 0;
-}
-
 static bool sc_rep_eq(const struct m0_cas_next_reply *a,
 		      const struct m0_cas_next_reply *b)
 {
@@ -130,8 +124,90 @@ static int sc_key_pos_set(struct m0_dix_next_sort_ctx *ctx,
 	return ctx->sc_pos;
 }
 
+static struct m0_cas_next_reply *
+sc_heap_rep(const struct m0_dix_next_sort_ctx_arr *ctxarr, uint32_t hidx)
+{
+	const struct m0_dix_next_sort_ctx *ctx;
+
+	ctx = &ctxarr->sca_ctx[ctxarr->sca_heap[hidx]];
+	return &ctx->sc_reps[ctx->sc_pos];
+}
+
 /**
- * Searches for the minimal value in all sort contexts.
+ * Heap order: by the key at current position, ties are broken by sort context
+ * index. The latter makes the result independent of the heap shape: among
+ * replicas of a record the one from the first sort context is returned.
+ */
+static bool sc_heap_lt(const struct m0_dix_next_sort_ctx_arr *ctxarr,
+		       uint32_t a, uint32_t b)
+{
+	int cmp = sc_rep_cmp(sc_heap_rep(ctxarr, a), sc_heap_rep(ctxarr, b));
+
+	return cmp < 0 ||
+		(cmp == 0 && ctxarr->sca_heap[a] < ctxarr->sca_heap[b]);
+}
+
+static void sc_heap_down(struct m0_dix_next_sort_ctx_arr *ctxarr, uint32_t i)
+{
+	uint32_t *heap = ctxarr->sca_heap;
+	uint32_t  nr   = ctxarr->sca_heap_nr;
+	uint32_t  min;
+	uint32_t  c;
+
+	while (true) {
+		min = i;
+		c   = 2 * i + 1;
+		if (c < nr && sc_heap_lt(ctxarr, c, min))
+			min = c;
+		if (c + 1 < nr && sc_heap_lt(ctxarr, c + 1, min))
+			min = c + 1;
+		if (min == i)
+			break;
+		M0_SWAP(heap[i], heap[min]);
+		i = min;
+	}
+}
+
+/**
+ * Builds the heap of sort contexts having a record for the current starting
+ * key at current position.
+ */
+static void sc_heap_build(struct m0_dix_next_sort_ctx_arr *ctxarr)
+{
+	struct m0_cas_next_reply *val;
+	uint32_t                  ctx_id;
+	uint32_t                  i;
+
+	ctxarr->sca_heap_nr = 0;
+	for (ctx_id = 0; ctx_id < ctxarr->sca_nr; ctx_id++) {
+		if (sc_rep_get(&ctxarr->sca_ctx[ctx_id], &val) == 0)
+			ctxarr->sca_heap[ctxarr->sca_heap_nr++] = ctx_id;
+	}
+	for (i = ctxarr->sca_heap_nr / 2; i > 0; i--)
+		sc_heap_down(ctxarr, i - 1);
+}
+
+/**
+ * Advances current position of the sort context on the top of the heap and
+ * restores the heap. The context leaves the heap when it has no more records
+ * for the current starting key.
+ */
+static void sc_heap_top_next(struct m0_dix_next_sort_ctx_arr *ctxarr)
+{
+	struct m0_dix_next_sort_ctx *ctx;
+	struct m0_cas_next_reply    *val;
+
+	M0_PRE(ctxarr->sca_heap_nr > 0);
+	ctx = &ctxarr->sca_ctx[ctxarr->sca_heap[0]];
+	sc_next(ctx);
+	if (sc_rep_get(ctx, &val) != 0)
+		ctxarr->sca_heap[0] =
+			ctxarr->sca_heap[--ctxarr->sca_heap_nr];
+	sc_heap_down(ctxarr, 0);
+}
+
+/**
+ * Takes the minimal value in all sort contexts from the heap.
  *
  * After minimal value is found, all sort contexts current positions are moved
  * to the first value that is bigger than found minimal value.
@@ -141,7 +217,7 @@ static int sc_key_pos_set(struct m0_dix_next_sort_ctx *ctx,
  * m0_dix_next_sort_ctx *ret_ctx - sort context which contains "rep"
  * ret_idx - number of rep in cas_next_rep array
  *
- * Returns true if for current starting key there are no more records in all
+ * Returns false if for current starting key there are no more records in all
  * sorting contexts.
  */
 static bool sc_min_val_get(struct m0_dix_next_sort_ctx_arr  *ctxarr,
@@ -149,49 +225,20 @@ static bool sc_min_val_get(struct m0_dix_next_sort_ctx_arr  *ctxarr,
 			   struct m0_dix_next_sort_ctx     **ret_ctx,
 			   uint32_t                         *ret_idx)
 {
-	uint32_t                     ctx_id;
-	uint32_t                     done_cnt  = 0;
-	uint32_t                     nokey_cnt = 0;
 	struct m0_dix_next_sort_ctx *ctx;
-	struct m0_dix_next_sort_ctx *ctx_arr;
-	struct m0_cas_next_reply    *min       = NULL;
-	struct m0_cas_next_reply    *val;
-	int                          rc;
-
-	*ret_ctx = NULL;
-	ctx_arr  = ctxarr->sca_ctx;
-	/* Find minimal value in sort contexts. */
-	for (ctx_id = 0; ctx_id < ctxarr->sca_nr; ctx_id++) {
-		ctx = &ctx_arr[ctx_id];
-		rc = sc_rep_get(ctx, &val);
-		if (rc == NOENT) {
-			nokey_cnt++;
-			continue;
-		}
-		if (rc == PROCESSING_IS_DONE) {
-			done_cnt++;
-			continue;
-		}
-		if (sc_rep_eq(NULL, min) || sc_rep_le(val, min)) {
-			min = val;
-			*ret_ctx = ctx;
-			*ret_idx = ctx->sc_pos;
-		}
-	}
-	*rep = min;
-	if (done_cnt == ctxarr->sca_nr || nokey_cnt == ctxarr->sca_nr)
-		return true;
 
-	/* Advance positions (if necessary) in all sort contexts. */
-	for (ctx_id = 0; ctx_id < ctxarr->sca_nr; ctx_id++) {
-		ctx = &ctx_arr[ctx_id];
-		if (ctx->sc_stop)
-			continue;
-		sc_rep_get(ctx, &val);
-		if (val == NULL || sc_rep_eq(val, min))
-			sc_next(ctx);
-	}
-	return false;
+	if (ctxarr->sca_heap_nr == 0)
+		return false;
+	ctx      = &ctxarr->sca_ctx[ctxarr->sca_heap[0]];
+	*rep     = &ctx->sc_reps[ctx->sc_pos];
+	*ret_ctx = ctx;
+	*ret_idx = ctx->sc_pos;
+	/* Skip the found value in all sort contexts. */
+	do {
+		sc_heap_top_next(ctxarr);
+	} while (ctxarr->sca_heap_nr > 0 &&
+		 sc_rep_eq(sc_heap_rep(ctxarr, 0), *rep));
+	return true;
 }
 
 static int dix_rs_vals_alloc(struct m0_dix_next_resultset *rs,
@@ -252,7 +299,6 @@ static int dix_data_load(struct m0_dix_req            *req,
 M0_INTERNAL int m0_dix_next_result_prepare(struct m0_dix_req *req)
 {
 	struct m0_cas_next_reply        *rep;
-	struct m0_cas_next_reply        *last_rep = NULL;
 	struct m0_dix_next_sort_ctx_arr *ctx_arr;
 	struct m0_dix_next_sort_ctx     *ctxs;
 	uint32_t                         i;
@@ -262,7 +308,6 @@ M0_INTERNAL int m0_dix_next_result_prepare(struct m0_dix_req *req)
 	uint64_t                         start_keys_nr;
 	struct m0_dix_next_resultset    *rs;
 	uint32_t                         ctxs_nr;
-	bool                             done = false;
 	uint32_t                         rc = 0;
 
 	recs_nr       = req->dr_recs_nr;
@@ -290,25 +335,17 @@ M0_INTERNAL int m0_dix_next_result_prepare(struct m0_dix_req *req)
 	if (rc != 0)
 		goto end;
 	/* Scan all results and merge-sort values into resultset. */
-	for (key_id = 0; !done && rc == 0 && key_id < start_keys_nr; key_id++) {
+	for (key_id = 0; key_id < start_keys_nr; key_id++) {
 		uint32_t                     cidx    = 0;
 		struct m0_dix_next_sort_ctx *key_ctx = NULL;
 
 		/* Setup key position for all contexts. */
 		for (ctx_id = 0; ctx_id < ctxs_nr; ctx_id++)
 			sc_key_pos_set(&ctxs[ctx_id], key_id, recs_nr);
-		i = 0;
-		while (rc == 0 && i < recs_nr[key_id]) {
-			if ((done = sc_min_val_get(ctx_arr, &rep, &key_ctx,
-						   &cidx)))
-				break;
-			if (rep != NULL &&
-			   (i == 0 || !sc_rep_eq(last_rep, rep))) {
-				sc_result_add(key_ctx, cidx, rs, key_id, rep);
-				last_rep = rep;
-				i++;
-			}
-		}
+		sc_heap_build(ctx_arr);
+		for (i = 0; i < recs_nr[key_id] &&
+			    sc_min_val_get(ctx_arr, &rep, &key_ctx, &cidx); i++)
+			sc_result_add(key_ctx, cidx, rs, key_id, rep);
 	}
 	/* Free all creqs. We don't need any data from them. */
 	if (!M0_FI_ENABLED("mock_data_load"))
@@ -324,9 +361,17 @@ end:
 static int sc_init(struct m0_dix_next_sort_ctx_arr *ctx_arr, uint32_t nr)
 {
 	ctx_arr->sca_nr = nr;
+	ctx_arr->sca_heap_nr = 0;
 	M0_ALLOC_ARR(ctx_arr->sca_ctx, ctx_arr->sca_nr);
-	if (ctx_arr->sca_ctx == NULL)
+	M0_ALLOC_ARR(ctx_arr->sca_heap, ctx_arr->sca_nr);
+	if (ctx_arr->sca_ctx == NULL || ctx_arr->sca_heap == NULL) {
+		m0_free(ctx_arr->sca_ctx);
+		m0_free(ctx_arr->sca_heap);
+		ctx_arr->sca_ctx  = NULL;
+		ctx_arr->sca_heap = NULL;
+		ctx_arr->sca_nr   = 0;
 		return M0_ERR(-ENOMEM);
+	}
 	return 0;
 }
 
@@ -337,6 +382,7 @@ static void sc_fini(struct m0_dix_next_sort_ctx_arr *ctx_arr)
 	for (i = 0; i < ctx_arr->sca_nr; i++)
 		m0_free(ctx_arr->sca_ctx[i].sc_reps);
 	m0_free(ctx_arr->sca_ctx);
+	m0_free(ctx_arr->sca_heap);
 }
 
 M0_INTERNAL int m0_dix_rs_init(struct m0_dix_next_resultset *rs,
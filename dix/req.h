@@ -124,11 +124,16 @@ struct m0_dix {
  * basically do the following:
  * - In every sorting context find first record related to this starting key and
  *   sets current position to it.
- * - Goes through all sorting contexts looking at records at current position
- *   and find the record with minimal key among them.
- * - Add found record to a result set.
- * - Advances current position in all sorting contexts, so it points to the
- *   first record with a key bigger than the found one.
+ * - Builds a binary min-heap of sorting contexts having a record at current
+ *   position, ordered by the key of this record.
+ * - Takes the record with minimal key from the top of the heap and adds it to
+ *   a result set.
+ * - Advances current position in all sorting contexts on the top of the heap
+ *   with the same key (replicas of the found record), so they point to the
+ *   first record with a key bigger than the found one, and restores the heap.
+ *
+ * Thus merging R records from T component catalogues takes O(R * log(T))
+ * key comparisons.
  */
 struct m0_dix_next_sort_ctx {
 	struct m0_cas_req        *sc_creq;
@@ -142,6 +147,12 @@ struct m0_dix_next_sort_ctx {
 struct m0_dix_next_sort_ctx_arr {
 	struct m0_dix_next_sort_ctx *sca_ctx;
 	uint32_t                     sca_nr;
+	/**
+	 * Min-heap of indices in sca_ctx[] of sorting contexts with a record
+	 * at current position.
+	 */
+	uint32_t                    *sca_heap;
+	uint32_t                     sca_heap_nr;
 };
 
 /**
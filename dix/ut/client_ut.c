@@ -2753,6 +2753,7 @@ enum {
 	CASE_2,
 	CASE_3,
 	CASE_4,
+	CASE_5,
 };
 
 static void keys_alloc(struct m0_bufvec *cas_reps,
@@ -3212,6 +3213,77 @@ static int case_4_data(struct m0_bufvec *cas_reps,
 	return 0;
 }
 
+/*
+ * Wide merge: 16 component catalogues, every key is stored in two of them
+ * (key k in catalogues k % 8 and k % 8 + 8).
+ * int keys[] = {1, 50};
+ * int nrs[]  = {10, 10};
+ * arrN[]     = 10 keys >= 1 and 10 keys >= 50 stored in catalogue N.
+ * Result must be:
+ *  1  : 1 2 ... 10
+ *  50 : 50 51 ... 59
+ */
+static int case_5_data(struct m0_bufvec *cas_reps,
+		       struct m0_bufvec *dix_reps,
+		       uint32_t         **recs_nr,
+		       struct m0_bufvec *start_keys,
+		       uint32_t         *ctx_nr)
+{
+	enum { CTX_NR = 16, REPLICA = 8, RECS = 10 };
+	static const uint64_t keys[] = { 1, 50 };
+	int                   rc;
+	int                   i;
+	int                   j;
+	int                   n;
+	uint64_t              key;
+	uint32_t              start_keys_nr = ARRAY_SIZE(keys);
+	struct m0_bufvec     *reps;
+
+	*ctx_nr = CTX_NR;
+	rc = m0_bufvec_alloc(start_keys, start_keys_nr, sizeof (uint64_t));
+	M0_UT_ASSERT(rc == 0);
+	M0_ALLOC_ARR(*recs_nr, start_keys_nr);
+	M0_UT_ASSERT(*recs_nr != NULL);
+	rc = m0_bufvec_alloc(cas_reps, *ctx_nr, sizeof (struct m0_bufvec));
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < *ctx_nr; i++) {
+		rc = m0_bufvec_alloc(cas_reps->ov_buf[i],
+				     start_keys_nr * RECS,
+				     sizeof (struct m0_cas_next_reply));
+		M0_UT_ASSERT(rc == 0);
+	}
+	rc = m0_bufvec_alloc(dix_reps, start_keys_nr,
+			     sizeof (struct m0_bufvec));
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < start_keys_nr; i++) {
+		rc = m0_bufvec_alloc(dix_reps->ov_buf[i], RECS,
+				     sizeof (struct m0_dix_next_reply));
+		M0_UT_ASSERT(rc == 0);
+	}
+	keys_alloc(cas_reps, dix_reps);
+	for (i = 0; i < start_keys_nr; i++) {
+		(*recs_nr)[i] = RECS;
+		*(uint64_t *)start_keys->ov_buf[i] = keys[i];
+	}
+	/* Every catalogue returns RECS records for every starting key. */
+	for (i = 0; i < *ctx_nr; i++) {
+		reps = cas_reps->ov_buf[i];
+		n = 0;
+		for (j = 0; j < start_keys_nr; j++) {
+			for (key = keys[j]; key % REPLICA != i % REPLICA; key++)
+				;
+			for (; n < (j + 1) * RECS; n++, key += REPLICA)
+				crep_val_set(reps, n, key);
+		}
+	}
+	for (i = 0; i < start_keys_nr; i++) {
+		reps = dix_reps->ov_buf[i];
+		for (j = 0; j < RECS; j++)
+			drep_val_set(reps, j, keys[i] + j);
+	}
+	return 0;
+}
+
 static int dix_rep_cmp(struct m0_dix_next_reply *a, struct m0_dix_next_reply *b)
 {
 	if (a == NULL && b == NULL)
@@ -3270,6 +3342,7 @@ static int (*cases[]) (struct m0_bufvec *cas_reps,
 	[CASE_2] = case_2_data,
 	[CASE_3] = case_3_data,
 	[CASE_4] = case_4_data,
+	[CASE_5] = case_5_data,
 };
 
 void static results_check(struct m0_dix_req *req, struct m0_bufvec *dix_reps)
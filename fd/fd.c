@@ -124,6 +124,15 @@ static bool is_cache_valid(const struct m0_fd_perm_cache *cache,
 
 static uint64_t tree2pv_level_conv(uint64_t level, uint64_t tree_depth);
 
+static int  perm_lru_init(struct m0_fd_perm_lru *lru);
+static void perm_lru_fini(struct m0_fd_perm_lru *lru);
+/**
+ * Makes m0_pdclust_instance::pi_fd_tgt[] valid for the tile omega, using the
+ * permutations shared through m0_fd_tree::ft_perm_lru. Returns false if
+ * the shared cache is not available.
+ */
+static bool tile_perm_get(struct m0_pdclust_instance *pi, uint64_t omega);
+
 static bool is_objv(const struct m0_conf_obj *obj,
 		    const struct m0_conf_obj_type *type)
 {
@@ -724,7 +733,32 @@ M0_INTERNAL int m0_fd__perm_cache_build(struct m0_fd_tree *tree)
 	       tree->ft_cache_info.fci_nr * sizeof cache_len[0]);
 	m0_free(tree->ft_cache_info.fci_info);
 	tree->ft_cache_info.fci_info = cache_len;
-	return M0_RC(0);
+	rc = perm_lru_init(&tree->ft_perm_lru);
+	if (rc != 0)
+		m0_fd__perm_cache_destroy(tree);
+	return M0_RC(rc);
+}
+
+static int perm_lru_init(struct m0_fd_perm_lru *lru)
+{
+	M0_SET0(lru);
+	M0_ALLOC_ARR(lru->fpl_entry, M0_FD_PERM_LRU_NR);
+	if (lru->fpl_entry == NULL)
+		return M0_ERR(-ENOMEM);
+	m0_mutex_init(&lru->fpl_lock);
+	return 0;
+}
+
+static void perm_lru_fini(struct m0_fd_perm_lru *lru)
+{
+	uint32_t i;
+
+	if (lru->fpl_entry == NULL)
+		return;
+	for (i = 0; i < M0_FD_PERM_LRU_NR; ++i)
+		m0_free(lru->fpl_entry[i].fple_tgt);
+	m0_free0(&lru->fpl_entry);
+	m0_mutex_fini(&lru->fpl_lock);
 }
 
 static void cache_info_update(struct m0_fd_cache_info *cache_info, uint64_t cnt)
@@ -820,6 +854,7 @@ M0_INTERNAL void m0_fd_tree_destroy(struct m0_fd_tree *tree)
 M0_INTERNAL void m0_fd__perm_cache_destroy(struct m0_fd_tree *tree)
 {
 	M0_PRE(tree != NULL);
+	perm_lru_fini(&tree->ft_perm_lru);
 	m0_free(tree->ft_cache_info.fci_info);
 	tree->ft_cache_info.fci_nr = 0;
 }
@@ -860,6 +895,13 @@ M0_INTERNAL void m0_fd_fwd_map(struct m0_pdclust_instance *pi,
 	M0_ASSERT(tile != NULL);
 	/* Get location in fault-tolerant permutation. */
 	m0_fd_src_to_tgt(tile, src, tgt);
+	M0_ASSERT(tile->ft_G != 0);
+	C = tile->ft_rows * tile->ft_cols / tile->ft_G;
+	omega = src->sa_group / C;
+	if (tile_perm_get(pi, omega)) {
+		tgt->ta_obj = pi->pi_fd_tgt[tgt->ta_obj];
+		return;
+	}
 	tree_depth = pver->pv_fd_tile.ft_depth;
 	for (i = 1, children = 1; i < tree_depth; ++i) {
 		children *= tile->ft_child[i];
@@ -869,12 +911,132 @@ M0_INTERNAL void m0_fd_fwd_map(struct m0_pdclust_instance *pi,
 		vidx        %= children;
 		children    /= tile->ft_child[i];
 	}
-	M0_ASSERT(tile->ft_G != 0);
-	C = tile->ft_rows * tile->ft_cols / tile->ft_G;
 	m0_dec(C, src->sa_group, &omega, &src_base.sa_group);
 	permuted_tgt_get(pi, omega, rel_vidx, &tgt->ta_obj);
 }
 
+M0_INTERNAL void m0_fd_fwd_map_groups(struct m0_pdclust_instance *pi,
+				      uint64_t group, uint64_t nr,
+				      struct m0_pdclust_tgt_addr *tgt)
+{
+	const struct m0_fd_tile_cell *cell;
+	struct m0_pdclust_src_addr    src;
+	struct m0_fd_tile            *tile;
+	uint64_t                      omega;
+	uint64_t                      frame0;
+	uint64_t                      C;
+	uint64_t                      G;
+	uint64_t                      j;
+	uint64_t                      g;
+	uint64_t                      u;
+	bool                          cached;
+
+	M0_PRE(pi != NULL && tgt != NULL);
+
+	tile = &pool_ver_get(pi)->pv_fd_tile;
+	M0_ASSERT(tile->ft_G != 0);
+	G = tile->ft_G;
+	C = tile->ft_rows * tile->ft_cols / G;
+	m0_dec(C, group, &omega, &j);
+	cached = tile_perm_get(pi, omega);
+	frame0 = omega * tile->ft_rows;
+	for (g = 0; g < nr; ++g) {
+		if (cached) {
+			cell = &tile->ft_cell[m0_enc(G, j, 0)];
+			for (u = 0; u < G; ++u, ++cell, ++tgt) {
+				*tgt = cell->ftc_tgt;
+				tgt->ta_obj    = pi->pi_fd_tgt[tgt->ta_obj];
+				tgt->ta_frame += frame0;
+			}
+		} else {
+			src.sa_group = group + g;
+			for (src.sa_unit = 0; src.sa_unit < G; ++src.sa_unit)
+				m0_fd_fwd_map(pi, &src, tgt++);
+		}
+		if (++j == C && g + 1 < nr) {
+			j = 0;
+			++omega;
+			cached = tile_perm_get(pi, omega);
+			frame0 = omega * tile->ft_rows;
+		}
+	}
+}
+
+static bool tile_perm_get(struct m0_pdclust_instance *pi, uint64_t omega)
+{
+	struct m0_pool_version      *pver;
+	struct m0_fd_tile           *tile;
+	struct m0_fd_perm_lru       *lru;
+	struct m0_fd_perm_lru_entry *e;
+	struct m0_fd_perm_lru_entry *victim;
+	struct m0_fid               *gfid;
+	uint64_t                     rel_vidx[M0_CONF_PVER_HEIGHT];
+	uint64_t                     children;
+	uint64_t                     top;
+	uint64_t                     vidx;
+	uint64_t                     col;
+	uint64_t                     i;
+
+	if (pi->pi_fd_tgt != NULL && pi->pi_fd_omega == omega)
+		return true;
+	pver = pool_ver_get(pi);
+	tile = &pver->pv_fd_tile;
+	lru  = &pver->pv_fd_tree.ft_perm_lru;
+	gfid = &pi->pi_base.li_gfid;
+	if (lru->fpl_entry == NULL)
+		return false;
+	if (pi->pi_fd_tgt == NULL) {
+		M0_ALLOC_ARR(pi->pi_fd_tgt, tile->ft_cols);
+		if (pi->pi_fd_tgt == NULL)
+			return false;
+	}
+	m0_mutex_lock(&lru->fpl_lock);
+	e      = NULL;
+	victim = &lru->fpl_entry[0];
+	for (i = 0; i < M0_FD_PERM_LRU_NR; ++i) {
+		if (lru->fpl_entry[i].fple_tgt != NULL &&
+		    lru->fpl_entry[i].fple_omega == omega &&
+		    m0_fid_eq(&lru->fpl_entry[i].fple_gfid, gfid)) {
+			e = &lru->fpl_entry[i];
+			break;
+		}
+		if (lru->fpl_entry[i].fple_used < victim->fple_used)
+			victim = &lru->fpl_entry[i];
+	}
+	if (e == NULL) {
+		e = victim;
+		if (e->fple_tgt == NULL) {
+			M0_ALLOC_ARR(e->fple_tgt, tile->ft_cols);
+			if (e->fple_tgt == NULL) {
+				m0_mutex_unlock(&lru->fpl_lock);
+				return false;
+			}
+		}
+		for (i = 1, top = 1; i < tile->ft_depth; ++i)
+			top *= tile->ft_child[i];
+		/* See m0_fd_fwd_map() for the decomposition of a column. */
+		for (col = 0; col < tile->ft_cols; ++col) {
+			children = top;
+			for (i = 1, vidx = col; i <= tile->ft_depth; ++i) {
+				rel_vidx[i]  = vidx / children;
+				vidx        %= children;
+				children    /= tile->ft_child[i];
+			}
+			permuted_tgt_get(pi, omega, rel_vidx, &e->fple_tgt[col]);
+		}
+		e->fple_gfid  = *gfid;
+		e->fple_omega = omega;
+		++lru->fpl_miss;
+	} else
+		++lru->fpl_hit;
+	e->fple_used = ++lru->fpl_clock;
+	memcpy(pi->pi_fd_tgt, e->fple_tgt,
+	       tile->ft_cols * sizeof pi->pi_fd_tgt[0]);
+	m0_mutex_unlock(&lru->fpl_lock);
+	pi->pi_fd_omega = omega;
+	return true;
+}
+
 static void permuted_tgt_get(struct m0_pdclust_instance *pi, uint64_t omega,
 			     uint64_t *rel_vidx, uint64_t *tgt_idx)
 {
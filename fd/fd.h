@@ -27,6 +27,7 @@
 
 #include "layout/pdclust.h"
 #include "conf/obj.h"        /* M0_CONF_PVER_HEIGHT */
+#include "lib/mutex.h"       /* m0_mutex */
 
 /**
  * @defgroup failure_domains Failure Domains
@@ -183,6 +184,55 @@ struct m0_fd_perm_cache {
 	uint64_t       *fpc_inverse;
 };
 
+enum {
+	/** Number of tile permutations kept in m0_fd_perm_lru. */
+	M0_FD_PERM_LRU_NR = 64,
+};
+
+/**
+ * Cascaded permutations of a tile, flattened over the failure domains tree:
+ * fple_tgt[x] is the target to which column x of the fault tolerant tile is
+ * moved in the tile fple_omega of the file fple_gfid.
+ */
+struct m0_fd_perm_lru_entry {
+	struct m0_fid  fple_gfid;
+	uint64_t       fple_omega;
+	/** Value of m0_fd_perm_lru::fpl_clock when the entry was last used. */
+	uint64_t       fple_used;
+	/**
+	 * Array of m0_fd_tile::ft_cols elements. NULL until the entry is used
+	 * for the first time.
+	 */
+	uint64_t      *fple_tgt;
+};
+
+/**
+ * Recently used tile permutations of a pool version.
+ *
+ * Building the permutations of a tile walks the failure domains tree and
+ * regenerates a permutation at every level, which costs O(P^2) for a pool of
+ * width P. Layout instances are built per request, so their own
+ * m0_fd_perm_cache-s are cold for every request. This cache is shared by all
+ * layout instances using the tree and lets a request start from
+ * permutations computed by earlier requests.
+ *
+ * The least recently used entry is replaced on a miss. Entries are looked up
+ * once per tile (see m0_fd_fwd_map()), so a linear scan is good enough.
+ */
+struct m0_fd_perm_lru {
+	/** Protects all fields below. */
+	struct m0_mutex              fpl_lock;
+	uint64_t                     fpl_clock;
+	uint64_t                     fpl_hit;
+	uint64_t                     fpl_miss;
+	/**
+	 * Array of M0_FD_PERM_LRU_NR elements. NULL if the cache is not
+	 * initialised, in which case tiles are always permuted through
+	 * m0_pdclust_instance::pi_perm_cache.
+	 */
+	struct m0_fd_perm_lru_entry *fpl_entry;
+};
+
 struct m0_fd_cache_info {
 	/** Total number of permutation caches required. */
 	uint64_t  fci_nr;
@@ -207,6 +257,8 @@ struct m0_fd_tree {
 	uint64_t                ft_cnt;
 	/** Holds the information relevant to build a permutation cache.  */
 	struct m0_fd_cache_info ft_cache_info;
+	/** Tile permutations shared by layout instances. */
+	struct m0_fd_perm_lru   ft_perm_lru;
 };
 
 struct m0_fd_tree_node {
@@ -319,6 +371,23 @@ M0_INTERNAL void m0_fd_fwd_map(struct m0_pdclust_instance *pi,
 			       const struct m0_pdclust_src_addr *src,
 			       struct m0_pdclust_tgt_addr *tgt);
 
+/**
+ * Maps all units of "nr" consecutive parity groups, starting from "group".
+ *
+ * This is equivalent to calling m0_fd_fwd_map() for every unit, but the
+ * permutation of every tile is looked up once and no divisions are done per
+ * unit.
+ *
+ * @param[in]  pi    Parity declustered layout instance for a particular file.
+ * @param[in]  group The first parity group to be mapped.
+ * @param[in]  nr    Number of parity groups to be mapped.
+ * @param[out] tgt   Array of nr * (N + K + S) elements. Unit u of the group
+ *                   (group + g) is mapped to tgt[g * (N + K + S) + u].
+ */
+M0_INTERNAL void m0_fd_fwd_map_groups(struct m0_pdclust_instance *pi,
+				      uint64_t group, uint64_t nr,
+				      struct m0_pdclust_tgt_addr *tgt);
+
 /**
  * Maps a target and frame from the pool version, to appropriate
  * parity group and its unit.
@@ -116,6 +116,7 @@ M0_INTERNAL int fd_ut_tree_init(struct m0_fd_tree *tree, uint64_t tree_depth)
 	M0_PRE(tree != NULL);
 	M0_PRE(tree_depth < M0_CONF_PVER_HEIGHT);
 
+	M0_SET0(tree);
 	tree->ft_depth = tree_depth;
 	tree->ft_cnt   = 0;
 	tree->ft_root  = m0_alloc(sizeof tree->ft_root[0]);
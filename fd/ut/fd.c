@@ -32,6 +32,7 @@
 #include "lib/errno.h"      /* EINVAL */
 #include "conf/ut/common.h" /* m0_conf_ut_ast_thread_init */
 #include "ut/ut.h"          /* M0_UT_ASSERT */
+#include "lib/ub.h"
 
 /* Conf parameters. */
 
@@ -123,6 +124,9 @@ static bool is_tgt_failed(struct m0_pool_version *pv,
 static void failed_nodes_mark(struct m0_fd_tree *tree, uint32_t level,
 			      uint64_t tol, uint64_t *failed_domains);
 static void fd_tolerance_check(struct m0_pool_version *pv);
+static void fd_map_groups_check(struct m0_pool_version *pv,
+				struct m0_pdclust_instance *pi,
+				uint64_t group, uint64_t nr);
 
 static void test_fd_mapping_sanity(enum tree_attr ta)
 {
@@ -233,10 +237,53 @@ static void fd_mapping_check(struct m0_pool_version *pv)
 			++unmapped;
 	}
 	M0_UT_ASSERT(unmapped + pv->pv_fd_tile.ft_cols == P);
+	fd_map_groups_check(pv, &pi, omega * C + C / 2, 2 * C + 1);
 	m0_pdclust_perm_cache_destroy(pi.pi_base.li_l, &pi);
 	m0_free(pi.pi_base.li_l);
 }
 
+static void fd_map_groups_check(struct m0_pool_version *pv,
+				struct m0_pdclust_instance *pi,
+				uint64_t group, uint64_t nr)
+{
+	struct m0_fd_perm_lru      *lru = &pv->pv_fd_tree.ft_perm_lru;
+	struct m0_fd_perm_lru_entry *entry;
+	struct m0_pdclust_instance  pi2;
+	struct m0_pdclust_tgt_addr *tgts;
+	struct m0_pdclust_tgt_addr  t;
+	uint64_t                    G = pv->pv_fd_tile.ft_G;
+	uint64_t                    hit;
+	uint64_t                    i;
+
+	M0_ALLOC_ARR(tgts, nr * G);
+	M0_UT_ASSERT(tgts != NULL);
+	m0_fd_fwd_map_groups(pi, group, nr, tgts);
+	for (i = 0; i < nr * G; ++i) {
+		src.sa_group = group + i / G;
+		src.sa_unit  = i % G;
+		m0_fd_fwd_map(pi, &src, &t);
+		M0_UT_ASSERT(t.ta_obj == tgts[i].ta_obj);
+		M0_UT_ASSERT(t.ta_frame == tgts[i].ta_frame);
+		/* Same mapping without the shared permutation cache. */
+		entry = lru->fpl_entry;
+		lru->fpl_entry = NULL;
+		pi->pi_fd_omega = ~(uint64_t)0;
+		m0_fd_fwd_map(pi, &src, &t);
+		lru->fpl_entry = entry;
+		M0_UT_ASSERT(t.ta_obj == tgts[i].ta_obj);
+		M0_UT_ASSERT(t.ta_frame == tgts[i].ta_frame);
+	}
+	/* Another instance of the same file finds the permutations cached. */
+	pi2.pi_base.li_l    = pi->pi_base.li_l;
+	pi2.pi_base.li_gfid = pi->pi_base.li_gfid;
+	m0_pdclust_perm_cache_build(pi2.pi_base.li_l, &pi2);
+	hit = lru->fpl_hit;
+	m0_fd_fwd_map_groups(&pi2, group, 1, tgts);
+	M0_UT_ASSERT(lru->fpl_hit == hit + 1);
+	m0_pdclust_perm_cache_destroy(pi2.pi_base.li_l, &pi2);
+	m0_free(tgts);
+}
+
 static uint64_t real_child_cnt_get(uint64_t level)
 {
 	M0_UT_ASSERT(level < M0_CONF_PVER_HEIGHT);
@@ -549,3 +596,148 @@ struct m0_ut_suite failure_domains_ut = {
 		{ NULL, NULL }
 	}
 };
+
+/*
+ * Mapping benchmark on a wide pool: 8 racks of 16 disks, 16+4+2 layout. An
+ * iteration maps all units of one parity group, so that ops/sec reported for
+ * different rounds are comparable.
+ */
+
+enum {
+	UB_ITER    = 200000,
+	UB_RACKS   = 8,
+	UB_DISKS   = 16,
+	/* Parity groups in a request. */
+	UB_REQ_NR  = 4,
+	/* Tiles touched by requests, fits into m0_fd_perm_lru. */
+	UB_TILE_NR = M0_FD_PERM_LRU_NR / 2,
+};
+
+static struct m0_pool_version      ub_pv;
+static struct m0_layout            ub_l;
+static struct m0_pdclust_instance  ub_pi;
+static struct m0_pdclust_tgt_addr *ub_tgt;
+static struct m0_fd_perm_lru_entry *ub_entry;
+static uint64_t                    ub_C;
+static uint64_t                    ub_G;
+
+static const struct m0_pdclust_attr ub_attr = {
+	.pa_N         = 16,
+	.pa_K         = 4,
+	.pa_S         = 2,
+	.pa_P         = UB_RACKS * UB_DISKS,
+	.pa_unit_size = 4096,
+};
+
+static int ub_init(const char *opts M0_UNUSED)
+{
+	struct m0_fd_tree *tree = &ub_pv.pv_fd_tree;
+	int                rc;
+
+	M0_SET0(&ub_pv);
+	rc = fd_ut_tree_init(tree, 2) ?:
+		m0_fd__tree_root_create(tree, UB_RACKS) ?:
+		fd_ut_tree_level_populate(tree, UB_DISKS, 1, TA_SYMM) ?:
+		fd_ut_tree_level_populate(tree, 0, 2, TA_SYMM) ?:
+		m0_fd__perm_cache_build(tree);
+	M0_UB_ASSERT(rc == 0);
+	fd_ut_symm_tree_get(tree, ub_pv.pv_fd_tile.ft_child);
+	rc = m0_fd__tile_init(&ub_pv.pv_fd_tile, &ub_attr,
+			      ub_pv.pv_fd_tile.ft_child, tree->ft_depth);
+	M0_UB_ASSERT(rc == 0);
+	m0_fd__tile_populate(&ub_pv.pv_fd_tile);
+	M0_UB_ASSERT(ub_pv.pv_fd_tile.ft_cols == ub_attr.pa_P);
+
+	ub_G = ub_pv.pv_fd_tile.ft_G;
+	ub_C = ub_pv.pv_fd_tile.ft_rows * ub_pv.pv_fd_tile.ft_cols / ub_G;
+	ub_l.l_pver = &ub_pv;
+	ub_pi.pi_base.li_l = &ub_l;
+	m0_fid_set(&ub_pi.pi_base.li_gfid, 0x1000, 0x2000);
+	rc = m0_pdclust_perm_cache_build(&ub_l, &ub_pi);
+	M0_UB_ASSERT(rc == 0);
+	M0_ALLOC_ARR(ub_tgt, UB_REQ_NR * ub_G);
+	M0_UB_ASSERT(ub_tgt != NULL);
+	return 0;
+}
+
+static void ub_fini(void)
+{
+	m0_free(ub_tgt);
+	m0_pdclust_perm_cache_destroy(&ub_l, &ub_pi);
+	m0_fd_tree_destroy(&ub_pv.pv_fd_tree);
+	m0_fd_tile_destroy(&ub_pv.pv_fd_tile);
+}
+
+/* Rounds "*-walk" permute tiles through the failure domains tree only. */
+static void ub_lru_off(void)
+{
+	ub_entry = ub_pv.pv_fd_tree.ft_perm_lru.fpl_entry;
+	ub_pv.pv_fd_tree.ft_perm_lru.fpl_entry = NULL;
+	ub_pi.pi_fd_omega = ~(uint64_t)0;
+}
+
+static void ub_lru_on(void)
+{
+	ub_pv.pv_fd_tree.ft_perm_lru.fpl_entry = ub_entry;
+}
+
+static void ub_unit(int iter)
+{
+	struct m0_pdclust_src_addr s = { .sa_group = iter };
+
+	for (s.sa_unit = 0; s.sa_unit < ub_G; ++s.sa_unit)
+		m0_fd_fwd_map(&ub_pi, &s, &ub_tgt[s.sa_unit]);
+}
+
+static void ub_groups(int iter)
+{
+	m0_fd_fwd_map_groups(&ub_pi, iter, 1, ub_tgt);
+}
+
+/*
+ * A request of UB_REQ_NR groups in a random tile, mapped through a new layout
+ * instance as the client does.
+ */
+static void ub_req(int iter)
+{
+	struct m0_pdclust_instance pi = {};
+	uint64_t                   seed = iter;
+	int                        rc;
+
+	pi.pi_base.li_l    = &ub_l;
+	pi.pi_base.li_gfid = ub_pi.pi_base.li_gfid;
+	rc = m0_pdclust_perm_cache_build(&ub_l, &pi);
+	M0_UB_ASSERT(rc == 0);
+	m0_fd_fwd_map_groups(&pi, (m0_rnd64(&seed) % UB_TILE_NR) * ub_C,
+			     UB_REQ_NR, ub_tgt);
+	m0_pdclust_perm_cache_destroy(&ub_l, &pi);
+}
+
+struct m0_ub_set m0_fd_ub = {
+	.us_name = "fd-ub",
+	.us_init = ub_init,
+	.us_fini = ub_fini,
+	.us_run  = {
+		{ .ub_name  = "unit-walk",
+		  .ub_iter  = UB_ITER,
+		  .ub_init  = ub_lru_off,
+		  .ub_round = ub_unit,
+		  .ub_fini  = ub_lru_on },
+		{ .ub_name  = "unit",
+		  .ub_iter  = UB_ITER,
+		  .ub_round = ub_unit },
+		{ .ub_name  = "groups",
+		  .ub_iter  = UB_ITER,
+		  .ub_round = ub_groups },
+		{ .ub_name  = "req-walk",
+		  .ub_iter  = UB_ITER / 100,
+		  .ub_init  = ub_lru_off,
+		  .ub_round = ub_req,
+		  .ub_fini  = ub_lru_on },
+		{ .ub_name  = "req",
+		  .ub_iter  = UB_ITER / 100,
+		  .ub_round = ub_req },
+		{ .ub_name = NULL }
+	}
+};
+
@@ -42,6 +42,7 @@ M0_INTERNAL void m0_fdmi_filter_init(struct m0_fdmi_filter    *flt)
 	M0_PRE(flt != NULL);
 
 	flt->ff_root = NULL;
+	flt->ff_code = NULL;
 
 	M0_LEAVE();
 }
@@ -53,6 +54,7 @@ M0_INTERNAL void m0_fdmi_filter_root_set(struct m0_fdmi_filter    *flt,
 	M0_PRE(flt != NULL);
 	M0_PRE(root != NULL);
 	flt->ff_root = root;
+	m0_free0(&flt->ff_code);
 	M0_LEAVE();
 }
 
@@ -118,6 +120,8 @@ M0_INTERNAL void m0_fdmi_filter_fini(struct m0_fdmi_filter *flt)
 		free_flt_node(flt->ff_root);
 		flt->ff_root = NULL;
 	}
+	/* Allocated as a single block by the evaluator. */
+	m0_free0(&flt->ff_code);
 
 	M0_LEAVE();
 }
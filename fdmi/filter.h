@@ -113,11 +113,20 @@ enum m0_fdmi_flt_op_code {
 	M0_FFO_TOTAL_OPS_CNT
 };
 
+struct m0_fdmi_flt_code;
+
 /**
  * FDMI filter expression
  */
 struct m0_fdmi_filter {
 	struct m0_fdmi_flt_node    *ff_root; /**< Root of the expression tree */
+	/**
+	 * Compiled expression, built by the filter evaluator when the filter
+	 * is evaluated for the first time and freed together with the tree.
+	 *
+	 * @see m0_fdmi_eval_flt()
+	 */
+	struct m0_fdmi_flt_code    *ff_code;
 };
 
 /**
@@ -25,6 +25,9 @@
 
 #include "lib/types.h"
 #include "lib/errno.h"
+#include "lib/memory.h"
+#include "lib/atomic.h"
+#include "lib/finject.h"
 
 #include "fdmi/filter.h"
 #include "fdmi/flt_eval.h"
@@ -127,14 +130,30 @@ M0_INTERNAL void m0_fdmi_eval_del_op_cb(struct m0_fdmi_eval_ctx *ctx,
 	M0_LEAVE();
 }
 
+/** Source of m0_fdmi_eval_ctx::fec_id. */
+static struct m0_atomic64 eval_ctx_id;
+
 M0_INTERNAL void m0_fdmi_eval_init(struct m0_fdmi_eval_ctx *ctx)
 {
 	M0_ENTRY("ctx=%p", ctx);
-	M0_SET_ARR0(ctx->opers);
+	M0_SET0(ctx);
 	init_std_operation_handlers(ctx->opers);
+	ctx->fec_id = m0_atomic64_add_return(&eval_ctx_id, 1);
 	M0_LEAVE();
 }
 
+M0_INTERNAL void m0_fdmi_eval_rec_begin(struct m0_fdmi_eval_ctx *ctx)
+{
+	M0_PRE(ctx->fec_gen == 0);
+	ctx->fec_gen = ++ctx->fec_gen_last;
+}
+
+M0_INTERNAL void m0_fdmi_eval_rec_end(struct m0_fdmi_eval_ctx *ctx)
+{
+	M0_PRE(ctx->fec_gen != 0);
+	ctx->fec_gen = 0;
+}
+
 static int eval_flt_node(struct m0_fdmi_eval_ctx    *ctx,
                          struct m0_fdmi_flt_node    *node,
                          struct m0_fdmi_flt_operand *res,
@@ -181,16 +200,356 @@ static int eval_flt_node(struct m0_fdmi_eval_ctx    *ctx,
 	return M0_RC(rc);
 }
 
+/**
+ * @name Compiled filters
+ *
+ * A filter tree is compiled into postfix code (m0_fdmi_flt_code) executed
+ * with an operand stack, avoiding recursion and per-node dispatch.
+ *
+ * Every sub-expression containing variables is described by a canonical key
+ * built from the node contents, so that equal sub-expressions of different
+ * filters get the same shared slot in the evaluator context. While a record
+ * is evaluated (m0_fdmi_eval_rec_begin()), the value computed for a slot is
+ * remembered, and other filters push it instead of computing it again. Hence
+ * a variable used by all filters is retrieved once per record, and so is a
+ * predicate common to several filters.
+ *
+ * @{
+ */
+
+static struct m0_fdmi_eval_shared *shared_get(struct m0_fdmi_eval_ctx *ctx,
+					      int32_t                  slot)
+{
+	struct m0_fdmi_eval_shared *sh;
+
+	if (slot < 0 || ctx->fec_gen == 0)
+		return NULL;
+	sh = &ctx->fec_shared[slot];
+	return sh->fes_gen == ctx->fec_gen ? sh : NULL;
+}
+
+static void shared_put(struct m0_fdmi_eval_ctx          *ctx,
+		       int32_t                           slot,
+		       const struct m0_fdmi_flt_operand *val)
+{
+	if (slot >= 0 && ctx->fec_gen != 0) {
+		ctx->fec_shared[slot].fes_gen = ctx->fec_gen;
+		ctx->fec_shared[slot].fes_val = *val;
+	}
+}
+
+/**
+ * Returns shared slot for the sub-expression with the given key, or -1 if
+ * there is no free slot.
+ */
+static int32_t shared_slot(struct m0_fdmi_eval_ctx *ctx,
+			   const struct m0_buf     *key)
+{
+	struct m0_fdmi_eval_shared *sh;
+	uint32_t                    i;
+
+	if (ctx->fec_shared == NULL) {
+		M0_ALLOC_ARR(ctx->fec_shared, FDMI_EVAL_SHARED_MAX);
+		if (ctx->fec_shared == NULL)
+			return -1;
+	}
+	for (i = 0; i < ctx->fec_shared_nr; ++i) {
+		if (m0_buf_eq(&ctx->fec_shared[i].fes_key, key))
+			return i;
+	}
+	if (ctx->fec_shared_nr == FDMI_EVAL_SHARED_MAX)
+		return -1;
+	sh = &ctx->fec_shared[ctx->fec_shared_nr];
+	if (m0_buf_copy(&sh->fes_key, key) != 0)
+		return -1;
+	return ctx->fec_shared_nr++;
+}
+
+/** Appends "len" bytes to the key. */
+static int key_add(struct m0_buf *key, const void *data, m0_bcount_t len)
+{
+	char *area;
+
+	if (len == 0)
+		return 0;
+	area = m0_alloc(key->b_nob + len);
+	if (area == NULL)
+		return M0_ERR(-ENOMEM);
+	if (key->b_nob != 0)
+		memcpy(area, key->b_addr, key->b_nob);
+	memcpy(area + key->b_nob, data, len);
+	m0_free(key->b_addr);
+	key->b_addr = area;
+	key->b_nob += len;
+	return 0;
+}
+
+static int key_add_u64(struct m0_buf *key, uint64_t val)
+{
+	return key_add(key, &val, sizeof val);
+}
+
+static int key_add_operand(struct m0_buf                    *key,
+			   const struct m0_fdmi_flt_operand *opnd)
+{
+	const struct m0_fdmi_flt_opnd_pld *pld = &opnd->ffo_data;
+	int                                rc;
+
+	rc = key_add(key, "C", 1) ?:
+	     key_add_u64(key, opnd->ffo_type) ?:
+	     key_add_u64(key, pld->fpl_type);
+	if (rc != 0)
+		return rc;
+	switch (pld->fpl_type) {
+	case M0_FF_OPND_PLD_INT:
+		return key_add_u64(key, pld->fpl_pld.fpl_integer);
+	case M0_FF_OPND_PLD_UINT:
+		return key_add_u64(key, pld->fpl_pld.fpl_uinteger);
+	case M0_FF_OPND_PLD_BOOL:
+		return key_add_u64(key, !!pld->fpl_pld.fpl_boolean);
+	case M0_FF_OPND_PLD_BUF:
+		return key_add_u64(key, pld->fpl_pld.fpl_buf.b_nob) ?:
+			key_add(key, pld->fpl_pld.fpl_buf.b_addr,
+				pld->fpl_pld.fpl_buf.b_nob);
+	default:
+		return M0_ERR(-EINVAL);
+	}
+}
+
+static struct m0_fdmi_flt_insn *insn_add(struct m0_fdmi_flt_code *code,
+					 enum m0_fdmi_flt_insn_type type,
+					 struct m0_fdmi_flt_node *node)
+{
+	struct m0_fdmi_flt_insn *insn = &code->fc_insn[code->fc_nr++];
+
+	*insn = (struct m0_fdmi_flt_insn) {
+		.fi_type = type,
+		.fi_slot = -1,
+		.fi_node = node
+	};
+	return insn;
+}
+
+/**
+ * Emits code computing the value of "node" at the stack depth "depth".
+ *
+ * Returns canonical key of the sub-expression in "key" and sets "*var" if
+ * the sub-expression contains variables.
+ */
+static int flt_emit(struct m0_fdmi_eval_ctx *ctx,
+		    struct m0_fdmi_flt_code *code,
+		    struct m0_fdmi_flt_node *node,
+		    uint32_t                 depth,
+		    struct m0_buf           *key,
+		    bool                    *var)
+{
+	struct m0_fdmi_flt_op_node *on = &node->ffn_u.ffn_oper;
+	struct m0_fdmi_flt_insn    *insn;
+	struct m0_buf               sub;
+	uint32_t                    at;
+	bool                        sub_var;
+	int                         rc;
+	int                         i;
+
+	if (depth >= FDMI_FLT_STACK_MAX)
+		return M0_ERR(-E2BIG);
+	*var = false;
+	switch (node->ffn_type) {
+	case M0_FLT_OPERAND_NODE:
+		insn_add(code, M0_FFI_CONST, node);
+		return key_add_operand(key, &node->ffn_u.ffn_operand);
+	case M0_FLT_VARIABLE_NODE:
+		*var = true;
+		rc = key_add(key, "V", 1) ?:
+		     key_add(key, node->ffn_u.ffn_var.ffvn_data.b_addr,
+			     node->ffn_u.ffn_var.ffvn_data.b_nob);
+		if (rc == 0)
+			insn_add(code, M0_FFI_VAR, node)->fi_slot =
+				shared_slot(ctx, key);
+		return rc;
+	case M0_FLT_OPERATION_NODE:
+		if (on->ffon_op_code >= M0_FFO_TOTAL_OPS_CNT ||
+		    on->ffon_opnds.fno_cnt < 0 ||
+		    on->ffon_opnds.fno_cnt > FDMI_FLT_MAX_OPNDS_NR)
+			return M0_ERR(-EINVAL);
+		rc = key_add(key, "O", 1) ?:
+		     key_add_u64(key, on->ffon_op_code) ?:
+		     key_add_u64(key, on->ffon_opnds.fno_cnt);
+		if (rc != 0)
+			return rc;
+		/* Placeholder for M0_FFI_SHARED, removed if not needed. */
+		at = code->fc_nr;
+		insn_add(code, M0_FFI_SHARED, node);
+		for (i = 0; i < on->ffon_opnds.fno_cnt; i++) {
+			sub = M0_BUF_INIT0;
+			rc = flt_emit(ctx, code,
+				      on->ffon_opnds.fno_opnds[i].ffnp_ptr,
+				      depth + i, &sub, &sub_var) ?:
+			     key_add_u64(key, sub.b_nob) ?:
+			     key_add(key, sub.b_addr, sub.b_nob);
+			m0_buf_free(&sub);
+			if (rc != 0)
+				return rc;
+			*var |= sub_var;
+		}
+		insn = insn_add(code, M0_FFI_OP, node);
+		insn->fi_op = on->ffon_op_code;
+		insn->fi_nr = on->ffon_opnds.fno_cnt;
+		if (*var)
+			insn->fi_slot = shared_slot(ctx, key);
+		if (insn->fi_slot >= 0) {
+			code->fc_insn[at].fi_slot = insn->fi_slot;
+			code->fc_insn[at].fi_nr = code->fc_nr - at - 1;
+		} else {
+			/* Skip counts are relative, moving is safe. */
+			memmove(&code->fc_insn[at], &code->fc_insn[at + 1],
+				(code->fc_nr - at - 1) * sizeof *insn);
+			code->fc_nr--;
+		}
+		return 0;
+	default:
+		return M0_ERR(-EINVAL);
+	}
+}
+
+/** Returns the number of nodes in the tree, or -E2BIG if it is too deep. */
+static int flt_nodes_nr(const struct m0_fdmi_flt_node *node, uint32_t depth)
+{
+	const struct m0_fdmi_flt_op_node *on = &node->ffn_u.ffn_oper;
+	int                               nr = 1;
+	int                               rc;
+	int                               i;
+
+	if (depth >= FDMI_FLT_STACK_MAX)
+		return M0_ERR(-E2BIG);
+	if (node->ffn_type != M0_FLT_OPERATION_NODE)
+		return 1;
+	for (i = 0; i < on->ffon_opnds.fno_cnt; i++) {
+		rc = flt_nodes_nr(on->ffon_opnds.fno_opnds[i].ffnp_ptr,
+				  depth + 1);
+		if (rc < 0)
+			return rc;
+		nr += rc;
+	}
+	return nr;
+}
+
+static int flt_compile(struct m0_fdmi_eval_ctx *ctx,
+		       struct m0_fdmi_filter   *flt)
+{
+	struct m0_fdmi_flt_code *code;
+	struct m0_buf            key = M0_BUF_INIT0;
+	bool                     var;
+	int                      nr;
+	int                      rc;
+
+	M0_ENTRY("ctx=%p flt=%p", ctx, flt);
+	m0_free0(&flt->ff_code);
+	nr = flt_nodes_nr(flt->ff_root, 0);
+	/* Every operation takes at most 2 instructions. */
+	code = nr < 0 ? NULL :
+		m0_alloc(sizeof *code + 2 * nr * sizeof code->fc_insn[0]);
+	if (code == NULL) {
+		/* Remember the failure, so that the tree is walked. */
+		M0_ALLOC_PTR(code);
+		if (code == NULL)
+			return M0_ERR(-ENOMEM);
+		rc = nr < 0 ? nr : -ENOMEM;
+	} else {
+		rc = flt_emit(ctx, code, flt->ff_root, 0, &key, &var);
+		m0_buf_free(&key);
+		if (rc != 0)
+			code->fc_nr = 0;
+	}
+	code->fc_ctx_id = ctx->fec_id;
+	flt->ff_code = code;
+	return M0_RC(rc);
+}
+
+static int flt_code_run(struct m0_fdmi_eval_ctx       *ctx,
+			const struct m0_fdmi_flt_code *code,
+			struct m0_fdmi_eval_var_info  *var_info,
+			struct m0_fdmi_flt_operand    *res)
+{
+	struct m0_fdmi_flt_operand     stack[FDMI_FLT_STACK_MAX];
+	struct m0_fdmi_flt_operands    opnds;
+	const struct m0_fdmi_flt_insn *insn;
+	struct m0_fdmi_eval_shared    *sh;
+	m0_fdmi_flt_op_cb_t            op;
+	uint32_t                       sp = 0;
+	uint32_t                       i;
+	int                            rc;
+
+	for (i = 0; i < code->fc_nr; i++) {
+		insn = &code->fc_insn[i];
+		switch (insn->fi_type) {
+		case M0_FFI_CONST:
+			stack[sp++] = insn->fi_node->ffn_u.ffn_operand;
+			break;
+		case M0_FFI_SHARED:
+			sh = shared_get(ctx, insn->fi_slot);
+			if (sh != NULL) {
+				stack[sp++] = sh->fes_val;
+				i += insn->fi_nr;
+			}
+			break;
+		case M0_FFI_VAR:
+			sh = shared_get(ctx, insn->fi_slot);
+			if (sh != NULL) {
+				stack[sp++] = sh->fes_val;
+				break;
+			}
+			if (var_info == NULL || var_info->get_value_cb == NULL)
+				return M0_ERR(-EINVAL);
+			rc = var_info->get_value_cb(var_info->user_data,
+					&insn->fi_node->ffn_u.ffn_var,
+					&stack[sp]);
+			if (rc != 0)
+				return M0_RC(rc);
+			shared_put(ctx, insn->fi_slot, &stack[sp++]);
+			break;
+		case M0_FFI_OP:
+			op = ctx->opers[insn->fi_op];
+			if (op == NULL)
+				return M0_ERR(-EINVAL);
+			M0_ASSERT(sp >= insn->fi_nr);
+			sp -= insn->fi_nr;
+			opnds.ffp_count = insn->fi_nr;
+			memcpy(opnds.ffp_operands, &stack[sp],
+			       insn->fi_nr * sizeof stack[0]);
+			rc = op(&opnds, &stack[sp]);
+			if (rc != 0)
+				return M0_RC(rc);
+			shared_put(ctx, insn->fi_slot, &stack[sp++]);
+			break;
+		default:
+			M0_IMPOSSIBLE("Invalid instruction");
+		}
+	}
+	M0_ASSERT(sp == 1);
+	*res = stack[0];
+	return 0;
+}
+
+/** @} end of Compiled filters */
+
 M0_INTERNAL int m0_fdmi_eval_flt(struct m0_fdmi_eval_ctx      *ctx,
                                  struct m0_conf_fdmi_filter   *filter,
                                  struct m0_fdmi_eval_var_info *var_info)
 {
+	struct m0_fdmi_filter     *flt = &filter->ff_filter;
 	int                        rc;
 	struct m0_fdmi_flt_operand res;
 
 	M0_ENTRY();
 
-	rc = eval_flt_node(ctx, filter->ff_filter.ff_root, &res, var_info);
+	if (flt->ff_code == NULL || flt->ff_code->fc_ctx_id != ctx->fec_id)
+		(void)flt_compile(ctx, flt);
+	if (flt->ff_code != NULL && flt->ff_code->fc_nr != 0 &&
+	    !M0_FI_ENABLED("tree_walk"))
+		rc = flt_code_run(ctx, flt->ff_code, var_info, &res);
+	else
+		rc = eval_flt_node(ctx, flt->ff_root, &res, var_info);
 
 	if (rc == 0) {
 		M0_ASSERT(res.ffo_type == M0_FF_OPND_BOOL);
@@ -203,7 +562,13 @@ M0_INTERNAL int m0_fdmi_eval_flt(struct m0_fdmi_eval_ctx      *ctx,
 
 M0_INTERNAL void m0_fdmi_eval_fini(struct m0_fdmi_eval_ctx *ctx)
 {
+	uint32_t i;
+
 	M0_ENTRY("ctx=%p", ctx);
+	for (i = 0; i < ctx->fec_shared_nr; ++i)
+		m0_buf_free(&ctx->fec_shared[i].fes_key);
+	m0_free0(&ctx->fec_shared);
+	ctx->fec_shared_nr = 0;
 	M0_LEAVE();
 }
 
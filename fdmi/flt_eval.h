@@ -51,6 +51,71 @@ struct m0_fdmi_flt_operands {
 typedef int (*m0_fdmi_flt_op_cb_t)(struct m0_fdmi_flt_operands *opnds,
                                    struct m0_fdmi_flt_operand  *res);
 
+enum {
+	/** Maximal depth of the operand stack of a compiled filter. */
+	FDMI_FLT_STACK_MAX   = 32,
+	/** Maximal number of sub-expressions shared between filters. */
+	FDMI_EVAL_SHARED_MAX = 256
+};
+
+/**
+ * Instruction types of a compiled filter.
+ *
+ * Compiled filter is the filter tree flattened in postfix order: operands
+ * are pushed to the stack, operation pops its operands and pushes the
+ * result.
+ */
+enum m0_fdmi_flt_insn_type {
+	/** Push constant operand of fi_node. */
+	M0_FFI_CONST,
+	/** Push value of the variable fi_node. */
+	M0_FFI_VAR,
+	/** Pop fi_nr operands, push result of the operation fi_op. */
+	M0_FFI_OP,
+	/**
+	 * If the sub-expression in the slot fi_slot is already evaluated for
+	 * the current record, push its value and skip the next fi_nr
+	 * instructions, which compute it.
+	 */
+	M0_FFI_SHARED
+};
+
+struct m0_fdmi_flt_insn {
+	uint32_t                 fi_type; /**< m0_fdmi_flt_insn_type */
+	uint32_t                 fi_op;   /**< m0_fdmi_flt_op_code */
+	uint32_t                 fi_nr;
+	/** Shared slot the result is stored to, or -1. */
+	int32_t                  fi_slot;
+	struct m0_fdmi_flt_node *fi_node;
+};
+
+/**
+ * Compiled filter expression.
+ *
+ * Built by m0_fdmi_eval_flt() on the first evaluation of a filter and
+ * stored in m0_fdmi_filter::ff_code. Slot numbers refer to the evaluator
+ * context the code was compiled for, the code is rebuilt if the filter is
+ * evaluated in another context. fc_nr == 0 means that the filter cannot be
+ * compiled (e.g., it is too deep) and is evaluated by walking the tree.
+ */
+struct m0_fdmi_flt_code {
+	uint64_t                fc_ctx_id;
+	uint32_t                fc_nr;
+	struct m0_fdmi_flt_insn fc_insn[0];
+};
+
+/**
+ * Sub-expression containing variables, which is evaluated once per record
+ * for all filters of an evaluator context.
+ */
+struct m0_fdmi_eval_shared {
+	/** Canonical representation of the sub-expression. */
+	struct m0_buf              fes_key;
+	/** Record generation fes_val is valid for. */
+	uint64_t                   fes_gen;
+	struct m0_fdmi_flt_operand fes_val;
+};
+
 /**
  * FDMI filter evaluator context
  *
@@ -59,7 +124,18 @@ typedef int (*m0_fdmi_flt_op_cb_t)(struct m0_fdmi_flt_operands *opnds,
 struct m0_fdmi_eval_ctx {
 	/** Array of operation handlers. Index is code of
 	  * operation from @ref m0_fdmi_flt_op_code */
-	m0_fdmi_flt_op_cb_t  opers[M0_FFO_TOTAL_OPS_CNT];
+	m0_fdmi_flt_op_cb_t         opers[M0_FFO_TOTAL_OPS_CNT];
+	/** Unique identifier, compiled filters are bound to it. */
+	uint64_t                    fec_id;
+	/**
+	 * Generation of the record being evaluated, 0 outside of
+	 * m0_fdmi_eval_rec_begin()/m0_fdmi_eval_rec_end().
+	 */
+	uint64_t                    fec_gen;
+	uint64_t                    fec_gen_last;
+	uint32_t                    fec_shared_nr;
+	/** Array of FDMI_EVAL_SHARED_MAX elements, allocated on demand. */
+	struct m0_fdmi_eval_shared *fec_shared;
 };
 
 /**
@@ -111,6 +187,11 @@ M0_INTERNAL void m0_fdmi_eval_del_op_cb(struct m0_fdmi_eval_ctx *ctx,
  *
  * Result of filter expression is always boolean.
  *
+ * The filter is compiled on its first evaluation (see m0_fdmi_flt_code);
+ * subsequent evaluations run the compiled code. Between
+ * m0_fdmi_eval_rec_begin() and m0_fdmi_eval_rec_end() values of variables
+ * and of sub-expressions shared by several filters are computed once.
+ *
  * @param filter   FDMI filter
  * @param ctx      FDMI filter evaluator context
  * @param var_info Information about how to get value of variable nodes
@@ -122,6 +203,18 @@ M0_INTERNAL int m0_fdmi_eval_flt(struct m0_fdmi_eval_ctx      *ctx,
                                  struct m0_conf_fdmi_filter   *filter,
                                  struct m0_fdmi_eval_var_info *var_info);
 
+/**
+ * Starts evaluation of filters against a new record.
+ *
+ * Until m0_fdmi_eval_rec_end(), variable values returned by
+ * m0_fdmi_eval_var_info::get_value_cb() and results of operations are
+ * assumed to depend on the record only, and are cached in the context.
+ */
+M0_INTERNAL void m0_fdmi_eval_rec_begin(struct m0_fdmi_eval_ctx *ctx);
+
+/** Ends evaluation of filters against the record. */
+M0_INTERNAL void m0_fdmi_eval_rec_end(struct m0_fdmi_eval_ctx *ctx);
+
 /**
  * Finalize FDMI evaluator
  *
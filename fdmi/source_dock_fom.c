@@ -389,6 +389,8 @@ static int apply_filters(struct fdmi_sd_fom     *sd_fom,
 	M0_ENTRY("sd_fom %p, src_rec %p", sd_fom, src_rec);
 	M0_PRE(m0_fdmi__record_is_valid(src_rec));
 
+	/* Variables common to the filters are retrieved once per record. */
+	m0_fdmi_eval_rec_begin(&sd_fom->fsf_flt_eval);
 	do {
 		/* @todo fco_get_next shouldn't block (phase 2) */
 		m0_fom_block_enter(fom);
@@ -417,6 +419,7 @@ static int apply_filters(struct fdmi_sd_fom     *sd_fom,
 			rc = ret;
 		}
 	} while (ret > 0);
+	m0_fdmi_eval_rec_end(&sd_fom->fsf_flt_eval);
 	return M0_RC(rc);
 }
 
@@ -28,6 +28,7 @@
 #include "lib/finject.h"
 #include "xcode/xcode.h"
 #include "ut/ut.h"
+#include "lib/ub.h"
 #include "conf/obj.h"           /* m0_conf_fdmi_filter */
 
 /* ------------------------------------------------------------------
@@ -390,6 +391,277 @@ static void flt_str_ops(void)
 	m0_fdmi_filter_fini(&flt);
 }
 
+/* ------------------------------------------------------------------
+ * Test Case: compiled filters and shared sub-expressions
+ * ------------------------------------------------------------------ */
+
+/** Record with two fields, "a" and "b", available as filter variables. */
+struct flt_rec {
+	uint64_t fr_a;
+	uint64_t fr_b;
+	/** Number of get_value_cb() calls. */
+	int      fr_calls;
+};
+
+static int flt_rec_var(void                        *data,
+		       struct m0_fdmi_flt_var_node *var,
+		       struct m0_fdmi_flt_operand  *val)
+{
+	struct flt_rec *rec = data;
+
+	rec->fr_calls++;
+	if (m0_buf_streq(&var->ffvn_data, "a"))
+		m0_fdmi_flt_uint_opnd_fill(val, rec->fr_a);
+	else if (m0_buf_streq(&var->ffvn_data, "b"))
+		m0_fdmi_flt_uint_opnd_fill(val, rec->fr_b);
+	else
+		return -ENOENT;
+	return 0;
+}
+
+static struct m0_fdmi_flt_node *flt_var_node_create(const char *name)
+{
+	struct m0_buf data;
+	int           rc;
+
+	rc = m0_buf_copy(&data, &M0_BUF_INITS((char *)name));
+	M0_ASSERT(rc == 0);
+	return m0_fdmi_flt_var_node_create(&data);
+}
+
+/** Initialises the filter "(a > ka) || (b > kb)". */
+static void flt_rec_filter_init(struct m0_conf_fdmi_filter *filter,
+				uint64_t ka, uint64_t kb)
+{
+	struct m0_fdmi_flt_node *root;
+
+	root = m0_fdmi_flt_op_node_create(
+		M0_FFO_OR,
+		m0_fdmi_flt_op_node_create(M0_FFO_GT, flt_var_node_create("a"),
+					   m0_fdmi_flt_uint_node_create(ka)),
+		m0_fdmi_flt_op_node_create(M0_FFO_GT, flt_var_node_create("b"),
+					   m0_fdmi_flt_uint_node_create(kb)));
+	M0_ASSERT(root != NULL);
+	m0_fdmi_filter_init(&filter->ff_filter);
+	m0_fdmi_filter_root_set(&filter->ff_filter, root);
+	filter->ff_type = M0_FDMI_FILTER_TYPE_TREE;
+}
+
+enum { FLT_COMP_NR = 10 };
+
+static void flt_eval_compiled(void)
+{
+	struct m0_conf_fdmi_filter   filters[FLT_COMP_NR];
+	struct m0_conf_fdmi_filter   deep;
+	struct m0_fdmi_eval_ctx      eval_ctx;
+	struct m0_fdmi_eval_ctx      eval_ctx2;
+	struct m0_fdmi_eval_var_info info;
+	struct m0_fdmi_flt_node     *root;
+	struct flt_rec               rec;
+	uint64_t                     a;
+	uint64_t                     b;
+	int                          expected;
+	int                          res;
+	int                          i;
+
+	info.user_data    = &rec;
+	info.get_value_cb = flt_rec_var;
+	m0_fdmi_eval_init(&eval_ctx);
+	/* Pairs of filters are equal and share all sub-expressions. */
+	for (i = 0; i < FLT_COMP_NR; i++)
+		flt_rec_filter_init(&filters[i], i / 2 * 10, 50 - i / 2 * 10);
+
+	for (a = 0; a < 60; a += 7) {
+		for (b = 0; b < 60; b += 11) {
+			rec = (struct flt_rec) { .fr_a = a, .fr_b = b };
+			m0_fdmi_eval_rec_begin(&eval_ctx);
+			for (i = 0; i < FLT_COMP_NR; i++) {
+				expected = a > i / 2 * 10 || b > 50 - i / 2 * 10;
+				res = m0_fdmi_eval_flt(&eval_ctx, &filters[i],
+						       &info);
+				M0_UT_ASSERT(res == expected);
+				M0_UT_ASSERT(filters[i].ff_filter.ff_code->fc_nr
+					     > 0);
+			}
+			m0_fdmi_eval_rec_end(&eval_ctx);
+			/* Every variable is retrieved once per record. */
+			M0_UT_ASSERT(rec.fr_calls == 2);
+
+			/* Tree walk gives the same results. */
+			rec.fr_calls = 0;
+			m0_fi_enable("m0_fdmi_eval_flt", "tree_walk");
+			m0_fdmi_eval_rec_begin(&eval_ctx);
+			for (i = 0; i < FLT_COMP_NR; i++) {
+				expected = a > i / 2 * 10 || b > 50 - i / 2 * 10;
+				res = m0_fdmi_eval_flt(&eval_ctx, &filters[i],
+						       &info);
+				M0_UT_ASSERT(res == expected);
+			}
+			m0_fdmi_eval_rec_end(&eval_ctx);
+			m0_fi_disable("m0_fdmi_eval_flt", "tree_walk");
+			M0_UT_ASSERT(rec.fr_calls == 2 * FLT_COMP_NR);
+		}
+	}
+
+	/* Nothing is cached outside of rec_begin()/rec_end(). */
+	rec = (struct flt_rec) { .fr_a = 100, .fr_b = 0 };
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &filters[0], &info) == 1);
+	rec.fr_a = 0;
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &filters[0], &info) == 0);
+	M0_UT_ASSERT(rec.fr_calls == 4);
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &filters[0], NULL) ==
+		     -EINVAL);
+
+	/* Filter evaluated in another context is compiled again. */
+	m0_fdmi_eval_init(&eval_ctx2);
+	M0_UT_ASSERT(eval_ctx2.fec_id != eval_ctx.fec_id);
+	rec.fr_a = 100;
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx2, &filters[0], &info) == 1);
+	M0_UT_ASSERT(filters[0].ff_filter.ff_code->fc_ctx_id ==
+		     eval_ctx2.fec_id);
+	m0_fdmi_eval_fini(&eval_ctx2);
+
+	/* Filter deeper than the operand stack is evaluated by tree walk. */
+	root = m0_fdmi_flt_op_node_create(M0_FFO_GT, flt_var_node_create("b"),
+					  m0_fdmi_flt_uint_node_create(0));
+	for (i = 0; i < FDMI_FLT_STACK_MAX; i++)
+		root = m0_fdmi_flt_op_node_create(
+			M0_FFO_OR, m0_fdmi_flt_bool_node_create(false), root);
+	m0_fdmi_filter_init(&deep.ff_filter);
+	m0_fdmi_filter_root_set(&deep.ff_filter, root);
+	deep.ff_type = M0_FDMI_FILTER_TYPE_TREE;
+	rec.fr_b = 1;
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &deep, &info) == 1);
+	M0_UT_ASSERT(deep.ff_filter.ff_code->fc_nr == 0);
+	rec.fr_b = 0;
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &deep, &info) == 0);
+	m0_fdmi_filter_fini(&deep.ff_filter);
+
+	/* Errors of variable retrieval are returned. */
+	root = m0_fdmi_flt_op_node_create(M0_FFO_GT, flt_var_node_create("c"),
+					  m0_fdmi_flt_uint_node_create(0));
+	m0_fdmi_filter_init(&deep.ff_filter);
+	m0_fdmi_filter_root_set(&deep.ff_filter, root);
+	M0_UT_ASSERT(m0_fdmi_eval_flt(&eval_ctx, &deep, &info) == -ENOENT);
+	m0_fdmi_filter_fini(&deep.ff_filter);
+
+	for (i = 0; i < FLT_COMP_NR; i++)
+		m0_fdmi_filter_fini(&filters[i].ff_filter);
+	m0_fdmi_eval_fini(&eval_ctx);
+}
+
+/* ------------------------------------------------------------------
+ * Benchmark: records/sec evaluated against 1, 10 and 100 filters
+ * ------------------------------------------------------------------ */
+
+enum {
+	FLT_UB_ITER       = 100000,
+	FLT_UB_FILTERS_NR = 100
+};
+
+static struct m0_conf_fdmi_filter flt_ub_filters[FLT_UB_FILTERS_NR];
+static struct m0_fdmi_eval_ctx    flt_ub_ctx;
+static struct flt_rec             flt_ub_rec;
+
+static int flt_ub_init(const char *opts M0_UNUSED)
+{
+	int i;
+
+	m0_fdmi_eval_init(&flt_ub_ctx);
+	for (i = 0; i < FLT_UB_FILTERS_NR; i++)
+		flt_rec_filter_init(&flt_ub_filters[i], i,
+				    FLT_UB_FILTERS_NR - i);
+	return 0;
+}
+
+static void flt_ub_fini(void)
+{
+	int i;
+
+	for (i = 0; i < FLT_UB_FILTERS_NR; i++)
+		m0_fdmi_filter_fini(&flt_ub_filters[i].ff_filter);
+	m0_fdmi_eval_fini(&flt_ub_ctx);
+}
+
+static void flt_ub_tree_init(void)
+{
+	m0_fi_enable("m0_fdmi_eval_flt", "tree_walk");
+}
+
+static void flt_ub_tree_fini(void)
+{
+	m0_fi_disable("m0_fdmi_eval_flt", "tree_walk");
+}
+
+/** Evaluates one record against "nr" filters. */
+static void flt_ub_round(int iter, int nr)
+{
+	struct m0_fdmi_eval_var_info info = {
+		.user_data    = &flt_ub_rec,
+		.get_value_cb = flt_rec_var
+	};
+	int                          rc;
+	int                          i;
+
+	flt_ub_rec.fr_a = iter % (FLT_UB_FILTERS_NR + 1);
+	flt_ub_rec.fr_b = iter * 7 % (FLT_UB_FILTERS_NR + 1);
+	m0_fdmi_eval_rec_begin(&flt_ub_ctx);
+	for (i = 0; i < nr; i++) {
+		rc = m0_fdmi_eval_flt(&flt_ub_ctx, &flt_ub_filters[i], &info);
+		M0_UB_ASSERT(rc >= 0);
+	}
+	m0_fdmi_eval_rec_end(&flt_ub_ctx);
+}
+
+static void flt_ub_1(int iter)
+{
+	flt_ub_round(iter, 1);
+}
+
+static void flt_ub_10(int iter)
+{
+	flt_ub_round(iter, 10);
+}
+
+static void flt_ub_100(int iter)
+{
+	flt_ub_round(iter, 100);
+}
+
+struct m0_ub_set m0_fdmi_flt_ub = {
+	.us_name = "fdmi-flt-ub",
+	.us_init = flt_ub_init,
+	.us_fini = flt_ub_fini,
+	.us_run  = {
+		/*                     parameter: number of filters */
+		{ .ub_name  = "tree-1",
+		  .ub_iter  = FLT_UB_ITER,
+		  .ub_init  = flt_ub_tree_init,
+		  .ub_round = flt_ub_1,
+		  .ub_fini  = flt_ub_tree_fini },
+		{ .ub_name  = "comp-1",
+		  .ub_iter  = FLT_UB_ITER,
+		  .ub_round = flt_ub_1 },
+		{ .ub_name  = "tree-10",
+		  .ub_iter  = FLT_UB_ITER,
+		  .ub_init  = flt_ub_tree_init,
+		  .ub_round = flt_ub_10,
+		  .ub_fini  = flt_ub_tree_fini },
+		{ .ub_name  = "comp-10",
+		  .ub_iter  = FLT_UB_ITER,
+		  .ub_round = flt_ub_10 },
+		{ .ub_name  = "tree-100",
+		  .ub_iter  = FLT_UB_ITER / 10,
+		  .ub_init  = flt_ub_tree_init,
+		  .ub_round = flt_ub_100,
+		  .ub_fini  = flt_ub_tree_fini },
+		{ .ub_name  = "comp-100",
+		  .ub_iter  = FLT_UB_ITER / 10,
+		  .ub_round = flt_ub_100 },
+		{ .ub_name = NULL }
+	}
+};
+
 /* ------------------------------------------------------------------
  * Test Sute definition
  * ------------------------------------------------------------------ */
@@ -403,6 +675,7 @@ struct m0_ut_suite fdmi_filter_eval_ut = {
 		/** @todo Move to filter tests */
 		{ "filter-xcode-str", flt_eval_flt_xcode_str },
 		{ "filter-str-ops",   flt_str_ops },
+		{ "compiled",         flt_eval_compiled },
 		{ NULL, NULL },
 	},
 };
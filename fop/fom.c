@@ -130,6 +130,37 @@
  * Thread state transitions, associated lists and counters are protected by
  * the group mutex.
  *
+ * <b>Work stealing</b>
+ *
+ * A fom is normally executed in its home locality. Foms of a type with
+ * m0_fom_type::ft_stealable set can be moved to another locality, as long as
+ * they haven't executed a phase transition yet: at this point the fom has no
+ * locality-bound state (transactions, timers, armed call-backs) except for its
+ * state machines, which are re-attached to the new locality group.
+ *
+ * Because the handler thread of a busy locality keeps its group lock all the
+ * time, foms are not taken directly. Instead, when a handler finds its
+ * run-queue empty, it posts m0_fom_locality::fl_steal_ast to the locality
+ * with the longest run-queue (fom_steal()). The ast is executed by the busy
+ * handler, which detaches up to LOC_STEAL_MAX stealable foms from its
+ * run-queues and posts them to the idle locality (loc_steal_ast()), where they
+ * are put in the run-queue (adoptit()). While in transit, the fom is accounted
+ * in m0_reqh_service::rs_fom_queued, the same as a newly queued fom.
+ *
+ * Work stealing is disabled by default and is enabled per domain
+ * (m0_fom_domain_steal_enable(), m0d option -W).
+ *
+ * m0_fom_locality::fl_steal_pending is set by fom_steal() and is cleared by
+ * loc_steal_done() on every path completing the request: when the ast is
+ * executed (whether or not foms were handed over) or when stealing was
+ * disabled concurrently. m0_fom_domain_fini() disables stealing and waits
+ * until no request is pending before finalising any locality, so that no
+ * steal ast is left in the fork queue of a finalised locality group.
+ *
+ * Steals and per-locality utilisation are reported via ADDB2
+ * (M0_AVI_LOCALITY_STEAL, M0_AVI_LOCALITY_UTIL). A moved fom is reported by
+ * M0_AVI_FOM_MOVE record.
+ *
  * @{
  */
 
@@ -138,6 +169,16 @@ enum {
 	HUNG_FOP_SEC_PERIOD   = 5,
 	HUNG_FOP_TIME_SEC_MAX = 2*60,
 	HUNG_FOP_TIME_SEC_IEM = 5*60,
+	/** Minimal run-queue length of a locality to steal from. */
+	LOC_STEAL_RUNQ_MIN    = 2,
+	/** Maximal number of foms handed over by a single steal request. */
+	LOC_STEAL_MAX         = 8,
+	/** Maximal number of run-queue foms examined by a steal request. */
+	LOC_STEAL_SCAN_MAX    = 32,
+	/** Period of locality utilisation reports. */
+	LOC_UTIL_SEC_PERIOD   = 1,
+	/** Polling period used to wait for pending steal requests to finish. */
+	LOC_STEAL_WAIT_MS     = 1,
 };
 
 /**
@@ -197,6 +238,8 @@ static int loc_thr_create(struct m0_fom_locality *loc);
 
 static void hung_foms_notify(struct m0_locality_chore *chore,
 			     struct m0_locality *loc, void *place);
+static void loc_util_notify(struct m0_locality_chore *chore,
+			    struct m0_locality *loc, void *place);
 
 static struct m0_sm_conf fom_states_conf0;
 M0_INTERNAL struct m0_sm_conf fom_states_conf;
@@ -216,6 +259,13 @@ static const struct m0_locality_chore_ops hung_foms_chore_ops = {
 	.co_tick = hung_foms_notify
 };
 
+/**
+ * Chore which reports locality utilisation.
+ */
+static const struct m0_locality_chore_ops loc_util_chore_ops = {
+	.co_tick = loc_util_notify
+};
+
 static void group_lock(struct m0_fom_locality *loc)
 {
 	m0_sm_group_lock(&loc->fl_group);
@@ -233,7 +283,7 @@ M0_INTERNAL bool m0_fom_group_is_locked(const struct m0_fom *fom)
 
 static bool is_in_runq(const struct m0_fom *fom)
 {
-	return runq_tlist_contains(&fom->fo_loc->fl_runq, fom);
+	return runq_tlist_contains(&fom->fo_loc->fl_runq[fom->fo_prio], fom);
 }
 
 static bool is_in_wail(const struct m0_fom *fom)
@@ -268,14 +318,21 @@ M0_INTERNAL bool m0_locality_invariant(const struct m0_fom_locality *loc)
 	return
 		_0C(loc != NULL && loc->fl_dom != NULL) &&
 		_0C(m0_mutex_is_locked(&loc->fl_group.s_lock)) &&
-		_0C(M0_CHECK_EX(m0_tlist_invariant(&runq_tl, &loc->fl_runq))) &&
+		_0C(m0_forall(i, M0_FOM_PRIO_NR,
+			      M0_CHECK_EX(m0_tlist_invariant(&runq_tl,
+							&loc->fl_runq[i])))) &&
 		_0C(M0_CHECK_EX(m0_tlist_invariant(&wail_tl, &loc->fl_wail))) &&
 		_0C(m0_tl_forall(thr, t, &loc->fl_threads,
 			     t->lt_loc == loc && thread_invariant(t))) &&
 		_0C(ergo(loc->fl_handler != NULL,
 		     thr_tlist_contains(&loc->fl_threads, loc->fl_handler))) &&
-		_0C(M0_CHECK_EX(m0_tl_forall(runq, fom, &loc->fl_runq,
-					 fom->fo_loc == loc))) &&
+		_0C(m0_forall(i, M0_FOM_PRIO_NR,
+			      M0_CHECK_EX(m0_tl_forall(runq, fom,
+						       &loc->fl_runq[i],
+						       fom->fo_loc == loc &&
+						       fom->fo_prio == i)))) &&
+		_0C(loc->fl_runq_nr == m0_reduce(i, M0_FOM_PRIO_NR, 0,
+						 + loc->fl_runq_prio_nr[i])) &&
 		_0C(M0_CHECK_EX(m0_tl_forall(wail, fom, &loc->fl_wail,
 					 fom->fo_loc == loc)));
 }
@@ -313,6 +370,7 @@ M0_INTERNAL bool m0_fom_invariant(const struct m0_fom *fom)
 	return
 		_0C(fom != NULL) && _0C(fom->fo_loc != NULL) &&
 		_0C(fom->fo_type != NULL) && _0C(fom->fo_ops != NULL) &&
+		_0C(IS_IN_ARRAY(fom->fo_prio, fom->fo_loc->fl_runq)) &&
 
 		_0C(m0_fom_group_is_locked(fom)) &&
 
@@ -415,19 +473,43 @@ static bool fom_wait_time_is_out(const struct m0_fom_domain *dom,
  *
  * @post m0_fom_invariant(fom)
  */
-static void fom_ready(struct m0_fom *fom)
+static void fom_runq_add(struct m0_fom *fom)
 {
-	struct m0_fom_locality *loc;
+	struct m0_fom_locality *loc  = fom->fo_loc;
+	enum m0_fom_prio        prio = fom->fo_prio;
 	bool                    empty;
 
-	fom_state_set(fom, M0_FOS_READY);
-	loc = fom->fo_loc;
-	empty = runq_tlist_is_empty(&loc->fl_runq);
-	runq_tlist_add_tail(&loc->fl_runq, fom);
+	M0_PRE(fom_state(fom) == M0_FOS_READY);
+
+	empty = loc->fl_runq_nr == 0;
+	runq_tlist_add_tail(&loc->fl_runq[prio], fom);
 	M0_CNT_INC(loc->fl_runq_nr);
+	M0_CNT_INC(loc->fl_runq_prio_nr[prio]);
 	m0_addb2_hist_mod(&loc->fl_runq_counter, loc->fl_runq_nr);
+	m0_addb2_hist_mod(&loc->fl_runq_prio_counter[prio],
+			  loc->fl_runq_prio_nr[prio]);
 	if (empty)
 		m0_chan_signal(&loc->fl_runrun);
+}
+
+static void fom_runq_del(struct m0_fom *fom)
+{
+	struct m0_fom_locality *loc  = fom->fo_loc;
+	enum m0_fom_prio        prio = fom->fo_prio;
+
+	runq_tlist_del(fom);
+	M0_CNT_DEC(loc->fl_runq_nr);
+	M0_CNT_DEC(loc->fl_runq_prio_nr[prio]);
+	m0_addb2_hist_mod(&loc->fl_runq_counter, loc->fl_runq_nr);
+	m0_addb2_hist_mod(&loc->fl_runq_prio_counter[prio],
+			  loc->fl_runq_prio_nr[prio]);
+}
+
+static void fom_ready(struct m0_fom *fom)
+{
+	fom_state_set(fom, M0_FOS_READY);
+	fom->fo_ready_at = m0_time_now();
+	fom_runq_add(fom);
 	M0_POST(m0_fom_invariant(fom));
 }
 
@@ -585,6 +667,11 @@ M0_INTERNAL void m0_fom_block_enter(struct m0_fom *fom)
 	group_unlock(loc);
 }
 
+M0_INTERNAL bool m0_fom_is_blocked(const struct m0_fom *fom)
+{
+	return fom_is_blocked(fom);
+}
+
 M0_INTERNAL void m0_fom_block_leave(struct m0_fom *fom)
 {
 	struct m0_fom_locality *loc;
@@ -861,24 +948,223 @@ static void fom_exec(struct m0_fom *fom)
 	}
 }
 
+/**
+ * Default run-queue deadlines of priority classes. The highest priority class
+ * is never overtaken, hence it needs no deadline.
+ */
+static const m0_time_t fom_prio_deadline[M0_FOM_PRIO_NR] = {
+	[M0_FOM_PRIO_IO] = 0,
+	[M0_FOM_PRIO_MD] = 10 * M0_TIME_ONE_MSEC,
+	[M0_FOM_PRIO_BG] = 100 * M0_TIME_ONE_MSEC,
+};
+
+static bool fom_deadline_is_out(const struct m0_fom *fom, m0_time_t now)
+{
+	const struct m0_reqh_service_type *stype = fom->fo_type->ft_rstype;
+	m0_time_t                          deadline;
+
+	deadline = stype != NULL && stype->rst_fom_deadline != 0 ?
+		stype->rst_fom_deadline : fom_prio_deadline[fom->fo_prio];
+	return deadline != 0 && m0_time_add(fom->fo_ready_at, deadline) <= now;
+}
+
 /**
  * Dequeues a fom from runq list of the locality.
  *
+ * The head of the highest priority non-empty run-queue is taken, unless the
+ * head of a lower priority run-queue is past its deadline. Foms within a
+ * class are executed in FIFO order.
+ *
  * @retval m0_fom if queue is not empty, NULL otherwise
  */
 static struct m0_fom *fom_dequeue(struct m0_fom_locality *loc)
 {
-	struct m0_fom *fom;
+	struct m0_fom *fom = NULL;
+	struct m0_fom *head;
+	m0_time_t      now;
+	int            prio;
+
+	if (loc->fl_runq_nr == 0)
+		return NULL;
 
-	fom = runq_tlist_pop(&loc->fl_runq);
-	if (fom != NULL) {
-		M0_ASSERT(fom->fo_loc == loc);
-		M0_CNT_DEC(loc->fl_runq_nr);
-		m0_addb2_hist_mod(&loc->fl_runq_counter, loc->fl_runq_nr);
+	now = m0_time_now();
+	for (prio = M0_FOM_PRIO_IO + 1; prio < M0_FOM_PRIO_NR; ++prio) {
+		head = runq_tlist_head(&loc->fl_runq[prio]);
+		if (head != NULL && fom_deadline_is_out(head, now)) {
+			fom = head;
+			break;
+		}
 	}
+	for (prio = 0; fom == NULL; ++prio) {
+		M0_ASSERT(prio < M0_FOM_PRIO_NR);
+		fom = runq_tlist_head(&loc->fl_runq[prio]);
+	}
+	M0_ASSERT(fom->fo_loc == loc);
+	fom_runq_del(fom);
+	m0_addb2_hist_mod(&loc->fl_runq_wait[fom->fo_prio],
+			  m0_time_sub(now, fom->fo_ready_at));
 	return fom;
 }
 
+static bool fom_is_stealable(struct m0_fom *fom)
+{
+	return fom->fo_type->ft_stealable && fom->fo_transitions == 0 &&
+		fom->fo_pending == NULL &&
+		!m0_chan_has_waiters(&fom->fo_sm_phase.sm_chan) &&
+		!m0_chan_has_waiters(&fom->fo_sm_state.sm_chan);
+}
+
+/**
+ * Re-attaches fom state machines to the group of a new locality.
+ *
+ * The fom is in the READY state and didn't execute any phase transition, so
+ * state machine states and epochs are preserved as is.
+ */
+static void fom_sm_move(struct m0_fom *fom, struct m0_fom_locality *to)
+{
+	struct m0_sm *sm[] = { &fom->fo_sm_phase, &fom->fo_sm_state };
+	int           i;
+
+	for (i = 0; i < ARRAY_SIZE(sm); ++i) {
+		m0_chan_fini(&sm[i]->sm_chan);
+		sm[i]->sm_grp = &to->fl_group;
+		m0_chan_init(&sm[i]->sm_chan, &to->fl_group.s_lock);
+	}
+}
+
+/**
+ * Completes fom migration in the new locality. See "Work stealing".
+ */
+static void adoptit(struct m0_sm_group *grp, struct m0_sm_ast *ast)
+{
+	struct m0_fom          *fom = container_of(ast, struct m0_fom,
+						   fo_cb.fc_ast);
+	struct m0_fom_locality *loc = fom->fo_loc;
+
+	M0_PRE(grp == &loc->fl_group);
+	M0_PRE(fom_state(fom) == M0_FOS_READY);
+
+	/*
+	 * The fom was already introduced to addb2 in its home locality. Only
+	 * re-attach state counters to the data of the new locality.
+	 */
+	if (fom_states_conf.scf_addb2_key > 0)
+		fom->fo_sm_state.sm_addb2_stats =
+			m0_locality_data(fom_states_conf.scf_addb2_key - 1);
+	M0_ADDB2_ADD(M0_AVI_FOM_MOVE, (uint64_t)fom, fom->fo_loc_idx,
+		     loc->fl_idx);
+	m0_fom_locality_inc(fom);
+	m0_atomic64_dec(&fom->fo_service->rs_fom_queued);
+	M0_CNT_INC(loc->fl_steal_nr);
+	fom_runq_add(fom);
+	M0_POST(m0_fom_invariant(fom));
+}
+
+/**
+ * Completes a steal request of a given locality.
+ */
+static void loc_steal_done(struct m0_fom_locality *thief)
+{
+	m0_atomic64_set(&thief->fl_steal_pending, 0);
+}
+
+/**
+ * Executed by the handler of a busy locality on a steal request from an idle
+ * locality. Hands over stealable foms from the run-queues.
+ */
+static void loc_steal_ast(struct m0_sm_group *grp, struct m0_sm_ast *ast)
+{
+	struct m0_fom_locality *loc   = container_of(grp,
+						     struct m0_fom_locality,
+						     fl_group);
+	struct m0_fom_locality *thief = container_of(ast,
+						     struct m0_fom_locality,
+						     fl_steal_ast);
+	struct m0_fom          *fom;
+	size_t                  nr    = 0;
+	size_t                  scan  = 0;
+	size_t                  max;
+	int                     prio;
+
+	if (loc->fl_shutdown || thief->fl_shutdown ||
+	    !loc->fl_dom->fd_steal) {
+		loc_steal_done(thief);
+		return;
+	}
+	max = min_check((size_t)LOC_STEAL_MAX, loc->fl_runq_nr / 2);
+	for (prio = 0; prio < M0_FOM_PRIO_NR; ++prio) {
+		m0_tl_for(runq, &loc->fl_runq[prio], fom) {
+			if (nr >= max || scan++ >= LOC_STEAL_SCAN_MAX)
+				break;
+			if (!fom_is_stealable(fom))
+				continue;
+			fom_runq_del(fom);
+			/*
+			 * Account the fom as queued while it is in transit, so
+			 * that m0_fom_domain_is_idle_for() doesn't miss it.
+			 */
+			m0_atomic64_inc(&fom->fo_service->rs_fom_queued);
+			(void)m0_fom_locality_dec(fom);
+			fom_sm_move(fom, thief);
+			/*
+			 * fo_loc_idx keeps the home locality: it is returned
+			 * to the client as m0_be_tx_remid::tri_locality.
+			 */
+			fom->fo_loc = thief;
+			fom->fo_cb.fc_ast.sa_cb = &adoptit;
+			m0_sm_ast_post(&thief->fl_group, &fom->fo_cb.fc_ast);
+			++nr;
+		} m0_tl_endfor;
+	}
+	loc->fl_stolen_nr += nr;
+	if (nr > 0)
+		M0_ADDB2_ADD(M0_AVI_LOCALITY_STEAL, thief->fl_idx, nr);
+	loc_steal_done(thief);
+}
+
+/**
+ * Called by the handler of a locality with empty run-queue. Requests foms from
+ * the locality with the longest run-queue.
+ *
+ * Run-queue lengths of other localities are read without locking: they are
+ * only used as a hint.
+ *
+ * fl_steal_pending is set before m0_fom_domain::fd_steal is checked, pairing
+ * with m0_fom_domain_fini(), which clears fd_steal before waiting for pending
+ * requests.
+ */
+static void fom_steal(struct m0_fom_locality *loc)
+{
+	struct m0_fom_domain   *dom    = loc->fl_dom;
+	struct m0_fom_locality *victim = NULL;
+	struct m0_fom_locality *scan;
+	size_t                  longest = LOC_STEAL_RUNQ_MIN - 1;
+	size_t                  i;
+
+	if (!dom->fd_steal || m0_atomic64_get(&loc->fl_steal_pending) != 0)
+		return;
+	/* Only the handler of this locality sets fl_steal_pending. */
+	m0_atomic64_set(&loc->fl_steal_pending, 1);
+	m0_mb();
+	if (!dom->fd_steal) {
+		loc_steal_done(loc);
+		return;
+	}
+	for (i = 1; i < dom->fd_localities_nr; ++i) {
+		scan = dom->fd_localities[(loc->fl_idx + i) %
+					  dom->fd_localities_nr];
+		if (scan->fl_runq_nr > longest && !scan->fl_shutdown) {
+			longest = scan->fl_runq_nr;
+			victim = scan;
+		}
+	}
+	if (victim != NULL) {
+		loc->fl_steal_ast.sa_cb = &loc_steal_ast;
+		m0_sm_ast_post(&victim->fl_group, &loc->fl_steal_ast);
+	} else
+		loc_steal_done(loc);
+}
+
 /**
  * Locality handler thread. See the "Locality internals" section.
  */
@@ -945,18 +1231,24 @@ static void loc_handler_thread(struct m0_loc_thread *th)
 				    m0_locality_chores_run(&loc->fl_locality));
 			fom = fom_dequeue(loc);
 			if (fom != NULL) {
+				m0_time_t start = m0_time_now();
+
 				fom_addb2_push(fom);
 				fom_exec(fom);
 				m0_addb2_pop(M0_AVI_FOM);
+				loc->fl_busy += m0_time_sub(m0_time_now(),
+							    start);
 			} else if (loc->fl_shutdown)
 				break;
-			else
+			else {
+				fom_steal(loc);
 				/*
 				 * Yes, sleep with the lock held. Knock on
 				 * &loc->fl_runrun or &loc->fl_group.s_clink to
 				 * wake.
 				 */
 				m0_chan_wait(clink);
+			}
 		}
 		loc->fl_handler = NULL;
 		th->lt_state = IDLE;
@@ -1037,6 +1329,7 @@ static void loc_addb2_fini(struct m0_fom_locality *loc)
 static void loc_fini(struct m0_fom_locality *loc)
 {
 	struct m0_loc_thread *th;
+	int                   i;
 
 	loc->fl_shutdown = true;
 	m0_clink_signal(&loc->fl_group.s_clink);
@@ -1052,7 +1345,10 @@ static void loc_fini(struct m0_fom_locality *loc)
 	}
 	group_unlock(loc);
 
-	runq_tlist_fini(&loc->fl_runq);
+	for (i = 0; i < M0_FOM_PRIO_NR; ++i) {
+		runq_tlist_fini(&loc->fl_runq[i]);
+		M0_ASSERT(loc->fl_runq_prio_nr[i] == 0);
+	}
 	M0_ASSERT(loc->fl_runq_nr == 0);
 	wail_tlist_fini(&loc->fl_wail);
 	M0_ASSERT(loc->fl_wail_nr == 0);
@@ -1084,6 +1380,7 @@ static int loc_init(struct m0_fom_locality *loc, struct m0_fom_domain *dom,
 		    size_t idx)
 {
 	int                   res;
+	int                   i;
 	struct m0_addb2_mach *orig = m0_thread_tls()->tls_addb2_mach;
 
 	M0_PRE(loc != NULL);
@@ -1097,11 +1394,16 @@ static int loc_init(struct m0_fom_locality *loc, struct m0_fom_domain *dom,
 		goto err;
 	}
 
-	runq_tlist_init(&loc->fl_runq);
+	for (i = 0; i < M0_FOM_PRIO_NR; ++i) {
+		runq_tlist_init(&loc->fl_runq[i]);
+		loc->fl_runq_prio_nr[i] = 0;
+	}
 	loc->fl_runq_nr = 0;
 	wail_tlist_init(&loc->fl_wail);
 	loc->fl_wail_nr = 0;
 	loc->fl_idx = idx;
+	m0_atomic64_set(&loc->fl_steal_pending, 0);
+	loc->fl_util_epoch = m0_time_now();
 	m0_thread_tls()->tls_addb2_mach = loc->fl_addb2_mach;
 	m0_addb2_push(M0_AVI_NODE, M0_ADDB2_OBJ(&m0_node_uuid));
 	M0_ADDB2_PUSH(M0_AVI_PID, m0_pid());
@@ -1109,6 +1411,13 @@ static int loc_init(struct m0_fom_locality *loc, struct m0_fom_domain *dom,
 	m0_addb2_clock_add(&loc->fl_clock, M0_AVI_CLOCK, -1);
 	m0_addb2_hist_add(&loc->fl_fom_active,   1, 30, M0_AVI_FOM_ACTIVE, -1);
 	m0_addb2_hist_add(&loc->fl_runq_counter, 1, 30, M0_AVI_RUNQ, -1);
+	for (i = 0; i < M0_FOM_PRIO_NR; ++i) {
+		m0_addb2_hist_add(&loc->fl_runq_prio_counter[i], 1, 30,
+				  M0_AVI_RUNQ_PRIO + i, -1);
+		m0_addb2_hist_add_log(&loc->fl_runq_wait[i],
+				      M0_ADDB2_LOGHIST_PRECISION,
+				      M0_AVI_RUNQ_WAIT + i, -1);
+	}
 	m0_addb2_hist_add(&loc->fl_wail_counter, 1, 30, M0_AVI_WAIL, -1);
 	m0_addb2_hist_add_auto(&loc->fl_grp_addb2.ga_forq_hist, 1000,
 			       M0_AVI_LOCALITY_FORQ, -1);
@@ -1133,8 +1442,6 @@ static int loc_init(struct m0_fom_locality *loc, struct m0_fom_domain *dom,
 
 	res = m0_bitmap_init(&loc->fl_processors, dom->fd_localities_nr);
 	if (res == 0) {
-		int i;
-
 		m0_bitmap_set(&loc->fl_processors, idx, true);
 		/* create a pool of idle threads plus the handler thread. */
 		group_lock(loc);
@@ -1181,13 +1488,36 @@ static void hung_foms_notify(struct m0_locality_chore *chore,
 	struct m0_fom_locality *floc = container_of(loc, struct m0_fom_locality,
 						    fl_locality);
 	const struct m0_fom_domain *dom = floc->fl_dom;
+	int                         i;
 
-	(void)m0_tl_forall(runq, fom, &floc->fl_runq,
-			   dom->fd_ops->fdo_time_is_out(dom, fom));
+	for (i = 0; i < M0_FOM_PRIO_NR; ++i)
+		(void)m0_tl_forall(runq, fom, &floc->fl_runq[i],
+				   dom->fd_ops->fdo_time_is_out(dom, fom));
 	(void)m0_tl_forall(wail, fom, &floc->fl_wail,
 			   dom->fd_ops->fdo_time_is_out(dom, fom));
 }
 
+static void loc_util_notify(struct m0_locality_chore *chore,
+			    struct m0_locality *loc, void *place)
+{
+	struct m0_fom_locality *floc = container_of(loc, struct m0_fom_locality,
+						    fl_locality);
+	m0_time_t               now  = m0_time_now();
+	m0_time_t               period;
+
+	period = m0_time_sub(now, floc->fl_util_epoch);
+	if (period == 0)
+		return;
+	/* fl_busy can exceed the period when executing foms block. */
+	M0_ADDB2_ADD(M0_AVI_LOCALITY_UTIL,
+		     min_check(floc->fl_busy, period) * 100 / period,
+		     floc->fl_steal_nr, floc->fl_stolen_nr);
+	floc->fl_busy       = 0;
+	floc->fl_steal_nr   = 0;
+	floc->fl_stolen_nr  = 0;
+	floc->fl_util_epoch = now;
+}
+
 M0_INTERNAL int m0_fom_domain_init(struct m0_fom_domain **out)
 {
 	struct m0_fom_domain   *dom;
@@ -1257,6 +1587,11 @@ M0_INTERNAL int m0_fom_domain_init(struct m0_fom_domain **out)
 				       NULL,
 				       M0_MKTIME(HUNG_FOP_SEC_PERIOD, 0),
 				       0);
+				m0_locality_chore_init(&dom->fd_util_chore,
+				       &loc_util_chore_ops,
+				       NULL,
+				       M0_MKTIME(LOC_UTIL_SEC_PERIOD, 0),
+				       0);
 			}
 		} else
 			result = M0_ERR(-ENOMEM);
@@ -1271,12 +1606,42 @@ M0_INTERNAL int m0_fom_domain_init(struct m0_fom_domain **out)
 	return result;
 }
 
+M0_INTERNAL void m0_fom_domain_steal_enable(struct m0_fom_domain *dom,
+					    bool                  enable)
+{
+	dom->fd_steal = enable;
+	m0_mb();
+}
+
+/**
+ * Disables work stealing and waits until steal requests posted by the
+ * localities of the domain are completed by the victim handlers, which are
+ * still running at this point.
+ */
+static void dom_steal_stop(struct m0_fom_domain *dom)
+{
+	struct m0_fom_locality *loc;
+	size_t                  i;
+
+	m0_fom_domain_steal_enable(dom, false);
+	for (i = 0; i < dom->fd_localities_nr; ++i) {
+		loc = dom->fd_localities[i];
+		if (loc == NULL)
+			continue;
+		while (m0_atomic64_get(&loc->fl_steal_pending) != 0)
+			m0_nanosleep(m0_time(0, LOC_STEAL_WAIT_MS *
+					     M0_TIME_ONE_MSEC), NULL);
+	}
+}
+
 M0_INTERNAL void m0_fom_domain_fini(struct m0_fom_domain *dom)
 {
 	int i;
 
+	m0_locality_chore_fini(&dom->fd_util_chore);
 	m0_locality_chore_fini(&dom->fd_hung_foms_chore);
 	if (dom->fd_localities != NULL) {
+		dom_steal_stop(dom);
 		for (i = dom->fd_localities_nr - 1; i >= 0; --i) {
 			if (dom->fd_localities[i] != NULL)
 				loc_fini(dom->fd_localities[i]);
@@ -1402,6 +1767,10 @@ void m0_fom_init(struct m0_fom *fom, const struct m0_fom_type *fom_type,
 	fom->fo_transitions = 0;
 	fom->fo_local	    = false;
 	fom->fo_local_update = false;
+	fom->fo_prio        = fom_type != NULL && fom_type->ft_rstype != NULL ?
+			      fom_type->ft_rstype->rst_fom_prio :
+			      M0_FOM_PRIO_IO;
+	M0_ASSERT(IS_IN_ARRAY(fom->fo_prio, fom_prio_deadline));
 	m0_fom_callback_init(&fom->fo_cb);
 	runq_tlink_init(fom);
 
@@ -1674,7 +2043,8 @@ M0_INTERNAL struct m0_sm_conf fom_states_conf = {
 	.scf_nr_states = ARRAY_SIZE(fom_states),
 	.scf_state     = fom_states,
 	.scf_trans_nr  = ARRAY_SIZE(fom_trans),
-	.scf_trans     = fom_trans
+	.scf_trans     = fom_trans,
+	.scf_addb2_loghist = M0_ADDB2_LOGHIST_PRECISION
 };
 
 static struct m0_sm_conf fom_states_conf0;
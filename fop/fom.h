@@ -235,6 +235,29 @@ struct m0_loc_thread;
 
 #define FOM_PHASE_DEBUG (1)
 
+/**
+ * Scheduling class of a fom.
+ *
+ * Each locality keeps a run-queue per class. The handler executes foms from
+ * the highest priority (lowest value) non-empty queue. To avoid starvation,
+ * a fom from a lower priority class is executed out of order once it spent
+ * longer than its class deadline in the run-queue.
+ *
+ * The class is taken from m0_reqh_service_type::rst_fom_prio when the fom
+ * is initialised and can be changed by the fom before it is queued.
+ *
+ * @see m0_fom::fo_prio, m0_fom_locality::fl_runq
+ */
+enum m0_fom_prio {
+	/** Client I/O and everything not classified otherwise. */
+	M0_FOM_PRIO_IO,
+	/** Meta-data requests (CAS, mdservice). */
+	M0_FOM_PRIO_MD,
+	/** Background activity: repair, rebalance, garbage collection. */
+	M0_FOM_PRIO_BG,
+	M0_FOM_PRIO_NR
+};
+
 /**
  * A locality is a partition of computational resources dedicated to fom
  * execution on the node.
@@ -255,9 +278,12 @@ struct m0_loc_thread;
 struct m0_fom_locality {
 	struct m0_fom_domain          *fl_dom;
 
-	/** Run-queue */
-	struct m0_tl		       fl_runq;
+	/** Run-queues, one per m0_fom_prio class. */
+	struct m0_tl		       fl_runq[M0_FOM_PRIO_NR];
+	/** Total length of all run-queues. */
 	size_t			       fl_runq_nr;
+	/** Lengths of individual run-queues. */
+	size_t			       fl_runq_prio_nr[M0_FOM_PRIO_NR];
 
 	/** Wait list */
 	struct m0_tl		       fl_wail;
@@ -297,11 +323,34 @@ struct m0_fom_locality {
 	struct m0_addb2_mach          *fl_addb2_mach;
 	struct m0_addb2_hist           fl_fom_active;
 	struct m0_addb2_hist           fl_runq_counter;
+	/** Per class run-queue length. */
+	struct m0_addb2_hist           fl_runq_prio_counter[M0_FOM_PRIO_NR];
+	/** Per class time spent by foms in the run-queue. */
+	struct m0_addb2_hist           fl_runq_wait[M0_FOM_PRIO_NR];
 	struct m0_addb2_hist           fl_wail_counter;
 	struct m0_addb2_sensor         fl_clock;
 	struct m0_locality             fl_locality;
 	struct m0_sm_group_addb2       fl_grp_addb2;
 	struct m0_chan_addb2           fl_chan_addb2;
+	/**
+	 * Ast posted by this (idle) locality to a busy one to request foms.
+	 * See "Work stealing" in fom.c.
+	 */
+	struct m0_sm_ast               fl_steal_ast;
+	/**
+	 * Non-zero while a steal request of this locality is in progress, that
+	 * is, from the moment fom_steal() decides to post fl_steal_ast and till
+	 * the ast is executed or the request is abandoned.
+	 */
+	struct m0_atomic64             fl_steal_pending;
+	/** Foms adopted from other localities in the current period. */
+	uint64_t                       fl_steal_nr;
+	/** Foms handed over to other localities in the current period. */
+	uint64_t                       fl_stolen_nr;
+	/** Time spent executing foms in the current period. */
+	m0_time_t                      fl_busy;
+	/** Start of the current utilisation period. */
+	m0_time_t                      fl_util_epoch;
 	/** Something for memory, see set_mempolicy(2). */
 };
 
@@ -335,7 +384,14 @@ struct m0_fom_domain {
 	const struct m0_fom_domain_ops *fd_ops;
 	/** Long living foms detecting chore. */
 	struct m0_locality_chore        fd_hung_foms_chore;
+	/** Chore reporting locality utilisation. */
+	struct m0_locality_chore        fd_util_chore;
 	struct m0_addb2_sys            *fd_addb2_sys;
+	/**
+	 * True iff idle localities are allowed to steal foms from busy ones.
+	 * See "Work stealing" in fom.c, m0_fom_domain_steal_enable().
+	 */
+	bool                            fd_steal;
 };
 
 /** Operations vector attached to a domain. */
@@ -397,6 +453,16 @@ M0_INTERNAL int m0_fom_domain_init(struct m0_fom_domain **dom);
  */
 M0_INTERNAL void m0_fom_domain_fini(struct m0_fom_domain *dom);
 
+/**
+ * Enables or disables work stealing between the localities of a domain.
+ *
+ * Work stealing is disabled by default. When enabled, foms of stealable types
+ * (m0_fom_type::ft_stealable) can be executed by a locality other than their
+ * home locality.
+ */
+M0_INTERNAL void m0_fom_domain_steal_enable(struct m0_fom_domain *dom,
+					    bool                  enable);
+
 /**
  * True iff no locality in the domain has a fom to execute.
  *
@@ -481,6 +547,10 @@ struct m0_fom_callback {
 struct m0_fom {
 	/** Locality this fom belongs to */
 	struct m0_fom_locality   *fo_loc;
+	/**
+	 * Index of the home locality. Not changed when the fom is moved to
+	 * another locality, see "Work stealing" in fom.c.
+	 */
 	size_t                    fo_loc_idx;
 	const struct m0_fom_type *fo_type;
 	const struct m0_fom_ops  *fo_ops;
@@ -528,6 +598,10 @@ struct m0_fom {
 	struct m0_sm              fo_sm_phase;
 	/** State machine for FOM states. */
 	struct m0_sm              fo_sm_state;
+	/** Scheduling class, see m0_fom_prio. */
+	enum m0_fom_prio          fo_prio;
+	/** Time when the fom was last put into the run-queue. */
+	m0_time_t                 fo_ready_at;
 	/** Thread executing current phase transition. */
 	struct m0_loc_thread     *fo_thread;
 	/**
@@ -621,6 +695,13 @@ struct m0_fom_type {
 	      struct m0_sm_conf            ft_conf;
 	      struct m0_sm_conf            ft_state_conf;
 	const struct m0_reqh_service_type *ft_rstype;
+	/**
+	 * True if foms of this type are locality-agnostic, i.e., their
+	 * correctness doesn't depend on being executed in the home locality
+	 * (m0_fom_ops::fo_home_locality()). Such a fom can be moved to an idle
+	 * locality before its first phase transition. False by default.
+	 */
+	bool                               ft_stealable;
 };
 
 /**
@@ -702,6 +783,11 @@ M0_INTERNAL void m0_fom_block_enter(struct m0_fom *fom);
  */
 M0_INTERNAL void m0_fom_block_leave(struct m0_fom *fom);
 
+/**
+ * True iff the fom is between m0_fom_block_enter() and m0_fom_block_leave().
+ */
+M0_INTERNAL bool m0_fom_is_blocked(const struct m0_fom *fom);
+
 /**
  * Dequeues fom from the locality waiting queue and enqueues it into
  * locality runq list changing the state to M0_FOS_READY.
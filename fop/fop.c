@@ -464,6 +464,10 @@ int m0_fop_type_addb2_instrument(struct m0_fop_type *type)
 	uint64_t                 mask = ((uint64_t)rt->rit_opcode) << 12;
 
 	mask |= M0_AVI_FOP_TYPES_RANGE_START;
+	/* FOM phase and state, rpc item latencies use log-linear buckets. */
+	ft->ft_conf.scf_addb2_loghist           = M0_ADDB2_LOGHIST_PRECISION;
+	rt->rit_outgoing_conf.scf_addb2_loghist = M0_ADDB2_LOGHIST_PRECISION;
+	rt->rit_incoming_conf.scf_addb2_loghist = M0_ADDB2_LOGHIST_PRECISION;
 	return (ft->ft_conf.scf_name != NULL ?
 		m0_sm_addb2_init(&ft->ft_conf, M0_AVI_PHASE,
 				 mask | (M0_AFC_PHASE << 8)) : 0) ?:
@@ -743,6 +743,65 @@ M0_INTERNAL void m0_pdclust_instance_map(struct m0_pdclust_instance *pi,
 	M0_LEAVE("pi %p", pi);
 }
 
+M0_INTERNAL void m0_pdclust_instance_map_groups(struct m0_pdclust_instance *pi,
+						uint64_t group, uint64_t nr,
+						struct m0_pdclust_tgt_addr *tgt)
+{
+	struct m0_pdclust_layout *pl;
+	const uint32_t           *perm;
+	uint32_t                  W;
+	uint32_t                  P;
+	uint32_t                  C;
+	uint32_t                  L;
+	uint32_t                  u;
+	uint64_t                  omega;
+	uint64_t                  frame;
+	uint64_t                  j;
+	uint64_t                  r;
+	uint64_t                  t;
+	uint64_t                  g;
+
+	M0_PRE(pdclust_instance_invariant(pi));
+	M0_PRE(tgt != NULL);
+
+	M0_ENTRY("pi %p group %"PRIu64" nr %"PRIu64, pi, group, nr);
+	pl = pi_to_pl(pi);
+	W = pl->pl_attr.pa_N + pl->pl_attr.pa_K + pl->pl_attr.pa_S;
+	P = pl->pl_attr.pa_P;
+	C = pl->pl_C;
+	L = pl->pl_L;
+
+	/*
+	 * Same steps as in m0_pdclust_instance_map(), except that (r, t)
+	 * coordinates of consecutive units are consecutive elements of the
+	 * L*P tile, so they are advanced instead of being re-computed.
+	 */
+	m_dec(C, group, &omega, &j);
+	m_dec(P, m_enc(W, j, 0), &r, &t);
+	permute_column(pi, omega, 0); /* Force tile cache update */
+	perm  = pi->pi_tile_cache.tc_permute;
+	frame = m_enc(L, omega, r);
+	for (g = 0; g < nr; ++g) {
+		for (u = 0; u < W; ++u, ++tgt) {
+			tgt->ta_obj   = perm[t];
+			tgt->ta_frame = frame;
+			if (++t == P) {
+				t = 0;
+				++frame;
+			}
+		}
+		/* C groups of W units fill L rows of the tile exactly. */
+		if (++j == C) {
+			j = 0;
+			++omega;
+			M0_ASSERT(t == 0 && frame == m_enc(L, omega, 0));
+			if (g + 1 < nr)
+				permute_column(pi, omega, 0);
+		}
+	}
+	M0_LEAVE("pi %p", pi);
+}
+
 M0_INTERNAL void m0_pdclust_instance_inv(struct m0_pdclust_instance *pi,
 					 const struct m0_pdclust_tgt_addr *tgt,
 					 struct m0_pdclust_src_addr *src)
@@ -799,6 +858,7 @@ M0_INTERNAL void m0_pdclust_perm_cache_destroy(struct m0_layout *layout,
 	for (i = 0; i < cache_cnt; ++i)
 		m0_fd_perm_cache_fini(&pi->pi_perm_cache[i]);
 	m0_free(pi->pi_perm_cache);
+	m0_free0(&pi->pi_fd_tgt);
 	pi->pi_cache_nr = 0;
 }
 
@@ -811,6 +871,9 @@ M0_INTERNAL int m0_pdclust_perm_cache_build(struct m0_layout *layout,
 
 	M0_PRE(layout != NULL && layout->l_pver != NULL);
 	cache_info = &layout->l_pver->pv_fd_tree.ft_cache_info;
+	/* Allocated by m0_fd_fwd_map() on the first use. */
+	pi->pi_fd_tgt   = NULL;
+	pi->pi_fd_omega = ~(uint64_t)0;
 	M0_ALLOC_ARR(pi->pi_perm_cache, cache_info->fci_nr);
 	if (pi->pi_perm_cache == NULL)
 		return M0_ERR(-ENOMEM);
@@ -219,6 +219,15 @@ struct m0_pdclust_instance {
 
 	uint64_t                     pi_cache_nr;
 	struct m0_fd_perm_cache     *pi_perm_cache;
+	/** Tile for which pi_fd_tgt[] is valid. */
+	uint64_t                     pi_fd_omega;
+	/**
+	 * Permutations of the tile pi_fd_omega, flattened over the failure
+	 * domains tree and copied from m0_fd_tree::ft_perm_lru.
+	 *
+	 * @see m0_fd_perm_lru_entry::fple_tgt
+	 */
+	uint64_t                    *pi_fd_tgt;
 	/** Parity math information, initialised according to the layout. */
 	struct m0_parity_math        pi_math;
 
@@ -309,6 +318,18 @@ m0_layout_instance_to_pdi(const struct m0_layout_instance *li);
 M0_INTERNAL void m0_pdclust_instance_map(struct m0_pdclust_instance *pi,
 					 const struct m0_pdclust_src_addr *src,
 					 struct m0_pdclust_tgt_addr *tgt);
+/**
+ * Maps all units of "nr" consecutive parity groups, starting from "group".
+ *
+ * Unit u of the group (group + g) is mapped to tgt[g * (N + K + S) + u], where
+ * tgt[] has nr * (N + K + S) elements. The result is the same as that of
+ * m0_pdclust_instance_map() called for every unit, but a column permutation
+ * is generated at most once per tile and (frame, column) coordinates are
+ * advanced incrementally.
+ */
+M0_INTERNAL void m0_pdclust_instance_map_groups(struct m0_pdclust_instance *pi,
+						uint64_t group, uint64_t nr,
+						struct m0_pdclust_tgt_addr *tgt);
 /**
  * Reverse layout mapping function.
  *
@@ -2493,9 +2493,12 @@ static void ldemo(struct m0_pdclust_instance *pi,
 	struct m0_pdclust_src_addr src;
 	struct m0_pdclust_tgt_addr tgt;
 	struct m0_pdclust_src_addr src1;
+	struct m0_pdclust_tgt_addr *tgts;
 	struct m0_pdclust_attr     attr = pl->pl_attr;
 	uint32_t                   W;
 	uint32_t                   unit;
+	uint64_t                   nr;
+	uint64_t                   i;
 
 	W = attr.pa_N + attr.pa_K + attr.pa_S;
 	src.sa_group = 0;
@@ -2505,6 +2508,20 @@ static void ldemo(struct m0_pdclust_instance *pi,
 		m0_pdclust_instance_inv(pi, &tgt, &src1);
 		M0_ASSERT(memcmp(&src, &src1, sizeof src) == 0);
 	}
+
+	/* Map groups from a few tiles at once, starting in the middle of one. */
+	nr = 3 * pl->pl_C + 1;
+	M0_ALLOC_ARR(tgts, nr * W);
+	M0_UT_ASSERT(tgts != NULL);
+	m0_pdclust_instance_map_groups(pi, pl->pl_C / 2, nr, tgts);
+	for (i = 0; i < nr * W; ++i) {
+		src.sa_group = pl->pl_C / 2 + i / W;
+		src.sa_unit  = i % W;
+		m0_pdclust_instance_map(pi, &src, &tgt);
+		M0_UT_ASSERT(tgt.ta_obj == tgts[i].ta_obj);
+		M0_UT_ASSERT(tgt.ta_frame == tgts[i].ta_frame);
+	}
+	m0_free(tgts);
 }
 
 /* Tests the APIs supported for m0_pdclust_instance object. */
@@ -21,8 +21,18 @@
 
 
 #include "lib/memory.h"               /* m0_alloc, m0_free */
+#include "lib/byteorder.h"            /* m0_byteorder_cpu_to_le32 */
+#include "lib/errno.h"                /* EINVAL */
+#include "lib/finject.h"              /* M0_FI_ENABLED */
 #include "lib/cksum_data.h"
 
+#ifndef __KERNEL__
+#if defined(__aarch64__)
+#include <sys/auxv.h>                 /* getauxval */
+#include <asm/hwcap.h>                /* HWCAP_CRC32 */
+#endif
+#endif
+
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_LIB
 #include "lib/trace.h"
 
@@ -276,6 +286,627 @@ M0_INTERNAL int m0_calculate_md5_inc_context(
 	return  0;
 }
 
+#ifndef __KERNEL__
+
+/**
+ * @defgroup cksum-fast CRC32C and xxHash64 protection info
+ *
+ * MD5 is a cryptographic hash and costs more cpu than erasure coding. For
+ * data integrity a strong non-cryptographic checksum is sufficient:
+ *
+ *     - CRC32C is computed with SSE4.2 (x86_64) or ARMv8 crc (aarch64)
+ *       instructions, if the cpu has them, and with a table otherwise;
+ *
+ *     - xxHash64 is a portable hash working at memory bandwidth.
+ *
+ * Both have incremental-context variants, where the context is the running
+ * (not finalised) hash state, similar to M0_PI_TYPE_MD5_INC_CONTEXT. The seed
+ * (m0_pi_seed) is hashed in binary form after the data.
+ *
+ * @{
+ */
+
+static const uint32_t crc32c_table[256] = {
+	0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4,
+	0xc79a971f, 0x35f1141c, 0x26a1e7e8, 0xd4ca64eb,
+	0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b,
+	0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24,
+	0x105ec76f, 0xe235446c, 0xf165b798, 0x030e349b,
+	0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+	0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54,
+	0x5d1d08bf, 0xaf768bbc, 0xbc267848, 0x4e4dfb4b,
+	0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a,
+	0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35,
+	0xaa64d611, 0x580f5512, 0x4b5fa6e6, 0xb93425e5,
+	0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+	0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45,
+	0xf779deae, 0x05125dad, 0x1642ae59, 0xe4292d5a,
+	0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a,
+	0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595,
+	0x417b1dbc, 0xb3109ebf, 0xa0406d4b, 0x522bee48,
+	0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+	0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687,
+	0x0c38d26c, 0xfe53516f, 0xed03a29b, 0x1f682198,
+	0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927,
+	0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38,
+	0xdbfc821c, 0x2997011f, 0x3ac7f2eb, 0xc8ac71e8,
+	0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+	0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096,
+	0xa65c047d, 0x5437877e, 0x4767748a, 0xb50cf789,
+	0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859,
+	0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46,
+	0x7198540d, 0x83f3d70e, 0x90a324fa, 0x62c8a7f9,
+	0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+	0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36,
+	0x3cdb9bdd, 0xceb018de, 0xdde0eb2a, 0x2f8b6829,
+	0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c,
+	0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93,
+	0x082f63b7, 0xfa44e0b4, 0xe9141340, 0x1b7f9043,
+	0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+	0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3,
+	0x55326b08, 0xa759e80b, 0xb4091bff, 0x466298fc,
+	0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c,
+	0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033,
+	0xa24bb5a6, 0x502036a5, 0x4370c551, 0xb11b4652,
+	0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+	0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d,
+	0xef087a76, 0x1d63f975, 0x0e330a81, 0xfc588982,
+	0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d,
+	0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622,
+	0x38cc2a06, 0xcaa7a905, 0xd9f75af1, 0x2b9cd9f2,
+	0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+	0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530,
+	0x0417b1db, 0xf67c32d8, 0xe52cc12c, 0x1747422f,
+	0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff,
+	0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0,
+	0xd3d3e1ab, 0x21b862a8, 0x32e8915c, 0xc083125f,
+	0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+	0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90,
+	0x9e902e7b, 0x6cfbad78, 0x7fab5e8c, 0x8dc0dd8f,
+	0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee,
+	0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1,
+	0x69e9f0d5, 0x9b8273d6, 0x88d28022, 0x7ab90321,
+	0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+	0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81,
+	0x34f4f86a, 0xc69f7b69, 0xd5cf889d, 0x27a40b9e,
+	0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e,
+	0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351,
+};
+
+static uint32_t crc32c_sw(uint32_t crc, const uint8_t *p, m0_bcount_t len)
+{
+	while (len-- > 0)
+		crc = crc32c_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+	return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_hw(uint32_t crc, const uint8_t *p, m0_bcount_t len)
+{
+	uint64_t c = crc;
+	uint64_t v;
+
+	for (; len >= sizeof v; len -= sizeof v, p += sizeof v) {
+		memcpy(&v, p, sizeof v);
+		c = __builtin_ia32_crc32di(c, v);
+	}
+	crc = c;
+	while (len-- > 0)
+		crc = __builtin_ia32_crc32qi(crc, *p++);
+	return crc;
+}
+
+static bool crc32c_hw_supported(void)
+{
+	return __builtin_cpu_supports("sse4.2");
+}
+#elif defined(__aarch64__)
+__attribute__((target("+crc")))
+static uint32_t crc32c_hw(uint32_t crc, const uint8_t *p, m0_bcount_t len)
+{
+	uint64_t v;
+
+	for (; len >= sizeof v; len -= sizeof v, p += sizeof v) {
+		memcpy(&v, p, sizeof v);
+		crc = __builtin_aarch64_crc32cx(crc, v);
+	}
+	while (len-- > 0)
+		crc = __builtin_aarch64_crc32cb(crc, *p++);
+	return crc;
+}
+
+static bool crc32c_hw_supported(void)
+{
+	return getauxval(AT_HWCAP) & HWCAP_CRC32;
+}
+#else
+#define crc32c_hw crc32c_sw
+
+static bool crc32c_hw_supported(void)
+{
+	return false;
+}
+#endif
+
+/**
+ * Updates running (not inverted) crc.
+ *
+ * The implementation is selected on the first call. Concurrent first calls
+ * store the same value. "sw" fault point forces the table implementation.
+ */
+static uint32_t crc32c_update(uint32_t crc, const void *data, m0_bcount_t len)
+{
+	static uint32_t (*impl)(uint32_t, const uint8_t *, m0_bcount_t);
+
+	if (M0_FI_ENABLED("sw"))
+		return crc32c_sw(crc, data, len);
+	if (impl == NULL)
+		impl = crc32c_hw_supported() ? &crc32c_hw : &crc32c_sw;
+	return impl(crc, data, len);
+}
+
+M0_INTERNAL uint32_t m0_crc32c(const void *data, m0_bcount_t len)
+{
+	return ~crc32c_update(~0U, data, len);
+}
+
+#define XXH_P1 11400714785074694791ULL
+#define XXH_P2 14029467366897019727ULL
+#define XXH_P3  1609587929392839161ULL
+#define XXH_P4  9650029242287828579ULL
+#define XXH_P5  2870177450012600261ULL
+
+static inline uint64_t xxh_rotl(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t xxh_read64(const uint8_t *p)
+{
+	uint64_t v;
+
+	memcpy(&v, p, sizeof v);
+	return m0_byteorder_le64_to_cpu(v);
+}
+
+static inline uint32_t xxh_read32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof v);
+	return m0_byteorder_le32_to_cpu(v);
+}
+
+static inline uint64_t xxh_round(uint64_t acc, uint64_t input)
+{
+	acc += input * XXH_P2;
+	return xxh_rotl(acc, 31) * XXH_P1;
+}
+
+static inline uint64_t xxh_merge(uint64_t acc, uint64_t val)
+{
+	acc ^= xxh_round(0, val);
+	return acc * XXH_P1 + XXH_P4;
+}
+
+static void xxh64_init(struct m0_xxh64_ctx *ctx, uint64_t seed)
+{
+	M0_SET0(ctx);
+	ctx->xc_seed = seed;
+	ctx->xc_v[0] = seed + XXH_P1 + XXH_P2;
+	ctx->xc_v[1] = seed + XXH_P2;
+	ctx->xc_v[2] = seed;
+	ctx->xc_v[3] = seed - XXH_P1;
+}
+
+/* Consumes a 32-byte stripe. */
+static inline void xxh64_stripe(uint64_t *v, const uint8_t *p)
+{
+	v[0] = xxh_round(v[0], xxh_read64(p));
+	v[1] = xxh_round(v[1], xxh_read64(p + 8));
+	v[2] = xxh_round(v[2], xxh_read64(p + 16));
+	v[3] = xxh_round(v[3], xxh_read64(p + 24));
+}
+
+static void xxh64_update(struct m0_xxh64_ctx *ctx, const void *data,
+			 m0_bcount_t len)
+{
+	const uint8_t *p   = data;
+	const uint8_t *end = p + len;
+	uint32_t       fill;
+
+	ctx->xc_total += len;
+	if (ctx->xc_memsize + len < sizeof ctx->xc_mem) {
+		memcpy(ctx->xc_mem + ctx->xc_memsize, p, len);
+		ctx->xc_memsize += len;
+		return;
+	}
+	if (ctx->xc_memsize > 0) {
+		fill = sizeof ctx->xc_mem - ctx->xc_memsize;
+		memcpy(ctx->xc_mem + ctx->xc_memsize, p, fill);
+		xxh64_stripe(ctx->xc_v, ctx->xc_mem);
+		p += fill;
+		ctx->xc_memsize = 0;
+	}
+	for (; p + sizeof ctx->xc_mem <= end; p += sizeof ctx->xc_mem)
+		xxh64_stripe(ctx->xc_v, p);
+	if (p < end) {
+		memcpy(ctx->xc_mem, p, end - p);
+		ctx->xc_memsize = end - p;
+	}
+}
+
+/* Returns the hash of the data so far, ctx is not modified. */
+static uint64_t xxh64_digest(const struct m0_xxh64_ctx *ctx)
+{
+	const uint8_t *p   = ctx->xc_mem;
+	const uint8_t *end = p + ctx->xc_memsize;
+	const uint64_t *v  = ctx->xc_v;
+	uint64_t       h;
+
+	if (ctx->xc_total >= sizeof ctx->xc_mem) {
+		h = xxh_rotl(v[0], 1) + xxh_rotl(v[1], 7) +
+		    xxh_rotl(v[2], 12) + xxh_rotl(v[3], 18);
+		h = xxh_merge(h, v[0]);
+		h = xxh_merge(h, v[1]);
+		h = xxh_merge(h, v[2]);
+		h = xxh_merge(h, v[3]);
+	} else
+		h = ctx->xc_seed + XXH_P5;
+	h += ctx->xc_total;
+	for (; p + 8 <= end; p += 8) {
+		h ^= xxh_round(0, xxh_read64(p));
+		h  = xxh_rotl(h, 27) * XXH_P1 + XXH_P4;
+	}
+	if (p + 4 <= end) {
+		h ^= (uint64_t)xxh_read32(p) * XXH_P1;
+		h  = xxh_rotl(h, 23) * XXH_P2 + XXH_P3;
+		p += 4;
+	}
+	for (; p < end; ++p) {
+		h ^= *p * XXH_P5;
+		h  = xxh_rotl(h, 11) * XXH_P1;
+	}
+	h ^= h >> 33;
+	h *= XXH_P2;
+	h ^= h >> 29;
+	h *= XXH_P3;
+	h ^= h >> 32;
+	return h;
+}
+
+M0_INTERNAL uint64_t m0_xxh64(const void *data, m0_bcount_t len,
+			      uint64_t seed)
+{
+	struct m0_xxh64_ctx ctx;
+
+	xxh64_init(&ctx, seed);
+	xxh64_update(&ctx, data, len);
+	return xxh64_digest(&ctx);
+}
+
+/* Binary form of the seed hashed by CRC32C and xxHash64 PI types. */
+static void pi_seed_encode(const struct m0_pi_seed *seed, uint64_t out[3])
+{
+	out[0] = m0_byteorder_cpu_to_le64(seed->pis_obj_id.f_container);
+	out[1] = m0_byteorder_cpu_to_le64(seed->pis_obj_id.f_key);
+	out[2] = m0_byteorder_cpu_to_le64(seed->pis_data_unit_offset);
+}
+
+static uint32_t crc32c_bufvec(uint32_t crc, const struct m0_bufvec *bvec)
+{
+	uint32_t i;
+
+	for (i = 0; bvec != NULL && i < bvec->ov_vec.v_nr; i++)
+		crc = crc32c_update(crc, bvec->ov_buf[i],
+				    bvec->ov_vec.v_count[i]);
+	return crc;
+}
+
+static uint32_t crc32c_seed(uint32_t crc, const struct m0_pi_seed *seed)
+{
+	uint64_t s[3];
+
+	if (seed == NULL)
+		return crc;
+	pi_seed_encode(seed, s);
+	return crc32c_update(crc, s, sizeof s);
+}
+
+static void crc32c_put(unsigned char *out, uint32_t crc)
+{
+	crc = m0_byteorder_cpu_to_le32(~crc);
+	memcpy(out, &crc, sizeof crc);
+}
+
+static void xxh64_bufvec(struct m0_xxh64_ctx *ctx,
+			 const struct m0_bufvec *bvec)
+{
+	uint32_t i;
+
+	for (i = 0; bvec != NULL && i < bvec->ov_vec.v_nr; i++)
+		xxh64_update(ctx, bvec->ov_buf[i], bvec->ov_vec.v_count[i]);
+}
+
+static void xxh64_seed(struct m0_xxh64_ctx *ctx, const struct m0_pi_seed *seed)
+{
+	uint64_t s[3];
+
+	if (seed != NULL) {
+		pi_seed_encode(seed, s);
+		xxh64_update(ctx, s, sizeof s);
+	}
+}
+
+static void xxh64_put(unsigned char *out, const struct m0_xxh64_ctx *ctx)
+{
+	uint64_t h = m0_byteorder_cpu_to_le64(xxh64_digest(ctx));
+
+	memcpy(out, &h, sizeof h);
+}
+
+/**
+ * Calculates CRC32C protection info.
+ *
+ * Parameters are the same as for m0_calculate_md5(). Every call starts a new
+ * crc, M0_PI_CALC_UNIT_ZERO flag makes no difference.
+ */
+M0_INTERNAL int m0_calculate_crc32c(struct m0_crc32c_pi *pi,
+				    struct m0_pi_seed *seed,
+				    struct m0_bufvec *bvec,
+				    enum m0_pi_calc_flag flag)
+{
+	uint32_t crc;
+
+	M0_PRE(pi != NULL);
+	pi->pic_hdr.pih_size = sizeof *pi / M0_CKSUM_DATA_ROUNDOFF_BYTE;
+	M0_SET_ARR0(pi->pic_pad);
+	crc = crc32c_seed(crc32c_bufvec(~0U, bvec), seed);
+	if (!(flag & M0_PI_SKIP_CALC_FINAL))
+		crc32c_put(pi->pic_value, crc);
+	return 0;
+}
+
+/**
+ * Calculates CRC32C protection info with context.
+ *
+ * Parameters are the same as for m0_calculate_md5_inc_context(). Context is the
+ * running crc, M0_CRC32C_LEN bytes of curr_context are set.
+ */
+M0_INTERNAL int m0_calculate_crc32c_inc_context(
+		struct m0_crc32c_inc_context_pi *pi,
+		struct m0_pi_seed *seed,
+		struct m0_bufvec *bvec,
+		enum m0_pi_calc_flag flag,
+		unsigned char *curr_context,
+		unsigned char *pi_value_without_seed)
+{
+	uint32_t crc;
+
+	M0_PRE(pi != NULL);
+	M0_PRE(curr_context != NULL);
+	pi->picc_hdr.pih_size = sizeof *pi / M0_CKSUM_DATA_ROUNDOFF_BYTE;
+	M0_SET_ARR0(pi->picc_pad);
+	if (flag & M0_PI_CALC_UNIT_ZERO) {
+		crc = ~0U;
+		memcpy(pi->picc_prev_context, &crc, sizeof crc);
+	}
+	memcpy(&crc, pi->picc_prev_context, sizeof crc);
+	crc = crc32c_bufvec(crc, bvec);
+	memcpy(curr_context, &crc, sizeof crc);
+	if (pi_value_without_seed != NULL)
+		crc32c_put(pi_value_without_seed, crc);
+	if (!(flag & M0_PI_SKIP_CALC_FINAL))
+		crc32c_put(pi->picc_value, crc32c_seed(crc, seed));
+	return 0;
+}
+
+/**
+ * Calculates xxHash64 protection info.
+ *
+ * Parameters are the same as for m0_calculate_md5(). Every call starts a new
+ * hash, M0_PI_CALC_UNIT_ZERO flag makes no difference.
+ */
+M0_INTERNAL int m0_calculate_xxh64(struct m0_xxh64_pi *pi,
+				   struct m0_pi_seed *seed,
+				   struct m0_bufvec *bvec,
+				   enum m0_pi_calc_flag flag)
+{
+	struct m0_xxh64_ctx ctx;
+
+	M0_PRE(pi != NULL);
+	pi->pix_hdr.pih_size = sizeof *pi / M0_CKSUM_DATA_ROUNDOFF_BYTE;
+	M0_SET_ARR0(pi->pix_pad);
+	xxh64_init(&ctx, 0);
+	xxh64_bufvec(&ctx, bvec);
+	xxh64_seed(&ctx, seed);
+	if (!(flag & M0_PI_SKIP_CALC_FINAL))
+		xxh64_put(pi->pix_value, &ctx);
+	return 0;
+}
+
+/**
+ * Calculates xxHash64 protection info with context.
+ *
+ * Parameters are the same as for m0_calculate_md5_inc_context(). Context is
+ * struct m0_xxh64_ctx, which is copied to curr_context.
+ */
+M0_INTERNAL int m0_calculate_xxh64_inc_context(
+		struct m0_xxh64_inc_context_pi *pi,
+		struct m0_pi_seed *seed,
+		struct m0_bufvec *bvec,
+		enum m0_pi_calc_flag flag,
+		unsigned char *curr_context,
+		unsigned char *pi_value_without_seed)
+{
+	struct m0_xxh64_ctx ctx;
+
+	M0_PRE(pi != NULL);
+	M0_PRE(curr_context != NULL);
+	pi->pixc_hdr.pih_size = sizeof *pi / M0_CKSUM_DATA_ROUNDOFF_BYTE;
+	M0_SET_ARR0(pi->pixc_pad);
+	if (flag & M0_PI_CALC_UNIT_ZERO) {
+		xxh64_init(&ctx, 0);
+		memcpy(pi->pixc_prev_context, &ctx, sizeof ctx);
+	}
+	memcpy(&ctx, pi->pixc_prev_context, sizeof ctx);
+	xxh64_bufvec(&ctx, bvec);
+	memcpy(curr_context, &ctx, sizeof ctx);
+	if (pi_value_without_seed != NULL)
+		xxh64_put(pi_value_without_seed, &ctx);
+	if (!(flag & M0_PI_SKIP_CALC_FINAL)) {
+		xxh64_seed(&ctx, seed);
+		xxh64_put(pi->pixc_value, &ctx);
+	}
+	return 0;
+}
+
+/*
+ * Verifies CRC32C or xxHash64 protection info. For context variants, context
+ * of the previous unit is taken from "pi".
+ */
+static bool pi_fast_verify(struct m0_generic_pi *pi, struct m0_pi_seed *seed,
+			   struct m0_bufvec *bvec)
+{
+	union m0_md5_union_pi calc;
+	struct m0_xxh64_ctx   context;
+	uint32_t              size = m0_cksum_get_size(pi->pi_hdr.pih_type);
+
+	memcpy(&calc, pi, size);
+	m0_client_calculate_pi((struct m0_generic_pi *)&calc, seed, bvec,
+			       M0_PI_NO_FLAG, (unsigned char *)&context, NULL);
+	if (memcmp(&calc, pi, size) == 0)
+		return true;
+	M0_LOG(M0_ERROR, "checksum fail type %d data_unit_offset 0x%" PRIx64,
+	       (int)pi->pi_hdr.pih_type,
+	       seed != NULL ? seed->pis_data_unit_offset : 0);
+	return false;
+}
+
+/*
+ * Seed in the form hashed by MD5 PI types, see m0_calculate_md5().
+ */
+static void md5_seed_str(const struct m0_pi_seed *seed, char str[64])
+{
+	memset(str, 0, 64);
+	snprintf(str, 64, "%" PRIx64 "%" PRIx64 "%" PRIx64,
+		 seed->pis_obj_id.f_container, seed->pis_obj_id.f_key,
+		 seed->pis_data_unit_offset);
+}
+
+M0_INTERNAL int m0_cksum_stream_init(struct m0_cksum_stream *cs,
+				     enum m0_pi_algo_type type)
+{
+	cs->cs_type = type;
+	switch (type) {
+	case M0_PI_TYPE_MD5:
+	case M0_PI_TYPE_MD5_INC_CONTEXT:
+		if (MD5_Init(&cs->cs_u.u_md5) != 1)
+			return M0_ERR_INFO(-EINVAL, "MD5_Init failed");
+		return 0;
+	case M0_PI_TYPE_CRC32C:
+	case M0_PI_TYPE_CRC32C_INC_CONTEXT:
+		cs->cs_u.u_crc = ~0U;
+		return 0;
+	case M0_PI_TYPE_XXH64:
+	case M0_PI_TYPE_XXH64_INC_CONTEXT:
+		xxh64_init(&cs->cs_u.u_xxh, 0);
+		return 0;
+	default:
+		return M0_ERR_INFO(-EINVAL, "pi_type = %d", type);
+	}
+}
+
+M0_INTERNAL int m0_cksum_stream_update(struct m0_cksum_stream *cs,
+				       const void *data, m0_bcount_t nob)
+{
+	switch (cs->cs_type) {
+	case M0_PI_TYPE_MD5:
+	case M0_PI_TYPE_MD5_INC_CONTEXT:
+		if (MD5_Update(&cs->cs_u.u_md5, data, nob) != 1)
+			return M0_ERR_INFO(-EINVAL, "MD5_Update failed "
+					   "nob=%" PRIu64, nob);
+		break;
+	case M0_PI_TYPE_CRC32C:
+	case M0_PI_TYPE_CRC32C_INC_CONTEXT:
+		cs->cs_u.u_crc = crc32c_update(cs->cs_u.u_crc, data, nob);
+		break;
+	default:
+		xxh64_update(&cs->cs_u.u_xxh, data, nob);
+		break;
+	}
+	return 0;
+}
+
+M0_INTERNAL int m0_cksum_stream_final(struct m0_cksum_stream *cs,
+				      struct m0_generic_pi *pi,
+				      struct m0_pi_seed *seed)
+{
+	union m0_md5_union_pi *u = (union m0_md5_union_pi *)pi;
+	char                   seed_str[64];
+	uint32_t               crc;
+	int                    rc = 0;
+
+	M0_PRE(seed != NULL);
+
+	pi->pi_hdr.pih_type = cs->cs_type;
+	pi->pi_hdr.pih_size = m0_cksum_get_size(cs->cs_type) /
+			      M0_CKSUM_DATA_ROUNDOFF_BYTE;
+	switch (cs->cs_type) {
+	case M0_PI_TYPE_MD5:
+	case M0_PI_TYPE_MD5_INC_CONTEXT:
+		md5_seed_str(seed, seed_str);
+		rc = MD5_Update(&cs->cs_u.u_md5, seed_str, sizeof seed_str);
+		if (rc != 1)
+			return M0_ERR_INFO(-EINVAL, "MD5_Update failed");
+		if (cs->cs_type == M0_PI_TYPE_MD5) {
+			M0_SET_ARR0(u->p.pimd5_pad);
+			rc = MD5_Final(u->p.pimd5_value, &cs->cs_u.u_md5);
+		} else {
+			M0_SET_ARR0(u->c.pi_md5c_pad);
+			/* Initial context, as M0_PI_CALC_UNIT_ZERO sets it. */
+			rc = MD5_Init((MD5_CTX *)u->c.pimd5c_prev_context);
+			if (rc == 1)
+				rc = MD5_Final(u->c.pimd5c_value,
+					       &cs->cs_u.u_md5);
+		}
+		rc = rc == 1 ? 0 : M0_ERR_INFO(-EINVAL, "MD5_Final failed");
+		break;
+	case M0_PI_TYPE_CRC32C:
+		M0_SET_ARR0(u->cp.pic_pad);
+		crc32c_put(u->cp.pic_value, crc32c_seed(cs->cs_u.u_crc, seed));
+		break;
+	case M0_PI_TYPE_CRC32C_INC_CONTEXT:
+		M0_SET_ARR0(u->cc.picc_pad);
+		crc = ~0U;
+		memcpy(u->cc.picc_prev_context, &crc, sizeof crc);
+		crc32c_put(u->cc.picc_value, crc32c_seed(cs->cs_u.u_crc, seed));
+		break;
+	case M0_PI_TYPE_XXH64:
+		M0_SET_ARR0(u->xp.pix_pad);
+		xxh64_seed(&cs->cs_u.u_xxh, seed);
+		xxh64_put(u->xp.pix_value, &cs->cs_u.u_xxh);
+		break;
+	case M0_PI_TYPE_XXH64_INC_CONTEXT: {
+		struct m0_xxh64_ctx ctx;
+
+		M0_SET_ARR0(u->xc.pixc_pad);
+		xxh64_init(&ctx, 0);
+		memcpy(u->xc.pixc_prev_context, &ctx, sizeof ctx);
+		xxh64_seed(&cs->cs_u.u_xxh, seed);
+		xxh64_put(u->xc.pixc_value, &cs->cs_u.u_xxh);
+		break;
+	}
+	default:
+		rc = M0_ERR_INFO(-EINVAL, "pi_type = %d", cs->cs_type);
+	}
+	return rc;
+}
+
+/** @} end of cksum-fast group */
+#endif /* __KERNEL__ */
+
 M0_INTERNAL uint32_t m0_cksum_get_size(enum m0_pi_algo_type pi_type)
 {
 #ifndef __KERNEL__
@@ -286,6 +917,14 @@ M0_INTERNAL uint32_t m0_cksum_get_size(enum m0_pi_algo_type pi_type)
 	case M0_PI_TYPE_MD5:
 		return sizeof(struct m0_md5_pi);
 		break;
+	case M0_PI_TYPE_CRC32C:
+		return sizeof(struct m0_crc32c_pi);
+	case M0_PI_TYPE_CRC32C_INC_CONTEXT:
+		return sizeof(struct m0_crc32c_inc_context_pi);
+	case M0_PI_TYPE_XXH64:
+		return sizeof(struct m0_xxh64_pi);
+	case M0_PI_TYPE_XXH64_INC_CONTEXT:
+		return sizeof(struct m0_xxh64_inc_context_pi);
 	default:
 		break;
 	}
@@ -295,6 +934,14 @@ M0_INTERNAL uint32_t m0_cksum_get_size(enum m0_pi_algo_type pi_type)
 
 M0_INTERNAL uint32_t m0_cksum_get_max_size(void)
 {
+	/*
+	 * Extent map records are sized by this, new PI types must not be
+	 * larger than MD5 with context.
+	 */
+	M0_CASSERT(sizeof(struct m0_xxh64_inc_context_pi) <=
+		   sizeof(struct m0_md5_inc_context_pi));
+	M0_CASSERT(sizeof(struct m0_crc32c_inc_context_pi) <=
+		   sizeof(struct m0_md5_inc_context_pi));
 	return (sizeof(struct m0_md5_pi) >
 		sizeof(struct m0_md5_inc_context_pi) ?
 		sizeof(struct m0_md5_pi) :
@@ -325,6 +972,24 @@ int m0_client_calculate_pi(struct m0_generic_pi *pi,
 						  pi_value_without_seed);
 		}
 		break;
+	case M0_PI_TYPE_CRC32C:
+		rc = m0_calculate_crc32c((struct m0_crc32c_pi *)pi, seed,
+					 bvec, flag);
+		break;
+	case M0_PI_TYPE_CRC32C_INC_CONTEXT:
+		rc = m0_calculate_crc32c_inc_context(
+			(struct m0_crc32c_inc_context_pi *)pi, seed, bvec,
+			flag, curr_context, pi_value_without_seed);
+		break;
+	case M0_PI_TYPE_XXH64:
+		rc = m0_calculate_xxh64((struct m0_xxh64_pi *)pi, seed,
+					bvec, flag);
+		break;
+	case M0_PI_TYPE_XXH64_INC_CONTEXT:
+		rc = m0_calculate_xxh64_inc_context(
+			(struct m0_xxh64_inc_context_pi *)pi, seed, bvec,
+			flag, curr_context, pi_value_without_seed);
+		break;
 	}
 #endif
 	return rc;
@@ -371,6 +1036,11 @@ bool m0_calc_verify_cksum_one_unit(struct m0_generic_pi *pi,
 		}
 		break;
 	}
+	case M0_PI_TYPE_CRC32C:
+	case M0_PI_TYPE_CRC32C_INC_CONTEXT:
+	case M0_PI_TYPE_XXH64:
+	case M0_PI_TYPE_XXH64_INC_CONTEXT:
+		return pi_fast_verify(pi, seed, bvec);
 	default:
 		M0_IMPOSSIBLE("pi_type = %d", pi->pi_hdr.pih_type);
 	}
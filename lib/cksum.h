@@ -49,10 +49,19 @@ enum m0_pi_algo_type
 	M0_PI_TYPE_MD5,
 	M0_PI_TYPE_MD5_INC_CONTEXT,
 	M0_PI_TYPE_CRC,
+	/* CRC32C (Castagnoli), uses SSE4.2 or ARMv8 crc instructions */
+	M0_PI_TYPE_CRC32C,
+	M0_PI_TYPE_CRC32C_INC_CONTEXT,
+	/* xxHash64, fast non-cryptographic hash */
+	M0_PI_TYPE_XXH64,
+	M0_PI_TYPE_XXH64_INC_CONTEXT,
 	M0_PI_TYPE_MAX
 };
 
-/* Default checksum type, TODO_DI: Get from config */
+/*
+ * Default checksum type, used by pool versions unless configured otherwise,
+ * see m0_pool_version::pv_pi_type.
+ */
 enum {
 	M0_CKSUM_DEFAULT_PI = M0_PI_TYPE_MD5
 };
@@ -102,6 +111,17 @@ M0_INTERNAL uint32_t m0_cksum_get_size(enum m0_pi_algo_type pi_type);
  */
 M0_INTERNAL uint32_t m0_cksum_get_max_size(void);
 
+/**
+ * Computes CRC32C (Castagnoli polynomial) of the buffer.
+ *
+ * Hardware crc instructions are used when the cpu supports them.
+ */
+M0_INTERNAL uint32_t m0_crc32c(const void *data, m0_bcount_t len);
+
+/** Computes xxHash64 of the buffer with the given seed. */
+M0_INTERNAL uint64_t m0_xxh64(const void *data, m0_bcount_t len,
+			      uint64_t seed);
+
 /**
  * Calculate checksum/protection info for data/KV
  *
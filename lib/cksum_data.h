@@ -80,10 +80,106 @@ struct m0_md5_inc_context_pi {
 #endif
 };
 
+/*********************** CRC32C Cksum Structure ***********************/
+enum {
+	M0_CRC32C_LEN = sizeof(uint32_t)
+};
+
+#define M0_CKSUM_PAD_CRC32C (M0_CALC_PAD((sizeof(struct m0_pi_hdr) + \
+					 M0_CRC32C_LEN), \
+					 M0_CKSUM_DATA_ROUNDOFF_BYTE))
+
+/* CRC32C checksum structure, the checksum value is in pic_value */
+struct m0_crc32c_pi {
+	/* header for protection info */
+	struct m0_pi_hdr pic_hdr;
+	/* little-endian crc of the current data */
+	unsigned char    pic_value[M0_CRC32C_LEN];
+	/* structure should be 16 byte aligned */
+	char             pic_pad[M0_CKSUM_PAD_CRC32C];
+};
+
+#define M0_CKSUM_PAD_CRC32C_INC_CXT (M0_CALC_PAD((sizeof(struct m0_pi_hdr) + \
+						 2 * M0_CRC32C_LEN), \
+						 M0_CKSUM_DATA_ROUNDOFF_BYTE))
+
+/**
+ * CRC32C checksum structure with context:
+ *  - The computed checksum value will be in picc_value.
+ *  - Running (not finalised) crc of the previous data units in
+ *    picc_prev_context.
+ */
+struct m0_crc32c_inc_context_pi {
+	/* header for protection info */
+	struct m0_pi_hdr picc_hdr;
+	/* context of previous data unit */
+	unsigned char    picc_prev_context[M0_CRC32C_LEN];
+	/* protection value computed for the current data unit */
+	unsigned char    picc_value[M0_CRC32C_LEN];
+	/* structure should be 16 byte aligned */
+	char             picc_pad[M0_CKSUM_PAD_CRC32C_INC_CXT];
+};
+
+/*********************** xxHash64 Cksum Structure ***********************/
+enum {
+	M0_XXH64_LEN = sizeof(uint64_t)
+};
+
+/* Streaming xxHash64 state, stored in PI as the context. */
+struct m0_xxh64_ctx {
+	uint64_t xc_total;
+	uint64_t xc_seed;
+	uint64_t xc_v[4];
+	uint8_t  xc_mem[32];
+	uint32_t xc_memsize;
+	uint32_t xc_pad;
+};
+
+#define M0_CKSUM_PAD_XXH64 (M0_CALC_PAD((sizeof(struct m0_pi_hdr) + \
+					M0_XXH64_LEN), \
+					M0_CKSUM_DATA_ROUNDOFF_BYTE))
+
+/* xxHash64 checksum structure, the checksum value is in pix_value */
+struct m0_xxh64_pi {
+	/* header for protection info */
+	struct m0_pi_hdr pix_hdr;
+	/* little-endian hash of the current data */
+	unsigned char    pix_value[M0_XXH64_LEN];
+	/* structure should be 16 byte aligned */
+	char             pix_pad[M0_CKSUM_PAD_XXH64];
+};
+
+#define M0_CKSUM_PAD_XXH64_INC_CXT (M0_CALC_PAD((sizeof(struct m0_pi_hdr) + \
+				    sizeof(struct m0_xxh64_ctx) + \
+				    M0_XXH64_LEN), \
+				    M0_CKSUM_DATA_ROUNDOFF_BYTE))
+
+/**
+ * xxHash64 checksum structure with context:
+ *  - The computed checksum value will be in pixc_value.
+ *  - Hash state (struct m0_xxh64_ctx) of the previous data units in
+ *    pixc_prev_context.
+ */
+struct m0_xxh64_inc_context_pi {
+	/* header for protection info */
+	struct m0_pi_hdr pixc_hdr;
+	/* context of previous data unit */
+	unsigned char    pixc_prev_context[sizeof(struct m0_xxh64_ctx)];
+	/* protection value computed for the current data unit */
+	unsigned char    pixc_value[M0_XXH64_LEN];
+	/* structure should be 16 byte aligned */
+	char             pixc_pad[M0_CKSUM_PAD_XXH64_INC_CXT];
+};
+
+/* Union of all PI structures, named after the first supported type. */
 union m0_md5_union_pi
 {
 	struct m0_md5_pi p;
 	struct m0_md5_inc_context_pi c;
+	struct m0_crc32c_pi cp;
+	struct m0_crc32c_inc_context_pi cc;
+	struct m0_xxh64_pi xp;
+	struct m0_xxh64_inc_context_pi xc;
 };
 
 /* Max checksum size for all supported PIs */
@@ -91,4 +187,45 @@ enum {
 	M0_CKSUM_MAX_SIZE = sizeof(union m0_md5_union_pi)
 };
 
+#ifndef __KERNEL__
+/**
+ * Checksum of a data unit, computed piece by piece as the unit is filled.
+ *
+ * This allows to checksum a page right after it was copied, while it is still
+ * in the cpu cache, instead of walking the whole unit once more later:
+ *
+ * @code
+ * m0_cksum_stream_init(&cs, type);
+ * for each piece of the unit, in order:
+ *         m0_cksum_stream_update(&cs, addr, nob);
+ * m0_cksum_stream_final(&cs, pi, &seed);
+ * @endcode
+ *
+ * The resulting "pi" is the same as the one computed by
+ * m0_client_calculate_pi(pi, &seed, bvec, M0_PI_CALC_UNIT_ZERO, ...) over
+ * the whole unit.
+ */
+struct m0_cksum_stream {
+	enum m0_pi_algo_type         cs_type;
+	union {
+		MD5_CTX              u_md5;
+		uint32_t             u_crc;
+		struct m0_xxh64_ctx  u_xxh;
+	}                            cs_u;
+};
+
+M0_INTERNAL int m0_cksum_stream_init(struct m0_cksum_stream *cs,
+				     enum m0_pi_algo_type type);
+M0_INTERNAL int m0_cksum_stream_update(struct m0_cksum_stream *cs,
+				       const void *data, m0_bcount_t nob);
+/**
+ * Finalises the checksum and sets all fields of "pi", including header,
+ * context of the previous unit and padding. "cs" can not be updated after
+ * this call.
+ */
+M0_INTERNAL int m0_cksum_stream_final(struct m0_cksum_stream *cs,
+				      struct m0_generic_pi *pi,
+				      struct m0_pi_seed *seed);
+#endif
+
 #endif /* __MOTR_CKSUM_DATA_H__ */
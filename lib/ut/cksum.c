@@ -0,0 +1,355 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include "lib/cksum_data.h"
+#include "lib/vec.h"		/* m0_bufvec */
+#include "lib/misc.h"		/* M0_SET0 */
+#include "lib/ub.h"		/* m0_ub_set */
+#include "lib/finject.h"	/* m0_fi_enable */
+#include "ut/ut.h"		/* M0_UT_ASSERT */
+
+enum {
+	CKSUM_SEG_SIZE = 4096,
+	CKSUM_SEG_NR   = 16,
+	CKSUM_UNIT_NR  = 4,
+};
+
+static void cksum_bufvec_fill(struct m0_bufvec *bv, uint32_t nr)
+{
+	int rc;
+	int i;
+
+	rc = m0_bufvec_alloc(bv, nr, CKSUM_SEG_SIZE);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < nr; ++i)
+		memset(bv->ov_buf[i], 'a' + i % 26, CKSUM_SEG_SIZE);
+}
+
+static void cksum_vectors(void)
+{
+	const char *spam = "Nobody inspects the spammish repetition";
+
+	/* Reference values from the CRC32C and xxHash specifications. */
+	M0_UT_ASSERT(m0_crc32c("123456789", 9) == 0xe3069283);
+	M0_UT_ASSERT(m0_crc32c("", 0) == 0);
+	M0_UT_ASSERT(m0_xxh64("", 0, 0) == 0xef46db3751d8e999ULL);
+	M0_UT_ASSERT(m0_xxh64("abc", 3, 0) == 0x44bc2cf5ad770999ULL);
+	M0_UT_ASSERT(m0_xxh64(spam, strlen(spam), 0) == 0xfbcea83c8a378bf1ULL);
+}
+
+/*
+ * Table implementation of CRC32C, forced by "sw" fault point, must match the
+ * hardware one (which is the table one too on cpus without crc instructions)
+ * for all lengths and alignments around the 8-byte step of the latter.
+ */
+static void cksum_crc32c_sw(void)
+{
+	union m0_md5_union_pi hw;
+	union m0_md5_union_pi sw;
+	struct m0_bufvec      bv;
+	struct m0_pi_seed     seed;
+	uint32_t              crc[64][8];
+	char                 *buf;
+	int                   len;
+	int                   off;
+	int                   rc;
+
+	m0_fid_set(&seed.pis_obj_id, 0x123, 0x456);
+	seed.pis_data_unit_offset = 7;
+	cksum_bufvec_fill(&bv, CKSUM_SEG_NR);
+	buf = bv.ov_buf[0];
+	for (len = 0; len < ARRAY_SIZE(crc); ++len) {
+		for (off = 0; off < ARRAY_SIZE(crc[0]); ++off) {
+			buf[off + len / 2] = len ^ off;
+			crc[len][off] = m0_crc32c(buf + off, len);
+		}
+	}
+	M0_SET0(&hw);
+	((struct m0_generic_pi *)&hw)->pi_hdr.pih_type = M0_PI_TYPE_CRC32C;
+	sw = hw;
+	rc = m0_client_calculate_pi((struct m0_generic_pi *)&hw, &seed, &bv,
+				    M0_PI_CALC_UNIT_ZERO, NULL, NULL);
+	M0_UT_ASSERT(rc == 0);
+
+	m0_fi_enable("crc32c_update", "sw");
+	M0_UT_ASSERT(m0_crc32c("123456789", 9) == 0xe3069283);
+	for (len = 0; len < ARRAY_SIZE(crc); ++len) {
+		for (off = 0; off < ARRAY_SIZE(crc[0]); ++off)
+			M0_UT_ASSERT(crc[len][off] == m0_crc32c(buf + off, len));
+	}
+	rc = m0_client_calculate_pi((struct m0_generic_pi *)&sw, &seed, &bv,
+				    M0_PI_CALC_UNIT_ZERO, NULL, NULL);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(memcmp(&hw, &sw, sizeof hw) == 0);
+	m0_fi_disable("crc32c_update", "sw");
+	m0_bufvec_free(&bv);
+}
+
+/*
+ * Context variant computed unit by unit must produce the same unseeded value
+ * as the one-shot computation over all units, and the seeded value must pass
+ * verification.
+ */
+static void cksum_inc_context(enum m0_pi_algo_type type)
+{
+	union m0_md5_union_pi pi;
+	union m0_md5_union_pi big;
+	struct m0_bufvec      unit[CKSUM_UNIT_NR];
+	struct m0_bufvec      all;
+	struct m0_pi_seed     seed;
+	unsigned char         ctx[sizeof(struct m0_xxh64_ctx)];
+	unsigned char         value[M0_XXH64_LEN];
+	unsigned char         big_value[M0_XXH64_LEN];
+	uint32_t              size = m0_cksum_get_size(type);
+	uint32_t              ctxsize;
+	int                   rc;
+	int                   i;
+
+	M0_UT_ASSERT(size > 0 && size <= m0_cksum_get_max_size());
+	M0_UT_ASSERT(size % M0_CKSUM_DATA_ROUNDOFF_BYTE == 0);
+	ctxsize = type == M0_PI_TYPE_CRC32C_INC_CONTEXT ? M0_CRC32C_LEN :
+		sizeof(struct m0_xxh64_ctx);
+	m0_fid_set(&seed.pis_obj_id, 0x123, 0x456);
+	cksum_bufvec_fill(&all, CKSUM_SEG_NR * CKSUM_UNIT_NR);
+	M0_SET0(&pi);
+	((struct m0_generic_pi *)&pi)->pi_hdr.pih_type = type;
+	for (i = 0; i < CKSUM_UNIT_NR; ++i) {
+		cksum_bufvec_fill(&unit[i], CKSUM_SEG_NR);
+		seed.pis_data_unit_offset = i;
+		rc = m0_client_calculate_pi((struct m0_generic_pi *)&pi, &seed,
+					    &unit[i],
+					    i == 0 ? M0_PI_CALC_UNIT_ZERO :
+					    M0_PI_NO_FLAG, ctx, value);
+		M0_UT_ASSERT(rc == 0);
+		M0_UT_ASSERT(((struct m0_generic_pi *)&pi)->pi_hdr.pih_size *
+			     M0_CKSUM_DATA_ROUNDOFF_BYTE == size);
+		M0_UT_ASSERT(m0_calc_verify_cksum_one_unit(
+				     (struct m0_generic_pi *)&pi, &seed,
+				     &unit[i]));
+		/* The context is right after the header in both types. */
+		memcpy((char *)&pi + sizeof(struct m0_pi_hdr), ctx, ctxsize);
+	}
+	M0_SET0(&big);
+	((struct m0_generic_pi *)&big)->pi_hdr.pih_type = type;
+	rc = m0_client_calculate_pi((struct m0_generic_pi *)&big, NULL, &all,
+				    M0_PI_CALC_UNIT_ZERO, ctx, big_value);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(memcmp(value, big_value,
+			    type == M0_PI_TYPE_CRC32C_INC_CONTEXT ?
+			    M0_CRC32C_LEN : M0_XXH64_LEN) == 0);
+	for (i = 0; i < CKSUM_UNIT_NR; ++i)
+		m0_bufvec_free(&unit[i]);
+	m0_bufvec_free(&all);
+}
+
+static void cksum_plain(enum m0_pi_algo_type type)
+{
+	union m0_md5_union_pi pi;
+	struct m0_bufvec      bv;
+	struct m0_pi_seed     seed;
+	int                   rc;
+
+	m0_fid_set(&seed.pis_obj_id, 0x123, 0x456);
+	seed.pis_data_unit_offset = 7;
+	cksum_bufvec_fill(&bv, CKSUM_SEG_NR);
+	M0_SET0(&pi);
+	((struct m0_generic_pi *)&pi)->pi_hdr.pih_type = type;
+	rc = m0_client_calculate_pi((struct m0_generic_pi *)&pi, &seed, &bv,
+				    M0_PI_CALC_UNIT_ZERO, NULL, NULL);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_calc_verify_cksum_one_unit((struct m0_generic_pi *)&pi,
+						   &seed, &bv));
+	/* Corrupt the data. */
+	((char *)bv.ov_buf[CKSUM_SEG_NR / 2])[1] ^= 1;
+	M0_UT_ASSERT(!m0_calc_verify_cksum_one_unit((struct m0_generic_pi *)&pi,
+						    &seed, &bv));
+	m0_bufvec_free(&bv);
+}
+
+/*
+ * Checksum computed segment by segment with m0_cksum_stream must be the same
+ * as the one computed over the whole unit.
+ */
+static void cksum_stream(enum m0_pi_algo_type type)
+{
+	union m0_md5_union_pi  pi;
+	union m0_md5_union_pi  streamed;
+	struct m0_cksum_stream cs;
+	struct m0_bufvec       bv;
+	struct m0_pi_seed      seed;
+	unsigned char          ctx[M0_CKSUM_MAX_SIZE];
+	int                    rc;
+	int                    i;
+
+	m0_fid_set(&seed.pis_obj_id, 0x123, 0x456);
+	seed.pis_data_unit_offset = 3;
+	cksum_bufvec_fill(&bv, CKSUM_SEG_NR);
+	M0_SET0(&pi);
+	((struct m0_generic_pi *)&pi)->pi_hdr.pih_type = type;
+	rc = m0_client_calculate_pi((struct m0_generic_pi *)&pi, &seed, &bv,
+				    M0_PI_CALC_UNIT_ZERO, ctx, NULL);
+	M0_UT_ASSERT(rc == 0);
+	memset(&streamed, 0xff, sizeof streamed);
+	rc = m0_cksum_stream_init(&cs, type);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < CKSUM_SEG_NR; ++i) {
+		/* Uneven pieces, to exercise partial blocks of the hashes. */
+		rc = m0_cksum_stream_update(&cs, bv.ov_buf[i], 17) ?:
+		     m0_cksum_stream_update(&cs, (char *)bv.ov_buf[i] + 17,
+					    CKSUM_SEG_SIZE - 17);
+		M0_UT_ASSERT(rc == 0);
+	}
+	rc = m0_cksum_stream_final(&cs, (struct m0_generic_pi *)&streamed,
+				   &seed);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(memcmp(&pi, &streamed, m0_cksum_get_size(type)) == 0);
+	m0_bufvec_free(&bv);
+}
+
+void test_cksum(void)
+{
+	int type;
+
+	cksum_vectors();
+	cksum_crc32c_sw();
+	cksum_plain(M0_PI_TYPE_CRC32C);
+	cksum_plain(M0_PI_TYPE_XXH64);
+	cksum_inc_context(M0_PI_TYPE_CRC32C_INC_CONTEXT);
+	cksum_inc_context(M0_PI_TYPE_XXH64_INC_CONTEXT);
+	for (type = M0_PI_TYPE_MD5; type < M0_PI_TYPE_MAX; ++type) {
+		if (type != M0_PI_TYPE_CRC)
+			cksum_stream(type);
+	}
+}
+
+/*
+ * Benchmark: computes protection info of each type over a 1MB bufvec of 4KB
+ * segments. GB/s per core is UB_CKSUM_SEG_NR * UB_CKSUM_SEG_SIZE *
+ * UB_CKSUM_ITER divided by the reported round time.
+ */
+
+enum {
+	UB_CKSUM_SEG_SIZE = 4096,
+	UB_CKSUM_SEG_NR   = 256,
+	UB_CKSUM_ITER     = 1024,
+};
+
+static struct m0_bufvec      ub_cksum_bv;
+static union m0_md5_union_pi ub_cksum_pi;
+static unsigned char         ub_cksum_ctx[M0_CKSUM_MAX_SIZE];
+
+static int ub_cksum_init(const char *opts M0_UNUSED)
+{
+	int rc;
+	int i;
+
+	rc = m0_bufvec_alloc_aligned(&ub_cksum_bv, UB_CKSUM_SEG_NR,
+				     UB_CKSUM_SEG_SIZE, 12);
+	for (i = 0; rc == 0 && i < UB_CKSUM_SEG_NR; ++i)
+		memset(ub_cksum_bv.ov_buf[i], i, UB_CKSUM_SEG_SIZE);
+	return rc;
+}
+
+static void ub_cksum_fini(void)
+{
+	m0_bufvec_free_aligned(&ub_cksum_bv, 12);
+}
+
+static void ub_cksum(enum m0_pi_algo_type type)
+{
+	struct m0_pi_seed seed = { .pis_data_unit_offset = 1 };
+
+	((struct m0_generic_pi *)&ub_cksum_pi)->pi_hdr.pih_type = type;
+	m0_client_calculate_pi((struct m0_generic_pi *)&ub_cksum_pi, &seed,
+			       &ub_cksum_bv, M0_PI_CALC_UNIT_ZERO,
+			       ub_cksum_ctx, NULL);
+}
+
+static void ub_md5(int i)
+{
+	ub_cksum(M0_PI_TYPE_MD5);
+}
+
+static void ub_md5_inc(int i)
+{
+	ub_cksum(M0_PI_TYPE_MD5_INC_CONTEXT);
+}
+
+static void ub_crc32c(int i)
+{
+	ub_cksum(M0_PI_TYPE_CRC32C);
+}
+
+static void ub_crc32c_inc(int i)
+{
+	ub_cksum(M0_PI_TYPE_CRC32C_INC_CONTEXT);
+}
+
+static void ub_xxh64(int i)
+{
+	ub_cksum(M0_PI_TYPE_XXH64);
+}
+
+static void ub_xxh64_inc(int i)
+{
+	ub_cksum(M0_PI_TYPE_XXH64_INC_CONTEXT);
+}
+
+struct m0_ub_set m0_cksum_ub = {
+	.us_name = "cksum-ub",
+	.us_init = ub_cksum_init,
+	.us_fini = ub_cksum_fini,
+	.us_run  = {
+		{ .ub_name  = "md5-1M",
+		  .ub_iter  = UB_CKSUM_ITER,
+		  .ub_round = ub_md5 },
+		{ .ub_name  = "md5-ctx-1M",
+		  .ub_iter  = UB_CKSUM_ITER,
+		  .ub_round = ub_md5_inc },
+		{ .ub_name  = "crc32c-1M",
+		  .ub_iter  = UB_CKSUM_ITER,
+		  .ub_round = ub_crc32c },
+		{ .ub_name  = "crc32c-ctx-1M",
+		  .ub_iter  = UB_CKSUM_ITER,
+		  .ub_round = ub_crc32c_inc },
+		{ .ub_name  = "xxh64-1M",
+		  .ub_iter  = UB_CKSUM_ITER,
+		  .ub_round = ub_xxh64 },
+		{ .ub_name  = "xxh64-ctx-1M",
+		  .ub_iter  = UB_CKSUM_ITER,
+		  .ub_round = ub_xxh64_inc },
+		{ .ub_name = NULL }
+	}
+};
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -58,6 +58,7 @@ extern void test_fold(void);
 extern void m0_ut_lib_thread_pool_test(void);
 extern void test_combinations(void);
 extern void test_hash_fnc(void);
+extern void test_cksum(void);
 extern void m0_test_coroutine(void);
 extern void m0_test_coroutine2(void);
 
@@ -100,6 +101,7 @@ struct m0_ut_suite libm0_ut = {
 		{ "tpool",            m0_ut_lib_thread_pool_test },
 		{ "combinations",     test_combinations  },
 		{ "hash-fnc",         test_hash_fnc,     "Leonid" },
+		{ "cksum",            test_cksum         },
 		{ "coroutine",        m0_test_coroutine, "Anatoliy" },
 		{ "coroutine2",       m0_test_coroutine2,"Anatoliy" },
 		{ NULL,               NULL               }
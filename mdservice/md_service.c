@@ -74,6 +74,7 @@ struct m0_reqh_service_type m0_mds_type = {
 	.rst_ops      = &mds_type_ops,
 	.rst_level    = M0_MD_SVC_LEVEL,
 	.rst_typecode = M0_CST_MDS,
+	.rst_fom_prio = M0_FOM_PRIO_MD,
 };
 
 M0_INTERNAL int m0_mds_register(void)
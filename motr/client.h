@@ -1003,6 +1003,13 @@ struct m0_config {
 	 */
 	bool        mc_is_addb_init;
 
+	/**
+	 * On writes, copy application data, recalculate parity and compute
+	 * checksums of a parity group in one pass, while the group is still
+	 * in the cpu cache, instead of three passes over the whole request.
+	 */
+	bool        mc_is_fused_write;
+
 	/** Local endpoint.*/
 	const char *mc_local_addr;
 	/** HA service's endpoint.*/
@@ -1499,6 +1506,13 @@ void m0_obj_idx_init(struct m0_idx       *idx,
  * @remarks "data" defines buffers from which data are read on WRITE and
  * written to on READ.
  *
+ * @remarks Pages of "data" buffers which are aligned to the network buffer
+ * alignment (M0_NETBUF_SHIFT, e.g. allocated by m0_bufvec_alloc_aligned())
+ * are used for parity calculation and network transfer directly, without
+ * copying. Other pages (e.g. unaligned head and tail of a buffer) are copied
+ * to and from internal buffers. In both cases the buffers must not be
+ * modified or freed until the operation completes.
+ *
  * @remarks "attr" and "mask" together define which block attributes are read
  * or written.
  *
@@ -296,6 +296,12 @@ struct m0_op_io {
 	uint32_t                          ioo_flags;
 	/** Object's pool version */
 	struct m0_fid                     ioo_pver;
+	/**
+	 * PI type (enum m0_pi_algo_type) of checksums generated by motr,
+	 * resolved from the pool version by m0__obj_di_pi_type_resolve() when
+	 * the operation is launched. M0_PI_TYPE_RESERVED until then.
+	 */
+	uint8_t                           ioo_pi_type;
 
 	/** This is currently storing error status of DI validation for IO */
 	int32_t                           ioo_rc;
@@ -370,6 +376,12 @@ struct m0_op_io {
 	 */
 	uint64_t                         ioo_copied_nr;
 
+	/**
+	 * Number of data pages which are application buffers themselves, i.e.
+	 * are transferred without copying, see pargrp_iomap_databuf_alloc().
+	 */
+	uint64_t                         ioo_app_pages_nr;
+
 	/** Cached map index value from ioreq_iosm_handle_* functions */
 	uint64_t                         ioo_map_idx;
 
@@ -984,6 +996,7 @@ m0__obj_pool_version_is_valid(const struct m0_obj *obj);
 M0_INTERNAL bool m0__obj_is_parity_verify_mode(struct m0_client *instance);
 M0_INTERNAL bool m0__obj_is_di_cksum_gen_enabled(struct m0_op_io *ioo);
 M0_INTERNAL bool m0__obj_is_di_enabled(struct m0_op_io *ioo);
+M0_INTERNAL void m0__obj_di_pi_type_resolve(struct m0_op_io *ioo);
 M0_INTERNAL uint8_t m0__obj_di_cksum_type(struct m0_op_io *ioo);
 M0_INTERNAL uint32_t m0__obj_di_cksum_size(struct m0_op_io *ioo);
 M0_INTERNAL int m0_target_calculate_checksum(struct m0_op_io *ioo,
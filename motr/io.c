@@ -222,6 +222,8 @@ static void addb2_add_ioo_attrs(const struct m0_op_io *ioo, int rmw)
 	M0_ADDB2_ADD(M0_AVI_ATTR, ioid, M0_AVI_IOO_ATTR_BUFS_ALIGNED,
 		     (int)addr_is_network_aligned(ioo->ioo_data.ov_buf[0]));
 	M0_ADDB2_ADD(M0_AVI_ATTR, ioid, M0_AVI_IOO_ATTR_RMW, rmw);
+	M0_ADDB2_ADD(M0_AVI_ATTR, ioid, M0_AVI_IOO_ATTR_APP_PAGES,
+		     ioo->ioo_app_pages_nr);
 }
 
 /**
@@ -488,6 +490,7 @@ static int obj_io_init(struct m0_obj      *obj,
 	ioo->ioo_obj = obj;
 	ioo->ioo_ops = &ioo_ops;
 	ioo->ioo_pver = oo->oo_pver;
+	ioo->ioo_pi_type = M0_PI_TYPE_RESERVED;
 
 	/* Initialise this operation as a network transfer */
 	nw_xfer_request_init(&ioo->ioo_nwxfer);
@@ -667,12 +670,36 @@ M0_INTERNAL bool m0__obj_is_di_enabled(struct m0_op_io *ioo)
 	return ioo->ioo_obj->ob_entity.en_flags & (M0_ENF_DI | M0_ENF_GEN_DI);
 }
 
+/**
+ * Caches the PI type motr generates checksums with, configured per pool
+ * version, in m0_op_io::ioo_pi_type. Called once, when the operation is
+ * launched.
+ */
+M0_INTERNAL void m0__obj_di_pi_type_resolve(struct m0_op_io *ioo)
+{
+	struct m0_pool_version *pv;
+	struct m0_client       *cinst;
+
+	if (ioo->ioo_pi_type != M0_PI_TYPE_RESERVED)
+		return;
+	cinst = m0__op_instance(&ioo->ioo_oo.oo_oc.oc_op);
+	pv = m0_pool_version_find(&cinst->m0c_pools_common, &ioo->ioo_pver);
+	ioo->ioo_pi_type = pv != NULL ? pv->pv_pi_type : M0_CKSUM_DEFAULT_PI;
+}
+
+/** PI type motr generates checksums with. */
+static uint8_t ioo_pi_type(const struct m0_op_io *ioo)
+{
+	return ioo->ioo_pi_type != M0_PI_TYPE_RESERVED ?
+		ioo->ioo_pi_type : M0_CKSUM_DEFAULT_PI;
+}
+
 M0_INTERNAL uint8_t m0__obj_di_cksum_type(struct m0_op_io *ioo)
 {
 	struct m0_generic_pi *pi;
 
 	if (ioo->ioo_obj->ob_entity.en_flags & M0_ENF_GEN_DI)
-		return M0_CKSUM_DEFAULT_PI;
+		return ioo_pi_type(ioo);
 	else if ((ioo->ioo_obj->ob_entity.en_flags & M0_ENF_DI) &&
 		 ioo->ioo_attr.ov_buf) {
 		pi = (struct m0_generic_pi *)ioo->ioo_attr.ov_buf[0];
@@ -684,7 +711,7 @@ M0_INTERNAL uint8_t m0__obj_di_cksum_type(struct m0_op_io *ioo)
 M0_INTERNAL uint32_t m0__obj_di_cksum_size(struct m0_op_io *ioo)
 {
 	if (ioo->ioo_obj->ob_entity.en_flags & M0_ENF_GEN_DI)
-		return m0_cksum_get_size(M0_CKSUM_DEFAULT_PI);
+		return m0_cksum_get_size(ioo_pi_type(ioo));
 	else if ((ioo->ioo_obj->ob_entity.en_flags & M0_ENF_DI) &&
 		 ioo->ioo_attr.ov_buf)
 		return ioo->ioo_attr.ov_vec.v_count[0];
@@ -822,6 +822,7 @@ int m0_target_calculate_checksum(struct m0_op_io *ioo, uint8_t pi_type,
 	struct m0_buf              *buf;
 	struct m0_buf              *buf_seq;
 	uint64_t                    u_idx;
+	uint32_t                    size;
 
 	u_idx = cs_idx->ci_unit_idx;
 	if (cs_idx->ci_pg_idx >= ioo->ioo_iomap_nr)
@@ -852,6 +853,16 @@ int m0_target_calculate_checksum(struct m0_op_io *ioo, uint8_t pi_type,
 			return -EINVAL;
 	}
 
+	/* Computed when the data were copied, see ioreq_fused_write(). */
+	if (map->pi_cksum != NULL && map->pi_cksum_type == pi_type &&
+	    (filter == PA_PARITY || m0__obj_is_di_cksum_gen_enabled(ioo))) {
+		size = m0_cksum_get_size(pi_type);
+		if (filter == PA_PARITY)
+			u_idx += layout_n(play);
+		memcpy(chksm_buf, map->pi_cksum + u_idx * size, size);
+		return 0;
+	}
+
 	rc = m0_bufvec_empty_alloc(&bvec, rows_nr(play, obj));
 	if (rc != 0)
 		return -ENOMEM;
@@ -1748,6 +1759,21 @@ static void paritybufs_set_dgw_mode(struct pargrp_iomap *iomap,
 	}
 }
 
+/**
+ * Maps a unit of a parity group, using the targets mapped in advance by
+ * nw_xfer_io_distribute() if they are for the same group.
+ */
+static void nw_xfer_unit_map(struct nw_xfer_request           *xfer,
+			     struct m0_pdclust_instance       *pi,
+			     const struct m0_pdclust_src_addr *src,
+			     struct m0_pdclust_tgt_addr       *tgt)
+{
+	if (xfer->nxr_tgt != NULL && xfer->nxr_tgt_group == src->sa_group)
+		*tgt = xfer->nxr_tgt[src->sa_unit];
+	else
+		m0_fd_fwd_map(pi, src, tgt);
+}
+
 /**
  * Distributes file data into target_ioreq objects as required and populates
  * target_ioreq::ti_ivec and target_ioreq::ti_bufvec.
@@ -1777,6 +1803,7 @@ static int nw_xfer_io_distribute(struct nw_xfer_request *xfer)
 	struct target_ioreq        *ti;
 	struct m0_ivec_cursor       cursor;
 	struct m0_pdclust_layout   *play;
+	struct m0_pdclust_instance *play_instance;
 	enum m0_pdclust_unit_type   unit_type;
 	struct m0_pdclust_src_addr  src;
 	struct m0_pdclust_tgt_addr  tgt;
@@ -1817,12 +1844,23 @@ static int nw_xfer_io_distribute(struct nw_xfer_request *xfer)
 		if (rc != 0)
 			return M0_ERR(rc);
 	}
+	/*
+	 * Units of every group are mapped at once below. Without the memory,
+	 * nw_xfer_tioreq_map() maps them one by one.
+	 */
+	M0_ALLOC_ARR(xfer->nxr_tgt, m0_pdclust_size(play));
 
 	for (i = 0; i < ioo->ioo_iomap_nr; ++i) {
 		count        = 0;
 		iomap        = ioo->ioo_iomaps[i];
 		pgstart      = data_size(play) * iomap->pi_grpid;
 		src.sa_group = iomap->pi_grpid;
+		if (xfer->nxr_tgt != NULL) {
+			play_instance = pdlayout_instance(layout_instance(ioo));
+			m0_fd_fwd_map_groups(play_instance, src.sa_group, 1,
+					     xfer->nxr_tgt);
+			xfer->nxr_tgt_group = src.sa_group;
+		}
 
 		M0_LOG(M0_DEBUG, "xfer=%p map=%p [grpid=%" PRIu64 " state=%u]",
 				 xfer, iomap, iomap->pi_grpid, iomap->pi_state);
@@ -1938,6 +1976,7 @@ static int nw_xfer_io_distribute(struct nw_xfer_request *xfer)
 
 	if (do_cobs)
 		m0_bitmap_fini(&units_spanned);
+	m0_free0(&xfer->nxr_tgt);
 
 	M0_ASSERT(ergo(M0_IN(op_code, (M0_OC_READ, M0_OC_WRITE)),
 		       m0_vec_count(&ioo->ioo_ext.iv_vec) ==
@@ -1945,6 +1984,7 @@ static int nw_xfer_io_distribute(struct nw_xfer_request *xfer)
 
 	return M0_RC(0);
 err:
+	m0_free0(&xfer->nxr_tgt);
 	m0_htable_for(tioreqht, ti, &xfer->nxr_tioreqs_hash) {
 		tioreqht_htable_del(&xfer->nxr_tioreqs_hash, ti);
 		target_ioreq_fini(ti);
@@ -2377,7 +2417,7 @@ static int nw_xfer_tioreq_map(struct nw_xfer_request           *xfer,
 	M0_PRE(play_instance != NULL);
 
 	spare = *src;
-	m0_fd_fwd_map(play_instance, src, tgt);
+	nw_xfer_unit_map(xfer, play_instance, src, tgt);
 	tfid = target_fid(ioo, tgt);
 	M0_LOG(M0_DEBUG, "src_id[%" PRIu64 ":%" PRIu64 "] -> "
 			 "dest_id[%" PRIu64 ":%" PRIu64 "] @ tfid="FID_F,
@@ -2409,7 +2449,7 @@ static int nw_xfer_tioreq_map(struct nw_xfer_request           *xfer,
 		/* Check if there is an effective-failure. */
 		if (spare_slot_prev != src->sa_unit) {
 			spare.sa_unit = spare_slot_prev;
-			m0_fd_fwd_map(play_instance, &spare, tgt);
+			nw_xfer_unit_map(xfer, play_instance, &spare, tgt);
 			tfid = target_fid(ioo, tgt);
 			rc = m0_poolmach_device_state(pm, tgt->ta_obj,
 						      &dev_state_prev);
@@ -2420,7 +2460,7 @@ static int nw_xfer_tioreq_map(struct nw_xfer_request           *xfer,
 
 		if (dev_state_prev == M0_PNDS_SNS_REPAIRED) {
 			spare.sa_unit = spare_slot;
-			m0_fd_fwd_map(play_instance, &spare, tgt);
+			nw_xfer_unit_map(xfer, play_instance, &spare, tgt);
 			tfid = target_fid(ioo, tgt);
 		}
 		dev_state = dev_state_prev;
@@ -2464,6 +2504,7 @@ M0_INTERNAL void nw_xfer_request_init(struct nw_xfer_request *xfer)
 	m0_atomic64_set(&xfer->nxr_rdbulk_nr, 0);
 	xfer->nxr_state     = NXS_INITIALIZED;
 	xfer->nxr_ops       = &xfer_ops;
+	xfer->nxr_tgt       = NULL;
 	m0_mutex_init(&xfer->nxr_lock);
 
 	play = pdlayout_get(ioo);
@@ -911,13 +911,21 @@ static int pargrp_iomap_databuf_alloc(struct pargrp_iomap     *map,
 	if (data)
 		addr = m0_bufvec_cursor_addr(data);
 
+	/*
+	 * Zero-copy: the page is the application buffer, which is then used
+	 * for parity calculation and registered for network transfer as is.
+	 * This is possible if the buffer is aligned as network requires and
+	 * the whole page is within one application buffer.
+	 */
 	flags = PA_NONE | PA_APP_MEMORY;
 	/* Fall back to allocate-copy route */
-	if (!addr_is_network_aligned(addr) || addr == NULL) {
+	if (!addr_is_network_aligned(addr) || addr == NULL ||
+	    m0_bufvec_cursor_step(data) < obj_buffer_size(obj)) {
 		addr = m0_alloc_aligned(obj_buffer_size(obj),
 				        M0_NETBUF_SHIFT);
 		flags = PA_NONE;
-	}
+	} else
+		map->pi_ioo->ioo_app_pages_nr++;
 
 	data_buf_init(buf, addr, obj_buffer_size(obj), flags);
 	M0_POST_EX(data_buf_invariant(buf));
@@ -2423,6 +2431,7 @@ M0_INTERNAL int pargrp_iomap_init(struct pargrp_iomap  *map,
 	map->pi_state         = PI_HEALTHY;
 	map->pi_paritybufs    = NULL;
 	map->pi_trunc_partial = false;
+	map->pi_cksum         = NULL;
 
 	rc = m0_indexvec_alloc(&map->pi_ivec,
 			       page_nr(data_size(play), ioo->ioo_obj));
@@ -2563,6 +2572,7 @@ M0_INTERNAL void pargrp_iomap_fini(struct pargrp_iomap *map,
 
 	m0_free0(&map->pi_databufs);
 	m0_free0(&map->pi_paritybufs);
+	m0_free0(&map->pi_cksum);
 	map->pi_ioo = NULL;
 
 	M0_LEAVE();
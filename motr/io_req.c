@@ -32,7 +32,7 @@
 #include "rpc/rpclib.h"          /* m0_rpc_client_connect */
 #include "lib/ext.h"             /* struct m0_ext */
 #include "lib/misc.h"            /* M0_KEY_VAL_NULL */
-#include "lib/cksum.h"
+#include "lib/cksum_data.h"      /* m0_cksum_stream */
 
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_CLIENT
 #include "lib/trace.h"           /* M0_LOG */
@@ -157,6 +157,8 @@ const struct m0_bob_type ioo_bobtype = {
 	.bt_check        = NULL,
 };
 
+static int ioreq_fused_write(struct m0_op_io *ioo);
+
  /**
   * This is heavily based on m0t1fs/linux_kernel/file.c::is_pver_dud.
   *
@@ -330,6 +332,7 @@ static void ioreq_iosm_handle_launch(struct m0_sm_group *grp,
 	M0_PRE_EX(m0_op_io_invariant(ioo));
 	op = &ioo->ioo_oo.oo_oc.oc_op;
 	play = pdlayout_get(ioo);
+	m0__obj_di_pi_type_resolve(ioo);
 
 	/* @todo Do error handling based on m0_sm::sm_rc. */
 	/*
@@ -343,7 +346,16 @@ static void ioreq_iosm_handle_launch(struct m0_sm_group *grp,
 		state = (op->op_code == M0_OC_READ) ?
 			IRS_READING : IRS_WRITING;
 
-		if (state == IRS_WRITING) {
+		if (state == IRS_WRITING && op->op_code != M0_OC_FREE &&
+		    !m0_pdclust_is_replicated(play) &&
+		    m0__op_instance(op)->m0c_config->mc_is_fused_write) {
+			rc = ioreq_fused_write(ioo);
+			if (rc != 0) {
+				M0_LOG(M0_ERROR, "ioreq_fused_write() "
+						 "failed: rc=%d", rc);
+				goto fail_locked;
+			}
+		} else if (state == IRS_WRITING) {
 			if (op->op_code != M0_OC_FREE) {
 				rc = ioo->ioo_ops->iro_application_data_copy(ioo,
 					CD_COPY_FROM_APP, 0);
@@ -886,6 +898,7 @@ static int ioreq_iomaps_prepare(struct m0_op_io *ioo)
 		bufvec = false;
 
 	play = pdlayout_get(ioo);
+	ioo->ioo_app_pages_nr = 0;
 
 	M0_LOG(M0_DEBUG, "ioo=%p spanned_groups=%"PRIu64
 			 " [N,K,usz]=[%d,%d,%" PRIu64 "]",
@@ -982,7 +995,7 @@ static uint64_t data_buf_copy(struct data_buf          *data,
 			break;
 
 		/* app_data == data->db_buf.b_addr implies zero copy */
-		if (app_data != data->db_buf.b_addr) {
+		if (app_data != (char *)data->db_buf.b_addr + copied) {
 			if (dir == CD_COPY_FROM_APP)
 				memcpy((char*)data->db_buf.b_addr +
 				       copied, app_data, app_data_len);
@@ -1172,11 +1185,20 @@ static int ioreq_application_data_copy(struct m0_op_io *ioo,
 	M0_PRE(M0_IN(dir, (CD_COPY_FROM_APP, CD_COPY_TO_APP)));
 	M0_PRE_EX(m0_op_io_invariant(ioo));
 
+	play = pdlayout_get(ioo);
+	/*
+	 * All pages of the request are application buffers (zero-copy),
+	 * there is nothing to copy. Replicated layouts may have to copy
+	 * a good replica to the application, see application_data_copy().
+	 */
+	if (!m0_pdclust_is_replicated(play) &&
+	    ioo->ioo_app_pages_nr ==
+	    m0_vec_count(&ioo->ioo_ext.iv_vec) / m0__page_size(ioo))
+		return M0_RC(0);
+
 	m0_bufvec_cursor_init(&appdatacur, &ioo->ioo_data);
 	m0_ivec_cursor_init(&extcur, &ioo->ioo_ext);
 
-	play = pdlayout_get(ioo);
-
 	for (i = 0; i < ioo->ioo_iomap_nr; ++i) {
 		M0_ASSERT_EX(pargrp_iomap_invariant(ioo->ioo_iomaps[i]));
 
@@ -1245,6 +1267,246 @@ static int ioreq_parity_recalc(struct m0_op_io *ioo)
 				 iomap->pi_grpid);
 }
 
+/**
+ * Checksums computed during the fused pass over a write request, see
+ * ioreq_fused_write().
+ */
+struct fused_cksum {
+	/** Type of protection info, M0_PI_TYPE_RESERVED if none is needed. */
+	uint8_t                 fc_type;
+	uint32_t                fc_size;
+	/** Whether motr generates protection info of data units. */
+	bool                    fc_data;
+	/** Checksum streams of data units of the current parity group. */
+	struct m0_cksum_stream *fc_cs;
+	/** Next row of each data unit which can be fed to its stream. */
+	uint32_t               *fc_row;
+	/** Number of pages fed to each data unit stream. */
+	uint32_t               *fc_nr;
+	/** False if pages of some unit were not fed in order. */
+	bool                    fc_ordered;
+};
+
+static int fused_cksum_init(struct fused_cksum *fc, struct m0_op_io *ioo)
+{
+	uint32_t n = layout_n(pdlayout_get(ioo));
+
+	M0_SET0(fc);
+	fc->fc_type = M0_PI_TYPE_RESERVED;
+	if (!m0__obj_is_di_enabled(ioo) ||
+	    m0__obj_di_cksum_type(ioo) >= M0_PI_TYPE_MAX)
+		return 0;
+	fc->fc_type = m0__obj_di_cksum_type(ioo);
+	fc->fc_size = m0__obj_di_cksum_size(ioo);
+	fc->fc_data = m0__obj_is_di_cksum_gen_enabled(ioo);
+	M0_ALLOC_ARR(fc->fc_cs, n);
+	M0_ALLOC_ARR(fc->fc_row, n);
+	M0_ALLOC_ARR(fc->fc_nr, n);
+	return fc->fc_cs == NULL || fc->fc_row == NULL || fc->fc_nr == NULL ?
+		M0_ERR(-ENOMEM) : 0;
+}
+
+static void fused_cksum_fini(struct fused_cksum *fc)
+{
+	m0_free(fc->fc_cs);
+	m0_free(fc->fc_row);
+	m0_free(fc->fc_nr);
+}
+
+static int fused_cksum_group_start(struct fused_cksum *fc, uint32_t n)
+{
+	uint32_t col;
+	int      rc = 0;
+
+	if (fc->fc_type == M0_PI_TYPE_RESERVED || !fc->fc_data)
+		return 0;
+	fc->fc_ordered = true;
+	for (col = 0; rc == 0 && col < n; ++col) {
+		fc->fc_row[col] = 0;
+		fc->fc_nr[col]  = 0;
+		rc = m0_cksum_stream_init(&fc->fc_cs[col], fc->fc_type);
+	}
+	return rc;
+}
+
+/** Checksums the data page which has just been copied from the application. */
+static int fused_cksum_page(struct fused_cksum *fc, struct pargrp_iomap *map,
+			    uint32_t row, uint32_t col)
+{
+	struct m0_buf *buf = &map->pi_databufs[row][col]->db_buf;
+
+	if (fc->fc_type == M0_PI_TYPE_RESERVED || !fc->fc_data ||
+	    !fc->fc_ordered)
+		return 0;
+	if (row < fc->fc_row[col]) {
+		fc->fc_ordered = false;
+		return 0;
+	}
+	fc->fc_row[col] = row + 1;
+	fc->fc_nr[col]++;
+	return m0_cksum_stream_update(&fc->fc_cs[col], buf->b_addr,
+				      buf->b_nob);
+}
+
+/**
+ * Finalises checksums of the data units and computes checksums of the parity
+ * units of the group, right after its parity was calculated.
+ *
+ * Seeds are the same as in m0_target_calculate_checksum().
+ */
+static int fused_cksum_group_end(struct fused_cksum *fc,
+				 struct pargrp_iomap *map, uint64_t map_idx)
+{
+	struct m0_op_io          *ioo  = map->pi_ioo;
+	struct m0_pdclust_layout *play = pdlayout_get(ioo);
+	struct m0_cksum_stream    cs;
+	struct m0_pi_seed         seed;
+	struct data_buf          *db;
+	uint32_t                  row;
+	uint32_t                  col;
+	uint32_t                  nr;
+	int                       rc = 0;
+
+	m0_free0(&map->pi_cksum);
+	if (fc->fc_type == M0_PI_TYPE_RESERVED)
+		return 0;
+	/* Fall back to m0_target_calculate_checksum() for this group. */
+	if (fc->fc_data && !fc->fc_ordered)
+		return 0;
+	/* All pages of a data unit must have been fed to its stream. */
+	for (col = 0; fc->fc_data && col < layout_n(play); ++col) {
+		for (row = 0, nr = 0; row < rows_nr(play, ioo->ioo_obj); ++row)
+			nr += map->pi_databufs[row][col] != NULL;
+		if (nr != fc->fc_nr[col])
+			return 0;
+	}
+	map->pi_cksum = m0_alloc(fc->fc_size *
+				 (layout_n(play) + layout_k(play)));
+	if (map->pi_cksum == NULL)
+		return M0_ERR(-ENOMEM);
+	seed.pis_obj_id.f_container = ioo->ioo_obj->ob_entity.en_id.u_hi;
+	seed.pis_obj_id.f_key       = ioo->ioo_obj->ob_entity.en_id.u_lo;
+	for (col = 0; fc->fc_data && rc == 0 && col < layout_n(play); ++col) {
+		seed.pis_data_unit_offset = (map_idx +
+					     ioo->ioo_iomaps[0]->pi_grpid) *
+					    layout_n(play) + col;
+		rc = m0_cksum_stream_final(&fc->fc_cs[col],
+					   (struct m0_generic_pi *)
+					   (map->pi_cksum + col * fc->fc_size),
+					   &seed);
+	}
+	for (col = 0; rc == 0 && col < layout_k(play); ++col) {
+		rc = m0_cksum_stream_init(&cs, fc->fc_type);
+		for (row = 0; rc == 0 && row < rows_nr(play, ioo->ioo_obj);
+		     ++row) {
+			db = map->pi_paritybufs[row][col];
+			if (db != NULL)
+				rc = m0_cksum_stream_update(&cs,
+							    db->db_buf.b_addr,
+							    db->db_buf.b_nob);
+		}
+		seed.pis_data_unit_offset = (map_idx +
+					     ioo->ioo_iomaps[0]->pi_grpid) *
+					    layout_n(play) + col;
+		if (rc == 0)
+			rc = m0_cksum_stream_final(&cs, (struct m0_generic_pi *)
+						   (map->pi_cksum +
+						    (layout_n(play) + col) *
+						    fc->fc_size), &seed);
+	}
+	if (rc != 0)
+		m0_free0(&map->pi_cksum);
+	else
+		map->pi_cksum_type = fc->fc_type;
+	return M0_RC(rc);
+}
+
+/**
+ * Copies the data of a write request from the application, recalculates
+ * parity and computes protection info one parity group at a time.
+ *
+ * ioreq_application_data_copy(), ioreq_parity_recalc() and
+ * m0_target_calculate_checksum() each walk all pages of the request. For
+ * requests larger than the cpu cache every pass reads the pages from memory
+ * again. Here a data page is checksummed right after it is copied, and the
+ * parity of a group is calculated and checksummed right after the group is
+ * copied, while the group is still in the cache. Computed protection info is
+ * stored in pargrp_iomap::pi_cksum for m0_target_calculate_checksum().
+ *
+ * Used for writes which do not need read-modify-write, when
+ * m0_config::mc_is_fused_write is set.
+ */
+static int ioreq_fused_write(struct m0_op_io *ioo)
+{
+	int                       rc;
+	uint64_t                  i;
+	uint32_t                  row;
+	uint32_t                  col;
+	m0_bindex_t               grpstart;
+	m0_bindex_t               grpend;
+	m0_bindex_t               pgstart;
+	m0_bindex_t               pgend;
+	m0_bcount_t               count;
+	struct m0_bufvec_cursor   appdatacur;
+	struct m0_ivec_cursor     extcur;
+	struct m0_pdclust_layout *play;
+	struct pargrp_iomap      *map = NULL;
+	struct fused_cksum        fc;
+
+	M0_ENTRY("op_io : %p", ioo);
+	M0_PRE_EX(m0_op_io_invariant(ioo));
+
+	rc = fused_cksum_init(&fc, ioo);
+	if (rc != 0) {
+		fused_cksum_fini(&fc);
+		return M0_ERR(rc);
+	}
+	m0_bufvec_cursor_init(&appdatacur, &ioo->ioo_data);
+	m0_ivec_cursor_init(&extcur, &ioo->ioo_ext);
+	play = pdlayout_get(ioo);
+
+	for (i = 0; rc == 0 && i < ioo->ioo_iomap_nr; ++i) {
+		map = ioo->ioo_iomaps[i];
+		M0_ASSERT_EX(pargrp_iomap_invariant(map));
+		M0_ASSERT(map->pi_rtype == PIR_NONE);
+
+		count    = 0;
+		grpstart = data_size(play) * map->pi_grpid;
+		grpend   = grpstart + data_size(play);
+		rc = fused_cksum_group_start(&fc, layout_n(play));
+
+		while (rc == 0 && !m0_ivec_cursor_move(&extcur, count) &&
+		       m0_ivec_cursor_index(&extcur) < grpend) {
+			pgstart = m0_ivec_cursor_index(&extcur);
+			pgend = min64u(m0_round_up(pgstart + 1,
+						   m0__page_size(ioo)),
+				       pgstart + m0_ivec_cursor_step(&extcur));
+			count = pgend - pgstart;
+
+			rc = application_data_copy(map, ioo->ioo_obj,
+						   pgstart, pgend, &appdatacur,
+						   CD_COPY_FROM_APP, 0);
+			if (rc == 0) {
+				page_pos_get(map, pgstart, grpstart,
+					     &row, &col);
+				rc = fused_cksum_page(&fc, map, row, col);
+			}
+		}
+		if (rc == 0) {
+			m0_semaphore_down(&cpus_sem);
+			rc = map->pi_ops->pi_parity_recalc(map);
+			m0_semaphore_up(&cpus_sem);
+		}
+		if (rc == 0)
+			rc = fused_cksum_group_end(&fc, map, i);
+	}
+	fused_cksum_fini(&fc);
+
+	return rc == 0 ? M0_RC(rc) :
+		M0_ERR_INFO(rc, "Fused write failed for grpid=%3"PRIu64,
+			    map->pi_grpid);
+}
+
 /**
  * Reconstructs the missing data of parity groups.
  * This is heavily based on m0t1fs/linux_kernel/file.c::ioreq_dgmode_recover
@@ -1844,6 +1844,11 @@ int main(int argc, char **argv)
 
 	cr_set_debug_level(conf != NULL ? conf->log_level : CLL_WARN);
 
+	if (conf != NULL && conf->results_json != NULL &&
+	    cr_json_open(conf->results_json) != 0) {
+		m0_free(load);
+		return EXIT_FAILURE;
+	}
         if (idx < 0)
                 cr_log(CLL_INFO, "no workloads were specified\n");
         for (i = 0; i <= idx; ++i) {
@@ -1855,6 +1860,7 @@ int main(int argc, char **argv)
                 cr_log(CLL_INFO, "done workload %i\n", i);
                 cr_log(CLL_INFO, "---------------------------------------\n");
         }
+	cr_json_close();
 	m0_free(load);
         return 0;
 }
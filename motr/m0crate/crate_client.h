@@ -35,12 +35,16 @@
 #include "motr/client.h"
 #include "motr/m0crate/workload.h"
 #include "motr/m0crate/crate_utils.h"
+#include "motr/m0crate/crate_hist.h"
 
 struct crate_conf {
         /* Client parameters */
         bool is_addb_init;
         bool is_oostrore;
         bool is_read_verify;
+	bool is_fused_write;
+	/* Motr generates checksums of written data (M0_ENF_GEN_DI). */
+	bool is_gen_di;
         char *local_addr;
         char *ha_addr;
         char *prof;
@@ -58,6 +62,8 @@ struct crate_conf {
 	bool is_enf_meta;
 	bool is_skip_layout;
 	bool is_crow_disable;
+	/** Results are appended to this file in JSON format, if set. */
+	char *results_json;
 };
 
 enum m0_operation_type {
@@ -117,6 +123,14 @@ struct m0_workload_index {
 	struct m0_fid		index_fid;
 
 	uint64_t		seed;
+
+	/**
+	 * Operations per second issued by every thread (open loop).
+	 * 0 means "next operation is issued when the previous completes".
+	 */
+	unsigned		arrival_rate;
+	/** Poisson (true) or fixed (false) arrivals in open loop. */
+	bool			arrival_poisson;
 };
 
 struct m0_workload_task {
@@ -186,6 +200,11 @@ struct m0_workload_io {
 	m0_time_t         cwi_execution_time;
 	m0_time_t         cwi_time[CR_OPS_NR];
 	char             *cwi_filename;
+	/** Operations per second issued by every thread, 0 for closed loop. */
+	uint32_t          cwi_arrival_rate;
+	bool              cwi_arrival_poisson;
+	/** Latency histograms, indexed by enum m0_operations. */
+	struct cr_hist   *cwi_hist;
 };
 
 struct cti_global {
@@ -212,6 +231,8 @@ struct m0_task_io {
 	struct cti_global          cti_g;
 	/** Limit op_launch to max_nr_ops */
 	struct m0_semaphore        cti_max_ops_sem;
+	/** Schedule of operations in open-loop mode. */
+	struct cr_arrival          cti_arrival;
 };
 
 int parse_crate(int argc, char **argv, struct workload *w);
@@ -93,6 +93,7 @@ int init(struct workload *w)
 	m0_conf.mc_addb_size             = conf->addb_size;
 	m0_conf.mc_is_oostore            = conf->is_oostrore;
 	m0_conf.mc_is_read_verify        = conf->is_read_verify;
+	m0_conf.mc_is_fused_write        = conf->is_fused_write;
 	m0_conf.mc_local_addr            = conf->local_addr;
 	m0_conf.mc_ha_addr               = conf->ha_addr;
 	m0_conf.mc_profile               = conf->prof;
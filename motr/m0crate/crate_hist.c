@@ -0,0 +1,199 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include <math.h>         /* log */
+#include <pthread.h>
+#include <errno.h>
+#include <string.h>       /* strerror */
+
+#include "lib/arith.h"    /* m0_rnd64 */
+#include "lib/memory.h"   /* M0_ALLOC_ARR */
+#include "lib/misc.h"     /* M0_SET0 */
+#include "motr/m0crate/logger.h"
+#include "motr/m0crate/crate_hist.h"
+
+/**
+ * @addtogroup crate_hist
+ *
+ * @{
+ */
+
+void cr_hist_init(struct cr_hist *h)
+{
+	M0_SET0(h);
+	h->ch_min = INT64_MAX;
+}
+
+void cr_hist_record(struct cr_hist *h, m0_time_t latency)
+{
+	int64_t v = min64u(latency, INT64_MAX);
+	int64_t old;
+
+	m0_atomic64_inc(&h->ch_bucket[m0_addb2_loghist_idx(CR_HIST_PRECISION,
+							   v)]);
+	m0_atomic64_inc(&h->ch_count);
+	m0_atomic64_add(&h->ch_sum, v);
+	do {
+		old = h->ch_min;
+	} while (v < old && !m0_atomic64_cas(&h->ch_min, old, v));
+	do {
+		old = h->ch_max;
+	} while (v > old && !m0_atomic64_cas(&h->ch_max, old, v));
+}
+
+uint64_t cr_hist_count(const struct cr_hist *h)
+{
+	return m0_atomic64_get(&h->ch_count);
+}
+
+uint64_t cr_hist_percentile(const struct cr_hist *h, unsigned permille)
+{
+	uint64_t *bucket;
+	uint64_t  result;
+	int       i;
+
+	if (cr_hist_count(h) == 0)
+		return 0;
+	M0_ALLOC_ARR(bucket, CR_HIST_NR);
+	if (bucket == NULL)
+		return 0;
+	for (i = 0; i < CR_HIST_NR; ++i)
+		bucket[i] = m0_atomic64_get(&h->ch_bucket[i]);
+	result = m0_addb2_loghist_percentile(CR_HIST_PRECISION, bucket,
+					     permille);
+	m0_free(bucket);
+	return min64u(result, h->ch_max);
+}
+
+static uint64_t hist_min(const struct cr_hist *h)
+{
+	return cr_hist_count(h) == 0 ? 0 : h->ch_min;
+}
+
+static uint64_t hist_mean(const struct cr_hist *h)
+{
+	uint64_t count = cr_hist_count(h);
+
+	return count == 0 ? 0 : m0_atomic64_get(&h->ch_sum) / count;
+}
+
+void cr_hist_print(FILE *f, const char *label, const struct cr_hist *h)
+{
+	fprintf(f, "%s: ops=%" PRIu64 " min="TIME_F" mean="TIME_F
+		" p50="TIME_F" p99="TIME_F" p99.9="TIME_F" max="TIME_F"\n",
+		label, cr_hist_count(h),
+		TIME_P(hist_min(h)), TIME_P(hist_mean(h)),
+		TIME_P(cr_hist_percentile(h, 500)),
+		TIME_P(cr_hist_percentile(h, 990)),
+		TIME_P(cr_hist_percentile(h, 999)),
+		TIME_P((uint64_t)h->ch_max));
+}
+
+void cr_hist_json(FILE *f, const char *label, const struct cr_hist *h)
+{
+	fprintf(f, "\"%s\": {\"ops\": %" PRIu64 ", \"min_ns\": %" PRIu64
+		", \"mean_ns\": %" PRIu64 ", \"p50_ns\": %" PRIu64
+		", \"p99_ns\": %" PRIu64 ", \"p999_ns\": %" PRIu64
+		", \"max_ns\": %" PRIu64 "}",
+		label, cr_hist_count(h), hist_min(h), hist_mean(h),
+		cr_hist_percentile(h, 500), cr_hist_percentile(h, 990),
+		cr_hist_percentile(h, 999), (uint64_t)h->ch_max);
+}
+
+static FILE           *cr_json_file = NULL;
+static pthread_mutex_t cr_json_lock_m = PTHREAD_MUTEX_INITIALIZER;
+
+int cr_json_open(const char *path)
+{
+	cr_json_file = fopen(path, "a");
+	if (cr_json_file == NULL) {
+		cr_log(CLL_ERROR, "Cannot open results file %s: %s\n",
+		       path, strerror(errno));
+		return -errno;
+	}
+	return 0;
+}
+
+void cr_json_close(void)
+{
+	if (cr_json_file != NULL) {
+		fclose(cr_json_file);
+		cr_json_file = NULL;
+	}
+}
+
+FILE *cr_json_lock(void)
+{
+	if (cr_json_file == NULL)
+		return NULL;
+	pthread_mutex_lock(&cr_json_lock_m);
+	return cr_json_file;
+}
+
+void cr_json_unlock(void)
+{
+	fflush(cr_json_file);
+	pthread_mutex_unlock(&cr_json_lock_m);
+}
+
+void cr_arrival_init(struct cr_arrival *a, unsigned rate, bool poisson,
+		     uint64_t seed)
+{
+	M0_PRE(rate > 0);
+	a->ca_next    = m0_time_now();
+	a->ca_period  = M0_TIME_ONE_SECOND / rate;
+	a->ca_poisson = poisson;
+	a->ca_seed    = seed;
+}
+
+m0_time_t cr_arrival_wait(struct cr_arrival *a)
+{
+	m0_time_t start = a->ca_next;
+	m0_time_t now   = m0_time_now();
+	double    u;
+
+	if (start > now)
+		m0_nanosleep(m0_time_sub(start, now), NULL);
+	if (a->ca_poisson) {
+		/* Exponentially distributed gap, u is uniform in (0, 1]. */
+		u = ((m0_rnd64(&a->ca_seed) >> 11) + 1) /
+			(double)(1ULL << 53);
+		a->ca_next += (m0_time_t)(-log(u) * a->ca_period);
+	} else
+		a->ca_next += a->ca_period;
+	return start;
+}
+
+/** @} end of crate_hist group */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -0,0 +1,131 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#pragma once
+
+#ifndef __MOTR_M0CRATE_CRATE_HIST_H__
+#define __MOTR_M0CRATE_CRATE_HIST_H__
+
+#include <stdio.h>        /* FILE */
+#include "lib/types.h"
+#include "lib/time.h"     /* m0_time_t */
+#include "lib/atomic.h"   /* m0_atomic64 */
+#include "addb2/histogram.h"  /* M0_ADDB2_LOGHIST_NR */
+
+/**
+ * @defgroup crate_hist
+ *
+ * Latency histograms and open-loop arrivals for crate workloads.
+ *
+ * Latencies are recorded in the log-linear buckets of addb2 histograms
+ * (m0_addb2_loghist_idx()) with CR_HIST_PRECISION, so the relative error of a
+ * reported percentile is below 2^-(CR_HIST_PRECISION - 1). Recording is
+ * lock-free, so that a histogram can be shared by all threads of a workload
+ * and updated from operation completion callbacks.
+ *
+ * In open-loop mode (ARRIVAL_RATE > 0) every thread issues operations at the
+ * given rate, with fixed or exponentially distributed (Poisson process)
+ * inter-arrival times, whether earlier operations completed or not. Latency
+ * is measured from the time an operation was scheduled to start, so that
+ * queueing delays caused by a slow system are not hidden ("coordinated
+ * omission").
+ *
+ * @{
+ */
+
+enum {
+	CR_HIST_PRECISION = M0_ADDB2_LOGHIST_PRECISION_MAX,
+	CR_HIST_NR        = M0_ADDB2_LOGHIST_NR(CR_HIST_PRECISION)
+};
+
+struct cr_hist {
+	struct m0_atomic64 ch_count;
+	struct m0_atomic64 ch_sum;
+	/** Updated with m0_atomic64_cas(). */
+	int64_t            ch_min;
+	int64_t            ch_max;
+	struct m0_atomic64 ch_bucket[CR_HIST_NR];
+};
+
+void     cr_hist_init(struct cr_hist *h);
+void     cr_hist_record(struct cr_hist *h, m0_time_t latency);
+uint64_t cr_hist_count(const struct cr_hist *h);
+/**
+ * Returns the latency (in ns) which is not exceeded by "permille" 1/1000-ths
+ * of recorded values.
+ */
+uint64_t cr_hist_percentile(const struct cr_hist *h, unsigned permille);
+/** Prints "label: ops=... min=... mean=... p50=... ..." line to "f". */
+void     cr_hist_print(FILE *f, const char *label, const struct cr_hist *h);
+/** Prints "\"label\": {...}" JSON member to "f". */
+void     cr_hist_json(FILE *f, const char *label, const struct cr_hist *h);
+
+/**
+ * Machine-readable results.
+ *
+ * If RESULTS_JSON is set in the configuration, every workload (every thread
+ * of an index workload) appends one line with a JSON object describing its
+ * results to this file ("JSON lines" format), so that results of different
+ * runs and releases can be collected in one file.
+ */
+int   cr_json_open(const char *path);
+void  cr_json_close(void);
+/**
+ * Returns the results file locked for the caller, or NULL if JSON output is
+ * not enabled. The caller prints one line and calls cr_json_unlock().
+ */
+FILE *cr_json_lock(void);
+void  cr_json_unlock(void);
+
+struct cr_arrival {
+	/** Scheduled start of the next operation. */
+	m0_time_t ca_next;
+	/** Mean time between operations. */
+	m0_time_t ca_period;
+	bool      ca_poisson;
+	uint64_t  ca_seed;
+};
+
+/** Operations are issued at "rate" per second, starting now. */
+void      cr_arrival_init(struct cr_arrival *a, unsigned rate, bool poisson,
+			  uint64_t seed);
+/**
+ * Waits until the scheduled start of the next operation and returns it. If
+ * the schedule is behind, returns immediately.
+ */
+m0_time_t cr_arrival_wait(struct cr_arrival *a);
+
+/** @} end of crate_hist group */
+#endif /* __MOTR_M0CRATE_CRATE_HIST_H__ */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -102,6 +102,10 @@ extern struct crate_conf *conf;
  * * KEY_ORDER - defines key ordering in operations ("ordered" or "random").
  * * INDEX_FID - index fid (fid, for example, `<7800000000000001:0>`).
  * * LOG_LEVEL - logging level(err(0), warn(1), info(2), trace(3), debug(4)).
+ * * ARRIVAL_RATE - operations per second issued by each thread after warmup.
+ *	If not set or 0, next operation is issued when the previous one is
+ *	completed (closed loop).
+ * * ARRIVAL - "fixed" or "poisson" times between operations in open loop.
  *
  *
  * ## Operation order (see ::cr_idx_w_select_op)
@@ -131,8 +135,12 @@ extern struct crate_conf *conf;
  * how they change storage state.
  *
  * ## Measurements
- * Currently, only execution time is measured during the test. It measures with
- * `m0_time*` functions. Crate prints result to stdout when test is finished.
+ * Execution time is measured with `m0_time*` functions. Latency of every
+ * operation after warmup is recorded in a histogram (see @ref crate_hist) and
+ * p50/p99/p99.9/max are reported per operation type. In open loop, latency is
+ * counted from the time the operation was scheduled to start, so that time an
+ * operation waits for the previous (slow) one is not lost. Crate prints result
+ * to stdout when test is finished, and to RESULTS_JSON file if it is set.
  *
  * ## Logging
  * crate has own logging system, which based on `fprintf(stderr...)`.
@@ -353,6 +361,10 @@ struct cr_idx_w {
 	size_t				exec_time;
 	enum cr_op_selector		op_selector;
 	struct cr_idx_w_results	        ciw_results;
+	/** Latency histograms per cr_opcode, NULL during warmup. */
+	struct cr_hist                 *ciw_hist;
+	/** Schedule of operations in open-loop mode. */
+	struct cr_arrival               ciw_arrival;
 };
 
 static int cr_idx_w_init(struct cr_idx_w *ciw,
@@ -411,6 +423,35 @@ static void cr_time_capture_results(struct cr_time_measure_ctx *t,
 	}
 
 }
+/** Appends results to the JSON file. */
+static void cr_idx_w_json(struct cr_time_measure_ctx *t, struct cr_idx_w *w)
+{
+	FILE       *f;
+	const char *sep = "";
+	int         i;
+
+	f = cr_json_lock();
+	if (f == NULL)
+		return;
+	fprintf(f, "{\"workload\": \"index\", \"num_kvp\": %d, "
+		"\"key_size\": %d, \"value_size\": %d, "
+		"\"arrival_rate\": %u, \"arrival\": \"%s\", "
+		"\"total_s\": %f, \"ops\": {",
+		w->wit->num_kvs, w->wit->key_size, w->wit->value_size,
+		w->wit->arrival_rate,
+		w->wit->arrival_rate == 0 ? "closed" :
+		w->wit->arrival_poisson ? "poisson" : "fixed", t->elapsed);
+	for (i = 0; i < CRATE_OP_NR; i++) {
+		if (cr_hist_count(&w->ciw_hist[i]) != 0) {
+			fprintf(f, "%s", sep);
+			cr_hist_json(f, cr_idx_op_labels[i], &w->ciw_hist[i]);
+			sep = ", ";
+		}
+	}
+	fprintf(f, "}}\n");
+	cr_json_unlock();
+}
+
 /** RESULT REPORT */
 static void cr_time_measure_report(struct cr_time_measure_ctx *t,
 					struct cr_idx_w w)
@@ -450,6 +491,15 @@ static void cr_time_measure_report(struct cr_time_measure_ctx *t,
 				op_results[i].cior_op_count);
 		}
 	}
+
+	if (w.ciw_hist == NULL)
+		return;
+	for (i = 0; i < CRATE_OP_NR; i++) {
+		if (cr_hist_count(&w.ciw_hist[i]) != 0)
+			cr_hist_print(stdout, op_results[i].cior_op_label,
+				      &w.ciw_hist[i]);
+	}
+	cr_idx_w_json(t, &w);
 }
 
 
@@ -1143,7 +1193,10 @@ static int cr_idx_w_execute(struct cr_idx_w *w,
 		goto do_exit_kv;
 	}
 	/* accumulate time required by each op on opcode basis. */
-	op_start_time = m0_time_now();
+	if (w->ciw_hist != NULL && w->wit->arrival_rate > 0)
+		op_start_time = cr_arrival_wait(&w->ciw_arrival);
+	else
+		op_start_time = m0_time_now();
 	rc = cr_execute_query(&w->wit->index_fid, &kv, opcode);
 	op_time = m0_time_sub(m0_time_now(), op_start_time);
 	w->ciw_results.ciwr_ops_result[opcode].cior_ops_total_time_m0 =
@@ -1153,6 +1206,8 @@ static int cr_idx_w_execute(struct cr_idx_w *w,
 		rc = M0_ERR(rc);
 		goto do_exit_kv;
 	}
+	if (w->ciw_hist != NULL)
+		cr_hist_record(&w->ciw_hist[opcode], op_time);
 
 	if (op->readonly) {
 		if (!random)
@@ -1528,6 +1583,7 @@ static int index_operation(struct workload *wt,
 	struct m0_workload_index     *wit = wt->u.cw_index;
 	struct m0_uint128             index_fid;
 	int                           rc;
+	int                           i;
 
 	M0_PRE(crate_uber_realm() != NULL);
 	M0_PRE(crate_uber_realm()->re_instance != NULL);
@@ -1555,6 +1611,16 @@ static int index_operation(struct workload *wt,
 	if (rc != 0)
 		goto do_del_idx;
 
+	/* Only operations after warmup are measured. */
+	if (NULL == M0_ALLOC_ARR(w.ciw_hist, CRATE_OP_NR)) {
+		rc = M0_ERR(-ENOMEM);
+		goto do_del_idx;
+	}
+	for (i = 0; i < CRATE_OP_NR; i++)
+		cr_hist_init(&w.ciw_hist[i]);
+	if (wit->arrival_rate > 0)
+		cr_arrival_init(&w.ciw_arrival, wit->arrival_rate,
+				wit->arrival_poisson, m0_time_now());
 	rc = cr_idx_w_common(&w);
 	if (rc != 0)
 		goto do_del_idx;
@@ -1572,6 +1638,7 @@ do_exit_wg:
 	cr_time_measure_end(&t);
 	cr_time_capture_results(&t, &w);
 	cr_time_measure_report(&t, w);
+	m0_free(w.ciw_hist);
 do_exit:
 	return M0_RC(rc);
 }
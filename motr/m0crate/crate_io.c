@@ -66,10 +66,23 @@
  * * NR_THREADS: - Number of threads.
  * * EXEC_TIME - time limit for executing (seconds or "unlimited").
  * * NR_ROUNDS:  - How many times this workload to be executed.
+ * * ARRIVAL_RATE: - Operations per second issued by each thread. If not set
+ *	or 0, the next operation is issued as soon as one of MAX_NR_OPS
+ *	operations completes (closed loop).
+ * * ARRIVAL: - "fixed" or "poisson" times between operations in open loop.
  *
  * ## Measurements
- * Currently, only execution time is measured during the test. It measures with
- * `m0_time*` functions. Crate prints result to stdout when test is finished.
+ * Execution time is measured with `m0_time*` functions. Cpu time (user and
+ * system) consumed by the crate process is measured with getrusage(2) and is
+ * reported per GiB of data written and read, so that client-side cpu costs
+ * (data copying, parity and checksum calculation) of different configurations
+ * can be compared, e.g. with IS_FUSED_WRITE set to 0 and to 1. Latency of
+ * every operation is recorded in a histogram (see @ref crate_hist) and its
+ * percentiles are reported per operation type. In open loop, latency is
+ * counted from the time the operation was scheduled to start, which includes
+ * the time spent waiting for a free slot among MAX_NR_OPS. Crate prints
+ * result to stdout when test is finished, and to RESULTS_JSON file if it is
+ * set.
  * ## Logging
  * crate has own logging system, which based on `fprintf(stderr...)`.
  * (see ::crlog and see ::cr_log).
@@ -85,6 +98,7 @@
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/time.h>
+#include <sys/resource.h>         /* getrusage */
 #include <assert.h>
 #include <stdarg.h>
 #include <unistd.h>
@@ -107,6 +121,8 @@ void integrity(struct m0_uint128 object_id, unsigned char **md5toverify,
 void list_index_return(struct workload *w);
 
 struct m0_op_context {
+	/** Scheduled start, used for latency histograms. */
+	m0_time_t              coc_op_start;
 	m0_time_t              coc_op_launch;
 	m0_time_t              coc_op_finish;
 	int                    coc_index;
@@ -166,6 +182,9 @@ void cr_op_stable(struct m0_op *op)
 		op_time = m0_time_sub(op_context->coc_op_finish,
 				      op_context->coc_op_launch);
 		cr_time_acc(&cti->cti_op_acc_time, op_time);
+		cr_hist_record(&cti->cti_cwi->cwi_hist[op_context->coc_op_code],
+			       m0_time_sub(op_context->coc_op_finish,
+					   op_context->coc_op_start));
 		m0_semaphore_up(&cti->cti_max_ops_sem);
 		op_context->coc_buf_vec = NULL;
 	}
@@ -376,6 +395,8 @@ int cr_namei_open(struct m0_workload_io *cwi,
 	M0_PRE(obj != NULL);
 	M0_SET0(obj);
 	m0_obj_init(obj, crate_uber_realm(), id, cwi->cwi_layout_id);
+	if (conf->is_gen_di)
+		obj->ob_entity.en_flags |= M0_ENF_GEN_DI;
 	return m0_entity_open(&obj->ob_entity, &cti->cti_ops[free_slot]);
 }
 
@@ -438,6 +459,36 @@ int cr_io_read(struct m0_workload_io *cwi,
 	return rc;
 }
 
+/**
+ * Waits until the next operation can be launched and returns its scheduled
+ * start time.
+ *
+ * In open loop the operation is due at the time given by the task schedule,
+ * and it may have to wait further for one of cwi_max_nr_ops slots.
+ */
+static m0_time_t cr_op_slot_get(struct m0_workload_io *cwi,
+				struct m0_task_io *cti)
+{
+	m0_time_t start;
+
+	if (cwi->cwi_arrival_rate == 0) {
+		m0_semaphore_down(&cti->cti_max_ops_sem);
+		return m0_time_now();
+	}
+	start = cr_arrival_wait(&cti->cti_arrival);
+	m0_semaphore_down(&cti->cti_max_ops_sem);
+	return start;
+}
+
+static void cr_op_schedule_init(struct m0_workload_io *cwi,
+				struct m0_task_io *cti)
+{
+	if (cwi->cwi_arrival_rate > 0)
+		cr_arrival_init(&cti->cti_arrival, cwi->cwi_arrival_rate,
+				cwi->cwi_arrival_poisson,
+				m0_time_now() + cti->cti_task_idx);
+}
+
 cr_operation_t opcode_operation_map [] = {
 	[CR_CREATE]         = cr_namei_create,
 	[CR_OPEN]           = cr_namei_open,
@@ -455,14 +506,16 @@ int cr_execute_ops(struct m0_workload_io *cwi, struct m0_task_io *cti,
 	int                   idx;
 	struct m0_op_context *op_ctx;
 	cr_operation_t        spec_op;
+	m0_time_t             start;
 
 	for (i = 0; i < cti->cti_nr_ops; i++) {
-		m0_semaphore_down(&cti->cti_max_ops_sem);
+		start = cr_op_slot_get(cwi, cti);
 		/* We can launch at least one more operation. */
 		idx = cr_free_op_idx(cti, cwi->cwi_max_nr_ops);
 		op_ctx = m0_alloc(sizeof *op_ctx);
 		M0_ASSERT(op_ctx != NULL);
 
+		op_ctx->coc_op_start = start;
 		op_ctx->coc_index = idx;
 		op_ctx->coc_obj_index = obj_idx;
 		op_ctx->coc_task = cti;
@@ -507,6 +560,7 @@ int cr_op_namei(struct m0_workload_io  *cwi, struct m0_task_io *cti,
 	struct m0_op_context *op_ctx;
 	struct m0_op_ops     *cbs;
 	cr_operation_t        spec_op;
+	m0_time_t             start;
 	int                   rc = 0;
 
 	cbs = m0_alloc(sizeof *cbs);
@@ -520,15 +574,17 @@ int cr_op_namei(struct m0_workload_io  *cwi, struct m0_task_io *cti,
 	       op_code == CR_CREATE ? "Creating" :
 	       op_code == CR_OPEN ? "Opening" : "Deleting");
 	m0_semaphore_init(&cti->cti_max_ops_sem, cwi->cwi_max_nr_ops);
+	cr_op_schedule_init(cwi, cti);
 	stime = m0_time_now();
 
 	for (i = 0; i < cwi->cwi_nr_objs; i++) {
-		m0_semaphore_down(&cti->cti_max_ops_sem);
+		start = cr_op_slot_get(cwi, cti);
 		/* We can launch at least one more operation. */
 		idx = cr_free_op_idx(cti, cwi->cwi_max_nr_ops);
 		op_ctx = m0_alloc(sizeof *op_ctx);
 		M0_ASSERT(op_ctx != NULL);
 
+		op_ctx->coc_op_start = start;
 		op_ctx->coc_index = idx;
 		op_ctx->coc_task = cti;
 		op_ctx->coc_op_code = op_code;
@@ -607,6 +663,7 @@ int cr_op_io(struct m0_workload_io  *cwi, struct m0_task_io *cti,
 	       TIME_P(m0_time_now()), cti->cti_task_idx,
 	       op_code == CR_WRITE ? "Writing" : "Reading");
 	m0_semaphore_init(&cti->cti_max_ops_sem, cwi->cwi_max_nr_ops);
+	cr_op_schedule_init(cwi, cti);
 	stime = m0_time_now();
 
 	for (i = 0; i < cwi->cwi_nr_objs; i++) {
@@ -914,10 +971,13 @@ int cr_task_prep_one(struct m0_workload_io *cwi,
 	if (cti->cti_objs == NULL)
 		goto enomem;
 
-	for (i = 0; i < cwi->cwi_nr_objs; i++)
+	for (i = 0; i < cwi->cwi_nr_objs; i++) {
 		m0_obj_init(&cti->cti_objs[i],
 				   crate_uber_realm(),
 				   &cti->cti_ids[i], cwi->cwi_layout_id);
+		if (conf->is_gen_di)
+			cti->cti_objs[i].ob_entity.en_flags |= M0_ENF_GEN_DI;
+	}
 
 	M0_ALLOC_ARR(cti->cti_ops, cwi->cwi_max_nr_ops);
 	if (cti->cti_ops == NULL)
@@ -1010,18 +1070,95 @@ static uint64_t bw(uint64_t bytes, m0_time_t time)
 	return bytes * M0_TIME_ONE_MSEC / (time / 1000);
 }
 
+/** Returns cpu time (user + system) consumed by the process so far. */
+static m0_time_t cpu_time(void)
+{
+	struct rusage ru;
+
+	if (getrusage(RUSAGE_SELF, &ru) != 0)
+		return 0;
+	return m0_time(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec,
+		       (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1000);
+}
+
+/** Returns cpu time per GiB of data. */
+static m0_time_t cpu_per_gib(m0_time_t cpu, uint64_t bytes)
+{
+	return bytes == 0 ? 0 : (m0_time_t)((double)cpu * (1ULL << 30) / bytes);
+}
+
+static const char *cr_io_op_name[CR_OPS_NR] = {
+	[CR_CREATE] = "CREATE",
+	[CR_OPEN]   = "OPEN",
+	[CR_WRITE]  = "WRITE",
+	[CR_READ]   = "READ",
+	[CR_DELETE] = "DELETE"
+};
+
+/** Prints latency percentiles and appends results to the JSON file. */
+static void cr_io_report(struct workload *w, m0_time_t cpu, uint64_t written,
+			 uint64_t read)
+{
+	struct m0_workload_io *cwi = w->u.cw_io;
+	FILE                  *f;
+	const char            *sep = "";
+	int                    i;
+
+	for (i = 0; i < CR_OPS_NR; i++) {
+		if (cr_hist_count(&cwi->cwi_hist[i]) != 0)
+			cr_hist_print(stdout, cr_io_op_name[i],
+				      &cwi->cwi_hist[i]);
+	}
+	f = cr_json_lock();
+	if (f == NULL)
+		return;
+	fprintf(f, "{\"workload\": \"io\", \"opcode\": %d, \"threads\": %u, "
+		"\"objs\": %d, \"block_size\": %" PRIu64 ", "
+		"\"blocks_per_op\": %u, \"max_nr_ops\": %u, "
+		"\"arrival_rate\": %u, \"arrival\": \"%s\", "
+		"\"time_ns\": %" PRIu64 ", \"cpu_ns\": %" PRIu64 ", "
+		"\"written\": %" PRIu64 ", \"read\": %" PRIu64 ", \"ops\": {",
+		cwi->cwi_opcode, w->cw_nr_thread,
+		cwi->cwi_nr_objs * w->cw_nr_thread, cwi->cwi_bs,
+		cwi->cwi_bcount_per_op, cwi->cwi_max_nr_ops,
+		cwi->cwi_arrival_rate,
+		cwi->cwi_arrival_rate == 0 ? "closed" :
+		cwi->cwi_arrival_poisson ? "poisson" : "fixed",
+		m0_time_sub(cwi->cwi_finish_time, cwi->cwi_start_time),
+		cpu, written, read);
+	for (i = 0; i < CR_OPS_NR; i++) {
+		if (cr_hist_count(&cwi->cwi_hist[i]) != 0) {
+			fprintf(f, "%s", sep);
+			cr_hist_json(f, cr_io_op_name[i], &cwi->cwi_hist[i]);
+			sep = ", ";
+		}
+	}
+	fprintf(f, "}}\n");
+	cr_json_unlock();
+}
+
 void run(struct workload *w, struct workload_task *tasks)
 {
 	int                    i;
 	uint64_t               written;
 	uint64_t               read;
+	uint64_t               total;
 	int                    rc;
 	struct m0_workload_io *cwi = w->u.cw_io;
 	struct m0_uint128      start_obj_id;
+	m0_time_t              cpu;
 
+	M0_ALLOC_ARR(cwi->cwi_hist, CR_OPS_NR);
+	if (cwi->cwi_hist == NULL) {
+		cr_log(CLL_ERROR, "Cannot allocate histograms.\n");
+		return;
+	}
+	for (i = 0; i < CR_OPS_NR; i++)
+		cr_hist_init(&cwi->cwi_hist[i]);
 	start_obj_id = cwi->cwi_start_obj_id;
 	m0_mutex_init(&cwi->cwi_g.cg_mutex);
 	cwi->cwi_start_time = m0_time_now();
+	cpu = cpu_time();
 	if (M0_IN(cwi->cwi_opcode, (CR_POPULATE, CR_CLEANUP)) &&
 	    !entity_id_is_valid(&cwi->cwi_start_obj_id))
 		cwi->cwi_start_obj_id = M0_ID_APP;
@@ -1032,6 +1169,7 @@ void run(struct workload *w, struct workload_task *tasks)
 		if (rc != 0) {
 			cr_tasks_release(w, tasks);
 			m0_mutex_fini(&cwi->cwi_g.cg_mutex);
+			m0_free0(&cwi->cwi_hist);
 			cr_log(CLL_ERROR, "Task preparation failed.\n");
 			return;
 		}
@@ -1051,12 +1189,17 @@ void run(struct workload *w, struct workload_task *tasks)
 
 	m0_mutex_fini(&cwi->cwi_g.cg_mutex);
 	cwi->cwi_finish_time = m0_time_now();
+	cpu = m0_time_sub(cpu_time(), cpu);
 
 	cr_log(CLL_INFO, "I/O workload is finished.\n");
 	cr_log(CLL_INFO, "Total: time="TIME_F" objs=%d ops=%" PRIu64 "\n",
 	       TIME_P(m0_time_sub(cwi->cwi_finish_time, cwi->cwi_start_time)),
 	       cwi->cwi_nr_objs * w->cw_nr_thread,
 	       cwi->cwi_ops_done[CR_WRITE] + cwi->cwi_ops_done[CR_READ]);
+	total = cwi->cwi_bs * cwi->cwi_bcount_per_op *
+		(cwi->cwi_ops_done[CR_WRITE] + cwi->cwi_ops_done[CR_READ]);
+	cr_log(CLL_INFO, "CPU: "TIME_F" ("TIME_F" per GiB)\n",
+	       TIME_P(cpu), TIME_P(cpu_per_gib(cpu, total)));
 	if (cwi->cwi_ops_done[CR_CREATE] != 0)
 		cr_log(CLL_INFO, "C: "TIME_F" ("TIME_F" per op)\n",
 		       TIME_P(cwi->cwi_time[CR_CREATE]),
@@ -1072,26 +1215,26 @@ void run(struct workload *w, struct workload_task *tasks)
 		       TIME_P(cwi->cwi_time[CR_DELETE]),
 		       TIME_P(cwi->cwi_g.cg_cwi_acc_time[CR_DELETE] /
 			      cwi->cwi_ops_done[CR_DELETE]));
-	if (cwi->cwi_ops_done[CR_WRITE] == 0)
-		return;
 	written = cwi->cwi_bs * cwi->cwi_bcount_per_op *
 	          cwi->cwi_ops_done[CR_WRITE];
-	cr_log(CLL_INFO, "W: "TIME_F" ("TIME_F" per op), "
-	       "%" PRIu64 " KiB, %" PRIu64 " KiB/s\n",
-	       TIME_P(cwi->cwi_time[CR_WRITE]),
-	       TIME_P(cwi->cwi_g.cg_cwi_acc_time[CR_WRITE] /
-		      cwi->cwi_ops_done[CR_WRITE]), written/1024,
-	       bw(written, cwi->cwi_time[CR_WRITE]) /1024);
-	if (cwi->cwi_ops_done[CR_READ] == 0)
-		return;
+	if (cwi->cwi_ops_done[CR_WRITE] != 0)
+		cr_log(CLL_INFO, "W: "TIME_F" ("TIME_F" per op), "
+		       "%" PRIu64 " KiB, %" PRIu64 " KiB/s\n",
+		       TIME_P(cwi->cwi_time[CR_WRITE]),
+		       TIME_P(cwi->cwi_g.cg_cwi_acc_time[CR_WRITE] /
+			      cwi->cwi_ops_done[CR_WRITE]), written/1024,
+		       bw(written, cwi->cwi_time[CR_WRITE]) /1024);
 	read = cwi->cwi_bs * cwi->cwi_bcount_per_op *
 	       cwi->cwi_ops_done[CR_READ];
-	cr_log(CLL_INFO, "R: "TIME_F" ("TIME_F" per op), "
-	       "%" PRIu64 " KiB, %" PRIu64 " KiB/s\n",
-	       TIME_P(cwi->cwi_time[CR_READ]),
-	       TIME_P(cwi->cwi_g.cg_cwi_acc_time[CR_READ] /
-		      cwi->cwi_ops_done[CR_READ]), read/1024,
-	       bw(read, cwi->cwi_time[CR_READ]) /1024);
+	if (cwi->cwi_ops_done[CR_READ] != 0)
+		cr_log(CLL_INFO, "R: "TIME_F" ("TIME_F" per op), "
+		       "%" PRIu64 " KiB, %" PRIu64 " KiB/s\n",
+		       TIME_P(cwi->cwi_time[CR_READ]),
+		       TIME_P(cwi->cwi_g.cg_cwi_acc_time[CR_READ] /
+			      cwi->cwi_ops_done[CR_READ]), read/1024,
+		       bw(read, cwi->cwi_time[CR_READ]) /1024);
+	cr_io_report(w, cpu, written, read);
+	m0_free0(&cwi->cwi_hist);
 }
 
 void m0_op_run(struct workload *w, struct workload_task *task,
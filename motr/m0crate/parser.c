@@ -46,6 +46,8 @@ enum config_key_val {
 	LAYOUT_ID,
 	IS_OOSTORE,
 	IS_READ_VERIFY,
+	IS_FUSED_WRITE,
+	IS_GEN_DI,
 	MAX_QUEUE_LEN,
 	MAX_RPC_MSG,
 	PROCESS_FID,
@@ -59,6 +61,7 @@ enum config_key_val {
 	IS_SKIP_LAYOUT,
 	IS_CROW_DISABLE,
 	LOG_LEVEL,
+	RESULTS_JSON,
 	/*
 	 * All parameters below are workload-specific,
 	 * anything else should be added above this point.
@@ -103,6 +106,8 @@ enum config_key_val {
 	INSERT,
 	LOOKUP,
 	DELETE,
+	ARRIVAL_RATE,
+	ARRIVAL,
 };
 
 struct key_lookup_table {
@@ -117,6 +122,8 @@ struct key_lookup_table lookuptable[] = {
 	{"LAYOUT_ID", LAYOUT_ID},
 	{"IS_OOSTORE", IS_OOSTORE},
 	{"IS_READ_VERIFY", IS_READ_VERIFY},
+	{"IS_FUSED_WRITE", IS_FUSED_WRITE},
+	{"IS_GEN_DI", IS_GEN_DI},
 	{"TM_RECV_QUEUE_MIN_LEN", MAX_QUEUE_LEN},
 	{"M0_MAX_RPC_MSG_SIZE", MAX_RPC_MSG},
 	{"PROCESS_FID", PROCESS_FID},
@@ -171,7 +178,10 @@ struct key_lookup_table lookuptable[] = {
 	{"PATTERN", PATTERN},
 	{"INSERT", INSERT},
 	{"LOOKUP", LOOKUP},
-	{"DELETE", DELETE}
+	{"DELETE", DELETE},
+	{"RESULTS_JSON", RESULTS_JSON},
+	{"ARRIVAL_RATE", ARRIVAL_RATE},
+	{"ARRIVAL", ARRIVAL}
 };
 
 #define NKEYS (sizeof(lookuptable)/sizeof(struct key_lookup_table))
@@ -268,6 +278,8 @@ int copy_value(struct workload *load, int max_workload, int *index,
 	struct cr_workload_btree *cbw;
 	int			 *key_size;
 	int			 *val_size;
+	int			  rate;
+	bool			  poisson;
 
 	if (m0_streq(value, conf_section_name)) {
 		if (conf != NULL) {
@@ -332,6 +344,12 @@ int copy_value(struct workload *load, int max_workload, int *index,
 		case IS_READ_VERIFY:
 			conf->is_read_verify = atoi(value);
 			break;
+		case IS_FUSED_WRITE:
+			conf->is_fused_write = atoi(value);
+			break;
+		case IS_GEN_DI:
+			conf->is_gen_di = atoi(value);
+			break;
 		case IDX_SERVICE_ID:
 			conf->index_service_id = atoi(value);
 			break;
@@ -671,6 +689,12 @@ int copy_value(struct workload *load, int max_workload, int *index,
 		case IS_CROW_DISABLE:
 			conf->is_crow_disable = atoi(value);
 			break;
+		case RESULTS_JSON:
+			conf->results_json = m0_alloc(value_len + 1);
+			if (conf->results_json == NULL)
+				return -ENOMEM;
+			strcpy(conf->results_json, value);
+			break;
 		case PATTERN:
 			w = &load[*index];
 			cbw = workload_btree(w);
@@ -694,6 +718,37 @@ int copy_value(struct workload *load, int max_workload, int *index,
 			cbw->cwb_bo[BOT_DELETE].prcnt = parse_int(value,
 								  DELETE);
 			break;
+		case ARRIVAL_RATE:
+			w = &load[*index];
+			rate = parse_int(value, ARRIVAL_RATE);
+			if (rate < 0)
+				parser_emit_error("Invalid arrival rate: %s",
+						  value);
+			if (w->cw_type == CWT_INDEX) {
+				ciw = workload_index(w);
+				ciw->arrival_rate = rate;
+			} else {
+				cw = workload_io(w);
+				cw->cwi_arrival_rate = rate;
+			}
+			break;
+		case ARRIVAL:
+			w = &load[*index];
+			if (!strcmp(value, "poisson"))
+				poisson = true;
+			else if (!strcmp(value, "fixed"))
+				poisson = false;
+			else
+				parser_emit_error("Unknown arrival process: "
+						  "'%s'", value);
+			if (w->cw_type == CWT_INDEX) {
+				ciw = workload_index(w);
+				ciw->arrival_poisson = poisson;
+			} else {
+				cw = workload_io(w);
+				cw->cwi_arrival_poisson = poisson;
+			}
+			break;
 		default:
 			break;
 	}
@@ -101,6 +101,18 @@ enum m0_magic_satchel {
 	/* be_alloc_chunk::bac_magic_free (edifice faded) */
 	M0_BE_ALLOC_FREE_LINK_MAGIC = 0xed1f1cefaded,
 
+	/* be_alloc_slab::bsl_magic (scalable baffle) */
+	M0_BE_ALLOC_SLAB_MAGIC = 0x5ca1ab1ebaff1e,
+
+	/* be_alloc_slab_obj::bso_magic (objected scalable) */
+	M0_BE_ALLOC_SLAB_OBJ_MAGIC = 0x0b1ec7ed5ca1ab1e,
+
+	/* be_alloc_slab::bsl_link_magic (callable code) */
+	M0_BE_ALLOC_SLAB_LINK_MAGIC = 0x33ca11ab1ec0de77,
+
+	/* m0_be_alloc_arena::baa_slabs[] (baseballed) */
+	M0_BE_ALLOC_SLAB_HEAD_MAGIC = 0x33ba5eba11ed1e77,
+
 	/* m0_be_0type::b0_magic (bee fires stig) */
 	M0_BE_0TYPE_MAGIC = 0x33beef17e5519177,
 
@@ -917,6 +929,9 @@ enum m0_magic_satchel {
 	/* rpc_conn_tl::td_head_magic (bloodless god) */
 	M0_RPC_CONN_HEAD_MAGIC = 0x33b100d1e5590d77,
 
+	/* rpc_conn_hash_tl::td_head_magic (diced office) */
+	M0_RPC_CONN_HASH_HEAD_MAGIC = 0x33d1ced0ff1ce077,
+
 	/* m0_rpc_session::s_magic (azido ballade) */
 	M0_RPC_SESSION_MAGIC = 0x33a21d0ba11ade77,
 
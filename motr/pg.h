@@ -312,6 +312,15 @@ struct nw_xfer_request {
 	 * The number is decremented in cc_bottom_half.
 	 */
 	struct m0_atomic64        nxr_ccfop_nr;
+
+	/**
+	 * Targets of all units of the parity group nxr_tgt_group, mapped at
+	 * once by nw_xfer_io_distribute() with m0_fd_fwd_map_groups().
+	 * NULL outside of nw_xfer_io_distribute(), in which case units are
+	 * mapped one by one.
+	 */
+	struct m0_pdclust_tgt_addr *nxr_tgt;
+	uint64_t                    nxr_tgt_group;
 };
 
 /**
@@ -403,6 +412,17 @@ struct pargrp_iomap {
 	 * any of the replicas of this group are corrupted.
 	 */
 	bool                            pi_is_corrupted;
+
+	/**
+	 * Protection info of the data units followed by protection info of
+	 * the parity units of the group, m0_cksum_get_size(pi_cksum_type)
+	 * bytes each. It is computed on writes when the data are copied from
+	 * the application, see m0_config::mc_is_fused_write, and used instead
+	 * of walking the units again in m0_target_calculate_checksum().
+	 * NULL if not computed.
+	 */
+	unsigned char                  *pi_cksum;
+	uint8_t                         pi_cksum_type;
 };
 
 /** Operations vector for struct pargrp_iomap. */
@@ -329,6 +329,7 @@ M0_INTERNAL int m0_ep_and_xprt_extract(struct cs_endpoint_and_xprt *epx,
 {
 	char *sptr;
 	char *endpoint;
+	char *params;
 	int   ep_len;
 
 	M0_PRE(ep != NULL);
@@ -344,6 +345,13 @@ M0_INTERNAL int m0_ep_and_xprt_extract(struct cs_endpoint_and_xprt *epx,
 	epx->ex_xprt = strtok_r(epx->ex_scrbuf, ":", &sptr);
 	if (epx->ex_xprt == NULL)
 		goto err;
+	/* Optional transport parameters: "xprt,param[=value],...". */
+	params = strchr(epx->ex_xprt, ',');
+	if (params != NULL) {
+		*params = '\0';
+		epx->ex_xprt_params = params + 1;
+	} else
+		epx->ex_xprt_params = NULL;
 
 	endpoint = strtok_r(NULL, "\0", &sptr);
 	if (endpoint == NULL)
@@ -1248,6 +1256,31 @@ static int reqh_services_start(struct m0_reqh_context *rctx,
 	return M0_RC(rc);
 }
 
+/**
+   Applies transport parameters given with the endpoint (see
+   m0_ep_and_xprt_extract()) to the network domain, before any transfer
+   machine is initialised in it.
+ */
+static int cs_net_domain_params_set(struct m0_net_domain *ndom,
+				    struct cs_endpoint_and_xprt *ep)
+{
+	char *params;
+	char *param;
+	char *sptr;
+	int   rc = 0;
+
+	if (ep->ex_xprt_params == NULL)
+		return 0;
+	params = m0_strdup(ep->ex_xprt_params);
+	if (params == NULL)
+		return M0_ERR(-ENOMEM);
+	for (param = strtok_r(params, ",", &sptr); param != NULL && rc == 0;
+	     param = strtok_r(NULL, ",", &sptr))
+		rc = m0_net_domain_param_set(ndom, param);
+	m0_free(params);
+	return M0_RC(rc);
+}
+
 static int
 cs_net_domain_init(struct cs_endpoint_and_xprt *ep, struct m0_motr *cctx)
 {
@@ -1263,7 +1296,7 @@ cs_net_domain_init(struct cs_endpoint_and_xprt *ep, struct m0_motr *cctx)
 
 	ndom = m0_cs_net_domain_locate(cctx, ep->ex_xprt);
 	if (ndom != NULL)
-		return 0; /* pass */
+		return cs_net_domain_params_set(ndom, ep); /* pass */
 
 	M0_ALLOC_PTR(ndom);
 	if (ndom == NULL) {
@@ -1277,7 +1310,8 @@ cs_net_domain_init(struct cs_endpoint_and_xprt *ep, struct m0_motr *cctx)
 
 	m0_net_domain_bob_init(ndom);
 	ndom_tlink_init_at_tail(ndom, &cctx->cc_ndoms);
-	return 0;
+	/* The domain is finalised by cs_net_domains_fini() on failure. */
+	return cs_net_domain_params_set(ndom, ep);
 err:
 	m0_free(ndom); /* freeing NULL does not hurt */
 	return M0_RC(rc);
@@ -1580,6 +1614,8 @@ static int cs_reqh_start(struct m0_reqh_context *rctx)
 			  .rhia_mdstore = &rctx->rc_mdstore,
 			  .rhia_pc = &rctx->rc_motr->cc_pools_common,
 			  .rhia_fid = &rctx->rc_fid);
+	if (rc == 0)
+		m0_fom_domain_steal_enable(m0_fom_dom(), rctx->rc_fom_steal);
 	rctx->rc_state = RC_REQH_INITIALISED;
 	return M0_RC(rc);
 }
@@ -2325,7 +2361,8 @@ static int _args_parse(struct m0_motr *cctx, int argc, char **argv)
 			 * configuration.
 			 */
 			M0_STRINGARG('e', "Network endpoint,"
-				     " e.g. transport:address",
+				     " e.g. transport:address or"
+				     " transport,param[=value],...:address",
 				LAMBDA(void, (const char *s)
 				{
 				      rc = ep_and_xprt_append(&rctx->rc_eps, s);
@@ -2373,6 +2410,11 @@ static int _args_parse(struct m0_motr *cctx, int argc, char **argv)
 				{
 					rctx->rc_lru_wm_high = high;
 				})),
+			M0_VOIDARG('W', "Enable FOM work stealing",
+				LAMBDA(void, (void)
+				{
+					rctx->rc_fom_steal = true;
+				})),
 			);
 	/* generate reqh fid in case it is all-zero */
 	process_fid_generate_conditional(rctx);
@@ -174,6 +174,12 @@ struct cs_endpoint_and_xprt {
 	const char      *ex_endpoint;
 	/** Supported network transport. */
 	const char      *ex_xprt;
+	/**
+	   Comma separated transport parameters, given as
+	   "transport,param[=value],...:address", or NULL.
+	   @see m0_net_domain_param_set().
+	 */
+	const char      *ex_xprt_params;
 	/**
 	   Scratch buffer for endpoint and transport extraction.
 	 */
@@ -353,6 +359,9 @@ struct m0_reqh_context {
 	int64_t                      rc_lru_wm_low;
 	int64_t                      rc_lru_wm_mid;
 	int64_t                      rc_lru_wm_high;
+
+	/** Enable FOM work stealing between localities */
+	bool                         rc_fom_steal;
 };
 
 /**
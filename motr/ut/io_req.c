@@ -1312,6 +1312,199 @@ M0_INTERNAL int ut_io_req_fini(void)
 	return 0;
 }
 
+/**
+ * Mock parity: xor of the data units of each row, so that the result depends
+ * on the data copied by the time parity is calculated.
+ */
+static int ut_fused_parity_recalc(struct pargrp_iomap *map)
+{
+	uint32_t     row;
+	uint32_t     col;
+	m0_bcount_t  i;
+	char        *parity;
+	char        *data;
+
+	for (row = 0; row < map->pi_max_row; ++row) {
+		parity = map->pi_paritybufs[row][0]->db_buf.b_addr;
+		memset(parity, 0, UT_DEFAULT_BLOCK_SIZE);
+		for (col = 0; col < map->pi_max_col; ++col) {
+			data = map->pi_databufs[row][col]->db_buf.b_addr;
+			for (i = 0; i < UT_DEFAULT_BLOCK_SIZE; ++i)
+				parity[i] ^= data[i];
+		}
+	}
+	return 0;
+}
+
+static const struct pargrp_iomap_ops ut_fused_iomap_ops = {
+	.pi_parity_recalc = &ut_fused_parity_recalc,
+};
+
+static const struct m0_op_io_ops ut_fused_ioo_ops = {
+	.iro_application_data_copy = &ioreq_application_data_copy,
+	.iro_parity_recalc         = &ioreq_parity_recalc,
+};
+
+/** Launches a write and returns with data and parity of all groups. */
+static void ut_fused_write_launch(struct m0_op_io *ioo, bool fused,
+				  struct m0_bufvec *out)
+{
+	struct m0_sm_group  *op_grp = &ioo->ioo_oo.oo_oc.oc_op.op_sm_group;
+	struct m0_sm_group   grp;
+	struct pargrp_iomap *map;
+	struct m0_client    *instance = dummy_instance;
+	uint32_t             i;
+	uint32_t             row;
+	uint32_t             col;
+	uint32_t             nr = 0;
+
+	/* Clear the pages left by the previous launch. */
+	for (i = 0; i < ioo->ioo_iomap_nr; ++i) {
+		map = ioo->ioo_iomaps[i];
+		for (row = 0; row < map->pi_max_row; ++row) {
+			for (col = 0; col < map->pi_max_col; ++col)
+				memset(map->pi_databufs[row][col]->db_buf.b_addr,
+				       0, UT_DEFAULT_BLOCK_SIZE);
+			memset(map->pi_paritybufs[row][0]->db_buf.b_addr, 0,
+			       UT_DEFAULT_BLOCK_SIZE);
+		}
+	}
+	instance->m0c_config->mc_is_fused_write = fused;
+	m0_sm_group_init(&grp);
+	m0_sm_init(&ioo->ioo_oo.oo_oc.oc_op.op_sm, &m0_op_conf,
+		   M0_OS_INITIALISED, op_grp);
+	m0_sm_init(&ioo->ioo_sm, &io_sm_conf, IRS_INITIALIZED, &grp);
+	m0_sm_group_lock(&grp);
+
+	ioreq_iosm_handle_launch(&grp, &ioo->ioo_ast);
+	M0_UT_ASSERT(ioo->ioo_sm.sm_state == IRS_WRITING);
+	M0_UT_ASSERT(ioo->ioo_oo.oo_oc.oc_op.op_sm.sm_state ==
+		     M0_OS_LAUNCHED);
+	/* Protection info is not generated for this object. */
+	M0_UT_ASSERT(m0_forall(j, ioo->ioo_iomap_nr,
+			       ioo->ioo_iomaps[j]->pi_cksum == NULL));
+
+	for (i = 0; i < ioo->ioo_iomap_nr; ++i) {
+		map = ioo->ioo_iomaps[i];
+		for (row = 0; row < map->pi_max_row; ++row) {
+			for (col = 0; col < map->pi_max_col; ++col)
+				memcpy(out->ov_buf[nr++],
+				       map->pi_databufs[row][col]->db_buf.b_addr,
+				       UT_DEFAULT_BLOCK_SIZE);
+			memcpy(out->ov_buf[nr++],
+			       map->pi_paritybufs[row][0]->db_buf.b_addr,
+			       UT_DEFAULT_BLOCK_SIZE);
+		}
+	}
+	M0_UT_ASSERT(nr == out->ov_vec.v_nr);
+
+	m0_sm_group_lock(ioo->ioo_oo.oo_sm_grp);
+	m0_sm_asts_run(ioo->ioo_oo.oo_sm_grp);
+	m0_sm_group_unlock(ioo->ioo_oo.oo_sm_grp);
+	m0_sm_state_set(&ioo->ioo_sm, IRS_WRITE_COMPLETE);
+	m0_sm_state_set(&ioo->ioo_sm, IRS_REQ_COMPLETE);
+	m0_sm_group_lock(op_grp);
+	m0_sm_move(&ioo->ioo_oo.oo_oc.oc_op.op_sm, -777, M0_OS_FAILED);
+	m0_sm_fini(&ioo->ioo_oo.oo_oc.oc_op.op_sm);
+	m0_sm_group_unlock(op_grp);
+	m0_sm_fini(&ioo->ioo_sm);
+	m0_sm_group_unlock(&grp);
+	m0_sm_group_fini(&grp);
+}
+
+/**
+ * Tests ioreq_fused_write(): a write launched with m0_config::
+ * mc_is_fused_write goes through the same state transitions and produces the
+ * same data and parity pages as the unfused copy and parity passes.
+ */
+static void ut_test_ioreq_fused_write(void)
+{
+	enum { UNIT_NR = 3 * M0T1FS_LAYOUT_N };
+	struct m0_op_io     *ioo;
+	struct m0_client    *instance = dummy_instance;
+	struct m0_realm      realm;
+	struct m0_entity     entity;
+	struct nw_xfer_ops   nxr_ops = {
+		.nxo_dispatch = &ut_mock_handle_launch_dispatch,
+		.nxo_complete = &ut_mock_handle_executed_complete,
+	};
+	struct m0_bufvec     stashed;
+	struct m0_bufvec     unfused;
+	struct m0_bufvec     fused;
+	struct m0_sm_group  *op_grp;
+	bool                 fused_write;
+	uint32_t             pages_nr;
+	int                  rc;
+	int                  i;
+	int                  j;
+
+	fused_write = instance->m0c_config->mc_is_fused_write;
+	ut_realm_entity_setup(&realm, &entity, instance);
+	ioo = ut_dummy_ioo_create(instance, UNIT_NR / M0T1FS_LAYOUT_N);
+	ioo->ioo_obj->ob_attr.oa_bshift = M0_DEFAULT_BUF_SHIFT;
+	ioo->ioo_oo.oo_oc.oc_op.op_entity = &entity;
+	ioo->ioo_oo.oo_oc.oc_op.op_code = M0_OC_WRITE;
+	ioo->ioo_map_idx = ioo->ioo_iomap_nr;
+	ioo->ioo_nwxfer.nxr_ops = &nxr_ops;
+	ioo->ioo_ops = &ut_fused_ioo_ops;
+	op_grp = &ioo->ioo_oo.oo_oc.oc_op.op_sm_group;
+	m0_sm_group_init(op_grp);
+	for (i = 0; i < ioo->ioo_iomap_nr; i++) {
+		ioo->ioo_iomaps[i]->pi_ivec.iv_index[0] =
+				i * M0T1FS_LAYOUT_N * UT_DEFAULT_BLOCK_SIZE;
+		ioo->ioo_iomaps[i]->pi_ops = &ut_fused_iomap_ops;
+		ut_dummy_paritybufs_create(ioo->ioo_iomaps[i], true);
+	}
+	m0_semaphore_init(&cpus_sem, 1);
+
+	/* The ioo is launched in a private group. */
+	m0_sm_group_lock(&instance->m0c_sm_group);
+	m0_sm_fini(&ioo->ioo_sm);
+	m0_sm_group_unlock(&instance->m0c_sm_group);
+
+	/* Application data, distinct in every byte of every block. */
+	stashed = ioo->ioo_data;
+	rc = m0_bufvec_alloc(&ioo->ioo_data, UNIT_NR, UT_DEFAULT_BLOCK_SIZE);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < UNIT_NR; i++) {
+		for (j = 0; j < UT_DEFAULT_BLOCK_SIZE; j++)
+			((char *)ioo->ioo_data.ov_buf[i])[j] = i * 37 + j;
+	}
+	ioo->ioo_ext.iv_index[0] = 0;
+	ioo->ioo_ext.iv_vec.v_count[0] = UNIT_NR * UT_DEFAULT_BLOCK_SIZE;
+
+	pages_nr = ioo->ioo_iomap_nr * (M0T1FS_LAYOUT_N + M0T1FS_LAYOUT_K);
+	rc = m0_bufvec_alloc(&unfused, pages_nr, UT_DEFAULT_BLOCK_SIZE) ?:
+	     m0_bufvec_alloc(&fused, pages_nr, UT_DEFAULT_BLOCK_SIZE);
+	M0_UT_ASSERT(rc == 0);
+
+	ut_fused_write_launch(ioo, false, &unfused);
+	ut_fused_write_launch(ioo, true, &fused);
+	for (i = 0; i < pages_nr; i++)
+		M0_UT_ASSERT(memcmp(unfused.ov_buf[i], fused.ov_buf[i],
+				    UT_DEFAULT_BLOCK_SIZE) == 0);
+	/* The data pages hold the application data. */
+	for (i = 0; i < UNIT_NR; i++)
+		M0_UT_ASSERT(memcmp(fused.ov_buf[i + i / M0T1FS_LAYOUT_N *
+						 M0T1FS_LAYOUT_K],
+				    ioo->ioo_data.ov_buf[i],
+				    UT_DEFAULT_BLOCK_SIZE) == 0);
+
+	instance->m0c_config->mc_is_fused_write = fused_write;
+	m0_bufvec_free(&unfused);
+	m0_bufvec_free(&fused);
+	m0_bufvec_free(&ioo->ioo_data);
+	ioo->ioo_data = stashed;
+	for (i = 0; i < ioo->ioo_iomap_nr; i++)
+		ut_dummy_paritybufs_delete(ioo->ioo_iomaps[i], true);
+	/* ut_dummy_ioo_delete() finalises ioo_sm. */
+	m0_sm_init(&ioo->ioo_sm, &io_sm_conf, IRS_INITIALIZED,
+		   &instance->m0c_sm_group);
+	ut_dummy_ioo_delete(ioo, instance);
+	m0_sm_group_fini(op_grp);
+	m0_entity_fini(&entity);
+}
+
 struct m0_ut_suite ut_suite_io_req = {
 	.ts_name = "io-req-ut",
 	.ts_init = ut_io_req_init,
@@ -1339,6 +1532,8 @@ struct m0_ut_suite ut_suite_io_req = {
 				    &ut_test_ioreq_application_data_copy},
 		{ "ioreq_parity_recalc",
 				    &ut_test_ioreq_parity_recalc},
+		{ "ioreq_fused_write",
+				    &ut_test_ioreq_fused_write},
 		{ "device_check",
 				    &ut_test_device_check},
 		{ "ioreq_dgmode_recover",
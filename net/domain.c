@@ -24,6 +24,7 @@
 #include "lib/trace.h"
 
 #include "lib/assert.h"
+#include "lib/errno.h"                  /* ENOTSUP */
 #include "net/net_internal.h"
 
 /**
@@ -78,6 +79,21 @@ void m0_net_domain_fini(struct m0_net_domain *dom)
 }
 M0_EXPORTED(m0_net_domain_fini);
 
+M0_INTERNAL int m0_net_domain_param_set(struct m0_net_domain *dom,
+					const char           *param)
+{
+	int rc;
+
+	M0_ENTRY("dom=%p param=%s", dom, param);
+	M0_PRE(dom->nd_xprt != NULL);
+	if (dom->nd_xprt->nx_ops->xo_dom_param_set == NULL)
+		return M0_ERR_INFO(-ENOTSUP, "%s", dom->nd_xprt->nx_name);
+	m0_mutex_lock(&dom->nd_mutex);
+	rc = dom->nd_xprt->nx_ops->xo_dom_param_set(dom, param);
+	m0_mutex_unlock(&dom->nd_mutex);
+	return M0_RC(rc);
+}
+
 static void net_domain_fini(struct m0_net_domain *dom)
 {
 	M0_PRE(m0_mutex_is_locked(&m0_net_mutex));
@@ -143,6 +143,14 @@ struct m0_net_xprt_ops {
 	   Only the m0_net_mutex is held across this call.
 	 */
 	void (*xo_dom_fini)(struct m0_net_domain *dom);
+	/**
+	   Sets a transport specific parameter of a domain. The parameter has
+	   the form "name" or "name=value". Transfer machines initialised after
+	   the call use the new value.
+	   Optional, the domain mutex is held across this call.
+	   @see m0_net_domain_param_set()
+	 */
+	int  (*xo_dom_param_set)(struct m0_net_domain *dom, const char *param);
 
 	/**
 	   Performs transport level initialization of the transfer machine.
@@ -439,6 +447,15 @@ int m0_net_domain_init(struct m0_net_domain *dom,
  */
 void m0_net_domain_fini(struct m0_net_domain *dom);
 
+/**
+   Sets a transport specific parameter of a domain, e.g., "zerocopy" for sock
+   transport. See m0_net_xprt_ops::xo_dom_param_set().
+
+   @retval -ENOTSUP the transport has no parameters.
+ */
+M0_INTERNAL int m0_net_domain_param_set(struct m0_net_domain *dom,
+					const char           *param);
+
 /**
    Returns the the maximum buffer size allowed for the domain.
    This includes all segments.
@@ -544,6 +544,55 @@
  * m0_net_buffer::nb_min_receive_size, m0_net_buffer::nb_max_receive_msgs) are
  * not supported.
  *
+ * Zero-copy and busy-polling
+ * --------------------------
+ *
+ * Payload is always moved directly between the socket and the segments of
+ * m0_net_buffer::nb_buffer with vectorised readv(2) and writev(2)
+ * (pk_iov_prep()), there is no intermediate user-space copy. On send, the
+ * kernel still copies the data into socket buffers. If zero-copy is enabled
+ * (m0_net_sock_params::sp_zerocopy), SO_ZEROCOPY is set on stream sockets
+ * and large writes are done with sendmsg(2) and MSG_ZEROCOPY flag, so that
+ * the kernel pins user pages instead of copying them.
+ *
+ * The pages must not be modified or released until the kernel is done with
+ * them, which is reported by notifications on the socket error queue. Each
+ * successful MSG_ZEROCOPY sendmsg() gets a 32-bit identifier, assigned
+ * sequentially by the kernel, and a notification covers a range of such
+ * identifiers. Writers of different buffers interleave on a socket, so the
+ * identifiers of a buffer are not contiguous: sock::s_zc_fifo maps every
+ * outstanding identifier to its buffer. At most SOCK_ZC_MAX sends per socket
+ * are outstanding, further writes are done by copying. A buffer that has
+ * outstanding zero-copy sends is linked into sock::s_zc (buf::b_zc_nr is the
+ * number of outstanding sends). buf_done()
+ * for such a buffer only records the result and the completion event is
+ * delivered by sock_zc_reap(), when the last notification arrives, or by
+ * sock_done(), when the socket is closed.
+ *
+ * Notifications are read from the error queue, which makes epoll(2) report
+ * EPOLLERR. Whether there is also a pending socket error is checked with
+ * poll(2), which, unlike SO_ERROR, does not clear it.
+ *
+ * Packet header (mover::m_pkbuf) is re-used by the next packet, so it is
+ * always sent by copying. All zero-copy sends of a buffer go through the
+ * same socket (buf::b_zc_sock).
+ *
+ * If the kernel reports that it had to copy the data anyway
+ * (SO_EE_CODE_ZEROCOPY_COPIED, which is always the case for loopback),
+ * zero-copy is disabled for the socket, because pinning pages is more
+ * expensive than copying.
+ *
+ * By default, the poller thread blocks in epoll_wait(2). If
+ * m0_net_sock_params::sp_busy_poll is non-zero, after processing a batch of
+ * events the poller keeps polling the epoll instance without blocking for
+ * that long, trading cpu for latency.
+ *
+ * Both parameters are per-domain (dom_param_set()): "zerocopy" and
+ * "busy_poll=<time>" can be passed to m0_net_domain_param_set(), for example,
+ * m0d accepts them with the endpoint: "-e sock,zerocopy,busy_poll=20us:addr".
+ * Defaults for new domains are set by m0_net_sock_params_set() (m0nettestd -z
+ * and -b). net/test/st/st-bulk-zc.sh compares bulk throughput of the modes.
+ *
  * Differences with lnet
  * ---------------------
  *
@@ -609,11 +658,13 @@
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <sys/socket.h>                    /* epoll_create */
+#include <linux/errqueue.h>                /* sock_extended_err */
 #include <netinet/in.h>                    /* INET_ADDRSTRLEN */
 #include <netinet/ip.h>
 #include <arpa/inet.h>                     /* inet_pton, htons */
 #include <string.h>                        /* strchr */
 #include <unistd.h>                        /* close */
+#include <poll.h>                          /* poll */
 
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_NET
 #include "lib/trace.h"
@@ -629,6 +680,7 @@
 #include "lib/bitmap.h"
 #include "lib/refs.h"
 #include "lib/time.h"
+#include "lib/getopts.h"                   /* m0_time_get */
 #include "sm/sm.h"
 #include "motr/magic.h"
 #include "net/net.h"
@@ -638,6 +690,15 @@
 
 #include "net/sock/xcode.h"
 #include "net/sock/xcode_xc.h"
+#include "net/sock/sock.h"
+
+/* Older glibc headers do not define these. */
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY  60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
 
 #define EP_DEBUG (1)
 
@@ -710,7 +771,25 @@ enum sock_flags {
 	/** Non blocking write is possible on the sock. */
 	HAS_WRITE  = M0_BITS(M_WRITE),
 	/** Non-blocking writes are monitored for this sock by epoll(2). */
-	WRITE_POLL = M0_BITS(M_NR + 1)
+	WRITE_POLL = M0_BITS(M_NR + 1),
+	/** SO_ZEROCOPY is set on the socket. */
+	ZEROCOPY   = M0_BITS(M_NR + 2),
+	/** Kernel copied zero-copy data, do not use MSG_ZEROCOPY any more. */
+	ZC_COPIED  = M0_BITS(M_NR + 3)
+};
+
+enum {
+	/**
+	 * Minimal size of a write done with MSG_ZEROCOPY. Page pinning and
+	 * notification processing overhead exceeds copying for smaller writes.
+	 */
+	SOCK_ZC_MIN = 16 * 1024,
+	/**
+	 * Maximal number of outstanding zero-copy sends through a socket, size
+	 * of sock::s_zc_fifo. Must be a power of 2, so that the fifo index
+	 * survives identifier wrap-around.
+	 */
+	SOCK_ZC_MAX = 256
 };
 
 /**
@@ -798,6 +877,8 @@ struct ma {
 	struct m0_tl               t_deathrow;
 	/** List of completed buffers. */
 	struct m0_tl               t_done;
+	/** Parameters copied from the domain when the ma is initialised. */
+	struct m0_net_sock_params  t_params;
 };
 
 /**
@@ -898,8 +979,17 @@ struct buf {
 	struct bdesc          b_peer;
 	/** The other end-point for the transfer. */
 	struct ep            *b_other;
-	/** Linkage in the list of completed buffers (ma::t_done). */
+	/**
+	 * Linkage in the list of completed buffers (ma::t_done) or in the list
+	 * of buffers with outstanding zero-copy sends (sock::s_zc).
+	 */
 	struct m0_tlink       b_linkage;
+	/** Socket through which zero-copy sends of the buffer are done. */
+	struct sock          *b_zc_sock;
+	/** The number of outstanding zero-copy sends. */
+	uint32_t              b_zc_nr;
+	/** buf_done() has been called while zero-copy sends are outstanding. */
+	bool                  b_zc_done;
 	/** Not currently used. */
 	m0_bindex_t           b_offset;
 	/**
@@ -925,6 +1015,18 @@ struct sock {
 	struct m0_tlink s_linkage;
 	/** Not currently used. Will be used to garbage collect idle sockets. */
 	m0_time_t       s_last;
+	/** Buffers with outstanding zero-copy sends through this socket. */
+	struct m0_tl    s_zc;
+	/**
+	 * Buffers of outstanding zero-copy sends: the send with identifier id
+	 * is in s_zc_fifo[id % SOCK_ZC_MAX], NULL once it is acknowledged.
+	 * Allocated when SO_ZEROCOPY is set.
+	 */
+	struct buf    **s_zc_fifo;
+	/** Identifier of the oldest not acknowledged zero-copy send. */
+	uint32_t        s_zc_tail;
+	/** Identifier the kernel assigns to the next zero-copy send. */
+	uint32_t        s_zc_next;
 };
 
 /**
@@ -1007,6 +1109,7 @@ M0_TL_DEFINE(b, static, struct buf);
 
 static int  dom_init(const struct m0_net_xprt *xprt, struct m0_net_domain *dom);
 static void dom_fini(struct m0_net_domain *dom);
+static int  dom_param_set(struct m0_net_domain *dom, const char *param);
 static int  ma_init(struct m0_net_transfer_mc *ma);
 static int  ma_confine(struct m0_net_transfer_mc *ma,
 		       const struct m0_bitmap *processors);
@@ -1078,6 +1181,13 @@ static int  sock_init_fd(int fd, struct sock *s, struct ep *ep, uint32_t flags);
 static int  sock_init(int fd, struct ep *src, struct ep *tgt, uint32_t flags);
 static struct mover *sock_writer(struct sock *s);
 static bool sock_invariant(const struct sock *s);
+static bool sock_zc_use (const struct sock *s, const struct buf *buf,
+			 int count);
+static int  sock_zc_send(struct mover *m, struct sock *s,
+			 struct iovec *iv, int nr);
+static void sock_zc_reap(struct sock *s);
+static void sock_zc_ack (struct sock *s, uint32_t lo, uint32_t hi);
+static void buf_zc_release(struct buf *buf);
 
 static struct ma *buf_ma(struct buf *buf);
 static bool buf_invariant(const struct buf *buf);
@@ -1328,7 +1438,15 @@ static bool mover_invariant(const struct mover *m)
 /** Used as m0_net_xprt_ops::xo_dom_init(). */
 static int dom_init(const struct m0_net_xprt *xprt, struct m0_net_domain *dom)
 {
+	struct m0_net_sock_params *p;
+
 	M0_ENTRY();
+	M0_ALLOC_PTR(p);
+	if (p == NULL)
+		return M0_ERR(-ENOMEM);
+	/* Start with the process-wide defaults. */
+	m0_net_sock_params_get(p);
+	dom->nd_xprt_private = p;
 	return M0_RC(0);
 }
 
@@ -1336,9 +1454,49 @@ static int dom_init(const struct m0_net_xprt *xprt, struct m0_net_domain *dom)
 static void dom_fini(struct m0_net_domain *dom)
 {
 	M0_ENTRY();
+	m0_free(dom->nd_xprt_private);
+	dom->nd_xprt_private = NULL;
 	M0_LEAVE();
 }
 
+/**
+ * Used as m0_net_xprt_ops::xo_dom_param_set().
+ *
+ * Supported parameters:
+ *
+ *     - "zerocopy" or "zerocopy=<0|1>": m0_net_sock_params::sp_zerocopy;
+ *
+ *     - "busy_poll=<time>" (in m0_time_get() format, e.g., "20us"):
+ *       m0_net_sock_params::sp_busy_poll.
+ */
+static int dom_param_set(struct m0_net_domain *dom, const char *param)
+{
+	struct m0_net_sock_params *p = dom->nd_xprt_private;
+	const char                *val = strchr(param, '=');
+	size_t                     len = val != NULL ? val - param :
+					 strlen(param);
+	m0_time_t                  busy;
+	int                        result;
+
+	M0_ENTRY("%s", param);
+	if (len == strlen("zerocopy") && strncmp(param, "zerocopy", len) == 0) {
+		if (val == NULL || m0_streq(val, "=1"))
+			p->sp_zerocopy = true;
+		else if (m0_streq(val, "=0"))
+			p->sp_zerocopy = false;
+		else
+			return M0_ERR_INFO(-EINVAL, "%s", param);
+		result = 0;
+	} else if (len == strlen("busy_poll") &&
+		   strncmp(param, "busy_poll", len) == 0 && val != NULL) {
+		result = m0_time_get(val + 1, &busy);
+		if (result == 0)
+			p->sp_busy_poll = busy;
+	} else
+		result = M0_ERR_INFO(-ENOENT, "Unknown parameter: %s", param);
+	return M0_RC(result);
+}
+
 static void ma_lock(struct ma *ma)
 {
 	m0_mutex_lock(&ma->t_ma->ntm_mutex);
@@ -1361,6 +1519,8 @@ static void poller(struct ma *ma)
 {
 	enum { EV_NR = 256 };
 	struct epoll_event ev[EV_NR] = {};
+	m0_time_t          busy = ma->t_params.sp_busy_poll;
+	m0_time_t          spin = 0;
 	int                nr;
 	int                i;
 	/*
@@ -1382,12 +1542,23 @@ static void poller(struct ma *ma)
 	while (1) {
 		if (ma->t_shutdown)
 			break;
-		nr = epoll_wait(ma->t_epollfd, ev, ARRAY_SIZE(ev), 1000);
+		/*
+		 * When busy-polling, do not block until "spin" deadline, set
+		 * after the last batch of events, expires.
+		 */
+		nr = epoll_wait(ma->t_epollfd, ev, ARRAY_SIZE(ev),
+				busy != 0 && m0_time_now() < spin ? 0 : 1000);
 		if (nr == -1) {
 			M0_LOG(M0_DEBUG, "epoll: %i.", -errno);
 			M0_ASSERT(errno == EINTR);
 			continue;
 		}
+		if (busy != 0) {
+			if (nr > 0)
+				spin = m0_time_add(m0_time_now(), busy);
+			else if (m0_time_now() < spin)
+				continue;
+		}
 		/* Check again because epoll() may block for some time */
 		if (ma->t_shutdown)
 			break;
@@ -1457,6 +1628,8 @@ static int ma_init(struct m0_net_transfer_mc *net)
 		ma->t_ma = net;
 		s_tlist_init(&ma->t_deathrow);
 		b_tlist_init(&ma->t_done);
+		ma->t_params = *(struct m0_net_sock_params *)
+			net->ntm_dom->nd_xprt_private;
 		result = 0;
 	} else
 		result = M0_ERR(-ENOMEM);
@@ -2022,6 +2195,8 @@ static void sock_fini(struct sock *s)
 	TLOG(SOCK_F, SOCK_P(s));
 	EP_PUT(s->s_ep, sock);
 	s->s_ep = NULL;
+	b_tlist_fini(&s->s_zc);
+	m0_free(s->s_zc_fifo);
 	m0_sm_fini(&s->s_sm);
 	s_tlink_del_fini(s);
 	m0_free(s);
@@ -2047,15 +2222,41 @@ static void sock_done(struct sock *s, bool balance)
 	if (s->s_fd > 0)
 		sock_close(s);
 	if (s->s_sm.sm_state != S_DELETED) { /* sock_close() might finalise. */
+		struct buf *buf;
+
 		mover_fini(&s->s_reader);
 		M0_ASSERT(sock_writer(s) == NULL);
 		if (s->s_fd > 0) {
 			int result = sock_ctl(s, EPOLL_CTL_DEL, 0);
 			M0_ASSERT(ergo(result != 0, errno == ENOENT));
+			if (!b_tlist_is_empty(&s->s_zc)) {
+				/*
+				 * Drop unsent data, so that the kernel
+				 * releases pages of the buffers completed
+				 * below.
+				 */
+				struct linger l = { .l_onoff = 1 };
+
+				(void)setsockopt(s->s_fd, SOL_SOCKET, SO_LINGER,
+						 &l, sizeof l);
+			}
 			shutdown(s->s_fd, SHUT_RDWR);
 			close(s->s_fd);
 			s->s_fd = -1;
 		}
+		/* No more notifications will arrive. */
+		m0_tl_for(b, &s->s_zc, buf) {
+			/*
+			 * Unsent data were dropped by SO_LINGER above, the
+			 * peer might not have received the buffer.
+			 */
+			if (buf->b_writer.m_sm.sm_rc == 0)
+				buf->b_writer.m_sm.sm_rc = M0_ERR(-ECONNABORTED);
+			buf->b_zc_nr = 0;
+			buf_zc_release(buf);
+		} m0_tl_endfor;
+		for (; s->s_zc_tail != s->s_zc_next; ++s->s_zc_tail)
+			s->s_zc_fifo[s->s_zc_tail % SOCK_ZC_MAX] = NULL;
 		m0_sm_state_set(&s->s_sm, S_DELETED);
 		s_tlist_move(&ma->t_deathrow, s);
 		if (balance)
@@ -2098,6 +2299,7 @@ static int sock_init(int fd, struct ep *src, struct ep *tgt, uint32_t flags)
 	s->s_ep = ep;
 	EP_GET(ep, sock);
 	s_tlink_init_at(s, &ep->e_sock);
+	b_tlist_init(&s->s_zc);
 	m0_sm_init(&s->s_sm, &sock_conf, state, &ma->t_ma->ntm_group);
 	mover_init(&s->s_reader, ma, stype[ep->e_a.a_socktype].st_reader);
 	s->s_reader.m_sock = s;
@@ -2185,6 +2387,21 @@ static int sock_init_fd(int fd, struct sock *s, struct ep *ep, uint32_t flags)
 	}
 	if (fd >= 0 && result == 0) {
 		s->s_fd = fd;
+		if (!(flags & EPOLLET) && ep->e_a.a_socktype == SOCK_STREAM &&
+		    ep_ma(ep)->t_params.sp_zerocopy) {
+			int flag = true;
+
+			/* Not fatal: older kernels do not support zero-copy. */
+			M0_ALLOC_ARR(s->s_zc_fifo, SOCK_ZC_MAX);
+			if (s->s_zc_fifo != NULL &&
+			    setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY,
+				       &flag, sizeof flag) == 0)
+				s->s_flags |= ZEROCOPY;
+			else {
+				M0_LOG(M0_DEBUG, "SO_ZEROCOPY: %i.", -errno);
+				m0_free0(&s->s_zc_fifo);
+			}
+		}
 		result = sock_ctl(s, EPOLL_CTL_ADD, flags & ~EPOLLET);
 	}
 	if (result != 0 || fd < 0)
@@ -2282,6 +2499,19 @@ static bool sock_event(struct sock *s, uint32_t ev)
 		}
 		break;
 	case S_OPEN:
+		if ((s->s_flags & ZEROCOPY) && (ev & EPOLLERR)) {
+			struct pollfd pfd = { .fd = s->s_fd };
+
+			/*
+			 * Zero-copy notifications are delivered as errors.
+			 * Once they are drained, POLLERR means a socket error,
+			 * which is left pending for sock_close().
+			 */
+			sock_zc_reap(s);
+			if (poll(&pfd, 1, 0) == 0 ||
+			    (pfd.revents & POLLERR) == 0)
+				ev &= ~EPOLLERR;
+		}
 		if (ev & EPOLLIN) {
 			/* Ran out of buffer on the receive queue. */
 			if (sock_in(s) == -ENOBUFS)
@@ -2892,6 +3122,9 @@ static void buf_fini(struct buf *buf)
 		buf->b_other = NULL;
 	}
 	M0_SET0(&buf->b_peer);
+	M0_ASSERT(buf->b_zc_nr == 0);
+	buf->b_zc_sock = NULL;
+	buf->b_zc_done = false;
 	buf->b_offset = 0;
 	buf->b_length = 0;
 	buf->b_writer.m_sm.sm_rc = 0;
@@ -2908,6 +3141,11 @@ static void buf_done(struct buf *buf, int rc)
 	       buf->b_buf != NULL ? buf->b_buf->nb_length : -1, rc); */
 	if (buf->b_writer.m_sm.sm_rc == 0) /* Reuse this field for result. */
 		buf->b_writer.m_sm.sm_rc = rc;
+	if (buf->b_zc_nr > 0) {
+		/* Completed by buf_zc_release(). */
+		buf->b_zc_done = true;
+		return;
+	}
 	/*
 	 * Multiple buf_done() calls on the same buffer are possible if the
 	 * buffer is cancelled.
@@ -3233,7 +3471,10 @@ static int pk_io(struct mover *m, struct sock *s, uint64_t flag,
 			 bv ?: m->m_buf != NULL ?
 			 &m->m_buf->b_buf->nb_buffer : NULL, tgt, &count);
 	s->s_flags &= ~flag;
-	rc = (flag == HAS_READ ? readv : writev)(s->s_fd, iv, nr);
+	if (flag == HAS_WRITE && sock_zc_use(s, m->m_buf, count))
+		rc = sock_zc_send(m, s, iv, nr);
+	else
+		rc = (flag == HAS_READ ? readv : writev)(s->s_fd, iv, nr);
 	M0_LOG(M0_DEBUG, "flag: %" PRIi64 ", rc: %i, idx: %i, errno: %i.",
 	       flag, rc, nr, errno);
 	if (rc >= 0) {
@@ -3258,6 +3499,148 @@ static int pk_io(struct mover *m, struct sock *s, uint64_t flag,
 	return rc;
 }
 
+/** Returns true iff a write of "count" bytes should be zero-copy. */
+static bool sock_zc_use(const struct sock *s, const struct buf *buf, int count)
+{
+	return (s->s_flags & (ZEROCOPY|ZC_COPIED)) == ZEROCOPY &&
+		count >= SOCK_ZC_MIN && buf != NULL &&
+		(buf->b_zc_nr == 0 || buf->b_zc_sock == s) &&
+		s->s_zc_next - s->s_zc_tail < SOCK_ZC_MAX;
+}
+
+/**
+ * Writes the packet with MSG_ZEROCOPY.
+ *
+ * Returns the same as writev(2) would: the number of bytes written or -1 with
+ * errno set.
+ */
+static int sock_zc_send(struct mover *m, struct sock *s,
+			struct iovec *iv, int nr)
+{
+	struct buf   *buf = m->m_buf;
+	struct msghdr msg = { .msg_iov = iv, .msg_iovlen = nr };
+	int           hdr = 0;
+	int           rc;
+
+	if (m->m_nob < sizeof m->m_pkbuf) {
+		/*
+		 * Header is in m->m_pkbuf, which is overwritten by the next
+		 * packet while the kernel may still use the pages. Copy it.
+		 */
+		hdr = send(s->s_fd, iv[0].iov_base, iv[0].iov_len, MSG_MORE);
+		if (hdr != (int)iv[0].iov_len || nr == 1)
+			return hdr;
+		msg.msg_iov++;
+		msg.msg_iovlen--;
+	}
+	rc = sendmsg(s->s_fd, &msg, MSG_ZEROCOPY);
+	if (rc < 0 && errno == ENOBUFS) {
+		/* Socket option memory limit for notifications is reached. */
+		rc = sendmsg(s->s_fd, &msg, 0);
+	} else if (rc > 0) {
+		/* The kernel assigned the next identifier to this send. */
+		if (buf->b_zc_nr++ == 0) {
+			buf->b_zc_sock = s;
+			b_tlist_add_tail(&s->s_zc, buf);
+		}
+		M0_ASSERT(buf->b_zc_sock == s);
+		M0_ASSERT(s->s_zc_fifo[s->s_zc_next % SOCK_ZC_MAX] == NULL);
+		s->s_zc_fifo[s->s_zc_next++ % SOCK_ZC_MAX] = buf;
+	}
+	/* Report the copied header even if the payload was not written. */
+	return rc >= 0 ? hdr + rc : hdr ?: rc;
+}
+
+/** Drains zero-copy notifications from the socket error queue. */
+static void sock_zc_reap(struct sock *s)
+{
+	struct sock_extended_err *ee;
+	char                      cbuf[CMSG_SPACE(sizeof *ee)];
+	struct msghdr             msg;
+	struct cmsghdr           *cm;
+
+	while (1) {
+		msg = (struct msghdr) {
+			.msg_control    = cbuf,
+			.msg_controllen = sizeof cbuf
+		};
+		if (recvmsg(s->s_fd, &msg, MSG_ERRQUEUE) < 0) {
+			if (errno != EAGAIN && errno != EINTR)
+				M0_LOG(M0_ERROR, "errqueue: %i.", -errno);
+			break;
+		}
+		for (cm = CMSG_FIRSTHDR(&msg); cm != NULL;
+		     cm = CMSG_NXTHDR(&msg, cm)) {
+			if (!((cm->cmsg_level == SOL_IP &&
+			       cm->cmsg_type == IP_RECVERR) ||
+			      (cm->cmsg_level == SOL_IPV6 &&
+			       cm->cmsg_type == IPV6_RECVERR)))
+				continue;
+			ee = (void *)CMSG_DATA(cm);
+			if (ee->ee_origin != SO_EE_ORIGIN_ZEROCOPY ||
+			    ee->ee_errno != 0) {
+				M0_LOG(M0_ERROR, "Unexpected: %i/%i.",
+				       ee->ee_origin, ee->ee_errno);
+				continue;
+			}
+			if (ee->ee_code & SO_EE_CODE_ZEROCOPY_COPIED &&
+			    !(s->s_flags & ZC_COPIED)) {
+				M0_LOG(M0_DEBUG, "Zero-copy copied.");
+				s->s_flags |= ZC_COPIED;
+			}
+			/* ee_info..ee_data is an inclusive range. */
+			sock_zc_ack(s, ee->ee_info, ee->ee_data);
+		}
+	}
+}
+
+/**
+ * Accounts completed zero-copy sends with identifiers in [lo, hi] range.
+ *
+ * Identifiers wrap around, compare them relative to sock::s_zc_tail.
+ * Notifications can arrive out of order, the tail only advances over
+ * acknowledged sends.
+ */
+static void sock_zc_ack(struct sock *s, uint32_t lo, uint32_t hi)
+{
+	struct buf **slot;
+	struct buf  *buf;
+	int32_t      from = max32(lo - s->s_zc_tail, 0);
+	int32_t      to   = min32(hi - s->s_zc_tail,
+				  s->s_zc_next - s->s_zc_tail - 1);
+
+	for (; from <= to; ++from) {
+		slot = &s->s_zc_fifo[(s->s_zc_tail + from) % SOCK_ZC_MAX];
+		buf  = *slot;
+		if (buf == NULL) /* Already acknowledged. */
+			continue;
+		*slot = NULL;
+		M0_ASSERT(buf->b_zc_sock == s && buf->b_zc_nr > 0);
+		if (--buf->b_zc_nr == 0)
+			buf_zc_release(buf);
+	}
+	while (s->s_zc_tail != s->s_zc_next &&
+	       s->s_zc_fifo[s->s_zc_tail % SOCK_ZC_MAX] == NULL)
+		++s->s_zc_tail;
+}
+
+/**
+ * Called when the kernel no longer uses the buffer pages.
+ *
+ * Completes the buffer if buf_done() was called in the meantime. Completion is
+ * delivered through ma::t_done, because sock_done() iterates over sock::s_zc.
+ */
+static void buf_zc_release(struct buf *buf)
+{
+	M0_PRE(buf->b_zc_nr == 0);
+	b_tlist_del(buf);
+	buf->b_zc_sock = NULL;
+	if (buf->b_zc_done) {
+		buf->b_zc_done = false;
+		b_tlist_add_tail(&buf_ma(buf)->t_done, buf);
+	}
+}
+
 /** Initialises the header for the current packet in a writer. */
 static void pk_header_init(struct mover *m, struct sock *s)
 {
@@ -3889,6 +4272,7 @@ static const struct m0_format_tag get_tag = {
 static const struct m0_net_xprt_ops xprt_ops = {
 	.xo_dom_init                    = &dom_init,
 	.xo_dom_fini                    = &dom_fini,
+	.xo_dom_param_set               = &dom_param_set,
 	.xo_tm_init                     = &ma_init,
 	.xo_tm_confine                  = &ma_confine,
 	.xo_tm_start                    = &ma_start,
@@ -3963,6 +4347,19 @@ M0_INTERNAL void m0_net_sock_mod_fini(void)
 		m0_net_xprt_deregister(&m0_net_sock_xprt);
 }
 
+/** Default parameters of new domains, see dom_init(). */
+static struct m0_net_sock_params sock_params = {};
+
+M0_INTERNAL void m0_net_sock_params_set(const struct m0_net_sock_params *p)
+{
+	sock_params = *p;
+}
+
+M0_INTERNAL void m0_net_sock_params_get(struct m0_net_sock_params *p)
+{
+	*p = sock_params;
+}
+
 M0_INTERNAL void mover__print(const struct mover *m)
 {
 	printf("\t%p: %s sock: %p state: %i buf: %p\n", m,
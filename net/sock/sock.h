@@ -26,6 +26,9 @@
 #define __MOTR_NET_SOCK_SOCK_H__
 
 #ifndef __KERNEL__
+#include "lib/types.h"
+#include "lib/time.h"                      /* m0_time_t */
+
 extern const struct m0_net_xprt m0_net_sock_xprt;
 #endif
 /**
@@ -34,6 +37,29 @@ extern const struct m0_net_xprt m0_net_sock_xprt;
  * @{
  */
 
+#ifndef __KERNEL__
+/** Tunables of sock transport. */
+struct m0_net_sock_params {
+	/** Use MSG_ZEROCOPY for large writes to stream sockets. */
+	bool      sp_zerocopy;
+	/**
+	 * If non-zero, the poller thread keeps polling without blocking for
+	 * this long after it processed a batch of events.
+	 */
+	m0_time_t sp_busy_poll;
+};
+
+/**
+ * Sets the default parameters for domains initialised after this call.
+ *
+ * Parameters of a particular domain can be changed with
+ * m0_net_domain_param_set(). Transfer machines that are already initialised
+ * are not affected.
+ */
+M0_INTERNAL void m0_net_sock_params_set(const struct m0_net_sock_params *p);
+M0_INTERNAL void m0_net_sock_params_get(struct m0_net_sock_params *p);
+#endif
+
 
 /** @} end of netsock group */
 #endif /* __MOTR_NET_SOCK_SOCK_H__ */
@@ -55,7 +55,8 @@ node_start_addr()
 		mkdir -p $dir
 		pushd $dir > /dev/null
 		DIR_COUNTER=$(($DIR_COUNTER + 1))
-		"$CMD_M0NETTESTD" -a "$addr" -c "$addr_console" &
+		"$CMD_M0NETTESTD" -a "$addr" -c "$addr_console" \
+				  $M0NETTESTD_OPTS &
 		popd > /dev/null
 		eval PID_"${pid_role}"=$!
 	fi
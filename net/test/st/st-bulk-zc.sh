@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+#
+# Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# For any questions about this software or licensing,
+# please email opensource@seagate.com or cortx-questions@seagate.com.
+#
+
+# Compares sock transport bulk throughput with copying and zero-copy sends
+# (m0nettestd -z), optionally with poller busy-polling (m0nettestd -b).
+#
+# Usage: st-bulk-zc.sh [busy-poll-usec]
+#
+# Note that over loopback the kernel always copies the data, so the
+# comparison is only meaningful between different hosts (LNET_IF in
+# st-config.sh).
+
+CWD=$(cd "$( dirname "$0")" && pwd)
+BUSY_POLL=${1:-}
+
+for opts in "" "-z" ${BUSY_POLL:+"-z -b $BUSY_POLL"}; do
+	echo "--- bulk test, m0nettestd options: '$opts'"
+	M0NETTESTD_OPTS="$opts" "$CWD"/st-bulk.sh
+done
@@ -34,6 +34,7 @@
 #include "net/test/user_space/common_u.h" /* m0_net_test_u_str_copy */
 #include "net/test/node.h"
 #include "net/test/initfini.h"		/* m0_net_test_init */
+#include "net/sock/sock.h"			/* m0_net_sock_params */
 
 /**
    @page net-test-fspec-cli-node-user Test node command line pamameters
@@ -45,6 +46,8 @@
 
 	 -a     string: Test node commands endpoint
 	 -c     string: Test console commands endpoint
+	 -z           : Use zero-copy send (sock transport)
+	 -b     number: Busy-poll time in microseconds (sock transport)
 	 -v           : Verbose output
 	 -l           : List available LNET interfaces
 	 -?           : display this help and exit
@@ -82,8 +85,10 @@ static void config_print(struct m0_net_test_node_cfg *cfg)
 
 static int configure(int argc, char *argv[], struct m0_net_test_node_cfg *cfg)
 {
-	bool list_if = false;
+	struct m0_net_sock_params sp;
+	bool                      list_if = false;
 
+	m0_net_sock_params_get(&sp);
 	M0_GETOPTS("m0nettestd", argc, argv,
 		M0_STRINGARG('a', "Test node commands endpoint",
 		LAMBDA(void, (const char *addr) {
@@ -93,10 +98,19 @@ static int configure(int argc, char *argv[], struct m0_net_test_node_cfg *cfg)
 		LAMBDA(void, (const char *addr) {
 			cfg->ntnc_addr_console = m0_net_test_u_str_copy(addr);
 		})),
+		M0_FLAGARG('z', "Use zero-copy send (sock transport)",
+			   &sp.sp_zerocopy),
+		M0_NUMBERARG('b', "Busy-poll time in microseconds "
+			     "(sock transport)",
+		LAMBDA(void, (int64_t usec) {
+			sp.sp_busy_poll = M0_MKTIME(0, usec * 1000);
+		})),
 		M0_VERBOSEFLAGARG,
 		M0_IFLISTARG(&list_if),
 		M0_HELPARG('?'),
 		);
+	/* Picked up by the transfer machines created by the test node. */
+	m0_net_sock_params_set(&sp);
 	if (!list_if)
 		config_print(cfg);
 	return list_if ? 1 : config_check(cfg) ? 0 : -1;
@@ -35,6 +35,7 @@
 #include "conf/pvers.h"    /* m0_conf_pver_find_by_fid */
 #include "conf/cache.h"    /* m0_conf_cache_contains */
 #include "conf/helpers.h"  /* m0_confc_root_open() */
+#include "lib/cksum.h"      /* M0_CKSUM_DEFAULT_PI */
 #include "reqh/reqh_service.h" /* m0_reqh_service_ctx */
 #include "reqh/reqh.h"
 #include "rpc/rpc_machine.h"    /* m0_rpc_machine_ep */
@@ -547,6 +548,7 @@ M0_INTERNAL int m0_pool_version_init(struct m0_pool_version *pv,
 	pool_version_tlink_init(pv);
 	pv->pv_is_dirty = false;
 	pv->pv_is_stale = false;
+	pv->pv_pi_type = M0_CKSUM_DEFAULT_PI;
 
 	M0_POST(pool_version_invariant(pv));
 	return M0_RC(rc);
@@ -142,6 +142,13 @@ struct m0_pool_version {
 
 	uint32_t                     pv_sns_flags;
 
+	/**
+	 * Protection info type (enum m0_pi_algo_type) used when motr
+	 * generates data integrity checksums for objects of this pool version.
+	 * Initialised to M0_CKSUM_DEFAULT_PI.
+	 */
+	uint8_t                      pv_pi_type;
+
 	/**
 	 * Linkage into list of pool versions.
 	 * @see struct m0_pool::po_vers
@@ -38,6 +38,7 @@
 #include "rpc/link.h"    /* m0_rpc_link */
 #include "sm/sm.h"
 #include "fop/wire.h"
+#include "fop/fom.h"     /* m0_fom_prio */
 
 struct m0_fop;
 struct m0_fom;
@@ -472,6 +473,17 @@ struct m0_reqh_service_type {
 	 * @see m0_conf_service::cs_type
 	 */
 	enum m0_conf_service_type              rst_typecode;
+	/**
+	 * Scheduling class of foms of this service type. The default
+	 * (M0_FOM_PRIO_IO) is the highest priority class.
+	 */
+	enum m0_fom_prio                       rst_fom_prio;
+	/**
+	 * The longest time a fom of this service type waits in a locality
+	 * run-queue before it is executed ahead of higher priority classes.
+	 * 0 means the default deadline of the rst_fom_prio class.
+	 */
+	m0_time_t                              rst_fom_deadline;
 
 	/**
 	    Linkage into global service types list.
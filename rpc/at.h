@@ -30,7 +30,7 @@
 #include "lib/buf_xc.h"           /* m0_buf_xc */
 #include "net/net_otw_types.h"    /* m0_net_buf_desc_data */
 #include "net/net_otw_types_xc.h" /* m0_net_buf_desc_data */
-#include "xcode/xcode_attr.h"
+#include "xcode/xcode.h"          /* m0_void_t */
 #include "lib/assert.h"           /* M0_BASSERT */
 
 
@@ -250,6 +250,10 @@ struct m0_rpc_at_buf {
 	/** Value from enum m0_rpc_at_type. */
 	uint32_t ab_type;
 	union {
+		/** No buffer, only the type is sent. */
+		m0_void_t                   ab_empty
+			M0_XCA_TAG("M0_RPC_AT_EMPTY");
+
 		struct m0_buf               ab_buf
 			M0_XCA_TAG("M0_RPC_AT_INLINE");
 
@@ -440,6 +440,7 @@ static int __conn_init(struct m0_rpc_conn      *conn,
 	rpc_session_tlist_init(&conn->c_sessions);
 	item_source_tlist_init(&conn->c_item_sources);
 	rpc_conn_tlink_init(conn);
+	rpc_conn_hash_tlink_init(conn);
 
 	rc = session_zero_attach(conn);
 	if (rc != 0) {
@@ -462,7 +463,7 @@ M0_INTERNAL void m0_rpc_conn_reset(struct m0_rpc_conn *conn)
 	conn_state_set(conn, M0_RPC_CONN_INITIALISED);
 	session0 = m0_rpc_conn_session0(conn);
 	session0->s_xid = 0;
-	conn->c_sender_id = SENDER_ID_INVALID;
+	m0_rpc_machine_conn_id_set(conn, SENDER_ID_INVALID);
 	M0_POST(m0_rpc_conn_invariant(conn));
 	m0_rpc_machine_unlock(machine);
 }
@@ -515,6 +516,7 @@ static void __conn_fini(struct m0_rpc_conn *conn)
 
 	rpc_session_tlist_fini(&conn->c_sessions);
 	item_source_tlist_fini(&conn->c_item_sources);
+	rpc_conn_hash_tlink_fini(conn);
 	rpc_conn_tlink_fini(conn);
 	m0_clink_fini(&conn->c_ha_clink);
 	m0_clink_fini(&conn->c_conf_exp_clink);
@@ -666,7 +668,7 @@ M0_INTERNAL void m0_rpc_conn_fini_locked(struct m0_rpc_conn *conn)
 					M0_RPC_CONN_FAILED,
 					M0_RPC_CONN_INITIALISED)));
 
-	rpc_conn_tlist_del(conn);
+	m0_rpc_machine_del_conn(conn->c_rpc_machine, conn);
 	M0_LOG(M0_DEBUG, "rpcmach %p conn %p deleted from %s list",
 		conn->c_rpc_machine, conn,
 		(conn->c_flags & RCF_SENDER_END) ? "outgoing" : "incoming");
@@ -955,7 +957,8 @@ M0_INTERNAL void m0_rpc_conn_establish_reply_received(struct m0_rpc_item *item)
 	if (rc == 0) {
 		M0_ASSERT(reply != NULL);
 		if (reply->rcer_sender_id != SENDER_ID_INVALID) {
-			conn->c_sender_id = reply->rcer_sender_id;
+			m0_rpc_machine_conn_id_set(conn,
+						   reply->rcer_sender_id);
 			conn_state_set(conn, M0_RPC_CONN_ACTIVE);
 		} else
 			rc = M0_ERR(-EPROTO);
@@ -26,6 +26,7 @@
 #define __MOTR_RPC_CONN_H__
 
 #include "lib/tlist.h"
+#include "lib/hash.h"          /* m0_hlink */
 #include "lib/time.h"          /* m0_time_t */
 #include "sm/sm.h"
 #include "rpc/onwire.h"        /* m0_rpc_sender_uuid */
@@ -297,6 +298,13 @@ struct m0_rpc_conn {
 	 */
 	struct m0_tlink            c_link;
 
+	/**
+	   Link in m0_rpc_machine::rm_incoming_ids or
+	   m0_rpc_machine::rm_outgoing_ids, while c_sender_id is valid.
+	   Hash descriptor: rpc_conn_hash
+	 */
+	struct m0_hlink            c_hlink;
+
 	/** Counts number of sessions (excluding session 0) */
 	uint64_t                   c_nr_sessions;
 
@@ -36,6 +36,8 @@
  * @{
  */
 static bool itemq_invariant(const struct m0_tl *q);
+static bool itemq_tail_invariant(const struct m0_rpc_frm *frm,
+				 enum m0_rpc_frm_itemq_type qtype);
 static m0_bcount_t itemq_nr_bytes_acc(const struct m0_tl *q);
 
 static enum m0_rpc_frm_itemq_type
@@ -43,8 +45,10 @@ frm_which_qtype(struct m0_rpc_frm *frm, const struct m0_rpc_item *item);
 static bool frm_is_idle(const struct m0_rpc_frm *frm);
 static void frm_insert(struct m0_rpc_frm *frm, struct m0_rpc_item *item);
 static void frm_remove(struct m0_rpc_frm *frm, struct m0_rpc_item *item);
-static void __itemq_insert(struct m0_tl *q, struct m0_rpc_item *new_item);
-static void __itemq_remove(struct m0_rpc_item *item);
+static void __itemq_insert(struct m0_rpc_frm *frm,
+			   enum m0_rpc_frm_itemq_type qtype,
+			   struct m0_rpc_item *new_item);
+static void __itemq_remove(struct m0_rpc_frm *frm, struct m0_rpc_item *item);
 static void frm_balance(struct m0_rpc_frm *frm);
 static bool frm_is_ready(const struct m0_rpc_frm *frm);
 static void frm_fill_packet(struct m0_rpc_frm *frm, struct m0_rpc_packet *p);
@@ -73,6 +77,15 @@ static void drop_all_items(struct m0_rpc_frm *frm);
 static bool
 constraints_are_valid(const struct m0_rpc_frm_constraints *constraints);
 
+enum {
+	/**
+	   Number of items frm_fill_packet() skips because they don't fit
+	   into the remaining packet space, before it gives up on the queues.
+	   See FRM_FILL_PACKET_NOTE_1.
+	 */
+	FRM_FILL_PACKET_SKIP_MAX = 16,
+};
+
 static const char *str_qtype[] = {
 	[FRMQ_URGENT]   = "URGENT",
 	[FRMQ_WAITING]  = "WAITING",
@@ -110,7 +123,8 @@ static bool frm_invariant(const struct m0_rpc_frm *frm)
 
 				  nr_items     += itemq_tlist_length(q);
 				  nr_bytes_acc += itemq_nr_bytes_acc(q);
-				  itemq_invariant(q); })) &&
+				  itemq_invariant(q) &&
+				  itemq_tail_invariant(frm, i); })) &&
 		frm->f_nr_items == nr_items &&
 		frm->f_nr_bytes_accumulated == nr_bytes_acc;
 }
@@ -126,6 +140,23 @@ static bool itemq_invariant(const struct m0_tl *q)
 				}));
 }
 
+static bool itemq_tail_invariant(const struct m0_rpc_frm *frm,
+				 enum m0_rpc_frm_itemq_type qtype)
+{
+	const struct m0_tl *q = &frm->f_itemq[qtype];
+
+	return m0_forall(prio, M0_RPC_ITEM_PRIO_NR, ({
+			const struct m0_rpc_item *tail =
+				frm->f_itemq_tail[qtype][prio];
+			const struct m0_rpc_item *next;
+
+			tail == NULL ?
+			m0_tl_forall(itemq, item, q, item->ri_prio != prio) :
+			(tail->ri_itemq == q && tail->ri_prio == prio &&
+			 ((next = itemq_tlist_next(q, tail)) == NULL ||
+			  next->ri_prio != prio)); }));
+}
+
 /**
    Defines total order of rpc items in itemq.
  */
@@ -212,6 +243,7 @@ M0_INTERNAL void m0_rpc_frm_init(struct m0_rpc_frm *frm,
 
 	for_each_itemq_in_frm(q, frm)
 		itemq_tlist_init(q);
+	M0_SET0(&frm->f_itemq_tail);
 
 	frm->f_state = FRM_IDLE;
 
@@ -273,7 +305,6 @@ M0_INTERNAL void m0_rpc_frm_enq_item(struct m0_rpc_frm *frm,
 static void frm_insert(struct m0_rpc_frm *frm, struct m0_rpc_item *item)
 {
 	enum m0_rpc_frm_itemq_type  qtype;
-	struct m0_tl               *q;
 	int                         rc;
 
 	M0_PRE(item != NULL && !itemq_tlink_is_in(item));
@@ -284,10 +315,9 @@ static void frm_insert(struct m0_rpc_frm *frm, struct m0_rpc_item *item)
 	M0_LOG(M0_DEBUG, "priority: %d", item->ri_prio);
 
 	qtype = frm_which_qtype(frm, item);
-	q     = &frm->f_itemq[qtype];
 
 	m0_rpc_item_get(item);
-	__itemq_insert(q, item);
+	__itemq_insert(frm, qtype, item);
 
 	M0_CNT_INC(frm->f_nr_items);
 	frm->f_nr_bytes_accumulated += m0_rpc_item_size(item);
@@ -359,22 +389,45 @@ frm_which_qtype(struct m0_rpc_frm *frm, const struct m0_rpc_item *item)
    q is sorted by m0_rpc_item::ri_prio and then by m0_rpc_item::ri_deadline.
 
    Insert new_item such that the ordering of q is maintained.
+
+   The search starts from the last item of the same priority
+   (m0_rpc_frm::f_itemq_tail[]) and goes backward. Deadlines of items are
+   usually assigned as "now + constant", so the new item typically goes right
+   after the tail and insertion takes O(1) instead of O(queue length).
  */
-static void __itemq_insert(struct m0_tl *q, struct m0_rpc_item *new_item)
+static void __itemq_insert(struct m0_rpc_frm *frm,
+			   enum m0_rpc_frm_itemq_type qtype,
+			   struct m0_rpc_item *new_item)
 {
-	struct m0_rpc_item *item;
+	struct m0_tl        *q    = &frm->f_itemq[qtype];
+	struct m0_rpc_item **tail = frm->f_itemq_tail[qtype];
+	struct m0_rpc_item  *item;
+	int                  prio = new_item->ri_prio;
+	int                  i;
 
 	M0_ENTRY();
-
-	/* insertion sort. */
-	m0_tl_for(itemq, q, item) {
-		if (!item_less_or_equal(item, new_item)) {
-			itemq_tlist_add_before(item, new_item);
-			break;
-		}
-	} m0_tl_endfor;
+	M0_PRE(IS_IN_ARRAY(prio, frm->f_itemq_tail[qtype]));
+
+	item = tail[prio];
+	while (item != NULL && item->ri_prio == prio &&
+	       !item_less_or_equal(item, new_item))
+		item = itemq_tlist_prev(q, item);
+	if (item == NULL || item->ri_prio != prio) {
+		/*
+		 * new_item goes first among the items of its priority: right
+		 * after the items of the nearest higher priority, if any.
+		 */
+		for (i = prio + 1; i < M0_RPC_ITEM_PRIO_NR && tail[i] == NULL;
+		     ++i)
+			;
+		item = i < M0_RPC_ITEM_PRIO_NR ? tail[i] : NULL;
+	}
 	if (item == NULL)
-		itemq_tlist_add_tail(q, new_item);
+		itemq_tlist_add(q, new_item);
+	else
+		itemq_tlist_add_after(item, new_item);
+	if (tail[prio] == NULL || tail[prio] == item)
+		tail[prio] = new_item;
 	new_item->ri_itemq = q;
 
 	M0_ASSERT_EX(itemq_invariant(q));
@@ -397,8 +450,8 @@ static void item_move_to_urgent_queue(struct m0_rpc_frm *frm,
 {
 	M0_PRE(item != NULL);
 
-	__itemq_remove(item);
-	__itemq_insert(&frm->f_itemq[FRMQ_URGENT], item);
+	__itemq_remove(frm, item);
+	__itemq_insert(frm, FRMQ_URGENT, item);
 }
 
 /**
@@ -497,6 +550,7 @@ static void frm_fill_packet(struct m0_rpc_frm *frm, struct m0_rpc_packet *p)
 	struct m0_rpc_item *item;
 	struct m0_tl       *q;
 	m0_bcount_t         limit;
+	int                 skipped = 0;
 
 	M0_ENTRY("frm: %p packet: %p", frm, p);
 
@@ -507,8 +561,11 @@ static void frm_fill_packet(struct m0_rpc_frm *frm, struct m0_rpc_packet *p)
 			/* See FRM_FILL_PACKET_NOTE_1 at the end of this func */
 			if (available_space_in_packet(p, frm) == 0)
 				goto out;
-			if (item_will_exceed_packet_size(item, p, frm))
+			if (item_will_exceed_packet_size(item, p, frm)) {
+				if (++skipped >= FRM_FILL_PACKET_SKIP_MAX)
+					goto sources;
 				continue;
+			}
 			if (item->ri_sm.sm_state == M0_RPC_ITEM_FAILED) {
 				/*
 				 * Request might have been cancelled while in
@@ -533,6 +590,7 @@ static void frm_fill_packet(struct m0_rpc_frm *frm, struct m0_rpc_packet *p)
 			m0_rpc_item_put(item);
 		} m0_tl_endfor;
 	}
+sources:
 	frm_fill_packet_from_item_sources(frm, p);
 out:
 	M0_ASSERT_EX(frm_invariant(frm));
@@ -543,6 +601,11 @@ out:
  * I know that this loop is inefficient. But for now
  * let's just stick to simplicity. We can optimize it
  * later if need arises. --Amit
+ *
+ * Once the packet is almost full, every remaining item would be skipped,
+ * making formation quadratic in the queue length. The scan is therefore
+ * stopped after FRM_FILL_PACKET_SKIP_MAX items that don't fit: the skipped
+ * items go into the next packet.
  */
 
 static m0_bcount_t available_space_in_packet(const struct m0_rpc_packet *p,
@@ -635,7 +698,7 @@ static void frm_remove(struct m0_rpc_frm *frm, struct m0_rpc_item *item)
 	M0_PRE(frm != NULL && item != NULL);
 	M0_PRE(frm->f_nr_items > 0 && item->ri_itemq != NULL);
 
-	__itemq_remove(item);
+	__itemq_remove(frm, item);
 	item->ri_frm = NULL;
 	M0_CNT_DEC(frm->f_nr_items);
 	frm->f_nr_bytes_accumulated -= m0_rpc_item_size(item);
@@ -647,8 +710,20 @@ static void frm_remove(struct m0_rpc_frm *frm, struct m0_rpc_item *item)
 	M0_LEAVE();
 }
 
-static void __itemq_remove(struct m0_rpc_item *item)
+static void __itemq_remove(struct m0_rpc_frm *frm, struct m0_rpc_item *item)
 {
+	struct m0_tl        *q = item->ri_itemq;
+	struct m0_rpc_item **tail;
+	struct m0_rpc_item  *prev;
+
+	M0_PRE(q >= frm_first_itemq(frm) && q < frm_end_itemq(frm));
+
+	tail = &frm->f_itemq_tail[q - frm->f_itemq][item->ri_prio];
+	if (*tail == item) {
+		prev = itemq_tlist_prev(q, item);
+		*tail = prev != NULL && prev->ri_prio == item->ri_prio ?
+			prev : NULL;
+	}
 	itemq_tlink_del_fini(item);
 	item->ri_itemq = NULL;
 }
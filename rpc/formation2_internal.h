@@ -215,6 +215,16 @@ struct m0_rpc_frm {
 	 */
 	struct m0_tl                   f_itemq[FRMQ_NR_QUEUES];
 
+	/**
+	   Index over f_itemq[]: f_itemq_tail[q][prio] is the last item with
+	   m0_rpc_item::ri_prio == prio in f_itemq[q], or NULL if there is no
+	   such item. Items of equal priority are contiguous in itemq, so
+	   this allows an item to be inserted without scanning the queue from
+	   the head. @see __itemq_insert()
+	 */
+	struct m0_rpc_item
+		*f_itemq_tail[FRMQ_NR_QUEUES][M0_RPC_ITEM_PRIO_NR];
+
 	/** Total number of items waiting in itemq */
 	uint64_t                       f_nr_items;
 
@@ -107,6 +107,29 @@ M0_TL_DESCR_DEFINE(rpc_conn, "rpc-conn", M0_INTERNAL, struct m0_rpc_conn,
 		   c_link, c_magic, M0_RPC_CONN_MAGIC, M0_RPC_CONN_HEAD_MAGIC);
 M0_TL_DEFINE(rpc_conn, M0_INTERNAL, struct m0_rpc_conn);
 
+enum {
+	/** Buckets in m0_rpc_machine::rm_{incoming,outgoing}_ids. */
+	RPC_CONN_HASH_NR = 512
+};
+
+static uint64_t rpc_conn_hash_func(const struct m0_htable *htable,
+				   const uint64_t         *sender_id)
+{
+	/* Sender ids are hashed by m0_rpc_id_generate() already. */
+	return *sender_id % htable->h_bucket_nr;
+}
+
+static bool rpc_conn_hash_eq(const uint64_t *id0, const uint64_t *id1)
+{
+	return *id0 == *id1;
+}
+
+M0_HT_DESCR_DEFINE(rpc_conn_hash, "rpc-conn-hash", M0_INTERNAL,
+		   struct m0_rpc_conn, c_hlink, c_magic, M0_RPC_CONN_MAGIC,
+		   M0_RPC_CONN_HASH_HEAD_MAGIC, c_sender_id,
+		   rpc_conn_hash_func, rpc_conn_hash_eq);
+M0_HT_DEFINE(rpc_conn_hash, M0_INTERNAL, struct m0_rpc_conn, uint64_t);
+
 static void rpc_tm_event_cb(const struct m0_net_tm_event *ev)
 {
 	/* Do nothing */
@@ -184,9 +207,22 @@ static int __rpc_machine_init(struct m0_rpc_machine *machine)
 	rpc_conn_tlist_init(&machine->rm_outgoing_conns);
 	rmach_watch_tlist_init(&machine->rm_watch);
 
-	rc = m0_rpc_service_start(machine->rm_reqh);
+	rc = rpc_conn_hash_htable_init(&machine->rm_incoming_ids,
+				       RPC_CONN_HASH_NR);
 	if (rc != 0)
 		return M0_ERR(rc);
+	rc = rpc_conn_hash_htable_init(&machine->rm_outgoing_ids,
+				       RPC_CONN_HASH_NR);
+	if (rc != 0) {
+		rpc_conn_hash_htable_fini(&machine->rm_incoming_ids);
+		return M0_ERR(rc);
+	}
+	rc = m0_rpc_service_start(machine->rm_reqh);
+	if (rc != 0) {
+		rpc_conn_hash_htable_fini(&machine->rm_outgoing_ids);
+		rpc_conn_hash_htable_fini(&machine->rm_incoming_ids);
+		return M0_ERR(rc);
+	}
 
 	m0_rpc_machine_bob_init(machine);
 	m0_sm_group_init(&machine->rm_sm_grp);
@@ -206,6 +242,8 @@ static void __rpc_machine_fini(struct m0_rpc_machine *machine)
 	m0_rpc_service_stop(machine->rm_reqh);
 
 	rmach_watch_tlist_fini(&machine->rm_watch);
+	rpc_conn_hash_htable_fini(&machine->rm_outgoing_ids);
+	rpc_conn_hash_htable_fini(&machine->rm_incoming_ids);
 	rpc_conn_tlist_fini(&machine->rm_outgoing_conns);
 	rpc_conn_tlist_fini(&machine->rm_incoming_conns);
 	rpc_chan_tlist_fini(&machine->rm_chans);
@@ -605,6 +643,13 @@ M0_INTERNAL const char *m0_rpc_machine_ep(const struct m0_rpc_machine *rmach)
 	return rmach->rm_tm.ntm_ep->nep_addr;
 }
 
+static struct m0_htable *rpc_machine_ids(struct m0_rpc_machine *rmach,
+					 const struct m0_rpc_conn *conn)
+{
+	return (conn->c_flags & RCF_SENDER_END) ? &rmach->rm_outgoing_ids :
+						  &rmach->rm_incoming_ids;
+}
+
 M0_INTERNAL void m0_rpc_machine_add_conn(struct m0_rpc_machine *rmach,
 					 struct m0_rpc_conn    *conn)
 {
@@ -621,6 +666,8 @@ M0_INTERNAL void m0_rpc_machine_add_conn(struct m0_rpc_machine *rmach,
 	tlist = (conn->c_flags & RCF_SENDER_END) ? &rmach->rm_outgoing_conns :
 						   &rmach->rm_incoming_conns;
 	rpc_conn_tlist_add(tlist, conn);
+	if (conn->c_sender_id != SENDER_ID_INVALID)
+		rpc_conn_hash_htable_add(rpc_machine_ids(rmach, conn), conn);
 	M0_LOG(M0_DEBUG, "rmach %p conn %p added to %s list", rmach, conn,
 		(conn->c_flags & RCF_SENDER_END) ? "outgoing" : "incoming");
 	m0_tl_for(rmach_watch, &rmach->rm_watch, watch) {
@@ -632,6 +679,31 @@ M0_INTERNAL void m0_rpc_machine_add_conn(struct m0_rpc_machine *rmach,
 	M0_LEAVE();
 }
 
+M0_INTERNAL void m0_rpc_machine_del_conn(struct m0_rpc_machine *rmach,
+					 struct m0_rpc_conn    *conn)
+{
+	M0_PRE(m0_rpc_machine_is_locked(rmach));
+	M0_PRE(rpc_conn_tlink_is_in(conn));
+
+	if (rpc_conn_hash_tlink_is_in(conn))
+		rpc_conn_hash_htable_del(rpc_machine_ids(rmach, conn), conn);
+	rpc_conn_tlist_del(conn);
+}
+
+M0_INTERNAL void m0_rpc_machine_conn_id_set(struct m0_rpc_conn *conn,
+					    uint64_t            sender_id)
+{
+	struct m0_rpc_machine *rmach = conn->c_rpc_machine;
+
+	M0_PRE(m0_rpc_machine_is_locked(rmach));
+
+	if (rpc_conn_hash_tlink_is_in(conn))
+		rpc_conn_hash_htable_del(rpc_machine_ids(rmach, conn), conn);
+	conn->c_sender_id = sender_id;
+	if (sender_id != SENDER_ID_INVALID && rpc_conn_tlink_is_in(conn))
+		rpc_conn_hash_htable_add(rpc_machine_ids(rmach, conn), conn);
+}
+
 M0_INTERNAL struct m0_rpc_chan *rpc_chan_get(struct m0_rpc_machine *machine,
 					     struct m0_net_end_point *dest_ep,
 					     uint64_t max_packets_in_flight)
@@ -816,18 +888,23 @@ static void packet_received(struct m0_rpc_packet    *p,
 
 	M0_ENTRY("p %p", p);
 
+	/*
+	 * The machine lock is taken once per packet rather than once per
+	 * item: each m0_rpc_machine_lock() and unlock also runs pending rpc
+	 * ASTs and pushes addb2 context, and packets of small items are common.
+	 */
+	m0_rpc_machine_lock(machine);
 	machine->rm_stats.rs_nr_rcvd_packets++;
 	machine->rm_stats.rs_nr_rcvd_bytes += p->rp_size;
 	/* packet p can also be empty */
 	for_each_item_in_packet(item, p) {
 		item->ri_rmachine = machine;
 		m0_rpc_item_get(item);
-		m0_rpc_machine_lock(machine);
 		m0_rpc_packet_remove_item(p, item);
 		item_received(item, from_ep);
 		m0_rpc_item_put(item);
-		m0_rpc_machine_unlock(machine);
 	} end_for_each_item_in_packet;
+	m0_rpc_machine_unlock(machine);
 
 	M0_LEAVE();
 }
@@ -845,19 +922,19 @@ m0_rpc_machine_find_conn(const struct m0_rpc_machine *machine,
 
 	header = &item->ri_header;
 	use_uuid = (header->osr_sender_id == SENDER_ID_INVALID);
-	conn_list = m0_rpc_item_is_request(item) ?
-				&machine->rm_incoming_conns :
-				&machine->rm_outgoing_conns;
-
-	m0_tl_for(rpc_conn, conn_list, conn) {
-		if (use_uuid) {
-			if (m0_uint128_cmp(&conn->c_uuid,
-					   &header->osr_uuid) == 0)
-				break;
-		} else if (conn->c_sender_id == header->osr_sender_id) {
-			break;
-		}
-	} m0_tl_endfor;
+	if (use_uuid) {
+		/* Connection establishing, no sender id yet. */
+		conn_list = m0_rpc_item_is_request(item) ?
+					&machine->rm_incoming_conns :
+					&machine->rm_outgoing_conns;
+		conn = m0_tl_find(rpc_conn, conn, conn_list,
+				  m0_uint128_cmp(&conn->c_uuid,
+						 &header->osr_uuid) == 0);
+	} else
+		conn = rpc_conn_hash_htable_lookup(m0_rpc_item_is_request(item) ?
+						   &machine->rm_incoming_ids :
+						   &machine->rm_outgoing_ids,
+						   &header->osr_sender_id);
 
 	M0_LEAVE("item=%p conn=%p use_uuid=%d header->osr_uuid="U128X_F" "
 	         "header->osr_sender_id=%"PRIu64, item, conn, !!use_uuid,
@@ -29,6 +29,7 @@
 #include "lib/tlist.h"
 #include "lib/thread.h"
 #include "lib/chan.h"
+#include "lib/hash.h"  /* m0_htable */
 #include "sm/sm.h"     /* m0_sm_group */
 #include "net/net.h"   /* m0_net_transfer_mc, m0_net_domain */
 
@@ -79,6 +80,13 @@ struct m0_rpc_stats {
    Several such contexts might be existing simultaneously.
  */
 struct m0_rpc_machine {
+	/**
+	    Group of all item, session and connection state machines of the
+	    machine, its lock is the machine lock (m0_rpc_machine_lock()).
+	    Formation, item caches, xid lists and reply handling of all
+	    connections are serialised by it; there are no per-connection
+	    locks.
+	 */
 	struct m0_sm_group                rm_sm_grp;
 	/** List of m0_rpc_chan objects, linked using rc_linkage.
 	    List descriptor: rpc_chan
@@ -93,6 +101,15 @@ struct m0_rpc_machine {
 	 */
 	struct m0_tl			  rm_incoming_conns;
 	struct m0_tl			  rm_outgoing_conns;
+	/**
+	    Connections from rm_incoming_conns and rm_outgoing_conns with
+	    valid sender ids, hashed by m0_rpc_conn::c_sender_id, so that an
+	    incoming item finds its connection without scanning all
+	    connections of the machine under the machine lock.
+	    Hash descriptor: rpc_conn_hash
+	 */
+	struct m0_htable		  rm_incoming_ids;
+	struct m0_htable		  rm_outgoing_ids;
 	struct m0_rpc_stats		  rm_stats;
 	/**
 	    Request handler this rpc_machine belongs to.
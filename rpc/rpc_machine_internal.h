@@ -26,6 +26,7 @@
 #define __MOTR_RPC_MACHINE_INT_H__
 
 #include "lib/tlist.h"
+#include "lib/hash.h"
 #include "lib/refs.h"
 #include "rpc/formation2_internal.h"
 
@@ -74,14 +75,28 @@ struct m0_rpc_chan {
 
 M0_INTERNAL void m0_rpc_machine_add_conn(struct m0_rpc_machine *rmach,
 					 struct m0_rpc_conn    *conn);
+M0_INTERNAL void m0_rpc_machine_del_conn(struct m0_rpc_machine *rmach,
+					 struct m0_rpc_conn    *conn);
 
 M0_INTERNAL struct m0_rpc_conn *
 m0_rpc_machine_find_conn(const struct m0_rpc_machine *machine,
 			 const struct m0_rpc_item    *item);
 
+/**
+   Sets sender id of the connection, keeping m0_rpc_machine::rm_incoming_ids
+   and m0_rpc_machine::rm_outgoing_ids up to date.
+
+   @pre m0_rpc_machine_is_locked(conn->c_rpc_machine)
+ */
+M0_INTERNAL void m0_rpc_machine_conn_id_set(struct m0_rpc_conn *conn,
+					    uint64_t            sender_id);
+
 M0_TL_DESCR_DECLARE(rpc_conn, M0_EXTERN);
 M0_TL_DECLARE(rpc_conn, M0_INTERNAL, struct m0_rpc_conn);
 
+M0_HT_DESCR_DECLARE(rpc_conn_hash, M0_EXTERN);
+M0_HT_DECLARE(rpc_conn_hash, M0_INTERNAL, struct m0_rpc_conn, uint64_t);
+
 M0_TL_DESCR_DECLARE(rmach_watch, M0_EXTERN);
 M0_TL_DECLARE(rmach_watch, M0_INTERNAL, struct m0_rpc_machine_watch);
 
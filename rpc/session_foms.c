@@ -270,7 +270,8 @@ M0_INTERNAL int m0_rpc_fom_conn_establish_tick(struct m0_fom *fom)
 		rc = m0_rpc_rcv_conn_init(conn, ctx->cec_sender_ep, machine,
 					  &header->osr_uuid);
 		if (rc == 0) {
-			conn->c_sender_id = m0_rpc_id_generate(uniq_fid);
+			m0_rpc_machine_conn_id_set(conn,
+					m0_rpc_id_generate(uniq_fid));
 			conn_state_set(conn, M0_RPC_CONN_ACTIVE);
 		}
 	}
@@ -0,0 +1,224 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2013-2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+/*
+ * Formation benchmark: queues a large number of small items to a single
+ * formation instance and then forms packets out of them.
+ *
+ * Rpc machine and formation are set up in the same way as in
+ * rpc/ut/formation2.c, no network is involved.
+ */
+
+#define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_UT
+#include "lib/trace.h"
+
+#include "lib/ub.h"         /* m0_ub_set */
+#include "lib/arith.h"      /* m0_rnd */
+#include "lib/memory.h"     /* M0_ALLOC_ARR */
+#include "lib/misc.h"       /* M0_SET0 */
+#include "lib/string.h"     /* memcpy */
+#include "sm/sm.h"
+#include "rpc/rpc_internal.h"
+
+enum {
+	FRM_UB_ITEMS_NR    = 100000,
+	FRM_UB_PACKETS_MAX = 64,
+	FRM_UB_ITEM_SIZE   = 10,
+};
+
+static struct m0_rpc_machine          frm_ub_machine;
+static struct m0_rpc_chan             frm_ub_chan;
+static struct m0_rpc_session          frm_ub_session;
+static struct m0_rpc_frm_constraints  frm_ub_constraints;
+static struct m0_sm_conf              frm_ub_sm_conf;
+static struct m0_sm_state_descr      *frm_ub_sm_states;
+static struct m0_rpc_item            *frm_ub_items;
+static struct m0_rpc_packet          *frm_ub_packets[FRM_UB_PACKETS_MAX + 1];
+static int                            frm_ub_packets_nr;
+
+extern const struct m0_sm_conf outgoing_item_sm_conf;
+extern const struct m0_sm_conf incoming_item_sm_conf;
+
+static m0_bcount_t frm_ub_item_size(const struct m0_rpc_item *item)
+{
+	return FRM_UB_ITEM_SIZE;
+}
+
+static void frm_ub_item_noop(struct m0_rpc_item *item)
+{
+}
+
+static struct m0_rpc_item_type_ops frm_ub_item_type_ops = {
+	.rito_payload_size = frm_ub_item_size,
+	.rito_item_get     = frm_ub_item_noop,
+	.rito_item_put     = frm_ub_item_noop,
+};
+
+static struct m0_rpc_item_type frm_ub_item_type = {
+	.rit_flags = M0_RPC_ITEM_TYPE_REQUEST,
+	.rit_ops   = &frm_ub_item_type_ops,
+};
+
+static int frm_ub_packet_ready(struct m0_rpc_packet *p)
+{
+	M0_UB_ASSERT(frm_ub_packets_nr < ARRAY_SIZE(frm_ub_packets));
+	frm_ub_packets[frm_ub_packets_nr++] = p;
+	return 0;
+}
+
+static const struct m0_rpc_frm_ops frm_ub_ops = {
+	.fo_packet_ready = frm_ub_packet_ready,
+};
+
+static struct m0_rpc_frm *frm_ub_frm(void)
+{
+	return &frm_ub_chan.rc_frm;
+}
+
+static int frm_ub_init(const char *opts M0_UNUSED)
+{
+	M0_SET0(&frm_ub_machine);
+	M0_SET0(&frm_ub_chan);
+	M0_SET0(&frm_ub_session);
+
+	M0_ALLOC_ARR(frm_ub_items, FRM_UB_ITEMS_NR);
+	M0_ALLOC_ARR(frm_ub_sm_states, outgoing_item_sm_conf.scf_nr_states);
+	if (frm_ub_items == NULL || frm_ub_sm_states == NULL) {
+		m0_free(frm_ub_items);
+		m0_free(frm_ub_sm_states);
+		return M0_ERR(-ENOMEM);
+	}
+
+	frm_ub_item_type.rit_incoming_conf = incoming_item_sm_conf;
+	frm_ub_item_type.rit_outgoing_conf = outgoing_item_sm_conf;
+	/*
+	 * Items are not sent anywhere, let them finish in SENDING state. Use a
+	 * private copy of the states, outgoing_item_sm_conf is shared.
+	 */
+	frm_ub_sm_conf = outgoing_item_sm_conf;
+	memcpy(frm_ub_sm_states, outgoing_item_sm_conf.scf_state,
+	       outgoing_item_sm_conf.scf_nr_states *
+	       sizeof frm_ub_sm_states[0]);
+	frm_ub_sm_conf.scf_state = frm_ub_sm_states;
+	frm_ub_sm_states[M0_RPC_ITEM_SENDING].sd_flags = M0_SDF_FINAL;
+
+	frm_ub_chan.rc_rpc_machine = &frm_ub_machine;
+	rpc_conn_tlist_init(&frm_ub_machine.rm_outgoing_conns);
+	m0_sm_group_init(&frm_ub_machine.rm_sm_grp);
+	m0_rpc_frm_constraints_get_defaults(&frm_ub_constraints);
+	m0_rpc_frm_init(frm_ub_frm(), &frm_ub_constraints, &frm_ub_ops);
+	m0_rpc_machine_lock(&frm_ub_machine);
+	return 0;
+}
+
+static void frm_ub_fini(void)
+{
+	m0_rpc_frm_fini(frm_ub_frm());
+	m0_rpc_machine_unlock(&frm_ub_machine);
+	m0_sm_group_fini(&frm_ub_machine.rm_sm_grp);
+	rpc_conn_tlist_fini(&frm_ub_machine.rm_outgoing_conns);
+	m0_free(frm_ub_items);
+	m0_free(frm_ub_sm_states);
+}
+
+/**
+ * Queues FRM_UB_ITEMS_NR items with formation disabled.
+ *
+ * Items have random priorities. Deadlines of items of the same priority
+ * mostly grow (with some jitter), as it happens when items are posted with
+ * "now + timeout" deadlines. All deadlines are in the past, so that items go
+ * to the URGENT queue and no deadline timers are armed.
+ */
+static void frm_ub_enqueue(int iter)
+{
+	struct m0_rpc_frm  *frm  = frm_ub_frm();
+	struct m0_rpc_item *item;
+	uint64_t            seed = 42 + iter;
+	int                 i;
+
+	frm->f_constraints.fc_max_nr_packets_enqed = 0;
+	for (i = 0; i < FRM_UB_ITEMS_NR; ++i) {
+		item = &frm_ub_items[i];
+		m0_rpc_item_init(item, &frm_ub_item_type);
+		item->ri_rmachine = &frm_ub_machine;
+		item->ri_session  = &frm_ub_session;
+		m0_rpc_item_sm_init(item, M0_RPC_ITEM_OUTGOING);
+		item->ri_sm.sm_conf = &frm_ub_sm_conf;
+		item->ri_prio     = m0_rnd(M0_RPC_ITEM_PRIO_NR, &seed);
+		item->ri_deadline = 1 + i * 4 + m0_rnd(16, &seed);
+		m0_rpc_frm_enq_item(frm, item);
+	}
+	M0_UB_ASSERT(frm->f_nr_items == FRM_UB_ITEMS_NR);
+}
+
+/**
+ * Forms packets out of all the queued items.
+ */
+static void frm_ub_form(int iter M0_UNUSED)
+{
+	struct m0_rpc_frm    *frm = frm_ub_frm();
+	struct m0_rpc_packet *p;
+	int                   i;
+
+	frm->f_constraints.fc_max_nr_packets_enqed = FRM_UB_PACKETS_MAX;
+	m0_rpc_frm_run_formation(frm);
+	while (frm_ub_packets_nr > 0) {
+		p = frm_ub_packets[--frm_ub_packets_nr];
+		/* Completion of a packet lets formation form the next one. */
+		m0_rpc_frm_packet_done(p);
+		m0_rpc_packet_discard(p);
+	}
+	M0_UB_ASSERT(frm->f_nr_items == 0);
+	for (i = 0; i < FRM_UB_ITEMS_NR; ++i)
+		m0_rpc_item_fini(&frm_ub_items[i]);
+}
+
+struct m0_ub_set m0_rpc_frm_ub = {
+	.us_name = "rpc-frm-ub",
+	.us_init = frm_ub_init,
+	.us_fini = frm_ub_fini,
+	.us_run  = {
+		/* frm_ub_form() forms packets from items queued here. */
+		{ .ub_name  = "enqueue",
+		  .ub_iter  = 1,
+		  .ub_round = frm_ub_enqueue },
+		{ .ub_name  = "form",
+		  .ub_iter  = 1,
+		  .ub_round = frm_ub_form },
+		{ .ub_name = NULL }
+	}
+};
+
+#undef M0_TRACE_SUBSYSTEM
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
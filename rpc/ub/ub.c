@@ -27,6 +27,7 @@
 #include "lib/misc.h"       /* M0_IN, M0_BITS */
 #include "lib/string.h"     /* strlen, m0_strdup */
 #include "lib/memory.h"     /* m0_free */
+#include "lib/thread.h"     /* M0_THREAD_INIT */
 #include "fop/fop.h"        /* m0_fop_alloc */
 #include "net/bulk_mem.h"   /* m0_net_bulk_mem_xprt */
 #include "net/lnet/lnet.h"  /* m0_net_lnet_xprt */
@@ -44,7 +45,8 @@
 #define ARGS                     \
 	X(nr_conns,    2, 10000) \
 	X(nr_msgs,  1000,  5000) \
-	X(msg_len,    32,  8192)
+	X(msg_len,    32,  8192) \
+	X(nr_threads,  1,   256)
 
 struct args {
 #define X(name, defval, max)  unsigned int a_ ## name;
@@ -331,11 +333,24 @@ static struct m0_rpc_session *_session(unsigned int i)
 	return &g_clients[i].rc_ctx.rcx_session;
 }
 
-static void run(int iter M0_UNUSED)
+/** Sends messages over every nr_threads-th session, starting from "t". */
+static void sender(int t)
 {
 	int n;
 	int k;
-	int rc;
+
+	for (n = 0; n < g_args.a_nr_msgs; ++n) {
+		for (k = t; k < g_args.a_nr_conns; k += g_args.a_nr_threads)
+			fop_send(_session(k), n);
+	}
+}
+
+static void run(int iter M0_UNUSED)
+{
+	struct m0_thread *threads;
+	int               t;
+	int               k;
+	int               rc;
 
 	M0_PRE(g_args.a_nr_msgs > 0 && g_args.a_nr_conns > 0);
 
@@ -343,9 +358,26 @@ static void run(int iter M0_UNUSED)
 	   motr: NOTICE : [rpc/slot.c:584:m0_rpc_slot_reply_received] < rc=-71.
 	   Needs investigation!
 	 */
-	for (n = 0; n < g_args.a_nr_msgs; ++n) {
-		for (k = 0; k < g_args.a_nr_conns; ++k)
-			fop_send(_session(k), n);
+	if (g_args.a_nr_threads == 1) {
+		sender(0);
+	} else {
+		/*
+		 * Concurrent senders load the client and server rpc machines
+		 * from many threads at once, showing how processing of
+		 * different connections scales.
+		 */
+		M0_ALLOC_ARR(threads, g_args.a_nr_threads);
+		M0_UB_ASSERT(threads != NULL);
+		for (t = 0; t < g_args.a_nr_threads; ++t) {
+			rc = M0_THREAD_INIT(&threads[t], int, NULL, &sender, t,
+					    "rpc-ub-%d", t);
+			M0_UB_ASSERT(rc == 0);
+		}
+		for (t = 0; t < g_args.a_nr_threads; ++t) {
+			m0_thread_join(&threads[t]);
+			m0_thread_fini(&threads[t]);
+		}
+		m0_free(threads);
 	}
 
 	for (k = 0; k < g_args.a_nr_conns; ++k) {
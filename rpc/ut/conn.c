@@ -56,6 +56,8 @@ static int conn_ut_init(void)
 
 	rpc_conn_ut_tlist_init(&machine.rm_incoming_conns);
 	rpc_conn_ut_tlist_init(&machine.rm_outgoing_conns);
+	rpc_conn_hash_htable_init(&machine.rm_incoming_ids, 7);
+	rpc_conn_hash_htable_init(&machine.rm_outgoing_ids, 7);
 	rmach_watch_tlist_init(&machine.rm_watch);
 	m0_sm_group_init(&machine.rm_sm_grp);
 
@@ -71,6 +73,8 @@ static int conn_ut_fini(void)
 	rmach_watch_tlist_fini(&machine.rm_watch);
 	rpc_conn_ut_tlist_fini(&machine.rm_incoming_conns);
 	rpc_conn_ut_tlist_fini(&machine.rm_outgoing_conns);
+	rpc_conn_hash_htable_fini(&machine.rm_incoming_ids);
+	rpc_conn_hash_htable_fini(&machine.rm_outgoing_ids);
 	m0_sm_group_fini(&machine.rm_sm_grp);
 	m0_fi_disable("rpc_chan_get", "do_nothing");
 	m0_fi_disable("rpc_chan_put", "do_nothing");
@@ -148,6 +152,9 @@ static void conn_establish_reply(void)
 	m0_rpc_conn_establish_reply_received(&est_fop.f_item);
 	m0_rpc_machine_unlock(&machine);
 	M0_UT_ASSERT(conn_state(&conn) == M0_RPC_CONN_ACTIVE);
+	/* Replies to the connection are found by its sender id. */
+	M0_UT_ASSERT(rpc_conn_hash_htable_lookup(&machine.rm_outgoing_ids,
+						 &conn.c_sender_id) == &conn);
 }
 
 static void conn_terminate(void)
@@ -179,6 +186,7 @@ static void conn_terminate_reply_and_fini(void)
 
 	/* Checks for Conn M0_RPC_CONN_TERMINATED => M0_RPC_CONN_FINALISED */
 	m0_rpc_conn_fini(&conn);
+	M0_UT_ASSERT(rpc_conn_hash_htable_is_empty(&machine.rm_outgoing_ids));
 }
 
 static void conn_check(void)
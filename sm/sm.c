@@ -829,14 +829,19 @@ static int sm_addb2_ctor(struct m0_sm_addb2_stats *stats,
 	stats->as_id = c->scf_addb2_id;
 	stats->as_nr = c->scf_trans_nr;
 	for (i = 0; i < stats->as_nr; ++i) {
-		m0_addb2_hist_add_auto(&stats->as_hist[i], 1000 /* skip */,
-				     /*
-				      * index parameter (2) corresponds to
-				      * "standard" labels added to the context
-				      * of a locality addb2 machine: node, pid
-				      * and locality-id.
-				      */
-				     c->scf_addb2_counter + i, 2);
+		/*
+		 * index parameter (2) corresponds to "standard" labels added
+		 * to the context of a locality addb2 machine: node, pid and
+		 * locality-id.
+		 */
+		if (c->scf_addb2_loghist > 0)
+			m0_addb2_hist_add_log(&stats->as_hist[i],
+					      c->scf_addb2_loghist,
+					      c->scf_addb2_counter + i, 2);
+		else
+			m0_addb2_hist_add_auto(&stats->as_hist[i],
+					       1000 /* skip */,
+					       c->scf_addb2_counter + i, 2);
 	}
 	return 0;
 }
@@ -361,6 +361,13 @@ struct m0_sm_conf {
 	uint64_t                        scf_addb2_key;
 	uint64_t                        scf_addb2_id;
 	uint64_t                        scf_addb2_counter;
+	/**
+	 * If non-zero, transition latencies are collected in log-linear
+	 * histograms with this precision (m0_addb2_hist_add_log()), rather
+	 * than in auto-tuned linear ones. Must be set before
+	 * m0_sm_addb2_init().
+	 */
+	uint32_t                        scf_addb2_loghist;
 };
 
 enum {
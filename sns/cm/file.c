@@ -757,6 +757,15 @@ M0_INTERNAL void m0_sns_cm_file_fwd_map(struct m0_sns_cm_file_ctx *fctx,
 	m0_sns_cm_fctx_unlock(fctx);
 }
 
+M0_INTERNAL void m0_sns_cm_file_fwd_map_groups(struct m0_sns_cm_file_ctx *fctx,
+					       uint64_t group, uint64_t nr,
+					       struct m0_pdclust_tgt_addr *ta)
+{
+	m0_sns_cm_fctx_lock(fctx);
+	m0_fd_fwd_map_groups(fctx->sf_pi, group, nr, ta);
+	m0_sns_cm_fctx_unlock(fctx);
+}
+
 M0_INTERNAL void m0_sns_cm_file_bwd_map(struct m0_sns_cm_file_ctx *fctx,
 					const struct m0_pdclust_tgt_addr *ta,
 					struct m0_pdclust_src_addr *sa)
@@ -195,6 +195,14 @@ M0_INTERNAL void m0_sns_cm_file_fwd_map(struct m0_sns_cm_file_ctx *fctx,
 					const struct m0_pdclust_src_addr *sa,
 					struct m0_pdclust_tgt_addr *ta);
 
+/**
+ * Maps all units of "nr" consecutive parity groups starting from "group".
+ * @see m0_fd_fwd_map_groups()
+ */
+M0_INTERNAL void m0_sns_cm_file_fwd_map_groups(struct m0_sns_cm_file_ctx *fctx,
+					       uint64_t group, uint64_t nr,
+					       struct m0_pdclust_tgt_addr *ta);
+
 M0_INTERNAL void m0_sns_cm_file_bwd_map(struct m0_sns_cm_file_ctx *fctx,
 					const struct m0_pdclust_tgt_addr *ta,
 					struct m0_pdclust_src_addr *sa);
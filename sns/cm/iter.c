@@ -51,6 +51,8 @@
 
 enum {
         SNS_REPAIR_ITER_MAGIX = 0x33BAADF00DCAFE77,
+	/** Number of parity groups mapped at once by __group_skip(). */
+	SNS_ITER_GROUP_BATCH  = 16,
 };
 
 static const struct m0_bob_type iter_bob = {
@@ -224,6 +226,12 @@ static int __file_context_init(struct m0_sns_cm_iter *it)
 	it->si_fc.ifc_dpupg = m0_sns_cm_ag_nr_data_units(pl) +
 				m0_sns_cm_ag_nr_parity_units(pl);
 	it->si_fc.ifc_upg = m0_sns_cm_ag_size(pl);
+	m0_free(it->si_fc.ifc_group_ta);
+	M0_ALLOC_ARR(it->si_fc.ifc_group_ta,
+		     SNS_ITER_GROUP_BATCH * it->si_fc.ifc_upg);
+	if (it->si_fc.ifc_group_ta == NULL)
+		return M0_ERR(-ENOMEM);
+	it->si_fc.ifc_ta_nr = 0;
 	M0_CNT_INC(it->si_total_files);
 	out_last = &cm->cm_last_processed_out;
 	if (m0_cm_ag_id_is_set(out_last)) {
@@ -375,26 +383,43 @@ static bool __has_incoming(struct m0_sns_cm *scm,
 }
 
 
-static bool __group_skip(struct m0_sns_cm_iter *it, uint64_t group)
+/**
+ * Returns targets of all units of the group, mapping SNS_ITER_GROUP_BATCH
+ * groups at once, as the groups of a file are scanned in order.
+ */
+static const struct m0_pdclust_tgt_addr *group_ta(struct m0_sns_cm_iter *it,
+						  uint64_t group)
 {
 	struct m0_sns_cm_iter_file_ctx *ifc = &it->si_fc;
-	struct m0_sns_cm_file_ctx      *fctx = ifc->ifc_fctx;
-	struct m0_fid                   cobfid;
-	struct m0_pdclust_src_addr      sa;
-	struct m0_pdclust_tgt_addr      ta;
-	int                             i;
-	struct m0_poolmach             *pm = fctx->sf_pm;
- 	struct m0_sns_cm               *scm = it2sns(it);
+
+	if (group < ifc->ifc_ta_group ||
+	    group >= ifc->ifc_ta_group + ifc->ifc_ta_nr) {
+		ifc->ifc_ta_group = group;
+		ifc->ifc_ta_nr = min64u(SNS_ITER_GROUP_BATCH,
+					ifc->ifc_group_last - group + 1);
+		m0_sns_cm_file_fwd_map_groups(ifc->ifc_fctx, group,
+					      ifc->ifc_ta_nr,
+					      ifc->ifc_group_ta);
+	}
+	return &ifc->ifc_group_ta[(group - ifc->ifc_ta_group) * ifc->ifc_upg];
+}
+
+static bool __group_skip(struct m0_sns_cm_iter *it, uint64_t group)
+{
+	struct m0_sns_cm_iter_file_ctx   *ifc = &it->si_fc;
+	struct m0_sns_cm_file_ctx        *fctx = ifc->ifc_fctx;
+	const struct m0_pdclust_tgt_addr *ta;
+	int                               i;
+	struct m0_poolmach               *pm = fctx->sf_pm;
+ 	struct m0_sns_cm                 *scm = it2sns(it);
 
 	M0_ENTRY("it: %p group: %lu", it, (unsigned long)group);
 
+	ta = group_ta(it, group);
 	for (i = 0; i < ifc->ifc_upg; ++i) {
-		sa.sa_unit = i;
-		sa.sa_group = group;
-		m0_sns_cm_unit2cobfid(fctx, &sa, &ta, &cobfid);
-		if (scm->sc_helpers->sch_is_cob_failed(pm, ta.ta_obj) &&
-		    !m0_sns_cm_is_cob_repaired(pm, ta.ta_obj) &&
-		    !m0_sns_cm_unit_is_spare(fctx, group, sa.sa_unit))
+		if (scm->sc_helpers->sch_is_cob_failed(pm, ta[i].ta_obj) &&
+		    !m0_sns_cm_is_cob_repaired(pm, ta[i].ta_obj) &&
+		    !m0_sns_cm_unit_is_spare(fctx, group, i))
 			return false;
 	}
 
@@ -915,6 +940,7 @@ M0_INTERNAL void m0_sns_cm_iter_stop(struct m0_sns_cm_iter *it)
 	if (iter_phase(it) == ITPH_IDLE) {
 		if (it->si_cns_it.cni_cdom != NULL)
 			m0_cob_ns_iter_fini(&it->si_cns_it);
+		m0_free(it->si_fc.ifc_group_ta);
 		M0_SET0(&it->si_fc);
 	}
 }
@@ -925,6 +951,7 @@ M0_INTERNAL void m0_sns_cm_iter_fini(struct m0_sns_cm_iter *it)
 	M0_PRE(M0_IN(iter_phase(it), (ITPH_INIT, ITPH_IDLE)));
 
 	iter_phase_set(it, ITPH_FINI);
+	m0_free0(&it->si_fc.ifc_group_ta);
 	m0_sm_fini(&it->si_sm);
 	m0_sns_cm_iter_bob_fini(it);
 }
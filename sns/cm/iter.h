@@ -83,6 +83,15 @@ struct m0_sns_cm_iter_file_ctx {
 	struct m0_fid                 ifc_cob_fid;
 
 	bool                          ifc_cob_is_spare_unit;
+
+	/**
+	 * Targets of all units of the ifc_ta_nr groups starting from
+	 * ifc_ta_group, mapped at once while looking for the next group to
+	 * be processed.
+	 */
+	struct m0_pdclust_tgt_addr   *ifc_group_ta;
+	uint64_t                      ifc_ta_group;
+	uint64_t                      ifc_ta_nr;
 };
 
 /**
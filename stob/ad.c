@@ -1168,34 +1168,44 @@ M0_INTERNAL int stob_ad_cursor(struct m0_stob_ad_domain *adom,
 	return M0_RC(rc);
 }
 
+/**
+ * Returns the number of fragments the write to "iv" is mapped with.
+ *
+ * Adjacent and overlapping segments of iv are mapped by a single emap paste
+ * (stob_ad_write_prepare() packs io->si_stob), so they are counted as one
+ * run. A run is split into balloc-group-sized fragments, because every
+ * allocated extent belongs to a single group.
+ */
 static uint32_t stob_ad_write_map_count(struct m0_stob_ad_domain *adom,
-					struct m0_indexvec *iv, bool pack)
+					const struct m0_indexvec *iv)
 {
-	uint32_t               frags;
-	m0_bcount_t            frag_size;
-	m0_bcount_t            grp_size;
-	bool                   eov;
-	struct m0_ivec_cursor  it;
+	const m0_bindex_t *idx = iv->iv_index;
+	const m0_bcount_t *cnt = iv->iv_vec.v_count;
+	uint32_t           nr  = iv->iv_vec.v_nr;
+	uint32_t           frags = 0;
+	m0_bcount_t        grp_size;
+	m0_bcount_t        run;
+	m0_bindex_t        end;
+	uint32_t           i;
+	uint32_t           j;
 
-	M0_ENTRY("dom=%p bshift=%u babshift=%d pack=%#x", adom,
-		 adom->sad_bshift, adom->sad_babshift, (int)pack);
+	M0_ENTRY("dom=%p bshift=%u babshift=%d nr=%u", adom,
+		 adom->sad_bshift, adom->sad_babshift, nr);
 
-	frags = 0;
-	m0_ivec_cursor_init(&it, iv);
 	grp_size = adom->sad_blocks_per_group << adom->sad_babshift;
-
-	if (pack)
-		m0_indexvec_pack(iv);
-	do {
-		frag_size = min_check(m0_ivec_cursor_step(&it), grp_size);
-		M0_ASSERT(frag_size > 0);
-		M0_ASSERT(frag_size <= (size_t)~0ULL);
-		M0_LOG(M0_DEBUG, "frag_size=0x%"PRIx64, frag_size);
-
-		eov = m0_ivec_cursor_move(&it, frag_size);
-
-		M0_CNT_INC(frags);
-	} while (!eov);
+	for (i = 0; i < nr; i = j) {
+		run = cnt[i];
+		end = idx[i] + cnt[i];
+		/* Same merging rule as in m0_indexvec_pack(). */
+		for (j = i + 1; j < nr && idx[j] <= end; ++j) {
+			if (idx[j] + cnt[j] > end) {
+				run += idx[j] + cnt[j] - end;
+				end  = idx[j] + cnt[j];
+			}
+		}
+		frags += (run + grp_size - 1) / grp_size;
+	}
+	M0_POST(frags > 0);
 
 	M0_LEAVE("dom=%p frags=%u", adom, frags);
 	return frags;
@@ -1207,14 +1217,18 @@ static void stob_ad_write_credit(const struct m0_stob_domain *dom,
 {
 	struct m0_stob_ad_domain *adom = stob_ad_domain2ad(dom);
 	struct m0_ad_balloc      *ballroom = adom->sad_ballroom;
-	/* XXX discard const, because stob_ad_write_map_count() changes iv */
-	struct m0_indexvec       *iv = (struct m0_indexvec *) &io->si_stob;
 	int                       bfrags = BALLOC_FRAGS_MAX;
 	int                       frags;
+	int                       pastes;
 
-	frags = stob_ad_write_map_count(adom, iv, false);
-	M0_LOG(M0_DEBUG, "frags=%d", frags);
-	frags = max_check(frags, bfrags);
+	frags = stob_ad_write_map_count(adom, &io->si_stob);
+	/*
+	 * stob_ad_write_map() pastes a fragment at every boundary of packed
+	 * io->si_stob runs or of allocated extents. There are at most bfrags
+	 * allocated extents, each adding at most one boundary.
+	 */
+	pastes = frags + bfrags - 1;
+	M0_LOG(M0_DEBUG, "frags=%d pastes=%d", frags, pastes);
 
 	if (ballroom->ab_ops->bo_alloc_credit != NULL)
 		ballroom->ab_ops->bo_alloc_credit(ballroom, bfrags, accum);
@@ -1222,13 +1236,13 @@ static void stob_ad_write_credit(const struct m0_stob_domain *dom,
 	/*
 	 * XXX We don't know if MOTR-2099 is triggered by miscalulating of
 	 * emap credit (BETREE_DELETE epecially). Adding one more extra credit
-	 * of 'emap paste' (that is frags + 1) to verify this idea.
+	 * of 'emap paste' (that is pastes + 1) to verify this idea.
 	 */
-	m0_be_emap_credit(&adom->sad_adata, M0_BEO_PASTE, frags + 1, accum);
+	m0_be_emap_credit(&adom->sad_adata, M0_BEO_PASTE, pastes + 1, accum);
 
 	if (adom->sad_overwrite && ballroom->ab_ops->bo_free_credit != NULL) {
 		/* for each emap_paste() seg_free() could be called 3 times */
-		ballroom->ab_ops->bo_free_credit(ballroom, 3 * frags, accum);
+		ballroom->ab_ops->bo_free_credit(ballroom, 3 * pastes, accum);
 	}
 	m0_stob_io_credit(io, m0_stob_dom_get(adom->sad_bstore), accum);
 }
@@ -1866,6 +1880,7 @@ static int stob_ad_write_map(struct m0_stob_io *io,
 	struct stob_ad_rec_frag	*arp;
 	uint32_t		 i = 0;
 	uint32_t                 last_seg;
+	uint32_t                 pastes = 0;
 
 	M0_ENTRY("io=%p dom=%p frags=%u", io, adom, frags);
 
@@ -1899,6 +1914,7 @@ static int stob_ad_write_map(struct m0_stob_io *io,
 		rc = stob_ad_write_map_ext(io, adom, off, map->ct_it, &todo);
 		if (rc != 0)
 			break;
+		++pastes;
 
 		last_seg = dst->ic_cur.vc_seg;
 		eodst = m0_ivec_cursor_move(dst, frag_size);
@@ -1920,14 +1936,44 @@ static int stob_ad_write_map(struct m0_stob_io *io,
 		M0_ASSERT(eodst == eoext);
 	} while (!eodst);
 
-	if (rc == 0)
+	if (rc == 0) {
+		M0_ADDB2_ADD(M0_AVI_ATTR, io->si_id,
+			     M0_AVI_STOB_IO_ATTR_AD_PASTES, pastes);
 		m0_fol_frag_add(&io->si_tx->tx_fol_rec, frag);
-	else
+	} else
 		stob_ad_fol_frag_free(frag);
 
 	return M0_RC(rc);
 }
 
+/**
+   Merges physically adjacent allocated extents, so that they are written and
+   mapped as a single fragment. Extents are not merged across balloc groups,
+   so that freeing a mapped segment touches a single group, as assumed by
+   stob_ad_write_credit(). Returns the number of merged extents.
+ */
+static uint32_t stob_ad_wext_merge(struct m0_stob_ad_domain *adom,
+				   struct stob_ad_write_ext *wext)
+{
+	struct stob_ad_write_ext *next;
+	m0_bcount_t               grp_size;
+	uint32_t                  merged = 0;
+
+	grp_size = adom->sad_blocks_per_group << adom->sad_babshift;
+	while ((next = wext->we_next) != NULL) {
+		if (wext->we_ext.e_end == next->we_ext.e_start &&
+		    wext->we_ext.e_start / grp_size ==
+		    (next->we_ext.e_end - 1) / grp_size) {
+			wext->we_ext.e_end = next->we_ext.e_end;
+			wext->we_next = next->we_next;
+			m0_free(next);
+			++merged;
+		} else
+			wext = next;
+	}
+	return merged;
+}
+
 /**
    Frees wext list.
  */
@@ -2024,7 +2070,11 @@ static int stob_ad_write_prepare(struct m0_stob_io        *io,
 
 	if (rc == 0) {
 		uint32_t frags;
+		uint32_t merged;
 
+		merged = stob_ad_wext_merge(adom, &head);
+		M0_ADDB2_ADD(M0_AVI_ATTR, io->si_id,
+			     M0_AVI_STOB_IO_ATTR_AD_EXT_MERGED, merged);
 		/* Init cursor for balloc extents */
 		stob_ad_wext_cursor_init(&wc, &head);
 		/* Find num of frag based on boundaries of balloc-extents &
@@ -2046,11 +2096,18 @@ static int stob_ad_write_prepare(struct m0_stob_io        *io,
 			 */
 			stob_ad_write_back_fill(io, back, src, &wc);
 
+			/*
+			 * Coalesce adjacent COB-offset extents, so that each
+			 * run is mapped by a single emap paste.
+			 */
+			M0_ADDB2_ADD(M0_AVI_ATTR, io->si_id,
+				     M0_AVI_STOB_IO_ATTR_AD_SEG_MERGED,
+				     m0_indexvec_pack(&io->si_stob));
 			/* Init cursor for COB-offset-extent */
 			m0_ivec_cursor_init(&dst, &io->si_stob);
 			stob_ad_wext_cursor_init(&wc, &head);
 			frags = max_check(bfrags, stob_ad_write_map_count(adom,
-							   &io->si_stob, true));
+							   &io->si_stob));
 			rc = stob_ad_write_map(io, adom, &dst, map, &wc, frags);
 		}
 	}
@@ -48,6 +48,14 @@ enum m0_avi_stob_io_labels {
         M0_AVI_STOB_IO_ATTR_UVEC_NR,
         M0_AVI_STOB_IO_ATTR_UVEC_COUNT,
         M0_AVI_STOB_IO_ATTR_UVEC_BYTES,
+	/** Adjacent segments of an AD write coalesced before mapping. */
+	M0_AVI_STOB_IO_ATTR_AD_SEG_MERGED,
+	/** Physically adjacent allocated extents merged by AD write. */
+	M0_AVI_STOB_IO_ATTR_AD_EXT_MERGED,
+	/** Extent map pastes done by AD write. */
+	M0_AVI_STOB_IO_ATTR_AD_PASTES,
+	/** Log-linear histogram of linux stob I/O latencies (ns). */
+	M0_AVI_STOB_IOQ_LATENCY,
 } M0_XCA_ENUM;
 
 enum m0_addb2_stio_req_labels {
@@ -31,6 +31,7 @@
 #include "ha/ha.h"                      /* m0_ha_send */
 #include "ha/msg.h"                     /* m0_ha_msg */
 
+#include "lib/arith.h"			/* min32 */
 #include "lib/misc.h"			/* M0_SET0 */
 #include "lib/errno.h"			/* ENOMEM */
 #include "lib/finject.h"		/* M0_FI_ENABLED */
@@ -96,6 +97,27 @@
    implemented, because it requires synchronization between user actions
    (cancellation) and ongoing IO in SIS_BUSY state.
 
+   <b>io_uring back-end</b>
+
+   When a domain is initialised with M0_STOB_IOQ_URING back-end
+   ("ioq=uring" in the domain init configuration, see stob/linux.c), fragments
+   go through the same admission queue, but ioq_queue_submit() moves them to
+   the io_uring submission queue and submits the whole batch with a single
+   io_uring_enter(2) call, in the context of the thread that launched the
+   request. Stob file descriptors are kept in the io_uring registered files
+   table (m0_stob_ioq_file_register()).
+
+   Completions are reaped in batches by a single thread per domain
+   (ioq_uring_thread()), which calls ioq_complete() exactly as AIO threads do.
+   Completions are not delivered from the launching thread: completion
+   call-backs (ad stob, BE, ADDB2) may take locks held by the launcher.
+
+   The completion thread waits with a timeout and retries the submission of
+   entries left in the submission queue by a failed io_uring_enter(2), so that
+   they are not stuck when there is no I/O in flight to wake the thread up.
+   Waiting with a timeout must not touch the submission queue, which is owned
+   by the submitters, hence the back-end requires IORING_FEAT_EXT_ARG.
+
    @todo use explicit state machine instead of ioq threads
 
    @see http://www.kernel.org/doc/man-pages/online/pages/man2/io_setup.2.html
@@ -141,6 +163,7 @@ static struct ioq_qev *ioq_queue_get   (struct m0_stob_ioq *ioq);
 static void            ioq_queue_put   (struct m0_stob_ioq *ioq,
 					struct ioq_qev *qev);
 static void            ioq_queue_submit(struct m0_stob_ioq *ioq);
+static void            ioq_uring_submit(struct m0_stob_ioq *ioq);
 static void            ioq_queue_lock  (struct m0_stob_ioq *ioq);
 static void            ioq_queue_unlock(struct m0_stob_ioq *ioq);
 
@@ -400,6 +423,10 @@ static void ioq_queue_submit(struct m0_stob_ioq *ioq)
 	struct ioq_qev  *qev[M0_STOB_IOQ_BATCH_IN_SIZE];
 	struct iocb    *evin[M0_STOB_IOQ_BATCH_IN_SIZE];
 
+	if (ioq->ioq_backend == M0_STOB_IOQ_URING) {
+		ioq_uring_submit(ioq);
+		return;
+	}
 	do {
 		ioq_queue_lock(ioq);
 		avail = m0_atomic64_get(&ioq->ioq_avail);
@@ -493,7 +520,7 @@ int64_t emulate_disk_errors_nr = 0;
    m0_stob_io::si_wait.
  */
 static void ioq_complete(struct m0_stob_ioq *ioq, struct ioq_qev *qev,
-			 long res, long res2)
+			 long res, long res2, struct m0_addb2_hist *latency)
 {
 	struct m0_stob_io    *io   = qev->iq_io;
 	struct stob_linux_io *lio  = io->si_stob_private;
@@ -574,13 +601,15 @@ static void ioq_complete(struct m0_stob_ioq *ioq, struct ioq_qev *qev,
 	 */
 	if (m0_atomic64_add_return(&lio->si_done, 1) == lio->si_nr) {
 		m0_bcount_t bdone = m0_atomic64_get(&lio->si_bdone);
+		m0_time_t   duration;
 
 		M0_LOG(M0_DEBUG, FID_F" nr=%d sz=%lx si_rc=%d", FID_P(fid),
 		       lio->si_nr, (unsigned long)bdone, (int)io->si_rc);
 		io->si_count = bdone >> m0_stob_ioq_bshift(ioq);
-		M0_ADDB2_ADD(M0_AVI_STOB_IO_END, FID_P(fid),
-			     m0_time_sub(m0_time_now(), io->si_start),
+		duration = m0_time_sub(m0_time_now(), io->si_start);
+		M0_ADDB2_ADD(M0_AVI_STOB_IO_END, FID_P(fid), duration,
 			     io->si_rc, io->si_count, lio->si_nr);
+		m0_addb2_hist_mod(latency, duration);
 		stob_linux_io_release(lio);
 		io->si_state = SIS_IDLE;
 		M0_ADDB2_ADD(M0_AVI_STOB_IO_REQ, io->si_id, M0_AVI_LIO_ENDIO);
@@ -644,6 +673,7 @@ static void stob_ioq_thread(struct m0_stob_ioq *ioq)
 	struct m0_addb2_hist inflight = {};
 	struct m0_addb2_hist queued   = {};
 	struct m0_addb2_hist gotten   = {};
+	struct m0_addb2_hist latency  = {};
 	int                  thread_index;
 
 	thread_index = m0_thread_self() - ioq->ioq_thread;
@@ -651,6 +681,8 @@ static void stob_ioq_thread(struct m0_stob_ioq *ioq)
 	m0_addb2_hist_add_auto(&inflight, 1000, M0_AVI_STOB_IOQ_INFLIGHT, -1);
 	m0_addb2_hist_add_auto(&queued,   1000, M0_AVI_STOB_IOQ_QUEUED, -1);
 	m0_addb2_hist_add_auto(&gotten,   1000, M0_AVI_STOB_IOQ_GOT, -1);
+	m0_addb2_hist_add_log(&latency, M0_ADDB2_LOGHIST_PRECISION,
+			      M0_AVI_STOB_IOQ_LATENCY, -1);
 	while (!m0_semaphore_trydown(&ioq->ioq_stop_sem[thread_index])) {
 		timeout = ioq_timeout_default;
 		got = io_getevents(ioq->ioq_ctx, 1, ARRAY_SIZE(evout),
@@ -666,7 +698,7 @@ static void stob_ioq_thread(struct m0_stob_ioq *ioq)
 			iev = &evout[i];
 			qev = container_of(iev->obj, struct ioq_qev, iq_iocb);
 			M0_ASSERT(!m0_queue_link_is_in(&qev->iq_linkage));
-			ioq_complete(ioq, qev, iev->res, iev->res2);
+			ioq_complete(ioq, qev, iev->res, iev->res2, &latency);
 		}
 		ioq_queue_submit(ioq);
 		m0_addb2_hist_mod(&gotten, got);
@@ -683,17 +715,248 @@ static void stob_ioq_thread(struct m0_stob_ioq *ioq)
 	m0_timer_locality_fini(&ioq->ioq_stop_timer_loc[thread_index]);
 }
 
-M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq)
+#ifdef ENABLE_IO_URING
+
+enum {
+	/** First back-off delay after a completion queue wait error. */
+	IOQ_URING_BACKOFF_MIN       = M0_TIME_ONE_MSEC,
+	/** The back-off delay doesn't grow beyond MIN << SHIFT_MAX (~1s). */
+	IOQ_URING_BACKOFF_SHIFT_MAX = 10
+};
+
+/** How long ioq_uring_thread() waits for a completion before retrying. */
+static const struct __kernel_timespec ioq_uring_wait = {
+	.tv_sec  = 1,
+	.tv_nsec = 0
+};
+
+/**
+   Fills submission queue entry for the fragment.
+
+   The fragment is described by its iocb in the same way as for AIO back-end,
+   so that ioq_complete() and ioq_io_error() work for both back-ends.
+ */
+static void ioq_uring_prep(struct m0_stob_ioq *ioq, struct io_uring_sqe *sqe,
+			   struct ioq_qev *qev)
+{
+	struct m0_stob_linux *lstob = m0_stob_linux_container(qev->iq_io->
+							       si_obj);
+	struct iocb          *iocb  = &qev->iq_iocb;
+	const struct iovec   *iov   = iocb->u.v.vec;
+	bool                  read  = iocb->aio_lio_opcode == IO_CMD_PREADV;
+	int                   fd;
+
+	fd = lstob->sl_fd_idx >= 0 ? lstob->sl_fd_idx : lstob->sl_fd;
+	if (read)
+		io_uring_prep_readv(sqe, fd, iov, iocb->u.v.nr,
+				    iocb->u.v.offset);
+	else
+		io_uring_prep_writev(sqe, fd, iov, iocb->u.v.nr,
+				     iocb->u.v.offset);
+	if (lstob->sl_fd_idx >= 0)
+		io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+	io_uring_sqe_set_data(sqe, qev);
+}
+
+/**
+   Moves fragments from the admission queue to the submission queue and
+   submits all of them with a single system call.
+
+   Entries not accepted by a failed io_uring_submit() stay in the submission
+   queue. They are submitted with the next batch or, if no other batch comes,
+   by ioq_uring_thread() within IOQ_URING_WAIT.
+ */
+static void ioq_uring_submit(struct m0_stob_ioq *ioq)
+{
+	struct io_uring_sqe *sqe;
+	int                  got = 0;
+	int                  rc;
+
+	ioq_queue_lock(ioq);
+	while (ioq->ioq_queued > 0 && m0_atomic64_get(&ioq->ioq_avail) > 0) {
+		sqe = io_uring_get_sqe(&ioq->ioq_uring);
+		if (sqe == NULL)
+			break;
+		ioq_uring_prep(ioq, sqe, ioq_queue_get(ioq));
+		m0_atomic64_dec(&ioq->ioq_avail);
+		++got;
+	}
+	rc = io_uring_sq_ready(&ioq->ioq_uring) > 0 ?
+		io_uring_submit(&ioq->ioq_uring) : 0;
+	ioq_queue_unlock(ioq);
+	if (rc < 0)
+		M0_LOG(M0_ERROR, "got=%d rc=%d", got, rc);
+}
+
+/**
+   io_uring completion thread.
+
+   Waits for completion events, reaps them in batches and delivers them to the
+   users. Submits fragments left in the admission queue when space frees up
+   and entries left in the submission queue by a failed submission. Stops
+   when m0_stob_ioq_fini() sets ioq_uring_stop and wakes it up with a no-op
+   request.
+ */
+static void ioq_uring_thread(struct m0_stob_ioq *ioq)
+{
+	struct io_uring_cqe      *cqe[M0_STOB_IOQ_BATCH_OUT_SIZE];
+	struct ioq_qev           *qev[M0_STOB_IOQ_BATCH_OUT_SIZE];
+	long                      res[M0_STOB_IOQ_BATCH_OUT_SIZE];
+	struct m0_addb2_hist      inflight = {};
+	struct m0_addb2_hist      queued   = {};
+	struct m0_addb2_hist      gotten   = {};
+	struct m0_addb2_hist      latency  = {};
+	struct __kernel_timespec  wait;
+	int                       got;
+	int                       done;
+	int                       avail;
+	int                       errors   = 0;
+	int                       rc;
+	int                       i;
+
+	M0_ADDB2_PUSH(M0_AVI_STOB_IOQ, 0);
+	m0_addb2_hist_add_auto(&inflight, 1000, M0_AVI_STOB_IOQ_INFLIGHT, -1);
+	m0_addb2_hist_add_auto(&queued,   1000, M0_AVI_STOB_IOQ_QUEUED, -1);
+	m0_addb2_hist_add_auto(&gotten,   1000, M0_AVI_STOB_IOQ_GOT, -1);
+	m0_addb2_hist_add_log(&latency, M0_ADDB2_LOGHIST_PRECISION,
+			      M0_AVI_STOB_IOQ_LATENCY, -1);
+	while (!ioq->ioq_uring_stop) {
+		wait = ioq_uring_wait;
+		rc = io_uring_wait_cqe_timeout(&ioq->ioq_uring, &cqe[0], &wait);
+		if (rc == -ETIME || rc == -EINTR) {
+			errors = 0;
+			/* Retry entries left by a failed submission. */
+			ioq_queue_submit(ioq);
+			continue;
+		} else if (rc != 0) {
+			/* Back off exponentially on persistent errors. */
+			M0_LOG(M0_ERROR, "rc=%d errors=%d", rc, errors);
+			m0_nanosleep(IOQ_URING_BACKOFF_MIN <<
+				     min32(errors, IOQ_URING_BACKOFF_SHIFT_MAX),
+				     NULL);
+			++errors;
+			ioq_queue_submit(ioq);
+			continue;
+		}
+		errors = 0;
+		got = io_uring_peek_batch_cqe(&ioq->ioq_uring,
+					      cqe, ARRAY_SIZE(cqe));
+		for (done = 0, i = 0; i < got; ++i) {
+			/* NULL is the wake-up from m0_stob_ioq_fini(). */
+			if (io_uring_cqe_get_data(cqe[i]) == NULL)
+				continue;
+			qev[done] = io_uring_cqe_get_data(cqe[i]);
+			res[done] = cqe[i]->res;
+			++done;
+		}
+		io_uring_cq_advance(&ioq->ioq_uring, got);
+		if (done > 0) {
+			avail = m0_atomic64_add_return(&ioq->ioq_avail, done);
+			M0_ASSERT(avail <= M0_STOB_IOQ_RING_SIZE);
+		}
+		for (i = 0; i < done; ++i) {
+			M0_ASSERT(!m0_queue_link_is_in(&qev[i]->iq_linkage));
+			ioq_complete(ioq, qev[i], res[i], 0, &latency);
+		}
+		ioq_queue_submit(ioq);
+		m0_addb2_hist_mod(&gotten, done);
+		m0_addb2_hist_mod(&queued, ioq->ioq_queued);
+		m0_addb2_hist_mod(&inflight, M0_STOB_IOQ_RING_SIZE -
+				     m0_atomic64_get(&ioq->ioq_avail));
+		m0_addb2_force(M0_MKTIME(5, 0));
+	}
+	m0_addb2_pop(M0_AVI_STOB_IOQ);
+}
+
+static int ioq_uring_init(struct m0_stob_ioq *ioq)
 {
 	int result;
 	int i;
 
-	ioq->ioq_ctx      = NULL;
-	m0_atomic64_set(&ioq->ioq_avail, M0_STOB_IOQ_RING_SIZE);
-	ioq->ioq_queued   = 0;
+	for (i = 0; i < ARRAY_SIZE(ioq->ioq_files); ++i)
+		ioq->ioq_files[i] = -1;
+	ioq->ioq_uring_stop = false;
+	/*
+	 * Completion queue is twice as large as the submission queue, so it
+	 * doesn't overflow while no more than M0_STOB_IOQ_RING_SIZE fragments
+	 * are in flight (see ioq_avail).
+	 */
+	result = io_uring_queue_init(M0_STOB_IOQ_RING_SIZE, &ioq->ioq_uring, 0);
+	if (result != 0)
+		return M0_ERR(result);
+	if (!(ioq->ioq_uring.features & IORING_FEAT_EXT_ARG)) {
+		io_uring_queue_exit(&ioq->ioq_uring);
+		return M0_ERR_INFO(-ENOSYS, "IORING_FEAT_EXT_ARG is required.");
+	}
+	/* Sparse table, slots are filled by m0_stob_ioq_file_register(). */
+	result = io_uring_register_files(&ioq->ioq_uring, ioq->ioq_files,
+					 ARRAY_SIZE(ioq->ioq_files)) ?:
+		 M0_THREAD_INIT(&ioq->ioq_thread[0], struct m0_stob_ioq *,
+				NULL, &ioq_uring_thread, ioq, "ioq_uring");
+	if (result != 0)
+		io_uring_queue_exit(&ioq->ioq_uring);
+	return M0_RC(result);
+}
 
-	m0_queue_init(&ioq->ioq_queue);
-	m0_mutex_init(&ioq->ioq_lock);
+static void ioq_uring_fini(struct m0_stob_ioq *ioq)
+{
+	struct io_uring_sqe *sqe;
+	int                  rc;
+
+	/* All I/O is complete at this point, submission queue is empty. */
+	ioq_queue_lock(ioq);
+	ioq->ioq_uring_stop = true;
+	sqe = io_uring_get_sqe(&ioq->ioq_uring);
+	M0_ASSERT(sqe != NULL);
+	io_uring_prep_nop(sqe);
+	io_uring_sqe_set_data(sqe, NULL);
+	rc = io_uring_submit(&ioq->ioq_uring);
+	M0_ASSERT(rc == 1);
+	ioq_queue_unlock(ioq);
+	m0_thread_join(&ioq->ioq_thread[0]);
+	io_uring_queue_exit(&ioq->ioq_uring);
+}
+
+static bool ioq_uring_available(void)
+{
+	struct io_uring ring;
+	bool            result;
+
+	if (io_uring_queue_init(1, &ring, 0) != 0)
+		return false;
+	result = ring.features & IORING_FEAT_EXT_ARG;
+	io_uring_queue_exit(&ring);
+	return result;
+}
+
+#else /* !ENABLE_IO_URING */
+
+static void ioq_uring_submit(struct m0_stob_ioq *ioq)
+{
+	M0_IMPOSSIBLE("Built without io_uring support.");
+}
+
+static int ioq_uring_init(struct m0_stob_ioq *ioq)
+{
+	return M0_ERR_INFO(-ENOSYS, "Built without io_uring support.");
+}
+
+static void ioq_uring_fini(struct m0_stob_ioq *ioq)
+{
+	M0_IMPOSSIBLE("Built without io_uring support.");
+}
+
+static bool ioq_uring_available(void)
+{
+	return false;
+}
+
+#endif /* ENABLE_IO_URING */
+
+static int ioq_aio_init(struct m0_stob_ioq *ioq)
+{
+	int result;
+	int i;
 
 	result = io_setup(M0_STOB_IOQ_RING_SIZE, &ioq->ioq_ctx);
 	if (result == 0) {
@@ -705,30 +968,119 @@ M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq)
 						"ioq_thread%d", i);
 			if (result != 0)
 				break;
-			m0_stob_ioq_directio_setup(ioq, false);
 		}
 	}
-	if (result != 0)
-		m0_stob_ioq_fini(ioq);
 	return result;
 }
 
-M0_INTERNAL void m0_stob_ioq_fini(struct m0_stob_ioq *ioq)
+static void ioq_aio_fini(struct m0_stob_ioq *ioq)
 {
 	int i;
 
-	for (i = 0; i < ARRAY_SIZE(ioq->ioq_stop_timer); ++i)
-		m0_timer_start(&ioq->ioq_stop_timer[i], M0_TIME_IMMEDIATELY);
+	for (i = 0; i < ARRAY_SIZE(ioq->ioq_thread); ++i) {
+		if (ioq->ioq_thread[i].t_func != NULL)
+			m0_timer_start(&ioq->ioq_stop_timer[i],
+				       M0_TIME_IMMEDIATELY);
+	}
 	for (i = 0; i < ARRAY_SIZE(ioq->ioq_thread); ++i) {
 		if (ioq->ioq_thread[i].t_func != NULL)
 			m0_thread_join(&ioq->ioq_thread[i]);
 	}
 	if (ioq->ioq_ctx != NULL)
 		io_destroy(ioq->ioq_ctx);
+}
+
+M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq,
+				 enum m0_stob_ioq_backend backend)
+{
+	int result;
+
+	M0_PRE(M0_IN(backend, (M0_STOB_IOQ_AIO, M0_STOB_IOQ_URING)));
+
+	ioq->ioq_ctx      = NULL;
+	m0_atomic64_set(&ioq->ioq_avail, M0_STOB_IOQ_RING_SIZE);
+	ioq->ioq_queued   = 0;
+	m0_stob_ioq_directio_setup(ioq, false);
+
+	m0_queue_init(&ioq->ioq_queue);
+	m0_mutex_init(&ioq->ioq_lock);
+
+	if (backend == M0_STOB_IOQ_URING) {
+		result = ioq_uring_init(ioq);
+		if (result != 0)
+			M0_LOG(M0_WARN, "io_uring is not available (rc=%d), "
+			       "falling back to AIO.", result);
+		backend = result == 0 ? M0_STOB_IOQ_URING : M0_STOB_IOQ_AIO;
+	}
+	ioq->ioq_backend = backend;
+	result = backend == M0_STOB_IOQ_AIO ? ioq_aio_init(ioq) : 0;
+	if (result != 0)
+		m0_stob_ioq_fini(ioq);
+	return result;
+}
+
+M0_INTERNAL bool m0_stob_ioq_uring_available(void)
+{
+	return ioq_uring_available();
+}
+
+M0_INTERNAL void m0_stob_ioq_fini(struct m0_stob_ioq *ioq)
+{
+	if (ioq->ioq_backend == M0_STOB_IOQ_URING)
+		ioq_uring_fini(ioq);
+	else
+		ioq_aio_fini(ioq);
 	m0_queue_fini(&ioq->ioq_queue);
 	m0_mutex_fini(&ioq->ioq_lock);
 }
 
+M0_INTERNAL int m0_stob_ioq_file_register(struct m0_stob_ioq *ioq, int fd)
+{
+	int idx = -1;
+#ifdef ENABLE_IO_URING
+	int rc;
+	int i;
+
+	if (ioq->ioq_backend != M0_STOB_IOQ_URING)
+		return -1;
+	ioq_queue_lock(ioq);
+	for (i = 0; i < ARRAY_SIZE(ioq->ioq_files); ++i) {
+		if (ioq->ioq_files[i] != -1)
+			continue;
+		rc = io_uring_register_files_update(&ioq->ioq_uring, i, &fd, 1);
+		if (rc == 1) {
+			ioq->ioq_files[i] = fd;
+			idx = i;
+		} else
+			M0_LOG(M0_WARN, "fd=%d rc=%d", fd, rc);
+		break;
+	}
+	ioq_queue_unlock(ioq);
+#endif
+	return idx;
+}
+
+M0_INTERNAL void m0_stob_ioq_file_deregister(struct m0_stob_ioq *ioq, int idx)
+{
+#ifdef ENABLE_IO_URING
+	int fd = -1;
+	int rc;
+
+	M0_PRE(ioq->ioq_backend == M0_STOB_IOQ_URING);
+	M0_PRE(idx >= 0 && idx < ARRAY_SIZE(ioq->ioq_files));
+
+	ioq_queue_lock(ioq);
+	/* Fragments in flight keep their own references to the file. */
+	rc = io_uring_register_files_update(&ioq->ioq_uring, idx, &fd, 1);
+	if (rc != 1)
+		M0_LOG(M0_WARN, "idx=%d rc=%d", idx, rc);
+	ioq->ioq_files[idx] = -1;
+	ioq_queue_unlock(ioq);
+#else
+	M0_IMPOSSIBLE("Built without io_uring support.");
+#endif
+}
+
 M0_INTERNAL uint32_t m0_stob_ioq_bshift(struct m0_stob_ioq *ioq)
 {
 	return ioq->ioq_use_directio ? STOB_IOQ_BSHIFT : 0;
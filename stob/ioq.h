@@ -26,6 +26,9 @@
 #define __MOTR_STOB_IOQ_H__
 
 #include <libaio.h>        /* io_context_t */
+#ifdef ENABLE_IO_URING
+#include <liburing.h>      /* io_uring */
+#endif
 
 #include "lib/types.h"     /* bool */
 #include "lib/atomic.h"    /* m0_atomic64 */
@@ -43,6 +46,7 @@
 
 struct m0_stob;
 struct m0_stob_io;
+struct m0_bufvec;
 
 enum {
 	/** Default number of threads to create in a storage object domain. */
@@ -55,6 +59,21 @@ enum {
 	/** Size of a batch in which completion events are extracted from the
 	    ring buffer. */
 	M0_STOB_IOQ_BATCH_OUT_SIZE = 8,
+	/** Size of io_uring registered files table. */
+	M0_STOB_IOQ_URING_FILES_NR = 1024,
+};
+
+/** I/O submission back-end of a storage object domain. */
+enum m0_stob_ioq_backend {
+	/** Linux AIO, io_submit(2) and M0_STOB_IOQ_NR_THREADS threads. */
+	M0_STOB_IOQ_AIO,
+	/**
+	 * io_uring: fragments are submitted in batches from the launching
+	 * thread, completions are reaped by a single thread. Falls back to
+	 * M0_STOB_IOQ_AIO if motr is built without liburing or the kernel
+	 * doesn't support io_uring.
+	 */
+	M0_STOB_IOQ_URING,
 };
 
 struct m0_stob_ioq {
@@ -64,6 +83,8 @@ struct m0_stob_ioq {
 	 *  Initial value is set to 'false'.
 	 */
 	bool                     ioq_use_directio;
+	/** Back-end used by this ioq, set by m0_stob_ioq_init(). */
+	enum m0_stob_ioq_backend ioq_backend;
 	/** Set up when domain is being shut down. adieu worker threads
 	    (ioq_thread()) check this field on each iteration. */
 	/**
@@ -89,10 +110,29 @@ struct m0_stob_ioq {
 	struct m0_semaphore      ioq_stop_sem[M0_STOB_IOQ_NR_THREADS];
 	struct m0_timer          ioq_stop_timer[M0_STOB_IOQ_NR_THREADS];
 	struct m0_timer_locality ioq_stop_timer_loc[M0_STOB_IOQ_NR_THREADS];
+#ifdef ENABLE_IO_URING
+	/**
+	 * io_uring instance used with M0_STOB_IOQ_URING back-end. Submission
+	 * queue is protected by ioq_lock, completion queue is only accessed by
+	 * ioq_thread[0].
+	 */
+	struct io_uring          ioq_uring;
+	/** Set by m0_stob_ioq_fini() to stop the completion thread. */
+	bool                     ioq_uring_stop;
+	/** Registered files table, -1 marks a free slot. */
+	int                      ioq_files[M0_STOB_IOQ_URING_FILES_NR];
+#endif
 };
 
-M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq);
+M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq,
+				 enum m0_stob_ioq_backend backend);
 M0_INTERNAL void m0_stob_ioq_fini(struct m0_stob_ioq *ioq);
+/**
+ * Returns true if M0_STOB_IOQ_URING back-end can be used: motr is built with
+ * io_uring support and the kernel provides the required features. Otherwise
+ * m0_stob_ioq_init() falls back to M0_STOB_IOQ_AIO.
+ */
+M0_INTERNAL bool m0_stob_ioq_uring_available(void);
 M0_INTERNAL void m0_stob_ioq_directio_setup(struct m0_stob_ioq *ioq,
 					    bool use_directio);
 
@@ -101,6 +141,15 @@ M0_INTERNAL uint32_t m0_stob_ioq_bshift(struct m0_stob_ioq *ioq);
 M0_INTERNAL m0_bcount_t m0_stob_ioq_bsize(struct m0_stob_ioq *ioq);
 M0_INTERNAL m0_bcount_t m0_stob_ioq_bmask(struct m0_stob_ioq *ioq);
 
+/**
+ * Adds fd to the registered files table of io_uring back-end.
+ *
+ * @return index of fd in the table or -1 if the table is full or the back-end
+ * doesn't use registered files. In the latter case fd is used as is.
+ */
+M0_INTERNAL int m0_stob_ioq_file_register(struct m0_stob_ioq *ioq, int fd);
+M0_INTERNAL void m0_stob_ioq_file_deregister(struct m0_stob_ioq *ioq, int idx);
+
 M0_INTERNAL int m0_stob_linux_io_init(struct m0_stob *stob,
 				      struct m0_stob_io *io);
 
@@ -71,6 +71,11 @@
    somewhere in str_cfg_init for m0_stob_domain_init() or
    m0_stob_domain_create().
 
+   <b>I/O back-end</b>
+
+   By default I/O is submitted through Linux AIO. "ioq=uring" in str_cfg_init
+   selects io_uring back-end (M0_STOB_IOQ_URING), see stob/ioq.c.
+
    <b>Symlinks</b>
 
    To make stob pointing to other file on the filesystem just pass filename
@@ -196,10 +201,13 @@ static int stob_linux_domain_cfg_init_parse(const char *str_cfg_init,
 			.sldc_file_mode	   = 0700,
 			.sldc_file_flags   = 0,
 			.sldc_use_directio = false,
+			.sldc_ioq_backend  = M0_STOB_IOQ_AIO,
 		};
 		if (str_cfg_init != NULL) {
 			cfg->sldc_use_directio = strstr(str_cfg_init,
 						"directio=true") != NULL;
+			if (strstr(str_cfg_init, "ioq=uring") != NULL)
+				cfg->sldc_ioq_backend = M0_STOB_IOQ_URING;
 		}
 	}
 	if (rc == 0)
@@ -246,7 +254,8 @@ static int stob_linux_domain_init(struct m0_stob_type *type,
 
 	rc = rc ?: stob_linux_domain_key_get_set(path, &dom_key, true);
 	rc = rc ?: m0_stob_domain__dom_key_is_valid(dom_key) ? 0 : -EINVAL;
-	rc = rc ?: m0_stob_ioq_init(&ldom->sld_ioq);
+	rc = rc ?: m0_stob_ioq_init(&ldom->sld_ioq,
+				    ldom->sld_cfg.sldc_ioq_backend);
 	if (rc == 0) {
 		m0_stob_ioq_directio_setup(&ldom->sld_ioq,
 					   ldom->sld_cfg.sldc_use_directio);
@@ -387,6 +396,7 @@ static int stob_linux_open(struct m0_stob *stob,
 
 	stob->so_ops = &stob_linux_ops;
 	lstob->sl_dom = ldom;
+	lstob->sl_fd_idx = -1;
 
 	file_stob = stob_linux_file_stob(ldom->sld_path, stob_fid);
 	if (file_stob == NULL)
@@ -399,6 +409,8 @@ static int stob_linux_open(struct m0_stob *stob,
 	lstob->sl_fd = rc ?: open(file_stob, flags,
 				  ldom->sld_cfg.sldc_file_mode);
 	rc = lstob->sl_fd == -1 ? -errno : stob_linux_stat(lstob);
+	lstob->sl_fd_idx = rc == 0 ?
+		m0_stob_ioq_file_register(&ldom->sld_ioq, lstob->sl_fd) : -1;
 
 	m0_free(file_stob);
 
@@ -416,6 +428,11 @@ static void stob_linux_close(struct m0_stob_linux *lstob)
 {
 	int rc;
 
+	if (lstob->sl_fd_idx != -1) {
+		m0_stob_ioq_file_deregister(&lstob->sl_dom->sld_ioq,
+					    lstob->sl_fd_idx);
+		lstob->sl_fd_idx = -1;
+	}
 	if (lstob->sl_fd != -1) {
 		rc = close(lstob->sl_fd);
 		M0_ASSERT(rc == 0);
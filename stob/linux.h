@@ -42,6 +42,8 @@ struct m0_stob_linux_domain_cfg {
 	mode_t sldc_file_mode;
 	int    sldc_file_flags;
 	bool   sldc_use_directio;
+	/** "ioq=uring" in init configuration selects M0_STOB_IOQ_URING. */
+	enum m0_stob_ioq_backend sldc_ioq_backend;
 };
 
 struct m0_stob_linux_domain {
@@ -58,6 +60,8 @@ struct m0_stob_linux {
 	struct m0_stob_linux_domain *sl_dom;
 	/** fd from returned open(2) */
 	int			     sl_fd;
+	/** index of sl_fd in ioq registered files table, or -1 */
+	int			     sl_fd_idx;
 	/** file mode as returned by stat(2) */
 	mode_t			     sl_mode;
 	/** fid of the corresponding m0_conf_sdev object */
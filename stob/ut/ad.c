@@ -526,6 +526,48 @@ static void test_ad_rw_unordered()
 	}
 }
 
+/**
+   Coalescing of adjacent segments: write credit does not depend on how a
+   contiguous range is split into segments, data is written correctly.
+ */
+static void test_ad_coalesce(void)
+{
+	struct m0_be_tx_credit split = {};
+	struct m0_be_tx_credit whole = {};
+	struct m0_be_tx_credit apart = {};
+	int                    i;
+
+	init_vecs();
+	m0_stob_io_init(&io);
+	io.si_opcode = SIO_WRITE;
+	io.si_user.ov_vec.v_nr = NR;
+	io.si_user.ov_vec.v_count = user_vc;
+	io.si_user.ov_buf = (void **)user_bufs;
+	io.si_stob.iv_vec.v_nr = NR;
+	io.si_stob.iv_vec.v_count = stob_vc;
+	io.si_stob.iv_index = stob_vi;
+	/* Sparse segments, as set by init_vecs(). */
+	m0_stob_io_credit(&io, dom_fore, &apart);
+	for (i = 0; i < NR; ++i)
+		stob_vi[i] = (buf_size * i) >> block_shift;
+	m0_stob_io_credit(&io, dom_fore, &split);
+	stob_vc[0] = (buf_size * NR) >> block_shift;
+	io.si_user.ov_vec.v_nr = 1;
+	io.si_stob.iv_vec.v_nr = 1;
+	m0_stob_io_credit(&io, dom_fore, &whole);
+	m0_stob_io_fini(&io);
+	M0_UT_ASSERT(m0_be_tx_credit_eq(&split, &whole));
+	M0_UT_ASSERT(split.tc_reg_nr < apart.tc_reg_nr);
+
+	init_vecs();
+	for (i = 0; i < NR; ++i)
+		stob_vi[i] = (buf_size * i) >> block_shift;
+	test_write(NR, NULL);
+	test_read(NR);
+	for (i = 0; i < NR; ++i)
+		M0_ASSERT(memcmp(user_buf[i], read_buf[i], buf_size) == 0);
+}
+
 /**
    AD unit-test.
  */
@@ -616,6 +658,7 @@ void m0_stob_ut_adieu_ad(void)
 	M0_ASSERT(rc == 0);
 	test_ad();
 	test_ad_rw_unordered();
+	test_ad_coalesce();
 	test_ad_undo();
 	rc = test_ad_fini();
 	M0_ASSERT(rc == 0);
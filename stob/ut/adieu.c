@@ -19,6 +19,9 @@
  */
 
 
+#define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_UT
+#include "lib/trace.h"
+
 #include <stdlib.h>    /* system */
 #include <stdio.h>     /* fopen, fgetc, ... */
 #include <unistd.h>    /* unlink */
@@ -82,6 +85,7 @@ static uint32_t block_shift;
 static uint32_t buf_size;
 
 static int test_adieu_init(const char *location,
+			   const char *dom_init_cfg,
 			   const char *dom_cfg,
 			   const char *stob_cfg)
 {
@@ -90,8 +94,8 @@ static int test_adieu_init(const char *location,
 	struct m0_stob_id stob_id;
 	char   cs_char = 'a';
 
-	rc = m0_stob_domain_create(location,
-				   NULL, M0_STOB_UT_DOMAIN_KEY, dom_cfg, &dom);
+	rc = m0_stob_domain_create(location, dom_init_cfg,
+				   M0_STOB_UT_DOMAIN_KEY, dom_cfg, &dom);
 	M0_ASSERT(rc == 0);
 	M0_ASSERT(dom != NULL);
 
@@ -297,7 +301,21 @@ void m0_stob_ut_adieu_linux(void)
 {
 	int rc;
 
-	rc = test_adieu_init(linux_location, NULL, NULL);
+	rc = test_adieu_init(linux_location, NULL, NULL, NULL);
+	M0_ASSERT(rc == 0);
+	test_adieu(linux_path);
+	test_adieu_fini();
+}
+
+void m0_stob_ut_adieu_linux_uring(void)
+{
+	int rc;
+
+	if (!m0_ut_stob_uring_available()) {
+		M0_LOG(M0_WARN, "io_uring is not available, test skipped.");
+		return;
+	}
+	rc = test_adieu_init(linux_location, "ioq=uring", NULL, NULL);
 	M0_ASSERT(rc == 0);
 	test_adieu(linux_path);
 	test_adieu_fini();
@@ -307,7 +325,7 @@ void m0_stob_ut_adieu_perf(void)
 {
 	int rc;
 
-	rc = test_adieu_init(perf_location, NULL, NULL);
+	rc = test_adieu_init(perf_location, NULL, NULL, NULL);
 	M0_ASSERT(rc == 0);
 	test_adieu(perf_path);
 	test_adieu_fini();
@@ -382,9 +400,10 @@ static void ub_iovec_sort_invert()
 	m0_stob_iovec_sort(&io);
 }
 
-static int ub_init(const char *opts M0_UNUSED)
+/* opts are passed as domain init configuration, e.g. "ioq=uring". */
+static int ub_init(const char *opts)
 {
-	return test_adieu_init(linux_location, NULL, NULL);
+	return test_adieu_init(linux_location, opts, NULL, NULL);
 }
 
 static void ub_fini(void)
@@ -440,6 +459,8 @@ struct m0_ub_set m0_adieu_ub = {
 
 /** @} end group stob */
 
+#undef M0_TRACE_SUBSYSTEM
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
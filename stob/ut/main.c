@@ -34,6 +34,8 @@ extern void m0_stob_ut_stob_domain_linux(void);
 extern void m0_stob_ut_stob_linux(void);
 extern void m0_stob_ut_adieu_linux(void);
 extern void m0_stob_ut_stobio_linux(void);
+extern void m0_stob_ut_adieu_linux_uring(void);
+extern void m0_stob_ut_stobio_linux_uring(void);
 extern void m0_stob_ut_stob_domain_perf(void);
 extern void m0_stob_ut_stob_domain_perf_null(void);
 extern void m0_stob_ut_stob_perf(void);
@@ -58,6 +60,8 @@ struct m0_ut_suite stob_ut = {
 		{ "linux-stob",		m0_stob_ut_stob_linux		},
 		{ "linux-adieu",	m0_stob_ut_adieu_linux		},
 		{ "linux-stobio",	m0_stob_ut_stobio_linux		},
+		{ "linux-adieu-uring",	m0_stob_ut_adieu_linux_uring	},
+		{ "linux-stobio-uring",	m0_stob_ut_stobio_linux_uring	},
 		{ "perf-stob-domain",	m0_stob_ut_stob_domain_perf	},
 		{ "perf-stob-domain-null", m0_stob_ut_stob_domain_perf_null },
 		{ "perf-stob",		m0_stob_ut_stob_perf		},
@@ -19,6 +19,9 @@
  */
 
 
+#define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_UT
+#include "lib/trace.h"
+
 #include <stdlib.h>             /* system */
 
 #include "lib/arith.h"          /* max_check */
@@ -86,6 +89,8 @@ static const char test_blkdev[] = "/dev/loop0";
 
 static const char *test_location;
 static const char *test_location_dio;
+static const char *test_init_cfg;
+static const char *test_init_cfg_dio;
 static const char linux_location[] = "linuxstob:./__s_stob";
 static const char linux_location_dio[] = "linuxstob:./__s_dio";
 static const char perf_location[] = "perfstob:./__s";
@@ -314,14 +319,15 @@ static int stobio_storage_init(void)
 
 	M0_PRE(test_location != NULL && test_location_dio != NULL);
 
-	result = m0_stob_domain_create(test_location, NULL, M0_STOB_UT_DOM_KEY,
-				       NULL, &test_dom);
+	result = m0_stob_domain_create(test_location, test_init_cfg,
+				       M0_STOB_UT_DOM_KEY, NULL, &test_dom);
 	M0_UT_ASSERT(result == 0);
 	M0_UT_ASSERT(test_dom != NULL);
 
 	result = m0_stob_domain_create(test_location_dio,
-				       "directio=true", M0_STOB_UT_DOM_DIO_KEY,
-				       NULL, &test_dom_dio);
+				       test_init_cfg_dio ?: "directio=true",
+				       M0_STOB_UT_DOM_DIO_KEY, NULL,
+				       &test_dom_dio);
 	M0_UT_ASSERT(result == 0);
 	M0_UT_ASSERT(test_dom_dio != NULL);
 
@@ -621,6 +627,25 @@ void m0_stob_ut_stobio_linux(void)
 	test_location = test_location_dio = NULL;
 }
 
+void m0_stob_ut_stobio_linux_uring(void)
+{
+	if (!m0_ut_stob_uring_available()) {
+		M0_LOG(M0_WARN, "io_uring is not available, test skipped.");
+		return;
+	}
+	test_location = linux_location;
+	test_location_dio = linux_location_dio;
+	test_init_cfg = "ioq=uring";
+	test_init_cfg_dio = "directio=true ioq=uring";
+
+	test_stobio();
+	test_short_read();
+	test_single_ivec();
+
+	test_location = test_location_dio = NULL;
+	test_init_cfg = test_init_cfg_dio = NULL;
+}
+
 void m0_stob_ut_stobio_perf(void)
 {
 	test_location = perf_location;
@@ -633,6 +658,8 @@ void m0_stob_ut_stobio_perf(void)
 	test_location = test_location_dio = NULL;
 }
 
+#undef M0_TRACE_SUBSYSTEM
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
@@ -32,7 +32,15 @@
 extern struct m0_ub_set m0_ad_ub;
 extern struct m0_ub_set m0_adieu_ub;
 extern struct m0_ub_set m0_atomic_ub;
+extern struct m0_ub_set m0_balloc_ub;
+extern struct m0_ub_set m0_be_alloc_ub;
+extern struct m0_ub_set m0_be_recovery_ub;
 extern struct m0_ub_set m0_bitmap_ub;
+extern struct m0_ub_set m0_btree_ub;
+extern struct m0_ub_set m0_cas_ub;
+extern struct m0_ub_set m0_cksum_ub;
+extern struct m0_ub_set m0_fd_ub;
+extern struct m0_ub_set m0_fdmi_flt_ub;
 extern struct m0_ub_set m0_fol_ub;
 extern struct m0_ub_set m0_fom_ub;
 extern struct m0_ub_set m0_list_ub;
@@ -40,12 +48,14 @@ extern struct m0_ub_set m0_memory_ub;
 extern struct m0_ub_set m0_parity_math_ub;
 extern struct m0_ub_set m0_parity_math_mt_ub;
 //extern struct m0_ub_set m0_rpc_ub;
+extern struct m0_ub_set m0_rpc_frm_ub;
 extern struct m0_ub_set m0_thread_ub;
 extern struct m0_ub_set m0_time_ub;
 extern struct m0_ub_set m0_timer_ub;
 extern struct m0_ub_set m0_tlist_ub;
 extern struct m0_ub_set m0_trace_ub;
 extern struct m0_ub_set m0_varr_ub;
+extern struct m0_ub_set m0_xcode_ub;
 
 #define UB_SANDBOX "./ub-sandbox"
 
@@ -99,12 +109,14 @@ static void ub_add(const struct ub_args *args)
 	 * These benchmarks are executed in reverse order from the way
 	 * they are listed here.
 	 */
+	m0_ub_set_add(&m0_xcode_ub);
 	m0_ub_set_add(&m0_varr_ub);
 	m0_ub_set_add(&m0_trace_ub);
 	m0_ub_set_add(&m0_tlist_ub);
 	m0_ub_set_add(&m0_timer_ub);
 	m0_ub_set_add(&m0_time_ub);
 	m0_ub_set_add(&m0_thread_ub);
+	m0_ub_set_add(&m0_rpc_frm_ub);
 //	m0_ub_set_add(&m0_rpc_ub);
 	m0_ub_set_add(&m0_parity_math_mt_ub);
 	m0_ub_set_add(&m0_parity_math_ub);
@@ -112,6 +124,14 @@ static void ub_add(const struct ub_args *args)
 	m0_ub_set_add(&m0_list_ub);
 	m0_ub_set_add(&m0_fom_ub);
 	m0_ub_set_add(&m0_fol_ub);
+	m0_ub_set_add(&m0_fdmi_flt_ub);
+	m0_ub_set_add(&m0_fd_ub);
+	m0_ub_set_add(&m0_cas_ub);
+	m0_ub_set_add(&m0_btree_ub);
+	m0_ub_set_add(&m0_cksum_ub);
+	m0_ub_set_add(&m0_be_recovery_ub);
+	m0_ub_set_add(&m0_be_alloc_ub);
+	m0_ub_set_add(&m0_balloc_ub);
 //XXX_BE_DB 	m0_ub_set_add(&m0_bitmap_ub);
 //XXX_BE_DB 	m0_ub_set_add(&m0_atomic_ub);
 	m0_ub_set_add(&m0_adieu_ub);
@@ -173,6 +173,7 @@ extern struct m0_ut_suite storage_dev_ut;
 extern struct m0_ut_suite udb_ut;
 extern struct m0_ut_suite xcode_bufvec_fop_ut;
 extern struct m0_ut_suite xcode_ff2c_ut;
+extern struct m0_ut_suite xcode_gen_ut;
 extern struct m0_ut_suite xcode_ut;
 extern struct m0_ut_suite sns_flock_ut;
 extern struct m0_ut_suite ut_suite_pi;
@@ -323,6 +324,7 @@ static void tests_add(struct m0_ut_module *m)
 	m0_ut_add(m, &udb_ut, true);
 	m0_ut_add(m, &xcode_bufvec_fop_ut, true);
 	m0_ut_add(m, &xcode_ff2c_ut, true);
+	m0_ut_add(m, &xcode_gen_ut, true);
 	m0_ut_add(m, &xcode_ut, true);
 	m0_ut_add(m, &ut_suite_pi, true);
 
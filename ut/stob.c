@@ -37,6 +37,9 @@
 
 #include "stob/domain.h"	/* m0_stob_domain */
 #include "stob/stob.h"		/* m0_stob_find */
+#ifndef __KERNEL__
+#include "stob/ioq.h"		/* m0_stob_ioq_uring_available */
+#endif
 
 /**
  * @addtogroup utstob
@@ -332,6 +335,15 @@ M0_INTERNAL int m0_ut_stob_destroy_by_stob_id(struct m0_stob_id *stob_id)
 	return rc;
 }
 
+M0_INTERNAL bool m0_ut_stob_uring_available(void)
+{
+#ifndef __KERNEL__
+	return m0_stob_ioq_uring_available();
+#else
+	return false;
+#endif
+}
+
 M0_INTERNAL struct m0_dtx *m0_ut_dtx_open(struct m0_be_tx_credit *cred,
 					  struct m0_be_domain    *be_dom)
 {
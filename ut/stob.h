@@ -71,6 +71,9 @@ M0_INTERNAL int m0_ut_stob_create_by_stob_id(struct m0_stob_id *stob_id,
 					     const char *str_cfg);
 M0_INTERNAL int m0_ut_stob_destroy_by_stob_id(struct m0_stob_id *stob_id);
 
+/** Returns true if linux stob domains can use io_uring back-end. */
+M0_INTERNAL bool m0_ut_stob_uring_available(void);
+
 /* XXX move somewhere else */
 M0_INTERNAL struct m0_dtx *m0_ut_dtx_open(struct m0_be_tx_credit *cred,
 					  struct m0_be_domain    *be_dom);
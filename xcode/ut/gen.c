@@ -0,0 +1,478 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+/*
+ * Generated encoders/decoders (m0_xcode_type::xct_gen) are checked against
+ * the interpretive xcode walk: for every test object both must produce the
+ * same byte stream and decode it into equal objects.
+ */
+
+#include "lib/errno.h"                      /* EPROTO */
+#include "lib/memory.h"
+#include "lib/vec.h"                        /* m0_bufvec */
+#include "lib/misc.h"                       /* M0_SET0 */
+#include "lib/string.h"                     /* memcmp */
+#include "lib/ub.h"
+#include "ut/ut.h"
+
+#include "xcode/xcode.h"
+#include "fid/fid.h"
+#include "fid/fid_xc.h"
+#include "lib/buf_xc.h"
+#include "cas/cas.h"
+#include "cas/cas_xc.h"
+#include "ioservice/io_fops.h"
+#include "ioservice/io_fops_xc.h"
+#include "xcode/ut/test_gccxml_simple.h"
+#include "xcode/ut/test_gccxml_simple_xc.h"
+
+enum {
+	GEN_UT_SEG_SIZE = 7,
+	GEN_UT_REC_NR   = 2,
+	GEN_UT_SEG_NR   = 4,
+	GEN_UB_REC_NR   = 16,
+	GEN_UB_SEG_NR   = 64,
+	GEN_UB_ITER     = 100000
+};
+
+/** Encodes and decodes an object in the current (walk or generated) mode. */
+static void gen_roundtrip(const struct m0_xcode_type *xt, void *ptr,
+			  void **buf, m0_bcount_t *len, void **out)
+{
+	struct m0_xcode_obj obj = M0_XCODE_OBJ(xt, ptr);
+	struct m0_xcode_obj dec = M0_XCODE_OBJ(xt, NULL);
+	int                 rc;
+
+	rc = m0_xcode_obj_enc_to_buf(&obj, buf, len);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_xcode_obj_dec_from_buf(&dec, *buf, *len);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(dec.xo_ptr != NULL);
+	M0_UT_ASSERT(m0_xcode_cmp(&obj, &dec) == 0);
+	*out = dec.xo_ptr;
+}
+
+/**
+ * Encodes and decodes the object through a bufvec with small segments, so
+ * that generated code takes its slow (segment-crossing) path.
+ */
+static void gen_segmented(const struct m0_xcode_type *xt, void *ptr,
+			  const void *flat, m0_bcount_t len)
+{
+	struct m0_xcode_obj     obj = M0_XCODE_OBJ(xt, ptr);
+	struct m0_xcode_obj     dec = M0_XCODE_OBJ(xt, NULL);
+	struct m0_bufvec        bv;
+	struct m0_bufvec_cursor cur;
+	void                   *copy;
+	int                     rc;
+
+	rc = m0_bufvec_alloc(&bv, len / GEN_UT_SEG_SIZE + 1, GEN_UT_SEG_SIZE);
+	M0_UT_ASSERT(rc == 0);
+	m0_bufvec_cursor_init(&cur, &bv);
+	rc = m0_xcode_encdec(&obj, &cur, M0_XCODE_ENCODE);
+	M0_UT_ASSERT(rc == 0);
+
+	copy = m0_alloc(len);
+	M0_UT_ASSERT(copy != NULL);
+	m0_bufvec_cursor_init(&cur, &bv);
+	M0_UT_ASSERT(m0_bufvec_cursor_copyfrom(&cur, copy, len) == len);
+	M0_UT_ASSERT(memcmp(copy, flat, len) == 0);
+	m0_free(copy);
+
+	m0_bufvec_cursor_init(&cur, &bv);
+	rc = m0_xcode_encdec(&dec, &cur, M0_XCODE_DECODE);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_xcode_cmp(&obj, &dec) == 0);
+	m0_xcode_free_obj(&dec);
+	m0_bufvec_free(&bv);
+}
+
+/**
+ * Checks that generated and interpretive xcoding of the object agree.
+ */
+static void gen_check(const struct m0_xcode_type *xt, void *ptr)
+{
+	struct m0_xcode_ctx ctx;
+	struct m0_xcode_obj walk_dec;
+	struct m0_xcode_obj gen_dec;
+	void               *walk_buf;
+	void               *gen_buf;
+	m0_bcount_t         walk_len;
+	m0_bcount_t         gen_len;
+
+#ifdef ENABLE_XCODE_CODEC
+	M0_UT_ASSERT(xt->xct_gen != NULL);
+#endif
+	m0_xcode_gen_enable(false);
+	gen_roundtrip(xt, ptr, &walk_buf, &walk_len, &walk_dec.xo_ptr);
+	m0_xcode_gen_enable(true);
+	gen_roundtrip(xt, ptr, &gen_buf, &gen_len, &gen_dec.xo_ptr);
+	walk_dec.xo_type = gen_dec.xo_type = xt;
+
+	M0_UT_ASSERT(walk_len == gen_len);
+	M0_UT_ASSERT(m0_xcode_data_size(&ctx, &M0_XCODE_OBJ(xt, ptr)) ==
+		     gen_len);
+	M0_UT_ASSERT(memcmp(walk_buf, gen_buf, gen_len) == 0);
+	M0_UT_ASSERT(m0_xcode_cmp(&walk_dec, &gen_dec) == 0);
+	gen_segmented(xt, ptr, gen_buf, gen_len);
+
+	m0_xcode_free_obj(&walk_dec);
+	m0_xcode_free_obj(&gen_dec);
+	m0_free(walk_buf);
+	m0_free(gen_buf);
+}
+
+static void gen_ut_simple(void)
+{
+	struct m0_fid fid = M0_FID_INIT(0x1234, 0xdeadbeef);
+	char          data[] = "Bob Dylan";
+	struct m0_buf buf = M0_BUF_INIT(sizeof data, data);
+
+	gen_check(m0_fid_xc, &fid);
+	gen_check(m0_buf_xc, &buf);
+	buf = M0_BUF_INIT0;
+	gen_check(m0_buf_xc, &buf);
+}
+
+static void gen_ut_gccxml(void)
+{
+	struct optfid      of[3] = {
+		{ .o_flag = 1, .u = { .o_fid = M0_FID_INIT(7, 8) } },
+		{ .o_flag = 3, .u = { .o_short = 0x55aa } }
+	};
+	struct optfid      fa_data[NR];
+	struct optfidarray ofa = { .ofa_nr = ARRAY_SIZE(of), .ofa_data = of };
+	struct fixarray    fa  = { .fa_data = fa_data };
+	struct inlinearray ia  = {};
+	struct enumfield   ef  = {
+		.ef_0    = 1,
+		.ef_enum = TE_5,
+		.ef_bitm = BM_SIX | BM_NINE,
+		.ef_1    = 2
+	};
+	int                i;
+
+	for (i = 0; i < ARRAY_SIZE(of); ++i)
+		gen_check(optfid_xc, &of[i]);
+	gen_check(optfidarray_xc, &ofa);
+	ofa.ofa_nr = 0;
+	gen_check(optfidarray_xc, &ofa);
+	for (i = 0; i < NR; ++i)
+		fa_data[i] = of[i % ARRAY_SIZE(of)];
+	gen_check(fixarray_xc, &fa);
+	for (i = 0; i < ARRAY_SIZE(ia.ia_bugs); ++i) {
+		ia.ia_bugs[i].tt_char = 'a' + i;
+		ia.ia_bugs[i].tt_int  = -i;
+		ia.ia_bugs[i].tt_ll   = 1ULL << (i * 8);
+		ia.ia_bugs[i].tt_ui   = ~i;
+	}
+	gen_check(testtypes_xc, &ia.ia_bugs[1]);
+	gen_check(inlinearray_xc, &ia);
+	gen_check(enumfield_xc, &ef);
+}
+
+/** Union discriminator that matches no arm. */
+static void gen_ut_union_tag(void)
+{
+	struct optfid        of  = { .o_flag = 2 };
+	struct optfid        dec = {};
+	struct m0_xcode_obj  obj = M0_XCODE_OBJ(optfid_xc, &of);
+	struct m0_xcode_obj  out = M0_XCODE_OBJ(optfid_xc, &dec);
+	struct m0_xcode_ctx  ctx;
+	void                *buf;
+	m0_bcount_t          len;
+	int                  rc;
+
+	/* The walk sends only the discriminator. */
+	m0_xcode_gen_enable(false);
+	rc = m0_xcode_obj_enc_to_buf(&obj, &buf, &len);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(len == sizeof of.o_flag);
+	m0_xcode_gen_enable(true);
+	rc = m0_xcode_data_size(&ctx, &obj);
+#ifdef ENABLE_XCODE_CODEC
+	/* Generated code rejects it both ways. */
+	M0_UT_ASSERT(rc == -EPROTO);
+	rc = m0_xcode_obj_enc_to_buf(&obj, &buf, &len);
+	M0_UT_ASSERT(rc == -EPROTO);
+	rc = m0_xcode_obj_dec_from_buf(&out, buf, len);
+	M0_UT_ASSERT(rc == -EPROTO);
+#else
+	M0_UT_ASSERT(rc == len);
+	rc = m0_xcode_obj_dec_from_buf(&out, buf, len);
+	M0_UT_ASSERT(rc == 0 && dec.o_flag == of.o_flag);
+#endif
+	m0_free(buf);
+}
+
+static char gen_key[] = "key-0123456789";
+static char gen_val[] = "value-0123456789abcdef";
+
+static void gen_cas_op_fill(struct m0_cas_op *op, struct m0_cas_rec *rec,
+			    int nr)
+{
+	int i;
+
+	M0_SET0(op);
+	op->cg_id.ci_fid = M0_FID_TINIT('i', 1, 2);
+	op->cg_flags     = 0x5;
+	op->cg_rec.cr_nr  = nr;
+	op->cg_rec.cr_rec = rec;
+	for (i = 0; i < nr; ++i) {
+		M0_SET0(&rec[i]);
+		rec[i].cr_key.ab_type  = M0_RPC_AT_INLINE;
+		rec[i].cr_key.u.ab_buf = M0_BUF_INIT(sizeof gen_key - i,
+						      gen_key);
+		rec[i].cr_val.ab_type  = M0_RPC_AT_INLINE;
+		rec[i].cr_val.u.ab_buf = M0_BUF_INIT(sizeof gen_val, gen_val);
+		rec[i].cr_rc = i;
+	}
+}
+
+static void gen_cob_rw_fill(struct m0_fop_cob_rw *rw, struct m0_ioseg *seg,
+			    int nr)
+{
+	int i;
+
+	M0_SET0(rw);
+	rw->crw_gfid  = M0_FID_TINIT('r', 1, 10);
+	rw->crw_fid   = M0_FID_TINIT('c', 1, 11);
+	rw->crw_pver  = M0_FID_TINIT('v', 1, 12);
+	rw->crw_index = 3;
+	rw->crw_lid   = 1;
+	rw->crw_ivec.ci_nr     = nr;
+	rw->crw_ivec.ci_iosegs = seg;
+	for (i = 0; i < nr; ++i) {
+		seg[i].ci_index = i * 8192;
+		seg[i].ci_count = 4096;
+	}
+	rw->crw_di_data = M0_BUF_INIT(sizeof gen_val, gen_val);
+}
+
+static void gen_ut_fops(void)
+{
+	struct m0_cas_op     op;
+	struct m0_cas_rec    rec[GEN_UT_REC_NR];
+	struct m0_fop_cob_rw rw;
+	struct m0_ioseg      seg[GEN_UT_SEG_NR];
+
+	gen_cas_op_fill(&op, rec, ARRAY_SIZE(rec));
+	gen_check(m0_cas_op_xc, &op);
+	gen_cob_rw_fill(&rw, seg, ARRAY_SIZE(seg));
+	gen_check(m0_fop_cob_rw_xc, &rw);
+}
+
+static int gen_ut_init(void)
+{
+	m0_xc_xcode_ut_test_gccxml_simple_init();
+	return 0;
+}
+
+static int gen_ut_fini(void)
+{
+	m0_xcode_gen_enable(true);
+	return 0;
+}
+
+struct m0_ut_suite xcode_gen_ut = {
+	.ts_name = "xcode-gen-ut",
+	.ts_init = gen_ut_init,
+	.ts_fini = gen_ut_fini,
+	.ts_tests = {
+		{ "simple",    gen_ut_simple    },
+		{ "gccxml",    gen_ut_gccxml    },
+		{ "union-tag", gen_ut_union_tag },
+		{ "fops",      gen_ut_fops      },
+		{ NULL, NULL }
+	}
+};
+
+/*
+ * Benchmark: time per fop to encode, decode and size a CAS request and an
+ * io request, with the interpretive walk and with generated code.
+ */
+
+static struct m0_cas_op     ub_op;
+static struct m0_cas_rec    ub_rec[GEN_UB_REC_NR];
+static struct m0_fop_cob_rw ub_rw;
+static struct m0_ioseg      ub_seg[GEN_UB_SEG_NR];
+static char                 ub_buf[32 * 1024];
+static void                *ub_addr = ub_buf;
+static m0_bcount_t          ub_nob  = sizeof ub_buf;
+static struct m0_bufvec     ub_bv   = M0_BUFVEC_INIT_BUF(&ub_addr, &ub_nob);
+
+static int ub_init(const char *opts M0_UNUSED)
+{
+	gen_cas_op_fill(&ub_op, ub_rec, ARRAY_SIZE(ub_rec));
+	gen_cob_rw_fill(&ub_rw, ub_seg, ARRAY_SIZE(ub_seg));
+	return 0;
+}
+
+static void ub_fini(void)
+{
+	m0_xcode_gen_enable(true);
+}
+
+static void ub_xcode(const struct m0_xcode_type *xt, void *ptr,
+		     enum m0_xcode_what what, bool gen)
+{
+	struct m0_xcode_obj     obj = M0_XCODE_OBJ(xt, ptr);
+	struct m0_bufvec_cursor cur;
+	int                     rc;
+
+	m0_xcode_gen_enable(gen);
+	m0_bufvec_cursor_init(&cur, &ub_bv);
+	rc = m0_xcode_encdec(&obj, &cur, what);
+	M0_UB_ASSERT(rc == 0);
+	if (what == M0_XCODE_DECODE)
+		m0_xcode_free_obj(&obj);
+}
+
+static void ub_length(const struct m0_xcode_type *xt, void *ptr, bool gen)
+{
+	struct m0_xcode_ctx ctx;
+
+	m0_xcode_gen_enable(gen);
+	M0_UB_ASSERT(m0_xcode_data_size(&ctx, &M0_XCODE_OBJ(xt, ptr)) > 0);
+}
+
+/*
+ * Decode rounds use the buffer filled by the preceding encode round of the
+ * same fop type.
+ */
+static void ub_cas_enc_walk(int i)
+{
+	ub_xcode(m0_cas_op_xc, &ub_op, M0_XCODE_ENCODE, false);
+}
+
+static void ub_cas_enc_gen(int i)
+{
+	ub_xcode(m0_cas_op_xc, &ub_op, M0_XCODE_ENCODE, true);
+}
+
+static void ub_cas_dec_walk(int i)
+{
+	ub_xcode(m0_cas_op_xc, NULL, M0_XCODE_DECODE, false);
+}
+
+static void ub_cas_dec_gen(int i)
+{
+	ub_xcode(m0_cas_op_xc, NULL, M0_XCODE_DECODE, true);
+}
+
+static void ub_cas_len_walk(int i)
+{
+	ub_length(m0_cas_op_xc, &ub_op, false);
+}
+
+static void ub_cas_len_gen(int i)
+{
+	ub_length(m0_cas_op_xc, &ub_op, true);
+}
+
+static void ub_rw_enc_walk(int i)
+{
+	ub_xcode(m0_fop_cob_rw_xc, &ub_rw, M0_XCODE_ENCODE, false);
+}
+
+static void ub_rw_enc_gen(int i)
+{
+	ub_xcode(m0_fop_cob_rw_xc, &ub_rw, M0_XCODE_ENCODE, true);
+}
+
+static void ub_rw_dec_walk(int i)
+{
+	ub_xcode(m0_fop_cob_rw_xc, NULL, M0_XCODE_DECODE, false);
+}
+
+static void ub_rw_dec_gen(int i)
+{
+	ub_xcode(m0_fop_cob_rw_xc, NULL, M0_XCODE_DECODE, true);
+}
+
+static void ub_rw_len_walk(int i)
+{
+	ub_length(m0_fop_cob_rw_xc, &ub_rw, false);
+}
+
+static void ub_rw_len_gen(int i)
+{
+	ub_length(m0_fop_cob_rw_xc, &ub_rw, true);
+}
+
+struct m0_ub_set m0_xcode_ub = {
+	.us_name = "xcode-ub",
+	.us_init = ub_init,
+	.us_fini = ub_fini,
+	.us_run  = {
+		{ .ub_name  = "cas-enc-walk",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_cas_enc_walk },
+		{ .ub_name  = "cas-dec-walk",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_cas_dec_walk },
+		{ .ub_name  = "cas-len-walk",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_cas_len_walk },
+		{ .ub_name  = "cas-enc-gen",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_cas_enc_gen },
+		{ .ub_name  = "cas-dec-gen",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_cas_dec_gen },
+		{ .ub_name  = "cas-len-gen",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_cas_len_gen },
+		{ .ub_name  = "rw-enc-walk",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_rw_enc_walk },
+		{ .ub_name  = "rw-dec-walk",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_rw_dec_walk },
+		{ .ub_name  = "rw-len-walk",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_rw_len_walk },
+		{ .ub_name  = "rw-enc-gen",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_rw_enc_gen },
+		{ .ub_name  = "rw-dec-gen",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_rw_dec_gen },
+		{ .ub_name  = "rw-len-gen",
+		  .ub_iter  = GEN_UB_ITER,
+		  .ub_round = ub_rw_len_gen },
+		{ .ub_name = NULL }
+	}
+};
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
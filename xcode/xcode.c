@@ -377,19 +377,170 @@ M0_INTERNAL void m0_xcode_ctx_init(struct m0_xcode_ctx *ctx,
 	m0_xcode_cursor_init(&ctx->xcx_it, obj);
 }
 
+static bool xcode_gen_enabled = true;
+
+M0_INTERNAL void m0_xcode_gen_enable(bool enable)
+{
+	xcode_gen_enabled = enable;
+}
+
+M0_INTERNAL bool m0_xcode_gen_is_enabled(void)
+{
+	return xcode_gen_enabled;
+}
+
+static const enum m0_xcode_gen_op gen_op[XO_NR] = {
+	[XO_ENC] = M0_XGO_ENC,
+	[XO_DEC] = M0_XGO_DEC,
+	[XO_LEN] = M0_XGO_LEN
+};
+
+static const enum xcode_op walk_op[] = {
+	[M0_XGO_ENC] = XO_ENC,
+	[M0_XGO_DEC] = XO_DEC,
+	[M0_XGO_LEN] = XO_LEN
+};
+
+/** True iff custom xcoding functions of "xt" have to be used for "op". */
+static bool has_ops(const struct m0_xcode_type *xt, enum xcode_op op)
+{
+	const struct m0_xcode_type_ops *ops = xt->xct_ops;
+
+	return ops != NULL &&
+		((op == XO_ENC && ops->xto_encode != NULL) ||
+		 (op == XO_DEC && ops->xto_decode != NULL) ||
+		 (op == XO_LEN && ops->xto_length != NULL));
+}
+
+static bool ctx_gen(const struct m0_xcode_ctx *ctx, enum xcode_op op)
+{
+	const struct m0_xcode_type *xt = ctx->xcx_it.xcu_stack[0].s_obj.xo_type;
+
+	return xcode_gen_enabled && xt->xct_gen != NULL && !has_ops(xt, op) &&
+		ctx->xcx_it.xcu_depth == 0 &&
+		ctx->xcx_it.xcu_stack[0].s_flag == M0_XCODE_CURSOR_NONE &&
+		ctx->xcx_iter == NULL && ctx->xcx_iter_end == NULL &&
+		ergo(op == XO_DEC, ctx->xcx_alloc == &m0_xcode_alloc);
+}
+
+/**
+   Xcodes the whole object with the generated function of its type.
+
+   Leaves the cursor in the same state as ctx_walk() does: the top-most object
+   is the only one referenced from it.
+ */
+static int ctx_gen_run(struct m0_xcode_ctx *ctx, enum xcode_op op)
+{
+	struct m0_xcode_obj *top = &ctx->xcx_it.xcu_stack[0].s_obj;
+	int                  result;
+
+	if (op == XO_DEC && top->xo_ptr == NULL) {
+		top->xo_ptr = ctx->xcx_alloc(&ctx->xcx_it,
+					     top->xo_type->xct_sizeof);
+		if (top->xo_ptr == NULL)
+			return M0_ERR(-ENOMEM);
+	}
+	result = top->xo_type->xct_gen(ctx, top->xo_ptr, gen_op[op]);
+	ctx->xcx_it.xcu_depth = -1;
+	return op == XO_LEN ? result : min_check(result, 0);
+}
+
 M0_INTERNAL int m0_xcode_decode(struct m0_xcode_ctx *ctx)
 {
-	return ctx_walk(ctx, XO_DEC);
+	return ctx_gen(ctx, XO_DEC) ? ctx_gen_run(ctx, XO_DEC) :
+		ctx_walk(ctx, XO_DEC);
 }
 
 M0_INTERNAL int m0_xcode_encode(struct m0_xcode_ctx *ctx)
 {
-	return ctx_walk(ctx, XO_ENC);
+	return ctx_gen(ctx, XO_ENC) ? ctx_gen_run(ctx, XO_ENC) :
+		ctx_walk(ctx, XO_ENC);
 }
 
 M0_INTERNAL int m0_xcode_length(struct m0_xcode_ctx *ctx)
 {
-	return ctx_walk(ctx, XO_LEN);
+	return ctx_gen(ctx, XO_LEN) ? ctx_gen_run(ctx, XO_LEN) :
+		ctx_walk(ctx, XO_LEN);
+}
+
+M0_INTERNAL int m0_xcode_gen_bytes(struct m0_xcode_ctx *ctx, void *ptr,
+				   m0_bcount_t nob, enum m0_xcode_gen_op op)
+{
+	struct m0_bufvec_cursor *buf  = &ctx->xcx_buf;
+	struct m0_bufvec         area = M0_BUFVEC_INIT_BUF(&ptr, &nob);
+	struct m0_bufvec_cursor  mem;
+	m0_bcount_t              copied;
+
+	M0_PRE(M0_IN(op, (M0_XGO_ENC, M0_XGO_DEC, M0_XGO_LEN)));
+
+	if (op == M0_XGO_LEN)
+		return nob;
+	if (nob == 0)
+		return 0;
+	/* Fast path: the bytes are in the current segment of the buffer. */
+	if (!m0_bufvec_cursor_move(buf, 0) &&
+	    m0_bufvec_cursor_step(buf) >= nob) {
+		if (op == M0_XGO_ENC)
+			memcpy(m0_bufvec_cursor_addr(buf), ptr, nob);
+		else
+			memcpy(ptr, m0_bufvec_cursor_addr(buf), nob);
+		m0_bufvec_cursor_move(buf, nob);
+		return 0;
+	}
+	m0_bufvec_cursor_init(&mem, &area);
+	copied = op == M0_XGO_ENC ? m0_bufvec_cursor_copy(buf, &mem, nob) :
+				    m0_bufvec_cursor_copy(&mem, buf, nob);
+	return copied == nob ? 0 : -EPROTO;
+}
+
+M0_INTERNAL int m0_xcode_gen_alloc(struct m0_xcode_ctx *ctx, void **slot,
+				   size_t nob, enum m0_xcode_gen_op op)
+{
+	if (op != M0_XGO_DEC || nob == 0 || *slot != NULL)
+		return 0;
+	*slot = ctx->xcx_alloc(&ctx->xcx_it, nob);
+	return *slot != NULL ? 0 : M0_ERR(-ENOMEM);
+}
+
+M0_INTERNAL int m0_xcode_gen_sub(struct m0_xcode_ctx *ctx,
+				 const struct m0_xcode_type *xt, void *obj,
+				 enum m0_xcode_gen_op op)
+{
+	struct m0_xcode_ctx sub;
+	int                 result;
+
+	if (xt->xct_gen != NULL && !has_ops(xt, walk_op[op]))
+		return xt->xct_gen(ctx, obj, op);
+	if (xt->xct_aggr == M0_XA_ATOM && !has_ops(xt, walk_op[op]))
+		return m0_xcode_gen_bytes(ctx, obj, xt->xct_sizeof, op);
+	/* No generated function: walk the sub-object. */
+	m0_xcode_ctx_init(&sub, &M0_XCODE_OBJ(xt, obj));
+	sub.xcx_buf   = ctx->xcx_buf;
+	sub.xcx_alloc = ctx->xcx_alloc;
+	sub.xcx_free  = ctx->xcx_free;
+	result = ctx_walk(&sub, walk_op[op]);
+	ctx->xcx_buf = sub.xcx_buf;
+	return op == M0_XGO_LEN ? result : min_check(result, 0);
+}
+
+M0_INTERNAL int m0_xcode_gen_opaque(struct m0_xcode_ctx *ctx,
+				    const struct m0_xcode_type *xt, void *obj,
+				    int fieldno, enum m0_xcode_gen_op op)
+{
+	const struct m0_xcode_obj    par = M0_XCODE_OBJ(xt, obj);
+	const struct m0_xcode_field *f   = &xt->xct_child[fieldno];
+	const struct m0_xcode_type  *pt;
+	void                       **slot;
+	int                          result;
+
+	M0_PRE(f->xf_type == &M0_XT_OPAQUE);
+
+	result = f->xf_opaque(&par, &pt);
+	if (result != 0)
+		return result;
+	slot = m0_xcode_addr(&par, fieldno, ~0ULL);
+	result = m0_xcode_gen_alloc(ctx, slot, pt->xct_sizeof, op);
+	return result ?: m0_xcode_gen_sub(ctx, pt, *slot, op);
 }
 
 M0_INTERNAL void m0_xcode_type_iterate(struct m0_xcode_type *xt,
@@ -840,9 +991,13 @@ M0_INTERNAL int m0_xcode_obj_enc_to_buf(struct m0_xcode_obj  *obj,
 	struct m0_xcode_ctx     ctx;
 	struct m0_bufvec        val;
 	struct m0_bufvec_cursor cur;
+	int                     result;
 
 	M0_PRE(obj != NULL);
-	*len = m0_xcode_data_size(&ctx, obj);
+	result = m0_xcode_data_size(&ctx, obj);
+	if (result < 0)
+		return M0_ERR(result);
+	*len = result;
 	*buf = m0_alloc(*len);
 	if (*buf == NULL)
 		return M0_ERR(-ENOMEM);
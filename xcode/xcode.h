@@ -155,6 +155,34 @@ struct m0_xcode_field;
 struct m0_xcode_cursor;
 struct m0_xcode_field_ops;
 
+/** Operation performed by a generated xcoding function. */
+enum m0_xcode_gen_op {
+	M0_XGO_ENC,
+	M0_XGO_DEC,
+	M0_XGO_LEN
+};
+
+/**
+   Specialised xcoding function of a type.
+
+   m0gccxml2xcode (with --codec option) generates such function for every
+   type it processes. The function is straight-line C code over the fields of
+   the C structure, calling m0_xcode_gen_*() helpers for sub-objects.
+
+   Encodes (M0_XGO_ENC) or decodes (M0_XGO_DEC) "obj" at ctx->xcx_buf, or
+   measures (M0_XGO_LEN) its serialised representation. Returns the length for
+   M0_XGO_LEN, 0 for other operations, or a negative error code.
+
+   The result must be identical to the result of walking the type with
+   m0_xcode_next(), which is the reference implementation. The exception is a
+   union with a discriminator that matches none of its arms: the walk xcodes
+   only the discriminator, the generated function fails with -EPROTO.
+
+   @see m0_xcode_gen_enable()
+ */
+typedef int (*m0_xcode_gen_t)(struct m0_xcode_ctx *ctx, void *obj,
+			      enum m0_xcode_gen_op op);
+
 /**
    Type of aggregation for a data-type.
 
@@ -319,6 +347,12 @@ struct m0_xcode_type {
 	const char                     *xct_name;
 	/** Custom operations. */
 	const struct m0_xcode_type_ops *xct_ops;
+	/**
+	    Generated xcoding function, NULL if none.
+
+	    @see m0_xcode_gen_t
+	 */
+	m0_xcode_gen_t                  xct_gen;
 	/**
 	    Which atomic type this is?
 
@@ -690,6 +724,58 @@ M0_INTERNAL bool m0_xcode_is_byte_array(const struct m0_xcode_type *xt);
 M0_INTERNAL ssize_t
 m0_xcode_alloc_obj(struct m0_xcode_cursor *it,
 		   void *(*alloc)(struct m0_xcode_cursor *, size_t));
+
+/**
+   @name generated xcoding
+
+   m0_xcode_encode(), m0_xcode_decode() and m0_xcode_length() call the
+   generated function (m0_xcode_type::xct_gen) of the top-level type instead of
+   walking the type, provided that:
+
+       - generated xcoding is enabled (m0_xcode_gen_enable());
+
+       - the context has no iteration call-backs (m0_xcode_ctx::xcx_iter,
+         m0_xcode_ctx::xcx_iter_end);
+
+       - for decoding, the context uses default allocator (m0_xcode_alloc()),
+         because other allocators look into the iteration cursor, which is not
+         maintained by the generated code.
+
+   The functions below are used by the generated code. They return values
+   following m0_xcode_gen_t convention.
+ */
+/** @{ */
+
+/** Enables or disables generated xcoding. It is enabled by default. */
+M0_INTERNAL void m0_xcode_gen_enable(bool enable);
+M0_INTERNAL bool m0_xcode_gen_is_enabled(void);
+
+/** Xcodes "nob" bytes of atoms at "ptr". */
+M0_INTERNAL int m0_xcode_gen_bytes(struct m0_xcode_ctx *ctx, void *ptr,
+				   m0_bcount_t nob, enum m0_xcode_gen_op op);
+/**
+   Allocates "nob" bytes for a non-inline sub-object when decoding, unless
+   "*slot" is already set. Does nothing for other operations.
+ */
+M0_INTERNAL int m0_xcode_gen_alloc(struct m0_xcode_ctx *ctx, void **slot,
+				   size_t nob, enum m0_xcode_gen_op op);
+/**
+   Xcodes a sub-object of type "xt" at "obj".
+
+   Calls the generated function of "xt" if any, falls back to the walk
+   otherwise.
+ */
+M0_INTERNAL int m0_xcode_gen_sub(struct m0_xcode_ctx *ctx,
+				 const struct m0_xcode_type *xt, void *obj,
+				 enum m0_xcode_gen_op op);
+/**
+   Xcodes the object referenced by OPAQUE field "fieldno" of "obj" of type
+   "xt".
+ */
+M0_INTERNAL int m0_xcode_gen_opaque(struct m0_xcode_ctx *ctx,
+				    const struct m0_xcode_type *xt, void *obj,
+				    int fieldno, enum m0_xcode_gen_op op);
+/** @} generated xcoding. */
 /** @} xcoding. */
 
 /**